@@ -1,5 +1,6 @@
 #include <glad/glad.h>
 #include <GLFW/glfw3.h>
+#include <learnopengl/sample_capture.h>
 #include <iostream>
 
 void framebuffer_size_callback(GLFWwindow* window, int width, int height);
@@ -24,17 +25,23 @@ const char * fragmentShaderSource = "#version 330 core\n"
                                     "   FragColor = vec4(1.0f, 0.5f, 0.2f, 1.0f);\n"
                                     "}\n\0";
 
-int main()
+int main(int argc, char *argv[])
 {
     using std::cout;
     using std::endl;
 
+    // --capture：隐藏窗口渲染一帧并截图，golden_images 用它和参考图比较
+    SampleCapture capture;
+    if (!capture.Parse(argc, argv))
+        return EXIT_FAILURE;
+
     // glfw: 初始化设置
     // ------------------------------
     glfwInit();
     glfwWindowHint(GLFW_CONTEXT_VERSION_MAJOR, 3);
     glfwWindowHint(GLFW_CONTEXT_VERSION_MINOR, 3);
     glfwWindowHint(GLFW_OPENGL_PROFILE, GLFW_OPENGL_CORE_PROFILE);
+    capture.WindowHints();
 
     // glfw: 创建窗口
     // --------------------
@@ -75,6 +82,7 @@ int main()
     // 片段着色器
     unsigned int fragmentShader = glCreateShader(GL_FRAGMENT_SHADER);
     glShaderSource(fragmentShader, 1, &fragmentShaderSource, nullptr);
+    glCompileShader(fragmentShader);
     glGetShaderiv(fragmentShader, GL_COMPILE_STATUS, &success);
     if (!success) {
         glGetShaderInfoLog(fragmentShader, 512, nullptr, infoLog);
@@ -139,6 +147,7 @@ int main()
 
         // glfw: 交换颜色缓冲（存储着每个像素颜色的大缓冲），在本轮迭代中用来绘制窗口
         // -------------------------------------------------------------------------------
+        capture.EndFrame(window);
         glfwSwapBuffers(window);
         // 事件触发检测
         glfwPollEvents();
@@ -151,7 +160,7 @@ int main()
     // glfw: 终结窗口显示，并释放资源
     // ------------------------------------------------------------------
     glfwTerminate();
-    return 0;
+    return capture.ExitCode();
 }
 
 // process all input: query GLFW whether relevant keys are pressed/released this frame and react accordingly
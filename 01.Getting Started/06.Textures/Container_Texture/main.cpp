@@ -1,9 +1,8 @@
-#define STB_IMAGE_IMPLEMENTATION
 #include <glad/glad.h>
 #include <GLFW/glfw3.h>
 
-#include "stb_image.h"
-#include "shader_s.h"
+#include <stb_image.h>
+#include <learnopengl/shader.h>
 
 #include <iostream>
 
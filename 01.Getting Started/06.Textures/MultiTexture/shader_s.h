@@ -1,126 +0,0 @@
-//
-// Created by tuser on 19-1-14.
-//
-
-#ifndef SHADER_S_H
-#define SHADER_S_H
-
-#include <glad/glad.h>  // 包含glad来获取所有的必须OpenGL头文件
-
-#include <string>
-#include <fstream>
-#include <sstream>
-#include <iostream>
-
-class Shader {
-public:
-    unsigned int ID;
-    // 两个参数分别是顶点着色器源码路径和片段着色器顶点路径
-    Shader(const char * vertexPath, const char * fragmentPath);
-    // 激活着色器程序
-    void use() { glUseProgram(ID); }
-    // uniform工具函数
-    void setBool(const std::string & name, bool value) const;
-    void setInt(const std::string & name, int value) const;
-    void setFloat(const std::string & name, float value) const;
-
-private:
-    void checkCompileErrors(unsigned int shader, std::string type);
-};
-
-Shader::Shader(const char *vertexPath, const char *fragmentPath) {
-    // 1. 从着色器源码文件中读取着色器
-    // --------------------------------------------------
-    using namespace std;
-
-    string vertexCode;
-    string fragmentCode;
-    ifstream vShaderFile;
-    ifstream fShaderFile;
-    // 确保ifstream对象可以抛出异常
-    vShaderFile.exceptions(ifstream::failbit | ifstream::badbit);
-    fShaderFile.exceptions(ifstream::failbit | ifstream::badbit);
-
-    try {
-        // 打开文件
-        vShaderFile.open(vertexPath);
-        fShaderFile.open(fragmentPath);
-        // 内核格式化
-        stringstream vShaderStream, fShaderStream;
-        // 读取文件到格式化字符串中
-        vShaderStream << vShaderFile.rdbuf();
-        fShaderStream << fShaderFile.rdbuf();
-        // 关闭文件流
-        vShaderFile.close();
-        fShaderFile.close();
-        // 转换为string对象
-        vertexCode  = vShaderStream.str();
-        fragmentCode = fShaderStream.str();
-    }
-    catch (ifstream::failure &e) {
-        cout << "ERROR::SHADER::FILE_NOT_SUCCESSFULLY_READ" << endl;
-    }
-    // 得到着色器源码字符串
-    const char * vShaderCode = vertexCode.c_str();
-    const char * fShaderCode = fragmentCode.c_str();
-
-    // 2. 编译链接着色器
-    // --------------------------------------------------
-    unsigned int vertex, fragment;
-    // 顶点着色器
-    vertex = glCreateShader(GL_VERTEX_SHADER);
-    glShaderSource(vertex, 1, &vShaderCode, nullptr);
-    glCompileShader(vertex);
-    checkCompileErrors(vertex, "VERTEX");
-    // 片段着色器
-    fragment = glCreateShader(GL_FRAGMENT_SHADER);
-    glShaderSource(fragment, 1, &fShaderCode, nullptr);
-    glCompileShader(fragment);
-    checkCompileErrors(fragment, "FRAGMENT");
-    // 着色器程序
-    ID = glCreateProgram();
-    glAttachShader(ID, vertex);
-    glAttachShader(ID, fragment);
-    glLinkProgram(ID);
-    checkCompileErrors(ID, "PROGRAM");
-    // 删除着色器
-    glDeleteShader(vertex);
-    glDeleteShader(fragment);
-}
-
-void Shader::setBool(const std::string &name, bool value) const {
-    glUniform1i(glGetUniformLocation(ID, name.c_str()), (int) value);
-}
-
-void Shader::setInt(const std::string &name, int value) const {
-    glUniform1i(glGetUniformLocation(ID, name.c_str()), value);
-}
-
-void Shader::setFloat(const std::string &name, float value) const {
-    glUniform1f(glGetUniformLocation(ID, name.c_str()), value);
-}
-
-void Shader::checkCompileErrors(unsigned int shader, std::string type) {
-    using std::cout;
-    using std::endl;
-
-    int success;
-    char infoLog[1024];
-    if (type != "PROGRAM") {
-        glGetShaderiv(shader, GL_COMPILE_STATUS, &success);
-        if (!success) {
-            glGetShaderInfoLog(shader, 1024, nullptr, infoLog);
-            cout << "ERROR::SHADER_COMPILATION_ERROR of type: " << type << "\n" << infoLog
-                 << "\n -- --------------------------------------------------- -- " << endl;
-        }
-    } else {
-        glGetProgramiv(shader, GL_LINK_STATUS, &success);
-        if (!success) {
-            glGetProgramInfoLog(shader, 1024, nullptr, infoLog);
-            cout << "ERROR::PROGRAM_LINKING_ERROR of type: " << type << "\n" << infoLog
-                 << "\n -- --------------------------------------------------- -- " << endl;
-        }
-    }
-}
-
-#endif // SHADER_S_H
@@ -1,4 +1,3 @@
-#define STB_IMAGE_IMPLEMENTATION
 #include <glad/glad.h>
 #include <GLFW/glfw3.h>
 
@@ -7,8 +6,9 @@
 #include <glm/gtc/type_ptr.hpp>
 
 
-#include "stb_image.h"
-#include "shader_s.h"
+#include <stb_image.h>
+#include <learnopengl/shader.h>
+#include <learnopengl/sample_capture.h>
 
 #include <iostream>
 
@@ -22,17 +22,23 @@ const unsigned int SCR_HEIGHT = 800;
 
 float mixValue = 0.2f;
 
-int main()
+int main(int argc, char *argv[])
 {
     using std::cout;
     using std::endl;
 
+    // --capture：隐藏窗口渲染一帧并截图，golden_images 用它和参考图比较
+    SampleCapture capture;
+    if (!capture.Parse(argc, argv))
+        return EXIT_FAILURE;
+
     // glfw: 初始化设置
     // ------------------------------
     glfwInit();
     glfwWindowHint(GLFW_CONTEXT_VERSION_MAJOR, 3);
     glfwWindowHint(GLFW_CONTEXT_VERSION_MINOR, 3);
     glfwWindowHint(GLFW_OPENGL_PROFILE, GLFW_OPENGL_CORE_PROFILE);
+    capture.WindowHints();
 
     // glfw: 创建窗口
     // --------------------
@@ -156,7 +162,7 @@ int main()
         // 创建旋转矩阵
         glm::mat4 transform = glm::mat4(1.0f);
         transform = glm::translate(transform, glm::vec3(0.5f, -0.5f, 0.0f));
-        transform = glm::rotate(transform, (float)glfwGetTime(), glm::vec3(0.0f, 0.0f, 1.0f));
+        transform = glm::rotate(transform, capture.Time(), glm::vec3(0.0f, 0.0f, 1.0f));
 
         unsigned int transformLoc = glGetUniformLocation(ourShader.ID, "transform");
         glUniformMatrix4fv(transformLoc, 1, GL_FALSE, glm::value_ptr(transform));
@@ -167,6 +173,7 @@ int main()
 
         // glfw: 交换颜色缓冲（存储着每个像素颜色的大缓冲），在本轮迭代中用来绘制窗口
         // -------------------------------------------------------------------------------
+        capture.EndFrame(window);
         glfwSwapBuffers(window);
         // 事件触发检测
         glfwPollEvents();
@@ -180,7 +187,7 @@ int main()
     // glfw: 终结窗口显示，并释放资源
     // ------------------------------------------------------------------
     glfwTerminate();
-    return 0;
+    return capture.ExitCode();
 }
 
 // process all input: query GLFW whether relevant keys are pressed/released this frame and react accordingly
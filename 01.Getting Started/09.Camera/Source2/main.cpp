@@ -1,4 +1,3 @@
-#define STB_IMAGE_IMPLEMENTATION
 #include <glad/glad.h>
 #include <GLFW/glfw3.h>
 
@@ -7,8 +6,8 @@
 #include <glm/gtc/type_ptr.hpp>
 
 
-#include "stb_image.h"
-#include "shader_s.h"
+#include <stb_image.h>
+#include <learnopengl/shader.h>
 
 #include <iostream>
 
@@ -1,201 +0,0 @@
-//
-// Created by tuser on 19-1-14.
-//
-
-#ifndef SHADER_S_H
-#define SHADER_S_H
-
-#include <glad/glad.h>  // 包含glad来获取所有的必须OpenGL头文件
-#include <glm/glm.hpp>
-
-#include <string>
-#include <fstream>
-#include <sstream>
-#include <iostream>
-
-class Shader {
-public:
-    unsigned int ID;
-    // 两个参数分别是顶点着色器源码路径和片段着色器顶点路径
-    Shader(const char * vertexPath, const char * fragmentPath, const char* geometryPath = nullptr);
-    // 激活着色器程序
-    void use() { glUseProgram(ID); }
-    // uniform工具函数
-    void setBool(const std::string & name, bool value) const;
-    void setInt(const std::string & name, int value) const;
-    void setFloat(const std::string & name, float value) const;
-    void setVec2(const std::string &name, const glm::vec2 &value) const;
-    void setVec2(const std::string &name, float x, float y) const;
-
-    void setVec3(const std::string &name, const glm::vec3 &value) const;
-    void setVec3(const std::string &name, float x, float y, float z) const;
-
-    void setVec4(const std::string &name, const glm::vec4 &value) const;
-    void setVec4(const std::string &name, float x, float y, float z, float w) const;
-
-    void setMat2(const std::string &name, const glm::mat2 &mat) const;
-    void setMat3(const std::string &name, const glm::mat3 &mat) const;
-    void setMat4(const std::string &name, const glm::mat4 &mat) const;
-
-private:
-    void checkCompileErrors(unsigned int shader, std::string type);
-};
-
-Shader::Shader(const char* vertexPath, const char* fragmentPath, const char* geometryPath) {
-    // 1. 从着色器源码文件中读取着色器
-    // --------------------------------------------------
-    using namespace std;
-
-    string vertexCode;
-    string fragmentCode;
-    string geometryCode;
-    ifstream vShaderFile;
-    ifstream fShaderFile;
-    ifstream gShaderFile;
-    // 确保ifstream对象可以抛出异常
-    vShaderFile.exceptions(ifstream::failbit | ifstream::badbit);
-    fShaderFile.exceptions(ifstream::failbit | ifstream::badbit);
-    gShaderFile.exceptions(ifstream::failbit | ifstream::badbit);
-
-    try {
-        // 打开文件
-        vShaderFile.open(vertexPath);
-        fShaderFile.open(fragmentPath);
-        // 内核格式化
-        stringstream vShaderStream, fShaderStream;
-        // 读取文件到格式化字符串中
-        vShaderStream << vShaderFile.rdbuf();
-        fShaderStream << fShaderFile.rdbuf();
-        // 关闭文件流
-        vShaderFile.close();
-        fShaderFile.close();
-        // 转换为string对象
-        vertexCode  = vShaderStream.str();
-        fragmentCode = fShaderStream.str();
-        // 如果有几何着色器，加载
-        if (geometryPath != nullptr) {
-            gShaderFile.open(geometryPath);
-            stringstream gShaderStream;
-            gShaderStream << gShaderFile.rdbuf();
-            gShaderFile.close();
-            geometryCode = gShaderStream.str();
-        }
-    }
-    catch (ifstream::failure &e) {
-        cout << "ERROR::SHADER::FILE_NOT_SUCCESSFULLY_READ" << endl;
-    }
-    // 得到着色器源码字符串
-    const char * vShaderCode = vertexCode.c_str();
-    const char * fShaderCode = fragmentCode.c_str();
-
-    // 2. 编译链接着色器
-    // --------------------------------------------------
-    unsigned int vertex, fragment;
-    // 顶点着色器
-    vertex = glCreateShader(GL_VERTEX_SHADER);
-    glShaderSource(vertex, 1, &vShaderCode, nullptr);
-    glCompileShader(vertex);
-    checkCompileErrors(vertex, "VERTEX");
-    // 片段着色器
-    fragment = glCreateShader(GL_FRAGMENT_SHADER);
-    glShaderSource(fragment, 1, &fShaderCode, nullptr);
-    glCompileShader(fragment);
-    checkCompileErrors(fragment, "FRAGMENT");
-    // Geometry
-    unsigned int geometry{};
-    if (geometryPath != nullptr) {
-        const char * gShaderCode = geometryCode.c_str();
-        geometry = glCreateShader(GL_GEOMETRY_SHADER);
-        glShaderSource(geometry, 1, &gShaderCode, nullptr);
-        glCompileShader(geometry);
-        checkCompileErrors(geometry, "GEOMETRY");
-    }
-    // 着色器程序
-    ID = glCreateProgram();
-    glAttachShader(ID, vertex);
-    glAttachShader(ID, fragment);
-    if (geometryPath != nullptr)
-        glAttachShader(ID, geometry);
-    glLinkProgram(ID);
-    checkCompileErrors(ID, "PROGRAM");
-    // 删除着色器
-    glDeleteShader(vertex);
-    glDeleteShader(fragment);
-    if (geometryPath != nullptr)
-        glDeleteShader(geometry);
-}
-
-
-void Shader::checkCompileErrors(unsigned int shader, std::string type) {
-    using std::cout;
-    using std::endl;
-
-    int success;
-    char infoLog[1024];
-    if (type != "PROGRAM") {
-        glGetShaderiv(shader, GL_COMPILE_STATUS, &success);
-        if (!success) {
-            glGetShaderInfoLog(shader, 1024, nullptr, infoLog);
-            cout << "ERROR::SHADER_COMPILATION_ERROR of type: " << type << "\n" << infoLog
-                 << "\n -- --------------------------------------------------- -- " << endl;
-        }
-    } else {
-        glGetProgramiv(shader, GL_LINK_STATUS, &success);
-        if (!success) {
-            glGetProgramInfoLog(shader, 1024, nullptr, infoLog);
-            cout << "ERROR::PROGRAM_LINKING_ERROR of type: " << type << "\n" << infoLog
-                 << "\n -- --------------------------------------------------- -- " << endl;
-        }
-    }
-}
-
-
-void Shader::setBool(const std::string &name, bool value) const {
-    glUniform1i(glGetUniformLocation(ID, name.c_str()), (int) value);
-}
-
-void Shader::setInt(const std::string &name, int value) const {
-    glUniform1i(glGetUniformLocation(ID, name.c_str()), value);
-}
-
-void Shader::setFloat(const std::string &name, float value) const {
-    glUniform1f(glGetUniformLocation(ID, name.c_str()), value);
-}
-
-// -------------------------------------------------------------------------------
-void Shader::setVec2(const std::string &name, const glm::vec2 &value) const {
-    glUniform2fv(glGetUniformLocation(ID, name.c_str()), 1, &value[0]);
-}
-void Shader::setVec2(const std::string &name, float x, float y) const {
-    glUniform2f(glGetUniformLocation(ID, name.c_str()), x, y);
-}
-
-// -------------------------------------------------------------------------------
-void Shader::setVec3(const std::string &name, const glm::vec3 &value) const {
-    glUniform3fv(glGetUniformLocation(ID, name.c_str()), 1, &value[0]);
-}
-void Shader::setVec3(const std::string &name, float x, float y, float z) const {
-    glUniform3f(glGetUniformLocation(ID, name.c_str()), x, y, z);
-}
-
-// -------------------------------------------------------------------------------
-void Shader::setVec4(const std::string &name, const glm::vec4 &value) const {
-    glUniform4fv(glGetUniformLocation(ID, name.c_str()), 1, &value[0]);
-}
-void Shader::setVec4(const std::string &name, float x, float y, float z, float w) const {
-    glUniform4f(glGetUniformLocation(ID, name.c_str()), x, y, z, w);
-}
-// -------------------------------------------------------------------------------
-void Shader::setMat2(const std::string &name, const glm::mat2 &mat) const {
-    glUniformMatrix2fv(glGetUniformLocation(ID, name.c_str()), 1, GL_FALSE, &mat[0][0]);
-}
-// -------------------------------------------------------------------------------
-void Shader::setMat3(const std::string &name, const glm::mat3 &mat) const {
-    glUniformMatrix3fv(glGetUniformLocation(ID, name.c_str()), 1, GL_FALSE, &mat[0][0]);
-}
-// -------------------------------------------------------------------------------
-void Shader::setMat4(const std::string &name, const glm::mat4 &mat) const {
-    glUniformMatrix4fv(glGetUniformLocation(ID, name.c_str()), 1, GL_FALSE, &mat[0][0]);
-}
-
-#endif // SHADER_S_H
@@ -5,7 +5,11 @@ in vec2 TexCoord;
 
 uniform sampler2D texture1;
 uniform sampler2D texture2;
+// 鼠标悬停的物体高亮
+uniform bool highlight;
 
 void main() {
 	FragColor = mix(texture(texture1, TexCoord), texture(texture2, TexCoord), 0.2f);
+	if (highlight)
+		FragColor = mix(FragColor, vec4(1.0f, 0.8f, 0.2f, 1.0f), 0.4f);
 }
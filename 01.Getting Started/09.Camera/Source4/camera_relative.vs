@@ -0,0 +1,13 @@
+#version 330 core
+layout (location = 0) in vec3 aPos;
+layout (location = 1) in vec2 aTexCoord;
+layout (location = 2) in mat4 aModelView;	// 逐实例属性，CPU上以摄像机为原点算好的 视图 * 模型，占用 location 2 ~ 5
+
+out vec2 TexCoord;
+
+uniform mat4 projection;
+
+void main() {
+	gl_Position = projection * aModelView * vec4(aPos, 1.0f);
+	TexCoord = vec2(aTexCoord);
+}
@@ -0,0 +1,610 @@
+// 预烘焙网格示例：.mesh 文件映射后顶点和索引各用一次 glBufferData 上传（格式见 cooked_mesh.h），和每次都解析OBJ对比加载时间
+// 绘制时按屏幕上的误差自动选择LOD，小簇做视锥体剔除和法线锥背面剔除，可见的小簇用一次 glMultiDrawElements 画出
+// 着色器和网格导入示例共用（mesh_import.vs / mesh_import.fs）
+//
+// 运行参数：
+//   [文件]       .mesh 直接打开；.obj / .glb 先导入再烘焙成同名的 .mesh；没有参数时生成一个细分的球面
+//   --validate   隐藏窗口，检查烘焙的结果（Verify、LOD、小簇的限制）、损坏的文件被拒绝、
+//                32字节格式和导入的网格渲染结果相同、紧凑格式和LOD的差别很小、小簇剔除不改变画面，并对比加载时间
+// 按键：L 切换LOD（自动 / 固定某一级），C 开关小簇剔除
+#include <iostream>
+#include <cstring>
+#include <cstdint>
+#include <cstdio>
+#include <vector>
+#include <string>
+#include <chrono>
+#include <functional>
+#include <cmath>
+#include <glad/glad.h>
+#include <GLFW/glfw3.h>
+
+#include <glm/glm.hpp>
+#include <glm/gtc/matrix_transform.hpp>
+#include <glm/gtc/type_ptr.hpp>
+
+#include <learnopengl/shader.h>
+#include <learnopengl/camera.h>
+#include <learnopengl/texture.h>
+#include <learnopengl/frustum.h>
+#include <learnopengl/image_compare.h>
+#include <learnopengl/mesh_import.h>
+#include <learnopengl/cooked_mesh.h>
+
+void framebuffer_size_callback(GLFWwindow* window, int width, int height);
+void mouse_callback(GLFWwindow* window, double xpos, double ypos);
+void scroll_callback(GLFWwindow* window, double xoffset, double yoffset);
+void key_callback(GLFWwindow* window, int key, int scancode, int action, int mods);
+void processInput(GLFWwindow *window);
+
+// 窗口大小
+const unsigned int SCR_WIDTH = 800;
+const unsigned int SCR_HEIGHT = 600;
+
+// camera
+Camera camera(glm::vec3(0.0f, 0.0f, 3.0f));
+
+bool firstMouse = true;
+double lastX = SCR_WIDTH / 2.0;
+double lastY = SCR_HEIGHT / 2.0;
+
+// timing
+float deltaTime = 0.0f;	// time between current frame and last frame
+float lastFrame = 0.0f;
+
+// -1 自动选择LOD，否则固定画这一级
+int lodMode = -1;
+unsigned int lodCount = 1;
+bool meshletCulling = true;
+
+// 没有参数时生成的文件
+const char *SPHERE_OBJ = "cooked_mesh_sphere.obj";
+const char *SPHERE_MESH = "cooked_mesh_sphere.mesh";
+
+// LOD的误差投影到屏幕上不超过这么多像素
+const float LOD_PIXEL_ERROR = 1.0f;
+
+typedef std::chrono::high_resolution_clock Clock;
+
+double millisecondsSince(Clock::time_point start)
+{
+    return std::chrono::duration<double, std::milli>(Clock::now() - start).count();
+}
+
+// 导入的网格：一个交错的顶点缓冲和一个索引缓冲，作为对比
+struct ImportedBuffers {
+    unsigned int VAO = 0, VBO = 0, EBO = 0;
+    GLsizei IndexCount = 0;
+};
+
+bool writeSphereObj(const char *path, int rings, int segments);
+ImportedBuffers uploadImported(const ImportedMesh &mesh);
+void deleteImported(ImportedBuffers &buffers);
+unsigned int selectLod(const CookedMesh &mesh, const Camera &cam, int viewportHeight);
+void cullMeshlets(const CookedMesh &mesh, unsigned int lod, const Camera &cam, float aspectRatio, std::vector<unsigned int> &visible);
+void setupShader(const Shader &shader, const Camera &cam, float aspectRatio, bool hasNormals);
+void frameCamera(Camera &cam, const AABB &bounds);
+int validate(const Shader &shader);
+
+int main(int argc, char *argv[])
+{
+    using std::cout;
+    using std::endl;
+
+    bool validateMode = argc > 1 && std::strcmp(argv[1], "--validate") == 0;
+    std::string path = argc > 1 && !validateMode ? argv[1] : "";
+
+    // glfw: 初始化设置
+    // ------------------------------
+    glfwInit();
+    glfwWindowHint(GLFW_CONTEXT_VERSION_MAJOR, 3);
+    glfwWindowHint(GLFW_CONTEXT_VERSION_MINOR, 3);
+    glfwWindowHint(GLFW_OPENGL_PROFILE, GLFW_OPENGL_CORE_PROFILE);
+    if (validateMode)
+        glfwWindowHint(GLFW_VISIBLE, GLFW_FALSE);
+
+    // glfw: 创建窗口
+    // --------------------
+    GLFWwindow* window = glfwCreateWindow(SCR_WIDTH, SCR_HEIGHT, "LearnOpenGL", nullptr, nullptr);
+    if (window == nullptr)
+    {
+        cout << "Failed to create GLFW window" << endl;
+        glfwTerminate();
+        exit(EXIT_FAILURE);
+    }
+    glfwMakeContextCurrent(window);     // 设置OpenGL上下文
+    glfwSetFramebufferSizeCallback(window, framebuffer_size_callback);
+    glfwSetCursorPosCallback(window, mouse_callback);
+    glfwSetScrollCallback(window, scroll_callback);
+    glfwSetKeyCallback(window, key_callback);
+    if (!validateMode)
+        glfwSetInputMode(window, GLFW_CURSOR, GLFW_CURSOR_DISABLED);
+
+    // glad: 加载OpenGL函数指针
+    // ---------------------------------------
+    if (!gladLoadGLLoader((GLADloadproc)glfwGetProcAddress))
+    {
+        cout << "Failed to initialize GLAD" << endl;
+        exit(EXIT_FAILURE);
+    }
+    glEnable(GL_DEPTH_TEST);
+    cout << "renderer: " << glGetString(GL_RENDERER) << endl;
+
+    // 定义编译着色器，纹理和摄像机示例相同
+    Shader shader("mesh_import.vs", "mesh_import.fs");
+    unsigned int textures[2] = {LoadTexture("container.jpg"), LoadTexture("awesomeface.png")};
+    glActiveTexture(GL_TEXTURE0);
+    glBindTexture(GL_TEXTURE_2D, textures[0]);
+    glActiveTexture(GL_TEXTURE1);
+    glBindTexture(GL_TEXTURE_2D, textures[1]);
+    shader.use();
+    shader.setInt("texture1", 0);
+    shader.setInt("texture2", 1);
+
+    if (validateMode) {
+        int failures = validate(shader);
+        glDeleteTextures(2, textures);
+        glfwTerminate();
+        return failures == 0 ? EXIT_SUCCESS : EXIT_FAILURE;
+    }
+
+    // 没有参数时生成球面；不是 .mesh 时先导入再烘焙
+    if (path.empty()) {
+        if (!writeSphereObj(SPHERE_OBJ, 512, 1024)) {
+            cout << "Failed to generate " << SPHERE_OBJ << endl;
+            glfwTerminate();
+            return EXIT_FAILURE;
+        }
+        path = SPHERE_OBJ;
+    }
+    std::string info;
+    if (path.size() < 5 || path.substr(path.size() - 5) != ".mesh") {
+        MeshImporter importer;
+        ImportedMesh mesh;
+        MeshCooker cooker;
+        std::string cookedPath = path.substr(0, path.find_last_of('.')) + ".mesh";
+        if (!importer.Load(path.c_str(), mesh) || !cooker.Write(mesh, cookedPath.c_str())) {
+            cout << "Failed to cook " << path << ": " << importer.Error() << cooker.Error() << endl;
+            glfwTerminate();
+            return EXIT_FAILURE;
+        }
+        cout << path << ": parsed in " << importer.Stats().TotalMs << " ms, cooked to " << cookedPath << endl;
+        info = "parse " + std::to_string((int) importer.Stats().TotalMs) + " ms, ";
+        path = cookedPath;
+    }
+
+    // 映射 + 上传，glFinish 等上传真正完成
+    auto start = Clock::now();
+    CookedMesh mesh;
+    CookedMeshBuffers buffers;
+    if (!mesh.Open(path.c_str())) {
+        cout << "Failed to open " << path << ": " << mesh.Error() << endl;
+        glfwTerminate();
+        return EXIT_FAILURE;
+    }
+    buffers.Upload(mesh);
+    glFinish();
+    double loadMs = millisecondsSince(start);
+    cout << path << ": opened and uploaded in " << loadMs << " ms, " << mesh.Header().VertexCount << " vertices, "
+         << mesh.Lod(0).IndexCount / 3 << " triangles, " << mesh.Header().LodCount << " LODs, " << mesh.Header().MeshletCount << " meshlets" << endl;
+    info += "load " + std::to_string(loadMs).substr(0, 5) + " ms";
+    lodCount = mesh.Header().LodCount;
+    frameCamera(camera, mesh.Bounds());
+
+    // 渲染循环
+    // -----------
+    std::vector<unsigned int> visible;
+    float titleTimer = 1.0f;
+    while (!glfwWindowShouldClose(window))
+    {
+        float currentFrame = glfwGetTime();
+        deltaTime = currentFrame - lastFrame;
+        lastFrame = currentFrame;
+
+        processInput(window);
+
+        int width, height;
+        glfwGetFramebufferSize(window, &width, &height);
+        if (width == 0 || height == 0) {
+            glfwPollEvents();
+            continue;
+        }
+        float aspectRatio = (float) width / (float) height;
+        unsigned int lod = lodMode < 0 ? selectLod(mesh, camera, height) : (unsigned int) lodMode;
+        glClearColor(0.2f, 0.3f, 0.3f, 1.0f);
+        glClear(GL_COLOR_BUFFER_BIT | GL_DEPTH_BUFFER_BIT);
+        setupShader(shader, camera, aspectRatio, mesh.HasNormals());
+        size_t triangles = 0;
+        if (meshletCulling) {
+            cullMeshlets(mesh, lod, camera, aspectRatio, visible);
+            buffers.DrawMeshlets(visible);
+            for (unsigned int id : visible)
+                triangles += mesh.Meshlets()[id].TriangleCount;
+        } else {
+            buffers.DrawLod(lod);
+            triangles = mesh.Lod(lod).IndexCount / 3;
+        }
+
+        titleTimer += deltaTime;
+        if (titleTimer > 0.5f) {
+            titleTimer = 0.0f;
+            std::string title = "Cooked Mesh - LOD " + std::to_string(lod) + (lodMode < 0 ? " (auto)" : "") + " - " +
+                                std::to_string(triangles) + " triangles";
+            if (meshletCulling)
+                title += ", " + std::to_string(visible.size()) + "/" + std::to_string(mesh.Lod(lod).MeshletCount) + " meshlets";
+            title += " - " + info;
+            glfwSetWindowTitle(window, title.c_str());
+        }
+
+        // glfw: 交换颜色缓冲，检测事件
+        // -------------------------------------------------------------------------------
+        glfwSwapBuffers(window);
+        glfwPollEvents();
+    }
+
+    buffers.Release();
+    glDeleteTextures(2, textures);
+    glfwTerminate();
+    return 0;
+}
+
+// 经纬度细分的单位球面，rings x segments 个四边形面；每行最后一列的位置和法线回绕到第一列，纹理坐标是 u = 1
+// ---------------------------------------------------------------------------------------------------------
+bool writeSphereObj(const char *path, int rings, int segments)
+{
+    FILE *file = std::fopen(path, "wb");
+    if (!file)
+        return false;
+    const double PI = 3.14159265358979323846;
+    for (int r = 0; r <= rings; r++) {
+        double theta = PI * r / rings;
+        for (int s = 0; s < segments; s++) {
+            double phi = 2.0 * PI * s / segments;
+            double x = std::sin(theta) * std::cos(phi), y = std::cos(theta), z = -std::sin(theta) * std::sin(phi);
+            std::fprintf(file, "v %.6f %.6f %.6f\nvn %.6f %.6f %.6f\n", x, y, z, x, y, z);
+        }
+        for (int s = 0; s <= segments; s++)
+            std::fprintf(file, "vt %.6f %.6f\n", 4.0 * s / segments, 2.0 - 2.0 * r / rings);
+    }
+    for (int r = 0; r < rings; r++) {
+        for (int s = 0; s < segments; s++) {
+            int p[4] = {r * segments + s + 1, (r + 1) * segments + s + 1, (r + 1) * segments + (s + 1) % segments + 1, r * segments + (s + 1) % segments + 1};
+            int t[4] = {r * (segments + 1) + s + 1, (r + 1) * (segments + 1) + s + 1, (r + 1) * (segments + 1) + s + 2, r * (segments + 1) + s + 2};
+            std::fprintf(file, "f %d/%d/%d %d/%d/%d %d/%d/%d %d/%d/%d\n", p[0], t[0], p[0], p[1], t[1], p[1], p[2], t[2], p[2], p[3], t[3], p[3]);
+        }
+    }
+    return std::fclose(file) == 0;
+}
+
+ImportedBuffers uploadImported(const ImportedMesh &mesh)
+{
+    ImportedBuffers buffers;
+    buffers.IndexCount = (GLsizei) mesh.Indices.size();
+    glGenVertexArrays(1, &buffers.VAO);
+    glGenBuffers(1, &buffers.VBO);
+    glGenBuffers(1, &buffers.EBO);
+    glBindVertexArray(buffers.VAO);
+    glBindBuffer(GL_ARRAY_BUFFER, buffers.VBO);
+    glBufferData(GL_ARRAY_BUFFER, mesh.Vertices.size() * sizeof(MeshVertex), mesh.Vertices.data(), GL_STATIC_DRAW);
+    glBindBuffer(GL_ELEMENT_ARRAY_BUFFER, buffers.EBO);
+    glBufferData(GL_ELEMENT_ARRAY_BUFFER, mesh.Indices.size() * sizeof(unsigned int), mesh.Indices.data(), GL_STATIC_DRAW);
+    glVertexAttribPointer(0, 3, GL_FLOAT, GL_FALSE, sizeof(MeshVertex), (void *) offsetof(MeshVertex, Position));
+    glEnableVertexAttribArray(0);
+    glVertexAttribPointer(1, 3, GL_FLOAT, GL_FALSE, sizeof(MeshVertex), (void *) offsetof(MeshVertex, Normal));
+    glEnableVertexAttribArray(1);
+    glVertexAttribPointer(2, 2, GL_FLOAT, GL_FALSE, sizeof(MeshVertex), (void *) offsetof(MeshVertex, TexCoords));
+    glEnableVertexAttribArray(2);
+    glBindVertexArray(0);
+    return buffers;
+}
+
+void deleteImported(ImportedBuffers &buffers)
+{
+    glDeleteVertexArrays(1, &buffers.VAO);
+    glDeleteBuffers(1, &buffers.VBO);
+    glDeleteBuffers(1, &buffers.EBO);
+    buffers = ImportedBuffers();
+}
+
+// 最粗的、误差投影到屏幕上不超过 LOD_PIXEL_ERROR 像素的LOD；距离取到包围球表面
+// ---------------------------------------------------------------------------------------------------------
+unsigned int selectLod(const CookedMesh &mesh, const Camera &cam, int viewportHeight)
+{
+    AABB bounds = mesh.Bounds();
+    float distance = std::max(glm::length(bounds.Center() - cam.Position) - glm::length(bounds.Extents()), cam.NearPlane);
+    float pixelsPerUnit = viewportHeight / (2.0f * std::tan(glm::radians(cam.Zoom) * 0.5f)) / distance;
+    for (unsigned int lod = mesh.Header().LodCount - 1; lod > 0; lod--) {
+        if (mesh.Lod(lod).Error * pixelsPerUnit <= LOD_PIXEL_ERROR)
+            return lod;
+    }
+    return 0;
+}
+
+// 视锥体剔除 + 法线锥背面剔除，网格在世界空间中（模型矩阵是单位矩阵）
+// ---------------------------------------------------------------------------------------------------------
+void cullMeshlets(const CookedMesh &mesh, unsigned int lod, const Camera &cam, float aspectRatio, std::vector<unsigned int> &visible)
+{
+    Frustum frustum(cam.GetProjectionMatrix(aspectRatio) * cam.GetViewMatrix());
+    const CookedLod &entry = mesh.Lod(lod);
+    visible.clear();
+    for (unsigned int id = entry.MeshletOffset; id < entry.MeshletOffset + entry.MeshletCount; id++) {
+        const CookedMeshlet &meshlet = mesh.Meshlets()[id];
+        if (frustum.IntersectsAABB(meshlet.Bounds()) && !meshlet.BackFacing(cam.Position))
+            visible.push_back(id);
+    }
+}
+
+void setupShader(const Shader &shader, const Camera &cam, float aspectRatio, bool hasNormals)
+{
+    shader.use();
+    shader.setMat4("projection", cam.GetProjectionMatrix(aspectRatio));
+    shader.setMat4("view", cam.GetViewMatrix());
+    shader.setMat4("model", glm::mat4(1.0f));
+    shader.setBool("flipV", false);
+    shader.setBool("hasNormals", hasNormals);
+}
+
+// 摄像机放在包围盒前方，移动速度、远近平面按网格的大小调整
+// ---------------------------------------------------------------------------------------------------------
+void frameCamera(Camera &cam, const AABB &bounds)
+{
+    float radius = std::max(glm::length(bounds.Extents()), 1e-3f);
+    cam.Position = bounds.Center() + glm::vec3(0.0f, 0.0f, radius * 2.5f);
+    cam.Yaw = -90.0f;
+    cam.Pitch = 0.0f;
+    cam.MovementSpeed = radius;
+    cam.NearPlane = radius * 0.01f;
+    cam.FarPlane = radius * 100.0f;
+}
+
+// 1. 烘焙生成的球面：Verify 通过，LOD的三角形数递减、误差递增，小簇不超过限制
+// 2. 损坏的文件：截断、错误的魔数、越界的小簇在 Parse 时被拒绝；越界的索引由 Verify 发现
+// 3. 渲染：32字节格式的LOD 0 和导入的网格相同；紧凑格式、小簇剔除的画面几乎相同，并且剔除掉了一部分小簇；
+//    远处自动选择的LOD和LOD 0 差别很小
+// 4. 加载时间：解析OBJ vs 映射 + 上传
+// ---------------------------------------------------------------------------------------------------------
+int validate(const Shader &shader)
+{
+    using std::cout;
+    using std::endl;
+    int failures = 0;
+    auto check = [&failures](bool ok) {
+        cout << (ok ? "OK" : "FAILED") << endl;
+        if (!ok)
+            failures++;
+    };
+
+    MeshImporter importer;
+    ImportedMesh source;
+    if (!writeSphereObj(SPHERE_OBJ, 256, 512) || !importer.LoadObj(SPHERE_OBJ, source)) {
+        cout << "cannot generate the sphere " << importer.Error() << endl;
+        return 1;
+    }
+    double parseMs = importer.Stats().TotalMs;
+    size_t objBytes = importer.Stats().Bytes;
+    std::vector<unsigned char> data[2];
+    CookedMesh cooked[2];
+
+    // 1. 烘焙
+    {
+        bool ok = true;
+        for (int compact = 0; compact < 2; compact++) {
+            MeshCooker cooker;
+            cooker.CompactVertices = compact != 0;
+            ok = ok && cooker.Cook(source, data[compact]) && cooked[compact].Parse(data[compact].data(), data[compact].size()) &&
+                 cooked[compact].Verify();
+            if (!ok) {
+                cout << cooker.Error() << cooked[compact].Error() << endl;
+                break;
+            }
+        }
+        if (ok) {
+            const CookedMesh &mesh = cooked[1];
+            const CookedMeshHeader &header = mesh.Header();
+            ok = header.VertexStride == 20 && cooked[0].Header().VertexStride == 32 && header.IndexType == GL_UNSIGNED_INT &&
+                 header.VertexCount == source.Vertices.size() && mesh.Lod(0).IndexCount == source.Indices.size() && header.LodCount >= 3 &&
+                 header.FileSize % COOKED_MESH_ALIGNMENT == 0;
+            cout << "cooked: " << header.FileSize / 1024 << " KB (32-byte vertices " << cooked[0].Header().FileSize / 1024 << " KB), LODs";
+            for (unsigned int i = 0; i < header.LodCount; i++) {
+                cout << " " << mesh.Lod(i).IndexCount / 3 << " (" << mesh.Lod(i).MeshletCount << " meshlets)";
+                if (i > 0)
+                    ok = ok && mesh.Lod(i).IndexCount < mesh.Lod(i - 1).IndexCount && mesh.Lod(i).Error > mesh.Lod(i - 1).Error;
+            }
+            for (unsigned int i = 0; i < header.MeshletCount; i++)
+                ok = ok && mesh.Meshlets()[i].VertexCount <= MESHLET_MAX_VERTICES && mesh.Meshlets()[i].TriangleCount <= MESHLET_MAX_TRIANGLES;
+            cout << ", average " << (float) header.MeshletTriangleCount / header.MeshletCount << " triangles per meshlet";
+        }
+        // 顶点不超过65536个时用16位索引
+        ImportedMesh small;
+        std::vector<unsigned char> smallData;
+        CookedMesh smallMesh;
+        MeshCooker cooker;
+        ok = ok && writeSphereObj(SPHERE_OBJ, 32, 64) && importer.LoadObj(SPHERE_OBJ, small) && cooker.Cook(small, smallData) &&
+             smallMesh.Parse(smallData.data(), smallData.size()) && smallMesh.Verify() && smallMesh.Header().IndexType == GL_UNSIGNED_SHORT &&
+             smallMesh.Lod(0).IndexCount == small.Indices.size();
+        cout << "; 16-bit indices for " << small.Vertices.size() << " vertices ";
+        check(ok);
+    }
+
+    // 2. 损坏的文件
+    {
+        const std::vector<unsigned char> &good = data[1];
+        CookedMesh mesh;
+        std::vector<unsigned char> bad = good;
+        bool truncated = !mesh.Parse(bad.data(), bad.size() - COOKED_MESH_ALIGNMENT);
+        bad[0] ^= 0xFF;
+        bool magic = !mesh.Parse(bad.data(), bad.size());
+        bad = good;
+        CookedMeshHeader header;
+        std::memcpy(&header, bad.data(), sizeof(header));
+        CookedMeshlet meshlet;
+        std::memcpy(&meshlet, bad.data() + header.MeshletOffset, sizeof(meshlet));
+        meshlet.IndexOffset = header.IndexCount;
+        std::memcpy(bad.data() + header.MeshletOffset, &meshlet, sizeof(meshlet));
+        bool meshletRange = !mesh.Parse(bad.data(), bad.size());
+        std::string meshletError = mesh.Error();
+        bad = good;
+        uint32_t outOfRange = header.VertexCount;
+        std::memcpy(bad.data() + header.IndexOffset + 4 * 100, &outOfRange, 4);
+        bool index = mesh.Parse(bad.data(), bad.size()) && !mesh.Verify();
+        cout << "corrupted files: truncated, bad magic, \"" << meshletError << "\" rejected by Parse, \"" << mesh.Error() << "\" found by Verify ";
+        check(truncated && magic && meshletRange && index);
+    }
+
+    // 3. 渲染
+    {
+        const int width = SCR_WIDTH, height = SCR_HEIGHT;
+        unsigned int FBO, colorBuffer, depthBuffer;
+        glGenFramebuffers(1, &FBO);
+        glBindFramebuffer(GL_FRAMEBUFFER, FBO);
+        glGenRenderbuffers(1, &colorBuffer);
+        glBindRenderbuffer(GL_RENDERBUFFER, colorBuffer);
+        glRenderbufferStorage(GL_RENDERBUFFER, GL_RGBA8, width, height);
+        glFramebufferRenderbuffer(GL_FRAMEBUFFER, GL_COLOR_ATTACHMENT0, GL_RENDERBUFFER, colorBuffer);
+        glGenRenderbuffers(1, &depthBuffer);
+        glBindRenderbuffer(GL_RENDERBUFFER, depthBuffer);
+        glRenderbufferStorage(GL_RENDERBUFFER, GL_DEPTH24_STENCIL8, width, height);
+        glFramebufferRenderbuffer(GL_FRAMEBUFFER, GL_DEPTH_STENCIL_ATTACHMENT, GL_RENDERBUFFER, depthBuffer);
+        glViewport(0, 0, width, height);
+        float aspectRatio = (float) width / (float) height;
+
+        Camera cam(glm::vec3(0.0f), glm::vec3(0.0f, 1.0f, 0.0f), -90.0f, 0.0f);
+        frameCamera(cam, source.Bounds);
+        // 靠近一些并偏向一侧，一部分小簇在视锥体外
+        cam.Position = glm::vec3(0.6f, 0.5f, 1.6f);
+        cam.Yaw = -100.0f;
+        cam.Pitch = -15.0f;
+
+        ImportedBuffers imported = uploadImported(source);
+        CookedMeshBuffers buffers[2];
+        buffers[0].Upload(cooked[0]);
+        buffers[1].Upload(cooked[1]);
+        std::vector<unsigned char> pixels(width * height * 4);
+        auto render = [&](const std::function<void()> &draw) {
+            glClearColor(0.2f, 0.3f, 0.3f, 1.0f);
+            glClear(GL_COLOR_BUFFER_BIT | GL_DEPTH_BUFFER_BIT);
+            setupShader(shader, cam, aspectRatio, true);
+            draw();
+            glReadPixels(0, 0, width, height, GL_RGBA, GL_UNSIGNED_BYTE, pixels.data());
+            return pixels;
+        };
+        std::vector<unsigned char> reference = render([&]() {
+            glBindVertexArray(imported.VAO);
+            glDrawElements(GL_TRIANGLES, imported.IndexCount, GL_UNSIGNED_INT, nullptr);
+            glBindVertexArray(0);
+        });
+        std::vector<unsigned char> full = render([&]() { buffers[0].DrawLod(0); });
+        std::vector<unsigned char> compact = render([&]() { buffers[1].DrawLod(0); });
+        std::vector<unsigned int> visible;
+        cullMeshlets(cooked[1], 0, cam, aspectRatio, visible);
+        std::vector<unsigned char> culled = render([&]() { buffers[1].DrawMeshlets(visible); });
+
+        ImageDifference fullDiff = CompareImages(reference.data(), full.data(), width, height);
+        ImageDifference compactDiff = CompareImages(reference.data(), compact.data(), width, height);
+        ImageDifference culledDiff = CompareImages(compact.data(), culled.data(), width, height);
+        unsigned int total = cooked[1].Lod(0).MeshletCount;
+        cout << "rendering: 32-byte LOD 0 vs imported max diff " << fullDiff.MaxDiff << ", compact SSIM " << compactDiff.Ssim
+             << ", meshlet culling keeps " << visible.size() << "/" << total << " meshlets (max diff " << culledDiff.MaxDiff << ") ";
+        check(fullDiff.MaxDiff == 0 && compactDiff.Ssim > 0.97 && culledDiff.MaxDiff == 0 && visible.size() < total * 0.6f);
+
+        // 远处：自动选择的LOD和LOD 0 的画面差别很小
+        cam.Position = glm::vec3(0.0f, 0.0f, 25.0f);
+        cam.Yaw = -90.0f;
+        cam.Pitch = 0.0f;
+        unsigned int lod = selectLod(cooked[1], cam, height);
+        std::vector<unsigned char> near = render([&]() { buffers[1].DrawLod(0); });
+        std::vector<unsigned char> far = render([&]() { buffers[1].DrawLod(lod); });
+        ImageDifference lodDiff = CompareImages(near.data(), far.data(), width, height);
+        cout << "distant LOD: selected LOD " << lod << " (" << cooked[1].Lod(lod).IndexCount / 3 << " triangles), SSIM vs LOD 0 "
+             << lodDiff.Ssim << ", min window " << lodDiff.MinSsim << " ";
+        check(lod > 0 && lodDiff.Ssim > 0.97);
+
+        deleteImported(imported);
+        buffers[0].Release();
+        buffers[1].Release();
+        glBindFramebuffer(GL_FRAMEBUFFER, 0);
+        glDeleteFramebuffers(1, &FBO);
+        glDeleteRenderbuffers(1, &colorBuffer);
+        glDeleteRenderbuffers(1, &depthBuffer);
+    }
+
+    // 4. 加载时间：写成文件后 映射 + 上传 + glFinish
+    {
+        MeshCooker cooker;
+        bool ok = cooker.Write(source, SPHERE_MESH);
+        double loadMs = INFINITY;
+        for (int run = 0; ok && run < 5; run++) {
+            auto start = Clock::now();
+            CookedMesh mesh;
+            CookedMeshBuffers buffers;
+            ok = mesh.Open(SPHERE_MESH);
+            if (ok) {
+                buffers.Upload(mesh);
+                glFinish();
+            }
+            loadMs = std::min(loadMs, millisecondsSince(start));
+        }
+        cout << "load time: OBJ parse " << parseMs << " ms (" << objBytes / 1024 << " KB), cooked open + upload " << loadMs << " ms ";
+        check(ok && loadMs < parseMs);
+        std::remove(SPHERE_MESH);
+    }
+    std::remove(SPHERE_OBJ);
+
+    cout << (failures == 0 ? "cooked mesh OK" : "cooked mesh FAILED") << endl;
+    return failures;
+}
+
+// process all input: query GLFW whether relevant keys are pressed/released this frame and react accordingly
+// ---------------------------------------------------------------------------------------------------------
+void processInput(GLFWwindow *window)
+{
+    if (glfwGetKey(window, GLFW_KEY_ESCAPE) == GLFW_PRESS)
+        glfwSetWindowShouldClose(window, true);
+
+    if (glfwGetKey(window, GLFW_KEY_W) == GLFW_PRESS)
+        camera.ProcessKeyboard(FORWARD, deltaTime);
+    if (glfwGetKey(window, GLFW_KEY_S) == GLFW_PRESS)
+        camera.ProcessKeyboard(BACKWARD, deltaTime);
+    if (glfwGetKey(window, GLFW_KEY_A) == GLFW_PRESS)
+        camera.ProcessKeyboard(LEFT, deltaTime);
+    if (glfwGetKey(window, GLFW_KEY_D) == GLFW_PRESS)
+        camera.ProcessKeyboard(RIGHT, deltaTime);
+}
+
+// 按键事件：L 切换LOD（自动、0、1、……，超过最后一级时回到自动），C 开关小簇剔除
+// ---------------------------------------------------------------------------------------------------------
+void key_callback(GLFWwindow* window, int key, int scancode, int action, int mods)
+{
+    if (action != GLFW_PRESS)
+        return;
+    if (key == GLFW_KEY_L)
+        lodMode = lodMode + 1 >= (int) lodCount ? -1 : lodMode + 1;
+    if (key == GLFW_KEY_C)
+        meshletCulling = !meshletCulling;
+}
+
+// glfw: whenever the window size changed (by OS or user resize) this callback function executes
+// ---------------------------------------------------------------------------------------------
+void framebuffer_size_callback(GLFWwindow* window, int width, int height)
+{
+    glViewport(0, 0, width, height);
+}
+
+void mouse_callback(GLFWwindow* window, double xpos, double ypos) {
+    if (firstMouse) {
+        lastX = xpos;
+        lastY = ypos;
+        firstMouse = false;
+    }
+    float xoffset = xpos - lastX;
+    float yoffset = lastY - ypos;
+    lastX = xpos;
+    lastY = ypos;
+
+    camera.ProcessMouseMovement(xoffset, yoffset);
+}
+
+void scroll_callback(GLFWwindow* window, double xoffset, double yoffset)
+{
+    camera.ProcessMouseScroll(yoffset);
+}
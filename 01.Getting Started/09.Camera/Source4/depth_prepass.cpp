@@ -0,0 +1,737 @@
+// 深度预渲染示例：一大片互相遮挡的立方体，先用只有位置的顶点流和空片段着色器画一遍深度，
+// 再用 GL_EQUAL 深度测试画一遍着色，每个像素只有最前面的片段执行（很重的）片段着色器
+// 过度绘制用加法混合测量，自动模式下过度绘制高时才启用预渲染
+//
+// 按P切换预渲染模式（关 / 开 / 自动），按O切换绘制顺序（从后往前 / 打乱 / 从前往后），
+// 按V显示过度绘制的热度图，按T开关统计信息（每个 pass 的GPU时间、绘制调用、顶点、图元、片段），按 = / - 增减片段着色器的负载
+//
+// 运行参数：
+//   --stats <文件>  每一帧的统计按CSV格式写到文件中
+//   --validate   隐藏窗口，检查过度绘制的统计（和遮挡查询对比）、预渲染后每个像素只着色一次、画面相同、
+//                自动模式的切换，比较三种绘制顺序下开关预渲染的渲染时间，并检查统计信息和叠加显示
+#include <iostream>
+#include <cstring>
+#include <vector>
+#include <string>
+#include <random>
+#include <chrono>
+#include <cstdio>
+#include <fstream>
+#include <memory>
+#include <algorithm>
+#include <glad/glad.h>
+#include <GLFW/glfw3.h>
+
+#include <glm/glm.hpp>
+#include <glm/gtc/matrix_transform.hpp>
+#include <glm/gtc/type_ptr.hpp>
+
+
+#include <learnopengl/shader.h>
+#include <learnopengl/camera.h>
+#include <learnopengl/texture.h>
+#include <learnopengl/frame_stats.h>
+#include <learnopengl/depth_prepass.h>
+#include <learnopengl/image_compare.h>
+
+void framebuffer_size_callback(GLFWwindow* window, int width, int height);
+void mouse_callback(GLFWwindow* window, double xpos, double ypos);
+void scroll_callback(GLFWwindow* window, double xoffset, double yoffset);
+void key_callback(GLFWwindow* window, int key, int scancode, int action, int mods);
+void processInput(GLFWwindow *window);
+
+// 窗口大小
+const unsigned int SCR_WIDTH = 800;
+const unsigned int SCR_HEIGHT = 600;
+
+// camera
+Camera camera(glm::vec3(0.0f, 0.0f, 3.0f));
+
+bool firstMouse = true;
+double lastX = SCR_WIDTH / 2.0;
+double lastY = SCR_HEIGHT / 2.0;
+
+// timing
+float deltaTime = 0.0f;	// time between current frame and last frame
+float lastFrame = 0.0f;
+
+// 窗口的帧缓冲大小
+int fbWidth = SCR_WIDTH, fbHeight = SCR_HEIGHT;
+bool fbResized = false;
+
+// 立方体排成 COLUMNS x ROWS 的网格，沿 -z 方向 LAYERS 层，层与层在屏幕上大部分重叠
+const int COLUMNS = 10;
+const int ROWS = 8;
+const int LAYERS = 8;
+const int CUBE_COUNT = COLUMNS * ROWS * LAYERS;
+
+enum DrawOrder { ORDER_BACK_TO_FRONT = 0, ORDER_SHUFFLED, ORDER_FRONT_TO_BACK, ORDER_COUNT };
+const char *orderNames[ORDER_COUNT] = {"back-to-front", "shuffled", "front-to-back"};
+
+// P：预渲染模式；O：绘制顺序；V：热度图；T：统计信息；= / -：负载
+DepthPrepass prepass;
+DrawOrder drawOrder = ORDER_BACK_TO_FRONT;
+bool showOverdraw = false;
+bool showStats = true;
+int load = 64;
+
+std::vector<glm::mat4> cubeModels;
+
+// 按摄像机的距离排序，返回绘制的顺序
+std::vector<int> sortCubes(const Camera &cam, DrawOrder order);
+void drawCubes(Shader &shader, const Camera &cam, unsigned int VAO, float aspectRatio, const std::vector<int> &order,
+               FrameStats *stats = nullptr);
+int validate(Shader &sceneShader, Shader &depthShader, Shader &overdrawShader, unsigned int sceneVAO, unsigned int positionVAO);
+
+int main(int argc, char *argv[])
+{
+    using std::cout;
+    using std::endl;
+
+    bool validateMode = false;
+    std::string statsPath;
+    for (int i = 1; i < argc; i++) {
+        if (std::strcmp(argv[i], "--validate") == 0)
+            validateMode = true;
+        else if (std::strcmp(argv[i], "--stats") == 0 && i + 1 < argc)
+            statsPath = argv[++i];
+    }
+
+    // glfw: 初始化设置
+    // ------------------------------
+    glfwInit();
+    glfwWindowHint(GLFW_CONTEXT_VERSION_MAJOR, 3);
+    glfwWindowHint(GLFW_CONTEXT_VERSION_MINOR, 3);
+    glfwWindowHint(GLFW_OPENGL_PROFILE, GLFW_OPENGL_CORE_PROFILE);
+    if (validateMode)
+        glfwWindowHint(GLFW_VISIBLE, GLFW_FALSE);
+
+    // glfw: 创建窗口
+    // --------------------
+    GLFWwindow* window = glfwCreateWindow(SCR_WIDTH, SCR_HEIGHT, "LearnOpenGL", nullptr, nullptr);
+    if (window == nullptr)
+    {
+        cout << "Failed to create GLFW window" << endl;
+        glfwTerminate();
+        exit(EXIT_FAILURE);
+    }
+    glfwMakeContextCurrent(window);     // 设置OpenGL上下文
+    glfwSetFramebufferSizeCallback(window, framebuffer_size_callback);
+    glfwSetCursorPosCallback(window, mouse_callback);
+    glfwSetScrollCallback(window, scroll_callback);
+    glfwSetKeyCallback(window, key_callback);
+    if (!validateMode)
+        glfwSetInputMode(window, GLFW_CURSOR, GLFW_CURSOR_DISABLED);
+
+    // glad: 加载OpenGL函数指针
+    // ---------------------------------------
+    if (!gladLoadGLLoader((GLADloadproc)glfwGetProcAddress))
+    {
+        cout << "Failed to initialize GLAD" << endl;
+        exit(EXIT_FAILURE);
+    }
+    glEnable(GL_DEPTH_TEST);
+    glfwGetFramebufferSize(window, &fbWidth, &fbHeight);
+
+    // 定义编译着色器：着色、预渲染、过度绘制的测量、热度图
+    Shader sceneShader("depth_prepass_scene.vs", "dynamic_resolution.fs");
+    Shader depthShader("depth_prepass.vs", "depth_prepass.fs");
+    Shader overdrawShader("depth_prepass_scene.vs", "overdraw.fs");
+    Shader heatmapShader("overdraw_view.vs", "overdraw_view.fs");
+
+    // 定义顶点数据，包含位置、纹理坐标
+    float vertices[] = {        // 立方体的六个面
+            -0.5f, -0.5f, -0.5f,  0.0f, 0.0f,
+             0.5f, -0.5f, -0.5f,  1.0f, 0.0f,
+             0.5f,  0.5f, -0.5f,  1.0f, 1.0f,
+             0.5f,  0.5f, -0.5f,  1.0f, 1.0f,
+            -0.5f,  0.5f, -0.5f,  0.0f, 1.0f,
+            -0.5f, -0.5f, -0.5f,  0.0f, 0.0f,
+
+            -0.5f, -0.5f,  0.5f,  0.0f, 0.0f,
+             0.5f, -0.5f,  0.5f,  1.0f, 0.0f,
+             0.5f,  0.5f,  0.5f,  1.0f, 1.0f,
+             0.5f,  0.5f,  0.5f,  1.0f, 1.0f,
+            -0.5f,  0.5f,  0.5f,  0.0f, 1.0f,
+            -0.5f, -0.5f,  0.5f,  0.0f, 0.0f,
+
+            -0.5f,  0.5f,  0.5f,  1.0f, 0.0f,
+            -0.5f,  0.5f, -0.5f,  1.0f, 1.0f,
+            -0.5f, -0.5f, -0.5f,  0.0f, 1.0f,
+            -0.5f, -0.5f, -0.5f,  0.0f, 1.0f,
+            -0.5f, -0.5f,  0.5f,  0.0f, 0.0f,
+            -0.5f,  0.5f,  0.5f,  1.0f, 0.0f,
+
+             0.5f,  0.5f,  0.5f,  1.0f, 0.0f,
+             0.5f,  0.5f, -0.5f,  1.0f, 1.0f,
+             0.5f, -0.5f, -0.5f,  0.0f, 1.0f,
+             0.5f, -0.5f, -0.5f,  0.0f, 1.0f,
+             0.5f, -0.5f,  0.5f,  0.0f, 0.0f,
+             0.5f,  0.5f,  0.5f,  1.0f, 0.0f,
+
+            -0.5f, -0.5f, -0.5f,  0.0f, 1.0f,
+             0.5f, -0.5f, -0.5f,  1.0f, 1.0f,
+             0.5f, -0.5f,  0.5f,  1.0f, 0.0f,
+             0.5f, -0.5f,  0.5f,  1.0f, 0.0f,
+            -0.5f, -0.5f,  0.5f,  0.0f, 0.0f,
+            -0.5f, -0.5f, -0.5f,  0.0f, 1.0f,
+
+            -0.5f,  0.5f, -0.5f,  0.0f, 1.0f,
+             0.5f,  0.5f, -0.5f,  1.0f, 1.0f,
+             0.5f,  0.5f,  0.5f,  1.0f, 0.0f,
+             0.5f,  0.5f,  0.5f,  1.0f, 0.0f,
+            -0.5f,  0.5f,  0.5f,  0.0f, 0.0f,
+            -0.5f,  0.5f, -0.5f,  0.0f, 1.0f
+    };
+    // 预渲染只需要位置，单独放在一个紧凑的缓冲中（每个顶点12字节），顶点读取的带宽少一些
+    std::vector<float> positions;
+    for (int i = 0; i < 36; i++)
+        positions.insert(positions.end(), vertices + i * 5, vertices + i * 5 + 3);
+
+    // 创建顶点缓冲和顶点数组
+    unsigned int VAO, VBO, positionVAO, positionVBO, emptyVAO;
+    glGenVertexArrays(1, &VAO);
+    glGenBuffers(1, &VBO);
+
+    glBindVertexArray(VAO);
+    glBindBuffer(GL_ARRAY_BUFFER, VBO);
+    glBufferData(GL_ARRAY_BUFFER, sizeof(vertices), vertices, GL_STATIC_DRAW);
+
+    // 顶点位置
+    glVertexAttribPointer(0, 3, GL_FLOAT, GL_FALSE, 5 * sizeof(float), (void *)nullptr);
+    glEnableVertexAttribArray(0);
+    // 纹理坐标
+    glVertexAttribPointer(1, 2, GL_FLOAT, GL_FALSE, 5 * sizeof(float), (void *)(3 * sizeof(float)));
+    glEnableVertexAttribArray(1);
+
+    // 只有位置的顶点流
+    glGenVertexArrays(1, &positionVAO);
+    glGenBuffers(1, &positionVBO);
+    glBindVertexArray(positionVAO);
+    glBindBuffer(GL_ARRAY_BUFFER, positionVBO);
+    glBufferData(GL_ARRAY_BUFFER, positions.size() * sizeof(float), positions.data(), GL_STATIC_DRAW);
+    glVertexAttribPointer(0, 3, GL_FLOAT, GL_FALSE, 3 * sizeof(float), (void *)nullptr);
+    glEnableVertexAttribArray(0);
+
+    // 热度图的全屏三角形不需要顶点属性，但核心模式下必须绑定一个顶点数组
+    glGenVertexArrays(1, &emptyVAO);
+
+    // 创建纹理
+    unsigned int textures[2];
+    const char *texturePaths[2] = {"container.jpg", "awesomeface.png"};
+    for (int i = 0; i < 2; i++)
+        textures[i] = LoadTexture(texturePaths[i]);
+
+    // 激活纹理
+    sceneShader.use();
+    sceneShader.setInt("texture1", 0);
+    sceneShader.setInt("texture2", 1);
+    glActiveTexture(GL_TEXTURE0);
+    glBindTexture(GL_TEXTURE_2D, textures[0]);
+    glActiveTexture(GL_TEXTURE1);
+    glBindTexture(GL_TEXTURE_2D, textures[1]);
+    glActiveTexture(GL_TEXTURE0);
+
+    // 立方体：每一层错开半个间距，稍微旋转，相邻的立方体在屏幕上互相遮挡
+    for (int layer = 0; layer < LAYERS; layer++)
+        for (int row = 0; row < ROWS; row++)
+            for (int column = 0; column < COLUMNS; column++) {
+                float offset = (layer % 2) * 0.8f;
+                glm::vec3 position((column - COLUMNS / 2) * 1.6f + offset, (row - ROWS / 2) * 1.6f + offset, -4.0f - layer * 2.5f);
+                glm::mat4 model = glm::translate(glm::mat4(1.0f), position);
+                model = glm::rotate(model, glm::radians(7.0f * (column + row * 3 + layer * 5)), glm::vec3(1.0f, 0.3f, 0.5f));
+                model = glm::scale(model, glm::vec3(1.4f));
+                cubeModels.push_back(model);
+            }
+
+    if (validateMode) {
+        int failures = validate(sceneShader, depthShader, overdrawShader, VAO, positionVAO);
+        cout << (failures == 0 ? "depth prepass OK" : "depth prepass validation FAILED") << endl;
+        glDeleteVertexArrays(1, &VAO);
+        glDeleteVertexArrays(1, &positionVAO);
+        glDeleteVertexArrays(1, &emptyVAO);
+        glDeleteBuffers(1, &VBO);
+        glDeleteBuffers(1, &positionVBO);
+        glDeleteTextures(2, textures);
+        glfwTerminate();
+        return failures == 0 ? EXIT_SUCCESS : EXIT_FAILURE;
+    }
+
+    std::unique_ptr<OverdrawMeter> meter(new OverdrawMeter(fbWidth, fbHeight));
+    std::unique_ptr<FrameStats> stats(new FrameStats());
+    std::unique_ptr<StatsOverlay> overlay(new StatsOverlay("stats_overlay.vs", "stats_overlay.fs"));
+    if (!statsPath.empty() && !stats->OpenLog(statsPath))
+        cout << "Failed to open " << statsPath << endl;
+    OverdrawStats shown;
+    const char *modeNames[] = {"off", "on", "auto"};
+
+    // 渲染循环
+    // -----------
+    float titleTimer = 0.0f;
+    while (!glfwWindowShouldClose(window))
+    {
+        float currentFrame = glfwGetTime();
+        deltaTime = currentFrame - lastFrame;
+        lastFrame = currentFrame;
+
+        processInput(window);
+
+        if (fbResized) {
+            meter->Resize(fbWidth, fbHeight);
+            fbResized = false;
+        }
+        float aspectRatio = (float)fbWidth / (float)fbHeight;
+        std::vector<int> order = sortCubes(camera, drawOrder);
+        FrameStats *frameStats = stats.get();
+        // 每一遍都是单独的 pass，统计各自的时间、绘制调用和管线统计
+        auto drawDepth = [&]() {
+            frameStats->BeginPass("depth prepass");
+            drawCubes(depthShader, camera, positionVAO, aspectRatio, order, frameStats);
+            frameStats->EndPass();
+        };
+        auto drawColor = [&]() {
+            frameStats->BeginPass("shading");
+            sceneShader.use();
+            sceneShader.setInt("load", load);
+            frameStats->CountCalls(2);
+            drawCubes(sceneShader, camera, VAO, aspectRatio, order, frameStats);
+            frameStats->EndPass();
+        };
+        auto drawOverdraw = [&]() {
+            frameStats->BeginPass("overdraw");
+            drawCubes(overdrawShader, camera, VAO, aspectRatio, order, frameStats);
+            frameStats->EndPass();
+        };
+
+        stats->BeginFrame();
+        // 自动模式：隔一段时间测一次不用预渲染时的过度绘制
+        if (prepass.NeedsMeasurement())
+            prepass.ReportOverdraw((float) meter->Measure(drawOverdraw).FragmentsPerCoveredPixel);
+
+        if (showOverdraw) {
+            // 当前设置下实际着色的片段数
+            shown = meter->Measure([&]() { prepass.Render(drawDepth, drawOverdraw); });
+            stats->BeginPass("heatmap");
+            glViewport(0, 0, fbWidth, fbHeight);
+            glDisable(GL_DEPTH_TEST);
+            heatmapShader.use();
+            heatmapShader.setInt("counts", 0);
+            heatmapShader.setFloat("maxCount", 4.0f);
+            glBindTexture(GL_TEXTURE_2D, meter->Texture());
+            glBindVertexArray(emptyVAO);
+            glDrawArrays(GL_TRIANGLES, 0, 3);
+            stats->CountDraw();
+            glBindTexture(GL_TEXTURE_2D, textures[0]);
+            glEnable(GL_DEPTH_TEST);
+            stats->EndPass();
+        } else {
+            glViewport(0, 0, fbWidth, fbHeight);
+            glClearColor(0.2f, 0.3f, 0.3f, 1.0f);
+            glClear(GL_COLOR_BUFFER_BIT | GL_DEPTH_BUFFER_BIT);
+            prepass.Render(drawDepth, drawColor);
+        }
+
+        // 统计是两帧以前的
+        if (showStats && stats->HasResult()) {
+            stats->BeginPass("overlay");
+            overlay->AddFrameStats(stats->Latest(), fbWidth, fbHeight);
+            overlay->Draw(fbWidth, fbHeight, stats.get());
+        }
+        stats->EndFrame();
+
+        titleTimer += deltaTime;
+        if (titleTimer > 0.5f) {
+            titleTimer = 0.0f;
+            std::string title = std::string("Depth Prepass - ") + modeNames[prepass.Mode] +
+                                (prepass.Enabled() ? " (active)" : " (inactive)") + " - " + orderNames[drawOrder] +
+                                " - overdraw " + std::to_string(prepass.LastOverdraw());
+            if (showOverdraw)
+                title += " - shaded " + std::to_string(shown.FragmentsPerCoveredPixel) + " fragments/pixel";
+            else
+                title += " - GPU " + std::to_string(stats->Latest().GpuMs()) + " ms";
+            title += " - load " + std::to_string(load);
+            glfwSetWindowTitle(window, title.c_str());
+        }
+
+        // glfw: 交换颜色缓冲，检测事件
+        // -------------------------------------------------------------------------------
+        glfwSwapBuffers(window);
+        glfwPollEvents();
+    }
+
+    overlay.reset();
+    stats.reset();
+    meter.reset();
+    glDeleteVertexArrays(1, &VAO);
+    glDeleteVertexArrays(1, &positionVAO);
+    glDeleteVertexArrays(1, &emptyVAO);
+    glDeleteBuffers(1, &VBO);
+    glDeleteBuffers(1, &positionVBO);
+    glDeleteTextures(2, textures);
+
+    glfwTerminate();
+    return 0;
+}
+
+// 打乱的顺序是固定的，每帧一样
+// ---------------------------------------------------------------------------------------------------------
+std::vector<int> sortCubes(const Camera &cam, DrawOrder order)
+{
+    std::vector<int> indices(CUBE_COUNT);
+    for (int i = 0; i < CUBE_COUNT; i++)
+        indices[i] = i;
+    if (order == ORDER_SHUFFLED) {
+        std::mt19937 rng(7);
+        std::shuffle(indices.begin(), indices.end(), rng);
+        return indices;
+    }
+    std::vector<float> distance(CUBE_COUNT);
+    for (int i = 0; i < CUBE_COUNT; i++)
+        distance[i] = glm::length(glm::vec3(cubeModels[i][3]) - cam.Position);
+    std::sort(indices.begin(), indices.end(), [&](int a, int b) {
+        return order == ORDER_FRONT_TO_BACK ? distance[a] < distance[b] : distance[a] > distance[b];
+    });
+    return indices;
+}
+
+void drawCubes(Shader &shader, const Camera &cam, unsigned int VAO, float aspectRatio, const std::vector<int> &order, FrameStats *stats)
+{
+    shader.use();
+    shader.setMat4("projection", cam.GetProjectionMatrix(aspectRatio));
+    shader.setMat4("view", cam.GetViewMatrix());
+    glBindVertexArray(VAO);
+    for (int i : order) {
+        shader.setMat4("model", cubeModels[i]);
+        glDrawArrays(GL_TRIANGLES, 0, 36);
+    }
+    if (stats) {
+        stats->CountDraw((unsigned int) order.size());
+        // use、两个矩阵、绑定顶点数组，每个立方体一个矩阵
+        stats->CountCalls(4 + (unsigned int) order.size());
+    }
+}
+
+// 1. 过度绘制的统计：累加的片段总数和 GL_SAMPLES_PASSED 遮挡查询的结果相同
+// 2. 每种绘制顺序下：开启预渲染后着色的一遍每个像素只有一个片段（深度量化后相等的极少数像素除外），覆盖的像素不变，
+//    画面和不开启时相同
+// 3. 自动模式：过度绘制高时启用，低时关闭，两个阈值之间保持不变
+// 4. 渲染时间（glFinish 后的CPU时间，llvmpipe 上计时查询只包含提交命令的时间）
+// 5. 统计信息：读取的是两帧以前的结果、没有丢帧，绘制调用和管线统计的数量正确，叠加显示一次画出，CSV的行数正确
+// ---------------------------------------------------------------------------------------------------------
+int validate(Shader &sceneShader, Shader &depthShader, Shader &overdrawShader, unsigned int sceneVAO, unsigned int positionVAO)
+{
+    using std::cout;
+    using std::endl;
+
+    int failures = 0;
+    auto report = [&failures](const std::string &name, bool ok, const std::string &detail) {
+        cout << name << ": " << detail << (ok ? " OK" : " FAIL") << endl;
+        if (!ok)
+            failures++;
+    };
+
+    const int width = fbWidth, height = fbHeight;
+    float aspectRatio = (float) width / height;
+    OverdrawMeter meter(width, height);
+    DepthPrepass forced;
+
+    // 代替窗口，方便读回
+    unsigned int FBO, colorRbo, depthRbo;
+    glGenFramebuffers(1, &FBO);
+    glBindFramebuffer(GL_FRAMEBUFFER, FBO);
+    glGenRenderbuffers(1, &colorRbo);
+    glBindRenderbuffer(GL_RENDERBUFFER, colorRbo);
+    glRenderbufferStorage(GL_RENDERBUFFER, GL_RGBA8, width, height);
+    glFramebufferRenderbuffer(GL_FRAMEBUFFER, GL_COLOR_ATTACHMENT0, GL_RENDERBUFFER, colorRbo);
+    glGenRenderbuffers(1, &depthRbo);
+    glBindRenderbuffer(GL_RENDERBUFFER, depthRbo);
+    glRenderbufferStorage(GL_RENDERBUFFER, GL_DEPTH_COMPONENT24, width, height);
+    glFramebufferRenderbuffer(GL_FRAMEBUFFER, GL_DEPTH_ATTACHMENT, GL_RENDERBUFFER, depthRbo);
+
+    auto render = [&](const std::vector<int> &order, bool usePrepass, int shaderLoad) {
+        forced.Mode = usePrepass ? PREPASS_ON : PREPASS_OFF;
+        glBindFramebuffer(GL_FRAMEBUFFER, FBO);
+        glViewport(0, 0, width, height);
+        glClearColor(0.2f, 0.3f, 0.3f, 1.0f);
+        glClear(GL_COLOR_BUFFER_BIT | GL_DEPTH_BUFFER_BIT);
+        forced.Render([&]() { drawCubes(depthShader, camera, positionVAO, aspectRatio, order); },
+                      [&]() {
+                          sceneShader.use();
+                          sceneShader.setInt("load", shaderLoad);
+                          drawCubes(sceneShader, camera, sceneVAO, aspectRatio, order);
+                      });
+    };
+    auto readBack = [&]() {
+        std::vector<unsigned char> pixels((size_t) width * height * 4);
+        glBindFramebuffer(GL_FRAMEBUFFER, FBO);
+        glReadPixels(0, 0, width, height, GL_RGBA, GL_UNSIGNED_BYTE, pixels.data());
+        return pixels;
+    };
+    auto measureOverdraw = [&](const std::vector<int> &order, bool usePrepass) {
+        forced.Mode = usePrepass ? PREPASS_ON : PREPASS_OFF;
+        return meter.Measure([&]() {
+            forced.Render([&]() { drawCubes(depthShader, camera, positionVAO, aspectRatio, order); },
+                          [&]() { drawCubes(overdrawShader, camera, sceneVAO, aspectRatio, order); });
+        });
+    };
+
+    // 1. 和遮挡查询对比
+    {
+        std::vector<int> order = sortCubes(camera, ORDER_BACK_TO_FRONT);
+        unsigned int query;
+        GLuint64 samples = 0;
+        glGenQueries(1, &query);
+        OverdrawStats stats = meter.Measure([&]() {
+            glBeginQuery(GL_SAMPLES_PASSED, query);
+            drawCubes(overdrawShader, camera, sceneVAO, aspectRatio, order);
+            glEndQuery(GL_SAMPLES_PASSED);
+        });
+        glGetQueryObjectui64v(query, GL_QUERY_RESULT, &samples);
+        glDeleteQueries(1, &query);
+        report("overdraw meter", stats.TotalFragments == (double) samples,
+               std::to_string((long long) stats.TotalFragments) + " fragments counted, " + std::to_string(samples) + " samples passed");
+    }
+
+    // 2. 每种绘制顺序
+    double overdraw[ORDER_COUNT];
+    for (int o = 0; o < ORDER_COUNT; o++) {
+        std::vector<int> order = sortCubes(camera, (DrawOrder) o);
+        OverdrawStats without = measureOverdraw(order, false);
+        OverdrawStats with = measureOverdraw(order, true);
+        overdraw[o] = without.FragmentsPerCoveredPixel;
+        render(order, false, 8);
+        std::vector<unsigned char> a = readBack();
+        render(order, true, 8);
+        std::vector<unsigned char> b = readBack();
+        size_t different = 0;
+        for (size_t i = 0; i < a.size(); i += 4)
+            if (std::memcmp(&a[i], &b[i], 4) != 0)
+                different++;
+        // 两个表面的深度量化后相等时，GL_EQUAL 让两个片段都通过，后画的留下来；不用预渲染时是先画的留下来
+        // 只有这样的像素可以不同，而且要非常少
+        double ties = with.TotalFragments - with.Coverage * width * height;
+        bool ok = with.Coverage == without.Coverage && with.MaxFragments <= 2 && ties < width * height * 1e-4 &&
+                  (double) different <= ties;
+        report(std::string("prepass, ") + orderNames[o], ok,
+               "shaded fragments per covered pixel " + std::to_string(without.FragmentsPerCoveredPixel) + " -> " +
+               std::to_string(with.FragmentsPerCoveredPixel) + " (max " + std::to_string(without.MaxFragments) + " -> " +
+               std::to_string(with.MaxFragments) + ", coverage " + std::to_string(without.Coverage * 100.0) +
+               "%), " + std::to_string((long long) ties) + " depth ties, " + std::to_string(different) + " pixels differ");
+    }
+    report("overdraw by order", overdraw[ORDER_BACK_TO_FRONT] > overdraw[ORDER_SHUFFLED] &&
+                                overdraw[ORDER_SHUFFLED] > overdraw[ORDER_FRONT_TO_BACK],
+           "back-to-front > shuffled > front-to-back");
+
+    // 3. 自动模式：每4帧测一次，依次是从后往前（启用）、打乱（保持启用）、从前往后（关闭）、打乱（启用）；
+    //    在两个阈值之间时保持当前状态
+    {
+        DepthPrepass automatic;
+        automatic.MeasureInterval = 3;
+        const DrawOrder sequence[] = {ORDER_BACK_TO_FRONT, ORDER_SHUFFLED, ORDER_FRONT_TO_BACK, ORDER_SHUFFLED};
+        const bool expected[] = {true, true, false, true};
+        bool ok = true;
+        int measurements = 0;
+        std::string detail = "overdraw";
+        for (int frame = 0; frame < 16; frame++) {
+            if (automatic.NeedsMeasurement()) {
+                std::vector<int> order = sortCubes(camera, sequence[measurements]);
+                automatic.ReportOverdraw((float) measureOverdraw(order, false).FragmentsPerCoveredPixel);
+                detail += " " + std::to_string(automatic.LastOverdraw()) + (automatic.Enabled() ? " (on)" : " (off)");
+                measurements++;
+            }
+            ok = ok && automatic.Enabled() == expected[measurements - 1];
+        }
+        ok = ok && measurements == 4 && automatic.Switches() == 3;
+        float between = (automatic.EnableOverdraw + automatic.DisableOverdraw) * 0.5f;
+        automatic.ReportOverdraw(between);
+        ok = ok && automatic.Enabled();
+        automatic.ReportOverdraw(1.0f);
+        automatic.ReportOverdraw(between);
+        ok = ok && !automatic.Enabled();
+        report("auto mode", ok, detail + ", thresholds " + std::to_string(automatic.DisableOverdraw) + " / " +
+                                std::to_string(automatic.EnableOverdraw));
+    }
+
+    // 4. 渲染时间，取3帧中最短的
+    {
+        auto measure = [&](const std::vector<int> &order, bool usePrepass, int shaderLoad) {
+            double best = 1e30;
+            for (int i = 0; i < 3; i++) {
+                glFinish();
+                auto start = std::chrono::high_resolution_clock::now();
+                render(order, usePrepass, shaderLoad);
+                glFinish();
+                best = std::min(best, std::chrono::duration<double, std::milli>(std::chrono::high_resolution_clock::now() - start).count());
+            }
+            return best;
+        };
+        for (int shaderLoad : {0, 64}) {
+            for (int o = 0; o < ORDER_COUNT; o++) {
+                std::vector<int> order = sortCubes(camera, (DrawOrder) o);
+                double off = measure(order, false, shaderLoad), on = measure(order, true, shaderLoad);
+                cout << "load " << shaderLoad << ", " << orderNames[o] << ": " << off << " ms without prepass, "
+                     << on << " ms with prepass (" << off / on << "x)" << endl;
+            }
+        }
+    }
+
+    // 5. 统计信息：每帧结束后 glFinish，第N帧开始时第 N - 2 帧的结果一定已经完成，不会丢掉
+    {
+        std::unique_ptr<FrameStats> stats(new FrameStats());
+        std::unique_ptr<StatsOverlay> overlay(new StatsOverlay("stats_overlay.vs", "stats_overlay.fs"));
+        const char *logPath = "depth_prepass_stats.csv";
+        stats->OpenLog(logPath);
+        std::vector<int> order = sortCubes(camera, ORDER_BACK_TO_FRONT);
+        forced.Mode = PREPASS_ON;
+        const int FRAMES = 6;
+        bool latencyOk = true;
+        size_t overlayVertices = 0;
+        for (int f = 0; f < FRAMES; f++) {
+            stats->BeginFrame();
+            latencyOk = latencyOk && (f < 2 ? !stats->HasResult() : stats->Latest().Frame == stats->Frame() - FrameStats::Latency);
+            glBindFramebuffer(GL_FRAMEBUFFER, FBO);
+            glViewport(0, 0, width, height);
+            glClearColor(0.2f, 0.3f, 0.3f, 1.0f);
+            glClear(GL_COLOR_BUFFER_BIT | GL_DEPTH_BUFFER_BIT);
+            forced.Render([&]() {
+                              stats->BeginPass("depth prepass");
+                              drawCubes(depthShader, camera, positionVAO, aspectRatio, order, stats.get());
+                              stats->EndPass();
+                          },
+                          [&]() {
+                              stats->BeginPass("shading");
+                              sceneShader.use();
+                              sceneShader.setInt("load", 0);
+                              drawCubes(sceneShader, camera, sceneVAO, aspectRatio, order, stats.get());
+                              stats->EndPass();
+                          });
+            stats->BeginPass("overlay");
+            if (stats->HasResult())
+                overlay->AddFrameStats(stats->Latest(), width, height);
+            else
+                overlay->Text(8.0f, 8.0f, "WAITING FOR FRAME STATS");
+            overlayVertices = overlay->Draw(width, height, stats.get());
+            stats->EndPass();
+            stats->EndFrame();
+            glFinish();
+        }
+        stats->CloseLog();
+        std::vector<unsigned char> withOverlay = readBack();
+
+        const FrameStatsResult &result = stats->Latest();
+        bool ok = latencyOk && stats->Dropped() == 0 && result.Passes.size() == 3 &&
+                  result.Passes[0].Draws == CUBE_COUNT && result.Passes[1].Draws == CUBE_COUNT && result.Passes[2].Draws == 1;
+        report("frame stats", ok, "frame " + std::to_string(stats->Frame()) + " reads frame " + std::to_string(result.Frame) +
+                                  ", " + std::to_string(stats->Dropped()) + " dropped, draws per pass " +
+                                  std::to_string(result.Passes[0].Draws) + " / " + std::to_string(result.Passes[1].Draws) + " / " +
+                                  std::to_string(result.Passes[2].Draws));
+
+        // 管线统计：两遍提交的顶点和图元都是 36 / 12 乘以立方体数
+        if (stats->PipelineStatistics()) {
+            const PassStats &depthPass = result.Passes[0], &shading = result.Passes[1];
+            bool counts = depthPass.Vertices == 36ull * CUBE_COUNT && depthPass.Primitives == 12ull * CUBE_COUNT &&
+                          shading.Vertices == 36ull * CUBE_COUNT && shading.Primitives == 12ull * CUBE_COUNT;
+            // 片段着色器的执行次数怎么算由实现决定：有的驱动只算通过早期深度测试的，llvmpipe 算的是光栅化出的全部片段
+            double pixels = (double) width * height;
+            report("pipeline statistics", counts,
+                   "shading pass " + std::to_string(shading.Vertices) + " vertices, " + std::to_string(shading.Primitives) +
+                   " primitives, " + std::to_string(shading.ClippedPrimitives) + " after clipping, " +
+                   std::to_string(shading.FragmentInvocations / pixels) + " fragment invocations/pixel");
+        } else
+            cout << "pipeline statistics: not supported, only timings and call counts are collected" << endl;
+
+        // 叠加显示：一次绘制，左上角的像素有变化
+        render(order, true, 0);
+        std::vector<unsigned char> plain = readBack();
+        size_t changed = 0;
+        for (int y = height - 60; y < height; y++)
+            for (int x = 0; x < 300; x++) {
+                size_t i = ((size_t) y * width + x) * 4;
+                if (std::memcmp(&plain[i], &withOverlay[i], 4) != 0)
+                    changed++;
+            }
+        report("stats overlay", changed > 3000, std::to_string(overlayVertices / 6) + " quads in one draw, " +
+                                                std::to_string(changed) + " pixels changed in the top-left corner");
+
+        // CSV：表头加上每一帧每个 pass 一行
+        std::ifstream log(logPath);
+        std::string line;
+        int lines = 0;
+        while (std::getline(log, line))
+            lines++;
+        log.close();
+        std::remove(logPath);
+        int expectedLines = 1 + (FRAMES - (int) FrameStats::Latency) * 3;
+        report("stats log", lines == expectedLines, std::to_string(lines) + " lines written");
+    }
+
+    glBindFramebuffer(GL_FRAMEBUFFER, 0);
+    glDeleteFramebuffers(1, &FBO);
+    glDeleteRenderbuffers(1, &colorRbo);
+    glDeleteRenderbuffers(1, &depthRbo);
+    return failures;
+}
+
+// process all input: query GLFW whether relevant keys are pressed/released this frame and react accordingly
+// ---------------------------------------------------------------------------------------------------------
+void processInput(GLFWwindow *window)
+{
+    if (glfwGetKey(window, GLFW_KEY_ESCAPE) == GLFW_PRESS)
+        glfwSetWindowShouldClose(window, true);
+
+    if (glfwGetKey(window, GLFW_KEY_W) == GLFW_PRESS)
+        camera.ProcessKeyboard(FORWARD, deltaTime);
+    if (glfwGetKey(window, GLFW_KEY_S) == GLFW_PRESS)
+        camera.ProcessKeyboard(BACKWARD, deltaTime);
+    if (glfwGetKey(window, GLFW_KEY_A) == GLFW_PRESS)
+        camera.ProcessKeyboard(LEFT, deltaTime);
+    if (glfwGetKey(window, GLFW_KEY_D) == GLFW_PRESS)
+        camera.ProcessKeyboard(RIGHT, deltaTime);
+}
+
+void key_callback(GLFWwindow* window, int key, int scancode, int action, int mods)
+{
+    if (action != GLFW_PRESS && action != GLFW_REPEAT)
+        return;
+    if (key == GLFW_KEY_P && action == GLFW_PRESS)
+        prepass.Mode = (DepthPrepassMode) ((prepass.Mode + 1) % 3);
+    if (key == GLFW_KEY_O && action == GLFW_PRESS)
+        drawOrder = (DrawOrder) ((drawOrder + 1) % ORDER_COUNT);
+    if (key == GLFW_KEY_V && action == GLFW_PRESS)
+        showOverdraw = !showOverdraw;
+    if (key == GLFW_KEY_T && action == GLFW_PRESS)
+        showStats = !showStats;
+    if (key == GLFW_KEY_EQUAL)
+        load += 16;
+    if (key == GLFW_KEY_MINUS)
+        load = std::max(load - 16, 0);
+}
+
+// glfw: whenever the window size changed (by OS or user resize) this callback function executes
+// ---------------------------------------------------------------------------------------------
+void framebuffer_size_callback(GLFWwindow* window, int width, int height)
+{
+    glViewport(0, 0, width, height);
+    fbWidth = width;
+    fbHeight = height;
+    fbResized = true;
+}
+
+void mouse_callback(GLFWwindow* window, double xpos, double ypos) {
+    if (firstMouse) {
+        lastX = xpos;
+        lastY = ypos;
+        firstMouse = false;
+    }
+    float xoffset = xpos - lastX;
+    float yoffset = lastY - ypos;
+    lastX = xpos;
+    lastY = ypos;
+
+    camera.ProcessMouseMovement(xoffset, yoffset);
+}
+
+void scroll_callback(GLFWwindow* window, double xoffset, double yoffset)
+{
+    camera.ProcessMouseScroll(yoffset);
+}
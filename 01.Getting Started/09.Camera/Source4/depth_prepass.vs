@@ -0,0 +1,13 @@
+#version 330 core
+// 深度预渲染：只有位置的顶点流，和 depth_prepass_scene.vs 的 gl_Position 计算完全相同
+layout (location = 0) in vec3 aPos;
+
+uniform mat4 model;
+uniform mat4 view;
+uniform mat4 projection;
+
+invariant gl_Position;
+
+void main() {
+	gl_Position = projection * view * model * vec4(aPos, 1.0f);
+}
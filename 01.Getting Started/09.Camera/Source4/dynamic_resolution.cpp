@@ -0,0 +1,500 @@
+// 动态分辨率示例：场景渲染到离屏缓冲，内部分辨率在窗口大小的50%~100%之间自动调整，最后线性放大到窗口
+// 用GPU计时查询测量场景的渲染时间，控制器带迟滞，把GPU时间保持在目标（60帧）以内
+// 按R开关动态分辨率，按 = / - 增减片段着色器的负载
+//
+// 运行参数：
+//   --validate   隐藏窗口，先用模拟的负载曲线（GPU时间和像素数成正比，计时结果延迟3帧，带噪声）检查控制器的收敛和迟滞，
+//                再在真实GPU上检查计时查询、放大后的画面和闭环调整
+#include <iostream>
+#include <cstring>
+#include <vector>
+#include <string>
+#include <deque>
+#include <random>
+#include <cmath>
+#include <glad/glad.h>
+#include <GLFW/glfw3.h>
+
+#include <glm/glm.hpp>
+#include <glm/gtc/matrix_transform.hpp>
+#include <glm/gtc/type_ptr.hpp>
+
+
+#include <learnopengl/shader.h>
+#include <learnopengl/camera.h>
+#include <learnopengl/texture.h>
+#include <learnopengl/dynamic_resolution.h>
+
+void framebuffer_size_callback(GLFWwindow* window, int width, int height);
+void mouse_callback(GLFWwindow* window, double xpos, double ypos);
+void scroll_callback(GLFWwindow* window, double xoffset, double yoffset);
+void key_callback(GLFWwindow* window, int key, int scancode, int action, int mods);
+void processInput(GLFWwindow *window);
+
+// 窗口大小
+const unsigned int SCR_WIDTH = 800;
+const unsigned int SCR_HEIGHT = 600;
+
+// 目标GPU时间（毫秒）
+const double TARGET_MS = 1000.0 / 60.0;
+
+// camera
+Camera camera(glm::vec3(0.0f, 0.0f, 3.0f));
+
+bool firstMouse = true;
+double lastX = SCR_WIDTH / 2.0;
+double lastY = SCR_HEIGHT / 2.0;
+
+// timing
+float deltaTime = 0.0f;	// time between current frame and last frame
+float lastFrame = 0.0f;
+
+// 窗口的帧缓冲大小
+int fbWidth = SCR_WIDTH, fbHeight = SCR_HEIGHT;
+bool fbResized = false;
+
+// R：动态分辨率；= / -：负载
+bool dynamicResolution = true;
+int load = 256;
+
+// 世界空间中立方体的位置，最后一个是背景墙
+const glm::vec3 cubePositions[] = {
+        glm::vec3( 0.0f,  0.0f,  0.0f),
+        glm::vec3( 2.0f,  5.0f, -15.0f),
+        glm::vec3(-1.5f, -2.2f, -2.5f),
+        glm::vec3(-3.8f, -2.0f, -12.3f),
+        glm::vec3( 2.4f, -0.4f, -3.5f),
+        glm::vec3(-1.7f,  3.0f, -7.5f),
+        glm::vec3( 1.3f, -2.0f, -2.5f),
+        glm::vec3( 1.5f,  2.0f, -2.5f),
+        glm::vec3( 1.5f,  0.2f, -1.5f),
+        glm::vec3(-1.3f,  1.0f, -1.5f),
+        glm::vec3( 0.0f,  0.0f, -40.0f)
+};
+const int CUBE_COUNT = sizeof(cubePositions) / sizeof(cubePositions[0]);
+
+void drawScene(Shader &shader, const Camera &cam, unsigned int VAO, float aspectRatio, int shaderLoad);
+int validateController();
+int validateGpu(Shader &shader, unsigned int VAO);
+
+int main(int argc, char *argv[])
+{
+    using std::cout;
+    using std::endl;
+
+    bool validateMode = argc > 1 && std::strcmp(argv[1], "--validate") == 0;
+
+    // glfw: 初始化设置
+    // ------------------------------
+    glfwInit();
+    glfwWindowHint(GLFW_CONTEXT_VERSION_MAJOR, 3);
+    glfwWindowHint(GLFW_CONTEXT_VERSION_MINOR, 3);
+    glfwWindowHint(GLFW_OPENGL_PROFILE, GLFW_OPENGL_CORE_PROFILE);
+    if (validateMode)
+        glfwWindowHint(GLFW_VISIBLE, GLFW_FALSE);
+
+    // glfw: 创建窗口
+    // --------------------
+    GLFWwindow* window = glfwCreateWindow(SCR_WIDTH, SCR_HEIGHT, "LearnOpenGL", nullptr, nullptr);
+    if (window == nullptr)
+    {
+        cout << "Failed to create GLFW window" << endl;
+        glfwTerminate();
+        exit(EXIT_FAILURE);
+    }
+    glfwMakeContextCurrent(window);     // 设置OpenGL上下文
+    glfwSetFramebufferSizeCallback(window, framebuffer_size_callback);
+    glfwSetCursorPosCallback(window, mouse_callback);
+    glfwSetScrollCallback(window, scroll_callback);
+    glfwSetKeyCallback(window, key_callback);
+    if (!validateMode)
+        glfwSetInputMode(window, GLFW_CURSOR, GLFW_CURSOR_DISABLED);
+
+    // glad: 加载OpenGL函数指针
+    // ---------------------------------------
+    if (!gladLoadGLLoader((GLADloadproc)glfwGetProcAddress))
+    {
+        cout << "Failed to initialize GLAD" << endl;
+        exit(EXIT_FAILURE);
+    }
+    glEnable(GL_DEPTH_TEST);
+    glfwGetFramebufferSize(window, &fbWidth, &fbHeight);
+
+    // 定义编译着色器
+    Shader ourShader("6.1.coordinate_systems.vs", "dynamic_resolution.fs");
+
+    // 定义顶点数据，包含位置、纹理坐标
+    float vertices[] = {        // 立方体的六个面
+            -0.5f, -0.5f, -0.5f,  0.0f, 0.0f,
+             0.5f, -0.5f, -0.5f,  1.0f, 0.0f,
+             0.5f,  0.5f, -0.5f,  1.0f, 1.0f,
+             0.5f,  0.5f, -0.5f,  1.0f, 1.0f,
+            -0.5f,  0.5f, -0.5f,  0.0f, 1.0f,
+            -0.5f, -0.5f, -0.5f,  0.0f, 0.0f,
+
+            -0.5f, -0.5f,  0.5f,  0.0f, 0.0f,
+             0.5f, -0.5f,  0.5f,  1.0f, 0.0f,
+             0.5f,  0.5f,  0.5f,  1.0f, 1.0f,
+             0.5f,  0.5f,  0.5f,  1.0f, 1.0f,
+            -0.5f,  0.5f,  0.5f,  0.0f, 1.0f,
+            -0.5f, -0.5f,  0.5f,  0.0f, 0.0f,
+
+            -0.5f,  0.5f,  0.5f,  1.0f, 0.0f,
+            -0.5f,  0.5f, -0.5f,  1.0f, 1.0f,
+            -0.5f, -0.5f, -0.5f,  0.0f, 1.0f,
+            -0.5f, -0.5f, -0.5f,  0.0f, 1.0f,
+            -0.5f, -0.5f,  0.5f,  0.0f, 0.0f,
+            -0.5f,  0.5f,  0.5f,  1.0f, 0.0f,
+
+             0.5f,  0.5f,  0.5f,  1.0f, 0.0f,
+             0.5f,  0.5f, -0.5f,  1.0f, 1.0f,
+             0.5f, -0.5f, -0.5f,  0.0f, 1.0f,
+             0.5f, -0.5f, -0.5f,  0.0f, 1.0f,
+             0.5f, -0.5f,  0.5f,  0.0f, 0.0f,
+             0.5f,  0.5f,  0.5f,  1.0f, 0.0f,
+
+            -0.5f, -0.5f, -0.5f,  0.0f, 1.0f,
+             0.5f, -0.5f, -0.5f,  1.0f, 1.0f,
+             0.5f, -0.5f,  0.5f,  1.0f, 0.0f,
+             0.5f, -0.5f,  0.5f,  1.0f, 0.0f,
+            -0.5f, -0.5f,  0.5f,  0.0f, 0.0f,
+            -0.5f, -0.5f, -0.5f,  0.0f, 1.0f,
+
+            -0.5f,  0.5f, -0.5f,  0.0f, 1.0f,
+             0.5f,  0.5f, -0.5f,  1.0f, 1.0f,
+             0.5f,  0.5f,  0.5f,  1.0f, 0.0f,
+             0.5f,  0.5f,  0.5f,  1.0f, 0.0f,
+            -0.5f,  0.5f,  0.5f,  0.0f, 0.0f,
+            -0.5f,  0.5f, -0.5f,  0.0f, 1.0f
+    };
+
+    // 创建顶点缓冲和顶点数组
+    unsigned int VAO, VBO;
+    glGenVertexArrays(1, &VAO);
+    glGenBuffers(1, &VBO);
+
+    glBindVertexArray(VAO);
+    glBindBuffer(GL_ARRAY_BUFFER, VBO);
+    glBufferData(GL_ARRAY_BUFFER, sizeof(vertices), vertices, GL_STATIC_DRAW);
+
+    // 顶点位置
+    glVertexAttribPointer(0, 3, GL_FLOAT, GL_FALSE, 5 * sizeof(float), (void *)nullptr);
+    glEnableVertexAttribArray(0);
+    // 纹理坐标
+    glVertexAttribPointer(1, 2, GL_FLOAT, GL_FALSE, 5 * sizeof(float), (void *)(3 * sizeof(float)));
+    glEnableVertexAttribArray(1);
+
+    // 创建纹理
+    unsigned int textures[2];
+    const char *texturePaths[2] = {"container.jpg", "awesomeface.png"};
+    for (int i = 0; i < 2; i++)
+        textures[i] = LoadTexture(texturePaths[i]);
+
+    // 激活纹理
+    ourShader.use();
+    ourShader.setInt("texture1", 0);
+    ourShader.setInt("texture2", 1);
+    glActiveTexture(GL_TEXTURE0);
+    glBindTexture(GL_TEXTURE_2D, textures[0]);
+    glActiveTexture(GL_TEXTURE1);
+    glBindTexture(GL_TEXTURE_2D, textures[1]);
+
+    if (validateMode) {
+        int failures = validateController() + validateGpu(ourShader, VAO);
+        cout << (failures == 0 ? "dynamic resolution OK" : "dynamic resolution validation FAILED") << endl;
+        glDeleteVertexArrays(1, &VAO);
+        glDeleteBuffers(1, &VBO);
+        glDeleteTextures(2, textures);
+        glfwTerminate();
+        return failures == 0 ? EXIT_SUCCESS : EXIT_FAILURE;
+    }
+
+    ScaledRenderTarget target(fbWidth, fbHeight);
+    ResolutionController controller(TARGET_MS);
+    GpuTimer timer;
+    double gpuMs = 0.0;
+
+    // 渲染循环
+    // -----------
+    float titleTimer = 0.0f;
+    while (!glfwWindowShouldClose(window))
+    {
+        float currentFrame = glfwGetTime();
+        deltaTime = currentFrame - lastFrame;
+        lastFrame = currentFrame;
+
+        processInput(window);
+
+        if (fbResized) {
+            target.Resize(fbWidth, fbHeight);
+            fbResized = false;
+        }
+        target.SetScale(dynamicResolution ? controller.Scale() : 1.0f);
+
+        // 只计时场景本身，放大复制的开销和分辨率关系不大
+        timer.Begin();
+        target.Bind();
+        glClearColor(0.2f, 0.3f, 0.3f, 1.0f);
+        glClear(GL_COLOR_BUFFER_BIT | GL_DEPTH_BUFFER_BIT);
+        drawScene(ourShader, camera, VAO, (float)fbWidth / (float)fbHeight, load);
+        timer.End();
+        target.Upscale();
+
+        // 计时结果晚几帧才到，控制器用的是到达时最新的一个
+        if (timer.Poll(gpuMs) && dynamicResolution)
+            controller.Update(gpuMs);
+
+        titleTimer += deltaTime;
+        if (titleTimer > 0.5f) {
+            titleTimer = 0.0f;
+            std::string title = std::string("Dynamic Resolution - ") + (dynamicResolution ? "on" : "off") +
+                                " - " + std::to_string((int) std::lround(target.Scale() * 100.0f)) + "% (" +
+                                std::to_string(target.RenderWidth()) + "x" + std::to_string(target.RenderHeight()) +
+                                ") - GPU " + std::to_string(gpuMs) + " ms / target " + std::to_string(TARGET_MS) +
+                                " ms - load " + std::to_string(load) + " - " + std::to_string(controller.Changes()) + " changes";
+            glfwSetWindowTitle(window, title.c_str());
+        }
+
+        // glfw: 交换颜色缓冲，检测事件
+        // -------------------------------------------------------------------------------
+        glfwSwapBuffers(window);
+        glfwPollEvents();
+    }
+
+    glDeleteVertexArrays(1, &VAO);
+    glDeleteBuffers(1, &VBO);
+    glDeleteTextures(2, textures);
+
+    glfwTerminate();
+    return 0;
+}
+
+// 内部分辨率的宽高按同一比例缩放，宽高比不变
+// ---------------------------------------------------------------------------------------------------------
+void drawScene(Shader &shader, const Camera &cam, unsigned int VAO, float aspectRatio, int shaderLoad)
+{
+    shader.use();
+    shader.setInt("load", shaderLoad);
+    shader.setMat4("projection", cam.GetProjectionMatrix(aspectRatio));
+    shader.setMat4("view", cam.GetViewMatrix());
+    glBindVertexArray(VAO);
+    for (int i = 0; i < CUBE_COUNT; i++) {
+        glm::mat4 model = glm::mat4(1.0f);
+        model = glm::translate(model, cubePositions[i]);
+        if (i == CUBE_COUNT - 1)
+            model = glm::scale(model, glm::vec3(80.0f, 60.0f, 1.0f));
+        else
+            model = glm::rotate(model, glm::radians(20.0f * i), glm::vec3(1.0f, 0.3f, 0.5f));
+        shader.setMat4("model", model);
+        glDrawArrays(GL_TRIANGLES, 0, 36);
+    }
+}
+
+// 模拟的负载：GPU时间 = 固定开销 + 负载 * 满分辨率的像素开销 * Scale^2，带 ±5% 的噪声，计时结果延迟3帧才到
+// 负载分四段：略超目标、远低于目标、大幅超过目标、最低分辨率也超过目标
+// 每段的最后100帧要稳定（没有任何调整），并且前三段的GPU时间不超过目标
+// ---------------------------------------------------------------------------------------------------------
+int validateController()
+{
+    using std::cout;
+    using std::endl;
+
+    struct Phase { const char *Name; double Load; };
+    const Phase phases[] = {{"slightly over target", 1.0}, {"light", 0.4}, {"heavy", 1.6}, {"overloaded", 4.0}};
+    const int PHASE_FRAMES = 300, SETTLE_FRAMES = 200, LATENCY = 3;
+    auto gpuTime = [](double phaseLoad, float scale) { return 1.0 + phaseLoad * 20.0 * scale * scale; };
+
+    auto run = [&](ResolutionController &controller, bool report) {
+        std::mt19937 rng(3);
+        std::uniform_real_distribution<double> noise(0.95, 1.05);
+        std::deque<double> inFlight;
+        int failures = 0;
+        for (const Phase &phase : phases) {
+            unsigned int changesBefore = 0;
+            for (int frame = 0; frame < PHASE_FRAMES; frame++) {
+                if (frame == SETTLE_FRAMES)
+                    changesBefore = controller.Changes();
+                inFlight.push_back(gpuTime(phase.Load, controller.Scale()) * noise(rng));
+                if (inFlight.size() > LATENCY) {
+                    controller.Update(inFlight.front());
+                    inFlight.pop_front();
+                }
+            }
+            float scale = controller.Scale();
+            double ms = gpuTime(phase.Load, scale);
+            unsigned int settledChanges = controller.Changes() - changesBefore;
+            bool ok = settledChanges == 0 && scale >= controller.MinScale && scale <= controller.MaxScale;
+            if (phase.Load * 20.0 * controller.MinScale * controller.MinScale + 1.0 <= controller.TargetMs)
+                ok = ok && ms <= controller.TargetMs;
+            else
+                ok = ok && scale == controller.MinScale;
+            if (phase.Load <= 0.4)
+                ok = ok && scale == controller.MaxScale;
+            if (report)
+                cout << "  " << phase.Name << ": scale " << scale << ", GPU " << ms << " ms, "
+                     << settledChanges << " changes after settling" << (ok ? " OK" : " FAIL") << endl;
+            if (!ok)
+                failures++;
+        }
+        return failures;
+    };
+
+    cout << "controller (synthetic load, target " << TARGET_MS << " ms):" << endl;
+    ResolutionController controller(TARGET_MS);
+    int failures = run(controller, true);
+    cout << "  " << controller.Changes() << " resolution changes in total" << endl;
+
+    // 对比：没有迟滞、没有冷却的控制器在噪声和延迟下会不停地来回调整
+    ResolutionController noHysteresis(TARGET_MS);
+    noHysteresis.LowerBound = noHysteresis.UpperBound = 0.9;
+    noHysteresis.DecreaseFrames = noHysteresis.IncreaseFrames = 1;
+    noHysteresis.Cooldown = 0;
+    noHysteresis.Smoothing = 1.0;
+    run(noHysteresis, false);
+    cout << "  without hysteresis: " << noHysteresis.Changes() << " resolution changes" << endl;
+    return failures;
+}
+
+// 真实GPU上：降低分辨率后计时结果要明显变小；放大后的画面和满分辨率的画面相近；闭环调整后GPU时间降到目标附近
+// ---------------------------------------------------------------------------------------------------------
+int validateGpu(Shader &shader, unsigned int VAO)
+{
+    using std::cout;
+    using std::endl;
+
+    ScaledRenderTarget target(fbWidth, fbHeight);
+    // 代替窗口，方便读回
+    ScaledRenderTarget window(fbWidth, fbHeight);
+    GpuTimer timer;
+    float aspectRatio = (float)fbWidth / (float)fbHeight;
+
+    auto renderFrame = [&](float scale) {
+        target.SetScale(scale);
+        timer.Begin();
+        target.Bind();
+        glClearColor(0.2f, 0.3f, 0.3f, 1.0f);
+        glClear(GL_COLOR_BUFFER_BIT | GL_DEPTH_BUFFER_BIT);
+        drawScene(shader, camera, VAO, aspectRatio, load);
+        timer.End();
+        target.Upscale(window.Framebuffer());
+    };
+    // 等GPU执行完，取几帧中最小的时间，减少其他程序的干扰
+    auto measure = [&](float scale) {
+        double best = 1e30, ms;
+        for (int i = 0; i < 5; i++) {
+            renderFrame(scale);
+            glFinish();
+            if (timer.Poll(ms))
+                best = std::min(best, ms);
+        }
+        return best;
+    };
+    auto readBack = [&]() {
+        std::vector<unsigned char> pixels((size_t)fbWidth * fbHeight * 4);
+        glBindFramebuffer(GL_FRAMEBUFFER, window.Framebuffer());
+        glReadPixels(0, 0, fbWidth, fbHeight, GL_RGBA, GL_UNSIGNED_BYTE, pixels.data());
+        return pixels;
+    };
+
+    int failures = 0;
+    double fullMs = measure(1.0f);
+    std::vector<unsigned char> full = readBack();
+    double halfMs = measure(0.5f);
+    std::vector<unsigned char> half = readBack();
+    bool timerOk = fullMs > 0.0 && fullMs < 1e30 && halfMs < fullMs * 0.75;
+    cout << "GPU timer: 100% " << fullMs << " ms, 50% " << halfMs << " ms" << (timerOk ? " OK" : " FAIL") << endl;
+    if (!timerOk)
+        failures++;
+
+    // 放大后的画面：和满分辨率相比差别明显的像素只能是边缘上的少数
+    size_t different = 0;
+    for (size_t i = 0; i < full.size(); i += 4) {
+        int diff = 0;
+        for (int c = 0; c < 3; c++)
+            diff = std::max(diff, std::abs(full[i + c] - half[i + c]));
+        if (diff > 64)
+            different++;
+    }
+    double fraction = (double) different / (full.size() / 4);
+    bool upscaleOk = fraction < 0.1;
+    cout << "upscale: " << fraction * 100.0 << "% of pixels differ from the full-resolution image" << (upscaleOk ? " OK" : " FAIL") << endl;
+    if (!upscaleOk)
+        failures++;
+
+    // 闭环：目标定为满分辨率时间的一半，控制器要把分辨率降下来
+    ResolutionController controller(fullMs * 0.5);
+    double ms = fullMs;
+    for (int frame = 0; frame < 120; frame++) {
+        renderFrame(controller.Scale());
+        glFinish();
+        if (timer.Poll(ms))
+            controller.Update(ms);
+    }
+    double settledMs = measure(controller.Scale());
+    bool loopOk = controller.Scale() <= 0.8f && settledMs < fullMs * 0.75;
+    cout << "closed loop: target " << controller.TargetMs << " ms, settled at scale " << controller.Scale() << ", "
+         << settledMs << " ms" << (loopOk ? " OK" : " FAIL") << endl;
+    if (!loopOk)
+        failures++;
+
+    glBindFramebuffer(GL_FRAMEBUFFER, 0);
+    return failures;
+}
+
+// process all input: query GLFW whether relevant keys are pressed/released this frame and react accordingly
+// ---------------------------------------------------------------------------------------------------------
+void processInput(GLFWwindow *window)
+{
+    if (glfwGetKey(window, GLFW_KEY_ESCAPE) == GLFW_PRESS)
+        glfwSetWindowShouldClose(window, true);
+
+    if (glfwGetKey(window, GLFW_KEY_W) == GLFW_PRESS)
+        camera.ProcessKeyboard(FORWARD, deltaTime);
+    if (glfwGetKey(window, GLFW_KEY_S) == GLFW_PRESS)
+        camera.ProcessKeyboard(BACKWARD, deltaTime);
+    if (glfwGetKey(window, GLFW_KEY_A) == GLFW_PRESS)
+        camera.ProcessKeyboard(LEFT, deltaTime);
+    if (glfwGetKey(window, GLFW_KEY_D) == GLFW_PRESS)
+        camera.ProcessKeyboard(RIGHT, deltaTime);
+}
+
+void key_callback(GLFWwindow* window, int key, int scancode, int action, int mods)
+{
+    if (action != GLFW_PRESS && action != GLFW_REPEAT)
+        return;
+    if (key == GLFW_KEY_R && action == GLFW_PRESS)
+        dynamicResolution = !dynamicResolution;
+    if (key == GLFW_KEY_EQUAL)
+        load += 16;
+    if (key == GLFW_KEY_MINUS)
+        load = std::max(load - 16, 0);
+}
+
+// glfw: whenever the window size changed (by OS or user resize) this callback function executes
+// ---------------------------------------------------------------------------------------------
+void framebuffer_size_callback(GLFWwindow* window, int width, int height)
+{
+    glViewport(0, 0, width, height);
+    fbWidth = width;
+    fbHeight = height;
+    fbResized = true;
+}
+
+void mouse_callback(GLFWwindow* window, double xpos, double ypos) {
+    if (firstMouse) {
+        lastX = xpos;
+        lastY = ypos;
+        firstMouse = false;
+    }
+    float xoffset = xpos - lastX;
+    float yoffset = lastY - ypos;
+    lastX = xpos;
+    lastY = ypos;
+
+    camera.ProcessMouseMovement(xoffset, yoffset);
+}
+
+void scroll_callback(GLFWwindow* window, double xoffset, double yoffset)
+{
+    camera.ProcessMouseScroll(yoffset);
+}
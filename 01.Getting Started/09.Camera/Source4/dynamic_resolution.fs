@@ -0,0 +1,19 @@
+#version 330 core
+out vec4 FragColor;
+
+in vec2 TexCoord;
+
+uniform sampler2D texture1;
+uniform sampler2D texture2;
+// 每个像素额外的循环次数，代替复杂的光照计算，用来调节GPU负载
+uniform int load;
+
+void main() {
+	vec4 color = mix(texture(texture1, TexCoord), texture(texture2, TexCoord), 0.2f);
+	float shade = 0.0f;
+	for (int i = 0; i < load; i++)
+		shade += sin(dot(TexCoord, vec2(12.9898f, 78.233f)) * float(i + 1)) * 0.5f + 0.5f;
+	if (load > 0)
+		color.rgb *= 0.85f + 0.15f * shade / float(load);
+	FragColor = color;
+}
@@ -0,0 +1,524 @@
+// 固定步长示例：摄像机移动和立方体旋转按60Hz的固定步长模拟，渲染时在最近两步之间插值
+// 鼠标视角仍然按帧处理，键盘移动作为每一步的输入，模拟结果和帧率无关
+// 按T切换模拟在渲染线程中运行还是在单独的模拟线程中运行，按I开关插值，按J模拟不稳定的渲染负载（随机卡顿0~40ms）
+//
+// 运行参数：
+//   --validate   不创建窗口，用不同的帧时间序列（60Hz、144Hz、随机抖动 + 卡顿）和模拟线程运行同一段脚本输入，
+//                同一步的状态必须逐位相同；匀速移动时插值后的位置必须和真实时间成线性关系
+#include <iostream>
+#include <cstring>
+#include <vector>
+#include <string>
+#include <mutex>
+#include <random>
+#include <thread>
+#include <cmath>
+#include <algorithm>
+#include <glad/glad.h>
+#include <GLFW/glfw3.h>
+
+#include <glm/glm.hpp>
+#include <glm/gtc/matrix_transform.hpp>
+#include <glm/gtc/type_ptr.hpp>
+
+
+#include <learnopengl/shader.h>
+#include <learnopengl/camera.h>
+#include <learnopengl/texture.h>
+#include <learnopengl/frame_loop.h>
+
+void framebuffer_size_callback(GLFWwindow* window, int width, int height);
+void mouse_callback(GLFWwindow* window, double xpos, double ypos);
+void scroll_callback(GLFWwindow* window, double xoffset, double yoffset);
+void key_callback(GLFWwindow* window, int key, int scancode, int action, int mods);
+void processInput(GLFWwindow *window);
+
+// 窗口大小
+const unsigned int SCR_WIDTH = 800;
+const unsigned int SCR_HEIGHT = 600;
+
+// 模拟步长
+const double SIM_STEP = 1.0 / 60.0;
+const int CUBE_COUNT = 10;
+
+// camera
+Camera camera(glm::vec3(0.0f, 0.0f, 3.0f));
+
+bool firstMouse = true;
+double lastX = SCR_WIDTH / 2.0;
+double lastY = SCR_HEIGHT / 2.0;
+
+// timing
+float deltaTime = 0.0f;	// time between current frame and last frame
+float lastFrame = 0.0f;
+
+// T：模拟线程；I：插值；J：随机卡顿
+bool threadedSimulation = false;
+bool interpolation = true;
+bool variableLoad = false;
+
+// 模拟的状态，只包含会随时间变化的部分
+struct SimState {
+    uint64_t Tick = 0;
+    glm::vec3 Position = glm::vec3(0.0f, 0.0f, 3.0f);     // 摄像机位置
+    float Angles[CUBE_COUNT] = {};                          // 立方体的旋转角度
+};
+
+// 每一步的输入：按下的方向键和这一刻摄像机的朝向
+struct TickInput {
+    bool Keys[4] = {};      // 按 Camera_Movement 的顺序
+    glm::vec3 Front = glm::vec3(0.0f, 0.0f, -1.0f);
+    glm::vec3 Right = glm::vec3(1.0f, 0.0f, 0.0f);
+};
+
+// 主线程写入、模拟线程读取的输入
+std::mutex inputMutex;
+TickInput currentInput;
+
+// 把state推进一步
+void simulate(SimState &state, const TickInput &input, double step);
+SimState interpolate(const SimState &previous, const SimState &current, float alpha);
+TickInput readInput();
+int validate();
+
+int main(int argc, char *argv[])
+{
+    using std::cout;
+    using std::endl;
+
+    // 校验只用到CPU上的模拟，不需要窗口
+    if (argc > 1 && std::strcmp(argv[1], "--validate") == 0)
+        return validate();
+
+    // glfw: 初始化设置
+    // ------------------------------
+    glfwInit();
+    glfwWindowHint(GLFW_CONTEXT_VERSION_MAJOR, 3);
+    glfwWindowHint(GLFW_CONTEXT_VERSION_MINOR, 3);
+    glfwWindowHint(GLFW_OPENGL_PROFILE, GLFW_OPENGL_CORE_PROFILE);
+
+    // glfw: 创建窗口
+    // --------------------
+    GLFWwindow* window = glfwCreateWindow(SCR_WIDTH, SCR_HEIGHT, "LearnOpenGL", nullptr, nullptr);
+    if (window == nullptr)
+    {
+        cout << "Failed to create GLFW window" << endl;
+        glfwTerminate();
+        exit(EXIT_FAILURE);
+    }
+    glfwMakeContextCurrent(window);     // 设置OpenGL上下文
+    glfwSetFramebufferSizeCallback(window, framebuffer_size_callback);
+    glfwSetCursorPosCallback(window, mouse_callback);
+    glfwSetScrollCallback(window, scroll_callback);
+    glfwSetKeyCallback(window, key_callback);
+    glfwSetInputMode(window, GLFW_CURSOR, GLFW_CURSOR_DISABLED);
+
+    // glad: 加载OpenGL函数指针
+    // ---------------------------------------
+    if (!gladLoadGLLoader((GLADloadproc)glfwGetProcAddress))
+    {
+        cout << "Failed to initialize GLAD" << endl;
+        exit(EXIT_FAILURE);
+    }
+    glEnable(GL_DEPTH_TEST);
+
+    // 定义编译着色器
+    Shader ourShader("6.1.coordinate_systems.vs", "6.1.coordinate_systems.fs");
+
+    // 定义顶点数据，包含位置、纹理坐标
+    float vertices[] = {        // 立方体的六个面
+            -0.5f, -0.5f, -0.5f,  0.0f, 0.0f,
+             0.5f, -0.5f, -0.5f,  1.0f, 0.0f,
+             0.5f,  0.5f, -0.5f,  1.0f, 1.0f,
+             0.5f,  0.5f, -0.5f,  1.0f, 1.0f,
+            -0.5f,  0.5f, -0.5f,  0.0f, 1.0f,
+            -0.5f, -0.5f, -0.5f,  0.0f, 0.0f,
+
+            -0.5f, -0.5f,  0.5f,  0.0f, 0.0f,
+             0.5f, -0.5f,  0.5f,  1.0f, 0.0f,
+             0.5f,  0.5f,  0.5f,  1.0f, 1.0f,
+             0.5f,  0.5f,  0.5f,  1.0f, 1.0f,
+            -0.5f,  0.5f,  0.5f,  0.0f, 1.0f,
+            -0.5f, -0.5f,  0.5f,  0.0f, 0.0f,
+
+            -0.5f,  0.5f,  0.5f,  1.0f, 0.0f,
+            -0.5f,  0.5f, -0.5f,  1.0f, 1.0f,
+            -0.5f, -0.5f, -0.5f,  0.0f, 1.0f,
+            -0.5f, -0.5f, -0.5f,  0.0f, 1.0f,
+            -0.5f, -0.5f,  0.5f,  0.0f, 0.0f,
+            -0.5f,  0.5f,  0.5f,  1.0f, 0.0f,
+
+             0.5f,  0.5f,  0.5f,  1.0f, 0.0f,
+             0.5f,  0.5f, -0.5f,  1.0f, 1.0f,
+             0.5f, -0.5f, -0.5f,  0.0f, 1.0f,
+             0.5f, -0.5f, -0.5f,  0.0f, 1.0f,
+             0.5f, -0.5f,  0.5f,  0.0f, 0.0f,
+             0.5f,  0.5f,  0.5f,  1.0f, 0.0f,
+
+            -0.5f, -0.5f, -0.5f,  0.0f, 1.0f,
+             0.5f, -0.5f, -0.5f,  1.0f, 1.0f,
+             0.5f, -0.5f,  0.5f,  1.0f, 0.0f,
+             0.5f, -0.5f,  0.5f,  1.0f, 0.0f,
+            -0.5f, -0.5f,  0.5f,  0.0f, 0.0f,
+            -0.5f, -0.5f, -0.5f,  0.0f, 1.0f,
+
+            -0.5f,  0.5f, -0.5f,  0.0f, 1.0f,
+             0.5f,  0.5f, -0.5f,  1.0f, 1.0f,
+             0.5f,  0.5f,  0.5f,  1.0f, 0.0f,
+             0.5f,  0.5f,  0.5f,  1.0f, 0.0f,
+            -0.5f,  0.5f,  0.5f,  0.0f, 0.0f,
+            -0.5f,  0.5f, -0.5f,  0.0f, 1.0f
+    };
+
+    // 世界空间中立方体的位置
+    glm::vec3 cubePositions[] = {
+            glm::vec3( 0.0f,  0.0f,  0.0f),
+            glm::vec3( 2.0f,  5.0f, -15.0f),
+            glm::vec3(-1.5f, -2.2f, -2.5f),
+            glm::vec3(-3.8f, -2.0f, -12.3f),
+            glm::vec3( 2.4f, -0.4f, -3.5f),
+            glm::vec3(-1.7f,  3.0f, -7.5f),
+            glm::vec3( 1.3f, -2.0f, -2.5f),
+            glm::vec3( 1.5f,  2.0f, -2.5f),
+            glm::vec3( 1.5f,  0.2f, -1.5f),
+            glm::vec3(-1.3f,  1.0f, -1.5f)
+    };
+
+    // 创建顶点缓冲和顶点数组
+    unsigned int VAO, VBO;
+    glGenVertexArrays(1, &VAO);
+    glGenBuffers(1, &VBO);
+
+    glBindVertexArray(VAO);
+    glBindBuffer(GL_ARRAY_BUFFER, VBO);
+    glBufferData(GL_ARRAY_BUFFER, sizeof(vertices), vertices, GL_STATIC_DRAW);
+
+    // 顶点位置
+    glVertexAttribPointer(0, 3, GL_FLOAT, GL_FALSE, 5 * sizeof(float), (void *)nullptr);
+    glEnableVertexAttribArray(0);
+    // 纹理坐标
+    glVertexAttribPointer(1, 2, GL_FLOAT, GL_FALSE, 5 * sizeof(float), (void *)(3 * sizeof(float)));
+    glEnableVertexAttribArray(1);
+
+    // 创建纹理
+    unsigned int textures[2];
+    const char *texturePaths[2] = {"container.jpg", "awesomeface.png"};
+    for (int i = 0; i < 2; i++)
+        textures[i] = LoadTexture(texturePaths[i]);
+
+    // 激活纹理
+    ourShader.use();
+    ourShader.setInt("texture1", 0);
+    ourShader.setInt("texture2", 1);
+
+    // 单线程：渲染循环里用累加器推进模拟；多线程：模拟线程自己计时
+    FixedTimestep timestep(SIM_STEP);
+    SimulationThread<SimState> simulationThread(SIM_STEP);
+    SimState previous, current;
+    bool threadRunning = false;
+    std::mt19937 rng(1);
+
+    // 渲染循环
+    // -----------
+    float titleTimer = 0.0f;
+    uint64_t titleTicks = 0;
+    unsigned int frames = 0, maxSteps = 0;
+    while (!glfwWindowShouldClose(window))
+    {
+        float currentFrame = glfwGetTime();
+        deltaTime = currentFrame - lastFrame;
+        lastFrame = currentFrame;
+
+        processInput(window);
+
+        // 切换模式时从当前状态继续模拟
+        if (threadedSimulation && !threadRunning) {
+            simulationThread.Start(current, [](SimState &state, uint64_t, double step) {
+                simulate(state, readInput(), step);
+            });
+            threadRunning = true;
+        } else if (!threadedSimulation && threadRunning) {
+            simulationThread.Stop();
+            float unused;
+            simulationThread.Latest(previous, current, unused);
+            timestep.Reset();
+            threadRunning = false;
+        }
+
+        SimState rendered;
+        float alpha;
+        if (threadRunning) {
+            simulationThread.Latest(previous, current, alpha);
+        } else {
+            unsigned int steps = timestep.Advance(deltaTime);
+            TickInput input = readInput();
+            for (unsigned int i = 0; i < steps; i++) {
+                previous = current;
+                simulate(current, input, timestep.Step());
+            }
+            maxSteps = std::max(maxSteps, steps);
+            alpha = timestep.Alpha();
+        }
+        rendered = interpolation ? interpolate(previous, current, alpha) : current;
+
+        glClearColor(0.2f, 0.3f, 0.3f, 1.0f);
+        glClear(GL_COLOR_BUFFER_BIT | GL_DEPTH_BUFFER_BIT);
+
+        glActiveTexture(GL_TEXTURE0);
+        glBindTexture(GL_TEXTURE_2D, textures[0]);
+        glActiveTexture(GL_TEXTURE1);
+        glBindTexture(GL_TEXTURE_2D, textures[1]);
+
+        ourShader.use();
+        camera.Position = rendered.Position;
+        ourShader.setMat4("projection", camera.GetProjectionMatrix((float)SCR_WIDTH / (float)SCR_HEIGHT));
+        ourShader.setMat4("view", camera.GetViewMatrix());
+
+        glBindVertexArray(VAO);
+        for (unsigned int i = 0; i < CUBE_COUNT; i++) {
+            glm::mat4 model = glm::mat4(1.0f);
+            model = glm::translate(model, cubePositions[i]);
+            model = glm::rotate(model, glm::radians(rendered.Angles[i]), glm::vec3(1.0f, 0.3f, 0.5f));
+            ourShader.setMat4("model", model);
+            glDrawArrays(GL_TRIANGLES, 0, 36);
+        }
+
+        // 随机卡顿，模拟不稳定的渲染负载
+        if (variableLoad)
+            std::this_thread::sleep_for(std::chrono::milliseconds(std::uniform_int_distribution<int>(0, 40)(rng)));
+
+        frames++;
+        titleTimer += deltaTime;
+        if (titleTimer > 0.5f) {
+            uint64_t ticks = current.Tick;
+            double dropped = threadRunning ? simulationThread.DroppedTime() : timestep.DroppedTime();
+            std::string title = std::string("Fixed Timestep - ") + (threadRunning ? "simulation thread" : "single thread") +
+                                (interpolation ? ", interpolated" : "") + (variableLoad ? ", variable load" : "") +
+                                " - " + std::to_string((int) (frames / titleTimer)) + " fps, " +
+                                std::to_string((int) ((ticks - titleTicks) / titleTimer)) + " ticks/s, " +
+                                (threadRunning ? "" : "max " + std::to_string(maxSteps) + " steps/frame, ") +
+                                "dropped " + std::to_string(dropped) + " s";
+            glfwSetWindowTitle(window, title.c_str());
+            titleTimer = 0.0f;
+            titleTicks = ticks;
+            frames = 0;
+            maxSteps = 0;
+        }
+
+        // glfw: 交换颜色缓冲，检测事件
+        // -------------------------------------------------------------------------------
+        glfwSwapBuffers(window);
+        glfwPollEvents();
+    }
+    simulationThread.Stop();
+
+    glDeleteVertexArrays(1, &VAO);
+    glDeleteBuffers(1, &VBO);
+    glDeleteTextures(2, textures);
+
+    glfwTerminate();
+    return 0;
+}
+
+void simulate(SimState &state, const TickInput &input, double step)
+{
+    float velocity = SPEED * (float) step;
+    if (input.Keys[FORWARD])
+        state.Position += input.Front * velocity;
+    if (input.Keys[BACKWARD])
+        state.Position -= input.Front * velocity;
+    if (input.Keys[LEFT])
+        state.Position -= input.Right * velocity;
+    if (input.Keys[RIGHT])
+        state.Position += input.Right * velocity;
+    // 每个立方体的转速不同，角度保持在 [0, 360) 内
+    for (int i = 0; i < CUBE_COUNT; i++)
+        state.Angles[i] = std::fmod(state.Angles[i] + 20.0f * (i + 1) * (float) step, 360.0f);
+    state.Tick++;
+}
+
+SimState interpolate(const SimState &previous, const SimState &current, float alpha)
+{
+    SimState result = current;
+    result.Position = glm::mix(previous.Position, current.Position, alpha);
+    for (int i = 0; i < CUBE_COUNT; i++) {
+        // 角度可能刚好跨过360度
+        float delta = current.Angles[i] - previous.Angles[i];
+        if (delta < -180.0f)
+            delta += 360.0f;
+        result.Angles[i] = previous.Angles[i] + delta * alpha;
+    }
+    return result;
+}
+
+TickInput readInput()
+{
+    std::lock_guard<std::mutex> lock(inputMutex);
+    return currentInput;
+}
+
+// 不同的帧时间序列运行同一段脚本输入，同一步的状态逐位比较；匀速移动时检查插值的平滑程度
+// ---------------------------------------------------------------------------------------------------------
+int validate()
+{
+    using std::cout;
+    using std::endl;
+
+    // 脚本输入：每半秒换一个方向键，朝向缓慢转动
+    auto scriptedInput = [](uint64_t tick) {
+        TickInput input;
+        input.Keys[(tick / 30) % 4] = true;
+        float yaw = glm::radians(-90.0f + 0.5f * tick);
+        input.Front = glm::vec3(cos(yaw), 0.0f, sin(yaw));
+        input.Right = glm::normalize(glm::cross(input.Front, glm::vec3(0.0f, 1.0f, 0.0f)));
+        return input;
+    };
+    auto runTo = [&](SimState &state, uint64_t tick) {
+        while (state.Tick < tick)
+            simulate(state, scriptedInput(state.Tick), SIM_STEP);
+    };
+    auto same = [](const SimState &a, const SimState &b) {
+        return a.Tick == b.Tick && std::memcmp(&a.Position, &b.Position, sizeof(a.Position)) == 0 &&
+               std::memcmp(a.Angles, b.Angles, sizeof(a.Angles)) == 0;
+    };
+
+    const uint64_t ticks = 600;
+    SimState reference;
+    runTo(reference, ticks);
+
+    int failures = 0;
+    // 1. 不同帧时间序列，模拟到同一步的状态必须完全相同，每帧的步数不超过上限
+    std::mt19937 rng(7);
+    struct Sequence { const char *Name; std::function<double(int)> FrameTime; };
+    const Sequence sequences[] = {
+            {"60 Hz",            [](int) { return 1.0 / 60.0; }},
+            {"144 Hz",           [](int) { return 1.0 / 144.0; }},
+            {"jitter + hitches", [&](int frame) {
+                return frame % 97 == 96 ? 0.4 : std::uniform_real_distribution<double>(0.001, 0.05)(rng); }}
+    };
+    for (const Sequence &sequence : sequences) {
+        FixedTimestep timestep(SIM_STEP);
+        SimState state;
+        unsigned int maxSteps = 0;
+        int frame = 0;
+        while (state.Tick < ticks) {
+            unsigned int steps = timestep.Advance(sequence.FrameTime(frame++));
+            maxSteps = std::max(maxSteps, steps);
+            for (unsigned int i = 0; i < steps && state.Tick < ticks; i++)
+                simulate(state, scriptedInput(state.Tick), timestep.Step());
+        }
+        bool ok = same(state, reference) && maxSteps <= timestep.MaxSteps();
+        cout << sequence.Name << ": " << frame << " frames, max " << maxSteps << " steps/frame, dropped "
+             << timestep.DroppedTime() << " s" << (ok ? " OK" : " MISMATCH") << endl;
+        if (!ok)
+            failures++;
+    }
+
+    // 2. 模拟线程：和单线程模拟到同一步的状态相同，previous正好晚一步
+    {
+        SimulationThread<SimState> thread(SIM_STEP);
+        thread.Start(SimState(), [&](SimState &state, uint64_t, double step) {
+            simulate(state, scriptedInput(state.Tick), step);
+        });
+        std::this_thread::sleep_for(std::chrono::milliseconds(300));
+        SimState previous, current;
+        float alpha;
+        thread.Latest(previous, current, alpha);
+        thread.Stop();
+        SimState expected, expectedPrevious;
+        runTo(expectedPrevious, current.Tick - 1);
+        runTo(expected, current.Tick);
+        bool ok = current.Tick > 0 && same(current, expected) && same(previous, expectedPrevious) && alpha >= 0.0f && alpha <= 1.0f;
+        cout << "simulation thread: " << current.Tick << " ticks in 0.3 s, alpha " << alpha << (ok ? " OK" : " MISMATCH") << endl;
+        if (!ok)
+            failures++;
+    }
+
+    // 3. 匀速向前移动，帧时间随机抖动（不超过步数上限）：插值后的位置比真实时间正好晚一步，误差只有浮点舍入
+    {
+        TickInput forward;
+        forward.Keys[FORWARD] = true;
+        FixedTimestep timestep(SIM_STEP);
+        SimState previous, current;
+        double elapsed = 0.0, interpolatedError = 0.0, steppedError = 0.0;
+        for (int frame = 0; frame < 300; frame++) {
+            double frameTime = std::uniform_real_distribution<double>(0.001, 0.03)(rng);
+            elapsed += frameTime;
+            unsigned int steps = timestep.Advance(frameTime);
+            for (unsigned int i = 0; i < steps; i++) {
+                previous = current;
+                simulate(current, forward, timestep.Step());
+            }
+            if (current.Tick < 1)
+                continue;
+            float expected = 3.0f - SPEED * (float) (elapsed - SIM_STEP);
+            interpolatedError = std::max(interpolatedError, (double) std::fabs(interpolate(previous, current, timestep.Alpha()).Position.z - expected));
+            steppedError = std::max(steppedError, (double) std::fabs(current.Position.z - expected));
+        }
+        bool ok = interpolatedError < 1e-3;
+        cout << "constant velocity: max position error interpolated " << interpolatedError << ", without interpolation "
+             << steppedError << (ok ? " OK" : " FAIL") << endl;
+        if (!ok)
+            failures++;
+    }
+
+    cout << (failures == 0 ? "fixed timestep simulation is reproducible" : "fixed timestep validation FAILED") << endl;
+    return failures == 0 ? EXIT_SUCCESS : EXIT_FAILURE;
+}
+
+// process all input: query GLFW whether relevant keys are pressed/released this frame and react accordingly
+// ---------------------------------------------------------------------------------------------------------
+void processInput(GLFWwindow *window)
+{
+    if (glfwGetKey(window, GLFW_KEY_ESCAPE) == GLFW_PRESS)
+        glfwSetWindowShouldClose(window, true);
+
+    // 方向键和朝向作为下一步模拟的输入，摄像机不在这里移动
+    TickInput input;
+    input.Keys[FORWARD] = glfwGetKey(window, GLFW_KEY_W) == GLFW_PRESS;
+    input.Keys[BACKWARD] = glfwGetKey(window, GLFW_KEY_S) == GLFW_PRESS;
+    input.Keys[LEFT] = glfwGetKey(window, GLFW_KEY_A) == GLFW_PRESS;
+    input.Keys[RIGHT] = glfwGetKey(window, GLFW_KEY_D) == GLFW_PRESS;
+    input.Front = camera.GetFront();
+    input.Right = camera.GetRight();
+    std::lock_guard<std::mutex> lock(inputMutex);
+    currentInput = input;
+}
+
+void key_callback(GLFWwindow* window, int key, int scancode, int action, int mods)
+{
+    if (action != GLFW_PRESS)
+        return;
+    if (key == GLFW_KEY_T)
+        threadedSimulation = !threadedSimulation;
+    if (key == GLFW_KEY_I)
+        interpolation = !interpolation;
+    if (key == GLFW_KEY_J)
+        variableLoad = !variableLoad;
+}
+
+// glfw: whenever the window size changed (by OS or user resize) this callback function executes
+// ---------------------------------------------------------------------------------------------
+void framebuffer_size_callback(GLFWwindow* window, int width, int height)
+{
+    glViewport(0, 0, width, height);
+}
+
+void mouse_callback(GLFWwindow* window, double xpos, double ypos) {
+    if (firstMouse) {
+        lastX = xpos;
+        lastY = ypos;
+        firstMouse = false;
+    }
+    float xoffset = xpos - lastX;
+    float yoffset = lastY - ypos;
+    lastX = xpos;
+    lastY = ypos;
+
+    camera.ProcessMouseMovement(xoffset, yoffset);
+}
+
+void scroll_callback(GLFWwindow* window, double xoffset, double yoffset)
+{
+    camera.ProcessMouseScroll(yoffset);
+}
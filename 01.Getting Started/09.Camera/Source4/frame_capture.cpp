@@ -0,0 +1,520 @@
+// 异步帧捕获示例：每帧通过PBO环读回窗口的画面，工作线程编码，渲染线程只发起读取和检查栅栏
+// 按C开关PNG序列（capture_00000.png ...），按V开关视频录制（capture.y4m，可以用 ffmpeg -i capture.y4m 编码），
+// 按B切换环满时等待还是丢帧；标题栏显示每帧在渲染线程上花的时间
+//
+// 运行参数：
+//   --validate   隐藏窗口，在1920x1080的离屏缓冲上渲染60帧，异步捕获每一帧，和同步glReadPixels的结果逐帧比较，
+//                并检查PNG和Y4M输出能被正确读回
+#include <iostream>
+#include <cstring>
+#include <cstdio>
+#include <vector>
+#include <string>
+#include <chrono>
+#include <mutex>
+#include <glad/glad.h>
+#include <GLFW/glfw3.h>
+
+#include <glm/glm.hpp>
+#include <glm/gtc/matrix_transform.hpp>
+#include <glm/gtc/type_ptr.hpp>
+
+
+#include <stb_image.h>
+#include <learnopengl/shader.h>
+#include <learnopengl/camera.h>
+#include <learnopengl/texture.h>
+#include <learnopengl/frame_capture.h>
+
+void framebuffer_size_callback(GLFWwindow* window, int width, int height);
+void mouse_callback(GLFWwindow* window, double xpos, double ypos);
+void scroll_callback(GLFWwindow* window, double xoffset, double yoffset);
+void key_callback(GLFWwindow* window, int key, int scancode, int action, int mods);
+void processInput(GLFWwindow *window);
+
+// 窗口大小
+const unsigned int SCR_WIDTH = 800;
+const unsigned int SCR_HEIGHT = 600;
+
+// 校验时离屏缓冲的大小
+const int VALIDATE_WIDTH = 1920;
+const int VALIDATE_HEIGHT = 1080;
+const int VALIDATE_FRAMES = 60;
+
+// camera
+Camera camera(glm::vec3(0.0f, 0.0f, 3.0f));
+
+bool firstMouse = true;
+double lastX = SCR_WIDTH / 2.0;
+double lastY = SCR_HEIGHT / 2.0;
+
+// timing
+float deltaTime = 0.0f;	// time between current frame and last frame
+float lastFrame = 0.0f;
+
+// 窗口的帧缓冲大小
+int fbWidth = SCR_WIDTH, fbHeight = SCR_HEIGHT;
+bool fbResized = false;
+
+// C：PNG序列；V：视频；B：环满时等待
+bool capturePng = false;
+bool recordVideo = false;
+bool blockWhenBusy = true;
+
+// 世界空间中立方体的位置
+const glm::vec3 cubePositions[] = {
+        glm::vec3( 0.0f,  0.0f,  0.0f),
+        glm::vec3( 2.0f,  5.0f, -15.0f),
+        glm::vec3(-1.5f, -2.2f, -2.5f),
+        glm::vec3(-3.8f, -2.0f, -12.3f),
+        glm::vec3( 2.4f, -0.4f, -3.5f),
+        glm::vec3(-1.7f,  3.0f, -7.5f),
+        glm::vec3( 1.3f, -2.0f, -2.5f),
+        glm::vec3( 1.5f,  2.0f, -2.5f),
+        glm::vec3( 1.5f,  0.2f, -1.5f),
+        glm::vec3(-1.3f,  1.0f, -1.5f)
+};
+const int CUBE_COUNT = sizeof(cubePositions) / sizeof(cubePositions[0]);
+
+void drawScene(Shader &shader, const Camera &cam, unsigned int VAO, float aspectRatio, float time);
+int validate(Shader &shader, unsigned int VAO);
+
+int main(int argc, char *argv[])
+{
+    using std::cout;
+    using std::endl;
+
+    bool validateMode = argc > 1 && std::strcmp(argv[1], "--validate") == 0;
+
+    // glfw: 初始化设置
+    // ------------------------------
+    glfwInit();
+    glfwWindowHint(GLFW_CONTEXT_VERSION_MAJOR, 3);
+    glfwWindowHint(GLFW_CONTEXT_VERSION_MINOR, 3);
+    glfwWindowHint(GLFW_OPENGL_PROFILE, GLFW_OPENGL_CORE_PROFILE);
+    if (validateMode)
+        glfwWindowHint(GLFW_VISIBLE, GLFW_FALSE);
+
+    // glfw: 创建窗口
+    // --------------------
+    GLFWwindow* window = glfwCreateWindow(SCR_WIDTH, SCR_HEIGHT, "LearnOpenGL", nullptr, nullptr);
+    if (window == nullptr)
+    {
+        cout << "Failed to create GLFW window" << endl;
+        glfwTerminate();
+        exit(EXIT_FAILURE);
+    }
+    glfwMakeContextCurrent(window);     // 设置OpenGL上下文
+    glfwSetFramebufferSizeCallback(window, framebuffer_size_callback);
+    glfwSetCursorPosCallback(window, mouse_callback);
+    glfwSetScrollCallback(window, scroll_callback);
+    glfwSetKeyCallback(window, key_callback);
+    if (!validateMode)
+        glfwSetInputMode(window, GLFW_CURSOR, GLFW_CURSOR_DISABLED);
+
+    // glad: 加载OpenGL函数指针
+    // ---------------------------------------
+    if (!gladLoadGLLoader((GLADloadproc)glfwGetProcAddress))
+    {
+        cout << "Failed to initialize GLAD" << endl;
+        exit(EXIT_FAILURE);
+    }
+    glEnable(GL_DEPTH_TEST);
+    glfwGetFramebufferSize(window, &fbWidth, &fbHeight);
+
+    // 定义编译着色器
+    Shader ourShader("6.1.coordinate_systems.vs", "6.1.coordinate_systems.fs");
+
+    // 定义顶点数据，包含位置、纹理坐标
+    float vertices[] = {        // 立方体的六个面
+            -0.5f, -0.5f, -0.5f,  0.0f, 0.0f,
+             0.5f, -0.5f, -0.5f,  1.0f, 0.0f,
+             0.5f,  0.5f, -0.5f,  1.0f, 1.0f,
+             0.5f,  0.5f, -0.5f,  1.0f, 1.0f,
+            -0.5f,  0.5f, -0.5f,  0.0f, 1.0f,
+            -0.5f, -0.5f, -0.5f,  0.0f, 0.0f,
+
+            -0.5f, -0.5f,  0.5f,  0.0f, 0.0f,
+             0.5f, -0.5f,  0.5f,  1.0f, 0.0f,
+             0.5f,  0.5f,  0.5f,  1.0f, 1.0f,
+             0.5f,  0.5f,  0.5f,  1.0f, 1.0f,
+            -0.5f,  0.5f,  0.5f,  0.0f, 1.0f,
+            -0.5f, -0.5f,  0.5f,  0.0f, 0.0f,
+
+            -0.5f,  0.5f,  0.5f,  1.0f, 0.0f,
+            -0.5f,  0.5f, -0.5f,  1.0f, 1.0f,
+            -0.5f, -0.5f, -0.5f,  0.0f, 1.0f,
+            -0.5f, -0.5f, -0.5f,  0.0f, 1.0f,
+            -0.5f, -0.5f,  0.5f,  0.0f, 0.0f,
+            -0.5f,  0.5f,  0.5f,  1.0f, 0.0f,
+
+             0.5f,  0.5f,  0.5f,  1.0f, 0.0f,
+             0.5f,  0.5f, -0.5f,  1.0f, 1.0f,
+             0.5f, -0.5f, -0.5f,  0.0f, 1.0f,
+             0.5f, -0.5f, -0.5f,  0.0f, 1.0f,
+             0.5f, -0.5f,  0.5f,  0.0f, 0.0f,
+             0.5f,  0.5f,  0.5f,  1.0f, 0.0f,
+
+            -0.5f, -0.5f, -0.5f,  0.0f, 1.0f,
+             0.5f, -0.5f, -0.5f,  1.0f, 1.0f,
+             0.5f, -0.5f,  0.5f,  1.0f, 0.0f,
+             0.5f, -0.5f,  0.5f,  1.0f, 0.0f,
+            -0.5f, -0.5f,  0.5f,  0.0f, 0.0f,
+            -0.5f, -0.5f, -0.5f,  0.0f, 1.0f,
+
+            -0.5f,  0.5f, -0.5f,  0.0f, 1.0f,
+             0.5f,  0.5f, -0.5f,  1.0f, 1.0f,
+             0.5f,  0.5f,  0.5f,  1.0f, 0.0f,
+             0.5f,  0.5f,  0.5f,  1.0f, 0.0f,
+            -0.5f,  0.5f,  0.5f,  0.0f, 0.0f,
+            -0.5f,  0.5f, -0.5f,  0.0f, 1.0f
+    };
+
+    // 创建顶点缓冲和顶点数组
+    unsigned int VAO, VBO;
+    glGenVertexArrays(1, &VAO);
+    glGenBuffers(1, &VBO);
+
+    glBindVertexArray(VAO);
+    glBindBuffer(GL_ARRAY_BUFFER, VBO);
+    glBufferData(GL_ARRAY_BUFFER, sizeof(vertices), vertices, GL_STATIC_DRAW);
+
+    // 顶点位置
+    glVertexAttribPointer(0, 3, GL_FLOAT, GL_FALSE, 5 * sizeof(float), (void *)nullptr);
+    glEnableVertexAttribArray(0);
+    // 纹理坐标
+    glVertexAttribPointer(1, 2, GL_FLOAT, GL_FALSE, 5 * sizeof(float), (void *)(3 * sizeof(float)));
+    glEnableVertexAttribArray(1);
+
+    // 创建纹理
+    unsigned int textures[2];
+    const char *texturePaths[2] = {"container.jpg", "awesomeface.png"};
+    for (int i = 0; i < 2; i++)
+        textures[i] = LoadTexture(texturePaths[i]);
+
+    // 激活纹理
+    ourShader.use();
+    ourShader.setInt("texture1", 0);
+    ourShader.setInt("texture2", 1);
+    glActiveTexture(GL_TEXTURE0);
+    glBindTexture(GL_TEXTURE_2D, textures[0]);
+    glActiveTexture(GL_TEXTURE1);
+    glBindTexture(GL_TEXTURE_2D, textures[1]);
+
+    if (validateMode) {
+        int failures = validate(ourShader, VAO);
+        cout << (failures == 0 ? "frame capture OK" : "frame capture validation FAILED") << endl;
+        glDeleteVertexArrays(1, &VAO);
+        glDeleteBuffers(1, &VBO);
+        glDeleteTextures(2, textures);
+        glfwTerminate();
+        return failures == 0 ? EXIT_SUCCESS : EXIT_FAILURE;
+    }
+
+    FrameCapture capture(fbWidth, fbHeight);
+    bool pngActive = false, videoActive = false;
+    cout << "frame capture: " << (capture.PersistentMapping() ? "persistent mapped PBOs" : "mapped PBOs") << endl;
+
+    // 渲染循环
+    // -----------
+    float titleTimer = 0.0f;
+    double captureMs = 0.0;
+    unsigned int capturedFrames = 0;
+    while (!glfwWindowShouldClose(window))
+    {
+        float currentFrame = glfwGetTime();
+        deltaTime = currentFrame - lastFrame;
+        lastFrame = currentFrame;
+
+        processInput(window);
+
+        if (fbResized) {
+            capture.Resize(fbWidth, fbHeight);
+            fbResized = false;
+        }
+        if (capturePng != pngActive) {
+            capture.SetPngOutput(capturePng ? "capture_%05llu.png" : "");
+            pngActive = capturePng;
+        }
+        if (recordVideo != videoActive) {
+            capture.SetY4mOutput(recordVideo ? "capture.y4m" : "");
+            videoActive = recordVideo;
+        }
+        capture.BlockWhenBusy = blockWhenBusy;
+
+        glClearColor(0.2f, 0.3f, 0.3f, 1.0f);
+        glClear(GL_COLOR_BUFFER_BIT | GL_DEPTH_BUFFER_BIT);
+        drawScene(ourShader, camera, VAO, (float)fbWidth / (float)fbHeight, currentFrame);
+
+        // 在交换之前读取后台缓冲
+        if (pngActive || videoActive) {
+            auto start = std::chrono::steady_clock::now();
+            capture.Capture();
+            capture.Poll();
+            captureMs += std::chrono::duration<double, std::milli>(std::chrono::steady_clock::now() - start).count();
+            capturedFrames++;
+        }
+
+        titleTimer += deltaTime;
+        if (titleTimer > 0.5f) {
+            titleTimer = 0.0f;
+            std::string title = std::string("Frame Capture - ") + (pngActive ? "PNG " : "") + (videoActive ? "Y4M " : "") +
+                                (pngActive || videoActive ? "" : "idle ") + "- " +
+                                std::to_string(capturedFrames ? captureMs / capturedFrames : 0.0) + " ms/frame on render thread - " +
+                                std::to_string(capture.Encoded()) + "/" + std::to_string(capture.Captured()) + " encoded, " +
+                                std::to_string(capture.Stalls()) + " stalls, " + std::to_string(capture.Dropped()) + " dropped" +
+                                (blockWhenBusy ? "" : " (drop when busy)");
+            glfwSetWindowTitle(window, title.c_str());
+            captureMs = 0.0;
+            capturedFrames = 0;
+        }
+
+        // glfw: 交换颜色缓冲，检测事件
+        // -------------------------------------------------------------------------------
+        glfwSwapBuffers(window);
+        glfwPollEvents();
+    }
+    capture.Flush();
+
+    glDeleteVertexArrays(1, &VAO);
+    glDeleteBuffers(1, &VBO);
+    glDeleteTextures(2, textures);
+
+    glfwTerminate();
+    return 0;
+}
+
+// 画面只取决于time，校验时可以重复渲染完全相同的帧
+// ---------------------------------------------------------------------------------------------------------
+void drawScene(Shader &shader, const Camera &cam, unsigned int VAO, float aspectRatio, float time)
+{
+    shader.use();
+    shader.setMat4("projection", cam.GetProjectionMatrix(aspectRatio));
+    shader.setMat4("view", cam.GetViewMatrix());
+    glBindVertexArray(VAO);
+    for (int i = 0; i < CUBE_COUNT; i++) {
+        glm::mat4 model = glm::mat4(1.0f);
+        model = glm::translate(model, cubePositions[i]);
+        model = glm::rotate(model, time * glm::radians(20.0f * (i + 1)), glm::vec3(1.0f, 0.3f, 0.5f));
+        shader.setMat4("model", model);
+        glDrawArrays(GL_TRIANGLES, 0, 36);
+    }
+}
+
+// 1. 在离屏缓冲上渲染60帧并异步捕获，工作线程计算每帧的哈希；再同步渲染、读回同样的60帧，哈希必须逐帧相同
+// 2. 小尺寸的PNG和Y4M输出：PNG用stb_image读回和同步读回的像素比较，Y4M检查文件头和大小
+// ---------------------------------------------------------------------------------------------------------
+int validate(Shader &shader, unsigned int VAO)
+{
+    using std::cout;
+    using std::endl;
+    typedef std::chrono::steady_clock Clock;
+
+    unsigned int fbo, colorBuffer, depthBuffer;
+    glGenFramebuffers(1, &fbo);
+    glBindFramebuffer(GL_FRAMEBUFFER, fbo);
+    glGenRenderbuffers(1, &colorBuffer);
+    glBindRenderbuffer(GL_RENDERBUFFER, colorBuffer);
+    glRenderbufferStorage(GL_RENDERBUFFER, GL_RGBA8, VALIDATE_WIDTH, VALIDATE_HEIGHT);
+    glFramebufferRenderbuffer(GL_FRAMEBUFFER, GL_COLOR_ATTACHMENT0, GL_RENDERBUFFER, colorBuffer);
+    glGenRenderbuffers(1, &depthBuffer);
+    glBindRenderbuffer(GL_RENDERBUFFER, depthBuffer);
+    glRenderbufferStorage(GL_RENDERBUFFER, GL_DEPTH24_STENCIL8, VALIDATE_WIDTH, VALIDATE_HEIGHT);
+    glFramebufferRenderbuffer(GL_FRAMEBUFFER, GL_DEPTH_STENCIL_ATTACHMENT, GL_RENDERBUFFER, depthBuffer);
+    glViewport(0, 0, VALIDATE_WIDTH, VALIDATE_HEIGHT);
+
+    auto renderFrame = [&](int frame) {
+        glBindFramebuffer(GL_FRAMEBUFFER, fbo);
+        glClearColor(0.2f, 0.3f, 0.3f + 0.01f * (frame % 50), 1.0f);
+        glClear(GL_COLOR_BUFFER_BIT | GL_DEPTH_BUFFER_BIT);
+        drawScene(shader, camera, VAO, (float) VALIDATE_WIDTH / VALIDATE_HEIGHT, frame / 60.0f);
+    };
+    auto hash = [](const unsigned char *data, size_t size) {
+        uint64_t h = 1469598103934665603ull;
+        for (size_t i = 0; i < size; i++)
+            h = (h ^ data[i]) * 1099511628211ull;
+        return h;
+    };
+    auto readSync = [&](int width, int height) {
+        std::vector<unsigned char> pixels((size_t) width * height * 4);
+        glPixelStorei(GL_PACK_ALIGNMENT, 1);
+        glBindFramebuffer(GL_READ_FRAMEBUFFER, fbo);
+        glReadPixels(0, 0, width, height, GL_RGBA, GL_UNSIGNED_BYTE, pixels.data());
+        return pixels;
+    };
+
+    int failures = 0;
+    size_t frameBytes = (size_t) VALIDATE_WIDTH * VALIDATE_HEIGHT * 4;
+
+    // 同步读回作为参考，同时测量每帧在渲染线程上的时间
+    std::vector<uint64_t> expected(VALIDATE_FRAMES);
+    double syncMs = 0.0;
+    for (int frame = 0; frame < VALIDATE_FRAMES; frame++) {
+        renderFrame(frame);
+        // 只测量读回本身，不包括等待渲染完成
+        glFinish();
+        Clock::time_point start = Clock::now();
+        std::vector<unsigned char> pixels = readSync(VALIDATE_WIDTH, VALIDATE_HEIGHT);
+        syncMs += std::chrono::duration<double, std::milli>(Clock::now() - start).count();
+        expected[frame] = hash(pixels.data(), frameBytes);
+    }
+
+    // 异步捕获
+    {
+        std::mutex mutex;
+        std::vector<uint64_t> hashes(VALIDATE_FRAMES, 0);
+        FrameCapture capture(VALIDATE_WIDTH, VALIDATE_HEIGHT);
+        capture.SetCallback([&](const CapturedFrame &frame) {
+            uint64_t h = hash(frame.Pixels, (size_t) frame.Width * frame.Height * 4);
+            std::lock_guard<std::mutex> lock(mutex);
+            if (frame.Index < hashes.size())
+                hashes[frame.Index] = h;
+        });
+        double asyncMs = 0.0;
+        for (int frame = 0; frame < VALIDATE_FRAMES; frame++) {
+            renderFrame(frame);
+            glFinish();
+            Clock::time_point start = Clock::now();
+            capture.Capture(fbo);
+            capture.Poll();
+            asyncMs += std::chrono::duration<double, std::milli>(Clock::now() - start).count();
+        }
+        capture.Flush();
+
+        int mismatches = 0;
+        for (int frame = 0; frame < VALIDATE_FRAMES; frame++)
+            if (hashes[frame] != expected[frame])
+                mismatches++;
+        bool ok = mismatches == 0 && capture.Encoded() == VALIDATE_FRAMES;
+        cout << VALIDATE_WIDTH << "x" << VALIDATE_HEIGHT << ", " << VALIDATE_FRAMES << " frames ("
+             << (capture.PersistentMapping() ? "persistent mapped PBOs" : "mapped PBOs") << "):" << endl;
+        cout << "  render thread: glReadPixels " << syncMs / VALIDATE_FRAMES << " ms/frame, async capture "
+             << asyncMs / VALIDATE_FRAMES << " ms/frame, " << capture.Stalls() << " stalls" << endl;
+        cout << "  " << VALIDATE_FRAMES - mismatches << "/" << VALIDATE_FRAMES << " frames identical to glReadPixels"
+             << (ok ? " OK" : " FAIL") << endl;
+        if (!ok)
+            failures++;
+    }
+
+    // PNG和Y4M输出
+    {
+        const int width = 320, height = 240, frames = 10;
+        const char *pngPattern = "capture_validate_%05llu.png";
+        const char *videoPath = "capture_validate.y4m";
+        std::vector<unsigned char> firstFrame;
+        {
+            FrameCapture capture(width, height, 3, 2);
+            capture.SetPngOutput(pngPattern);
+            capture.SetY4mOutput(videoPath, 30);
+            for (int frame = 0; frame < frames; frame++) {
+                renderFrame(frame);
+                if (frame == 0)
+                    firstFrame = readSync(width, height);
+                capture.Capture(fbo);
+                capture.Poll();
+            }
+            capture.SetY4mOutput("");
+            capture.SetPngOutput("");
+        }
+
+        // PNG：stb_image读出来的行从上往下
+        char path[256];
+        std::snprintf(path, sizeof(path), pngPattern, 0ull);
+        int w = 0, h = 0, channels = 0;
+        stbi_set_flip_vertically_on_load(true);
+        unsigned char *png = stbi_load(path, &w, &h, &channels, 4);
+        bool pngOk = png && w == width && h == height && std::memcmp(png, firstFrame.data(), firstFrame.size()) == 0;
+        stbi_image_free(png);
+        cout << "PNG: " << path << (pngOk ? " matches glReadPixels OK" : " FAIL") << endl;
+        if (!pngOk)
+            failures++;
+
+        // Y4M：文件头 + 每帧 "FRAME\n" 和 4:2:0 的三个平面
+        FILE *file = std::fopen(videoPath, "rb");
+        char header[64] = {};
+        long size = 0;
+        if (file) {
+            if (!std::fgets(header, sizeof(header), file))
+                header[0] = 0;
+            std::fseek(file, 0, SEEK_END);
+            size = std::ftell(file);
+            std::fclose(file);
+        }
+        long expectedSize = (long) std::strlen(header) + frames * (6L + width * height * 3 / 2);
+        bool videoOk = std::strncmp(header, "YUV4MPEG2 W320 H240 F30:1", 25) == 0 && size == expectedSize;
+        cout << "Y4M: " << frames << " frames, " << size << " bytes (expected " << expectedSize << ")"
+             << (videoOk ? " OK" : " FAIL") << endl;
+        if (!videoOk)
+            failures++;
+
+        for (int frame = 0; frame < frames; frame++) {
+            std::snprintf(path, sizeof(path), pngPattern, (unsigned long long) frame);
+            std::remove(path);
+        }
+        std::remove(videoPath);
+    }
+
+    glBindFramebuffer(GL_FRAMEBUFFER, 0);
+    glDeleteFramebuffers(1, &fbo);
+    glDeleteRenderbuffers(1, &colorBuffer);
+    glDeleteRenderbuffers(1, &depthBuffer);
+    return failures;
+}
+
+// process all input: query GLFW whether relevant keys are pressed/released this frame and react accordingly
+// ---------------------------------------------------------------------------------------------------------
+void processInput(GLFWwindow *window)
+{
+    if (glfwGetKey(window, GLFW_KEY_ESCAPE) == GLFW_PRESS)
+        glfwSetWindowShouldClose(window, true);
+
+    if (glfwGetKey(window, GLFW_KEY_W) == GLFW_PRESS)
+        camera.ProcessKeyboard(FORWARD, deltaTime);
+    if (glfwGetKey(window, GLFW_KEY_S) == GLFW_PRESS)
+        camera.ProcessKeyboard(BACKWARD, deltaTime);
+    if (glfwGetKey(window, GLFW_KEY_A) == GLFW_PRESS)
+        camera.ProcessKeyboard(LEFT, deltaTime);
+    if (glfwGetKey(window, GLFW_KEY_D) == GLFW_PRESS)
+        camera.ProcessKeyboard(RIGHT, deltaTime);
+}
+
+void key_callback(GLFWwindow* window, int key, int scancode, int action, int mods)
+{
+    if (action != GLFW_PRESS)
+        return;
+    if (key == GLFW_KEY_C)
+        capturePng = !capturePng;
+    if (key == GLFW_KEY_V)
+        recordVideo = !recordVideo;
+    if (key == GLFW_KEY_B)
+        blockWhenBusy = !blockWhenBusy;
+}
+
+// glfw: whenever the window size changed (by OS or user resize) this callback function executes
+// ---------------------------------------------------------------------------------------------
+void framebuffer_size_callback(GLFWwindow* window, int width, int height)
+{
+    glViewport(0, 0, width, height);
+    fbWidth = width;
+    fbHeight = height;
+    fbResized = true;
+}
+
+void mouse_callback(GLFWwindow* window, double xpos, double ypos) {
+    if (firstMouse) {
+        lastX = xpos;
+        lastY = ypos;
+        firstMouse = false;
+    }
+    float xoffset = xpos - lastX;
+    float yoffset = lastY - ypos;
+    lastX = xpos;
+    lastY = ypos;
+
+    camera.ProcessMouseMovement(xoffset, yoffset);
+}
+
+void scroll_callback(GLFWwindow* window, double xoffset, double yoffset)
+{
+    camera.ProcessMouseScroll(yoffset);
+}
@@ -0,0 +1,316 @@
+// 金图（golden image）回归测试：比较前几章示例（三角形、纹理、变换、坐标系统、摄像机）自己渲染的截图和提交在 golden 目录中的参考图，
+// 用SSIM加逐像素差值的阈值判断是否通过；渲染路径做性能优化之后运行一次，画面有可见的变化就会失败，失败的用例会输出实际画面和差异图
+// 截图由构建步骤完成：check_golden_images 目标先用 --capture 运行各个示例（固定的时间和摄像机，见 includes/learnopengl/sample_capture.h），
+// 再运行本程序比较，用例在 01.Getting Started/CMakeLists.txt 中用 add_golden_case 定义
+//
+// 运行参数：
+//   golden_images <参考图目录> <截图目录> <用例名>...            比较 <截图目录>/<用例名>.png 和参考图，有失败的用例时返回非0
+//   golden_images --update <参考图目录> <截图目录> <用例名>...   用截图覆盖参考图（压缩的PNG），只在确认画面的变化是预期的之后使用
+//   golden_images --validate [参考图目录]                         不截图：用参考图检查SIMD和标量的SSIM一致、比较方法能区分细微噪声和真正的变化
+// 参考图在 llvmpipe 上生成。其他驱动的光栅化和纹理过滤有细微的差别，阈值能容忍一部分；差别更大时在该机器上用 update_golden_images 重新生成
+#include <iostream>
+#include <cstring>
+#include <cstdio>
+#include <vector>
+#include <string>
+#include <chrono>
+#include <algorithm>
+
+#include <stb_image.h>
+#include <learnopengl/frame_capture.h>
+#include <learnopengl/image_compare.h>
+
+#ifndef LEARNOPENGL_GOLDEN_DIR
+#define LEARNOPENGL_GOLDEN_DIR "golden"
+#endif
+
+// 通过的条件
+const double MIN_MEAN_SSIM = 0.99;
+const double MIN_WINDOW_SSIM = 0.9;
+const int DIFF_THRESHOLD = 16;
+const double MAX_DIFF_FRACTION = 0.001;
+
+// --validate 用到的参考图，和 01.Getting Started/CMakeLists.txt 中的 add_golden_case 对应；
+// 名字中第一个下划线之前相同的是同一个示例的不同时间或摄像机位置
+const char *VALIDATE_CASES[] = {
+        "triangle",
+        "textures",
+        "transformations_0",
+        "transformations_1",
+        "transformations_2",
+        "coordinate_systems",
+        "camera_front",
+        "camera_side",
+        "camera_above",
+        "camera_zoomed"
+};
+const int VALIDATE_CASE_COUNT = sizeof(VALIDATE_CASES) / sizeof(VALIDATE_CASES[0]);
+
+// RGBA8图像，行从下往上（和glReadPixels、CompareImages一致）
+struct Image {
+    int Width = 0, Height = 0;
+    std::vector<unsigned char> Pixels;
+};
+
+bool loadImage(const std::string &path, Image &image);
+int compareGoldens(const std::string &goldenDir, const std::string &captureDir, const std::vector<std::string> &names);
+int updateGoldens(const std::string &goldenDir, const std::string &captureDir, const std::vector<std::string> &names);
+int validate(const std::string &goldenDir);
+
+int main(int argc, char *argv[])
+{
+    using std::cout;
+    using std::endl;
+
+    enum { COMPARE, UPDATE, VALIDATE } mode = COMPARE;
+    std::vector<std::string> args;
+    for (int i = 1; i < argc; i++) {
+        if (std::strcmp(argv[i], "--update") == 0)
+            mode = UPDATE;
+        else if (std::strcmp(argv[i], "--validate") == 0)
+            mode = VALIDATE;
+        else
+            args.push_back(argv[i]);
+    }
+
+    int failures;
+    if (mode == VALIDATE) {
+        failures = validate(args.empty() ? LEARNOPENGL_GOLDEN_DIR : args[0]);
+    } else if (args.size() < 3) {
+        cout << "usage: " << argv[0] << " [--update] <golden dir> <capture dir> <case>...\n"
+             << "       " << argv[0] << " --validate [golden dir]" << endl;
+        failures = 1;
+    } else {
+        std::vector<std::string> names(args.begin() + 2, args.end());
+        if (mode == UPDATE)
+            failures = updateGoldens(args[0], args[1], names);
+        else
+            failures = compareGoldens(args[0], args[1], names);
+    }
+    return failures == 0 ? EXIT_SUCCESS : EXIT_FAILURE;
+}
+
+// 读取PNG，stb_image读出来的行从上往下，翻转成和glReadPixels一样
+bool loadImage(const std::string &path, Image &image)
+{
+    int channels = 0;
+    stbi_set_flip_vertically_on_load(true);
+    unsigned char *data = stbi_load(path.c_str(), &image.Width, &image.Height, &channels, 4);
+    if (data)
+        image.Pixels.assign(data, data + (size_t) image.Width * image.Height * 4);
+    stbi_image_free(data);
+    return data != nullptr;
+}
+
+ImageDifference compare(const Image &a, const Image &b)
+{
+    return CompareImages(a.Pixels.data(), b.Pixels.data(), a.Width, a.Height, DIFF_THRESHOLD);
+}
+
+bool passes(const ImageDifference &d)
+{
+    return d.Ssim >= MIN_MEAN_SSIM && d.MinSsim >= MIN_WINDOW_SSIM && d.DiffFraction <= MAX_DIFF_FRACTION;
+}
+
+void printDifference(const ImageDifference &d)
+{
+    std::cout << "SSIM " << d.Ssim << " (worst window " << d.MinSsim << "), max diff " << d.MaxDiff << ", "
+              << d.DiffFraction * 100.0 << "% pixels over " << DIFF_THRESHOLD;
+}
+
+// 和参考图比较，失败的用例在截图目录中输出 名字.actual.png 和 名字.diff.png
+// ---------------------------------------------------------------------------------------------------------
+int compareGoldens(const std::string &goldenDir, const std::string &captureDir, const std::vector<std::string> &names)
+{
+    using std::cout;
+    using std::endl;
+
+    int failures = 0;
+    for (const std::string &name : names) {
+        std::string goldenPath = goldenDir + "/" + name + ".png";
+        std::string capturePath = captureDir + "/" + name + ".png";
+        Image actual, golden;
+        cout << name << ": ";
+        if (!loadImage(capturePath, actual)) {
+            cout << "missing capture " << capturePath << ", the sample did not run" << endl;
+            failures++;
+            continue;
+        }
+        if (!loadImage(goldenPath, golden)) {
+            cout << "missing golden image " << goldenPath << ", build update_golden_images to create it" << endl;
+            failures++;
+            continue;
+        }
+        if (actual.Width != golden.Width || actual.Height != golden.Height) {
+            cout << "size " << actual.Width << "x" << actual.Height << " differs from golden " << golden.Width << "x"
+                 << golden.Height << " FAIL" << endl;
+            failures++;
+            continue;
+        }
+        ImageDifference d = compare(actual, golden);
+        printDifference(d);
+        if (passes(d)) {
+            cout << " OK" << endl;
+            continue;
+        }
+        cout << " FAIL" << endl;
+        failures++;
+        std::vector<unsigned char> diff;
+        MakeDiffImage(actual.Pixels.data(), golden.Pixels.data(), actual.Width, actual.Height, diff);
+        std::string base = captureDir + "/" + name;
+        WritePngRgba((base + ".actual.png").c_str(), actual.Width, actual.Height, actual.Pixels.data(), true);
+        WritePngRgba((base + ".diff.png").c_str(), actual.Width, actual.Height, diff.data(), true);
+    }
+    cout << names.size() - failures << "/" << names.size() << " golden images match" << endl;
+    return failures;
+}
+
+// 截图重新编码成压缩的PNG写进参考图目录，提交到仓库里的文件小得多
+int updateGoldens(const std::string &goldenDir, const std::string &captureDir, const std::vector<std::string> &names)
+{
+    using std::cout;
+    using std::endl;
+
+    int failures = 0;
+    for (const std::string &name : names) {
+        std::string goldenPath = goldenDir + "/" + name + ".png";
+        Image image;
+        bool ok = loadImage(captureDir + "/" + name + ".png", image) &&
+                  WritePngRgba(goldenPath.c_str(), image.Width, image.Height, image.Pixels.data(), true, true);
+        cout << (ok ? "wrote " : "Failed to write ") << goldenPath << endl;
+        if (!ok)
+            failures++;
+    }
+    return failures;
+}
+
+// 1. 参考图都在，并且和同一个示例的其他参考图大小相同
+// 2. SIMD和标量的SSIM一致，记录两者的耗时
+// 3. 每个通道 ±2 的随机噪声必须通过；同一个示例的相邻用例（不同的时间或摄像机位置）、少画一个立方体必须失败
+// 4. 写PNG（不压缩和压缩）再读回比较，必须完全相同
+// ---------------------------------------------------------------------------------------------------------
+int validate(const std::string &goldenDir)
+{
+    using std::cout;
+    using std::endl;
+    typedef std::chrono::steady_clock Clock;
+
+    int failures = 0;
+    std::vector<Image> images(VALIDATE_CASE_COUNT);
+    int missing = 0;
+    for (int i = 0; i < VALIDATE_CASE_COUNT; i++) {
+        std::string path = goldenDir + "/" + VALIDATE_CASES[i] + ".png";
+        if (!loadImage(path, images[i])) {
+            cout << "missing golden image " << path << endl;
+            missing++;
+        }
+    }
+    cout << "golden images: " << VALIDATE_CASE_COUNT - missing << "/" << VALIDATE_CASE_COUNT << " loaded from "
+         << goldenDir << (missing == 0 ? " OK" : " FAIL") << endl;
+    if (missing) {
+        cout << "golden image runner validation FAILED" << endl;
+        return 1;
+    }
+    // 下面用到的下标：transformations_0、transformations_1、textures、camera_front、camera_zoomed
+    const Image &transform0 = images[2], &transform1 = images[3], &textures = images[1];
+    const Image &cameraFront = images[6], &cameraZoomed = images[9];
+
+    // SIMD和标量
+    {
+        std::vector<float> x, y;
+        RgbaToLuma(transform0.Pixels.data(), transform0.Width, transform0.Height, x);
+        RgbaToLuma(transform1.Pixels.data(), transform1.Width, transform1.Height, y);
+        double simdMin, scalarMin, simd = 0.0, scalar = 0.0;
+        const int runs = 10;
+        Clock::time_point start = Clock::now();
+        for (int r = 0; r < runs; r++)
+            simd = SsimLuma(x.data(), y.data(), transform0.Width, transform0.Height, &simdMin);
+        double simdMs = std::chrono::duration<double, std::milli>(Clock::now() - start).count() / runs;
+        start = Clock::now();
+        for (int r = 0; r < runs; r++)
+            scalar = SsimLumaScalar(x.data(), y.data(), transform0.Width, transform0.Height, &scalarMin);
+        double scalarMs = std::chrono::duration<double, std::milli>(Clock::now() - start).count() / runs;
+        bool ok = std::fabs(simd - scalar) < 1e-4 && std::fabs(simdMin - scalarMin) < 1e-3;
+        cout << "SSIM kernel: SIMD " << simd << " in " << simdMs << " ms, scalar " << scalar << " in " << scalarMs
+             << " ms" << (ok ? " OK" : " FAIL") << endl;
+        if (!ok)
+            failures++;
+    }
+
+    // 噪声必须通过
+    {
+        Image noisy = cameraZoomed;
+        unsigned int seed = 12345;
+        for (size_t i = 0; i < noisy.Pixels.size(); i++) {
+            if (i % 4 == 3)
+                continue;
+            seed = seed * 1664525u + 1013904223u;
+            int value = noisy.Pixels[i] + (int) (seed >> 29) % 5 - 2;
+            noisy.Pixels[i] = (unsigned char) std::min(std::max(value, 0), 255);
+        }
+        ImageDifference d = compare(cameraZoomed, noisy);
+        bool ok = passes(d);
+        cout << "+-2 noise: ";
+        printDifference(d);
+        cout << (ok ? " passes OK" : " FAIL") << endl;
+        if (!ok)
+            failures++;
+    }
+
+    // 真正的变化必须失败：同一个示例的相邻用例，以及少画一个立方体
+    {
+        int undetected = 0;
+        for (int i = 0; i + 1 < VALIDATE_CASE_COUNT; i++) {
+            std::string a = VALIDATE_CASES[i], b = VALIDATE_CASES[i + 1];
+            if (a.substr(0, a.find('_')) != b.substr(0, b.find('_')))
+                continue;
+            cout << a << " vs " << b << ": ";
+            if (images[i].Width != images[i + 1].Width || images[i].Height != images[i + 1].Height) {
+                cout << "different sizes FAIL" << endl;
+                undetected++;
+                continue;
+            }
+            ImageDifference d = compare(images[i], images[i + 1]);
+            printDifference(d);
+            cout << (passes(d) ? " UNDETECTED" : " rejected") << endl;
+            if (passes(d))
+                undetected++;
+        }
+
+        // 用遮住一个立方体代替少画一个：在 camera_front 上把画面中心（最近的立方体）的一块涂成背景色
+        Image missingObject = cameraFront;
+        for (int y = cameraFront.Height / 2 - 50; y < cameraFront.Height / 2 + 50; y++)
+            for (int x = cameraFront.Width / 2 - 50; x < cameraFront.Width / 2 + 50; x++) {
+                unsigned char *p = &missingObject.Pixels[((size_t) y * cameraFront.Width + x) * 4];
+                p[0] = 51;
+                p[1] = 77;
+                p[2] = 77;
+            }
+        ImageDifference d = compare(cameraFront, missingObject);
+        cout << "missing object: ";
+        printDifference(d);
+        cout << (passes(d) ? " UNDETECTED" : " rejected") << endl;
+        if (passes(d))
+            undetected++;
+        cout << "changes: " << (undetected == 0 ? "all rejected OK" : "FAIL") << endl;
+        if (undetected)
+            failures++;
+    }
+
+    // PNG往返，压缩的编码器比不压缩的复杂得多，两种都检查
+    for (int compressed = 0; compressed < 2; compressed++) {
+        const char *path = "golden_validate.png";
+        Image loaded;
+        bool ok = WritePngRgba(path, textures.Width, textures.Height, textures.Pixels.data(), true, compressed != 0) &&
+                  loadImage(path, loaded) && loaded.Width == textures.Width && loaded.Height == textures.Height &&
+                  loaded.Pixels == textures.Pixels;
+        std::remove(path);
+        cout << "PNG round trip (" << (compressed ? "compressed" : "stored") << "): " << (ok ? "identical OK" : "FAIL")
+             << endl;
+        if (!ok)
+            failures++;
+    }
+
+    cout << (failures == 0 ? "golden image runner OK" : "golden image runner validation FAILED") << endl;
+    return failures;
+}
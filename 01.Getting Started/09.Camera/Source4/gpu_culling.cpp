@@ -0,0 +1,501 @@
+// GPU剔除示例：计算着色器做视锥体剔除 + Hi-Z遮挡剔除，结果直接写入间接绘制命令
+// 需要 OpenGL 4.3（计算着色器、SSBO、multi draw indirect），Mesa llvmpipe 也可以运行
+//
+// 运行参数：
+//   --validate   隐藏窗口，在一组固定的相机位姿下把GPU剔除结果和CPU参考实现对比，不一致时返回非0
+#include <iostream>
+#include <cstring>
+#include <vector>
+#include <memory>
+#include <algorithm>
+#include <glad/glad.h>
+#include <GLFW/glfw3.h>
+
+#include <glm/glm.hpp>
+#include <glm/gtc/matrix_transform.hpp>
+#include <glm/gtc/type_ptr.hpp>
+
+
+#include <learnopengl/shader.h>
+#include <learnopengl/camera.h>
+#include <learnopengl/texture.h>
+#include <learnopengl/bounds.h>
+#include <learnopengl/gpu_culling.h>
+
+void framebuffer_size_callback(GLFWwindow* window, int width, int height);
+void mouse_callback(GLFWwindow* window, double xpos, double ypos);
+void scroll_callback(GLFWwindow* window, double xoffset, double yoffset);
+void key_callback(GLFWwindow* window, int key, int scancode, int action, int mods);
+void processInput(GLFWwindow *window);
+
+// 窗口大小
+const unsigned int SCR_WIDTH = 800;
+const unsigned int SCR_HEIGHT = 800;
+
+// 场景：GRID x GRID 个小立方体，中间插入几堵墙作为遮挡物
+const int GRID = 128;
+const float SPACING = 2.0f;
+
+// camera
+Camera camera(glm::vec3(0.0f, 2.0f, 3.0f));
+
+bool firstMouse = true;
+double lastX = SCR_WIDTH / 2.0;
+double lastY = SCR_HEIGHT / 2.0;
+
+// timing
+float deltaTime = 0.0f;	// time between current frame and last frame
+float lastFrame = 0.0f;
+
+// 剔除选项，G切换GPU/CPU剔除，O切换遮挡剔除
+bool gpuCulling = true;
+bool occlusionCulling = true;
+
+// 离屏缓冲，Hi-Z需要读取深度纹理
+int fbWidth = SCR_WIDTH, fbHeight = SCR_HEIGHT;
+bool fbResized = false;
+
+struct SceneTarget {
+    unsigned int FBO = 0, ColorTexture = 0, DepthTexture = 0;
+};
+
+void createTarget(SceneTarget &target, int width, int height);
+void destroyTarget(SceneTarget &target);
+int validate(GpuCuller &culler, Shader &shader, unsigned int VAO, SceneTarget &target);
+
+int main(int argc, char *argv[])
+{
+    using std::cout;
+    using std::endl;
+
+    bool validateMode = argc > 1 && std::strcmp(argv[1], "--validate") == 0;
+
+    // glfw: 初始化设置
+    // ------------------------------
+    glfwInit();
+    glfwWindowHint(GLFW_CONTEXT_VERSION_MAJOR, 4);
+    glfwWindowHint(GLFW_CONTEXT_VERSION_MINOR, 3);
+    glfwWindowHint(GLFW_OPENGL_PROFILE, GLFW_OPENGL_CORE_PROFILE);
+    if (validateMode)
+        glfwWindowHint(GLFW_VISIBLE, GLFW_FALSE);
+
+    // glfw: 创建窗口
+    // --------------------
+    GLFWwindow* window = glfwCreateWindow(SCR_WIDTH, SCR_HEIGHT, "LearnOpenGL", nullptr, nullptr);
+    if (window == nullptr)
+    {
+        cout << "Failed to create GLFW window" << endl;
+        glfwTerminate();
+        exit(EXIT_FAILURE);
+    }
+    glfwMakeContextCurrent(window);     // 设置OpenGL上下文
+    glfwSetFramebufferSizeCallback(window, framebuffer_size_callback);
+    glfwSetCursorPosCallback(window, mouse_callback);
+    glfwSetScrollCallback(window, scroll_callback);
+    glfwSetKeyCallback(window, key_callback);
+    if (!validateMode)
+        glfwSetInputMode(window, GLFW_CURSOR, GLFW_CURSOR_DISABLED);
+
+    // glad: 加载OpenGL函数指针
+    // ---------------------------------------
+    if (!gladLoadGLLoader((GLADloadproc)glfwGetProcAddress))
+    {
+        cout << "Failed to initialize GLAD" << endl;
+        exit(EXIT_FAILURE);
+    }
+    if (!GLAD_GL_VERSION_4_3)
+    {
+        cout << "GPU culling requires OpenGL 4.3" << endl;
+        glfwTerminate();
+        exit(EXIT_FAILURE);
+    }
+    glEnable(GL_DEPTH_TEST);
+    camera.FarPlane = 500.0f;
+    glfwGetFramebufferSize(window, &fbWidth, &fbHeight);
+
+    // 定义编译着色器
+    Shader ourShader("gpu_culling.vs", "6.1.coordinate_systems.fs");
+    // 剔除器持有GL对象，需要在 glfwTerminate 之前释放
+    std::unique_ptr<GpuCuller> cullerPtr(new GpuCuller("hiz_build.comp", "gpu_cull.comp"));
+    GpuCuller &culler = *cullerPtr;
+
+    // 定义顶点数据，包含位置、纹理坐标
+    float vertices[] = {        // 立方体的六个面
+            -0.5f, -0.5f, -0.5f,  0.0f, 0.0f,
+             0.5f, -0.5f, -0.5f,  1.0f, 0.0f,
+             0.5f,  0.5f, -0.5f,  1.0f, 1.0f,
+             0.5f,  0.5f, -0.5f,  1.0f, 1.0f,
+            -0.5f,  0.5f, -0.5f,  0.0f, 1.0f,
+            -0.5f, -0.5f, -0.5f,  0.0f, 0.0f,
+
+            -0.5f, -0.5f,  0.5f,  0.0f, 0.0f,
+             0.5f, -0.5f,  0.5f,  1.0f, 0.0f,
+             0.5f,  0.5f,  0.5f,  1.0f, 1.0f,
+             0.5f,  0.5f,  0.5f,  1.0f, 1.0f,
+            -0.5f,  0.5f,  0.5f,  0.0f, 1.0f,
+            -0.5f, -0.5f,  0.5f,  0.0f, 0.0f,
+
+            -0.5f,  0.5f,  0.5f,  1.0f, 0.0f,
+            -0.5f,  0.5f, -0.5f,  1.0f, 1.0f,
+            -0.5f, -0.5f, -0.5f,  0.0f, 1.0f,
+            -0.5f, -0.5f, -0.5f,  0.0f, 1.0f,
+            -0.5f, -0.5f,  0.5f,  0.0f, 0.0f,
+            -0.5f,  0.5f,  0.5f,  1.0f, 0.0f,
+
+             0.5f,  0.5f,  0.5f,  1.0f, 0.0f,
+             0.5f,  0.5f, -0.5f,  1.0f, 1.0f,
+             0.5f, -0.5f, -0.5f,  0.0f, 1.0f,
+             0.5f, -0.5f, -0.5f,  0.0f, 1.0f,
+             0.5f, -0.5f,  0.5f,  0.0f, 0.0f,
+             0.5f,  0.5f,  0.5f,  1.0f, 0.0f,
+
+            -0.5f, -0.5f, -0.5f,  0.0f, 1.0f,
+             0.5f, -0.5f, -0.5f,  1.0f, 1.0f,
+             0.5f, -0.5f,  0.5f,  1.0f, 0.0f,
+             0.5f, -0.5f,  0.5f,  1.0f, 0.0f,
+            -0.5f, -0.5f,  0.5f,  0.0f, 0.0f,
+            -0.5f, -0.5f, -0.5f,  0.0f, 1.0f,
+
+            -0.5f,  0.5f, -0.5f,  0.0f, 1.0f,
+             0.5f,  0.5f, -0.5f,  1.0f, 1.0f,
+             0.5f,  0.5f,  0.5f,  1.0f, 0.0f,
+             0.5f,  0.5f,  0.5f,  1.0f, 0.0f,
+            -0.5f,  0.5f,  0.5f,  0.0f, 0.0f,
+            -0.5f,  0.5f, -0.5f,  0.0f, 1.0f
+    };
+
+    // 生成场景：地面上的立方体阵列，每隔16行插一堵墙
+    std::vector<glm::mat4> models;
+    for (int z = 0; z < GRID; z++) {
+        for (int x = 0; x < GRID; x++) {
+            glm::mat4 model = glm::mat4(1.0f);
+            model = glm::translate(model, glm::vec3((x - GRID / 2) * SPACING, 0.0f, -z * SPACING));
+            model = glm::rotate(model, glm::radians(20.0f * (x + z)), glm::vec3(1.0f, 0.3f, 0.5f));
+            models.push_back(model);
+        }
+        if (z % 16 == 8) {
+            glm::mat4 wall = glm::mat4(1.0f);
+            wall = glm::translate(wall, glm::vec3(0.0f, 2.0f, -z * SPACING - 1.0f));
+            wall = glm::scale(wall, glm::vec3(GRID * SPACING, 6.0f, 0.5f));
+            models.push_back(wall);
+        }
+    }
+
+    std::vector<GpuCullObject> objects;
+    AABB unitCube(glm::vec3(-0.5f), glm::vec3(0.5f));
+    for (const auto &model : models) {
+        AABB box = unitCube.Transformed(model);
+        GpuCullObject o{};
+        o.Center = glm::vec4(box.Center(), 0.0f);
+        o.Extents = glm::vec4(box.Extents(), 0.0f);
+        o.VertexCount = 36;
+        o.FirstVertex = 0;
+        objects.push_back(o);
+    }
+    culler.SetObjects(objects);
+    cout << "Objects: " << objects.size() << endl;
+
+    // 模型矩阵放在SSBO中，顶点着色器用物体编号索引
+    unsigned int modelBuffer;
+    glGenBuffers(1, &modelBuffer);
+    glBindBuffer(GL_SHADER_STORAGE_BUFFER, modelBuffer);
+    glBufferData(GL_SHADER_STORAGE_BUFFER, models.size() * sizeof(glm::mat4), models.data(), GL_STATIC_DRAW);
+    glBindBufferBase(GL_SHADER_STORAGE_BUFFER, 3, modelBuffer);
+
+    // 创建顶点缓冲和顶点数组
+    unsigned int VAO, VBO;
+    glGenVertexArrays(1, &VAO);
+    glGenBuffers(1, &VBO);
+
+    glBindVertexArray(VAO);
+    glBindBuffer(GL_ARRAY_BUFFER, VBO);
+    glBufferData(GL_ARRAY_BUFFER, sizeof(vertices), vertices, GL_STATIC_DRAW);
+
+    // 顶点位置
+    glVertexAttribPointer(0, 3, GL_FLOAT, GL_FALSE, 5 * sizeof(float), (void *)nullptr);
+    glEnableVertexAttribArray(0);
+    // 纹理坐标
+    glVertexAttribPointer(1, 2, GL_FLOAT, GL_FALSE, 5 * sizeof(float), (void *)(3 * sizeof(float)));
+    glEnableVertexAttribArray(1);
+    // 物体编号
+    culler.BindObjectIdAttribute(VAO, 2);
+
+    // 创建纹理
+    unsigned int textures[2];
+    const char *texturePaths[2] = {"container.jpg", "awesomeface.png"};
+    for (int i = 0; i < 2; i++)
+        textures[i] = LoadTexture(texturePaths[i]);
+
+    // 激活纹理
+    ourShader.use();
+    ourShader.setInt("texture1", 0);
+    ourShader.setInt("texture2", 1);
+
+    SceneTarget target;
+    createTarget(target, fbWidth, fbHeight);
+
+    if (validateMode) {
+        glActiveTexture(GL_TEXTURE0);
+        glBindTexture(GL_TEXTURE_2D, textures[0]);
+        glActiveTexture(GL_TEXTURE1);
+        glBindTexture(GL_TEXTURE_2D, textures[1]);
+        int failures = validate(culler, ourShader, VAO, target);
+        destroyTarget(target);
+        cullerPtr.reset();
+        glfwTerminate();
+        return failures == 0 ? EXIT_SUCCESS : EXIT_FAILURE;
+    }
+
+    // 渲染循环
+    // -----------
+    float titleTimer = 0.0f;
+    while (!glfwWindowShouldClose(window))
+    {
+        float currentFrame = glfwGetTime();
+        deltaTime = currentFrame - lastFrame;
+        lastFrame = currentFrame;
+
+        processInput(window);
+
+        if (fbResized) {
+            destroyTarget(target);
+            createTarget(target, fbWidth, fbHeight);
+            culler.InvalidateHiZ();
+            fbResized = false;
+        }
+
+        glm::mat4 projection = camera.GetProjectionMatrix((float)fbWidth / (float)fbHeight);
+        glm::mat4 view = camera.GetViewMatrix();
+        glm::mat4 viewProjection = projection * view;
+
+        // 剔除
+        if (gpuCulling)
+            culler.Cull(viewProjection, occlusionCulling);
+        else
+            culler.CullCpu(viewProjection);
+
+        // 渲染到离屏缓冲
+        glBindFramebuffer(GL_FRAMEBUFFER, target.FBO);
+        glViewport(0, 0, fbWidth, fbHeight);
+        glClearColor(0.2f, 0.3f, 0.3f, 1.0f);
+        glClear(GL_COLOR_BUFFER_BIT | GL_DEPTH_BUFFER_BIT);
+
+        glActiveTexture(GL_TEXTURE0);
+        glBindTexture(GL_TEXTURE_2D, textures[0]);
+        glActiveTexture(GL_TEXTURE1);
+        glBindTexture(GL_TEXTURE_2D, textures[1]);
+
+        ourShader.use();
+        ourShader.setMat4("projection", projection);
+        ourShader.setMat4("view", view);
+        glBindVertexArray(VAO);
+        culler.Draw();
+
+        // 用这一帧的深度生成Hi-Z，下一帧使用
+        if (gpuCulling && occlusionCulling)
+            culler.BuildHiZ(target.DepthTexture, fbWidth, fbHeight, viewProjection);
+
+        // 复制到默认帧缓冲
+        glBindFramebuffer(GL_READ_FRAMEBUFFER, target.FBO);
+        glBindFramebuffer(GL_DRAW_FRAMEBUFFER, 0);
+        glBlitFramebuffer(0, 0, fbWidth, fbHeight, 0, 0, fbWidth, fbHeight, GL_COLOR_BUFFER_BIT, GL_NEAREST);
+        glBindFramebuffer(GL_FRAMEBUFFER, 0);
+
+        titleTimer += deltaTime;
+        if (titleTimer > 0.5f) {
+            titleTimer = 0.0f;
+            std::string title = std::string("GPU Culling - ") + (gpuCulling ? "GPU" : "CPU") +
+                                (gpuCulling && occlusionCulling ? " + Hi-Z" : "") +
+                                " - " + std::to_string(deltaTime * 1000.0f) + " ms";
+            glfwSetWindowTitle(window, title.c_str());
+        }
+
+        // glfw: 交换颜色缓冲，检测事件
+        // -------------------------------------------------------------------------------
+        glfwSwapBuffers(window);
+        glfwPollEvents();
+    }
+
+    glDeleteVertexArrays(1, &VAO);
+    glDeleteBuffers(1, &VBO);
+    glDeleteBuffers(1, &modelBuffer);
+    glDeleteTextures(2, textures);
+    destroyTarget(target);
+    cullerPtr.reset();
+
+    glfwTerminate();
+    return 0;
+}
+
+// 在固定的相机位姿下对比GPU和CPU的剔除结果
+// 1. 只开视锥体剔除时，GPU可见集合必须和CPU完全一致
+// 2. 开启遮挡剔除时，GPU可见集合必须是视锥体可见集合的子集，并且被遮挡剔除掉的物体确实不可见
+//    （用 GL_ANY_SAMPLES_PASSED 查询在完整深度缓冲上绘制被剔除的物体，必须没有任何样本通过）
+// ---------------------------------------------------------------------------------------------------------
+int validate(GpuCuller &culler, Shader &shader, unsigned int VAO, SceneTarget &target)
+{
+    using std::cout;
+    using std::endl;
+
+    struct Pose { glm::vec3 Position; float Yaw, Pitch; };
+    const Pose poses[] = {
+            {glm::vec3(  0.0f,  2.0f,    3.0f),  -90.0f,   0.0f},
+            {glm::vec3( 40.0f,  1.0f,  -20.0f), -120.0f,   5.0f},
+            {glm::vec3(-60.0f, 30.0f,   10.0f),  -60.0f, -25.0f},
+            {glm::vec3(  0.0f,  1.0f, -100.0f),   90.0f,   0.0f},
+            {glm::vec3( 10.0f, 80.0f, -128.0f),  -90.0f, -89.0f},
+            {glm::vec3(  0.0f,  2.0f,   20.0f),   90.0f,   0.0f}     // 背对场景
+    };
+
+    unsigned int query;
+    glGenQueries(1, &query);
+    glBindFramebuffer(GL_FRAMEBUFFER, target.FBO);
+    glViewport(0, 0, fbWidth, fbHeight);
+    glBindVertexArray(VAO);
+
+    int failures = 0;
+    int index = 0;
+    for (const Pose &pose : poses) {
+        Camera cam(pose.Position, glm::vec3(0.0f, 1.0f, 0.0f), pose.Yaw, pose.Pitch);
+        cam.FarPlane = 500.0f;
+        glm::mat4 projection = cam.GetProjectionMatrix((float)fbWidth / (float)fbHeight);
+        glm::mat4 view = cam.GetViewMatrix();
+        glm::mat4 viewProjection = projection * view;
+
+        // 视锥体剔除：GPU和CPU结果一致
+        culler.Cull(viewProjection, false);
+        std::vector<unsigned int> gpuVisible = culler.ReadbackVisible();
+        std::vector<unsigned int> cpuVisible = culler.CullCpu(viewProjection);
+        bool frustumOk = gpuVisible == cpuVisible;
+
+        // 用CPU结果渲染完整深度，生成Hi-Z，再做遮挡剔除
+        // Cull/BuildHiZ 会切换到计算着色器程序，绘制前重新激活
+        shader.use();
+        shader.setMat4("projection", projection);
+        shader.setMat4("view", view);
+        glClear(GL_COLOR_BUFFER_BIT | GL_DEPTH_BUFFER_BIT);
+        culler.Draw();
+        culler.BuildHiZ(target.DepthTexture, fbWidth, fbHeight, viewProjection);
+        culler.Cull(viewProjection, true);
+        std::vector<unsigned int> occlusionVisible = culler.ReadbackVisible();
+        bool subsetOk = std::includes(cpuVisible.begin(), cpuVisible.end(),
+                                      occlusionVisible.begin(), occlusionVisible.end());
+
+        std::vector<unsigned int> occluded;
+        std::set_difference(cpuVisible.begin(), cpuVisible.end(),
+                            occlusionVisible.begin(), occlusionVisible.end(), std::back_inserter(occluded));
+        int samplesPassed = 0;
+        if (!occluded.empty()) {
+            culler.SetDrawList(occluded);
+            shader.use();
+            glDepthMask(GL_FALSE);
+            glBeginQuery(GL_ANY_SAMPLES_PASSED, query);
+            culler.Draw();
+            glEndQuery(GL_ANY_SAMPLES_PASSED);
+            glDepthMask(GL_TRUE);
+            glGetQueryObjectiv(query, GL_QUERY_RESULT, &samplesPassed);
+        }
+        bool occlusionOk = subsetOk && samplesPassed == 0;
+        culler.InvalidateHiZ();
+
+        cout << "pose " << index++ << ": frustum gpu " << gpuVisible.size() << " / cpu " << cpuVisible.size()
+             << (frustumOk ? " OK" : " MISMATCH")
+             << ", occlusion visible " << occlusionVisible.size() << " culled " << occluded.size()
+             << (occlusionOk ? " OK" : " FAIL") << endl;
+        if (!frustumOk || !occlusionOk)
+            failures++;
+    }
+    glDeleteQueries(1, &query);
+    glBindFramebuffer(GL_FRAMEBUFFER, 0);
+
+    cout << (failures == 0 ? "GPU culling matches CPU reference" : "GPU culling validation FAILED") << endl;
+    return failures;
+}
+
+void createTarget(SceneTarget &target, int width, int height)
+{
+    glGenFramebuffers(1, &target.FBO);
+    glBindFramebuffer(GL_FRAMEBUFFER, target.FBO);
+
+    glGenTextures(1, &target.ColorTexture);
+    glBindTexture(GL_TEXTURE_2D, target.ColorTexture);
+    glTexImage2D(GL_TEXTURE_2D, 0, GL_RGBA8, width, height, 0, GL_RGBA, GL_UNSIGNED_BYTE, nullptr);
+    glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_MIN_FILTER, GL_LINEAR);
+    glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_MAG_FILTER, GL_LINEAR);
+    glFramebufferTexture2D(GL_FRAMEBUFFER, GL_COLOR_ATTACHMENT0, GL_TEXTURE_2D, target.ColorTexture, 0);
+
+    glGenTextures(1, &target.DepthTexture);
+    glBindTexture(GL_TEXTURE_2D, target.DepthTexture);
+    glTexImage2D(GL_TEXTURE_2D, 0, GL_DEPTH_COMPONENT32F, width, height, 0, GL_DEPTH_COMPONENT, GL_FLOAT, nullptr);
+    glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_MIN_FILTER, GL_NEAREST);
+    glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_MAG_FILTER, GL_NEAREST);
+    glFramebufferTexture2D(GL_FRAMEBUFFER, GL_DEPTH_ATTACHMENT, GL_TEXTURE_2D, target.DepthTexture, 0);
+
+    if (glCheckFramebufferStatus(GL_FRAMEBUFFER) != GL_FRAMEBUFFER_COMPLETE)
+        std::cout << "ERROR::FRAMEBUFFER:: Framebuffer is not complete!" << std::endl;
+    glBindFramebuffer(GL_FRAMEBUFFER, 0);
+}
+
+void destroyTarget(SceneTarget &target)
+{
+    glDeleteFramebuffers(1, &target.FBO);
+    glDeleteTextures(1, &target.ColorTexture);
+    glDeleteTextures(1, &target.DepthTexture);
+    target = SceneTarget();
+}
+
+// process all input: query GLFW whether relevant keys are pressed/released this frame and react accordingly
+// ---------------------------------------------------------------------------------------------------------
+void processInput(GLFWwindow *window)
+{
+    if (glfwGetKey(window, GLFW_KEY_ESCAPE) == GLFW_PRESS)
+        glfwSetWindowShouldClose(window, true);
+
+    if (glfwGetKey(window, GLFW_KEY_W) == GLFW_PRESS)
+        camera.ProcessKeyboard(FORWARD, deltaTime);
+    if (glfwGetKey(window, GLFW_KEY_S) == GLFW_PRESS)
+        camera.ProcessKeyboard(BACKWARD, deltaTime);
+    if (glfwGetKey(window, GLFW_KEY_A) == GLFW_PRESS)
+        camera.ProcessKeyboard(LEFT, deltaTime);
+    if (glfwGetKey(window, GLFW_KEY_D) == GLFW_PRESS)
+        camera.ProcessKeyboard(RIGHT, deltaTime);
+}
+
+void key_callback(GLFWwindow* window, int key, int scancode, int action, int mods)
+{
+    if (action != GLFW_PRESS)
+        return;
+    if (key == GLFW_KEY_G)
+        gpuCulling = !gpuCulling;
+    if (key == GLFW_KEY_O)
+        occlusionCulling = !occlusionCulling;
+}
+
+// glfw: whenever the window size changed (by OS or user resize) this callback function executes
+// ---------------------------------------------------------------------------------------------
+void framebuffer_size_callback(GLFWwindow* window, int width, int height)
+{
+    fbWidth = width;
+    fbHeight = height;
+    fbResized = true;
+    glViewport(0, 0, width, height);
+}
+
+void mouse_callback(GLFWwindow* window, double xpos, double ypos) {
+    if (firstMouse) {
+        lastX = xpos;
+        lastY = ypos;
+        firstMouse = false;
+    }
+    float xoffset = xpos - lastX;
+    float yoffset = lastY - ypos;
+    lastX = xpos;
+    lastY = ypos;
+
+    camera.ProcessMouseMovement(xoffset, yoffset);
+}
+
+void scroll_callback(GLFWwindow* window, double xoffset, double yoffset)
+{
+    camera.ProcessMouseScroll(yoffset);
+}
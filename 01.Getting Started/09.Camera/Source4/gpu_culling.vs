@@ -0,0 +1,16 @@
+#version 430 core
+layout (location = 0) in vec3 aPos;
+layout (location = 1) in vec2 aTexCoord;
+layout (location = 2) in uint aObjectId;	// 逐实例属性，来自间接绘制命令的 baseInstance
+
+layout (std430, binding = 3) readonly buffer Models { mat4 models[]; };
+
+out vec2 TexCoord;
+
+uniform mat4 view;
+uniform mat4 projection;
+
+void main() {
+	gl_Position = projection * view * models[aObjectId] * vec4(aPos, 1.0f);
+	TexCoord = vec2(aTexCoord);
+}
@@ -0,0 +1,463 @@
+// 输入延迟示例：GLFW事件只能在主线程处理，所以主线程只负责等待事件、打上时间戳、放进无锁队列，
+// OpenGL上下文交给渲染线程；渲染线程在提交绘制前的最后一刻才从队列取出事件、更新摄像机、写入摄像机UBO
+// 按L切换最后时刻锁定（late latch）和帧开始时处理输入，窗口标题显示从事件到这一帧完成的延迟
+// 延迟的终点是 glfwSwapBuffers + glFinish 返回的时刻，不包含显示器扫描输出的时间
+//
+// 运行参数：
+//   --validate   隐藏窗口，主线程以1000Hz模拟鼠标事件，两种模式各渲染一段时间，
+//                最后时刻锁定的平均延迟必须更低，并且所有事件都被摄像机处理，没有丢失
+#include <iostream>
+#include <cstring>
+#include <vector>
+#include <string>
+#include <thread>
+#include <mutex>
+#include <atomic>
+#include <algorithm>
+#include <cmath>
+#include <glad/glad.h>
+#include <GLFW/glfw3.h>
+
+#include <glm/glm.hpp>
+#include <glm/gtc/matrix_transform.hpp>
+#include <glm/gtc/type_ptr.hpp>
+
+
+#include <learnopengl/shader.h>
+#include <learnopengl/camera.h>
+#include <learnopengl/texture.h>
+#include <learnopengl/input_queue.h>
+
+void framebuffer_size_callback(GLFWwindow* window, int width, int height);
+void mouse_callback(GLFWwindow* window, double xpos, double ypos);
+void scroll_callback(GLFWwindow* window, double xoffset, double yoffset);
+void key_callback(GLFWwindow* window, int key, int scancode, int action, int mods);
+
+// 窗口大小
+const unsigned int SCR_WIDTH = 800;
+const unsigned int SCR_HEIGHT = 600;
+
+// 模拟每帧在绘制之前的CPU工作（动画、物理、剔除等），单位毫秒
+const double FRAME_WORK_MS = 6.0;
+
+// 主线程（生产者）和渲染线程（消费者）之间的事件队列
+InputQueue inputQueue;
+std::atomic<unsigned int> droppedEvents(0);
+
+// 渲染线程写入、主线程设置的窗口标题
+std::mutex titleMutex;
+std::string pendingTitle;
+
+// 渲染线程的状态，只在渲染线程中访问
+// -------------------------------------------------------------------------------
+// camera
+Camera camera(glm::vec3(0.0f, 0.0f, 3.0f));
+
+bool firstMouse = true;
+double lastX = SCR_WIDTH / 2.0;
+double lastY = SCR_HEIGHT / 2.0;
+bool keys[GLFW_KEY_LAST + 1] = {};
+
+// L：最后时刻锁定摄像机
+bool lateLatch = true;
+
+// 从事件时间戳到这一帧完成的延迟统计
+struct LatencyStats {
+    double Sum = 0.0, Max = 0.0;
+    unsigned int Count = 0;
+
+    void Add(double seconds) {
+        Sum += seconds;
+        Max = std::max(Max, seconds);
+        Count++;
+    }
+    double AverageMs() const { return Count ? Sum / Count * 1000.0 : 0.0; }
+    double MaxMs() const { return Max * 1000.0; }
+};
+
+// 这一帧取出的事件时间戳，画面完成后统计延迟
+std::vector<double> latchedEvents;
+unsigned int latchedTotal = 0;
+// validate：两种模式分别统计，下标1为最后时刻锁定
+LatencyStats validateStats[2];
+
+void pushEvent(const InputEvent &event);
+// 取出队列中的所有事件，更新摄像机，然后按两次锁定之间的时间处理键盘移动
+void latchInput(double now, double &lastLatch);
+void renderLoop(GLFWwindow *window, bool validateMode, int *result);
+int validate(unsigned int pushed);
+
+int main(int argc, char *argv[])
+{
+    using std::cout;
+    using std::endl;
+
+    bool validateMode = argc > 1 && std::strcmp(argv[1], "--validate") == 0;
+
+    // glfw: 初始化设置
+    // ------------------------------
+    glfwInit();
+    glfwWindowHint(GLFW_CONTEXT_VERSION_MAJOR, 3);
+    glfwWindowHint(GLFW_CONTEXT_VERSION_MINOR, 3);
+    glfwWindowHint(GLFW_OPENGL_PROFILE, GLFW_OPENGL_CORE_PROFILE);
+    // 窗口不允许改变大小，上下文创建时的默认视口一直有效，渲染线程不需要处理大小变化
+    glfwWindowHint(GLFW_RESIZABLE, GLFW_FALSE);
+    if (validateMode)
+        glfwWindowHint(GLFW_VISIBLE, GLFW_FALSE);
+
+    // glfw: 创建窗口
+    // --------------------
+    GLFWwindow* window = glfwCreateWindow(SCR_WIDTH, SCR_HEIGHT, "LearnOpenGL", nullptr, nullptr);
+    if (window == nullptr)
+    {
+        cout << "Failed to create GLFW window" << endl;
+        glfwTerminate();
+        exit(EXIT_FAILURE);
+    }
+    glfwSetFramebufferSizeCallback(window, framebuffer_size_callback);
+    glfwSetCursorPosCallback(window, mouse_callback);
+    glfwSetScrollCallback(window, scroll_callback);
+    glfwSetKeyCallback(window, key_callback);
+    if (!validateMode)
+        glfwSetInputMode(window, GLFW_CURSOR, GLFW_CURSOR_DISABLED);
+
+    // 模拟的鼠标从窗口中心开始移动
+    if (validateMode)
+        firstMouse = false;
+
+    // 上下文在渲染线程中设为当前，主线程只处理事件
+    int result = EXIT_SUCCESS;
+    std::atomic<bool> rendering(true);
+    std::thread renderThread([&]() {
+        renderLoop(window, validateMode, &result);
+        rendering = false;
+        glfwPostEmptyEvent();
+    });
+
+    unsigned int pushed = 0;
+    if (validateMode) {
+        // 模拟1000Hz的鼠标：每毫秒向右移动一个像素，直到渲染线程结束
+        while (rendering) {
+            pushed++;
+            pushEvent({InputEvent::CURSOR_POS, InputTimestamp(), SCR_WIDTH / 2.0 + pushed, SCR_HEIGHT / 2.0, 0, 0});
+            std::this_thread::sleep_for(std::chrono::milliseconds(1));
+        }
+    } else {
+        while (rendering) {
+            glfwWaitEventsTimeout(0.1);
+            std::lock_guard<std::mutex> lock(titleMutex);
+            if (!pendingTitle.empty()) {
+                glfwSetWindowTitle(window, pendingTitle.c_str());
+                pendingTitle.clear();
+            }
+        }
+    }
+    renderThread.join();
+    if (validateMode && result == EXIT_SUCCESS)
+        result = validate(pushed);
+
+    glfwTerminate();
+    return result;
+}
+
+void pushEvent(const InputEvent &event)
+{
+    if (!inputQueue.Push(event))
+        droppedEvents++;
+}
+
+void latchInput(double now, double &lastLatch)
+{
+    InputEvent event;
+    while (inputQueue.Pop(event)) {
+        switch (event.Kind) {
+            case InputEvent::CURSOR_POS: {
+                if (firstMouse) {
+                    lastX = event.X;
+                    lastY = event.Y;
+                    firstMouse = false;
+                }
+                float xoffset = event.X - lastX;
+                float yoffset = lastY - event.Y;
+                lastX = event.X;
+                lastY = event.Y;
+                camera.ProcessMouseMovement(xoffset, yoffset, GL_TRUE);
+                break;
+            }
+            case InputEvent::SCROLL:
+                camera.ProcessMouseScroll(event.Y);
+                break;
+            case InputEvent::KEY:
+                if (event.Key >= 0 && event.Key <= GLFW_KEY_LAST)
+                    keys[event.Key] = event.Action != GLFW_RELEASE;
+                if (event.Key == GLFW_KEY_L && event.Action == GLFW_PRESS)
+                    lateLatch = !lateLatch;
+                break;
+        }
+        latchedEvents.push_back(event.Time);
+        latchedTotal++;
+    }
+
+    // 键盘按住期间持续移动，按两次锁定之间的时间积分
+    float deltaTime = lastLatch > 0.0 ? (float) (now - lastLatch) : 0.0f;
+    lastLatch = now;
+    if (keys[GLFW_KEY_W])
+        camera.ProcessKeyboard(FORWARD, deltaTime);
+    if (keys[GLFW_KEY_S])
+        camera.ProcessKeyboard(BACKWARD, deltaTime);
+    if (keys[GLFW_KEY_A])
+        camera.ProcessKeyboard(LEFT, deltaTime);
+    if (keys[GLFW_KEY_D])
+        camera.ProcessKeyboard(RIGHT, deltaTime);
+}
+
+// 渲染线程：持有OpenGL上下文，所有GL调用都在这里
+// ---------------------------------------------------------------------------------------------------------
+void renderLoop(GLFWwindow *window, bool validateMode, int *result)
+{
+    using std::cout;
+    using std::endl;
+
+    glfwMakeContextCurrent(window);
+    // glad: 加载OpenGL函数指针
+    // ---------------------------------------
+    if (!gladLoadGLLoader((GLADloadproc)glfwGetProcAddress))
+    {
+        cout << "Failed to initialize GLAD" << endl;
+        *result = EXIT_FAILURE;
+        return;
+    }
+    // 垂直同步打开时延迟里包含等待vblank的时间，这正是要测的
+    glfwSwapInterval(1);
+    glEnable(GL_DEPTH_TEST);
+
+    // 定义编译着色器
+    Shader ourShader("input_latency.vs", "6.1.coordinate_systems.fs");
+
+    // 定义顶点数据，包含位置、纹理坐标
+    float vertices[] = {        // 立方体的六个面
+            -0.5f, -0.5f, -0.5f,  0.0f, 0.0f,
+             0.5f, -0.5f, -0.5f,  1.0f, 0.0f,
+             0.5f,  0.5f, -0.5f,  1.0f, 1.0f,
+             0.5f,  0.5f, -0.5f,  1.0f, 1.0f,
+            -0.5f,  0.5f, -0.5f,  0.0f, 1.0f,
+            -0.5f, -0.5f, -0.5f,  0.0f, 0.0f,
+
+            -0.5f, -0.5f,  0.5f,  0.0f, 0.0f,
+             0.5f, -0.5f,  0.5f,  1.0f, 0.0f,
+             0.5f,  0.5f,  0.5f,  1.0f, 1.0f,
+             0.5f,  0.5f,  0.5f,  1.0f, 1.0f,
+            -0.5f,  0.5f,  0.5f,  0.0f, 1.0f,
+            -0.5f, -0.5f,  0.5f,  0.0f, 0.0f,
+
+            -0.5f,  0.5f,  0.5f,  1.0f, 0.0f,
+            -0.5f,  0.5f, -0.5f,  1.0f, 1.0f,
+            -0.5f, -0.5f, -0.5f,  0.0f, 1.0f,
+            -0.5f, -0.5f, -0.5f,  0.0f, 1.0f,
+            -0.5f, -0.5f,  0.5f,  0.0f, 0.0f,
+            -0.5f,  0.5f,  0.5f,  1.0f, 0.0f,
+
+             0.5f,  0.5f,  0.5f,  1.0f, 0.0f,
+             0.5f,  0.5f, -0.5f,  1.0f, 1.0f,
+             0.5f, -0.5f, -0.5f,  0.0f, 1.0f,
+             0.5f, -0.5f, -0.5f,  0.0f, 1.0f,
+             0.5f, -0.5f,  0.5f,  0.0f, 0.0f,
+             0.5f,  0.5f,  0.5f,  1.0f, 0.0f,
+
+            -0.5f, -0.5f, -0.5f,  0.0f, 1.0f,
+             0.5f, -0.5f, -0.5f,  1.0f, 1.0f,
+             0.5f, -0.5f,  0.5f,  1.0f, 0.0f,
+             0.5f, -0.5f,  0.5f,  1.0f, 0.0f,
+            -0.5f, -0.5f,  0.5f,  0.0f, 0.0f,
+            -0.5f, -0.5f, -0.5f,  0.0f, 1.0f,
+
+            -0.5f,  0.5f, -0.5f,  0.0f, 1.0f,
+             0.5f,  0.5f, -0.5f,  1.0f, 1.0f,
+             0.5f,  0.5f,  0.5f,  1.0f, 0.0f,
+             0.5f,  0.5f,  0.5f,  1.0f, 0.0f,
+            -0.5f,  0.5f,  0.5f,  0.0f, 0.0f,
+            -0.5f,  0.5f, -0.5f,  0.0f, 1.0f
+    };
+
+    // 世界空间中立方体的位置
+    glm::vec3 cubePositions[] = {
+            glm::vec3( 0.0f,  0.0f,  0.0f),
+            glm::vec3( 2.0f,  5.0f, -15.0f),
+            glm::vec3(-1.5f, -2.2f, -2.5f),
+            glm::vec3(-3.8f, -2.0f, -12.3f),
+            glm::vec3( 2.4f, -0.4f, -3.5f),
+            glm::vec3(-1.7f,  3.0f, -7.5f),
+            glm::vec3( 1.3f, -2.0f, -2.5f),
+            glm::vec3( 1.5f,  2.0f, -2.5f),
+            glm::vec3( 1.5f,  0.2f, -1.5f),
+            glm::vec3(-1.3f,  1.0f, -1.5f)
+    };
+
+    // 创建顶点缓冲和顶点数组
+    unsigned int VAO, VBO;
+    glGenVertexArrays(1, &VAO);
+    glGenBuffers(1, &VBO);
+
+    glBindVertexArray(VAO);
+    glBindBuffer(GL_ARRAY_BUFFER, VBO);
+    glBufferData(GL_ARRAY_BUFFER, sizeof(vertices), vertices, GL_STATIC_DRAW);
+
+    // 顶点位置
+    glVertexAttribPointer(0, 3, GL_FLOAT, GL_FALSE, 5 * sizeof(float), (void *)nullptr);
+    glEnableVertexAttribArray(0);
+    // 纹理坐标
+    glVertexAttribPointer(1, 2, GL_FLOAT, GL_FALSE, 5 * sizeof(float), (void *)(3 * sizeof(float)));
+    glEnableVertexAttribArray(1);
+
+    // 摄像机UBO：view + projection，绑定点0
+    unsigned int cameraUBO;
+    glGenBuffers(1, &cameraUBO);
+    glBindBuffer(GL_UNIFORM_BUFFER, cameraUBO);
+    glBufferData(GL_UNIFORM_BUFFER, 2 * sizeof(glm::mat4), nullptr, GL_DYNAMIC_DRAW);
+    glBindBufferBase(GL_UNIFORM_BUFFER, 0, cameraUBO);
+    glUniformBlockBinding(ourShader.ID, glGetUniformBlockIndex(ourShader.ID, "CameraBlock"), 0);
+
+    // 创建纹理
+    unsigned int textures[2];
+    const char *texturePaths[2] = {"container.jpg", "awesomeface.png"};
+    for (int i = 0; i < 2; i++)
+        textures[i] = LoadTexture(texturePaths[i]);
+
+    // 激活纹理
+    ourShader.use();
+    ourShader.setInt("texture1", 0);
+    ourShader.setInt("texture2", 1);
+
+    // 写入摄像机UBO，之后紧接着就是绘制调用
+    auto updateCameraBlock = [&]() {
+        glm::mat4 matrices[2] = {camera.GetViewMatrix(), camera.GetProjectionMatrix((float)SCR_WIDTH / (float)SCR_HEIGHT)};
+        glBindBuffer(GL_UNIFORM_BUFFER, cameraUBO);
+        glBufferSubData(GL_UNIFORM_BUFFER, 0, sizeof(matrices), matrices);
+    };
+
+    // validate：每种模式渲染的帧数，前几帧不统计
+    const int validateFrames = 60, warmupFrames = 5;
+    int frame = 0;
+
+    // 渲染循环
+    // -----------
+    LatencyStats stats;
+    double lastLatch = 0.0;
+    double titleTimer = InputTimestamp();
+    while (validateMode ? frame < 2 * validateFrames : !glfwWindowShouldClose(window))
+    {
+        double frameStart = InputTimestamp();
+        if (validateMode)
+            lateLatch = frame >= validateFrames;
+
+        // 传统做法：帧开始时处理输入
+        if (!lateLatch) {
+            latchInput(frameStart, lastLatch);
+            updateCameraBlock();
+        }
+
+        // 模拟绘制前的CPU工作
+        while ((InputTimestamp() - frameStart) * 1000.0 < FRAME_WORK_MS)
+            ;
+
+        glClearColor(0.2f, 0.3f, 0.3f, 1.0f);
+        glClear(GL_COLOR_BUFFER_BIT | GL_DEPTH_BUFFER_BIT);
+
+        glActiveTexture(GL_TEXTURE0);
+        glBindTexture(GL_TEXTURE_2D, textures[0]);
+        glActiveTexture(GL_TEXTURE1);
+        glBindTexture(GL_TEXTURE_2D, textures[1]);
+        ourShader.use();
+        glBindVertexArray(VAO);
+
+        // 最后时刻锁定：其它状态都准备好了，只剩摄像机UBO和绘制调用
+        if (lateLatch) {
+            latchInput(InputTimestamp(), lastLatch);
+            updateCameraBlock();
+        }
+
+        for (unsigned int i = 0; i < 10; i++) {
+            glm::mat4 model = glm::mat4(1.0f);
+            model = glm::translate(model, cubePositions[i]);
+            model = glm::rotate(model, glm::radians(20.0f * i), glm::vec3(1.0f, 0.3f, 0.5f));
+            ourShader.setMat4("model", model);
+            glDrawArrays(GL_TRIANGLES, 0, 36);
+        }
+
+        glfwSwapBuffers(window);
+        // 等待这一帧真正完成，作为画面更新的时刻
+        glFinish();
+        double presented = InputTimestamp();
+        for (double time : latchedEvents) {
+            stats.Add(presented - time);
+            if (validateMode && frame % validateFrames >= warmupFrames)
+                validateStats[lateLatch ? 1 : 0].Add(presented - time);
+        }
+        latchedEvents.clear();
+        frame++;
+
+        if (presented - titleTimer > 0.5) {
+            titleTimer = presented;
+            std::string title = std::string("Input Latency - ") + (lateLatch ? "late latch" : "latch at frame start") +
+                                " - avg " + std::to_string(stats.AverageMs()) + " ms, max " + std::to_string(stats.MaxMs()) +
+                                " ms (" + std::to_string(stats.Count) + " events)";
+            std::lock_guard<std::mutex> lock(titleMutex);
+            pendingTitle = title;
+            stats = LatencyStats();
+        }
+    }
+
+    glDeleteVertexArrays(1, &VAO);
+    glDeleteBuffers(1, &VBO);
+    glDeleteBuffers(1, &cameraUBO);
+    glDeleteTextures(2, textures);
+    glfwMakeContextCurrent(nullptr);
+}
+
+// 渲染线程结束后在主线程中检查：取出剩下的事件，所有模拟的鼠标事件都要被摄像机处理，
+// Yaw的变化等于事件数 * 灵敏度；最后时刻锁定的平均延迟必须比帧开始时处理输入更低
+// ---------------------------------------------------------------------------------------------------------
+int validate(unsigned int pushed)
+{
+    using std::cout;
+    using std::endl;
+
+    double lastLatch = 0.0;
+    latchInput(InputTimestamp(), lastLatch);
+    float expectedYaw = YAW + pushed * SENSITIVITY;
+    bool lossless = droppedEvents == 0 && latchedTotal == pushed && std::fabs(camera.Yaw - expectedYaw) < 1e-4f * pushed;
+    bool lower = validateStats[1].AverageMs() < validateStats[0].AverageMs();
+
+    cout << "latch at frame start: avg " << validateStats[0].AverageMs() << " ms, max " << validateStats[0].MaxMs()
+         << " ms (" << validateStats[0].Count << " events)" << endl;
+    cout << "late latch:           avg " << validateStats[1].AverageMs() << " ms, max " << validateStats[1].MaxMs()
+         << " ms (" << validateStats[1].Count << " events)" << (lower ? " OK" : " NOT LOWER") << endl;
+    cout << "events pushed " << pushed << ", processed " << latchedTotal << ", dropped " << droppedEvents
+         << ", yaw " << camera.Yaw << " expected " << expectedYaw << (lossless ? " OK" : " MISMATCH") << endl;
+    return lossless && lower ? EXIT_SUCCESS : EXIT_FAILURE;
+}
+
+// 下面的回调都在主线程中执行，只把事件放进队列，不直接修改摄像机
+// ---------------------------------------------------------------------------------------------------------
+void key_callback(GLFWwindow* window, int key, int scancode, int action, int mods)
+{
+    if (key == GLFW_KEY_ESCAPE && action == GLFW_PRESS)
+        glfwSetWindowShouldClose(window, true);
+    pushEvent({InputEvent::KEY, InputTimestamp(), 0.0, 0.0, key, action});
+}
+
+// glfw: whenever the window size changed (by OS or user resize) this callback function executes
+// ---------------------------------------------------------------------------------------------
+void framebuffer_size_callback(GLFWwindow* window, int width, int height)
+{
+    // 窗口创建时设置了 GLFW_RESIZABLE = false，大小不会改变，默认视口一直有效
+}
+
+void mouse_callback(GLFWwindow* window, double xpos, double ypos) {
+    pushEvent({InputEvent::CURSOR_POS, InputTimestamp(), xpos, ypos, 0, 0});
+}
+
+void scroll_callback(GLFWwindow* window, double xoffset, double yoffset)
+{
+    pushEvent({InputEvent::SCROLL, InputTimestamp(), xoffset, yoffset, 0, 0});
+}
@@ -0,0 +1,18 @@
+#version 330 core
+layout (location = 0) in vec3 aPos;
+layout (location = 1) in vec2 aTexCoord;
+
+out vec2 TexCoord;
+
+// 摄像机矩阵放在UBO里，渲染线程在绘制前最后一刻才更新
+layout (std140) uniform CameraBlock {
+	mat4 view;
+	mat4 projection;
+};
+
+uniform mat4 model;
+
+void main() {
+	gl_Position = projection * view * model * vec4(aPos, 1.0f);
+	TexCoord = vec2(aTexCoord);
+}
@@ -0,0 +1,429 @@
+// 大世界示例：GRID x GRID 个立方体放在10^7量级的世界坐标上，物体和摄像机的世界坐标都用双精度保存
+// 按P切换两种做法：以摄像机为原点在CPU上生成 视图 * 模型 矩阵（双精度相减后再转换成float），
+// 或者直接用float的世界矩阵和视图矩阵（顶点会明显抖动、错位）；按O在远处和原点附近之间切换场景
+//
+// 运行参数：
+//   --validate   隐藏窗口，同一组相机位姿分别在原点附近和10^7处渲染，以摄像机为原点的结果必须和原点附近的一致
+#include <iostream>
+#include <cstring>
+#include <vector>
+#include <string>
+#include <cmath>
+#include <cstdlib>
+#include <glad/glad.h>
+#include <GLFW/glfw3.h>
+
+#include <glm/glm.hpp>
+#include <glm/gtc/matrix_transform.hpp>
+#include <glm/gtc/quaternion.hpp>
+#include <glm/gtc/type_ptr.hpp>
+
+
+#include <learnopengl/shader.h>
+#include <learnopengl/camera.h>
+#include <learnopengl/texture.h>
+#include <learnopengl/camera_relative.h>
+
+void framebuffer_size_callback(GLFWwindow* window, int width, int height);
+void mouse_callback(GLFWwindow* window, double xpos, double ypos);
+void scroll_callback(GLFWwindow* window, double xoffset, double yoffset);
+void key_callback(GLFWwindow* window, int key, int scancode, int action, int mods);
+void processInput(GLFWwindow *window);
+
+// 窗口大小
+const unsigned int SCR_WIDTH = 800;
+const unsigned int SCR_HEIGHT = 800;
+
+// 场景：GRID x GRID 个立方体，整体放在WORLD_CENTER附近
+const int GRID = 32;
+const float SPACING = 1.5f;
+const glm::dvec3 WORLD_CENTER(1e7, 0.0, -1e7);
+
+// camera
+Camera camera(glm::vec3(0.0f, 3.0f, 10.0f), glm::vec3(0.0f, 1.0f, 0.0f), -90.0f, -15.0f);
+
+bool firstMouse = true;
+double lastX = SCR_WIDTH / 2.0;
+double lastY = SCR_HEIGHT / 2.0;
+
+// timing
+float deltaTime = 0.0f;	// time between current frame and last frame
+float lastFrame = 0.0f;
+
+// P：是否以摄像机为原点；O：场景放在WORLD_CENTER还是原点
+bool cameraRelative = true;
+bool farAway = true;
+
+// 按center摆放场景
+void buildScene(CameraRelativeBatch &batch, const glm::dvec3 &center);
+// 生成这一帧所有物体的 视图 * 模型 矩阵，直接写进映射出来的实例缓冲
+void uploadModelViews(const CameraRelativeBatch &batch, const Camera &cam, bool relative, unsigned int instanceVBO);
+int validate(CameraRelativeBatch &batch, Shader &shader, unsigned int VAO, unsigned int instanceVBO);
+
+int main(int argc, char *argv[])
+{
+    using std::cout;
+    using std::endl;
+
+    bool validateMode = argc > 1 && std::strcmp(argv[1], "--validate") == 0;
+
+    // glfw: 初始化设置
+    // ------------------------------
+    glfwInit();
+    glfwWindowHint(GLFW_CONTEXT_VERSION_MAJOR, 3);
+    glfwWindowHint(GLFW_CONTEXT_VERSION_MINOR, 3);
+    glfwWindowHint(GLFW_OPENGL_PROFILE, GLFW_OPENGL_CORE_PROFILE);
+    if (validateMode)
+        glfwWindowHint(GLFW_VISIBLE, GLFW_FALSE);
+
+    // glfw: 创建窗口
+    // --------------------
+    GLFWwindow* window = glfwCreateWindow(SCR_WIDTH, SCR_HEIGHT, "LearnOpenGL", nullptr, nullptr);
+    if (window == nullptr)
+    {
+        cout << "Failed to create GLFW window" << endl;
+        glfwTerminate();
+        exit(EXIT_FAILURE);
+    }
+    glfwMakeContextCurrent(window);     // 设置OpenGL上下文
+    glfwSetFramebufferSizeCallback(window, framebuffer_size_callback);
+    glfwSetCursorPosCallback(window, mouse_callback);
+    glfwSetScrollCallback(window, scroll_callback);
+    glfwSetKeyCallback(window, key_callback);
+    if (!validateMode)
+        glfwSetInputMode(window, GLFW_CURSOR, GLFW_CURSOR_DISABLED);
+
+    // glad: 加载OpenGL函数指针
+    // ---------------------------------------
+    if (!gladLoadGLLoader((GLADloadproc)glfwGetProcAddress))
+    {
+        cout << "Failed to initialize GLAD" << endl;
+        exit(EXIT_FAILURE);
+    }
+    glEnable(GL_DEPTH_TEST);
+    camera.FarPlane = 500.0f;
+    camera.WorldOrigin = WORLD_CENTER;
+
+    // 定义编译着色器
+    Shader ourShader("camera_relative.vs", "6.1.coordinate_systems.fs");
+
+    // 定义顶点数据，包含位置、纹理坐标
+    float vertices[] = {        // 立方体的六个面
+            -0.5f, -0.5f, -0.5f,  0.0f, 0.0f,
+             0.5f, -0.5f, -0.5f,  1.0f, 0.0f,
+             0.5f,  0.5f, -0.5f,  1.0f, 1.0f,
+             0.5f,  0.5f, -0.5f,  1.0f, 1.0f,
+            -0.5f,  0.5f, -0.5f,  0.0f, 1.0f,
+            -0.5f, -0.5f, -0.5f,  0.0f, 0.0f,
+
+            -0.5f, -0.5f,  0.5f,  0.0f, 0.0f,
+             0.5f, -0.5f,  0.5f,  1.0f, 0.0f,
+             0.5f,  0.5f,  0.5f,  1.0f, 1.0f,
+             0.5f,  0.5f,  0.5f,  1.0f, 1.0f,
+            -0.5f,  0.5f,  0.5f,  0.0f, 1.0f,
+            -0.5f, -0.5f,  0.5f,  0.0f, 0.0f,
+
+            -0.5f,  0.5f,  0.5f,  1.0f, 0.0f,
+            -0.5f,  0.5f, -0.5f,  1.0f, 1.0f,
+            -0.5f, -0.5f, -0.5f,  0.0f, 1.0f,
+            -0.5f, -0.5f, -0.5f,  0.0f, 1.0f,
+            -0.5f, -0.5f,  0.5f,  0.0f, 0.0f,
+            -0.5f,  0.5f,  0.5f,  1.0f, 0.0f,
+
+             0.5f,  0.5f,  0.5f,  1.0f, 0.0f,
+             0.5f,  0.5f, -0.5f,  1.0f, 1.0f,
+             0.5f, -0.5f, -0.5f,  0.0f, 1.0f,
+             0.5f, -0.5f, -0.5f,  0.0f, 1.0f,
+             0.5f, -0.5f,  0.5f,  0.0f, 0.0f,
+             0.5f,  0.5f,  0.5f,  1.0f, 0.0f,
+
+            -0.5f, -0.5f, -0.5f,  0.0f, 1.0f,
+             0.5f, -0.5f, -0.5f,  1.0f, 1.0f,
+             0.5f, -0.5f,  0.5f,  1.0f, 0.0f,
+             0.5f, -0.5f,  0.5f,  1.0f, 0.0f,
+            -0.5f, -0.5f,  0.5f,  0.0f, 0.0f,
+            -0.5f, -0.5f, -0.5f,  0.0f, 1.0f,
+
+            -0.5f,  0.5f, -0.5f,  0.0f, 1.0f,
+             0.5f,  0.5f, -0.5f,  1.0f, 1.0f,
+             0.5f,  0.5f,  0.5f,  1.0f, 0.0f,
+             0.5f,  0.5f,  0.5f,  1.0f, 0.0f,
+            -0.5f,  0.5f,  0.5f,  0.0f, 0.0f,
+            -0.5f,  0.5f, -0.5f,  0.0f, 1.0f
+    };
+
+    CameraRelativeBatch batch;
+    buildScene(batch, WORLD_CENTER);
+    cout << "Objects: " << batch.Count() << endl;
+
+    // 创建顶点缓冲和顶点数组
+    unsigned int VAO, VBO, instanceVBO;
+    glGenVertexArrays(1, &VAO);
+    glGenBuffers(1, &VBO);
+    glGenBuffers(1, &instanceVBO);
+
+    glBindVertexArray(VAO);
+    glBindBuffer(GL_ARRAY_BUFFER, VBO);
+    glBufferData(GL_ARRAY_BUFFER, sizeof(vertices), vertices, GL_STATIC_DRAW);
+
+    // 顶点位置
+    glVertexAttribPointer(0, 3, GL_FLOAT, GL_FALSE, 5 * sizeof(float), (void *)nullptr);
+    glEnableVertexAttribArray(0);
+    // 纹理坐标
+    glVertexAttribPointer(1, 2, GL_FLOAT, GL_FALSE, 5 * sizeof(float), (void *)(3 * sizeof(float)));
+    glEnableVertexAttribArray(1);
+
+    // 视图 * 模型矩阵，每个实例一个，mat4属性占4个location；摄像机一动所有矩阵都会变，每帧整体重写
+    glBindBuffer(GL_ARRAY_BUFFER, instanceVBO);
+    glBufferData(GL_ARRAY_BUFFER, batch.Count() * sizeof(glm::mat4), nullptr, GL_STREAM_DRAW);
+    for (int column = 0; column < 4; column++) {
+        glVertexAttribPointer(2 + column, 4, GL_FLOAT, GL_FALSE, sizeof(glm::mat4), (void *)(column * sizeof(glm::vec4)));
+        glEnableVertexAttribArray(2 + column);
+        glVertexAttribDivisor(2 + column, 1);
+    }
+
+    // 创建纹理
+    unsigned int textures[2];
+    const char *texturePaths[2] = {"container.jpg", "awesomeface.png"};
+    for (int i = 0; i < 2; i++)
+        textures[i] = LoadTexture(texturePaths[i]);
+
+    // 激活纹理
+    ourShader.use();
+    ourShader.setInt("texture1", 0);
+    ourShader.setInt("texture2", 1);
+
+    if (validateMode) {
+        glActiveTexture(GL_TEXTURE0);
+        glBindTexture(GL_TEXTURE_2D, textures[0]);
+        glActiveTexture(GL_TEXTURE1);
+        glBindTexture(GL_TEXTURE_2D, textures[1]);
+        int failures = validate(batch, ourShader, VAO, instanceVBO);
+        glDeleteVertexArrays(1, &VAO);
+        glDeleteBuffers(1, &VBO);
+        glDeleteBuffers(1, &instanceVBO);
+        glDeleteTextures(2, textures);
+        glfwTerminate();
+        return failures == 0 ? EXIT_SUCCESS : EXIT_FAILURE;
+    }
+
+    // 渲染循环
+    // -----------
+    float titleTimer = 0.0f;
+    bool sceneFarAway = farAway;
+    while (!glfwWindowShouldClose(window))
+    {
+        float currentFrame = glfwGetTime();
+        deltaTime = currentFrame - lastFrame;
+        lastFrame = currentFrame;
+
+        processInput(window);
+
+        // 切换场景位置时摄像机一起平移，画面保持不变
+        if (sceneFarAway != farAway) {
+            glm::dvec3 center = farAway ? WORLD_CENTER : glm::dvec3(0.0);
+            camera.WorldOrigin += center - (farAway ? glm::dvec3(0.0) : WORLD_CENTER);
+            batch.Clear();
+            buildScene(batch, center);
+            sceneFarAway = farAway;
+        }
+
+        uploadModelViews(batch, camera, cameraRelative, instanceVBO);
+
+        glClearColor(0.2f, 0.3f, 0.3f, 1.0f);
+        glClear(GL_COLOR_BUFFER_BIT | GL_DEPTH_BUFFER_BIT);
+
+        glActiveTexture(GL_TEXTURE0);
+        glBindTexture(GL_TEXTURE_2D, textures[0]);
+        glActiveTexture(GL_TEXTURE1);
+        glBindTexture(GL_TEXTURE_2D, textures[1]);
+
+        ourShader.use();
+        ourShader.setMat4("projection", camera.GetProjectionMatrix((float)SCR_WIDTH / (float)SCR_HEIGHT));
+
+        glBindVertexArray(VAO);
+        glDrawArraysInstanced(GL_TRIANGLES, 0, 36, batch.Count());
+
+        titleTimer += deltaTime;
+        if (titleTimer > 0.5f) {
+            titleTimer = 0.0f;
+            glm::dvec3 eye = camera.GetWorldPosition();
+            std::string title = std::string("Large World - ") + (cameraRelative ? "camera-relative" : "float world") +
+                                " - eye (" + std::to_string(eye.x) + ", " + std::to_string(eye.y) + ", " +
+                                std::to_string(eye.z) + ") - " + std::to_string(deltaTime * 1000.0f) + " ms";
+            glfwSetWindowTitle(window, title.c_str());
+        }
+
+        // glfw: 交换颜色缓冲，检测事件
+        // -------------------------------------------------------------------------------
+        glfwSwapBuffers(window);
+        glfwPollEvents();
+    }
+
+    glDeleteVertexArrays(1, &VAO);
+    glDeleteBuffers(1, &VBO);
+    glDeleteBuffers(1, &instanceVBO);
+    glDeleteTextures(2, textures);
+
+    glfwTerminate();
+    return 0;
+}
+
+void buildScene(CameraRelativeBatch &batch, const glm::dvec3 &center)
+{
+    for (int z = 0; z < GRID; z++) {
+        for (int x = 0; x < GRID; x++) {
+            glm::dvec3 offset((x - GRID / 2) * SPACING, 0.0, -z * SPACING);
+            float h = (float) (x * 7 + z * 13);
+            glm::quat rotation = glm::angleAxis(glm::radians(20.0f * (x + z)), glm::normalize(glm::vec3(sin(h), 1.0f, cos(h * 0.7f))));
+            batch.Add(center + offset, rotation, glm::vec3(0.5f + 0.1f * ((x + z) % 4)));
+        }
+    }
+}
+
+void uploadModelViews(const CameraRelativeBatch &batch, const Camera &cam, bool relative, unsigned int instanceVBO)
+{
+    glBindBuffer(GL_ARRAY_BUFFER, instanceVBO);
+    void *mapped = glMapBufferRange(GL_ARRAY_BUFFER, 0, batch.Count() * sizeof(glm::mat4),
+                                    GL_MAP_WRITE_BIT | GL_MAP_INVALIDATE_BUFFER_BIT);
+    if (!mapped)
+        return;
+    glm::dvec3 eye = cam.GetWorldPosition();
+    if (relative) {
+        batch.Build(eye, cam.GetViewRotationMatrix(), static_cast<float *>(mapped));
+    } else {
+        // 常见的做法：摄像机位置转换成float后构造视图矩阵
+        glm::mat4 view = glm::translate(cam.GetViewRotationMatrix(), -glm::vec3(eye));
+        batch.BuildSinglePrecision(view, static_cast<float *>(mapped));
+    }
+    glUnmapBuffer(GL_ARRAY_BUFFER);
+}
+
+// 同一组相机位姿（相对场景中心）分别在原点附近、10^7处渲染，读回颜色逐像素对比
+// 以摄像机为原点的做法必须和原点附近的结果一致，float世界矩阵的结果只打印出来对比
+// ---------------------------------------------------------------------------------------------------------
+int validate(CameraRelativeBatch &batch, Shader &shader, unsigned int VAO, unsigned int instanceVBO)
+{
+    using std::cout;
+    using std::endl;
+
+    struct Pose { glm::vec3 Position; float Yaw, Pitch; };
+    const Pose poses[] = {
+            {glm::vec3(  0.0f, 3.0f,  10.0f),  -90.0f, -15.0f},
+            {glm::vec3( 20.0f, 1.0f, -10.0f), -150.0f,  -5.0f},
+            {glm::vec3(-30.0f, 8.0f, -60.0f),   45.0f, -20.0f},
+            {glm::vec3(  0.3f, 0.6f, -20.2f),  -80.0f,   0.0f}     // 贴近立方体
+    };
+    // 一个整数坐标，一个不能被double精确表示的坐标
+    const glm::dvec3 centers[] = {WORLD_CENTER, glm::dvec3(12345678.9, -2345678.9, -9876543.21)};
+
+    int width = SCR_WIDTH, height = SCR_HEIGHT;
+    glfwGetFramebufferSize(glfwGetCurrentContext(), &width, &height);
+    glViewport(0, 0, width, height);
+    std::vector<unsigned char> reference((size_t) width * height * 4), pixels(reference.size());
+
+    auto render = [&](const glm::dvec3 &center, const Pose &pose, bool relative, std::vector<unsigned char> &out) {
+        batch.Clear();
+        buildScene(batch, center);
+        Camera cam(pose.Position, glm::vec3(0.0f, 1.0f, 0.0f), pose.Yaw, pose.Pitch);
+        cam.FarPlane = 500.0f;
+        cam.WorldOrigin = center;
+        uploadModelViews(batch, cam, relative, instanceVBO);
+
+        glClearColor(0.2f, 0.3f, 0.3f, 1.0f);
+        glClear(GL_COLOR_BUFFER_BIT | GL_DEPTH_BUFFER_BIT);
+        shader.use();
+        shader.setMat4("projection", cam.GetProjectionMatrix((float)width / (float)height));
+        glBindVertexArray(VAO);
+        glDrawArraysInstanced(GL_TRIANGLES, 0, 36, batch.Count());
+        glReadPixels(0, 0, width, height, GL_RGBA, GL_UNSIGNED_BYTE, out.data());
+    };
+    // 任一通道相差超过8的像素个数
+    auto countDifferent = [&]() {
+        int different = 0;
+        for (size_t i = 0; i < pixels.size(); i += 4)
+            for (int c = 0; c < 3; c++)
+                if (std::abs(pixels[i + c] - reference[i + c]) > 8) {
+                    different++;
+                    break;
+                }
+        return different;
+    };
+
+    int failures = 0;
+    int index = 0;
+    const int allowed = width * height / 1000;      // 光栅化的舍入差异，最多0.1%
+    for (const Pose &pose : poses) {
+        render(glm::dvec3(0.0), pose, true, reference);
+        for (const glm::dvec3 &center : centers) {
+            render(center, pose, true, pixels);
+            int relativeDifferent = countDifferent();
+            render(center, pose, false, pixels);
+            int floatDifferent = countDifferent();
+            bool ok = relativeDifferent <= allowed;
+            cout << "pose " << index << " at (" << center.x << ", " << center.y << ", " << center.z << "): "
+                 << "camera-relative " << relativeDifferent << " pixels differ" << (ok ? " OK" : " FAIL")
+                 << ", float world " << floatDifferent << " pixels differ" << endl;
+            if (!ok)
+                failures++;
+        }
+        index++;
+    }
+    cout << (failures == 0 ? "camera-relative rendering matches the origin reference" : "camera-relative validation FAILED") << endl;
+    return failures;
+}
+
+// process all input: query GLFW whether relevant keys are pressed/released this frame and react accordingly
+// ---------------------------------------------------------------------------------------------------------
+void processInput(GLFWwindow *window)
+{
+    if (glfwGetKey(window, GLFW_KEY_ESCAPE) == GLFW_PRESS)
+        glfwSetWindowShouldClose(window, true);
+
+    // Position只保存相对WorldOrigin的位移，每帧并入WorldOrigin，移动的精度不受世界坐标大小影响
+    camera.RebaseOrigin();
+    if (glfwGetKey(window, GLFW_KEY_W) == GLFW_PRESS)
+        camera.ProcessKeyboard(FORWARD, deltaTime);
+    if (glfwGetKey(window, GLFW_KEY_S) == GLFW_PRESS)
+        camera.ProcessKeyboard(BACKWARD, deltaTime);
+    if (glfwGetKey(window, GLFW_KEY_A) == GLFW_PRESS)
+        camera.ProcessKeyboard(LEFT, deltaTime);
+    if (glfwGetKey(window, GLFW_KEY_D) == GLFW_PRESS)
+        camera.ProcessKeyboard(RIGHT, deltaTime);
+}
+
+void key_callback(GLFWwindow* window, int key, int scancode, int action, int mods)
+{
+    if (action != GLFW_PRESS)
+        return;
+    if (key == GLFW_KEY_P)
+        cameraRelative = !cameraRelative;
+    if (key == GLFW_KEY_O)
+        farAway = !farAway;
+}
+
+// glfw: whenever the window size changed (by OS or user resize) this callback function executes
+// ---------------------------------------------------------------------------------------------
+void framebuffer_size_callback(GLFWwindow* window, int width, int height)
+{
+    glViewport(0, 0, width, height);
+}
+
+void mouse_callback(GLFWwindow* window, double xpos, double ypos) {
+    if (firstMouse) {
+        lastX = xpos;
+        lastY = ypos;
+        firstMouse = false;
+    }
+    float xoffset = xpos - lastX;
+    float yoffset = lastY - ypos;
+    lastX = xpos;
+    lastY = ypos;
+
+    camera.ProcessMouseMovement(xoffset, yoffset);
+}
+
+void scroll_callback(GLFWwindow* window, double xoffset, double yoffset)
+{
+    camera.ProcessMouseScroll(yoffset);
+}
@@ -1,20 +1,26 @@
-#define STB_IMAGE_IMPLEMENTATION
 #include <iostream>
+#include <vector>
 #include <glad/glad.h>
 #include <GLFW/glfw3.h>
 
 #include <glm/glm.hpp>
 #include <glm/gtc/matrix_transform.hpp>
+#include <glm/gtc/quaternion.hpp>
 #include <glm/gtc/type_ptr.hpp>
 
 
-#include "stb_image.h"
-#include "shader_s.h"
-#include "camera.h"
+#include <stb_image.h>
+#include <learnopengl/shader.h>
+#include <learnopengl/camera.h>
+#include <learnopengl/bvh.h>
+#include <learnopengl/picking.h>
+#include <learnopengl/transforms.h>
+#include <learnopengl/sample_capture.h>
 
 void framebuffer_size_callback(GLFWwindow* window, int width, int height);
 void mouse_callback(GLFWwindow* window, double xpos, double ypos);
 void scroll_callback(GLFWwindow* window, double xoffset, double yoffset);
+void key_callback(GLFWwindow* window, int key, int scancode, int action, int mods);
 void processInput(GLFWwindow *window);
 
 // 窗口大小
@@ -28,22 +34,39 @@ bool firstMouse = true;
 double lastX = SCR_WIDTH / 2.0;
 double lastY = SCR_HEIGHT / 2.0;
 
+// 编辑模式：Tab切换，光标可见，摄像机不跟随鼠标旋转，拾取光标下的物体；否则拾取屏幕中心
+bool editorMode = false;
+double cursorX = SCR_WIDTH / 2.0;
+double cursorY = SCR_HEIGHT / 2.0;
+
 // timing
 float deltaTime = 0.0f;	// time between current frame and last frame
 float lastFrame = 0.0f;
 
 
-int main()
+int main(int argc, char *argv[])
 {
     using std::cout;
     using std::endl;
 
+    // --capture：隐藏窗口渲染一帧并截图，golden_images 用它和参考图比较
+    SampleCapture capture;
+    if (!capture.Parse(argc, argv))
+        return EXIT_FAILURE;
+    if (capture.HasCamera) {
+        camera.Position = capture.CameraPosition;
+        camera.Yaw = capture.CameraYaw;
+        camera.Pitch = capture.CameraPitch;
+        camera.Zoom = capture.CameraZoom;
+    }
+
     // glfw: 初始化设置
     // ------------------------------
     glfwInit();
     glfwWindowHint(GLFW_CONTEXT_VERSION_MAJOR, 3);
     glfwWindowHint(GLFW_CONTEXT_VERSION_MINOR, 3);
     glfwWindowHint(GLFW_OPENGL_PROFILE, GLFW_OPENGL_CORE_PROFILE);
+    capture.WindowHints();
 
     // glfw: 创建窗口
     // --------------------
@@ -60,6 +83,7 @@ int main()
     // 鼠标输入回调函数
     glfwSetCursorPosCallback(window, mouse_callback);
     glfwSetScrollCallback(window, scroll_callback);
+    glfwSetKeyCallback(window, key_callback);
     // tell GLFW to capture our mouse
     glfwSetInputMode(window, GLFW_CURSOR, GLFW_CURSOR_DISABLED);
 
@@ -134,6 +158,24 @@ int main()
             glm::vec3(-1.3f,  1.0f, -1.5f)
     };
 
+    // 立方体旋转后的包围盒放进BVH，每帧只遍历视锥体内的立方体，不再线性扫描整个数组
+    // 模型矩阵由TransformSystem批量计算，立方体不动就不会被重新计算，渲染循环里不再每帧重建
+    TransformSystem cubeTransforms;
+    for (int i = 0; i < 10; i++)
+        cubeTransforms.Add(cubePositions[i], glm::angleAxis(glm::radians(20.0f * i), glm::normalize(glm::vec3(1.0f, 0.3f, 0.5f))));
+    std::vector<glm::mat4> cubeModels(cubeTransforms.Count());
+    cubeTransforms.Update(glm::value_ptr(cubeModels[0]));
+
+    std::vector<AABB> cubeBounds;
+    for (const auto &model : cubeModels)
+        cubeBounds.push_back(AABB(glm::vec3(-0.5f), glm::vec3(0.5f)).Transformed(model));
+    BVH cubeBVH;
+    cubeBVH.Build(cubeBounds);
+
+    // 拾取：场景BVH找到射线经过的立方体，再在物体空间里和立方体的三角形求交
+    MeshPicker cubePicker;
+    cubePicker.Build(vertices, 36, 5);
+
     // 创建顶点缓冲和顶点数组
     unsigned int VAO, VBO;
     glGenVertexArrays(1, &VAO);     // 1代表VAO数量
@@ -225,28 +267,44 @@ int main()
          ourShader.use();
 
         // 矩阵
-        glm::mat4 projection = glm::perspective(glm::radians(camera.Zoom), (float)SCR_WIDTH / (float)SCR_HEIGHT, 0.1f, 100.0f);
+        glm::mat4 projection = camera.GetProjectionMatrix((float)SCR_WIDTH / (float)SCR_HEIGHT);
         ourShader.setMat4("projection", projection);
 
         glm::mat4 view = camera.GetViewMatrix();
         ourShader.setMat4("view", view);
 
+        // 拾取光标下最近的立方体，投影矩阵使用固定的SCR_WIDTH / SCR_HEIGHT，光标坐标先按窗口大小换算过去
+        int windowWidth, windowHeight;
+        glfwGetWindowSize(window, &windowWidth, &windowHeight);
+        float pickX = editorMode && windowWidth > 0 ? (float) (cursorX * SCR_WIDTH / windowWidth) : SCR_WIDTH * 0.5f;
+        float pickY = editorMode && windowHeight > 0 ? (float) (cursorY * SCR_HEIGHT / windowHeight) : SCR_HEIGHT * 0.5f;
+        Ray ray = camera.ScreenPointToRay(pickX, pickY, (float) SCR_WIDTH, (float) SCR_HEIGHT);
+        int hovered = -1;
+        float hitDistance = 100.0f;
+        cubeBVH.Raycast(ray, hitDistance, [&](unsigned int i, float &t) {
+            PickHit hit = cubePicker.Pick(ray, cubeModels[i], t);
+            if (!hit.Hit)
+                return false;
+            t = hit.Distance;
+            hovered = (int) i;
+            return true;
+        });
+
         // 渲染输出
         glBindVertexArray(VAO);
 
-        for (int i = 0; i < 10; i++) {
-            glm::mat4 model = glm::mat4(1.0f);
-            model = glm::translate(model, cubePositions[i]);
-            float angle = 20.f * i;
-            model = glm::rotate(model, glm::radians(angle), glm::vec3(1.0f, 0.3f, 0.5f));
-            ourShader.setMat4("model", model);
+        Frustum frustum(projection * view);
+        cubeBVH.QueryFrustum(frustum, [&](unsigned int i) {
+            ourShader.setMat4("model", cubeModels[i]);
+            ourShader.setBool("highlight", (int) i == hovered);
 
             glDrawArrays(GL_TRIANGLES, 0, 36);
-        }
+        });
         // glDrawElements(GL_TRIANGLES, 6, GL_UNSIGNED_INT, nullptr);
 
         // glfw: 交换颜色缓冲（存储着每个像素颜色的大缓冲），在本轮迭代中用来绘制窗口
         // -------------------------------------------------------------------------------
+        capture.EndFrame(window);
         glfwSwapBuffers(window);
         // 事件触发检测
         glfwPollEvents();
@@ -260,7 +318,7 @@ int main()
     // glfw: 终结窗口显示，并释放资源
     // ------------------------------------------------------------------
     glfwTerminate();
-    return 0;
+    return capture.ExitCode();
 }
 
 // process all input: query GLFW whether relevant keys are pressed/released this frame and react accordingly
@@ -280,6 +338,16 @@ void processInput(GLFWwindow *window)
         camera.ProcessKeyboard(RIGHT, deltaTime);
 }
 
+void key_callback(GLFWwindow* window, int key, int scancode, int action, int mods)
+{
+    if (action != GLFW_PRESS || key != GLFW_KEY_TAB)
+        return;
+    editorMode = !editorMode;
+    glfwSetInputMode(window, GLFW_CURSOR, editorMode ? GLFW_CURSOR_NORMAL : GLFW_CURSOR_DISABLED);
+    // 切回摄像机模式时重新记录光标位置，避免视角跳动
+    firstMouse = true;
+}
+
 // glfw: whenever the window size changed (by OS or user resize) this callback function executes
 // ---------------------------------------------------------------------------------------------
 void framebuffer_size_callback(GLFWwindow* window, int width, int height)
@@ -289,6 +357,10 @@ void framebuffer_size_callback(GLFWwindow* window, int width, int height)
 }
 
 void mouse_callback(GLFWwindow* window, double xpos, double ypos) {
+    cursorX = xpos;
+    cursorY = ypos;
+    if (editorMode)
+        return;
     if (firstMouse) {
         lastX = xpos;
         lastY = ypos;
@@ -0,0 +1,660 @@
+// 网格导入示例：用 MeshImporter 加载OBJ或glb文件（命令行参数），没有参数时生成一个细分的球面（OBJ和glb各一份）
+// 导入结果是索引化、去重后的顶点和索引，直接交给 glBufferData；glb还可以不经过 ImportedMesh，
+// 把映射的文件中每个访问器的数据直接上传（零拷贝），按G键在两种方式之间切换，标题栏显示加载时间和网格大小
+//
+// 运行参数：
+//   [文件]       要加载的 .obj / .glb 文件
+//   --validate   隐藏窗口，检查OBJ解析（负索引、多边形、缺少的属性、CRLF、忽略的行、分块和线程数不影响结果）、
+//                出错时的行号、glb的节点层级和变换、损坏的glb被拒绝，以及导入的网格和零拷贝上传的glb渲染结果相同，并输出加载时间
+#include <iostream>
+#include <cstring>
+#include <cstdint>
+#include <cstdio>
+#include <vector>
+#include <string>
+#include <sstream>
+#include <fstream>
+#include <cmath>
+#include <glad/glad.h>
+#include <GLFW/glfw3.h>
+
+#include <glm/glm.hpp>
+#include <glm/gtc/matrix_transform.hpp>
+#include <glm/gtc/type_ptr.hpp>
+
+#include <learnopengl/shader.h>
+#include <learnopengl/camera.h>
+#include <learnopengl/texture.h>
+#include <learnopengl/image_compare.h>
+#include <learnopengl/mesh_import.h>
+
+void framebuffer_size_callback(GLFWwindow* window, int width, int height);
+void mouse_callback(GLFWwindow* window, double xpos, double ypos);
+void scroll_callback(GLFWwindow* window, double xoffset, double yoffset);
+void key_callback(GLFWwindow* window, int key, int scancode, int action, int mods);
+void processInput(GLFWwindow *window);
+
+// 窗口大小
+const unsigned int SCR_WIDTH = 800;
+const unsigned int SCR_HEIGHT = 600;
+
+// camera
+Camera camera(glm::vec3(0.0f, 0.0f, 3.0f));
+
+bool firstMouse = true;
+double lastX = SCR_WIDTH / 2.0;
+double lastY = SCR_HEIGHT / 2.0;
+
+// timing
+float deltaTime = 0.0f;	// time between current frame and last frame
+float lastFrame = 0.0f;
+
+// 画零拷贝上传的glb，而不是导入的网格
+bool drawZeroCopy = false;
+
+// 没有参数时生成的文件
+const char *SPHERE_OBJ = "mesh_import_sphere.obj";
+const char *SPHERE_GLB = "mesh_import_sphere.glb";
+
+// GL中的一个网格，Model 是glb节点的变换（导入的网格已经变换到世界空间）
+struct GpuMesh {
+    unsigned int VAO = 0;
+    std::vector<unsigned int> Buffers;
+    GLenum IndexType = GL_UNSIGNED_INT;
+    GLsizei IndexCount = 0;
+    bool Indexed = true;
+    bool FlipV = false;
+    bool HasNormals = false;
+    glm::mat4 Model = glm::mat4(1.0f);
+};
+
+bool writeSphereObj(const char *path, int rings, int segments);
+std::vector<unsigned char> makeGlb(const std::string &json, const std::vector<unsigned char> &bin);
+bool writeGlb(const char *path, const ImportedMesh &mesh);
+GpuMesh uploadImported(const ImportedMesh &mesh);
+std::vector<GpuMesh> uploadGlb(const GlbFile &glb);
+void drawMeshes(const std::vector<GpuMesh> &meshes, const Shader &shader, const Camera &cam, float aspectRatio);
+void deleteMeshes(std::vector<GpuMesh> &meshes);
+void frameCamera(Camera &cam, const AABB &bounds);
+int validate(const Shader &shader);
+
+int main(int argc, char *argv[])
+{
+    using std::cout;
+    using std::endl;
+
+    bool validateMode = argc > 1 && std::strcmp(argv[1], "--validate") == 0;
+    std::string path = argc > 1 && !validateMode ? argv[1] : "";
+
+    // glfw: 初始化设置
+    // ------------------------------
+    glfwInit();
+    glfwWindowHint(GLFW_CONTEXT_VERSION_MAJOR, 3);
+    glfwWindowHint(GLFW_CONTEXT_VERSION_MINOR, 3);
+    glfwWindowHint(GLFW_OPENGL_PROFILE, GLFW_OPENGL_CORE_PROFILE);
+    if (validateMode)
+        glfwWindowHint(GLFW_VISIBLE, GLFW_FALSE);
+
+    // glfw: 创建窗口
+    // --------------------
+    GLFWwindow* window = glfwCreateWindow(SCR_WIDTH, SCR_HEIGHT, "LearnOpenGL", nullptr, nullptr);
+    if (window == nullptr)
+    {
+        cout << "Failed to create GLFW window" << endl;
+        glfwTerminate();
+        exit(EXIT_FAILURE);
+    }
+    glfwMakeContextCurrent(window);     // 设置OpenGL上下文
+    glfwSetFramebufferSizeCallback(window, framebuffer_size_callback);
+    glfwSetCursorPosCallback(window, mouse_callback);
+    glfwSetScrollCallback(window, scroll_callback);
+    glfwSetKeyCallback(window, key_callback);
+    if (!validateMode)
+        glfwSetInputMode(window, GLFW_CURSOR, GLFW_CURSOR_DISABLED);
+
+    // glad: 加载OpenGL函数指针
+    // ---------------------------------------
+    if (!gladLoadGLLoader((GLADloadproc)glfwGetProcAddress))
+    {
+        cout << "Failed to initialize GLAD" << endl;
+        exit(EXIT_FAILURE);
+    }
+    glEnable(GL_DEPTH_TEST);
+    cout << "renderer: " << glGetString(GL_RENDERER) << endl;
+
+    // 定义编译着色器，纹理和摄像机示例相同
+    Shader shader("mesh_import.vs", "mesh_import.fs");
+    unsigned int textures[2] = {LoadTexture("container.jpg"), LoadTexture("awesomeface.png")};
+    glActiveTexture(GL_TEXTURE0);
+    glBindTexture(GL_TEXTURE_2D, textures[0]);
+    glActiveTexture(GL_TEXTURE1);
+    glBindTexture(GL_TEXTURE_2D, textures[1]);
+    shader.use();
+    shader.setInt("texture1", 0);
+    shader.setInt("texture2", 1);
+
+    if (validateMode) {
+        int failures = validate(shader);
+        glDeleteTextures(2, textures);
+        glfwTerminate();
+        return failures == 0 ? EXIT_SUCCESS : EXIT_FAILURE;
+    }
+
+    // 没有参数时生成球面，OBJ导入，glb零拷贝
+    std::string glbPath;
+    if (path.empty()) {
+        ImportedMesh sphere;
+        MeshImporter importer;
+        if (!writeSphereObj(SPHERE_OBJ, 256, 512) || !importer.LoadObj(SPHERE_OBJ, sphere) || !writeGlb(SPHERE_GLB, sphere)) {
+            cout << "Failed to generate " << SPHERE_OBJ << " / " << SPHERE_GLB << endl;
+            glfwTerminate();
+            return EXIT_FAILURE;
+        }
+        path = SPHERE_OBJ;
+        glbPath = SPHERE_GLB;
+    } else if (path.size() > 4 && (path.substr(path.size() - 4) == ".glb" || path.substr(path.size() - 4) == ".GLB"))
+        glbPath = path;
+
+    MeshImporter importer;
+    ImportedMesh mesh;
+    if (!importer.Load(path.c_str(), mesh)) {
+        cout << "Failed to load " << path << ": " << importer.Error() << endl;
+        glfwTerminate();
+        return EXIT_FAILURE;
+    }
+    const MeshImportStats &stats = importer.Stats();
+    cout << path << ": " << stats.Bytes / (1024.0 * 1024.0) << " MB in " << stats.TotalMs << " ms (map " << stats.MapMs
+         << ", parse " << stats.ParseMs << ", merge " << stats.MergeMs << ", " << stats.Threads << " threads), "
+         << mesh.Vertices.size() << " vertices, " << mesh.TriangleCount() << " triangles" << endl;
+    std::vector<GpuMesh> imported(1, uploadImported(mesh));
+    GlbFile glb;
+    std::vector<GpuMesh> zeroCopy;
+    if (!glbPath.empty() && glb.Open(glbPath.c_str()))
+        zeroCopy = uploadGlb(glb);
+    frameCamera(camera, mesh.Bounds);
+    std::string info = std::to_string(stats.TotalMs) + " ms, " + std::to_string(mesh.Vertices.size()) + " vertices, " +
+                       std::to_string(mesh.TriangleCount()) + " triangles";
+
+    // 渲染循环
+    // -----------
+    float titleTimer = 1.0f;
+    while (!glfwWindowShouldClose(window))
+    {
+        float currentFrame = glfwGetTime();
+        deltaTime = currentFrame - lastFrame;
+        lastFrame = currentFrame;
+
+        processInput(window);
+
+        int width, height;
+        glfwGetFramebufferSize(window, &width, &height);
+        if (width == 0 || height == 0) {
+            glfwPollEvents();
+            continue;
+        }
+        glClearColor(0.2f, 0.3f, 0.3f, 1.0f);
+        glClear(GL_COLOR_BUFFER_BIT | GL_DEPTH_BUFFER_BIT);
+        bool useZeroCopy = drawZeroCopy && !zeroCopy.empty();
+        drawMeshes(useZeroCopy ? zeroCopy : imported, shader, camera, (float) width / (float) height);
+
+        titleTimer += deltaTime;
+        if (titleTimer > 0.5f) {
+            titleTimer = 0.0f;
+            std::string title = std::string("Mesh Import - ") + (useZeroCopy ? "glb zero-copy" : "imported") + " - " + info;
+            glfwSetWindowTitle(window, title.c_str());
+        }
+
+        // glfw: 交换颜色缓冲，检测事件
+        // -------------------------------------------------------------------------------
+        glfwSwapBuffers(window);
+        glfwPollEvents();
+    }
+
+    deleteMeshes(imported);
+    deleteMeshes(zeroCopy);
+    glDeleteTextures(2, textures);
+    glfwTerminate();
+    return 0;
+}
+
+// 经纬度细分的单位球面，rings x segments 个四边形面；每行最后一列的位置和法线回绕到第一列，纹理坐标是 u = 1
+// ---------------------------------------------------------------------------------------------------------
+bool writeSphereObj(const char *path, int rings, int segments)
+{
+    FILE *file = std::fopen(path, "wb");
+    if (!file)
+        return false;
+    const double PI = 3.14159265358979323846;
+    for (int r = 0; r <= rings; r++) {
+        double theta = PI * r / rings;
+        for (int s = 0; s < segments; s++) {
+            double phi = 2.0 * PI * s / segments;
+            double x = std::sin(theta) * std::cos(phi), y = std::cos(theta), z = -std::sin(theta) * std::sin(phi);
+            std::fprintf(file, "v %.6f %.6f %.6f\nvn %.6f %.6f %.6f\n", x, y, z, x, y, z);
+        }
+        for (int s = 0; s <= segments; s++)
+            std::fprintf(file, "vt %.6f %.6f\n", 4.0 * s / segments, 2.0 - 2.0 * r / rings);
+    }
+    for (int r = 0; r < rings; r++) {
+        for (int s = 0; s < segments; s++) {
+            int p[4] = {r * segments + s + 1, (r + 1) * segments + s + 1, (r + 1) * segments + (s + 1) % segments + 1, r * segments + (s + 1) % segments + 1};
+            int t[4] = {r * (segments + 1) + s + 1, (r + 1) * (segments + 1) + s + 1, (r + 1) * (segments + 1) + s + 2, r * (segments + 1) + s + 2};
+            std::fprintf(file, "f %d/%d/%d %d/%d/%d %d/%d/%d %d/%d/%d\n", p[0], t[0], p[0], p[1], t[1], p[1], p[2], t[2], p[2], p[3], t[3], p[3]);
+        }
+    }
+    return std::fclose(file) == 0;
+}
+
+// glb文件的内容：12字节的文件头，JSON块（用空格补齐到4字节），BIN块（用0补齐）
+// ---------------------------------------------------------------------------------------------------------
+std::vector<unsigned char> makeGlb(const std::string &json, const std::vector<unsigned char> &bin)
+{
+    std::string text = json;
+    text.resize((text.size() + 3) & ~(size_t) 3, ' ');
+    size_t binSize = (bin.size() + 3) & ~(size_t) 3;
+    uint32_t header[5] = {0x46546C67, 2, (uint32_t) (12 + 8 + text.size() + 8 + binSize), (uint32_t) text.size(), 0x4E4F534A};
+    uint32_t binHeader[2] = {(uint32_t) binSize, 0x004E4942};
+    std::vector<unsigned char> glb(sizeof(header) + text.size() + sizeof(binHeader) + binSize, 0);
+    unsigned char *p = glb.data();
+    std::memcpy(p, header, sizeof(header));
+    std::memcpy(p += sizeof(header), text.data(), text.size());
+    std::memcpy(p += text.size(), binHeader, sizeof(binHeader));
+    if (!bin.empty())
+        std::memcpy(p + sizeof(binHeader), bin.data(), bin.size());
+    return glb;
+}
+
+// 导入的网格写成glb：交错的顶点（步长32字节）和32位索引，纹理坐标按glTF的习惯翻转v
+// ---------------------------------------------------------------------------------------------------------
+bool writeGlb(const char *path, const ImportedMesh &mesh)
+{
+    size_t vertexBytes = mesh.Vertices.size() * sizeof(MeshVertex), indexBytes = mesh.Indices.size() * sizeof(unsigned int);
+    std::vector<unsigned char> bin(vertexBytes + indexBytes);
+    std::vector<MeshVertex> vertices = mesh.Vertices;
+    for (MeshVertex &vertex : vertices)
+        vertex.TexCoords.y = 1.0f - vertex.TexCoords.y;
+    std::memcpy(bin.data(), vertices.data(), vertexBytes);
+    std::memcpy(bin.data() + vertexBytes, mesh.Indices.data(), indexBytes);
+    std::ostringstream json;
+    json << "{\"asset\":{\"version\":\"2.0\"},\"scene\":0,\"scenes\":[{\"nodes\":[0]}],\"nodes\":[{\"mesh\":0}],"
+         << "\"meshes\":[{\"primitives\":[{\"attributes\":{\"POSITION\":0,\"NORMAL\":1,\"TEXCOORD_0\":2},\"indices\":3}]}],"
+         << "\"buffers\":[{\"byteLength\":" << bin.size() << "}],"
+         << "\"bufferViews\":[{\"buffer\":0,\"byteLength\":" << vertexBytes << ",\"byteStride\":32},"
+         << "{\"buffer\":0,\"byteOffset\":" << vertexBytes << ",\"byteLength\":" << indexBytes << "}],\"accessors\":["
+         << "{\"bufferView\":0,\"componentType\":5126,\"count\":" << vertices.size() << ",\"type\":\"VEC3\"},"
+         << "{\"bufferView\":0,\"byteOffset\":12,\"componentType\":5126,\"count\":" << vertices.size() << ",\"type\":\"VEC3\"},"
+         << "{\"bufferView\":0,\"byteOffset\":24,\"componentType\":5126,\"count\":" << vertices.size() << ",\"type\":\"VEC2\"},"
+         << "{\"bufferView\":1,\"componentType\":5125,\"count\":" << mesh.Indices.size() << ",\"type\":\"SCALAR\"}]}";
+    std::vector<unsigned char> glb = makeGlb(json.str(), bin);
+    std::ofstream out(path, std::ios::binary);
+    out.write(reinterpret_cast<const char *>(glb.data()), (std::streamsize) glb.size());
+    return (bool) out;
+}
+
+// 导入的网格：一个交错的顶点缓冲和一个索引缓冲
+// ---------------------------------------------------------------------------------------------------------
+GpuMesh uploadImported(const ImportedMesh &mesh)
+{
+    GpuMesh gpu;
+    gpu.Buffers.resize(2);
+    gpu.IndexCount = (GLsizei) mesh.Indices.size();
+    gpu.HasNormals = mesh.HasNormals;
+    glGenVertexArrays(1, &gpu.VAO);
+    glGenBuffers(2, gpu.Buffers.data());
+    glBindVertexArray(gpu.VAO);
+    glBindBuffer(GL_ARRAY_BUFFER, gpu.Buffers[0]);
+    glBufferData(GL_ARRAY_BUFFER, mesh.Vertices.size() * sizeof(MeshVertex), mesh.Vertices.data(), GL_STATIC_DRAW);
+    glBindBuffer(GL_ELEMENT_ARRAY_BUFFER, gpu.Buffers[1]);
+    glBufferData(GL_ELEMENT_ARRAY_BUFFER, mesh.Indices.size() * sizeof(unsigned int), mesh.Indices.data(), GL_STATIC_DRAW);
+    glVertexAttribPointer(0, 3, GL_FLOAT, GL_FALSE, sizeof(MeshVertex), (void *) offsetof(MeshVertex, Position));
+    glEnableVertexAttribArray(0);
+    glVertexAttribPointer(1, 3, GL_FLOAT, GL_FALSE, sizeof(MeshVertex), (void *) offsetof(MeshVertex, Normal));
+    glEnableVertexAttribArray(1);
+    glVertexAttribPointer(2, 2, GL_FLOAT, GL_FALSE, sizeof(MeshVertex), (void *) offsetof(MeshVertex, TexCoords));
+    glEnableVertexAttribArray(2);
+    glBindVertexArray(0);
+    return gpu;
+}
+
+// glb的每个图元：每个访问器覆盖的字节范围直接从映射的文件上传，类型、步长、归一化都用文件中的值
+// ---------------------------------------------------------------------------------------------------------
+std::vector<GpuMesh> uploadGlb(const GlbFile &glb)
+{
+    std::vector<GpuMesh> meshes;
+    for (const GlbPrimitive &primitive : glb.Primitives()) {
+        GpuMesh gpu;
+        gpu.Model = primitive.Model;
+        gpu.FlipV = true;
+        gpu.HasNormals = primitive.Normals.Valid();
+        glGenVertexArrays(1, &gpu.VAO);
+        glBindVertexArray(gpu.VAO);
+        auto upload = [&gpu](GLenum target, const GlbAccessor &accessor) {
+            unsigned int buffer;
+            glGenBuffers(1, &buffer);
+            gpu.Buffers.push_back(buffer);
+            glBindBuffer(target, buffer);
+            size_t bytes = accessor.Count == 0 ? 0 : (accessor.Count - 1) * accessor.Stride + accessor.ElementSize();
+            glBufferData(target, (GLsizeiptr) bytes, accessor.Data, GL_STATIC_DRAW);
+        };
+        const GlbAccessor *attributes[3] = {&primitive.Positions, &primitive.Normals, &primitive.TexCoords};
+        for (GLuint location = 0; location < 3; location++) {
+            const GlbAccessor &accessor = *attributes[location];
+            if (!accessor.Valid())
+                continue;
+            upload(GL_ARRAY_BUFFER, accessor);
+            glVertexAttribPointer(location, (GLint) accessor.Components, accessor.ComponentType, accessor.Normalized ? GL_TRUE : GL_FALSE,
+                                  (GLsizei) accessor.Stride, nullptr);
+            glEnableVertexAttribArray(location);
+        }
+        // 索引缓冲要紧密排列；没有索引时按顺序画
+        if (primitive.Indices.Valid() && primitive.Indices.Packed()) {
+            upload(GL_ELEMENT_ARRAY_BUFFER, primitive.Indices);
+            gpu.IndexType = primitive.Indices.ComponentType;
+            gpu.IndexCount = (GLsizei) primitive.Indices.Count;
+        } else {
+            gpu.Indexed = false;
+            gpu.IndexCount = (GLsizei) primitive.Positions.Count;
+        }
+        glBindVertexArray(0);
+        meshes.push_back(gpu);
+    }
+    return meshes;
+}
+
+void drawMeshes(const std::vector<GpuMesh> &meshes, const Shader &shader, const Camera &cam, float aspectRatio)
+{
+    shader.use();
+    shader.setMat4("projection", cam.GetProjectionMatrix(aspectRatio));
+    shader.setMat4("view", cam.GetViewMatrix());
+    for (const GpuMesh &mesh : meshes) {
+        shader.setMat4("model", mesh.Model);
+        shader.setBool("flipV", mesh.FlipV);
+        shader.setBool("hasNormals", mesh.HasNormals);
+        glBindVertexArray(mesh.VAO);
+        if (mesh.Indexed)
+            glDrawElements(GL_TRIANGLES, mesh.IndexCount, mesh.IndexType, nullptr);
+        else
+            glDrawArrays(GL_TRIANGLES, 0, mesh.IndexCount);
+    }
+    glBindVertexArray(0);
+}
+
+void deleteMeshes(std::vector<GpuMesh> &meshes)
+{
+    for (GpuMesh &mesh : meshes) {
+        glDeleteVertexArrays(1, &mesh.VAO);
+        glDeleteBuffers((GLsizei) mesh.Buffers.size(), mesh.Buffers.data());
+    }
+    meshes.clear();
+}
+
+// 摄像机放在包围盒前方，移动速度、远近平面按网格的大小调整
+// ---------------------------------------------------------------------------------------------------------
+void frameCamera(Camera &cam, const AABB &bounds)
+{
+    float radius = std::max(glm::length(bounds.Extents()), 1e-3f);
+    cam.Position = bounds.Center() + glm::vec3(0.0f, 0.0f, radius * 2.5f);
+    cam.Yaw = -90.0f;
+    cam.Pitch = 0.0f;
+    cam.MovementSpeed = radius;
+    cam.NearPlane = radius * 0.01f;
+    cam.FarPlane = radius * 10.0f;
+}
+
+// 1. OBJ解析：注释、CRLF、制表符、忽略的行、多余的分量、指数、四边形、负索引、缺少纹理坐标或法线的面，
+//    检查顶点数、索引和几个顶点的值；1字节的块、3个线程的结果必须和整个文件一个块的结果相同
+// 2. 出错时的行号
+// 3. glb：节点层级（父节点平移、子节点缩放），16位索引，展开后的位置；截断的文件和损坏的访问器、节点下标要报错
+// 4. 生成的球面：OBJ导入后渲染，和写成glb后零拷贝上传的渲染结果比较，并输出加载时间
+// ---------------------------------------------------------------------------------------------------------
+int validate(const Shader &shader)
+{
+    using std::cout;
+    using std::endl;
+    int failures = 0;
+    auto check = [&failures](bool ok) {
+        cout << (ok ? "OK" : "FAILED") << endl;
+        if (!ok)
+            failures++;
+    };
+
+    // 1. OBJ解析
+    {
+        const char *obj =
+                "# comment\r\nmtllib test.mtl\r\no quad\r\n"
+                "v 0 0 0\r\nv 1 0 0 1.0\r\nv 1 1 0 0.5 0.5 0.5\r\nv\t0 1 0\r\n"
+                "vt 0 0\r\nvt 1 0\r\nvt 1 1\r\nvt 0 1 0\r\nvn 0 0 1\r\n"
+                "g group\r\nusemtl material\r\ns off\r\n"
+                "f 1/1/1 2/2/1 3/3/1 4/4/1\r\n"
+                "v 2e0 0 0\nv 2 1.E0 -0\n"
+                "f -5/-3/-1 -2/-2/-1 -1/-1/-1\n"
+                "f 2//1 5//1 6//1 # comment\n"
+                "f 1 2 3";
+        const unsigned int expectedIndices[] = {0, 1, 2, 0, 2, 3, 1, 4, 5, 6, 7, 8, 9, 10, 11};
+        MeshImporter importer;
+        ImportedMesh mesh, other;
+        bool ok = importer.ParseObj(obj, std::strlen(obj), mesh) && mesh.Vertices.size() == 12 && mesh.HasNormals && mesh.HasTexCoords &&
+                  mesh.Indices == std::vector<unsigned int>(expectedIndices, expectedIndices + 15) &&
+                  mesh.Vertices[3].Position == glm::vec3(0.0f, 1.0f, 0.0f) && mesh.Vertices[3].TexCoords == glm::vec2(0.0f, 1.0f) &&
+                  mesh.Vertices[4].Position == glm::vec3(2.0f, 0.0f, 0.0f) && mesh.Vertices[4].TexCoords == glm::vec2(1.0f, 1.0f) &&
+                  mesh.Vertices[4].Normal == glm::vec3(0.0f, 0.0f, 1.0f) && mesh.Vertices[6].TexCoords == glm::vec2(0.0f) &&
+                  mesh.Vertices[9].Normal == glm::vec3(0.0f) && mesh.Bounds.Max == glm::vec3(2.0f, 1.0f, 0.0f);
+        if (!ok)
+            cout << importer.Error() << endl;
+        importer.ChunkSize = 1;
+        importer.Threads = 3;
+        bool chunked = importer.ParseObj(obj, std::strlen(obj), other) && importer.Stats().Chunks > 10 &&
+                       other.Indices == mesh.Indices && other.Vertices.size() == mesh.Vertices.size() &&
+                       std::memcmp(other.Vertices.data(), mesh.Vertices.data(), mesh.Vertices.size() * sizeof(MeshVertex)) == 0;
+        cout << "obj parsing: " << mesh.Vertices.size() << " vertices, " << mesh.TriangleCount() << " triangles; "
+             << importer.Stats().Chunks << " chunks on 3 threads give the same result ";
+        check(ok && chunked);
+    }
+
+    // 2. 出错时的行号
+    {
+        MeshImporter importer;
+        ImportedMesh mesh;
+        const char *badNumber = "v 0 0 0\nv 1 0\nf 1 2 1\n";
+        const char *badIndex = "v 0 0 0\nv 1 0 0\nf 1 2 3\n";
+        bool ok = !importer.ParseObj(badNumber, std::strlen(badNumber), mesh) && importer.Error().find("line 2") == 0;
+        cout << "obj errors: \"" << importer.Error() << "\", ";
+        ok = ok && !importer.ParseObj(badIndex, std::strlen(badIndex), mesh) && mesh.Vertices.empty() && importer.Error().find("line 3") == 0;
+        cout << "\"" << importer.Error() << "\" ";
+        check(ok);
+
+        // 相对的纹理坐标、法线索引指到第一个元素之前（结果是-1，不能当成“没有”），
+        // 出错的面在一个大块的中间、或者分成很多小块时，行号都是面所在的行
+        const char *corrupted[][2] = {{"v 0 0 0\nv 1 0 0\nv 0 1 0\nf 1/-1 2/-1 3/-1\n", "line 4:"},
+                                      {"v 0 0 0\nv 1 0 0\nv 0 1 0\nvt 0 0\nf 1/-2 2/-2 3/-2\n", "line 5:"},
+                                      {"v 0 0 0\nv 1 0 0\nv 0 1 0\nvn 0 0 1\nf 1//-1 2//-1 3//-2\n", "line 5:"}};
+        unsigned int rejected = 0;
+        for (const auto &test : corrupted)
+            if (!importer.ParseObj(test[0], std::strlen(test[0]), mesh) && importer.Error().find(test[1]) == 0)
+                rejected++;
+        std::string big = "v 0 0 0\nv 1 0 0\nv 0 1 0\nvt 0 0\n";
+        for (int i = 0; i < 200; i++)
+            big += "f 1/1 2/1 3/1\n";
+        big += "f 1/1 2/-2 3/1\n";
+        for (int i = 0; i < 200; i++)
+            big += "f 1/1 2/1 3/1\n";
+        bool lines = true;
+        for (size_t chunkSize : {size_t(1) << 20, size_t(64)}) {
+            MeshImporter chunked;
+            chunked.ChunkSize = chunkSize;
+            chunked.Threads = 3;
+            lines = lines && !chunked.ParseObj(big.data(), big.size(), mesh) && chunked.Error().find("line 205:") == 0;
+        }
+        cout << "obj: " << rejected << " of 3 faces with relative indices before the first element rejected, "
+             << "out-of-range face reported on its own line in 1 and " << (big.size() + 63) / 64 << " chunks ";
+        check(rejected == 3 && lines);
+    }
+
+    // 3. glb的节点层级：父节点平移 (10, 0, 0)，子节点缩放2倍，一个三角形，16位索引（补齐到4字节）
+    {
+        const float positions[9] = {0.0f, 0.0f, 0.0f, 1.0f, 0.0f, 0.0f, 0.0f, 1.0f, 0.0f};
+        const uint16_t indices[3] = {0, 1, 2};
+        std::vector<unsigned char> bin(sizeof(positions) + 8, 0);
+        std::memcpy(bin.data(), positions, sizeof(positions));
+        std::memcpy(bin.data() + sizeof(positions), indices, sizeof(indices));
+        std::string json =
+                "{\"asset\":{\"version\":\"2.0\"},\"scene\":0,\"scenes\":[{\"nodes\":[0]}],"
+                "\"nodes\":[{\"translation\":[10,0,0],\"children\":[1]},{\"scale\":[2,2,2],\"mesh\":0}],"
+                "\"meshes\":[{\"primitives\":[{\"attributes\":{\"POSITION\":0},\"indices\":1}]}],"
+                "\"buffers\":[{\"byteLength\":44}],"
+                "\"bufferViews\":[{\"buffer\":0,\"byteOffset\":0,\"byteLength\":36},{\"buffer\":0,\"byteOffset\":36,\"byteLength\":6}],"
+                "\"accessors\":[{\"bufferView\":0,\"componentType\":5126,\"count\":3,\"type\":\"VEC3\"},"
+                "{\"bufferView\":1,\"componentType\":5123,\"count\":3,\"type\":\"SCALAR\"}]}";
+        std::vector<unsigned char> data = makeGlb(json, bin);
+        GlbFile glb;
+        MeshImporter importer;
+        ImportedMesh mesh;
+        bool ok = glb.Parse(data.data(), data.size()) && glb.Primitives().size() == 1 && glb.Primitives()[0].Indices.ComponentType == GL_UNSIGNED_SHORT &&
+                  glb.Primitives()[0].Positions.Data == data.data() + 20 + (json.size() + 3) / 4 * 4 + 8 &&
+                  importer.Flatten(glb, mesh) && mesh.Vertices.size() == 3 && mesh.Indices == std::vector<unsigned int>({0, 1, 2}) &&
+                  mesh.Vertices[1].Position == glm::vec3(12.0f, 0.0f, 0.0f) && mesh.Vertices[2].Position == glm::vec3(10.0f, 2.0f, 0.0f) &&
+                  !mesh.HasNormals && !mesh.HasTexCoords;
+        // 截断的文件要报错而不是越界读取
+        GlbFile truncated;
+        bool rejected = !truncated.Parse(data.data(), data.size() - 8);
+        cout << "glb: node hierarchy, 16-bit indices, accessors point into the file; truncated file rejected ("
+             << truncated.Error() << ") ";
+        check(ok && rejected);
+
+        // 损坏的数量、偏移和下标：2^62个元素时末尾的偏移 2^62 * 12 在64位下回绕成0；负数、小数、超过252的步长，
+        // 越过视图的偏移，负的子节点和小数的网格编号都要报错
+        const char *malformed[][2] = {
+                {"\"count\":3,\"type\":\"VEC3\"", "\"count\":4611686018427387904,\"type\":\"VEC3\""},
+                {"\"count\":3,\"type\":\"VEC3\"", "\"count\":-3,\"type\":\"VEC3\""},
+                {"\"bufferView\":0,", "\"bufferView\":0.5,"},
+                {"\"byteLength\":36}", "\"byteLength\":36,\"byteStride\":256}"},
+                {"\"bufferView\":0,", "\"bufferView\":0,\"byteOffset\":40,"},
+                {"\"byteOffset\":36,", "\"byteOffset\":-8,"},
+                {"\"children\":[1]", "\"children\":[-1]"},
+                {"\"mesh\":0", "\"mesh\":0.5"}};
+        unsigned int accepted = 0;
+        for (const auto &edit : malformed) {
+            std::string bad = json;
+            bad.replace(bad.find(edit[0]), std::strlen(edit[0]), edit[1]);
+            std::vector<unsigned char> badData = makeGlb(bad, bin);
+            GlbFile badGlb;
+            if (badGlb.Parse(badData.data(), badData.size())) {
+                cout << "accepted: " << edit[1] << endl;
+                accepted++;
+            }
+        }
+        cout << "glb: " << sizeof(malformed) / sizeof(malformed[0]) - accepted << " of " << sizeof(malformed) / sizeof(malformed[0])
+             << " malformed accessors and node indices rejected ";
+        check(accepted == 0);
+    }
+
+    // 4. 球面：OBJ导入 vs glb零拷贝，渲染结果相同
+    {
+        const int width = SCR_WIDTH, height = SCR_HEIGHT;
+        unsigned int FBO, colorBuffer, depthBuffer;
+        glGenFramebuffers(1, &FBO);
+        glBindFramebuffer(GL_FRAMEBUFFER, FBO);
+        glGenRenderbuffers(1, &colorBuffer);
+        glBindRenderbuffer(GL_RENDERBUFFER, colorBuffer);
+        glRenderbufferStorage(GL_RENDERBUFFER, GL_RGBA8, width, height);
+        glFramebufferRenderbuffer(GL_FRAMEBUFFER, GL_COLOR_ATTACHMENT0, GL_RENDERBUFFER, colorBuffer);
+        glGenRenderbuffers(1, &depthBuffer);
+        glBindRenderbuffer(GL_RENDERBUFFER, depthBuffer);
+        glRenderbufferStorage(GL_RENDERBUFFER, GL_DEPTH24_STENCIL8, width, height);
+        glFramebufferRenderbuffer(GL_FRAMEBUFFER, GL_DEPTH_STENCIL_ATTACHMENT, GL_RENDERBUFFER, depthBuffer);
+        glViewport(0, 0, width, height);
+
+        MeshImporter importer;
+        ImportedMesh mesh;
+        GlbFile glb;
+        bool ok = writeSphereObj(SPHERE_OBJ, 128, 256) && importer.LoadObj(SPHERE_OBJ, mesh);
+        const MeshImportStats &stats = importer.Stats();
+        cout << "sphere obj: " << stats.Bytes / 1024 << " KB in " << stats.TotalMs << " ms (parse " << stats.ParseMs << ", merge "
+             << stats.MergeMs << "), " << stats.Corners << " corners -> " << mesh.Vertices.size() << " vertices; ";
+        ok = ok && mesh.Vertices.size() == 129 * 256 + 129 && writeGlb(SPHERE_GLB, mesh) && glb.Open(SPHERE_GLB);
+
+        Camera cam(glm::vec3(0.0f), glm::vec3(0.0f, 1.0f, 0.0f), -90.0f, 0.0f);
+        frameCamera(cam, mesh.Bounds);
+        cam.Position += glm::vec3(0.8f, 0.6f, 0.0f);
+        std::vector<unsigned char> pixels[2];
+        std::vector<GpuMesh> meshes[2];
+        if (ok) {
+            meshes[0].push_back(uploadImported(mesh));
+            meshes[1] = uploadGlb(glb);
+        }
+        for (int i = 0; i < 2; i++) {
+            glClearColor(0.2f, 0.3f, 0.3f, 1.0f);
+            glClear(GL_COLOR_BUFFER_BIT | GL_DEPTH_BUFFER_BIT);
+            drawMeshes(meshes[i], shader, cam, (float) width / (float) height);
+            pixels[i].resize((size_t) width * height * 4);
+            glReadPixels(0, 0, width, height, GL_RGBA, GL_UNSIGNED_BYTE, pixels[i].data());
+            deleteMeshes(meshes[i]);
+        }
+        // 纹理坐标翻转了两次（CPU写glb时、着色器中），可能差一点舍入
+        ImageDifference diff = CompareImages(pixels[0].data(), pixels[1].data(), width, height, 8);
+        ok = ok && diff.Ssim > 0.999 && diff.DiffFraction < 0.001;
+        cout << "imported vs glb zero-copy: SSIM " << diff.Ssim << ", max diff " << diff.MaxDiff << " ";
+        check(ok);
+        std::remove(SPHERE_OBJ);
+        std::remove(SPHERE_GLB);
+
+        glBindFramebuffer(GL_FRAMEBUFFER, 0);
+        glDeleteFramebuffers(1, &FBO);
+        glDeleteRenderbuffers(1, &colorBuffer);
+        glDeleteRenderbuffers(1, &depthBuffer);
+    }
+
+    cout << (failures == 0 ? "mesh import OK" : "mesh import FAILED") << endl;
+    return failures;
+}
+
+// process all input: query GLFW whether relevant keys are pressed/released this frame and react accordingly
+// ---------------------------------------------------------------------------------------------------------
+void processInput(GLFWwindow *window)
+{
+    if (glfwGetKey(window, GLFW_KEY_ESCAPE) == GLFW_PRESS)
+        glfwSetWindowShouldClose(window, true);
+
+    if (glfwGetKey(window, GLFW_KEY_W) == GLFW_PRESS)
+        camera.ProcessKeyboard(FORWARD, deltaTime);
+    if (glfwGetKey(window, GLFW_KEY_S) == GLFW_PRESS)
+        camera.ProcessKeyboard(BACKWARD, deltaTime);
+    if (glfwGetKey(window, GLFW_KEY_A) == GLFW_PRESS)
+        camera.ProcessKeyboard(LEFT, deltaTime);
+    if (glfwGetKey(window, GLFW_KEY_D) == GLFW_PRESS)
+        camera.ProcessKeyboard(RIGHT, deltaTime);
+}
+
+// 按键事件：G切换导入的网格和零拷贝的glb
+// ---------------------------------------------------------------------------------------------------------
+void key_callback(GLFWwindow* window, int key, int scancode, int action, int mods)
+{
+    if (action == GLFW_PRESS && key == GLFW_KEY_G)
+        drawZeroCopy = !drawZeroCopy;
+}
+
+// glfw: whenever the window size changed (by OS or user resize) this callback function executes
+// ---------------------------------------------------------------------------------------------
+void framebuffer_size_callback(GLFWwindow* window, int width, int height)
+{
+    glViewport(0, 0, width, height);
+}
+
+void mouse_callback(GLFWwindow* window, double xpos, double ypos) {
+    if (firstMouse) {
+        lastX = xpos;
+        lastY = ypos;
+        firstMouse = false;
+    }
+    float xoffset = xpos - lastX;
+    float yoffset = lastY - ypos;
+    lastX = xpos;
+    lastY = ypos;
+
+    camera.ProcessMouseMovement(xoffset, yoffset);
+}
+
+void scroll_callback(GLFWwindow* window, double xoffset, double yoffset)
+{
+    camera.ProcessMouseScroll(yoffset);
+}
@@ -0,0 +1,20 @@
+#version 330 core
+out vec4 FragColor;
+
+in vec3 Normal;
+in vec2 TexCoord;
+
+uniform sampler2D texture1;
+uniform sampler2D texture2;
+// 没有法线的网格只显示纹理
+uniform bool hasNormals;
+
+void main() {
+	vec4 color = mix(texture(texture1, TexCoord), texture(texture2, TexCoord), 0.2f);
+	if (hasNormals) {
+		// 固定方向的光，加一点环境光
+		float diffuse = max(dot(normalize(Normal), normalize(vec3(0.4f, 1.0f, 0.6f))), 0.0f);
+		color.rgb *= 0.25f + 0.75f * diffuse;
+	}
+	FragColor = color;
+}
@@ -0,0 +1,19 @@
+#version 330 core
+layout (location = 0) in vec3 aPos;
+layout (location = 1) in vec3 aNormal;
+layout (location = 2) in vec2 aTexCoord;
+
+out vec3 Normal;
+out vec2 TexCoord;
+
+uniform mat4 model;
+uniform mat4 view;
+uniform mat4 projection;
+// glTF的纹理坐标原点在左上角，直接使用文件中的数据时在这里翻转
+uniform bool flipV;
+
+void main() {
+	gl_Position = projection * view * model * vec4(aPos, 1.0f);
+	Normal = mat3(model) * aNormal;
+	TexCoord = flipV ? vec2(aTexCoord.x, 1.0f - aTexCoord.y) : aTexCoord;
+}
@@ -0,0 +1,568 @@
+// CPU遮挡剔除示例：城市场景（街区里的楼房 + 街道上的小物体），离摄像机最近的楼房作为遮挡物，
+// 用 MaskedOcclusionCuller 光栅化到低分辨率的掩码缓冲，视锥体内的物体再用包围盒测试，只绘制可能可见的物体
+// 剔除在后台线程上进行：这一帧的剔除和上一帧的 glfwSwapBuffers（等待GPU完成上一帧）同时进行，再等待剔除结果生成绘制列表
+// 按O键开关遮挡剔除，M键切换AVX2和标量路径，T键在单线程和所有线程之间切换，标题栏显示绘制的物体数和剔除耗时
+//
+// 运行参数：
+//   --validate   隐藏窗口，在几个摄像机位置上用 GL_ANY_SAMPLES_PASSED 查询每个物体在完整深度缓冲上是否真的被挡住，
+//                被剔除的物体必须都被挡住；检查AVX2和标量、单线程和多线程、异步和同步的结果一致，并对比绘制耗时
+#include <iostream>
+#include <cstring>
+#include <vector>
+#include <string>
+#include <chrono>
+#include <cmath>
+#include <algorithm>
+#include <glad/glad.h>
+#include <GLFW/glfw3.h>
+
+#include <glm/glm.hpp>
+#include <glm/gtc/matrix_transform.hpp>
+#include <glm/gtc/type_ptr.hpp>
+
+#include <learnopengl/shader.h>
+#include <learnopengl/camera.h>
+#include <learnopengl/texture.h>
+#include <learnopengl/bounds.h>
+#include <learnopengl/frustum.h>
+#include <learnopengl/occlusion_culling.h>
+
+void framebuffer_size_callback(GLFWwindow* window, int width, int height);
+void mouse_callback(GLFWwindow* window, double xpos, double ypos);
+void scroll_callback(GLFWwindow* window, double xoffset, double yoffset);
+void key_callback(GLFWwindow* window, int key, int scancode, int action, int mods);
+void processInput(GLFWwindow *window);
+
+// 窗口大小
+const unsigned int SCR_WIDTH = 800;
+const unsigned int SCR_HEIGHT = 600;
+
+// 城市：BLOCKS x BLOCKS 个街区，每个街区 LOTS x LOTS 栋楼，楼之间是街道
+const int BLOCKS = 10;
+const int LOTS = 4;
+const float LOT = 10.0f;
+const float STREET = 8.0f;
+const float BLOCK = LOTS * LOT + STREET;
+// 每帧最多使用的遮挡物
+const size_t MAX_OCCLUDERS = 512;
+
+// camera
+Camera camera(glm::vec3(-3.0f, 1.7f, 100.0f));
+
+bool firstMouse = true;
+double lastX = SCR_WIDTH / 2.0;
+double lastY = SCR_HEIGHT / 2.0;
+
+// timing
+float deltaTime = 0.0f;	// time between current frame and last frame
+float lastFrame = 0.0f;
+
+// 剔除选项
+bool occlusionCulling = true;
+bool useSimd = true;
+bool allThreads = true;
+
+int fbWidth = SCR_WIDTH, fbHeight = SCR_HEIGHT;
+
+// 和摄像机示例相同的立方体：位置 + 纹理坐标，用来绘制
+const float cubeVertices[] = {
+        -0.5f, -0.5f, -0.5f,  0.0f, 0.0f,
+         0.5f, -0.5f, -0.5f,  1.0f, 0.0f,
+         0.5f,  0.5f, -0.5f,  1.0f, 1.0f,
+         0.5f,  0.5f, -0.5f,  1.0f, 1.0f,
+        -0.5f,  0.5f, -0.5f,  0.0f, 1.0f,
+        -0.5f, -0.5f, -0.5f,  0.0f, 0.0f,
+
+        -0.5f, -0.5f,  0.5f,  0.0f, 0.0f,
+         0.5f, -0.5f,  0.5f,  1.0f, 0.0f,
+         0.5f,  0.5f,  0.5f,  1.0f, 1.0f,
+         0.5f,  0.5f,  0.5f,  1.0f, 1.0f,
+        -0.5f,  0.5f,  0.5f,  0.0f, 1.0f,
+        -0.5f, -0.5f,  0.5f,  0.0f, 0.0f,
+
+        -0.5f,  0.5f,  0.5f,  1.0f, 0.0f,
+        -0.5f,  0.5f, -0.5f,  1.0f, 1.0f,
+        -0.5f, -0.5f, -0.5f,  0.0f, 1.0f,
+        -0.5f, -0.5f, -0.5f,  0.0f, 1.0f,
+        -0.5f, -0.5f,  0.5f,  0.0f, 0.0f,
+        -0.5f,  0.5f,  0.5f,  1.0f, 0.0f,
+
+         0.5f,  0.5f,  0.5f,  1.0f, 0.0f,
+         0.5f,  0.5f, -0.5f,  1.0f, 1.0f,
+         0.5f, -0.5f, -0.5f,  0.0f, 1.0f,
+         0.5f, -0.5f, -0.5f,  0.0f, 1.0f,
+         0.5f, -0.5f,  0.5f,  0.0f, 0.0f,
+         0.5f,  0.5f,  0.5f,  1.0f, 0.0f,
+
+        -0.5f, -0.5f, -0.5f,  0.0f, 1.0f,
+         0.5f, -0.5f, -0.5f,  1.0f, 1.0f,
+         0.5f, -0.5f,  0.5f,  1.0f, 0.0f,
+         0.5f, -0.5f,  0.5f,  1.0f, 0.0f,
+        -0.5f, -0.5f,  0.5f,  0.0f, 0.0f,
+        -0.5f, -0.5f, -0.5f,  0.0f, 1.0f,
+
+        -0.5f,  0.5f, -0.5f,  0.0f, 1.0f,
+         0.5f,  0.5f, -0.5f,  1.0f, 1.0f,
+         0.5f,  0.5f,  0.5f,  1.0f, 0.0f,
+         0.5f,  0.5f,  0.5f,  1.0f, 0.0f,
+        -0.5f,  0.5f,  0.5f,  0.0f, 0.0f,
+        -0.5f,  0.5f, -0.5f,  0.0f, 1.0f
+};
+
+// 场景中的物体，Building 是遮挡物列表中使用的楼房
+struct CityObject {
+    glm::mat4 Model;
+    AABB Box;
+    bool Building;
+};
+
+// 每帧的剔除输入，CullAsync 在后台线程上读取，Wait 之前不能修改
+struct CullInput {
+    glm::mat4 ViewProjection;
+    std::vector<unsigned int> Candidates;
+    std::vector<Occluder> Occluders;
+};
+
+std::vector<float> makeOccluderBox();
+std::vector<CityObject> makeCity();
+void prepareCull(const std::vector<CityObject> &objects, const std::vector<AABB> &boxes, const std::vector<float> &occluderBox,
+                 const glm::mat4 &viewProjection, const glm::vec3 &eye, CullInput &input);
+void drawObjects(Shader &shader, const std::vector<CityObject> &objects, const std::vector<unsigned int> &list);
+int validate(Shader &shader, const std::vector<CityObject> &objects, const std::vector<AABB> &boxes, const std::vector<float> &occluderBox);
+
+int main(int argc, char *argv[])
+{
+    using std::cout;
+    using std::endl;
+
+    bool validateMode = argc > 1 && std::strcmp(argv[1], "--validate") == 0;
+
+    // glfw: 初始化设置
+    // ------------------------------
+    glfwInit();
+    glfwWindowHint(GLFW_CONTEXT_VERSION_MAJOR, 3);
+    glfwWindowHint(GLFW_CONTEXT_VERSION_MINOR, 3);
+    glfwWindowHint(GLFW_OPENGL_PROFILE, GLFW_OPENGL_CORE_PROFILE);
+    if (validateMode)
+        glfwWindowHint(GLFW_VISIBLE, GLFW_FALSE);
+
+    // glfw: 创建窗口
+    // --------------------
+    GLFWwindow* window = glfwCreateWindow(SCR_WIDTH, SCR_HEIGHT, "LearnOpenGL", nullptr, nullptr);
+    if (window == nullptr)
+    {
+        cout << "Failed to create GLFW window" << endl;
+        glfwTerminate();
+        exit(EXIT_FAILURE);
+    }
+    glfwMakeContextCurrent(window);     // 设置OpenGL上下文
+    glfwSetFramebufferSizeCallback(window, framebuffer_size_callback);
+    glfwSetCursorPosCallback(window, mouse_callback);
+    glfwSetScrollCallback(window, scroll_callback);
+    glfwSetKeyCallback(window, key_callback);
+    if (!validateMode)
+        glfwSetInputMode(window, GLFW_CURSOR, GLFW_CURSOR_DISABLED);
+
+    // glad: 加载OpenGL函数指针
+    // ---------------------------------------
+    if (!gladLoadGLLoader((GLADloadproc)glfwGetProcAddress))
+    {
+        cout << "Failed to initialize GLAD" << endl;
+        exit(EXIT_FAILURE);
+    }
+    glEnable(GL_DEPTH_TEST);
+    camera.FarPlane = 1000.0f;
+    camera.MovementSpeed = 20.0f;
+    glfwGetFramebufferSize(window, &fbWidth, &fbHeight);
+
+    // 定义编译着色器
+    Shader ourShader("6.1.coordinate_systems.vs", "6.1.coordinate_systems.fs");
+
+    // 创建顶点缓冲和顶点数组
+    unsigned int VAO, VBO;
+    glGenVertexArrays(1, &VAO);
+    glGenBuffers(1, &VBO);
+
+    glBindVertexArray(VAO);
+    glBindBuffer(GL_ARRAY_BUFFER, VBO);
+    glBufferData(GL_ARRAY_BUFFER, sizeof(cubeVertices), cubeVertices, GL_STATIC_DRAW);
+
+    // 顶点位置
+    glVertexAttribPointer(0, 3, GL_FLOAT, GL_FALSE, 5 * sizeof(float), (void *)nullptr);
+    glEnableVertexAttribArray(0);
+    // 纹理坐标
+    glVertexAttribPointer(1, 2, GL_FLOAT, GL_FALSE, 5 * sizeof(float), (void *)(3 * sizeof(float)));
+    glEnableVertexAttribArray(1);
+
+    // 创建纹理
+    unsigned int textures[2];
+    const char *texturePaths[2] = {"container.jpg", "awesomeface.png"};
+    for (int i = 0; i < 2; i++)
+        textures[i] = LoadTexture(texturePaths[i]);
+
+    // 激活纹理
+    ourShader.use();
+    ourShader.setInt("texture1", 0);
+    ourShader.setInt("texture2", 1);
+    glActiveTexture(GL_TEXTURE0);
+    glBindTexture(GL_TEXTURE_2D, textures[0]);
+    glActiveTexture(GL_TEXTURE1);
+    glBindTexture(GL_TEXTURE_2D, textures[1]);
+
+    std::vector<CityObject> objects = makeCity();
+    std::vector<AABB> boxes;
+    for (const CityObject &object : objects)
+        boxes.push_back(object.Box);
+    std::vector<float> occluderBox = makeOccluderBox();
+    cout << "Objects: " << objects.size() << endl;
+
+    if (validateMode) {
+        int failures = validate(ourShader, objects, boxes, occluderBox);
+        glDeleteVertexArrays(1, &VAO);
+        glDeleteBuffers(1, &VBO);
+        glDeleteTextures(2, textures);
+        glfwTerminate();
+        return failures == 0 ? EXIT_SUCCESS : EXIT_FAILURE;
+    }
+
+    // 渲染循环
+    // -----------
+    MaskedOcclusionCuller culler(320, 240);
+    CullInput input;
+    std::vector<unsigned int> drawList;
+    bool frameRendered = false;
+    float titleTimer = 0.0f;
+    while (!glfwWindowShouldClose(window))
+    {
+        float currentFrame = glfwGetTime();
+        deltaTime = currentFrame - lastFrame;
+        lastFrame = currentFrame;
+
+        processInput(window);
+
+        if (fbWidth == 0 || fbHeight == 0) {
+            glfwPollEvents();
+            continue;
+        }
+        glm::mat4 projection = camera.GetProjectionMatrix((float)fbWidth / (float)fbHeight);
+        glm::mat4 view = camera.GetViewMatrix();
+
+        // 在后台线程上开始这一帧的剔除
+        prepareCull(objects, boxes, occluderBox, projection * view, camera.Position, input);
+        if (occlusionCulling) {
+            culler.Simd = useSimd;
+            culler.Threads = allThreads ? 0 : 1;
+            culler.CullAsync(input.Occluders, boxes, input.Candidates, input.ViewProjection);
+        }
+
+        // glfw: 交换上一帧的颜色缓冲，检测事件；驱动在这里等待GPU时剔除线程在工作
+        // -------------------------------------------------------------------------------
+        if (frameRendered)
+            glfwSwapBuffers(window);
+        glfwPollEvents();
+
+        // 按键在 glfwPollEvents 中处理，用 Pending 判断这一帧是否开始了剔除
+        drawList = culler.Pending() ? culler.Wait() : input.Candidates;
+
+        glClearColor(0.55f, 0.7f, 0.85f, 1.0f);
+        glClear(GL_COLOR_BUFFER_BIT | GL_DEPTH_BUFFER_BIT);
+        ourShader.use();
+        ourShader.setMat4("projection", projection);
+        ourShader.setMat4("view", view);
+        glBindVertexArray(VAO);
+        drawObjects(ourShader, objects, drawList);
+        frameRendered = true;
+
+        titleTimer += deltaTime;
+        if (titleTimer > 0.5f) {
+            titleTimer = 0.0f;
+            std::string title = "Occlusion Culling - " + std::to_string(drawList.size()) + " / " +
+                                std::to_string(input.Candidates.size()) + " drawn";
+            if (occlusionCulling) {
+                const OcclusionCullingStats &stats = culler.Stats();
+                title += std::string(useSimd && MaskedOcclusionCuller::HasAvx2() ? " - AVX2" : " - scalar") +
+                         (allThreads ? " MT" : " 1T") + " - raster " + std::to_string(stats.RasterMs) +
+                         " ms, test " + std::to_string(stats.TestMs) + " ms";
+            } else
+                title += " - occlusion culling off";
+            title += " - " + std::to_string(deltaTime * 1000.0f) + " ms";
+            glfwSetWindowTitle(window, title.c_str());
+        }
+    }
+    culler.Wait();
+
+    glDeleteVertexArrays(1, &VAO);
+    glDeleteBuffers(1, &VBO);
+    glDeleteTextures(2, textures);
+
+    glfwTerminate();
+    return 0;
+}
+
+// 以原点为中心的单位立方体，12个逆时针的三角形，只有位置；绘制用的立方体各个面的绕向不一致，不能直接做背面剔除
+std::vector<float> makeOccluderBox()
+{
+    std::vector<float> vertices;
+    for (int axis = 0; axis < 3; axis++) {
+        for (int side = -1; side <= 1; side += 2) {
+            // 面上的两个切向量，叉积朝外
+            glm::vec3 n(0.0f), u(0.0f), v(0.0f);
+            n[axis] = (float) side;
+            u[(axis + 1) % 3] = 1.0f;
+            v[(axis + 2) % 3] = (float) side;
+            glm::vec3 c[4] = {0.5f * (n - u - v), 0.5f * (n + u - v), 0.5f * (n + u + v), 0.5f * (n - u + v)};
+            const int order[6] = {0, 1, 2, 2, 3, 0};
+            for (int k : order)
+                vertices.insert(vertices.end(), {c[k].x, c[k].y, c[k].z});
+        }
+    }
+    return vertices;
+}
+
+// 可重复的伪随机数
+float random01(unsigned int &state)
+{
+    state = state * 1664525u + 1013904223u;
+    return (float) (state >> 8) / 16777216.0f;
+}
+
+std::vector<CityObject> makeCity()
+{
+    std::vector<CityObject> objects;
+    unsigned int seed = 12345u;
+    for (int bz = 0; bz < BLOCKS; bz++) {
+        for (int bx = 0; bx < BLOCKS; bx++) {
+            glm::vec3 origin(bx * BLOCK - BLOCKS * BLOCK * 0.5f, 0.0f, bz * BLOCK - BLOCKS * BLOCK * 0.5f);
+            for (int lz = 0; lz < LOTS; lz++) {
+                for (int lx = 0; lx < LOTS; lx++) {
+                    float height = 8.0f + 40.0f * random01(seed) * random01(seed);
+                    glm::vec3 size(LOT - 1.0f, height, LOT - 1.0f);
+                    glm::vec3 center = origin + glm::vec3((lx + 0.5f) * LOT, height * 0.5f, (lz + 0.5f) * LOT);
+                    glm::mat4 model = glm::scale(glm::translate(glm::mat4(1.0f), center), size);
+                    objects.push_back({model, AABB(center - size * 0.5f, center + size * 0.5f), true});
+                }
+            }
+            // 街道上的小物体
+            for (int i = 0; i < 30; i++) {
+                float along = random01(seed) * BLOCK, across = LOTS * LOT + 1.0f + random01(seed) * (STREET - 2.0f);
+                glm::vec3 center = random01(seed) < 0.5f ? origin + glm::vec3(along, 0.75f, across) : origin + glm::vec3(across, 0.75f, along);
+                glm::vec3 size(1.0f + 2.0f * random01(seed), 1.5f, 1.0f + 2.0f * random01(seed));
+                glm::mat4 model = glm::scale(glm::translate(glm::mat4(1.0f), center), size);
+                objects.push_back({model, AABB(center - size * 0.5f, center + size * 0.5f), false});
+            }
+        }
+    }
+    return objects;
+}
+
+// 视锥体剔除得到候选物体，其中离摄像机最近的楼房作为遮挡物，近处的先写入
+void prepareCull(const std::vector<CityObject> &objects, const std::vector<AABB> &boxes, const std::vector<float> &occluderBox,
+                 const glm::mat4 &viewProjection, const glm::vec3 &eye, CullInput &input)
+{
+    input.ViewProjection = viewProjection;
+    input.Candidates.clear();
+    input.Occluders.clear();
+    Frustum frustum(viewProjection);
+    std::vector<std::pair<float, unsigned int>> buildings;
+    for (unsigned int i = 0; i < boxes.size(); i++) {
+        if (!frustum.IntersectsAABB(boxes[i]))
+            continue;
+        input.Candidates.push_back(i);
+        if (objects[i].Building)
+            buildings.push_back(std::make_pair(glm::length(boxes[i].Center() - eye), i));
+    }
+    std::sort(buildings.begin(), buildings.end());
+    if (buildings.size() > MAX_OCCLUDERS)
+        buildings.resize(MAX_OCCLUDERS);
+    for (const auto &building : buildings) {
+        Occluder occluder;
+        occluder.Vertices = occluderBox.data();
+        occluder.VertexCount = (unsigned int) occluderBox.size() / 3;
+        occluder.Model = objects[building.second].Model;
+        input.Occluders.push_back(occluder);
+    }
+}
+
+void drawObjects(Shader &shader, const std::vector<CityObject> &objects, const std::vector<unsigned int> &list)
+{
+    for (unsigned int i : list) {
+        shader.setMat4("model", objects[i].Model);
+        glDrawArrays(GL_TRIANGLES, 0, 36);
+    }
+}
+
+// 在固定的摄像机位置上检查剔除结果
+// 1. 被剔除的物体确实被挡住：先绘制所有候选物体得到完整的深度，再对每个候选物体做 GL_ANY_SAMPLES_PASSED 查询（不写深度），
+//    被剔除的物体必须没有任何样本通过；查询结果同时给出真正被挡住的物体数，用来衡量剔除的效率
+// 2. AVX2和标量、单线程和多线程、CullAsync 和同步调用的结果完全一致
+// 3. 对比不剔除和剔除后的绘制耗时
+// ---------------------------------------------------------------------------------------------------------
+int validate(Shader &shader, const std::vector<CityObject> &objects, const std::vector<AABB> &boxes, const std::vector<float> &occluderBox)
+{
+    using std::cout;
+    using std::endl;
+    using Clock = std::chrono::high_resolution_clock;
+
+    struct Pose { const char *Name; glm::vec3 Position; float Yaw, Pitch; };
+    const Pose poses[] = {
+            {"street",   glm::vec3( -3.0f,  1.7f,  200.0f), -90.0f,   0.0f},
+            {"corner",   glm::vec3( 44.0f,  1.7f,   44.0f), -135.0f,  2.0f},
+            {"cross",    glm::vec3(-52.0f,  1.7f,  -30.0f),   0.0f,   0.0f},
+            {"rooftop",  glm::vec3( 20.0f, 45.0f,  150.0f), -100.0f, -15.0f},
+            {"aerial",   glm::vec3(  0.0f, 150.0f, 300.0f), -90.0f,  -35.0f},
+            {"inside",   glm::vec3( 25.0f,  5.0f,   25.0f), -90.0f,   0.0f}     // 摄像机在楼房内部，遮挡物和近平面相交
+    };
+
+    std::vector<unsigned int> queries(objects.size());
+    glGenQueries((GLsizei) queries.size(), queries.data());
+    glViewport(0, 0, fbWidth, fbHeight);
+
+    MaskedOcclusionCuller culler(320, 240);
+    CullInput input;
+    int failures = 0;
+    double fullMs = 0.0, culledMs = 0.0, cullMs = 0.0;
+    for (const Pose &pose : poses) {
+        Camera cam(pose.Position, glm::vec3(0.0f, 1.0f, 0.0f), pose.Yaw, pose.Pitch);
+        cam.FarPlane = 1000.0f;
+        glm::mat4 projection = cam.GetProjectionMatrix((float)fbWidth / (float)fbHeight);
+        glm::mat4 view = cam.GetViewMatrix();
+        prepareCull(objects, boxes, occluderBox, projection * view, cam.Position, input);
+
+        // 各种配置的结果必须一致，最后一次（AVX2 + 所有线程）的结果用于绘制
+        const struct { unsigned int Threads; bool Simd; } modes[] = {{1, false}, {1, true}, {0, true}};
+        std::vector<unsigned int> reference, visible;
+        bool deterministic = true;
+        for (int m = 0; m < 3; m++) {
+            culler.Threads = modes[m].Threads;
+            culler.Simd = modes[m].Simd;
+            auto start = Clock::now();
+            culler.Clear();
+            culler.RenderOccluders(input.Occluders, input.ViewProjection);
+            culler.Test(boxes, input.Candidates, visible);
+            double ms = std::chrono::duration<double, std::milli>(Clock::now() - start).count();
+            if (m == 0)
+                reference = visible;
+            deterministic = deterministic && visible == reference;
+            if (m == 2)
+                cullMs += ms;
+        }
+        culler.CullAsync(input.Occluders, boxes, input.Candidates, input.ViewProjection);
+        bool asyncOk = culler.Wait() == visible;
+        OcclusionCullingStats stats = culler.Stats();
+
+        // 完整的深度，同时计时
+        shader.use();
+        shader.setMat4("projection", projection);
+        shader.setMat4("view", view);
+        glClearColor(0.55f, 0.7f, 0.85f, 1.0f);
+        glClear(GL_COLOR_BUFFER_BIT | GL_DEPTH_BUFFER_BIT);
+        glFinish();
+        auto start = Clock::now();
+        drawObjects(shader, objects, input.Candidates);
+        glFinish();
+        fullMs += std::chrono::duration<double, std::milli>(Clock::now() - start).count();
+
+        // 每个候选物体一个查询，可见的物体自己的片段和深度缓冲相等，用 GL_LEQUAL 让它们通过
+        glDepthMask(GL_FALSE);
+        glDepthFunc(GL_LEQUAL);
+        for (size_t k = 0; k < input.Candidates.size(); k++) {
+            glBeginQuery(GL_ANY_SAMPLES_PASSED, queries[k]);
+            drawObjects(shader, objects, std::vector<unsigned int>(1, input.Candidates[k]));
+            glEndQuery(GL_ANY_SAMPLES_PASSED);
+        }
+        glDepthFunc(GL_LESS);
+        glDepthMask(GL_TRUE);
+        size_t hidden = 0, wronglyCulled = 0;
+        for (size_t k = 0, v = 0; k < input.Candidates.size(); k++) {
+            int samplesPassed = 0;
+            glGetQueryObjectiv(queries[k], GL_QUERY_RESULT, &samplesPassed);
+            bool culled = v >= visible.size() || visible[v] != input.Candidates[k];
+            if (!culled)
+                v++;
+            if (samplesPassed == 0)
+                hidden++;
+            else if (culled)
+                wronglyCulled++;
+        }
+
+        // 只绘制剔除后的物体
+        glClear(GL_COLOR_BUFFER_BIT | GL_DEPTH_BUFFER_BIT);
+        glFinish();
+        start = Clock::now();
+        drawObjects(shader, objects, visible);
+        glFinish();
+        culledMs += std::chrono::duration<double, std::milli>(Clock::now() - start).count();
+
+        bool ok = deterministic && asyncOk && wronglyCulled == 0;
+        cout << pose.Name << ": candidates " << input.Candidates.size() << ", occluders " << input.Occluders.size()
+             << " (" << stats.RasterizedTriangles << " triangles), culled " << stats.Culled << " of " << hidden
+             << " hidden, wrongly culled " << wronglyCulled << (deterministic ? ", deterministic" : ", MISMATCH")
+             << (asyncOk ? "" : ", ASYNC MISMATCH") << (ok ? " OK" : " FAILED") << endl;
+        if (!ok)
+            failures++;
+    }
+    glDeleteQueries((GLsizei) queries.size(), queries.data());
+
+    size_t poseCount = sizeof(poses) / sizeof(poses[0]);
+    cout << "average per pose: cull " << cullMs / poseCount << " ms (" << (MaskedOcclusionCuller::HasAvx2() ? "AVX2" : "scalar")
+         << "), draw all candidates " << fullMs / poseCount << " ms, draw visible " << culledMs / poseCount << " ms" << endl;
+    cout << (failures == 0 ? "Occlusion culling is conservative and deterministic" : "Occlusion culling validation FAILED") << endl;
+    return failures;
+}
+
+// process all input: query GLFW whether relevant keys are pressed/released this frame and react accordingly
+// ---------------------------------------------------------------------------------------------------------
+void processInput(GLFWwindow *window)
+{
+    if (glfwGetKey(window, GLFW_KEY_ESCAPE) == GLFW_PRESS)
+        glfwSetWindowShouldClose(window, true);
+
+    if (glfwGetKey(window, GLFW_KEY_W) == GLFW_PRESS)
+        camera.ProcessKeyboard(FORWARD, deltaTime);
+    if (glfwGetKey(window, GLFW_KEY_S) == GLFW_PRESS)
+        camera.ProcessKeyboard(BACKWARD, deltaTime);
+    if (glfwGetKey(window, GLFW_KEY_A) == GLFW_PRESS)
+        camera.ProcessKeyboard(LEFT, deltaTime);
+    if (glfwGetKey(window, GLFW_KEY_D) == GLFW_PRESS)
+        camera.ProcessKeyboard(RIGHT, deltaTime);
+}
+
+void key_callback(GLFWwindow* window, int key, int scancode, int action, int mods)
+{
+    if (action != GLFW_PRESS)
+        return;
+    if (key == GLFW_KEY_O)
+        occlusionCulling = !occlusionCulling;
+    if (key == GLFW_KEY_M)
+        useSimd = !useSimd;
+    if (key == GLFW_KEY_T)
+        allThreads = !allThreads;
+}
+
+// glfw: whenever the window size changed (by OS or user resize) this callback function executes
+// ---------------------------------------------------------------------------------------------
+void framebuffer_size_callback(GLFWwindow* window, int width, int height)
+{
+    fbWidth = width;
+    fbHeight = height;
+    glViewport(0, 0, width, height);
+}
+
+void mouse_callback(GLFWwindow* window, double xpos, double ypos) {
+    if (firstMouse) {
+        lastX = xpos;
+        lastY = ypos;
+        firstMouse = false;
+    }
+    float xoffset = xpos - lastX;
+    float yoffset = lastY - ypos;
+    lastX = xpos;
+    lastY = ypos;
+
+    camera.ProcessMouseMovement(xoffset, yoffset);
+}
+
+void scroll_callback(GLFWwindow* window, double xoffset, double yoffset)
+{
+    camera.ProcessMouseScroll(yoffset);
+}
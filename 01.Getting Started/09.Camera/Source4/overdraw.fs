@@ -0,0 +1,7 @@
+#version 330 core
+// 过度绘制的测量：每个片段输出1，加法混合累加到 R32F 缓冲
+out vec4 FragColor;
+
+void main() {
+	FragColor = vec4(1.0f);
+}
@@ -0,0 +1,16 @@
+#version 330 core
+// 过度绘制的热度图：片段数从0到 maxCount 依次是黑、蓝、绿、黄、红
+out vec4 FragColor;
+
+in vec2 TexCoord;
+
+uniform sampler2D counts;
+uniform float maxCount;
+
+void main() {
+	float count = texture(counts, TexCoord).r;
+	const vec3 ramp[5] = vec3[5](vec3(0.0f), vec3(0.1f, 0.2f, 0.9f), vec3(0.1f, 0.8f, 0.2f), vec3(0.95f, 0.9f, 0.1f), vec3(0.9f, 0.1f, 0.1f));
+	float t = clamp(count / maxCount, 0.0f, 1.0f) * 4.0f;
+	int i = min(int(t), 3);
+	FragColor = vec4(mix(ramp[i], ramp[i + 1], t - float(i)), 1.0f);
+}
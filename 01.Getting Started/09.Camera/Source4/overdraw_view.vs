@@ -0,0 +1,9 @@
+#version 330 core
+// 覆盖整个屏幕的三角形，不需要顶点缓冲
+out vec2 TexCoord;
+
+void main() {
+	vec2 position = vec2((gl_VertexID << 1) & 2, gl_VertexID & 2);
+	TexCoord = position;
+	gl_Position = vec4(position * 2.0f - 1.0f, 0.0f, 1.0f);
+}
@@ -0,0 +1,617 @@
+// 路径追踪示例：摄像机示例的场景（10个带两张纹理的立方体）用CPU上的 PathTracer 渐进式渲染，结果上传到纹理再复制到窗口
+// 摄像机不动时每帧给每个像素增加一个样本，画面逐渐收敛；摄像机一动就清空重新累计
+// 按L键在光照（天空 + 太阳，最多3次弹射）和只输出反照率之间切换，M键切换AVX2和标量路径，T键在单线程和所有线程之间切换，
+// 标题栏显示累计的样本数、每秒射线数和每帧的渲染时间
+//
+// 运行参数：
+//   --validate   隐藏窗口，检查：只输出反照率时和OpenGL渲染的画面一致（SSIM）；同一个种子的结果和线程数、AVX2/标量无关，逐字节相同，
+//                换一个种子结果不同；有光照时误差按 1/sqrt(样本数) 收敛；并输出每秒射线数
+#include <iostream>
+#include <cstring>
+#include <vector>
+#include <string>
+#include <chrono>
+#include <cmath>
+#include <glad/glad.h>
+#include <GLFW/glfw3.h>
+
+#include <glm/glm.hpp>
+#include <glm/gtc/matrix_transform.hpp>
+#include <glm/gtc/quaternion.hpp>
+#include <glm/gtc/type_ptr.hpp>
+
+#include <stb_image.h>
+#include <learnopengl/shader.h>
+#include <learnopengl/camera.h>
+#include <learnopengl/image_compare.h>
+#include <learnopengl/path_tracer.h>
+
+void framebuffer_size_callback(GLFWwindow* window, int width, int height);
+void mouse_callback(GLFWwindow* window, double xpos, double ypos);
+void scroll_callback(GLFWwindow* window, double xoffset, double yoffset);
+void key_callback(GLFWwindow* window, int key, int scancode, int action, int mods);
+void processInput(GLFWwindow *window);
+
+// 窗口大小
+const unsigned int SCR_WIDTH = 800;
+const unsigned int SCR_HEIGHT = 600;
+
+// camera
+Camera camera(glm::vec3(0.0f, 0.0f, 3.0f));
+
+bool firstMouse = true;
+double lastX = SCR_WIDTH / 2.0;
+double lastY = SCR_HEIGHT / 2.0;
+
+// timing
+float deltaTime = 0.0f;	// time between current frame and last frame
+float lastFrame = 0.0f;
+
+// 渲染方式，修改后要重新累计
+bool lighting = true;
+bool useSimd = true;
+bool allThreads = true;
+bool settingsChanged = false;
+
+int fbWidth = SCR_WIDTH, fbHeight = SCR_HEIGHT;
+
+// 和摄像机示例相同的立方体：位置 + 纹理坐标
+const float cubeVertices[] = {
+        -0.5f, -0.5f, -0.5f,  0.0f, 0.0f,
+         0.5f, -0.5f, -0.5f,  1.0f, 0.0f,
+         0.5f,  0.5f, -0.5f,  1.0f, 1.0f,
+         0.5f,  0.5f, -0.5f,  1.0f, 1.0f,
+        -0.5f,  0.5f, -0.5f,  0.0f, 1.0f,
+        -0.5f, -0.5f, -0.5f,  0.0f, 0.0f,
+
+        -0.5f, -0.5f,  0.5f,  0.0f, 0.0f,
+         0.5f, -0.5f,  0.5f,  1.0f, 0.0f,
+         0.5f,  0.5f,  0.5f,  1.0f, 1.0f,
+         0.5f,  0.5f,  0.5f,  1.0f, 1.0f,
+        -0.5f,  0.5f,  0.5f,  0.0f, 1.0f,
+        -0.5f, -0.5f,  0.5f,  0.0f, 0.0f,
+
+        -0.5f,  0.5f,  0.5f,  1.0f, 0.0f,
+        -0.5f,  0.5f, -0.5f,  1.0f, 1.0f,
+        -0.5f, -0.5f, -0.5f,  0.0f, 1.0f,
+        -0.5f, -0.5f, -0.5f,  0.0f, 1.0f,
+        -0.5f, -0.5f,  0.5f,  0.0f, 0.0f,
+        -0.5f,  0.5f,  0.5f,  1.0f, 0.0f,
+
+         0.5f,  0.5f,  0.5f,  1.0f, 0.0f,
+         0.5f,  0.5f, -0.5f,  1.0f, 1.0f,
+         0.5f, -0.5f, -0.5f,  0.0f, 1.0f,
+         0.5f, -0.5f, -0.5f,  0.0f, 1.0f,
+         0.5f, -0.5f,  0.5f,  0.0f, 0.0f,
+         0.5f,  0.5f,  0.5f,  1.0f, 0.0f,
+
+        -0.5f, -0.5f, -0.5f,  0.0f, 1.0f,
+         0.5f, -0.5f, -0.5f,  1.0f, 1.0f,
+         0.5f, -0.5f,  0.5f,  1.0f, 0.0f,
+         0.5f, -0.5f,  0.5f,  1.0f, 0.0f,
+        -0.5f, -0.5f,  0.5f,  0.0f, 0.0f,
+        -0.5f, -0.5f, -0.5f,  0.0f, 1.0f,
+
+        -0.5f,  0.5f, -0.5f,  0.0f, 1.0f,
+         0.5f,  0.5f, -0.5f,  1.0f, 1.0f,
+         0.5f,  0.5f,  0.5f,  1.0f, 0.0f,
+         0.5f,  0.5f,  0.5f,  1.0f, 0.0f,
+        -0.5f,  0.5f,  0.5f,  0.0f, 0.0f,
+        -0.5f,  0.5f, -0.5f,  0.0f, 1.0f
+};
+
+// 世界空间坐标
+const glm::vec3 cubePositions[] = {
+        glm::vec3( 0.0f,  0.0f,  0.0f),
+        glm::vec3( 2.0f,  5.0f, -15.0f),
+        glm::vec3(-1.5f, -2.2f, -2.5f),
+        glm::vec3(-3.8f, -2.0f, -12.3f),
+        glm::vec3( 2.4f, -0.4f, -3.5f),
+        glm::vec3(-1.7f,  3.0f, -7.5f),
+        glm::vec3( 1.3f, -2.0f, -2.5f),
+        glm::vec3( 1.5f,  2.0f, -2.5f),
+        glm::vec3( 1.5f,  0.2f, -1.5f),
+        glm::vec3(-1.3f,  1.0f, -1.5f)
+};
+const int CUBE_COUNT = sizeof(cubePositions) / sizeof(cubePositions[0]);
+
+// 校验用的摄像机位置
+struct View {
+    const char *Name;
+    glm::vec3 Position;
+    float Yaw, Pitch, Zoom;
+};
+const View VIEWS[] = {
+        {"front",   glm::vec3(0.0f, 0.0f, 3.0f),    -90.0f,   0.0f, 45.0f},
+        {"side",    glm::vec3(6.0f, 1.0f, -4.0f),  -180.0f, -10.0f, 45.0f},
+        {"above",   glm::vec3(0.0f, 12.0f, -5.0f),  -90.0f, -80.0f, 60.0f}
+};
+const int VIEW_COUNT = sizeof(VIEWS) / sizeof(VIEWS[0]);
+
+// 校验的分辨率比窗口小，CPU渲染多个样本也不会太慢
+const int VALIDATE_WIDTH = 400, VALIDATE_HEIGHT = 300;
+// 只输出反照率时和GL比较：GL的纹理用了mipmap，路径追踪每个像素多个抖动的样本（自带抗锯齿），
+// 远处的纹理和轮廓边上的像素会有差别，所以只要求平均SSIM
+const unsigned int UNLIT_SAMPLES = 16;
+const double MIN_MEAN_SSIM = 0.9;
+
+// 场景用到的GL对象和软件纹理
+struct Scene {
+    Shader *Program;
+    unsigned int VAO;
+    unsigned int Textures[2];
+    SoftwareTexture SoftwareTextures[2];
+    std::vector<glm::mat4> Models;
+};
+
+void drawGL(const Scene &scene, const Camera &cam, float aspectRatio);
+void buildScene(const Scene &scene, PathTracer &tracer);
+void setLighting(PathTracer &tracer, bool lit);
+int validate(const Scene &scene);
+
+int main(int argc, char *argv[])
+{
+    using std::cout;
+    using std::endl;
+
+    bool validateMode = argc > 1 && std::strcmp(argv[1], "--validate") == 0;
+
+    // glfw: 初始化设置
+    // ------------------------------
+    glfwInit();
+    glfwWindowHint(GLFW_CONTEXT_VERSION_MAJOR, 3);
+    glfwWindowHint(GLFW_CONTEXT_VERSION_MINOR, 3);
+    glfwWindowHint(GLFW_OPENGL_PROFILE, GLFW_OPENGL_CORE_PROFILE);
+    if (validateMode)
+        glfwWindowHint(GLFW_VISIBLE, GLFW_FALSE);
+
+    // glfw: 创建窗口
+    // --------------------
+    GLFWwindow* window = glfwCreateWindow(SCR_WIDTH, SCR_HEIGHT, "LearnOpenGL", nullptr, nullptr);
+    if (window == nullptr)
+    {
+        cout << "Failed to create GLFW window" << endl;
+        glfwTerminate();
+        exit(EXIT_FAILURE);
+    }
+    glfwMakeContextCurrent(window);     // 设置OpenGL上下文
+    glfwSetFramebufferSizeCallback(window, framebuffer_size_callback);
+    glfwSetCursorPosCallback(window, mouse_callback);
+    glfwSetScrollCallback(window, scroll_callback);
+    glfwSetKeyCallback(window, key_callback);
+    if (!validateMode)
+        glfwSetInputMode(window, GLFW_CURSOR, GLFW_CURSOR_DISABLED);
+
+    // glad: 加载OpenGL函数指针
+    // ---------------------------------------
+    if (!gladLoadGLLoader((GLADloadproc)glfwGetProcAddress))
+    {
+        cout << "Failed to initialize GLAD" << endl;
+        exit(EXIT_FAILURE);
+    }
+    glEnable(GL_DEPTH_TEST);
+    glfwGetFramebufferSize(window, &fbWidth, &fbHeight);
+    cout << "renderer: " << glGetString(GL_RENDERER) << endl;
+    cout << "path tracer: " << (PathTracer::HasAvx2() ? "AVX2" : "scalar") << ", "
+         << std::thread::hardware_concurrency() << " hardware threads" << endl;
+
+    // 定义编译着色器
+    Shader ourShader("6.1.coordinate_systems.vs", "6.1.coordinate_systems.fs");
+
+    Scene scene;
+    scene.Program = &ourShader;
+    for (int i = 0; i < CUBE_COUNT; i++) {
+        glm::mat4 model = glm::translate(glm::mat4(1.0f), cubePositions[i]);
+        model = model * glm::mat4_cast(glm::angleAxis(glm::radians(20.0f * i), glm::normalize(glm::vec3(1.0f, 0.3f, 0.5f))));
+        scene.Models.push_back(model);
+    }
+
+    // 创建顶点缓冲和顶点数组
+    unsigned int VBO;
+    glGenVertexArrays(1, &scene.VAO);
+    glGenBuffers(1, &VBO);
+    glBindVertexArray(scene.VAO);
+    glBindBuffer(GL_ARRAY_BUFFER, VBO);
+    glBufferData(GL_ARRAY_BUFFER, sizeof(cubeVertices), cubeVertices, GL_STATIC_DRAW);
+    // 顶点位置
+    glVertexAttribPointer(0, 3, GL_FLOAT, GL_FALSE, 5 * sizeof(float), (void *)nullptr);
+    glEnableVertexAttribArray(0);
+    // 纹理坐标
+    glVertexAttribPointer(1, 2, GL_FLOAT, GL_FALSE, 5 * sizeof(float), (void *)(3 * sizeof(float)));
+    glEnableVertexAttribArray(1);
+
+    // 纹理：同一份图片数据同时创建GL纹理和软件纹理，GL纹理的设置和摄像机示例相同
+    const char *texturePaths[2] = {"container.jpg", "awesomeface.png"};
+    glGenTextures(2, scene.Textures);
+    stbi_set_flip_vertically_on_load(true);
+    for (int i = 0; i < 2; i++) {
+        glBindTexture(GL_TEXTURE_2D, scene.Textures[i]);
+        glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_WRAP_S, GL_REPEAT);
+        glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_WRAP_T, GL_REPEAT);
+        glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_MIN_FILTER, GL_LINEAR);
+        glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_MAG_FILTER, GL_LINEAR);
+        int width, height, nrChannels;
+        unsigned char *data = stbi_load(texturePaths[i], &width, &height, &nrChannels, 0);
+        if (data) {
+            GLenum format = nrChannels == 4 ? GL_RGBA : nrChannels == 1 ? GL_RED : GL_RGB;
+            glPixelStorei(GL_UNPACK_ALIGNMENT, 1);
+            glTexImage2D(GL_TEXTURE_2D, 0, GL_RGB, width, height, 0, format, GL_UNSIGNED_BYTE, data);
+            glPixelStorei(GL_UNPACK_ALIGNMENT, 4);
+            glGenerateMipmap(GL_TEXTURE_2D);
+            scene.SoftwareTextures[i] = SoftwareTexture(data, width, height, nrChannels);
+        } else
+            cout << "Failed to load texture: " << texturePaths[i] << endl;
+        stbi_image_free(data);
+    }
+
+    ourShader.use();
+    ourShader.setInt("texture1", 0);
+    ourShader.setInt("texture2", 1);
+    ourShader.setBool("highlight", false);
+
+    if (validateMode) {
+        int failures = validate(scene);
+        glDeleteVertexArrays(1, &scene.VAO);
+        glDeleteBuffers(1, &VBO);
+        glDeleteTextures(2, scene.Textures);
+        glfwTerminate();
+        return failures == 0 ? EXIT_SUCCESS : EXIT_FAILURE;
+    }
+
+    PathTracer tracer(fbWidth, fbHeight);
+    buildScene(scene, tracer);
+    setLighting(tracer, lighting);
+
+    // 累计的结果上传到这张纹理，通过只读的帧缓冲复制到窗口
+    std::vector<unsigned char> pixels;
+    unsigned int uploadTexture, uploadFBO;
+    glGenTextures(1, &uploadTexture);
+    glGenFramebuffers(1, &uploadFBO);
+    int uploadWidth = 0, uploadHeight = 0;
+    glm::mat4 lastView(0.0f), lastProjection(0.0f);
+
+    // 渲染循环
+    // -----------
+    float titleTimer = 0.0f;
+    while (!glfwWindowShouldClose(window))
+    {
+        float currentFrame = glfwGetTime();
+        deltaTime = currentFrame - lastFrame;
+        lastFrame = currentFrame;
+
+        processInput(window);
+        if (fbWidth == 0 || fbHeight == 0) {
+            glfwPollEvents();
+            continue;
+        }
+
+        // 窗口大小、摄像机或设置变化时重新开始累计
+        glm::mat4 view = camera.GetViewMatrix();
+        glm::mat4 projection = camera.GetProjectionMatrix((float) fbWidth / (float) fbHeight);
+        if (tracer.Width() != fbWidth || tracer.Height() != fbHeight)
+            tracer.Resize(fbWidth, fbHeight);
+        if (settingsChanged || tracer.SampleCount() == 0 || view != lastView || projection != lastProjection) {
+            settingsChanged = false;
+            tracer.Simd = useSimd;
+            tracer.Threads = allThreads ? 0 : 1;
+            setLighting(tracer, lighting);
+            tracer.SetCamera(view, projection);
+            lastView = view;
+            lastProjection = projection;
+        }
+        tracer.Render(1);
+        tracer.ReadPixels(pixels);
+
+        glBindTexture(GL_TEXTURE_2D, uploadTexture);
+        if (uploadWidth != fbWidth || uploadHeight != fbHeight) {
+            uploadWidth = fbWidth;
+            uploadHeight = fbHeight;
+            glTexImage2D(GL_TEXTURE_2D, 0, GL_RGBA8, fbWidth, fbHeight, 0, GL_RGBA, GL_UNSIGNED_BYTE, nullptr);
+            glBindFramebuffer(GL_READ_FRAMEBUFFER, uploadFBO);
+            glFramebufferTexture2D(GL_READ_FRAMEBUFFER, GL_COLOR_ATTACHMENT0, GL_TEXTURE_2D, uploadTexture, 0);
+        }
+        glTexSubImage2D(GL_TEXTURE_2D, 0, 0, 0, fbWidth, fbHeight, GL_RGBA, GL_UNSIGNED_BYTE, pixels.data());
+        glBindFramebuffer(GL_READ_FRAMEBUFFER, uploadFBO);
+        glBindFramebuffer(GL_DRAW_FRAMEBUFFER, 0);
+        glBlitFramebuffer(0, 0, fbWidth, fbHeight, 0, 0, fbWidth, fbHeight, GL_COLOR_BUFFER_BIT, GL_NEAREST);
+        glBindFramebuffer(GL_FRAMEBUFFER, 0);
+
+        titleTimer += deltaTime;
+        if (titleTimer > 0.5f) {
+            titleTimer = 0.0f;
+            const PathTracerStats &stats = tracer.Stats();
+            std::string mode = std::string(lighting ? "lit" : "albedo") + ", " + (useSimd && PathTracer::HasAvx2() ? "AVX2" : "scalar") +
+                               (allThreads ? ", all threads" : ", 1 thread");
+            std::string title = "Path Tracer - " + mode + " - " + std::to_string(tracer.SampleCount()) + " spp, " +
+                                std::to_string(stats.RaysPerSecond() * 1e-6) + " Mrays/s, " + std::to_string(stats.Ms) + " ms";
+            glfwSetWindowTitle(window, title.c_str());
+        }
+
+        // glfw: 交换颜色缓冲，检测事件
+        // -------------------------------------------------------------------------------
+        glfwSwapBuffers(window);
+        glfwPollEvents();
+    }
+
+    glDeleteTextures(1, &uploadTexture);
+    glDeleteFramebuffers(1, &uploadFBO);
+    glDeleteVertexArrays(1, &scene.VAO);
+    glDeleteBuffers(1, &VBO);
+    glDeleteTextures(2, scene.Textures);
+
+    glfwTerminate();
+    return 0;
+}
+
+// 用OpenGL画所有立方体，调用前绑定好帧缓冲并清空
+// ---------------------------------------------------------------------------------------------------------
+void drawGL(const Scene &scene, const Camera &cam, float aspectRatio)
+{
+    glActiveTexture(GL_TEXTURE0);
+    glBindTexture(GL_TEXTURE_2D, scene.Textures[0]);
+    glActiveTexture(GL_TEXTURE1);
+    glBindTexture(GL_TEXTURE_2D, scene.Textures[1]);
+    scene.Program->use();
+    scene.Program->setMat4("projection", cam.GetProjectionMatrix(aspectRatio));
+    scene.Program->setMat4("view", cam.GetViewMatrix());
+    glBindVertexArray(scene.VAO);
+    for (const glm::mat4 &model : scene.Models) {
+        scene.Program->setMat4("model", model);
+        glDrawArrays(GL_TRIANGLES, 0, 36);
+    }
+}
+
+// 把场景的立方体交给路径追踪器并建BVH
+// ---------------------------------------------------------------------------------------------------------
+void buildScene(const Scene &scene, PathTracer &tracer)
+{
+    SoftwareMaterial material;
+    material.Texture1 = &scene.SoftwareTextures[0];
+    material.Texture2 = &scene.SoftwareTextures[1];
+    material.Mix = 0.2f;
+    tracer.ClearScene();
+    for (const glm::mat4 &model : scene.Models)
+        tracer.AddMesh(cubeVertices, 36, model, material);
+    tracer.Build();
+}
+
+// 有光照时天空是示例的清屏颜色提亮一些，再加一个太阳；没有光照时直接输出反照率，背景就是清屏颜色
+// ---------------------------------------------------------------------------------------------------------
+void setLighting(PathTracer &tracer, bool lit)
+{
+    tracer.SkyColor = lit ? glm::vec3(0.4f, 0.6f, 0.6f) : glm::vec3(0.2f, 0.3f, 0.3f);
+    tracer.SunColor = lit ? glm::vec3(1.0f, 0.95f, 0.85f) : glm::vec3(0.0f);
+    tracer.MaxBounces = lit ? 3 : 0;
+}
+
+// 1. 只输出反照率：每个摄像机位置和GL的画面比较SSIM
+// 2. 确定性：同一个种子，AVX2和标量、1 / 3 / 所有线程的结果逐字节相同，同一个配置渲染两次相同；换一个种子结果不同
+// 3. 收敛：有光照时换一个种子渲染很多样本作为参考，误差乘以 sqrt(样本数) 应该大致不变，样本数翻16倍误差至少降到 1/3
+// 4. 各种配置的每秒射线数
+// ---------------------------------------------------------------------------------------------------------
+int validate(const Scene &scene)
+{
+    using std::cout;
+    using std::endl;
+
+    const int width = VALIDATE_WIDTH, height = VALIDATE_HEIGHT;
+    float aspectRatio = (float) width / (float) height;
+    int failures = 0;
+
+    // 离屏缓冲，大小和窗口无关
+    unsigned int FBO, colorBuffer, depthBuffer;
+    glGenFramebuffers(1, &FBO);
+    glBindFramebuffer(GL_FRAMEBUFFER, FBO);
+    glGenRenderbuffers(1, &colorBuffer);
+    glBindRenderbuffer(GL_RENDERBUFFER, colorBuffer);
+    glRenderbufferStorage(GL_RENDERBUFFER, GL_RGBA8, width, height);
+    glFramebufferRenderbuffer(GL_FRAMEBUFFER, GL_COLOR_ATTACHMENT0, GL_RENDERBUFFER, colorBuffer);
+    glGenRenderbuffers(1, &depthBuffer);
+    glBindRenderbuffer(GL_RENDERBUFFER, depthBuffer);
+    glRenderbufferStorage(GL_RENDERBUFFER, GL_DEPTH24_STENCIL8, width, height);
+    glFramebufferRenderbuffer(GL_FRAMEBUFFER, GL_DEPTH_STENCIL_ATTACHMENT, GL_RENDERBUFFER, depthBuffer);
+    if (glCheckFramebufferStatus(GL_FRAMEBUFFER) != GL_FRAMEBUFFER_COMPLETE)
+        cout << "Framebuffer is not complete" << endl;
+    glViewport(0, 0, width, height);
+
+    auto makeCamera = [](const View &v) {
+        Camera cam(v.Position, glm::vec3(0.0f, 1.0f, 0.0f), v.Yaw, v.Pitch);
+        cam.Zoom = v.Zoom;
+        return cam;
+    };
+    auto render = [&](PathTracer &tracer, const Camera &cam, unsigned int samples) {
+        tracer.SetCamera(cam.GetViewMatrix(), cam.GetProjectionMatrix((float) tracer.Width() / (float) tracer.Height()));
+        tracer.Render(samples);
+    };
+
+    PathTracer tracer(width, height);
+    buildScene(scene, tracer);
+    std::vector<unsigned char> glPixels, ptPixels, other;
+
+    // 1. 只输出反照率时和GL比较
+    setLighting(tracer, false);
+    for (int i = 0; i < VIEW_COUNT; i++) {
+        Camera cam = makeCamera(VIEWS[i]);
+        glClearColor(0.2f, 0.3f, 0.3f, 1.0f);
+        glClear(GL_COLOR_BUFFER_BIT | GL_DEPTH_BUFFER_BIT);
+        drawGL(scene, cam, aspectRatio);
+        glPixels.resize((size_t) width * height * 4);
+        glReadPixels(0, 0, width, height, GL_RGBA, GL_UNSIGNED_BYTE, glPixels.data());
+        render(tracer, cam, UNLIT_SAMPLES);
+        tracer.ReadPixels(ptPixels);
+        ImageDifference diff = CompareImages(glPixels.data(), ptPixels.data(), width, height, 24);
+        bool ok = diff.Ssim >= MIN_MEAN_SSIM;
+        cout << "albedo view " << VIEWS[i].Name << ": " << UNLIT_SAMPLES << " spp, SSIM " << diff.Ssim << " (min " << diff.MinSsim
+             << "), " << diff.DiffFraction * 100.0 << "% pixels differ " << (ok ? "OK" : "FAILED") << endl;
+        if (!ok)
+            failures++;
+    }
+
+    // 2. 确定性，用有光照的场景，弹射和阴影射线都参与
+    setLighting(tracer, true);
+    {
+        Camera cam = makeCamera(VIEWS[0]);
+        const unsigned int SAMPLES = 2;
+        tracer.Simd = true;
+        tracer.Threads = 0;
+        render(tracer, cam, SAMPLES);
+        std::vector<unsigned char> reference;
+        tracer.ReadPixels(reference);
+        bool ok = true;
+        const struct { bool Simd; unsigned int Threads; } configs[] = {{false, 1}, {false, 0}, {true, 1}, {true, 3}, {true, 0}};
+        for (const auto &config : configs) {
+            tracer.Simd = config.Simd;
+            tracer.Threads = config.Threads;
+            render(tracer, cam, SAMPLES);
+            tracer.ReadPixels(other);
+            ok = ok && other == reference;
+        }
+        // 分两次累计和一次渲染所有样本结果相同
+        tracer.SetCamera(cam.GetViewMatrix(), cam.GetProjectionMatrix(aspectRatio));
+        tracer.Render(1);
+        tracer.Render(SAMPLES - 1);
+        tracer.ReadPixels(other);
+        ok = ok && other == reference;
+        tracer.Seed = 2;
+        render(tracer, cam, SAMPLES);
+        tracer.ReadPixels(other);
+        bool seedMatters = other != reference;
+        tracer.Seed = 1;
+        tracer.Simd = true;
+        tracer.Threads = 0;
+        cout << "determinism: " << (PathTracer::HasAvx2() ? "AVX2 and scalar" : "scalar only")
+             << ", 1 / 3 / all threads, progressive and one-shot produce identical images " << (ok ? "OK" : "FAILED")
+             << "; another seed gives a different image " << (seedMatters ? "OK" : "FAILED") << endl;
+        if (!ok || !seedMatters)
+            failures++;
+    }
+
+    // 3. 收敛，分辨率减半
+    {
+        Camera cam = makeCamera(VIEWS[0]);
+        PathTracer small(width / 2, height / 2);
+        buildScene(scene, small);
+        setLighting(small, true);
+        small.Seed = 1234;
+        render(small, cam, 256);
+        std::vector<glm::vec3> reference((size_t) small.Width() * small.Height());
+        for (int y = 0; y < small.Height(); y++)
+            for (int x = 0; x < small.Width(); x++)
+                reference[(size_t) y * small.Width() + x] = small.Pixel(x, y);
+        auto rmse = [&]() {
+            double sum = 0.0;
+            for (int y = 0; y < small.Height(); y++)
+                for (int x = 0; x < small.Width(); x++) {
+                    glm::vec3 d = small.Pixel(x, y) - reference[(size_t) y * small.Width() + x];
+                    sum += glm::dot(d, d) / 3.0;
+                }
+            return std::sqrt(sum / ((double) small.Width() * small.Height()));
+        };
+
+        small.Seed = 1;
+        small.SetCamera(cam.GetViewMatrix(), cam.GetProjectionMatrix((float) small.Width() / (float) small.Height()));
+        cout << "convergence (reference 256 spp):";
+        double firstError = 0.0, lastError = 0.0;
+        for (unsigned int target = 1; target <= 16; target *= 4) {
+            small.Render(target - small.SampleCount());
+            double error = rmse();
+            if (target == 1)
+                firstError = error;
+            lastError = error;
+            cout << " " << target << " spp rmse " << error << " (x sqrt(spp) " << error * std::sqrt((double) target) << ")";
+        }
+        // 理想情况下降到 1/4，参考图像本身也有噪声
+        bool ok = lastError < firstError / 3.0;
+        cout << " " << (ok ? "OK" : "FAILED") << endl;
+        if (!ok)
+            failures++;
+    }
+
+    // 4. 每秒射线数
+    {
+        Camera cam = makeCamera(VIEWS[0]);
+        cout << "rays per second:";
+        const struct { const char *Name; bool Simd; unsigned int Threads; } configs[] = {
+                {"scalar 1 thread", false, 1}, {"scalar all threads", false, 0},
+                {"AVX2 1 thread", true, 1}, {"AVX2 all threads", true, 0}};
+        for (const auto &config : configs) {
+            if (config.Simd && !PathTracer::HasAvx2())
+                continue;
+            tracer.Simd = config.Simd;
+            tracer.Threads = config.Threads;
+            render(tracer, cam, 2);
+            const PathTracerStats &stats = tracer.Stats();
+            cout << " " << config.Name << " " << stats.RaysPerSecond() * 1e-6 << " M (" << stats.Ms << " ms)";
+        }
+        cout << endl;
+    }
+
+    glBindFramebuffer(GL_FRAMEBUFFER, 0);
+    glDeleteFramebuffers(1, &FBO);
+    glDeleteRenderbuffers(1, &colorBuffer);
+    glDeleteRenderbuffers(1, &depthBuffer);
+    cout << (failures == 0 ? "path tracer OK" : "path tracer FAILED") << endl;
+    return failures;
+}
+
+// process all input: query GLFW whether relevant keys are pressed/released this frame and react accordingly
+// ---------------------------------------------------------------------------------------------------------
+void processInput(GLFWwindow *window)
+{
+    if (glfwGetKey(window, GLFW_KEY_ESCAPE) == GLFW_PRESS)
+        glfwSetWindowShouldClose(window, true);
+
+    if (glfwGetKey(window, GLFW_KEY_W) == GLFW_PRESS)
+        camera.ProcessKeyboard(FORWARD, deltaTime);
+    if (glfwGetKey(window, GLFW_KEY_S) == GLFW_PRESS)
+        camera.ProcessKeyboard(BACKWARD, deltaTime);
+    if (glfwGetKey(window, GLFW_KEY_A) == GLFW_PRESS)
+        camera.ProcessKeyboard(LEFT, deltaTime);
+    if (glfwGetKey(window, GLFW_KEY_D) == GLFW_PRESS)
+        camera.ProcessKeyboard(RIGHT, deltaTime);
+}
+
+// 按键事件：L切换光照和反照率，M切换AVX2和标量，T切换线程数
+// ---------------------------------------------------------------------------------------------------------
+void key_callback(GLFWwindow* window, int key, int scancode, int action, int mods)
+{
+    if (action != GLFW_PRESS)
+        return;
+    if (key == GLFW_KEY_L)
+        lighting = !lighting;
+    else if (key == GLFW_KEY_M)
+        useSimd = !useSimd;
+    else if (key == GLFW_KEY_T)
+        allThreads = !allThreads;
+    else
+        return;
+    settingsChanged = true;
+}
+
+// glfw: whenever the window size changed (by OS or user resize) this callback function executes
+// ---------------------------------------------------------------------------------------------
+void framebuffer_size_callback(GLFWwindow* window, int width, int height)
+{
+    fbWidth = width;
+    fbHeight = height;
+    glViewport(0, 0, width, height);
+}
+
+void mouse_callback(GLFWwindow* window, double xpos, double ypos) {
+    if (firstMouse) {
+        lastX = xpos;
+        lastY = ypos;
+        firstMouse = false;
+    }
+    float xoffset = xpos - lastX;
+    float yoffset = lastY - ypos;
+    lastX = xpos;
+    lastY = ypos;
+
+    camera.ProcessMouseMovement(xoffset, yoffset);
+}
+
+void scroll_callback(GLFWwindow* window, double xoffset, double yoffset)
+{
+    camera.ProcessMouseScroll(yoffset);
+}
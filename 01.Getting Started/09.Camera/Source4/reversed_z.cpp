@@ -0,0 +1,396 @@
+// 反转深度示例：在10到10万个单位的距离上各放一对重叠的平面，绿色平面在红色平面后面 1/10000 的距离处
+// 深度精度不够时两者的深度相同，先画的绿色平面会透出来（z-fighting）；深度精度足够时只能看到红色
+// 按Z键在三种模式之间切换：标准深度（近平面0.1，远平面100万）、反转深度 + glClipControl、没有glClipControl的反转深度
+// 三种模式都渲染到32位浮点深度的离屏缓冲
+//
+// 运行参数：
+//   --validate   隐藏窗口，用三种模式各渲染一次，统计每个距离上透出来的绿色像素；反转深度 + glClipControl 必须为0
+#include <iostream>
+#include <cstring>
+#include <vector>
+#include <string>
+#include <glad/glad.h>
+#include <GLFW/glfw3.h>
+
+#include <glm/glm.hpp>
+#include <glm/gtc/matrix_transform.hpp>
+#include <glm/gtc/type_ptr.hpp>
+
+
+#include <learnopengl/shader.h>
+#include <learnopengl/camera.h>
+
+void framebuffer_size_callback(GLFWwindow* window, int width, int height);
+void mouse_callback(GLFWwindow* window, double xpos, double ypos);
+void scroll_callback(GLFWwindow* window, double xoffset, double yoffset);
+void key_callback(GLFWwindow* window, int key, int scancode, int action, int mods);
+void processInput(GLFWwindow *window);
+
+// 窗口大小
+const unsigned int SCR_WIDTH = 800;
+const unsigned int SCR_HEIGHT = 800;
+
+// 平面对的距离，以及绿色平面相对红色平面往后挪的比例
+const float DISTANCES[] = {10.0f, 100.0f, 1000.0f, 10000.0f, 100000.0f};
+const int PAIR_COUNT = sizeof(DISTANCES) / sizeof(DISTANCES[0]);
+const float GAP = 1e-4f;
+
+// camera
+Camera camera(glm::vec3(0.0f, 0.0f, 0.0f));
+
+bool firstMouse = true;
+double lastX = SCR_WIDTH / 2.0;
+double lastY = SCR_HEIGHT / 2.0;
+
+// timing
+float deltaTime = 0.0f;	// time between current frame and last frame
+float lastFrame = 0.0f;
+
+// 深度模式
+enum DepthMode {
+    STANDARD_DEPTH,
+    REVERSED_Z,
+    REVERSED_Z_NO_CLIP_CONTROL,
+    DEPTH_MODE_COUNT
+};
+const char *DEPTH_MODE_NAMES[] = {"standard", "reversed-Z", "reversed-Z without glClipControl"};
+int depthMode = REVERSED_Z;
+bool depthModeChanged = true;
+
+// 离屏缓冲：RGBA8颜色 + 32位浮点深度
+int fbWidth = SCR_WIDTH, fbHeight = SCR_HEIGHT;
+bool fbResized = false;
+
+struct SceneTarget {
+    unsigned int FBO = 0, ColorBuffer = 0, DepthBuffer = 0;
+};
+
+void createTarget(SceneTarget &target, int width, int height);
+void destroyTarget(SceneTarget &target);
+void applyDepthMode(Camera &cam, int mode);
+void drawPairs(Shader &shader, const Camera &cam, unsigned int VAO, float aspectRatio);
+int validate(Shader &shader, unsigned int VAO, SceneTarget &target);
+
+int main(int argc, char *argv[])
+{
+    using std::cout;
+    using std::endl;
+
+    bool validateMode = argc > 1 && std::strcmp(argv[1], "--validate") == 0;
+
+    // glfw: 初始化设置
+    // ------------------------------
+    glfwInit();
+    glfwWindowHint(GLFW_CONTEXT_VERSION_MAJOR, 3);
+    glfwWindowHint(GLFW_CONTEXT_VERSION_MINOR, 3);
+    glfwWindowHint(GLFW_OPENGL_PROFILE, GLFW_OPENGL_CORE_PROFILE);
+    if (validateMode)
+        glfwWindowHint(GLFW_VISIBLE, GLFW_FALSE);
+
+    // glfw: 创建窗口
+    // --------------------
+    GLFWwindow* window = glfwCreateWindow(SCR_WIDTH, SCR_HEIGHT, "LearnOpenGL", nullptr, nullptr);
+    if (window == nullptr)
+    {
+        cout << "Failed to create GLFW window" << endl;
+        glfwTerminate();
+        exit(EXIT_FAILURE);
+    }
+    glfwMakeContextCurrent(window);     // 设置OpenGL上下文
+    glfwSetFramebufferSizeCallback(window, framebuffer_size_callback);
+    glfwSetCursorPosCallback(window, mouse_callback);
+    glfwSetScrollCallback(window, scroll_callback);
+    glfwSetKeyCallback(window, key_callback);
+    if (!validateMode)
+        glfwSetInputMode(window, GLFW_CURSOR, GLFW_CURSOR_DISABLED);
+
+    // glad: 加载OpenGL函数指针
+    // ---------------------------------------
+    if (!gladLoadGLLoader((GLADloadproc)glfwGetProcAddress))
+    {
+        cout << "Failed to initialize GLAD" << endl;
+        exit(EXIT_FAILURE);
+    }
+    glEnable(GL_DEPTH_TEST);
+    // 标准模式下的远平面，要能看到最远的平面对
+    camera.FarPlane = 1e6f;
+    glfwGetFramebufferSize(window, &fbWidth, &fbHeight);
+    cout << "glClipControl: " << (GLAD_GL_VERSION_4_5 || GLAD_GL_ARB_clip_control ? "available" : "not available") << endl;
+
+    // 定义编译着色器
+    Shader ourShader("6.1.coordinate_systems.vs", "reversed_z.fs");
+
+    // 单位正方形，位置 + 纹理坐标
+    float vertices[] = {
+            -0.5f, -0.5f, 0.0f,  0.0f, 0.0f,
+             0.5f, -0.5f, 0.0f,  1.0f, 0.0f,
+             0.5f,  0.5f, 0.0f,  1.0f, 1.0f,
+             0.5f,  0.5f, 0.0f,  1.0f, 1.0f,
+            -0.5f,  0.5f, 0.0f,  0.0f, 1.0f,
+            -0.5f, -0.5f, 0.0f,  0.0f, 0.0f
+    };
+
+    // 创建顶点缓冲和顶点数组
+    unsigned int VAO, VBO;
+    glGenVertexArrays(1, &VAO);
+    glGenBuffers(1, &VBO);
+
+    glBindVertexArray(VAO);
+    glBindBuffer(GL_ARRAY_BUFFER, VBO);
+    glBufferData(GL_ARRAY_BUFFER, sizeof(vertices), vertices, GL_STATIC_DRAW);
+
+    // 顶点位置
+    glVertexAttribPointer(0, 3, GL_FLOAT, GL_FALSE, 5 * sizeof(float), (void *)nullptr);
+    glEnableVertexAttribArray(0);
+    // 纹理坐标
+    glVertexAttribPointer(1, 2, GL_FLOAT, GL_FALSE, 5 * sizeof(float), (void *)(3 * sizeof(float)));
+    glEnableVertexAttribArray(1);
+
+    SceneTarget target;
+    createTarget(target, fbWidth, fbHeight);
+
+    if (validateMode) {
+        int failures = validate(ourShader, VAO, target);
+        destroyTarget(target);
+        glDeleteVertexArrays(1, &VAO);
+        glDeleteBuffers(1, &VBO);
+        glfwTerminate();
+        return failures == 0 ? EXIT_SUCCESS : EXIT_FAILURE;
+    }
+
+    // 渲染循环
+    // -----------
+    float titleTimer = 0.0f;
+    while (!glfwWindowShouldClose(window))
+    {
+        float currentFrame = glfwGetTime();
+        deltaTime = currentFrame - lastFrame;
+        lastFrame = currentFrame;
+
+        processInput(window);
+
+        if (fbResized) {
+            destroyTarget(target);
+            createTarget(target, fbWidth, fbHeight);
+            fbResized = false;
+        }
+        if (depthModeChanged) {
+            applyDepthMode(camera, depthMode);
+            depthModeChanged = false;
+        }
+
+        // 渲染到离屏缓冲
+        glBindFramebuffer(GL_FRAMEBUFFER, target.FBO);
+        glViewport(0, 0, fbWidth, fbHeight);
+        glClearColor(0.2f, 0.3f, 0.3f, 1.0f);
+        glClear(GL_COLOR_BUFFER_BIT | GL_DEPTH_BUFFER_BIT);
+        drawPairs(ourShader, camera, VAO, (float)fbWidth / (float)fbHeight);
+
+        // 复制到默认帧缓冲
+        glBindFramebuffer(GL_READ_FRAMEBUFFER, target.FBO);
+        glBindFramebuffer(GL_DRAW_FRAMEBUFFER, 0);
+        glBlitFramebuffer(0, 0, fbWidth, fbHeight, 0, 0, fbWidth, fbHeight, GL_COLOR_BUFFER_BIT, GL_NEAREST);
+        glBindFramebuffer(GL_FRAMEBUFFER, 0);
+
+        titleTimer += deltaTime;
+        if (titleTimer > 0.5f) {
+            titleTimer = 0.0f;
+            std::string title = std::string("Depth - ") + DEPTH_MODE_NAMES[depthMode] +
+                                " - " + std::to_string(deltaTime * 1000.0f) + " ms";
+            glfwSetWindowTitle(window, title.c_str());
+        }
+
+        // glfw: 交换颜色缓冲，检测事件
+        // -------------------------------------------------------------------------------
+        glfwSwapBuffers(window);
+        glfwPollEvents();
+    }
+
+    glDeleteVertexArrays(1, &VAO);
+    glDeleteBuffers(1, &VBO);
+    destroyTarget(target);
+
+    glfwTerminate();
+    return 0;
+}
+
+// 切换深度模式，同时设置摄像机的投影矩阵和GL的深度状态
+// ---------------------------------------------------------------------------------------------------------
+void applyDepthMode(Camera &cam, int mode)
+{
+    if (mode == STANDARD_DEPTH)
+        cam.DisableReversedZ();
+    else
+        cam.EnableReversedZ(mode == REVERSED_Z);
+}
+
+// 每对平面放在屏幕上的一列，大小随距离缩放，在屏幕上看起来一样大；先画后面的绿色平面，再画前面的红色平面
+// 深度相同时红色平面通不过 GL_LESS / GL_GREATER 测试，绿色就会露出来
+// ---------------------------------------------------------------------------------------------------------
+void drawPairs(Shader &shader, const Camera &cam, unsigned int VAO, float aspectRatio)
+{
+    shader.use();
+    shader.setMat4("projection", cam.GetProjectionMatrix(aspectRatio));
+    shader.setMat4("view", cam.GetViewMatrix());
+    glBindVertexArray(VAO);
+
+    // 屏幕空间中每列的宽度和平面边长（NDC单位）换算成世界空间
+    float tanHalfFov = tan(glm::radians(cam.Zoom) * 0.5f);
+    for (int i = 0; i < PAIR_COUNT; i++) {
+        float ndcX = -0.8f + 1.6f * i / (PAIR_COUNT - 1);
+        for (int k = 0; k < 2; k++) {
+            float distance = DISTANCES[i] * (k == 0 ? 1.0f + GAP : 1.0f);
+            glm::mat4 model = glm::mat4(1.0f);
+            model = glm::translate(model, glm::vec3(ndcX * distance * tanHalfFov * aspectRatio, 0.0f, -distance));
+            model = glm::scale(model, glm::vec3(0.3f * distance * tanHalfFov));
+            shader.setMat4("model", model);
+            shader.setVec3("color", k == 0 ? glm::vec3(0.0f, 1.0f, 0.0f) : glm::vec3(1.0f, 0.0f, 0.0f));
+            glDrawArrays(GL_TRIANGLES, 0, 6);
+        }
+    }
+}
+
+// 三种深度模式各渲染一次，读回颜色统计每一列中的绿色像素
+// 反转深度 + glClipControl 在所有距离上都不能出现绿色；其余两种模式只打印结果用于对比
+// ---------------------------------------------------------------------------------------------------------
+int validate(Shader &shader, unsigned int VAO, SceneTarget &target)
+{
+    using std::cout;
+    using std::endl;
+
+    glBindFramebuffer(GL_FRAMEBUFFER, target.FBO);
+    glViewport(0, 0, fbWidth, fbHeight);
+    std::vector<unsigned char> pixels((size_t)fbWidth * fbHeight * 4);
+
+    int failures = 0;
+    for (int mode = 0; mode < DEPTH_MODE_COUNT; mode++) {
+        Camera cam(glm::vec3(0.0f, 0.0f, 0.0f));
+        cam.FarPlane = 1e6f;
+        applyDepthMode(cam, mode);
+        if (mode == REVERSED_Z && !cam.ClipDepthZeroToOne) {
+            cout << DEPTH_MODE_NAMES[mode] << ": skipped, glClipControl not available" << endl;
+            continue;
+        }
+
+        glClearColor(0.2f, 0.3f, 0.3f, 1.0f);
+        glClear(GL_COLOR_BUFFER_BIT | GL_DEPTH_BUFFER_BIT);
+        drawPairs(shader, cam, VAO, (float)fbWidth / (float)fbHeight);
+        glReadPixels(0, 0, fbWidth, fbHeight, GL_RGBA, GL_UNSIGNED_BYTE, pixels.data());
+
+        // 每列对应一对平面
+        std::vector<int> green(PAIR_COUNT, 0), red(PAIR_COUNT, 0);
+        for (int y = 0; y < fbHeight; y++) {
+            for (int x = 0; x < fbWidth; x++) {
+                const unsigned char *p = &pixels[((size_t)y * fbWidth + x) * 4];
+                int column = x * PAIR_COUNT / fbWidth;
+                if (p[1] > 128 && p[0] < 128)
+                    green[column]++;
+                else if (p[0] > 128 && p[1] < 128)
+                    red[column]++;
+            }
+        }
+
+        cout << DEPTH_MODE_NAMES[mode] << ":" << endl;
+        bool ok = true;
+        for (int i = 0; i < PAIR_COUNT; i++) {
+            cout << "  distance " << DISTANCES[i] << ": " << green[i] << " z-fighting pixels of "
+                 << green[i] + red[i] << endl;
+            if (green[i] + red[i] == 0 || (mode == REVERSED_Z && green[i] != 0))
+                ok = false;
+        }
+        if (!ok) {
+            cout << "  FAILED" << endl;
+            failures++;
+        }
+    }
+    Camera().DisableReversedZ();
+    glBindFramebuffer(GL_FRAMEBUFFER, 0);
+    return failures;
+}
+
+void createTarget(SceneTarget &target, int width, int height)
+{
+    glGenFramebuffers(1, &target.FBO);
+    glBindFramebuffer(GL_FRAMEBUFFER, target.FBO);
+
+    glGenRenderbuffers(1, &target.ColorBuffer);
+    glBindRenderbuffer(GL_RENDERBUFFER, target.ColorBuffer);
+    glRenderbufferStorage(GL_RENDERBUFFER, GL_RGBA8, width, height);
+    glFramebufferRenderbuffer(GL_FRAMEBUFFER, GL_COLOR_ATTACHMENT0, GL_RENDERBUFFER, target.ColorBuffer);
+
+    // 反转深度要配合浮点深度缓冲，定点深度缓冲的精度是均匀分布的，反转没有意义
+    glGenRenderbuffers(1, &target.DepthBuffer);
+    glBindRenderbuffer(GL_RENDERBUFFER, target.DepthBuffer);
+    glRenderbufferStorage(GL_RENDERBUFFER, GL_DEPTH_COMPONENT32F, width, height);
+    glFramebufferRenderbuffer(GL_FRAMEBUFFER, GL_DEPTH_ATTACHMENT, GL_RENDERBUFFER, target.DepthBuffer);
+
+    if (glCheckFramebufferStatus(GL_FRAMEBUFFER) != GL_FRAMEBUFFER_COMPLETE)
+        std::cout << "Framebuffer is not complete" << std::endl;
+    glBindFramebuffer(GL_FRAMEBUFFER, 0);
+}
+
+void destroyTarget(SceneTarget &target)
+{
+    glDeleteFramebuffers(1, &target.FBO);
+    glDeleteRenderbuffers(1, &target.ColorBuffer);
+    glDeleteRenderbuffers(1, &target.DepthBuffer);
+    target = SceneTarget();
+}
+
+// process all input: query GLFW whether relevant keys are pressed/released this frame and react accordingly
+// ---------------------------------------------------------------------------------------------------------
+void processInput(GLFWwindow *window)
+{
+    if (glfwGetKey(window, GLFW_KEY_ESCAPE) == GLFW_PRESS)
+        glfwSetWindowShouldClose(window, true);
+
+    // 远处的平面需要更快的移动速度，按住Shift加速
+    float speed = glfwGetKey(window, GLFW_KEY_LEFT_SHIFT) == GLFW_PRESS ? 1000.0f : 1.0f;
+    if (glfwGetKey(window, GLFW_KEY_W) == GLFW_PRESS)
+        camera.ProcessKeyboard(FORWARD, deltaTime * speed);
+    if (glfwGetKey(window, GLFW_KEY_S) == GLFW_PRESS)
+        camera.ProcessKeyboard(BACKWARD, deltaTime * speed);
+    if (glfwGetKey(window, GLFW_KEY_A) == GLFW_PRESS)
+        camera.ProcessKeyboard(LEFT, deltaTime * speed);
+    if (glfwGetKey(window, GLFW_KEY_D) == GLFW_PRESS)
+        camera.ProcessKeyboard(RIGHT, deltaTime * speed);
+}
+
+// 按键事件：Z切换深度模式
+// ---------------------------------------------------------------------------------------------------------
+void key_callback(GLFWwindow* window, int key, int scancode, int action, int mods)
+{
+    if (key == GLFW_KEY_Z && action == GLFW_PRESS) {
+        depthMode = (depthMode + 1) % DEPTH_MODE_COUNT;
+        depthModeChanged = true;
+    }
+}
+
+// glfw: whenever the window size changed (by OS or user resize) this callback function executes
+// ---------------------------------------------------------------------------------------------
+void framebuffer_size_callback(GLFWwindow* window, int width, int height)
+{
+    fbWidth = width;
+    fbHeight = height;
+    fbResized = true;
+    glViewport(0, 0, width, height);
+}
+
+void mouse_callback(GLFWwindow* window, double xpos, double ypos) {
+    if (firstMouse) {
+        lastX = xpos;
+        lastY = ypos;
+        firstMouse = false;
+    }
+    float xoffset = xpos - lastX;
+    float yoffset = lastY - ypos;
+    lastX = xpos;
+    lastY = ypos;
+
+    camera.ProcessMouseMovement(xoffset, yoffset);
+}
+
+void scroll_callback(GLFWwindow* window, double xoffset, double yoffset)
+{
+    camera.ProcessMouseScroll(yoffset);
+}
@@ -0,0 +1,440 @@
+// 场景图示例：GRID x GRID 个“太阳系”，太阳 -> 行星 -> 卫星三层父子关系，每个节点画一个立方体
+// 只有动过的节点的子树会重新计算，世界矩阵按深度优先顺序连续存放，只上传变化的那一段
+// 按 1 / 2 / 3 切换：所有节点都转、只有行星自转（卫星跟着动）、只有第一个太阳系在转；按 Delete 删除一颗行星及其卫星
+//
+// 运行参数：
+//   --validate   不打开窗口，检查改父节点（包括挂到现在的父节点、祖父节点下）和删除子树之后的层级和世界矩阵
+#include <iostream>
+#include <vector>
+#include <cstring>
+#include <cmath>
+#include <glad/glad.h>
+#include <GLFW/glfw3.h>
+
+#include <glm/glm.hpp>
+#include <glm/gtc/matrix_transform.hpp>
+#include <glm/gtc/quaternion.hpp>
+#include <glm/gtc/type_ptr.hpp>
+
+
+#include <learnopengl/shader.h>
+#include <learnopengl/camera.h>
+#include <learnopengl/texture.h>
+#include <learnopengl/scene_graph.h>
+
+void framebuffer_size_callback(GLFWwindow* window, int width, int height);
+void mouse_callback(GLFWwindow* window, double xpos, double ypos);
+void scroll_callback(GLFWwindow* window, double xoffset, double yoffset);
+void key_callback(GLFWwindow* window, int key, int scancode, int action, int mods);
+void processInput(GLFWwindow *window);
+
+// 窗口大小
+const unsigned int SCR_WIDTH = 800;
+const unsigned int SCR_HEIGHT = 800;
+
+// 场景：GRID x GRID 个太阳系，每个有 PLANETS 颗行星，每颗行星有 MOONS 颗卫星
+const int GRID = 20;
+const int PLANETS = 6;
+const int MOONS = 3;
+const float SPACING = 16.0f;
+
+// camera
+Camera camera(glm::vec3(0.0f, 30.0f, 40.0f), glm::vec3(0.0f, 1.0f, 0.0f), -90.0f, -30.0f);
+
+bool firstMouse = true;
+double lastX = SCR_WIDTH / 2.0;
+double lastY = SCR_HEIGHT / 2.0;
+
+// timing
+float deltaTime = 0.0f;	// time between current frame and last frame
+float lastFrame = 0.0f;
+
+// 动画模式：1 全部，2 只有行星，3 只有第一个太阳系
+int animationMode = 1;
+bool deleteRequested = false;
+
+struct SolarSystem {
+    SceneHandle Sun;
+    std::vector<SceneHandle> Planets;
+};
+
+int validate();
+
+int main(int argc, char *argv[])
+{
+    using std::cout;
+    using std::endl;
+
+    if (argc > 1 && std::strcmp(argv[1], "--validate") == 0)
+        return validate() == 0 ? EXIT_SUCCESS : EXIT_FAILURE;
+
+    // glfw: 初始化设置
+    // ------------------------------
+    glfwInit();
+    glfwWindowHint(GLFW_CONTEXT_VERSION_MAJOR, 3);
+    glfwWindowHint(GLFW_CONTEXT_VERSION_MINOR, 3);
+    glfwWindowHint(GLFW_OPENGL_PROFILE, GLFW_OPENGL_CORE_PROFILE);
+
+    // glfw: 创建窗口
+    // --------------------
+    GLFWwindow* window = glfwCreateWindow(SCR_WIDTH, SCR_HEIGHT, "LearnOpenGL", nullptr, nullptr);
+    if (window == nullptr)
+    {
+        cout << "Failed to create GLFW window" << endl;
+        glfwTerminate();
+        exit(EXIT_FAILURE);
+    }
+    glfwMakeContextCurrent(window);     // 设置OpenGL上下文
+    glfwSetFramebufferSizeCallback(window, framebuffer_size_callback);
+    glfwSetCursorPosCallback(window, mouse_callback);
+    glfwSetScrollCallback(window, scroll_callback);
+    glfwSetKeyCallback(window, key_callback);
+    glfwSetInputMode(window, GLFW_CURSOR, GLFW_CURSOR_DISABLED);
+
+    // glad: 加载OpenGL函数指针
+    // ---------------------------------------
+    if (!gladLoadGLLoader((GLADloadproc)glfwGetProcAddress))
+    {
+        cout << "Failed to initialize GLAD" << endl;
+        exit(EXIT_FAILURE);
+    }
+    glEnable(GL_DEPTH_TEST);
+    camera.FarPlane = 500.0f;
+
+    // 定义编译着色器
+    Shader ourShader("transforms.vs", "6.1.coordinate_systems.fs");
+
+    // 定义顶点数据，包含位置、纹理坐标
+    float vertices[] = {        // 立方体的六个面
+            -0.5f, -0.5f, -0.5f,  0.0f, 0.0f,
+             0.5f, -0.5f, -0.5f,  1.0f, 0.0f,
+             0.5f,  0.5f, -0.5f,  1.0f, 1.0f,
+             0.5f,  0.5f, -0.5f,  1.0f, 1.0f,
+            -0.5f,  0.5f, -0.5f,  0.0f, 1.0f,
+            -0.5f, -0.5f, -0.5f,  0.0f, 0.0f,
+
+            -0.5f, -0.5f,  0.5f,  0.0f, 0.0f,
+             0.5f, -0.5f,  0.5f,  1.0f, 0.0f,
+             0.5f,  0.5f,  0.5f,  1.0f, 1.0f,
+             0.5f,  0.5f,  0.5f,  1.0f, 1.0f,
+            -0.5f,  0.5f,  0.5f,  0.0f, 1.0f,
+            -0.5f, -0.5f,  0.5f,  0.0f, 0.0f,
+
+            -0.5f,  0.5f,  0.5f,  1.0f, 0.0f,
+            -0.5f,  0.5f, -0.5f,  1.0f, 1.0f,
+            -0.5f, -0.5f, -0.5f,  0.0f, 1.0f,
+            -0.5f, -0.5f, -0.5f,  0.0f, 1.0f,
+            -0.5f, -0.5f,  0.5f,  0.0f, 0.0f,
+            -0.5f,  0.5f,  0.5f,  1.0f, 0.0f,
+
+             0.5f,  0.5f,  0.5f,  1.0f, 0.0f,
+             0.5f,  0.5f, -0.5f,  1.0f, 1.0f,
+             0.5f, -0.5f, -0.5f,  0.0f, 1.0f,
+             0.5f, -0.5f, -0.5f,  0.0f, 1.0f,
+             0.5f, -0.5f,  0.5f,  0.0f, 0.0f,
+             0.5f,  0.5f,  0.5f,  1.0f, 0.0f,
+
+            -0.5f, -0.5f, -0.5f,  0.0f, 1.0f,
+             0.5f, -0.5f, -0.5f,  1.0f, 1.0f,
+             0.5f, -0.5f,  0.5f,  1.0f, 0.0f,
+             0.5f, -0.5f,  0.5f,  1.0f, 0.0f,
+            -0.5f, -0.5f,  0.5f,  0.0f, 0.0f,
+            -0.5f, -0.5f, -0.5f,  0.0f, 1.0f,
+
+            -0.5f,  0.5f, -0.5f,  0.0f, 1.0f,
+             0.5f,  0.5f, -0.5f,  1.0f, 1.0f,
+             0.5f,  0.5f,  0.5f,  1.0f, 0.0f,
+             0.5f,  0.5f,  0.5f,  1.0f, 0.0f,
+            -0.5f,  0.5f,  0.5f,  0.0f, 0.0f,
+            -0.5f,  0.5f, -0.5f,  0.0f, 1.0f
+    };
+
+    // 建立层级：太阳在网格上，行星挂在太阳下面（太阳自转带动行星公转），卫星挂在行星下面
+    // 按深度优先顺序创建，节点总是追加在数组末尾
+    SceneGraph graph;
+    std::vector<SolarSystem> systems;
+    for (int z = 0; z < GRID; z++) {
+        for (int x = 0; x < GRID; x++) {
+            SolarSystem system;
+            system.Sun = graph.Create(glm::vec3((x - GRID / 2) * SPACING, 0.0f, -z * SPACING),
+                                      glm::quat(), glm::vec3(1.5f));
+            for (int p = 0; p < PLANETS; p++) {
+                float radius = 1.5f + p * 0.8f;
+                float phase = glm::radians(360.0f * p / PLANETS);
+                SceneHandle planet = graph.Create(glm::vec3(cos(phase) * radius, 0.0f, sin(phase) * radius),
+                                                  glm::quat(), glm::vec3(0.4f), system.Sun);
+                system.Planets.push_back(planet);
+                for (int m = 0; m < MOONS; m++) {
+                    float moonPhase = glm::radians(360.0f * m / MOONS);
+                    graph.Create(glm::vec3(cos(moonPhase) * 1.5f, 0.5f, sin(moonPhase) * 1.5f),
+                                 glm::quat(), glm::vec3(0.4f), planet);
+                }
+            }
+            systems.push_back(system);
+        }
+    }
+    graph.Update();
+    cout << "Nodes: " << graph.Count() << endl;
+
+    // 创建顶点缓冲和顶点数组
+    unsigned int VAO, VBO, instanceVBO;
+    glGenVertexArrays(1, &VAO);
+    glGenBuffers(1, &VBO);
+    glGenBuffers(1, &instanceVBO);
+
+    glBindVertexArray(VAO);
+    glBindBuffer(GL_ARRAY_BUFFER, VBO);
+    glBufferData(GL_ARRAY_BUFFER, sizeof(vertices), vertices, GL_STATIC_DRAW);
+
+    // 顶点位置
+    glVertexAttribPointer(0, 3, GL_FLOAT, GL_FALSE, 5 * sizeof(float), (void *)nullptr);
+    glEnableVertexAttribArray(0);
+    // 纹理坐标
+    glVertexAttribPointer(1, 2, GL_FLOAT, GL_FALSE, 5 * sizeof(float), (void *)(3 * sizeof(float)));
+    glEnableVertexAttribArray(1);
+
+    // 世界矩阵，每个节点一个实例，数组顺序就是场景图的深度优先顺序
+    glBindBuffer(GL_ARRAY_BUFFER, instanceVBO);
+    glBufferData(GL_ARRAY_BUFFER, graph.Count() * sizeof(glm::mat4), graph.WorldMatrices().data(), GL_DYNAMIC_DRAW);
+    for (int column = 0; column < 4; column++) {
+        glVertexAttribPointer(2 + column, 4, GL_FLOAT, GL_FALSE, sizeof(glm::mat4), (void *)(column * sizeof(glm::vec4)));
+        glEnableVertexAttribArray(2 + column);
+        glVertexAttribDivisor(2 + column, 1);
+    }
+
+    // 创建纹理
+    unsigned int textures[2];
+    const char *texturePaths[2] = {"container.jpg", "awesomeface.png"};
+    for (int i = 0; i < 2; i++)
+        textures[i] = LoadTexture(texturePaths[i]);
+
+    // 激活纹理
+    ourShader.use();
+    ourShader.setInt("texture1", 0);
+    ourShader.setInt("texture2", 1);
+
+    // 渲染循环
+    // -----------
+    float titleTimer = 0.0f;
+    unsigned int recomputed = 0;
+    while (!glfwWindowShouldClose(window))
+    {
+        float currentFrame = glfwGetTime();
+        deltaTime = currentFrame - lastFrame;
+        lastFrame = currentFrame;
+
+        processInput(window);
+
+        // 删除第一个太阳系的最后一颗行星，卫星随子树一起删除；之前保存的句柄失效，动画里会跳过它
+        if (deleteRequested) {
+            deleteRequested = false;
+            for (auto it = systems[0].Planets.rbegin(); it != systems[0].Planets.rend(); ++it) {
+                if (graph.Alive(*it)) {
+                    graph.Destroy(*it);
+                    break;
+                }
+            }
+        }
+
+        // 动画
+        glm::vec3 up(0.0f, 1.0f, 0.0f);
+        size_t animated = animationMode == 3 ? 1 : systems.size();
+        for (size_t s = 0; s < animated; s++) {
+            if (animationMode != 2)
+                graph.SetRotation(systems[s].Sun, glm::angleAxis(currentFrame * 0.5f, up));
+            for (SceneHandle planet : systems[s].Planets)
+                if (graph.Alive(planet))
+                    graph.SetRotation(planet, glm::angleAxis(currentFrame * 2.0f, up));
+        }
+
+        // 只重新计算动过的子树，只上传变化的那一段
+        unsigned int count = graph.Count();
+        recomputed = graph.Update();
+        unsigned int first, size;
+        if (graph.UpdatedRange(first, size)) {
+            glBindBuffer(GL_ARRAY_BUFFER, instanceVBO);
+            glBufferSubData(GL_ARRAY_BUFFER, first * sizeof(glm::mat4), size * sizeof(glm::mat4), &graph.WorldMatrices()[first]);
+        }
+
+        glClearColor(0.2f, 0.3f, 0.3f, 1.0f);
+        glClear(GL_COLOR_BUFFER_BIT | GL_DEPTH_BUFFER_BIT);
+
+        glActiveTexture(GL_TEXTURE0);
+        glBindTexture(GL_TEXTURE_2D, textures[0]);
+        glActiveTexture(GL_TEXTURE1);
+        glBindTexture(GL_TEXTURE_2D, textures[1]);
+
+        ourShader.use();
+        glm::mat4 projection = camera.GetProjectionMatrix((float)SCR_WIDTH / (float)SCR_HEIGHT);
+        ourShader.setMat4("projection", projection);
+        ourShader.setMat4("view", camera.GetViewMatrix());
+
+        glBindVertexArray(VAO);
+        glDrawArraysInstanced(GL_TRIANGLES, 0, 36, count);
+
+        titleTimer += deltaTime;
+        if (titleTimer > 0.5f) {
+            titleTimer = 0.0f;
+            std::string title = std::string("Scene Graph - ") + std::to_string(recomputed) + " / " +
+                                std::to_string(count) + " nodes recomputed - " + std::to_string(deltaTime * 1000.0f) + " ms";
+            glfwSetWindowTitle(window, title.c_str());
+        }
+
+        // glfw: 交换颜色缓冲，检测事件
+        // -------------------------------------------------------------------------------
+        glfwSwapBuffers(window);
+        glfwPollEvents();
+    }
+
+    glDeleteVertexArrays(1, &VAO);
+    glDeleteBuffers(1, &VBO);
+    glDeleteBuffers(1, &instanceVBO);
+    glDeleteTextures(2, textures);
+
+    glfwTerminate();
+    return 0;
+}
+
+// 沿父节点链逐层相乘得到的世界矩阵，作为参考
+// ---------------------------------------------------------------------------------------------------------
+glm::mat4 referenceWorld(const SceneGraph &graph, SceneHandle node)
+{
+    glm::mat4 local = glm::translate(glm::mat4(1.0f), graph.GetPosition(node)) * glm::mat4_cast(graph.GetRotation(node));
+    local = glm::scale(local, graph.GetScale(node));
+    SceneHandle parent = graph.GetParent(node);
+    return graph.Alive(parent) ? referenceWorld(graph, parent) * local : local;
+}
+
+// 所有活着的节点：世界矩阵和参考相同，父节点在子节点前面
+// ---------------------------------------------------------------------------------------------------------
+bool consistent(const SceneGraph &graph, const std::vector<SceneHandle> &alive)
+{
+    for (SceneHandle node : alive) {
+        if (!graph.Alive(node))
+            return false;
+        SceneHandle parent = graph.GetParent(node);
+        if (graph.Alive(parent) && graph.DenseIndex(parent) >= graph.DenseIndex(node))
+            return false;
+        glm::mat4 expected = referenceWorld(graph, node);
+        const glm::mat4 &world = graph.World(node);
+        for (int c = 0; c < 4; c++)
+            for (int r = 0; r < 4; r++)
+                if (std::fabs(expected[c][r] - world[c][r]) > 1e-4f)
+                    return false;
+    }
+    return true;
+}
+
+// 1. P{A, B{B1, B2}}：A 挂到自己现在的父节点 P 下（移动到 P 子树的末尾），之后移动 B，B1、B2 跟着动；删除 B 只删掉 B、B1、B2
+// 2. P{B{B1{C}}}：C 挂到祖父节点 B 下，再挂到 P 下，B1 挂到 P 下
+// ---------------------------------------------------------------------------------------------------------
+int validate()
+{
+    using std::cout;
+    using std::endl;
+    int failures = 0;
+    auto check = [&failures](bool ok) {
+        cout << (ok ? "OK" : "FAILED") << endl;
+        if (!ok)
+            failures++;
+    };
+
+    {
+        SceneGraph graph;
+        SceneHandle p = graph.Create();
+        SceneHandle a = graph.Create(glm::vec3(1.0f, 0.0f, 0.0f), glm::quat(), glm::vec3(1.0f), p);
+        SceneHandle b = graph.Create(glm::vec3(2.0f, 0.0f, 0.0f), glm::quat(), glm::vec3(1.0f), p);
+        SceneHandle b1 = graph.Create(glm::vec3(0.0f, 1.0f, 0.0f), glm::quat(), glm::vec3(1.0f), b);
+        SceneHandle b2 = graph.Create(glm::vec3(3.0f, 0.0f, 0.0f), glm::quat(), glm::vec3(1.0f), b);
+        graph.Update();
+        bool ok = graph.SetParent(a, p) && graph.GetParent(a) == p;
+        graph.SetPosition(b, glm::vec3(2.0f, 0.0f, 5.0f));
+        graph.Update();
+        ok = ok && consistent(graph, {p, a, b, b1, b2}) && graph.World(b2)[3][0] == 5.0f && graph.World(b2)[3][2] == 5.0f;
+        graph.Destroy(b);
+        graph.Update();
+        ok = ok && !graph.Alive(b) && !graph.Alive(b1) && !graph.Alive(b2) && graph.Count() == 2 && consistent(graph, {p, a});
+        cout << "reparent to own parent, then move and destroy a sibling subtree ";
+        check(ok);
+    }
+    {
+        SceneGraph graph;
+        SceneHandle p = graph.Create(glm::vec3(0.0f, 0.0f, -1.0f), glm::angleAxis(0.5f, glm::vec3(0.0f, 1.0f, 0.0f)));
+        SceneHandle b = graph.Create(glm::vec3(1.0f, 0.0f, 0.0f), glm::quat(), glm::vec3(2.0f), p);
+        SceneHandle b1 = graph.Create(glm::vec3(0.0f, 1.0f, 0.0f), glm::quat(), glm::vec3(1.0f), b);
+        SceneHandle c = graph.Create(glm::vec3(0.0f, 0.0f, 1.0f), glm::quat(), glm::vec3(1.0f), b1);
+        SceneHandle d = graph.Create(glm::vec3(4.0f, 0.0f, 0.0f), glm::quat(), glm::vec3(1.0f), b);
+        graph.Update();
+        bool ok = graph.SetParent(c, b) && graph.GetParent(c) == b;
+        graph.Update();
+        ok = ok && consistent(graph, {p, b, b1, c, d});
+        ok = ok && graph.SetParent(c, p) && graph.SetParent(b1, p) && !graph.SetParent(p, b);
+        graph.SetPosition(b, glm::vec3(-1.0f, 0.0f, 0.0f));
+        graph.Update();
+        ok = ok && consistent(graph, {p, b, b1, c, d}) && graph.GetParent(b1) == p && graph.GetParent(d) == b;
+        graph.Destroy(b);
+        ok = ok && graph.Alive(b1) && graph.Alive(c) && !graph.Alive(d) && graph.Count() == 3 && consistent(graph, {p, b1, c});
+        cout << "reparent to grandparent and great-grandparent ";
+        check(ok);
+    }
+
+    cout << (failures == 0 ? "scene graph OK" : "scene graph FAILED") << endl;
+    return failures;
+}
+
+// process all input: query GLFW whether relevant keys are pressed/released this frame and react accordingly
+// ---------------------------------------------------------------------------------------------------------
+void processInput(GLFWwindow *window)
+{
+    if (glfwGetKey(window, GLFW_KEY_ESCAPE) == GLFW_PRESS)
+        glfwSetWindowShouldClose(window, true);
+
+    if (glfwGetKey(window, GLFW_KEY_W) == GLFW_PRESS)
+        camera.ProcessKeyboard(FORWARD, deltaTime);
+    if (glfwGetKey(window, GLFW_KEY_S) == GLFW_PRESS)
+        camera.ProcessKeyboard(BACKWARD, deltaTime);
+    if (glfwGetKey(window, GLFW_KEY_A) == GLFW_PRESS)
+        camera.ProcessKeyboard(LEFT, deltaTime);
+    if (glfwGetKey(window, GLFW_KEY_D) == GLFW_PRESS)
+        camera.ProcessKeyboard(RIGHT, deltaTime);
+}
+
+void key_callback(GLFWwindow* window, int key, int scancode, int action, int mods)
+{
+    if (action != GLFW_PRESS)
+        return;
+    if (key == GLFW_KEY_1)
+        animationMode = 1;
+    if (key == GLFW_KEY_2)
+        animationMode = 2;
+    if (key == GLFW_KEY_3)
+        animationMode = 3;
+    if (key == GLFW_KEY_DELETE)
+        deleteRequested = true;
+}
+
+// glfw: whenever the window size changed (by OS or user resize) this callback function executes
+// ---------------------------------------------------------------------------------------------
+void framebuffer_size_callback(GLFWwindow* window, int width, int height)
+{
+    glViewport(0, 0, width, height);
+}
+
+void mouse_callback(GLFWwindow* window, double xpos, double ypos) {
+    if (firstMouse) {
+        lastX = xpos;
+        lastY = ypos;
+        firstMouse = false;
+    }
+    float xoffset = xpos - lastX;
+    float yoffset = lastY - ypos;
+    lastX = xpos;
+    lastY = ypos;
+
+    camera.ProcessMouseMovement(xoffset, yoffset);
+}
+
+void scroll_callback(GLFWwindow* window, double xoffset, double yoffset)
+{
+    camera.ProcessMouseScroll(yoffset);
+}
@@ -0,0 +1,623 @@
+// 软件光栅化示例：摄像机示例的场景（10个带两张纹理的立方体）同时用OpenGL和CPU上的 SoftwareRasterizer 渲染
+// 软件光栅化的结果上传到纹理再复制到窗口，两者的画面应该几乎一样
+// 按R键在软件光栅化和OpenGL之间切换，M键切换AVX2和标量路径，T键在单线程和所有线程之间切换，标题栏显示每帧的渲染时间
+//
+// 运行参数：
+//   --validate   隐藏窗口，在几个摄像机位置上用两种方式渲染并比较（SSIM + 逐像素差值），
+//                检查AVX2和标量、单线程和多线程的结果逐字节一致，用三角形扇检查光栅化没有裂缝也不会重复覆盖，并对比耗时
+#include <iostream>
+#include <cstring>
+#include <vector>
+#include <string>
+#include <chrono>
+#include <cmath>
+#include <glad/glad.h>
+#include <GLFW/glfw3.h>
+
+#include <glm/glm.hpp>
+#include <glm/gtc/matrix_transform.hpp>
+#include <glm/gtc/quaternion.hpp>
+#include <glm/gtc/type_ptr.hpp>
+
+#include <stb_image.h>
+#include <learnopengl/shader.h>
+#include <learnopengl/camera.h>
+#include <learnopengl/image_compare.h>
+#include <learnopengl/software_rasterizer.h>
+
+void framebuffer_size_callback(GLFWwindow* window, int width, int height);
+void mouse_callback(GLFWwindow* window, double xpos, double ypos);
+void scroll_callback(GLFWwindow* window, double xoffset, double yoffset);
+void key_callback(GLFWwindow* window, int key, int scancode, int action, int mods);
+void processInput(GLFWwindow *window);
+
+// 窗口大小
+const unsigned int SCR_WIDTH = 800;
+const unsigned int SCR_HEIGHT = 600;
+
+// camera
+Camera camera(glm::vec3(0.0f, 0.0f, 3.0f));
+
+bool firstMouse = true;
+double lastX = SCR_WIDTH / 2.0;
+double lastY = SCR_HEIGHT / 2.0;
+
+// timing
+float deltaTime = 0.0f;	// time between current frame and last frame
+float lastFrame = 0.0f;
+
+// 渲染方式
+bool softwareRendering = true;
+bool useSimd = true;
+bool allThreads = true;
+
+int fbWidth = SCR_WIDTH, fbHeight = SCR_HEIGHT;
+
+// 和摄像机示例相同的立方体：位置 + 纹理坐标
+const float cubeVertices[] = {
+        -0.5f, -0.5f, -0.5f,  0.0f, 0.0f,
+         0.5f, -0.5f, -0.5f,  1.0f, 0.0f,
+         0.5f,  0.5f, -0.5f,  1.0f, 1.0f,
+         0.5f,  0.5f, -0.5f,  1.0f, 1.0f,
+        -0.5f,  0.5f, -0.5f,  0.0f, 1.0f,
+        -0.5f, -0.5f, -0.5f,  0.0f, 0.0f,
+
+        -0.5f, -0.5f,  0.5f,  0.0f, 0.0f,
+         0.5f, -0.5f,  0.5f,  1.0f, 0.0f,
+         0.5f,  0.5f,  0.5f,  1.0f, 1.0f,
+         0.5f,  0.5f,  0.5f,  1.0f, 1.0f,
+        -0.5f,  0.5f,  0.5f,  0.0f, 1.0f,
+        -0.5f, -0.5f,  0.5f,  0.0f, 0.0f,
+
+        -0.5f,  0.5f,  0.5f,  1.0f, 0.0f,
+        -0.5f,  0.5f, -0.5f,  1.0f, 1.0f,
+        -0.5f, -0.5f, -0.5f,  0.0f, 1.0f,
+        -0.5f, -0.5f, -0.5f,  0.0f, 1.0f,
+        -0.5f, -0.5f,  0.5f,  0.0f, 0.0f,
+        -0.5f,  0.5f,  0.5f,  1.0f, 0.0f,
+
+         0.5f,  0.5f,  0.5f,  1.0f, 0.0f,
+         0.5f,  0.5f, -0.5f,  1.0f, 1.0f,
+         0.5f, -0.5f, -0.5f,  0.0f, 1.0f,
+         0.5f, -0.5f, -0.5f,  0.0f, 1.0f,
+         0.5f, -0.5f,  0.5f,  0.0f, 0.0f,
+         0.5f,  0.5f,  0.5f,  1.0f, 0.0f,
+
+        -0.5f, -0.5f, -0.5f,  0.0f, 1.0f,
+         0.5f, -0.5f, -0.5f,  1.0f, 1.0f,
+         0.5f, -0.5f,  0.5f,  1.0f, 0.0f,
+         0.5f, -0.5f,  0.5f,  1.0f, 0.0f,
+        -0.5f, -0.5f,  0.5f,  0.0f, 0.0f,
+        -0.5f, -0.5f, -0.5f,  0.0f, 1.0f,
+
+        -0.5f,  0.5f, -0.5f,  0.0f, 1.0f,
+         0.5f,  0.5f, -0.5f,  1.0f, 1.0f,
+         0.5f,  0.5f,  0.5f,  1.0f, 0.0f,
+         0.5f,  0.5f,  0.5f,  1.0f, 0.0f,
+        -0.5f,  0.5f,  0.5f,  0.0f, 0.0f,
+        -0.5f,  0.5f, -0.5f,  0.0f, 1.0f
+};
+
+// 世界空间坐标
+const glm::vec3 cubePositions[] = {
+        glm::vec3( 0.0f,  0.0f,  0.0f),
+        glm::vec3( 2.0f,  5.0f, -15.0f),
+        glm::vec3(-1.5f, -2.2f, -2.5f),
+        glm::vec3(-3.8f, -2.0f, -12.3f),
+        glm::vec3( 2.4f, -0.4f, -3.5f),
+        glm::vec3(-1.7f,  3.0f, -7.5f),
+        glm::vec3( 1.3f, -2.0f, -2.5f),
+        glm::vec3( 1.5f,  2.0f, -2.5f),
+        glm::vec3( 1.5f,  0.2f, -1.5f),
+        glm::vec3(-1.3f,  1.0f, -1.5f)
+};
+const int CUBE_COUNT = sizeof(cubePositions) / sizeof(cubePositions[0]);
+
+// 校验用的摄像机位置，最后一个紧贴第一个立方体的正面，正面在近平面之前被整个裁掉，侧面和近平面相交
+struct View {
+    const char *Name;
+    glm::vec3 Position;
+    float Yaw, Pitch, Zoom;
+};
+const View VIEWS[] = {
+        {"front",   glm::vec3(0.0f, 0.0f, 3.0f),    -90.0f,   0.0f, 45.0f},
+        {"side",    glm::vec3(6.0f, 1.0f, -4.0f),  -180.0f, -10.0f, 45.0f},
+        {"above",   glm::vec3(0.0f, 12.0f, -5.0f),  -90.0f, -80.0f, 60.0f},
+        {"zoomed",  glm::vec3(0.0f, 0.0f, 3.0f),    -95.0f,   5.0f, 20.0f},
+        {"close",   glm::vec3(0.3f, 0.1f, 0.55f),  -100.0f,   0.0f, 45.0f}
+};
+const int VIEW_COUNT = sizeof(VIEWS) / sizeof(VIEWS[0]);
+
+// 通过的条件：两种光栅化的顶点变换和对齐的舍入不同，像素中心几乎正好在轮廓边上时可能一边画了、一边没画，
+// 这样的单个像素就能让所在窗口的SSIM降到0.5以下，所以窗口SSIM的要求很低，主要看平均SSIM和差别明显的像素比例
+const double MIN_MEAN_SSIM = 0.99;
+const double MIN_WINDOW_SSIM = 0.3;
+const int DIFF_THRESHOLD = 24;
+const double MAX_DIFF_FRACTION = 0.0002;
+
+// 场景用到的GL对象和软件纹理
+struct Scene {
+    Shader *Program;
+    unsigned int VAO;
+    unsigned int Textures[2];
+    SoftwareTexture SoftwareTextures[2];
+    std::vector<glm::mat4> Models;
+};
+
+void drawGL(const Scene &scene, const Camera &cam, float aspectRatio);
+void drawSoftware(const Scene &scene, SoftwareRasterizer &rasterizer, const Camera &cam, float aspectRatio);
+int validate(const Scene &scene);
+
+int main(int argc, char *argv[])
+{
+    using std::cout;
+    using std::endl;
+
+    bool validateMode = argc > 1 && std::strcmp(argv[1], "--validate") == 0;
+
+    // glfw: 初始化设置
+    // ------------------------------
+    glfwInit();
+    glfwWindowHint(GLFW_CONTEXT_VERSION_MAJOR, 3);
+    glfwWindowHint(GLFW_CONTEXT_VERSION_MINOR, 3);
+    glfwWindowHint(GLFW_OPENGL_PROFILE, GLFW_OPENGL_CORE_PROFILE);
+    if (validateMode)
+        glfwWindowHint(GLFW_VISIBLE, GLFW_FALSE);
+
+    // glfw: 创建窗口
+    // --------------------
+    GLFWwindow* window = glfwCreateWindow(SCR_WIDTH, SCR_HEIGHT, "LearnOpenGL", nullptr, nullptr);
+    if (window == nullptr)
+    {
+        cout << "Failed to create GLFW window" << endl;
+        glfwTerminate();
+        exit(EXIT_FAILURE);
+    }
+    glfwMakeContextCurrent(window);     // 设置OpenGL上下文
+    glfwSetFramebufferSizeCallback(window, framebuffer_size_callback);
+    glfwSetCursorPosCallback(window, mouse_callback);
+    glfwSetScrollCallback(window, scroll_callback);
+    glfwSetKeyCallback(window, key_callback);
+    if (!validateMode)
+        glfwSetInputMode(window, GLFW_CURSOR, GLFW_CURSOR_DISABLED);
+
+    // glad: 加载OpenGL函数指针
+    // ---------------------------------------
+    if (!gladLoadGLLoader((GLADloadproc)glfwGetProcAddress))
+    {
+        cout << "Failed to initialize GLAD" << endl;
+        exit(EXIT_FAILURE);
+    }
+    glEnable(GL_DEPTH_TEST);
+    glfwGetFramebufferSize(window, &fbWidth, &fbHeight);
+    cout << "renderer: " << glGetString(GL_RENDERER) << endl;
+    cout << "software rasterizer: " << (SoftwareRasterizer::HasAvx2() ? "AVX2" : "scalar") << ", "
+         << std::thread::hardware_concurrency() << " hardware threads" << endl;
+
+    // 定义编译着色器
+    Shader ourShader("6.1.coordinate_systems.vs", "6.1.coordinate_systems.fs");
+
+    Scene scene;
+    scene.Program = &ourShader;
+    for (int i = 0; i < CUBE_COUNT; i++) {
+        glm::mat4 model = glm::translate(glm::mat4(1.0f), cubePositions[i]);
+        model = model * glm::mat4_cast(glm::angleAxis(glm::radians(20.0f * i), glm::normalize(glm::vec3(1.0f, 0.3f, 0.5f))));
+        scene.Models.push_back(model);
+    }
+
+    // 创建顶点缓冲和顶点数组
+    unsigned int VBO;
+    glGenVertexArrays(1, &scene.VAO);
+    glGenBuffers(1, &VBO);
+    glBindVertexArray(scene.VAO);
+    glBindBuffer(GL_ARRAY_BUFFER, VBO);
+    glBufferData(GL_ARRAY_BUFFER, sizeof(cubeVertices), cubeVertices, GL_STATIC_DRAW);
+    // 顶点位置
+    glVertexAttribPointer(0, 3, GL_FLOAT, GL_FALSE, 5 * sizeof(float), (void *)nullptr);
+    glEnableVertexAttribArray(0);
+    // 纹理坐标
+    glVertexAttribPointer(1, 2, GL_FLOAT, GL_FALSE, 5 * sizeof(float), (void *)(3 * sizeof(float)));
+    glEnableVertexAttribArray(1);
+
+    // 纹理：同一份图片数据同时创建GL纹理和软件纹理，GL纹理的设置和摄像机示例相同
+    const char *texturePaths[2] = {"container.jpg", "awesomeface.png"};
+    glGenTextures(2, scene.Textures);
+    stbi_set_flip_vertically_on_load(true);
+    for (int i = 0; i < 2; i++) {
+        glBindTexture(GL_TEXTURE_2D, scene.Textures[i]);
+        glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_WRAP_S, GL_REPEAT);
+        glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_WRAP_T, GL_REPEAT);
+        glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_MIN_FILTER, GL_LINEAR);
+        glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_MAG_FILTER, GL_LINEAR);
+        int width, height, nrChannels;
+        unsigned char *data = stbi_load(texturePaths[i], &width, &height, &nrChannels, 0);
+        if (data) {
+            GLenum format = nrChannels == 4 ? GL_RGBA : nrChannels == 1 ? GL_RED : GL_RGB;
+            glPixelStorei(GL_UNPACK_ALIGNMENT, 1);
+            glTexImage2D(GL_TEXTURE_2D, 0, GL_RGB, width, height, 0, format, GL_UNSIGNED_BYTE, data);
+            glPixelStorei(GL_UNPACK_ALIGNMENT, 4);
+            glGenerateMipmap(GL_TEXTURE_2D);
+            scene.SoftwareTextures[i] = SoftwareTexture(data, width, height, nrChannels);
+        } else
+            cout << "Failed to load texture: " << texturePaths[i] << endl;
+        stbi_image_free(data);
+    }
+
+    ourShader.use();
+    ourShader.setInt("texture1", 0);
+    ourShader.setInt("texture2", 1);
+    ourShader.setBool("highlight", false);
+
+    if (validateMode) {
+        int failures = validate(scene);
+        glDeleteVertexArrays(1, &scene.VAO);
+        glDeleteBuffers(1, &VBO);
+        glDeleteTextures(2, scene.Textures);
+        glfwTerminate();
+        return failures == 0 ? EXIT_SUCCESS : EXIT_FAILURE;
+    }
+
+    // 软件光栅化的结果上传到这张纹理，通过只读的帧缓冲复制到窗口
+    SoftwareRasterizer rasterizer(fbWidth, fbHeight);
+    std::vector<unsigned char> pixels;
+    unsigned int uploadTexture, uploadFBO;
+    glGenTextures(1, &uploadTexture);
+    glGenFramebuffers(1, &uploadFBO);
+    int uploadWidth = 0, uploadHeight = 0;
+
+    // 渲染循环
+    // -----------
+    float titleTimer = 0.0f;
+    double frameMs = 0.0;
+    while (!glfwWindowShouldClose(window))
+    {
+        float currentFrame = glfwGetTime();
+        deltaTime = currentFrame - lastFrame;
+        lastFrame = currentFrame;
+
+        processInput(window);
+        if (fbWidth == 0 || fbHeight == 0) {
+            glfwPollEvents();
+            continue;
+        }
+
+        float aspectRatio = (float) fbWidth / (float) fbHeight;
+        auto start = std::chrono::high_resolution_clock::now();
+        if (softwareRendering) {
+            rasterizer.Resize(fbWidth, fbHeight);
+            rasterizer.Simd = useSimd;
+            rasterizer.Threads = allThreads ? 0 : 1;
+            drawSoftware(scene, rasterizer, camera, aspectRatio);
+            rasterizer.ReadPixels(pixels);
+            frameMs = std::chrono::duration<double, std::milli>(std::chrono::high_resolution_clock::now() - start).count();
+
+            glBindTexture(GL_TEXTURE_2D, uploadTexture);
+            if (uploadWidth != fbWidth || uploadHeight != fbHeight) {
+                uploadWidth = fbWidth;
+                uploadHeight = fbHeight;
+                glTexImage2D(GL_TEXTURE_2D, 0, GL_RGBA8, fbWidth, fbHeight, 0, GL_RGBA, GL_UNSIGNED_BYTE, nullptr);
+                glBindFramebuffer(GL_READ_FRAMEBUFFER, uploadFBO);
+                glFramebufferTexture2D(GL_READ_FRAMEBUFFER, GL_COLOR_ATTACHMENT0, GL_TEXTURE_2D, uploadTexture, 0);
+            }
+            glTexSubImage2D(GL_TEXTURE_2D, 0, 0, 0, fbWidth, fbHeight, GL_RGBA, GL_UNSIGNED_BYTE, pixels.data());
+            glBindFramebuffer(GL_READ_FRAMEBUFFER, uploadFBO);
+            glBindFramebuffer(GL_DRAW_FRAMEBUFFER, 0);
+            glBlitFramebuffer(0, 0, fbWidth, fbHeight, 0, 0, fbWidth, fbHeight, GL_COLOR_BUFFER_BIT, GL_NEAREST);
+            glBindFramebuffer(GL_FRAMEBUFFER, 0);
+        } else {
+            glViewport(0, 0, fbWidth, fbHeight);
+            glClearColor(0.2f, 0.3f, 0.3f, 1.0f);
+            glClear(GL_COLOR_BUFFER_BIT | GL_DEPTH_BUFFER_BIT);
+            drawGL(scene, camera, aspectRatio);
+            glFinish();
+            frameMs = std::chrono::duration<double, std::milli>(std::chrono::high_resolution_clock::now() - start).count();
+        }
+
+        titleTimer += deltaTime;
+        if (titleTimer > 0.5f) {
+            titleTimer = 0.0f;
+            std::string mode = softwareRendering ? std::string("software ") + (useSimd && SoftwareRasterizer::HasAvx2() ? "AVX2" : "scalar") +
+                                                   (allThreads ? ", all threads" : ", 1 thread") : "OpenGL";
+            std::string title = "Rasterizer - " + mode + " - " + std::to_string(frameMs) + " ms";
+            glfwSetWindowTitle(window, title.c_str());
+        }
+
+        // glfw: 交换颜色缓冲，检测事件
+        // -------------------------------------------------------------------------------
+        glfwSwapBuffers(window);
+        glfwPollEvents();
+    }
+
+    glDeleteTextures(1, &uploadTexture);
+    glDeleteFramebuffers(1, &uploadFBO);
+    glDeleteVertexArrays(1, &scene.VAO);
+    glDeleteBuffers(1, &VBO);
+    glDeleteTextures(2, scene.Textures);
+
+    glfwTerminate();
+    return 0;
+}
+
+// 用OpenGL画所有立方体，调用前绑定好帧缓冲并清空
+// ---------------------------------------------------------------------------------------------------------
+void drawGL(const Scene &scene, const Camera &cam, float aspectRatio)
+{
+    glActiveTexture(GL_TEXTURE0);
+    glBindTexture(GL_TEXTURE_2D, scene.Textures[0]);
+    glActiveTexture(GL_TEXTURE1);
+    glBindTexture(GL_TEXTURE_2D, scene.Textures[1]);
+    scene.Program->use();
+    scene.Program->setMat4("projection", cam.GetProjectionMatrix(aspectRatio));
+    scene.Program->setMat4("view", cam.GetViewMatrix());
+    glBindVertexArray(scene.VAO);
+    for (const glm::mat4 &model : scene.Models) {
+        scene.Program->setMat4("model", model);
+        glDrawArrays(GL_TRIANGLES, 0, 36);
+    }
+}
+
+// 用软件光栅化器画同样的场景，返回时结果已经在 rasterizer 中
+// ---------------------------------------------------------------------------------------------------------
+void drawSoftware(const Scene &scene, SoftwareRasterizer &rasterizer, const Camera &cam, float aspectRatio)
+{
+    SoftwareMaterial material;
+    material.Texture1 = &scene.SoftwareTextures[0];
+    material.Texture2 = &scene.SoftwareTextures[1];
+    material.Mix = 0.2f;
+    rasterizer.Clear(glm::vec4(0.2f, 0.3f, 0.3f, 1.0f));
+    rasterizer.SetMaterial(material);
+    const glm::mat4 &projection = cam.GetProjectionMatrix(aspectRatio);
+    const glm::mat4 &view = cam.GetViewMatrix();
+    for (const glm::mat4 &model : scene.Models)
+        rasterizer.Draw(cubeVertices, 36, model, view, projection);
+    rasterizer.Flush();
+}
+
+// 1. 每个摄像机位置用GL和软件光栅化各渲染一次，比较SSIM和逐像素差值
+// 2. AVX2和标量、单线程和多线程渲染的结果必须逐字节相同
+// 3. 不透明的三角形扇和两个三角形组成的全屏矩形：覆盖的像素数必须等于被画到的不同像素数（没有像素被画两次），
+//    扇形内部不能有没画到的像素（没有裂缝）
+// 4. 对比GL（glFinish后的时间）和软件光栅化各种配置的每帧耗时
+// ---------------------------------------------------------------------------------------------------------
+int validate(const Scene &scene)
+{
+    using std::cout;
+    using std::endl;
+    typedef std::chrono::high_resolution_clock Clock;
+
+    const int width = SCR_WIDTH, height = SCR_HEIGHT;
+    float aspectRatio = (float) width / (float) height;
+    int failures = 0;
+
+    // 离屏缓冲，大小和窗口无关
+    unsigned int FBO, colorBuffer, depthBuffer;
+    glGenFramebuffers(1, &FBO);
+    glBindFramebuffer(GL_FRAMEBUFFER, FBO);
+    glGenRenderbuffers(1, &colorBuffer);
+    glBindRenderbuffer(GL_RENDERBUFFER, colorBuffer);
+    glRenderbufferStorage(GL_RENDERBUFFER, GL_RGBA8, width, height);
+    glFramebufferRenderbuffer(GL_FRAMEBUFFER, GL_COLOR_ATTACHMENT0, GL_RENDERBUFFER, colorBuffer);
+    glGenRenderbuffers(1, &depthBuffer);
+    glBindRenderbuffer(GL_RENDERBUFFER, depthBuffer);
+    glRenderbufferStorage(GL_RENDERBUFFER, GL_DEPTH24_STENCIL8, width, height);
+    glFramebufferRenderbuffer(GL_FRAMEBUFFER, GL_DEPTH_STENCIL_ATTACHMENT, GL_RENDERBUFFER, depthBuffer);
+    if (glCheckFramebufferStatus(GL_FRAMEBUFFER) != GL_FRAMEBUFFER_COMPLETE)
+        cout << "Framebuffer is not complete" << endl;
+    glViewport(0, 0, width, height);
+
+    auto renderGL = [&](const Camera &cam, std::vector<unsigned char> &pixels) {
+        glClearColor(0.2f, 0.3f, 0.3f, 1.0f);
+        glClear(GL_COLOR_BUFFER_BIT | GL_DEPTH_BUFFER_BIT);
+        drawGL(scene, cam, aspectRatio);
+        pixels.resize((size_t) width * height * 4);
+        glReadPixels(0, 0, width, height, GL_RGBA, GL_UNSIGNED_BYTE, pixels.data());
+    };
+    auto makeCamera = [](const View &v) {
+        Camera cam(v.Position, glm::vec3(0.0f, 1.0f, 0.0f), v.Yaw, v.Pitch);
+        cam.Zoom = v.Zoom;
+        return cam;
+    };
+
+    SoftwareRasterizer rasterizer(width, height);
+    std::vector<unsigned char> glPixels, swPixels, other;
+
+    // 1. 和GL比较
+    for (int i = 0; i < VIEW_COUNT; i++) {
+        Camera cam = makeCamera(VIEWS[i]);
+        renderGL(cam, glPixels);
+        drawSoftware(scene, rasterizer, cam, aspectRatio);
+        rasterizer.ReadPixels(swPixels);
+        ImageDifference diff = CompareImages(glPixels.data(), swPixels.data(), width, height, DIFF_THRESHOLD);
+        const SoftwareRasterizerStats &stats = rasterizer.Stats();
+        bool ok = diff.Ssim >= MIN_MEAN_SSIM && diff.MinSsim >= MIN_WINDOW_SSIM && diff.DiffFraction <= MAX_DIFF_FRACTION;
+        cout << "view " << VIEWS[i].Name << ": SSIM " << diff.Ssim << " (min " << diff.MinSsim << "), max diff " << diff.MaxDiff
+             << ", " << diff.DiffFraction * 100.0 << "% pixels differ; " << stats.Triangles << " triangles, "
+             << stats.Clipped << " clipped, " << stats.Culled << " culled, " << stats.BinEntries << " bin entries, "
+             << stats.PixelsShaded << " pixels shaded " << (ok ? "OK" : "FAILED") << endl;
+        if (!ok)
+            failures++;
+    }
+
+    // 2. 各种配置的结果逐字节相同
+    {
+        Camera cam = makeCamera(VIEWS[VIEW_COUNT - 1]);
+        rasterizer.Simd = true;
+        rasterizer.Threads = 0;
+        drawSoftware(scene, rasterizer, cam, aspectRatio);
+        rasterizer.ReadPixels(swPixels);
+        bool ok = true;
+        const struct { bool Simd; unsigned int Threads; } configs[] = {{false, 1}, {false, 0}, {true, 1}, {true, 3}};
+        for (const auto &config : configs) {
+            rasterizer.Simd = config.Simd;
+            rasterizer.Threads = config.Threads;
+            drawSoftware(scene, rasterizer, cam, aspectRatio);
+            rasterizer.ReadPixels(other);
+            ok = ok && other == swPixels;
+        }
+        rasterizer.Simd = true;
+        rasterizer.Threads = 0;
+        cout << "determinism: " << (SoftwareRasterizer::HasAvx2() ? "AVX2 and scalar" : "scalar only")
+             << ", 1 / 3 / all threads produce identical images " << (ok ? "OK" : "FAILED") << endl;
+        if (!ok)
+            failures++;
+    }
+
+    // 3. 没有裂缝、不重复覆盖：1x1的白色纹理，单位矩阵下直接给出NDC坐标
+    {
+        const unsigned char white[3] = {255, 255, 255};
+        SoftwareTexture whiteTexture(white, 1, 1, 3);
+        SoftwareMaterial material;
+        material.Texture1 = &whiteTexture;
+        const int SEGMENTS = 97;
+        // 圆心不在像素中心上，半径在x、y方向上换算成相同的像素数
+        glm::vec2 center(0.0123f, -0.0371f);
+        float radiusX = 0.8f / aspectRatio, radiusY = 0.8f;
+        std::vector<float> fan;
+        for (int s = 0; s < SEGMENTS; s++) {
+            float a0 = glm::radians(360.0f * s / SEGMENTS), a1 = glm::radians(360.0f * (s + 1) / SEGMENTS);
+            // 奇数的三角形反过来绕，两种方向都要正确处理
+            glm::vec2 p0 = center + glm::vec2(std::cos(a0) * radiusX, std::sin(a0) * radiusY);
+            glm::vec2 p1 = center + glm::vec2(std::cos(a1) * radiusX, std::sin(a1) * radiusY);
+            if (s % 2)
+                std::swap(p0, p1);
+            float triangle[15] = {center.x, center.y, 0.0f, 0.0f, 0.0f,
+                                  p0.x, p0.y, 0.0f, 0.0f, 0.0f,
+                                  p1.x, p1.y, 0.0f, 0.0f, 0.0f};
+            fan.insert(fan.end(), triangle, triangle + 15);
+        }
+        const float quad[30] = {-1.0f, -1.0f, 0.5f, 0.0f, 0.0f,   1.0f, -1.0f, 0.5f, 0.0f, 0.0f,   1.0f, 1.0f, 0.5f, 0.0f, 0.0f,
+                                 1.0f,  1.0f, 0.5f, 0.0f, 0.0f,  -1.0f,  1.0f, 0.5f, 0.0f, 0.0f,  -1.0f, -1.0f, 0.5f, 0.0f, 0.0f};
+        glm::mat4 identity(1.0f);
+
+        rasterizer.Clear(glm::vec4(0.0f, 0.0f, 0.0f, 1.0f));
+        rasterizer.SetMaterial(material);
+        rasterizer.Draw(fan.data(), SEGMENTS * 3, identity, identity, identity);
+        rasterizer.Flush();
+        rasterizer.ReadPixels(swPixels);
+        size_t painted = 0, holes = 0;
+        float centerX = (center.x * 0.5f + 0.5f) * width, centerY = (center.y * 0.5f + 0.5f) * height;
+        // 内接多边形的内切圆半径（像素）减去一个像素的余量
+        float inner = 0.8f * 0.5f * height * std::cos(glm::radians(180.0f / SEGMENTS)) - 1.0f;
+        for (int y = 0; y < height; y++) {
+            for (int x = 0; x < width; x++) {
+                bool white = swPixels[((size_t) y * width + x) * 4] == 255;
+                painted += white ? 1 : 0;
+                float dx = x + 0.5f - centerX, dy = y + 0.5f - centerY;
+                if (!white && dx * dx + dy * dy < inner * inner)
+                    holes++;
+            }
+        }
+        size_t fanCovered = rasterizer.Stats().PixelsCovered;
+
+        rasterizer.Clear(glm::vec4(0.0f, 0.0f, 0.0f, 1.0f));
+        rasterizer.SetMaterial(material);
+        rasterizer.Draw(quad, 6, identity, identity, identity);
+        rasterizer.Flush();
+        size_t quadCovered = rasterizer.Stats().PixelsCovered;
+
+        bool ok = fanCovered == painted && holes == 0 && quadCovered == (size_t) width * height;
+        cout << "watertight: fan of " << SEGMENTS << " triangles covers " << fanCovered << " pixels, " << painted
+             << " distinct, " << holes << " holes; full-screen quad covers " << quadCovered << " of " << width * height
+             << " pixels " << (ok ? "OK" : "FAILED") << endl;
+        if (!ok)
+            failures++;
+    }
+
+    // 4. 耗时
+    {
+        Camera cam = makeCamera(VIEWS[0]);
+        const int FRAMES = 20;
+        renderGL(cam, glPixels);
+        auto start = Clock::now();
+        for (int i = 0; i < FRAMES; i++) {
+            glClear(GL_COLOR_BUFFER_BIT | GL_DEPTH_BUFFER_BIT);
+            drawGL(scene, cam, aspectRatio);
+            glFinish();
+        }
+        double glMs = std::chrono::duration<double, std::milli>(Clock::now() - start).count() / FRAMES;
+        cout << "frame time: OpenGL (" << glGetString(GL_RENDERER) << ") " << glMs << " ms";
+
+        const struct { const char *Name; bool Simd; unsigned int Threads; } configs[] = {
+                {"scalar 1 thread", false, 1}, {"scalar all threads", false, 0},
+                {"AVX2 1 thread", true, 1}, {"AVX2 all threads", true, 0}};
+        for (const auto &config : configs) {
+            if (config.Simd && !SoftwareRasterizer::HasAvx2())
+                continue;
+            rasterizer.Simd = config.Simd;
+            rasterizer.Threads = config.Threads;
+            drawSoftware(scene, rasterizer, cam, aspectRatio);
+            start = Clock::now();
+            for (int i = 0; i < FRAMES; i++)
+                drawSoftware(scene, rasterizer, cam, aspectRatio);
+            double ms = std::chrono::duration<double, std::milli>(Clock::now() - start).count() / FRAMES;
+            cout << ", " << config.Name << " " << ms << " ms";
+        }
+        cout << endl;
+    }
+
+    glBindFramebuffer(GL_FRAMEBUFFER, 0);
+    glDeleteFramebuffers(1, &FBO);
+    glDeleteRenderbuffers(1, &colorBuffer);
+    glDeleteRenderbuffers(1, &depthBuffer);
+    cout << (failures == 0 ? "software rasterizer OK" : "software rasterizer FAILED") << endl;
+    return failures;
+}
+
+// process all input: query GLFW whether relevant keys are pressed/released this frame and react accordingly
+// ---------------------------------------------------------------------------------------------------------
+void processInput(GLFWwindow *window)
+{
+    if (glfwGetKey(window, GLFW_KEY_ESCAPE) == GLFW_PRESS)
+        glfwSetWindowShouldClose(window, true);
+
+    if (glfwGetKey(window, GLFW_KEY_W) == GLFW_PRESS)
+        camera.ProcessKeyboard(FORWARD, deltaTime);
+    if (glfwGetKey(window, GLFW_KEY_S) == GLFW_PRESS)
+        camera.ProcessKeyboard(BACKWARD, deltaTime);
+    if (glfwGetKey(window, GLFW_KEY_A) == GLFW_PRESS)
+        camera.ProcessKeyboard(LEFT, deltaTime);
+    if (glfwGetKey(window, GLFW_KEY_D) == GLFW_PRESS)
+        camera.ProcessKeyboard(RIGHT, deltaTime);
+}
+
+// 按键事件：R切换软件光栅化和OpenGL，M切换AVX2和标量，T切换线程数
+// ---------------------------------------------------------------------------------------------------------
+void key_callback(GLFWwindow* window, int key, int scancode, int action, int mods)
+{
+    if (action != GLFW_PRESS)
+        return;
+    if (key == GLFW_KEY_R)
+        softwareRendering = !softwareRendering;
+    else if (key == GLFW_KEY_M)
+        useSimd = !useSimd;
+    else if (key == GLFW_KEY_T)
+        allThreads = !allThreads;
+}
+
+// glfw: whenever the window size changed (by OS or user resize) this callback function executes
+// ---------------------------------------------------------------------------------------------
+void framebuffer_size_callback(GLFWwindow* window, int width, int height)
+{
+    fbWidth = width;
+    fbHeight = height;
+    glViewport(0, 0, width, height);
+}
+
+void mouse_callback(GLFWwindow* window, double xpos, double ypos) {
+    if (firstMouse) {
+        lastX = xpos;
+        lastY = ypos;
+        firstMouse = false;
+    }
+    float xoffset = xpos - lastX;
+    float yoffset = lastY - ypos;
+    lastX = xpos;
+    lastY = ypos;
+
+    camera.ProcessMouseMovement(xoffset, yoffset);
+}
+
+void scroll_callback(GLFWwindow* window, double xoffset, double yoffset)
+{
+    camera.ProcessMouseScroll(yoffset);
+}
@@ -0,0 +1,12 @@
+#version 330 core
+out vec4 FragColor;
+
+in vec2 TexCoord;
+in vec4 Color;
+
+// 点阵字体，R通道是覆盖率；最后一个格子是实心的，用来画矩形和图表
+uniform sampler2D font;
+
+void main() {
+	FragColor = vec4(Color.rgb, Color.a * texture(font, TexCoord).r);
+}
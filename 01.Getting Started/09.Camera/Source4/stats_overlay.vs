@@ -0,0 +1,17 @@
+#version 330 core
+// 叠加显示：位置以像素为单位，原点在左上角
+layout (location = 0) in vec2 aPos;
+layout (location = 1) in vec2 aTexCoord;
+layout (location = 2) in vec4 aColor;
+
+out vec2 TexCoord;
+out vec4 Color;
+
+uniform vec2 screenSize;
+
+void main() {
+	vec2 ndc = aPos / screenSize * 2.0f - 1.0f;
+	gl_Position = vec4(ndc.x, -ndc.y, 0.0f, 1.0f);
+	TexCoord = aTexCoord;
+	Color = aColor;
+}
@@ -0,0 +1,404 @@
+// 批量变换示例：GRID x GRID 个旋转的立方体，TransformSystem 用SIMD计算模型矩阵，直接写进映射出来的实例缓冲
+// 只有变换改变过的立方体会重新计算和上传，按 1 / 2 / 3 切换全部旋转、10%旋转、全部静止
+//
+// 运行参数：
+//   --validate   隐藏窗口，部分更新几次实例缓冲后读回，和逐个物体 glm::translate + glm::rotate 的结果对比
+#include <iostream>
+#include <cstring>
+#include <vector>
+#include <chrono>
+#include <cmath>
+#include <algorithm>
+#include <glad/glad.h>
+#include <GLFW/glfw3.h>
+
+#include <glm/glm.hpp>
+#include <glm/gtc/matrix_transform.hpp>
+#include <glm/gtc/quaternion.hpp>
+#include <glm/gtc/type_ptr.hpp>
+
+
+#include <learnopengl/shader.h>
+#include <learnopengl/camera.h>
+#include <learnopengl/texture.h>
+#include <learnopengl/transforms.h>
+
+void framebuffer_size_callback(GLFWwindow* window, int width, int height);
+void mouse_callback(GLFWwindow* window, double xpos, double ypos);
+void scroll_callback(GLFWwindow* window, double xoffset, double yoffset);
+void key_callback(GLFWwindow* window, int key, int scancode, int action, int mods);
+void processInput(GLFWwindow *window);
+
+// 窗口大小
+const unsigned int SCR_WIDTH = 800;
+const unsigned int SCR_HEIGHT = 800;
+
+// 场景：GRID x GRID 个立方体
+const int GRID = 100;
+const float SPACING = 2.0f;
+
+// camera
+Camera camera(glm::vec3(0.0f, 10.0f, 20.0f), glm::vec3(0.0f, 1.0f, 0.0f), -90.0f, -20.0f);
+
+bool firstMouse = true;
+double lastX = SCR_WIDTH / 2.0;
+double lastY = SCR_HEIGHT / 2.0;
+
+// timing
+float deltaTime = 0.0f;	// time between current frame and last frame
+float lastFrame = 0.0f;
+
+// 每帧旋转的立方体比例
+float spinningFraction = 1.0f;
+
+struct Spin {
+    glm::vec3 Axis;
+    float Speed;        // 角度/秒
+};
+
+// 设置第i个立方体在time时刻的旋转
+void setSpin(TransformSystem &transforms, const std::vector<Spin> &spins, unsigned int i, float time);
+// 把脏物体的矩阵写进实例缓冲，只映射脏的那一段
+unsigned int uploadTransforms(TransformSystem &transforms, unsigned int instanceVBO);
+int validate(TransformSystem &transforms, const std::vector<Spin> &spins, unsigned int instanceVBO);
+
+int main(int argc, char *argv[])
+{
+    using std::cout;
+    using std::endl;
+
+    bool validateMode = argc > 1 && std::strcmp(argv[1], "--validate") == 0;
+
+    // glfw: 初始化设置
+    // ------------------------------
+    glfwInit();
+    glfwWindowHint(GLFW_CONTEXT_VERSION_MAJOR, 3);
+    glfwWindowHint(GLFW_CONTEXT_VERSION_MINOR, 3);
+    glfwWindowHint(GLFW_OPENGL_PROFILE, GLFW_OPENGL_CORE_PROFILE);
+    if (validateMode)
+        glfwWindowHint(GLFW_VISIBLE, GLFW_FALSE);
+
+    // glfw: 创建窗口
+    // --------------------
+    GLFWwindow* window = glfwCreateWindow(SCR_WIDTH, SCR_HEIGHT, "LearnOpenGL", nullptr, nullptr);
+    if (window == nullptr)
+    {
+        cout << "Failed to create GLFW window" << endl;
+        glfwTerminate();
+        exit(EXIT_FAILURE);
+    }
+    glfwMakeContextCurrent(window);     // 设置OpenGL上下文
+    glfwSetFramebufferSizeCallback(window, framebuffer_size_callback);
+    glfwSetCursorPosCallback(window, mouse_callback);
+    glfwSetScrollCallback(window, scroll_callback);
+    glfwSetKeyCallback(window, key_callback);
+    if (!validateMode)
+        glfwSetInputMode(window, GLFW_CURSOR, GLFW_CURSOR_DISABLED);
+
+    // glad: 加载OpenGL函数指针
+    // ---------------------------------------
+    if (!gladLoadGLLoader((GLADloadproc)glfwGetProcAddress))
+    {
+        cout << "Failed to initialize GLAD" << endl;
+        exit(EXIT_FAILURE);
+    }
+    glEnable(GL_DEPTH_TEST);
+    camera.FarPlane = 500.0f;
+
+    // 定义编译着色器
+    Shader ourShader("transforms.vs", "6.1.coordinate_systems.fs");
+
+    // 定义顶点数据，包含位置、纹理坐标
+    float vertices[] = {        // 立方体的六个面
+            -0.5f, -0.5f, -0.5f,  0.0f, 0.0f,
+             0.5f, -0.5f, -0.5f,  1.0f, 0.0f,
+             0.5f,  0.5f, -0.5f,  1.0f, 1.0f,
+             0.5f,  0.5f, -0.5f,  1.0f, 1.0f,
+            -0.5f,  0.5f, -0.5f,  0.0f, 1.0f,
+            -0.5f, -0.5f, -0.5f,  0.0f, 0.0f,
+
+            -0.5f, -0.5f,  0.5f,  0.0f, 0.0f,
+             0.5f, -0.5f,  0.5f,  1.0f, 0.0f,
+             0.5f,  0.5f,  0.5f,  1.0f, 1.0f,
+             0.5f,  0.5f,  0.5f,  1.0f, 1.0f,
+            -0.5f,  0.5f,  0.5f,  0.0f, 1.0f,
+            -0.5f, -0.5f,  0.5f,  0.0f, 0.0f,
+
+            -0.5f,  0.5f,  0.5f,  1.0f, 0.0f,
+            -0.5f,  0.5f, -0.5f,  1.0f, 1.0f,
+            -0.5f, -0.5f, -0.5f,  0.0f, 1.0f,
+            -0.5f, -0.5f, -0.5f,  0.0f, 1.0f,
+            -0.5f, -0.5f,  0.5f,  0.0f, 0.0f,
+            -0.5f,  0.5f,  0.5f,  1.0f, 0.0f,
+
+             0.5f,  0.5f,  0.5f,  1.0f, 0.0f,
+             0.5f,  0.5f, -0.5f,  1.0f, 1.0f,
+             0.5f, -0.5f, -0.5f,  0.0f, 1.0f,
+             0.5f, -0.5f, -0.5f,  0.0f, 1.0f,
+             0.5f, -0.5f,  0.5f,  0.0f, 0.0f,
+             0.5f,  0.5f,  0.5f,  1.0f, 0.0f,
+
+            -0.5f, -0.5f, -0.5f,  0.0f, 1.0f,
+             0.5f, -0.5f, -0.5f,  1.0f, 1.0f,
+             0.5f, -0.5f,  0.5f,  1.0f, 0.0f,
+             0.5f, -0.5f,  0.5f,  1.0f, 0.0f,
+            -0.5f, -0.5f,  0.5f,  0.0f, 0.0f,
+            -0.5f, -0.5f, -0.5f,  0.0f, 1.0f,
+
+            -0.5f,  0.5f, -0.5f,  0.0f, 1.0f,
+             0.5f,  0.5f, -0.5f,  1.0f, 1.0f,
+             0.5f,  0.5f,  0.5f,  1.0f, 0.0f,
+             0.5f,  0.5f,  0.5f,  1.0f, 0.0f,
+            -0.5f,  0.5f,  0.5f,  0.0f, 0.0f,
+            -0.5f,  0.5f, -0.5f,  0.0f, 1.0f
+    };
+
+    // 立方体铺在xz平面上，每个立方体有自己的旋转轴和转速
+    TransformSystem transforms;
+    std::vector<Spin> spins;
+    for (int z = 0; z < GRID; z++) {
+        for (int x = 0; x < GRID; x++) {
+            glm::vec3 position((x - GRID / 2) * SPACING, 0.0f, -z * SPACING);
+            transforms.Add(position);
+            float h = (float) (x * 7 + z * 13);
+            spins.push_back({glm::normalize(glm::vec3(sin(h), 1.0f, cos(h * 0.7f))), 30.0f + (x * 31 + z * 17) % 90});
+        }
+    }
+    for (unsigned int i = 0; i < transforms.Count(); i++)
+        setSpin(transforms, spins, i, 0.0f);
+    cout << "Objects: " << transforms.Count() << endl;
+    // AVX路径只在 -DLEARNOPENGL_ENABLE_AVX2=ON 时编译进来
+#if defined(LEARNOPENGL_TRANSFORMS_AVX)
+    cout << "simd path: AVX, 8 objects per group" << endl;
+#elif defined(LEARNOPENGL_TRANSFORMS_SSE)
+    cout << "simd path: SSE2, 4 objects per group" << endl;
+#else
+    cout << "simd path: scalar fallback" << endl;
+#endif
+
+    // 创建顶点缓冲和顶点数组
+    unsigned int VAO, VBO, instanceVBO;
+    glGenVertexArrays(1, &VAO);
+    glGenBuffers(1, &VBO);
+    glGenBuffers(1, &instanceVBO);
+
+    glBindVertexArray(VAO);
+    glBindBuffer(GL_ARRAY_BUFFER, VBO);
+    glBufferData(GL_ARRAY_BUFFER, sizeof(vertices), vertices, GL_STATIC_DRAW);
+
+    // 顶点位置
+    glVertexAttribPointer(0, 3, GL_FLOAT, GL_FALSE, 5 * sizeof(float), (void *)nullptr);
+    glEnableVertexAttribArray(0);
+    // 纹理坐标
+    glVertexAttribPointer(1, 2, GL_FLOAT, GL_FALSE, 5 * sizeof(float), (void *)(3 * sizeof(float)));
+    glEnableVertexAttribArray(1);
+
+    // 模型矩阵，每个实例一个，mat4属性占4个location
+    glBindBuffer(GL_ARRAY_BUFFER, instanceVBO);
+    glBufferData(GL_ARRAY_BUFFER, transforms.Count() * sizeof(glm::mat4), nullptr, GL_DYNAMIC_DRAW);
+    for (int column = 0; column < 4; column++) {
+        glVertexAttribPointer(2 + column, 4, GL_FLOAT, GL_FALSE, sizeof(glm::mat4), (void *)(column * sizeof(glm::vec4)));
+        glEnableVertexAttribArray(2 + column);
+        glVertexAttribDivisor(2 + column, 1);
+    }
+    uploadTransforms(transforms, instanceVBO);
+
+    if (validateMode) {
+        int failures = validate(transforms, spins, instanceVBO);
+        glDeleteVertexArrays(1, &VAO);
+        glDeleteBuffers(1, &VBO);
+        glDeleteBuffers(1, &instanceVBO);
+        glfwTerminate();
+        return failures == 0 ? EXIT_SUCCESS : EXIT_FAILURE;
+    }
+
+    // 创建纹理
+    unsigned int textures[2];
+    const char *texturePaths[2] = {"container.jpg", "awesomeface.png"};
+    for (int i = 0; i < 2; i++)
+        textures[i] = LoadTexture(texturePaths[i]);
+
+    // 激活纹理
+    ourShader.use();
+    ourShader.setInt("texture1", 0);
+    ourShader.setInt("texture2", 1);
+
+    // 渲染循环
+    // -----------
+    float titleTimer = 0.0f;
+    while (!glfwWindowShouldClose(window))
+    {
+        float currentFrame = glfwGetTime();
+        deltaTime = currentFrame - lastFrame;
+        lastFrame = currentFrame;
+
+        processInput(window);
+
+        // 动画：按比例选取一部分立方体旋转，其余的保持不变，不会被重新计算
+        unsigned int spinning = (unsigned int) (transforms.Count() * spinningFraction);
+        for (unsigned int i = 0; i < spinning; i++)
+            setSpin(transforms, spins, i, currentFrame);
+        auto start = std::chrono::high_resolution_clock::now();
+        unsigned int updated = uploadTransforms(transforms, instanceVBO);
+        double updateMs = std::chrono::duration<double, std::milli>(std::chrono::high_resolution_clock::now() - start).count();
+
+        glClearColor(0.2f, 0.3f, 0.3f, 1.0f);
+        glClear(GL_COLOR_BUFFER_BIT | GL_DEPTH_BUFFER_BIT);
+
+        glActiveTexture(GL_TEXTURE0);
+        glBindTexture(GL_TEXTURE_2D, textures[0]);
+        glActiveTexture(GL_TEXTURE1);
+        glBindTexture(GL_TEXTURE_2D, textures[1]);
+
+        ourShader.use();
+        glm::mat4 projection = camera.GetProjectionMatrix((float)SCR_WIDTH / (float)SCR_HEIGHT);
+        ourShader.setMat4("projection", projection);
+        ourShader.setMat4("view", camera.GetViewMatrix());
+
+        glBindVertexArray(VAO);
+        glDrawArraysInstanced(GL_TRIANGLES, 0, 36, transforms.Count());
+
+        titleTimer += deltaTime;
+        if (titleTimer > 0.5f) {
+            titleTimer = 0.0f;
+            std::string title = std::string("Transforms - ") + std::to_string(updated) + " updated in " +
+                                std::to_string(updateMs) + " ms - " + std::to_string(deltaTime * 1000.0f) + " ms";
+            glfwSetWindowTitle(window, title.c_str());
+        }
+
+        // glfw: 交换颜色缓冲，检测事件
+        // -------------------------------------------------------------------------------
+        glfwSwapBuffers(window);
+        glfwPollEvents();
+    }
+
+    glDeleteVertexArrays(1, &VAO);
+    glDeleteBuffers(1, &VBO);
+    glDeleteBuffers(1, &instanceVBO);
+    glDeleteTextures(2, textures);
+
+    glfwTerminate();
+    return 0;
+}
+
+void setSpin(TransformSystem &transforms, const std::vector<Spin> &spins, unsigned int i, float time)
+{
+    transforms.SetRotation(i, glm::angleAxis(glm::radians(spins[i].Speed * time), spins[i].Axis));
+}
+
+unsigned int uploadTransforms(TransformSystem &transforms, unsigned int instanceVBO)
+{
+    unsigned int first, size;
+    if (!transforms.DirtyRange(first, size))
+        return 0;
+    glBindBuffer(GL_ARRAY_BUFFER, instanceVBO);
+    // 不加 GL_MAP_INVALIDATE_RANGE_BIT，范围内没变的矩阵保持原样
+    void *mapped = glMapBufferRange(GL_ARRAY_BUFFER, first * sizeof(glm::mat4), size * sizeof(glm::mat4), GL_MAP_WRITE_BIT);
+    if (!mapped)
+        return 0;
+    unsigned int updated = transforms.Update(static_cast<float *>(mapped), first);
+    glUnmapBuffer(GL_ARRAY_BUFFER);
+    return updated;
+}
+
+// 模拟几帧部分更新后读回实例缓冲，每个矩阵都要和 glm::translate + glm::rotate 的结果一致
+// ---------------------------------------------------------------------------------------------------------
+int validate(TransformSystem &transforms, const std::vector<Spin> &spins, unsigned int instanceVBO)
+{
+    using std::cout;
+    using std::endl;
+
+    const unsigned int count = transforms.Count();
+    std::vector<float> times(count, 0.0f);
+    const float frameTimes[] = {0.5f, 1.25f, 3.0f, 7.5f};
+    int frame = 0;
+    for (float time : frameTimes) {
+        // 每帧更新不同的一部分物体，包括不按8对齐的起点
+        unsigned int begin = (frame * 1237 + 3) % count;
+        unsigned int step = 2 + frame * 3;
+        for (unsigned int i = begin; i < count; i += step) {
+            setSpin(transforms, spins, i, time);
+            times[i] = time;
+        }
+        unsigned int updated = uploadTransforms(transforms, instanceVBO);
+        cout << "frame " << frame << ": " << updated << " matrices updated" << endl;
+        frame++;
+    }
+
+    std::vector<glm::mat4> uploaded(count);
+    glBindBuffer(GL_ARRAY_BUFFER, instanceVBO);
+    glGetBufferSubData(GL_ARRAY_BUFFER, 0, count * sizeof(glm::mat4), uploaded.data());
+
+    int failures = 0;
+    float maxError = 0.0f;
+    for (unsigned int i = 0; i < count; i++) {
+        glm::mat4 model = glm::mat4(1.0f);
+        model = glm::translate(model, transforms.GetPosition(i));
+        model = glm::rotate(model, glm::radians(spins[i].Speed * times[i]), spins[i].Axis);
+        float error = 0.0f;
+        for (int c = 0; c < 4; c++)
+            for (int r = 0; r < 4; r++)
+                error = std::max(error, std::fabs(model[c][r] - uploaded[i][c][r]));
+        maxError = std::max(maxError, error);
+        if (error > 1e-4f)
+            failures++;
+    }
+    cout << (failures ? "FAILED" : "OK") << ": " << count - failures << " / " << count
+         << " matrices match, max error " << maxError << endl;
+    return failures;
+}
+
+// process all input: query GLFW whether relevant keys are pressed/released this frame and react accordingly
+// ---------------------------------------------------------------------------------------------------------
+void processInput(GLFWwindow *window)
+{
+    if (glfwGetKey(window, GLFW_KEY_ESCAPE) == GLFW_PRESS)
+        glfwSetWindowShouldClose(window, true);
+
+    if (glfwGetKey(window, GLFW_KEY_W) == GLFW_PRESS)
+        camera.ProcessKeyboard(FORWARD, deltaTime);
+    if (glfwGetKey(window, GLFW_KEY_S) == GLFW_PRESS)
+        camera.ProcessKeyboard(BACKWARD, deltaTime);
+    if (glfwGetKey(window, GLFW_KEY_A) == GLFW_PRESS)
+        camera.ProcessKeyboard(LEFT, deltaTime);
+    if (glfwGetKey(window, GLFW_KEY_D) == GLFW_PRESS)
+        camera.ProcessKeyboard(RIGHT, deltaTime);
+}
+
+void key_callback(GLFWwindow* window, int key, int scancode, int action, int mods)
+{
+    if (action != GLFW_PRESS)
+        return;
+    if (key == GLFW_KEY_1)
+        spinningFraction = 1.0f;
+    if (key == GLFW_KEY_2)
+        spinningFraction = 0.1f;
+    if (key == GLFW_KEY_3)
+        spinningFraction = 0.0f;
+}
+
+// glfw: whenever the window size changed (by OS or user resize) this callback function executes
+// ---------------------------------------------------------------------------------------------
+void framebuffer_size_callback(GLFWwindow* window, int width, int height)
+{
+    glViewport(0, 0, width, height);
+}
+
+void mouse_callback(GLFWwindow* window, double xpos, double ypos) {
+    if (firstMouse) {
+        lastX = xpos;
+        lastY = ypos;
+        firstMouse = false;
+    }
+    float xoffset = xpos - lastX;
+    float yoffset = lastY - ypos;
+    lastX = xpos;
+    lastY = ypos;
+
+    camera.ProcessMouseMovement(xoffset, yoffset);
+}
+
+void scroll_callback(GLFWwindow* window, double xoffset, double yoffset)
+{
+    camera.ProcessMouseScroll(yoffset);
+}
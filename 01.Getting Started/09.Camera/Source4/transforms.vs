@@ -0,0 +1,14 @@
+#version 330 core
+layout (location = 0) in vec3 aPos;
+layout (location = 1) in vec2 aTexCoord;
+layout (location = 2) in mat4 aModel;	// 逐实例属性，占用 location 2 ~ 5
+
+out vec2 TexCoord;
+
+uniform mat4 view;
+uniform mat4 projection;
+
+void main() {
+	gl_Position = projection * view * aModel * vec4(aPos, 1.0f);
+	TexCoord = vec2(aTexCoord);
+}
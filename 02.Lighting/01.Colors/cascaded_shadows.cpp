@@ -0,0 +1,736 @@
+// 级联阴影示例：方向光 + 4级稳定的级联阴影贴图，远处两级只有静态物体的投影时缓存起来，不每帧重绘
+// 阴影和主视图的绘制都先用视锥体剔除，可见物体的编号放在SSBO中，一次实例化绘制
+// 需要 OpenGL 4.3（SSBO），Mesa llvmpipe 也可以运行
+//
+// 按键：K 开关级联缓存，U 开关剔除，C 按级联着色，H 开关阴影，J / L 旋转光源方向，空格暂停动态物体
+// 运行参数：
+//   --validate   隐藏窗口，检查级联的划分、范围和稳定性，缓存的重绘条件，缓存、剔除前后的渲染结果是否完全一致，
+//                并输出每一级阴影的绘制时间
+#include <iostream>
+#include <cstring>
+#include <vector>
+#include <memory>
+#include <algorithm>
+#include <glad/glad.h>
+#include <GLFW/glfw3.h>
+
+#include <glm/glm.hpp>
+#include <glm/gtc/matrix_transform.hpp>
+#include <glm/gtc/type_ptr.hpp>
+
+#include <learnopengl/shader.h>
+#include <learnopengl/camera.h>
+#include <learnopengl/bounds.h>
+#include <learnopengl/frustum.h>
+#include <learnopengl/cascaded_shadows.h>
+#include <learnopengl/gpu_profiler.h>
+#include <learnopengl/image_compare.h>
+
+void framebuffer_size_callback(GLFWwindow* window, int width, int height);
+void mouse_callback(GLFWwindow* window, double xpos, double ypos);
+void scroll_callback(GLFWwindow* window, double xoffset, double yoffset);
+void key_callback(GLFWwindow* window, int key, int scancode, int action, int mods);
+void processInput(GLFWwindow *window);
+
+// 窗口大小
+const unsigned int SCR_WIDTH = 1280;
+const unsigned int SCR_HEIGHT = 720;
+
+const int SHADOW_RESOLUTION = 2048;
+const int CASCADES = 4;
+
+// 场景：CITY x CITY 个高低不同的静态楼块，原点附近有几个运动的立方体，还有两个绕大圈运动、会进入远处级联的立方体
+const int CITY = 48;
+const float BLOCK_SPACING = 8.0f;
+const int DYNAMIC_NEAR = 8;
+const int DYNAMIC_FAR = 2;
+
+// camera
+Camera camera(glm::vec3(0.0f, 10.0f, 30.0f), glm::vec3(0.0f, 1.0f, 0.0f), -90.0f, -15.0f);
+
+bool firstMouse = true;
+double lastX = SCR_WIDTH / 2.0;
+double lastY = SCR_HEIGHT / 2.0;
+
+// timing
+float deltaTime = 0.0f;	// time between current frame and last frame
+float lastFrame = 0.0f;
+
+// 选项
+bool cacheCascades = true;
+bool cullObjects = true;
+bool showCascades = false;
+bool shadowsEnabled = true;
+bool animateObjects = true;
+float lightAzimuth = 35.0f;
+
+int fbWidth = SCR_WIDTH, fbHeight = SCR_HEIGHT;
+
+// 场景中的物体和绘制，持有GL对象，需要在 glfwTerminate 之前释放
+class ShadowScene {
+public:
+    Shader Lit, Depth;
+    bool Culling = true;
+
+    ShadowScene();
+    ~ShadowScene();
+    ShadowScene(const ShadowScene &) = delete;
+    ShadowScene &operator=(const ShadowScene &) = delete;
+
+    // 更新动态物体的位置
+    void Animate(float time);
+    const std::vector<AABB> &DynamicBounds() const { return dynamicBounds; }
+    size_t ObjectCount() const { return bounds.size(); }
+
+    // 绘制阴影贴图的一级，返回画了多少个物体
+    unsigned int DrawDepth(const glm::mat4 &lightViewProjection, const Frustum &frustum);
+    // 用阴影贴图绘制主视图
+    unsigned int DrawLit(const Camera &cam, float aspect, const CascadedShadowMap &shadows);
+
+private:
+    unsigned int VAO = 0, VBO = 0, modelBuffer = 0, colorBuffer = 0, visibleBuffer = 0;
+    std::vector<glm::mat4> models;
+    std::vector<AABB> bounds;
+    std::vector<AABB> dynamicBounds;
+    size_t firstDynamic = 0;
+    std::vector<unsigned int> visible;
+
+    void cull(const Frustum &frustum);
+};
+
+glm::vec3 sunDirection(float azimuth)
+{
+    float a = glm::radians(azimuth);
+    return glm::normalize(glm::vec3(std::cos(a), -1.2f, std::sin(a)));
+}
+
+int validate(ShadowScene &scene);
+
+int main(int argc, char *argv[])
+{
+    using std::cout;
+    using std::endl;
+
+    bool validateMode = argc > 1 && std::strcmp(argv[1], "--validate") == 0;
+
+    // glfw: 初始化设置
+    // ------------------------------
+    glfwInit();
+    glfwWindowHint(GLFW_CONTEXT_VERSION_MAJOR, 4);
+    glfwWindowHint(GLFW_CONTEXT_VERSION_MINOR, 3);
+    glfwWindowHint(GLFW_OPENGL_PROFILE, GLFW_OPENGL_CORE_PROFILE);
+    if (validateMode)
+        glfwWindowHint(GLFW_VISIBLE, GLFW_FALSE);
+
+    // glfw: 创建窗口
+    // --------------------
+    GLFWwindow* window = glfwCreateWindow(SCR_WIDTH, SCR_HEIGHT, "LearnOpenGL", nullptr, nullptr);
+    if (window == nullptr)
+    {
+        cout << "Failed to create GLFW window" << endl;
+        glfwTerminate();
+        exit(EXIT_FAILURE);
+    }
+    glfwMakeContextCurrent(window);     // 设置OpenGL上下文
+    glfwSetFramebufferSizeCallback(window, framebuffer_size_callback);
+    glfwSetCursorPosCallback(window, mouse_callback);
+    glfwSetScrollCallback(window, scroll_callback);
+    glfwSetKeyCallback(window, key_callback);
+    if (!validateMode)
+        glfwSetInputMode(window, GLFW_CURSOR, GLFW_CURSOR_DISABLED);
+
+    // glad: 加载OpenGL函数指针
+    // ---------------------------------------
+    if (!gladLoadGLLoader((GLADloadproc)glfwGetProcAddress))
+    {
+        cout << "Failed to initialize GLAD" << endl;
+        exit(EXIT_FAILURE);
+    }
+    if (!GLAD_GL_VERSION_4_3)
+    {
+        cout << "Cascaded shadows require OpenGL 4.3" << endl;
+        glfwTerminate();
+        exit(EXIT_FAILURE);
+    }
+    camera.FarPlane = 400.0f;
+    camera.MovementSpeed = 15.0f;
+    glfwGetFramebufferSize(window, &fbWidth, &fbHeight);
+
+    std::unique_ptr<ShadowScene> scenePtr(new ShadowScene());
+    ShadowScene &scene = *scenePtr;
+
+    if (validateMode) {
+        int failures = validate(scene);
+        scenePtr.reset();
+        glfwTerminate();
+        return failures == 0 ? EXIT_SUCCESS : EXIT_FAILURE;
+    }
+
+    std::unique_ptr<CascadedShadowMap> shadowsPtr(new CascadedShadowMap(SHADOW_RESOLUTION, CASCADES));
+    CascadedShadowMap &shadows = *shadowsPtr;
+    std::unique_ptr<GpuProfiler> profiler(new GpuProfiler());
+    float objectTime = 0.0f;
+
+    // 渲染循环
+    // -----------
+    float titleTimer = 0.0f;
+    while (!glfwWindowShouldClose(window))
+    {
+        float currentFrame = glfwGetTime();
+        deltaTime = currentFrame - lastFrame;
+        lastFrame = currentFrame;
+
+        processInput(window);
+
+        if (animateObjects)
+            objectTime += deltaTime;
+        scene.Animate(objectTime);
+        scene.Culling = cullObjects;
+
+        float aspect = (float)fbWidth / (float)fbHeight;
+        shadows.FirstCachedCascade = cacheCascades ? 2 : CASCADES;
+        shadows.SetLightDirection(sunDirection(lightAzimuth));
+        shadows.Update(camera, aspect, scene.DynamicBounds());
+        int rendered = shadows.Render([&](int, const glm::mat4 &lightViewProjection, const Frustum &frustum) {
+            scene.DrawDepth(lightViewProjection, frustum);
+        }, profiler.get());
+
+        glBindFramebuffer(GL_FRAMEBUFFER, 0);
+        glViewport(0, 0, fbWidth, fbHeight);
+        profiler->Begin("main view");
+        unsigned int drawn = scene.DrawLit(camera, aspect, shadows);
+        profiler->End();
+        profiler->Poll();
+
+        titleTimer += deltaTime;
+        if (titleTimer > 0.5f) {
+            titleTimer = 0.0f;
+            std::string title = "Cascaded Shadows - " + std::to_string(rendered) + "/" + std::to_string(CASCADES) +
+                                " cascades redrawn" + (cacheCascades ? "" : " (no cache)") +
+                                ", " + std::to_string(drawn) + "/" + std::to_string(scene.ObjectCount()) + " objects - " +
+                                profiler->Report() + " - " + std::to_string(deltaTime * 1000.0f) + " ms";
+            glfwSetWindowTitle(window, title.c_str());
+        }
+
+        // glfw: 交换颜色缓冲，检测事件
+        // -------------------------------------------------------------------------------
+        glfwSwapBuffers(window);
+        glfwPollEvents();
+    }
+
+    profiler.reset();
+    shadowsPtr.reset();
+    scenePtr.reset();
+
+    glfwTerminate();
+    return 0;
+}
+
+ShadowScene::ShadowScene()
+        : Lit("cascaded_shadows.vs", "cascaded_shadows.fs"),
+          Depth("shadow_depth.vs", "shadow_depth.fs")
+{
+    // 定义顶点数据，包含位置、法线
+    float vertices[] = {
+            -0.5f, -0.5f, -0.5f,  0.0f,  0.0f, -1.0f,
+             0.5f,  0.5f, -0.5f,  0.0f,  0.0f, -1.0f,
+             0.5f, -0.5f, -0.5f,  0.0f,  0.0f, -1.0f,
+             0.5f,  0.5f, -0.5f,  0.0f,  0.0f, -1.0f,
+            -0.5f, -0.5f, -0.5f,  0.0f,  0.0f, -1.0f,
+            -0.5f,  0.5f, -0.5f,  0.0f,  0.0f, -1.0f,
+
+            -0.5f, -0.5f,  0.5f,  0.0f,  0.0f,  1.0f,
+             0.5f, -0.5f,  0.5f,  0.0f,  0.0f,  1.0f,
+             0.5f,  0.5f,  0.5f,  0.0f,  0.0f,  1.0f,
+             0.5f,  0.5f,  0.5f,  0.0f,  0.0f,  1.0f,
+            -0.5f,  0.5f,  0.5f,  0.0f,  0.0f,  1.0f,
+            -0.5f, -0.5f,  0.5f,  0.0f,  0.0f,  1.0f,
+
+            -0.5f,  0.5f,  0.5f, -1.0f,  0.0f,  0.0f,
+            -0.5f,  0.5f, -0.5f, -1.0f,  0.0f,  0.0f,
+            -0.5f, -0.5f, -0.5f, -1.0f,  0.0f,  0.0f,
+            -0.5f, -0.5f, -0.5f, -1.0f,  0.0f,  0.0f,
+            -0.5f, -0.5f,  0.5f, -1.0f,  0.0f,  0.0f,
+            -0.5f,  0.5f,  0.5f, -1.0f,  0.0f,  0.0f,
+
+             0.5f,  0.5f,  0.5f,  1.0f,  0.0f,  0.0f,
+             0.5f, -0.5f, -0.5f,  1.0f,  0.0f,  0.0f,
+             0.5f,  0.5f, -0.5f,  1.0f,  0.0f,  0.0f,
+             0.5f, -0.5f, -0.5f,  1.0f,  0.0f,  0.0f,
+             0.5f,  0.5f,  0.5f,  1.0f,  0.0f,  0.0f,
+             0.5f, -0.5f,  0.5f,  1.0f,  0.0f,  0.0f,
+
+            -0.5f, -0.5f, -0.5f,  0.0f, -1.0f,  0.0f,
+             0.5f, -0.5f, -0.5f,  0.0f, -1.0f,  0.0f,
+             0.5f, -0.5f,  0.5f,  0.0f, -1.0f,  0.0f,
+             0.5f, -0.5f,  0.5f,  0.0f, -1.0f,  0.0f,
+            -0.5f, -0.5f,  0.5f,  0.0f, -1.0f,  0.0f,
+            -0.5f, -0.5f, -0.5f,  0.0f, -1.0f,  0.0f,
+
+            -0.5f,  0.5f, -0.5f,  0.0f,  1.0f,  0.0f,
+             0.5f,  0.5f,  0.5f,  0.0f,  1.0f,  0.0f,
+             0.5f,  0.5f, -0.5f,  0.0f,  1.0f,  0.0f,
+             0.5f,  0.5f,  0.5f,  0.0f,  1.0f,  0.0f,
+            -0.5f,  0.5f, -0.5f,  0.0f,  1.0f,  0.0f,
+            -0.5f,  0.5f,  0.5f,  0.0f,  1.0f,  0.0f
+    };
+
+    // 静态物体：地面和楼块；动态物体放在最后，每帧只更新这一段
+    std::vector<glm::vec4> colors;
+    float citySize = CITY * BLOCK_SPACING;
+    models.push_back(glm::scale(glm::translate(glm::mat4(1.0f), glm::vec3(0.0f, -0.5f, 0.0f)),
+                                glm::vec3(citySize + 40.0f, 1.0f, citySize + 40.0f)));
+    colors.push_back(glm::vec4(0.6f, 0.6f, 0.55f, 1.0f));
+    for (int z = 0; z < CITY; z++) {
+        for (int x = 0; x < CITY; x++) {
+            // 留出原点附近的空地给动态物体
+            if (std::abs(x - CITY / 2) < 3 && std::abs(z - CITY / 2) < 3)
+                continue;
+            float height = 2.0f + (float) ((x * 37 + z * 91) % 19);
+            glm::vec3 position((x - CITY / 2 + 0.5f) * BLOCK_SPACING, height * 0.5f, (z - CITY / 2 + 0.5f) * BLOCK_SPACING);
+            models.push_back(glm::scale(glm::translate(glm::mat4(1.0f), position), glm::vec3(4.0f, height, 4.0f)));
+            float shade = 0.6f + 0.05f * (float) ((x + z) % 7);
+            colors.push_back(glm::vec4(shade, shade * 0.95f, shade * 0.9f, 1.0f));
+        }
+    }
+    firstDynamic = models.size();
+    for (int i = 0; i < DYNAMIC_NEAR + DYNAMIC_FAR; i++) {
+        models.push_back(glm::mat4(1.0f));
+        colors.push_back(glm::vec4(0.9f, 0.5f, 0.2f, 1.0f));
+    }
+    AABB unitCube(glm::vec3(-0.5f), glm::vec3(0.5f));
+    for (const glm::mat4 &model : models)
+        bounds.push_back(unitCube.Transformed(model));
+    Animate(0.0f);
+
+    glGenBuffers(1, &modelBuffer);
+    glBindBuffer(GL_SHADER_STORAGE_BUFFER, modelBuffer);
+    glBufferData(GL_SHADER_STORAGE_BUFFER, models.size() * sizeof(glm::mat4), models.data(), GL_DYNAMIC_DRAW);
+    glGenBuffers(1, &colorBuffer);
+    glBindBuffer(GL_SHADER_STORAGE_BUFFER, colorBuffer);
+    glBufferData(GL_SHADER_STORAGE_BUFFER, colors.size() * sizeof(glm::vec4), colors.data(), GL_STATIC_DRAW);
+    glGenBuffers(1, &visibleBuffer);
+    glBindBufferBase(GL_SHADER_STORAGE_BUFFER, 3, modelBuffer);
+    glBindBufferBase(GL_SHADER_STORAGE_BUFFER, 4, colorBuffer);
+
+    // 创建顶点缓冲和顶点数组
+    glGenVertexArrays(1, &VAO);
+    glGenBuffers(1, &VBO);
+
+    glBindVertexArray(VAO);
+    glBindBuffer(GL_ARRAY_BUFFER, VBO);
+    glBufferData(GL_ARRAY_BUFFER, sizeof(vertices), vertices, GL_STATIC_DRAW);
+
+    // 顶点位置
+    glVertexAttribPointer(0, 3, GL_FLOAT, GL_FALSE, 6 * sizeof(float), (void *)nullptr);
+    glEnableVertexAttribArray(0);
+    // 法线
+    glVertexAttribPointer(1, 3, GL_FLOAT, GL_FALSE, 6 * sizeof(float), (void *)(3 * sizeof(float)));
+    glEnableVertexAttribArray(1);
+
+    Lit.use();
+    Lit.setInt("shadowMap", 0);
+}
+
+ShadowScene::~ShadowScene()
+{
+    glDeleteVertexArrays(1, &VAO);
+    glDeleteBuffers(1, &VBO);
+    glDeleteBuffers(1, &modelBuffer);
+    glDeleteBuffers(1, &colorBuffer);
+    glDeleteBuffers(1, &visibleBuffer);
+}
+
+void ShadowScene::Animate(float time)
+{
+    AABB unitCube(glm::vec3(-0.5f), glm::vec3(0.5f));
+    dynamicBounds.clear();
+    for (int i = 0; i < DYNAMIC_NEAR + DYNAMIC_FAR; i++) {
+        bool far = i >= DYNAMIC_NEAR;
+        float radius = far ? 120.0f + 40.0f * (i - DYNAMIC_NEAR) : 4.0f + 1.0f * i;
+        float speed = far ? 0.05f : 0.3f + 0.1f * i;
+        float angle = time * speed + i * 2.0f;
+        glm::vec3 position(radius * std::cos(angle), 2.0f + std::sin(time + i) * 1.5f, radius * std::sin(angle));
+        glm::mat4 model = glm::translate(glm::mat4(1.0f), position);
+        model = glm::rotate(model, time + i, glm::vec3(0.3f, 1.0f, 0.2f));
+        model = glm::scale(model, glm::vec3(far ? 6.0f : 2.0f));
+        models[firstDynamic + i] = model;
+        bounds[firstDynamic + i] = unitCube.Transformed(model);
+        dynamicBounds.push_back(bounds[firstDynamic + i]);
+    }
+    if (modelBuffer) {
+        glBindBuffer(GL_SHADER_STORAGE_BUFFER, modelBuffer);
+        glBufferSubData(GL_SHADER_STORAGE_BUFFER, firstDynamic * sizeof(glm::mat4),
+                        (models.size() - firstDynamic) * sizeof(glm::mat4), &models[firstDynamic]);
+    }
+}
+
+void ShadowScene::cull(const Frustum &frustum)
+{
+    visible.clear();
+    for (unsigned int i = 0; i < (unsigned int) bounds.size(); i++)
+        if (!Culling || frustum.IntersectsAABB(bounds[i]))
+            visible.push_back(i);
+    // 每次绘制前重新分配，驱动不用等上一次绘制读完旧的列表
+    glBindBuffer(GL_SHADER_STORAGE_BUFFER, visibleBuffer);
+    glBufferData(GL_SHADER_STORAGE_BUFFER, std::max<size_t>(visible.size(), 1) * sizeof(unsigned int), nullptr, GL_STREAM_DRAW);
+    glBufferSubData(GL_SHADER_STORAGE_BUFFER, 0, visible.size() * sizeof(unsigned int), visible.data());
+    glBindBufferBase(GL_SHADER_STORAGE_BUFFER, 5, visibleBuffer);
+}
+
+unsigned int ShadowScene::DrawDepth(const glm::mat4 &lightViewProjection, const Frustum &frustum)
+{
+    cull(frustum);
+    Depth.use();
+    Depth.setMat4("lightViewProjection", lightViewProjection);
+    glBindVertexArray(VAO);
+    glDrawArraysInstanced(GL_TRIANGLES, 0, 36, (GLsizei) visible.size());
+    return (unsigned int) visible.size();
+}
+
+unsigned int ShadowScene::DrawLit(const Camera &cam, float aspect, const CascadedShadowMap &shadows)
+{
+    const glm::mat4 &projection = cam.GetProjectionMatrix(aspect);
+    const glm::mat4 &view = cam.GetViewMatrix();
+    cull(Frustum(projection * view));
+
+    glEnable(GL_DEPTH_TEST);
+    glClearColor(0.55f, 0.7f, 0.9f, 1.0f);
+    glClear(GL_COLOR_BUFFER_BIT | GL_DEPTH_BUFFER_BIT);
+
+    Lit.use();
+    Lit.setMat4("projection", projection);
+    Lit.setMat4("view", view);
+    Lit.setVec3("viewPos", cam.Position);
+    Lit.setVec3("lightDir", shadows.LightDirection());
+    Lit.setVec3("lightColor", glm::vec3(1.0f, 0.97f, 0.9f));
+    Lit.setBool("shadowsEnabled", shadowsEnabled);
+    Lit.setBool("showCascades", showCascades);
+    Lit.setInt("cascadeCount", shadows.Count());
+    for (int i = 0; i < shadows.Count(); i++) {
+        std::string index = "[" + std::to_string(i) + "]";
+        Lit.setMat4("lightViewProjection" + index, shadows.LightViewProjection(i));
+        Lit.setFloat("cascadeSplits" + index, shadows.SplitDepth(i));
+        Lit.setFloat("texelSize" + index, shadows.TexelWorldSize(i));
+    }
+    glActiveTexture(GL_TEXTURE0);
+    glBindTexture(GL_TEXTURE_2D_ARRAY, shadows.Texture());
+    glBindVertexArray(VAO);
+    glDrawArraysInstanced(GL_TRIANGLES, 0, 36, (GLsizei) visible.size());
+    return (unsigned int) visible.size();
+}
+
+// 1. 实用划分单调递增，两端是近平面和阴影距离
+// 2. 随机的摄像机位姿下，每一级视锥体片段的角点都在级联的正交投影范围内
+// 3. 稳定性：摄像机平移、旋转时，固定的世界坐标点在阴影贴图中的纹素小数部分不变（只会整纹素地移动）
+// 4. 缓存：静止或小范围移动时远处两级不重绘，大范围移动、改变光源方向、动态物体进出远处级联时重绘
+// 5. 摄像机和动态物体一起运动几帧，带缓存和每帧全部重绘的画面完全一致；开关剔除的阴影贴图完全一致
+// 6. 阴影确实存在，并输出每一级阴影的绘制时间（全部重绘和使用缓存）
+// ---------------------------------------------------------------------------------------------------------
+int validate(ShadowScene &scene)
+{
+    using std::cout;
+    using std::endl;
+
+    const int width = SCR_WIDTH, height = SCR_HEIGHT;
+    float aspect = (float) width / height;
+    int failures = 0;
+    auto report = [&failures](const std::string &name, bool ok, const std::string &detail) {
+        cout << name << ": " << detail << (ok ? " OK" : " FAIL") << endl;
+        if (!ok)
+            failures++;
+    };
+    auto makeCamera = [](const glm::vec3 &position, float yaw, float pitch) {
+        Camera cam(position, glm::vec3(0.0f, 1.0f, 0.0f), yaw, pitch);
+        cam.FarPlane = 400.0f;
+        return cam;
+    };
+
+    std::unique_ptr<CascadedShadowMap> cachedPtr(new CascadedShadowMap(SHADOW_RESOLUTION, CASCADES));
+    std::unique_ptr<CascadedShadowMap> freshPtr(new CascadedShadowMap(SHADOW_RESOLUTION, CASCADES));
+    CascadedShadowMap &cached = *cachedPtr, &fresh = *freshPtr;
+    cached.SetLightDirection(sunDirection(lightAzimuth));
+    fresh.SetLightDirection(sunDirection(lightAzimuth));
+    auto drawDepth = [&scene](int, const glm::mat4 &lightViewProjection, const Frustum &frustum) {
+        scene.DrawDepth(lightViewProjection, frustum);
+    };
+    std::vector<AABB> noDynamic;
+
+    // 1. 划分
+    {
+        std::vector<float> splits = PracticalSplits(0.1f, 150.0f, CASCADES, 0.75f);
+        bool ok = splits.front() == 0.1f && splits.back() == 150.0f;
+        for (int i = 0; i < CASCADES; i++)
+            ok = ok && splits[i] < splits[i + 1];
+        std::string detail;
+        for (float s : splits)
+            detail += std::to_string(s) + " ";
+        report("practical splits", ok, detail);
+    }
+
+    // 2. 范围：片段的8个角点投影到级联的 [-1, 1]^3 内
+    {
+        bool ok = true;
+        float worst = 0.0f;
+        for (int p = 0; p < 32; p++) {
+            glm::vec3 position(std::sin(p * 1.7f) * 80.0f, 2.0f + p % 7 * 5.0f, std::cos(p * 2.3f) * 80.0f);
+            Camera cam = makeCamera(position, p * 37.0f, -60.0f + (p * 13) % 110);
+            cached.Update(cam, aspect, noDynamic);
+            float tanY = std::tan(glm::radians(cam.Zoom) * 0.5f), tanX = tanY * aspect;
+            for (int i = 0; i < CASCADES; i++) {
+                float depths[2] = {i == 0 ? cam.NearPlane : cached.SplitDepth(i - 1), cached.SplitDepth(i)};
+                for (float d : depths)
+                    for (float sx : {-1.0f, 1.0f})
+                        for (float sy : {-1.0f, 1.0f}) {
+                            glm::vec3 corner = cam.Position + cam.GetFront() * d + cam.GetRight() * (sx * tanX * d) + cam.GetUp() * (sy * tanY * d);
+                            glm::vec4 clip = cached.LightViewProjection(i) * glm::vec4(corner, 1.0f);
+                            float m = std::max(std::max(std::abs(clip.x), std::abs(clip.y)), std::abs(clip.z));
+                            worst = std::max(worst, m);
+                            ok = ok && m <= 1.0f;
+                        }
+            }
+        }
+        report("cascade bounds", ok, "max |ndc| of slice corners " + std::to_string(worst));
+    }
+
+    // 3. 稳定性
+    {
+        glm::vec3 probe(13.37f, 1.0f, -21.5f);
+        auto texelFraction = [&](int cascade) {
+            glm::vec4 clip = cached.LightViewProjection(cascade) * glm::vec4(probe, 1.0f);
+            glm::vec2 texel = (glm::vec2(clip.x, clip.y) * 0.5f + 0.5f) * (float) SHADOW_RESOLUTION;
+            return texel - glm::floor(texel);
+        };
+        Camera cam = makeCamera(glm::vec3(0.0f, 10.0f, 30.0f), -90.0f, -15.0f);
+        cached.Update(cam, aspect, noDynamic);
+        glm::vec2 reference[CASCADES];
+        float texelSize[CASCADES];
+        for (int i = 0; i < CASCADES; i++) {
+            reference[i] = texelFraction(i);
+            texelSize[i] = cached.TexelWorldSize(i);
+        }
+        float worst = 0.0f;
+        bool sizeOk = true;
+        for (int step = 1; step <= 40; step++) {
+            cam.Position += glm::vec3(0.173f, 0.011f, -0.291f);
+            cam.Yaw += 3.1f;
+            cam.Pitch = -15.0f + std::sin(step * 0.5f) * 20.0f;
+            cached.Update(cam, aspect, noDynamic);
+            for (int i = 0; i < CASCADES; i++) {
+                glm::vec2 diff = glm::abs(texelFraction(i) - reference[i]);
+                // 小数部分在0和1之间跳变也是同一个位置
+                diff = glm::min(diff, glm::vec2(1.0f) - diff);
+                worst = std::max(worst, std::max(diff.x, diff.y));
+                sizeOk = sizeOk && cached.TexelWorldSize(i) == texelSize[i];
+            }
+        }
+        report("texel snapping", worst < 0.01f && sizeOk, "max sub-texel drift " + std::to_string(worst) + " texels");
+    }
+
+    // 4. 缓存的重绘条件
+    {
+        auto frame = [&](const Camera &cam, const std::vector<AABB> &dynamic) {
+            cached.Update(cam, aspect, dynamic);
+            return cached.Render(drawDepth);
+        };
+        Camera cam = makeCamera(glm::vec3(0.0f, 10.0f, 30.0f), -90.0f, -15.0f);
+        cached.Invalidate();
+        std::vector<int> counts;
+        counts.push_back(frame(cam, noDynamic));                      // 第一帧：全部
+        counts.push_back(frame(cam, noDynamic));                      // 静止：只有近处两级
+        cam.Yaw += 2.0f;
+        cam.Position += glm::vec3(0.3f, 0.0f, -0.2f);
+        counts.push_back(frame(cam, noDynamic));                      // 小范围移动、转动
+        cam.Position += glm::vec3(120.0f, 0.0f, 0.0f);
+        counts.push_back(frame(cam, noDynamic));                      // 大范围移动：全部
+        cached.SetLightDirection(sunDirection(lightAzimuth + 20.0f));
+        counts.push_back(frame(cam, noDynamic));                      // 光源方向改变：全部
+        // 远处级联范围内的动态物体
+        glm::vec4 sphere = cached.SliceSphere(CASCADES - 1);
+        glm::vec3 center(sphere);
+        std::vector<AABB> dynamic = {AABB(center - glm::vec3(2.0f), center + glm::vec3(2.0f))};
+        counts.push_back(frame(cam, dynamic));                        // 动态物体进入：那一级重绘
+        counts.push_back(frame(cam, noDynamic));                      // 离开：再重绘一次擦掉旧的影子
+        counts.push_back(frame(cam, noDynamic));                      // 之后又不需要重绘
+        const int expected[] = {4, 2, 2, 4, 4, 3, 3, 2};
+        bool ok = true;
+        std::string detail = "redrawn";
+        for (size_t i = 0; i < counts.size(); i++) {
+            ok = ok && counts[i] == expected[i];
+            detail += " " + std::to_string(counts[i]);
+        }
+        report("cache invalidation", ok, detail);
+        cached.SetLightDirection(sunDirection(lightAzimuth));
+    }
+
+    // 5. 渲染结果
+    unsigned int FBO, colorRbo, depthRbo;
+    glGenFramebuffers(1, &FBO);
+    glBindFramebuffer(GL_FRAMEBUFFER, FBO);
+    glGenRenderbuffers(1, &colorRbo);
+    glBindRenderbuffer(GL_RENDERBUFFER, colorRbo);
+    glRenderbufferStorage(GL_RENDERBUFFER, GL_RGBA8, width, height);
+    glFramebufferRenderbuffer(GL_FRAMEBUFFER, GL_COLOR_ATTACHMENT0, GL_RENDERBUFFER, colorRbo);
+    glGenRenderbuffers(1, &depthRbo);
+    glBindRenderbuffer(GL_RENDERBUFFER, depthRbo);
+    glRenderbufferStorage(GL_RENDERBUFFER, GL_DEPTH_COMPONENT24, width, height);
+    glFramebufferRenderbuffer(GL_FRAMEBUFFER, GL_DEPTH_ATTACHMENT, GL_RENDERBUFFER, depthRbo);
+    auto renderView = [&](const Camera &cam, const CascadedShadowMap &shadows, std::vector<unsigned char> &pixels) {
+        glBindFramebuffer(GL_FRAMEBUFFER, FBO);
+        glViewport(0, 0, width, height);
+        scene.DrawLit(cam, aspect, shadows);
+        pixels.resize((size_t) width * height * 4);
+        glReadPixels(0, 0, width, height, GL_RGBA, GL_UNSIGNED_BYTE, pixels.data());
+    };
+    auto readShadowMap = [](const CascadedShadowMap &shadows, std::vector<float> &depth) {
+        depth.resize((size_t) shadows.Resolution() * shadows.Resolution() * shadows.Count());
+        glBindTexture(GL_TEXTURE_2D_ARRAY, shadows.Texture());
+        glGetTexImage(GL_TEXTURE_2D_ARRAY, 0, GL_DEPTH_COMPONENT, GL_FLOAT, depth.data());
+    };
+
+    {
+        std::vector<unsigned char> a, b;
+        Camera cam = makeCamera(glm::vec3(0.0f, 10.0f, 30.0f), -90.0f, -15.0f);
+        cached.Invalidate();
+        int worst = 0, cachedRedraws = 0;
+        for (int f = 0; f < 6; f++) {
+            scene.Animate(f * 0.7f);
+            cam.Position += glm::vec3(0.2f, 0.0f, -0.5f);
+            cam.Yaw += 1.0f;
+            cached.Update(cam, aspect, scene.DynamicBounds());
+            cachedRedraws += cached.Render(drawDepth);
+            fresh.Invalidate();
+            fresh.Update(cam, aspect, scene.DynamicBounds());
+            fresh.Render(drawDepth);
+            renderView(cam, cached, a);
+            renderView(cam, fresh, b);
+            worst = std::max(worst, CompareImages(a.data(), b.data(), width, height).MaxDiff);
+        }
+        report("cached vs fresh", worst == 0, "max diff " + std::to_string(worst) + " over 6 frames, " +
+                                              std::to_string(cachedRedraws) + "/24 cascades redrawn with cache");
+
+        // 阴影确实存在
+        shadowsEnabled = false;
+        renderView(cam, cached, b);
+        shadowsEnabled = true;
+        ImageDifference diff = CompareImages(a.data(), b.data(), width, height);
+        report("shadows visible", diff.DiffFraction > 0.05, std::to_string(diff.DiffFraction * 100.0) + "% pixels shadowed");
+
+        // 剔除：阴影贴图的每个深度值都不变
+        std::vector<float> culledDepth, allDepth;
+        std::vector<unsigned int> drawn(CASCADES);
+        fresh.Invalidate();
+        fresh.Update(cam, aspect, scene.DynamicBounds());
+        fresh.Render([&](int i, const glm::mat4 &m, const Frustum &frustum) { drawn[i] = scene.DrawDepth(m, frustum); });
+        readShadowMap(fresh, culledDepth);
+        scene.Culling = false;
+        fresh.Invalidate();
+        fresh.Update(cam, aspect, scene.DynamicBounds());
+        fresh.Render(drawDepth);
+        readShadowMap(fresh, allDepth);
+        scene.Culling = true;
+        std::string detail = "objects drawn per cascade";
+        for (unsigned int n : drawn)
+            detail += " " + std::to_string(n);
+        detail += " of " + std::to_string(scene.ObjectCount());
+        report("shadow culling", culledDepth == allDepth, detail);
+    }
+
+    // 6. 每一级的绘制时间
+    {
+        std::unique_ptr<GpuProfiler> profiler(new GpuProfiler(true));
+        Camera cam = makeCamera(glm::vec3(0.0f, 10.0f, 30.0f), -90.0f, -15.0f);
+        // 只有静态物体，缓存的帧只重绘近处的级联
+        cached.Invalidate();
+        cached.Update(cam, aspect, noDynamic);
+        cached.Render(drawDepth, profiler.get());
+        cout << "full redraw:   " << profiler->Report() << endl;
+        double full = 0.0, cachedMs = 0.0;
+        for (int i = 0; i < CASCADES; i++)
+            full += profiler->Milliseconds("shadow cascade " + std::to_string(i));
+        std::unique_ptr<GpuProfiler> cachedProfiler(new GpuProfiler(true));
+        cam.Position += glm::vec3(0.2f, 0.0f, -0.2f);
+        cached.Update(cam, aspect, noDynamic);
+        int redrawn = cached.Render(drawDepth, cachedProfiler.get());
+        for (int i = 0; i < CASCADES; i++)
+            cachedMs += cachedProfiler->Milliseconds("shadow cascade " + std::to_string(i));
+        cout << "cached frame:  " << cachedProfiler->Report() << " (" << redrawn << " cascades redrawn)" << endl;
+        cout << "shadow time: " << full << " ms full, " << cachedMs << " ms cached" << endl;
+    }
+
+    glBindFramebuffer(GL_FRAMEBUFFER, 0);
+    glDeleteFramebuffers(1, &FBO);
+    glDeleteRenderbuffers(1, &colorRbo);
+    glDeleteRenderbuffers(1, &depthRbo);
+    cachedPtr.reset();
+    freshPtr.reset();
+
+    cout << (failures == 0 ? "Cascaded shadows validation passed" : "Cascaded shadows validation FAILED") << endl;
+    return failures;
+}
+
+// process all input: query GLFW whether relevant keys are pressed/released this frame and react accordingly
+// ---------------------------------------------------------------------------------------------------------
+void processInput(GLFWwindow *window)
+{
+    if (glfwGetKey(window, GLFW_KEY_ESCAPE) == GLFW_PRESS)
+        glfwSetWindowShouldClose(window, true);
+
+    if (glfwGetKey(window, GLFW_KEY_W) == GLFW_PRESS)
+        camera.ProcessKeyboard(FORWARD, deltaTime);
+    if (glfwGetKey(window, GLFW_KEY_S) == GLFW_PRESS)
+        camera.ProcessKeyboard(BACKWARD, deltaTime);
+    if (glfwGetKey(window, GLFW_KEY_A) == GLFW_PRESS)
+        camera.ProcessKeyboard(LEFT, deltaTime);
+    if (glfwGetKey(window, GLFW_KEY_D) == GLFW_PRESS)
+        camera.ProcessKeyboard(RIGHT, deltaTime);
+    // 旋转光源方向，每一帧都会让所有级联重绘
+    if (glfwGetKey(window, GLFW_KEY_J) == GLFW_PRESS)
+        lightAzimuth -= 20.0f * deltaTime;
+    if (glfwGetKey(window, GLFW_KEY_L) == GLFW_PRESS)
+        lightAzimuth += 20.0f * deltaTime;
+}
+
+void key_callback(GLFWwindow* window, int key, int scancode, int action, int mods)
+{
+    if (action != GLFW_PRESS)
+        return;
+    if (key == GLFW_KEY_K)
+        cacheCascades = !cacheCascades;
+    if (key == GLFW_KEY_U)
+        cullObjects = !cullObjects;
+    if (key == GLFW_KEY_C)
+        showCascades = !showCascades;
+    if (key == GLFW_KEY_H)
+        shadowsEnabled = !shadowsEnabled;
+    if (key == GLFW_KEY_SPACE)
+        animateObjects = !animateObjects;
+}
+
+// glfw: whenever the window size changed (by OS or user resize) this callback function executes
+// ---------------------------------------------------------------------------------------------
+void framebuffer_size_callback(GLFWwindow* window, int width, int height)
+{
+    fbWidth = width;
+    fbHeight = height;
+    glViewport(0, 0, width, height);
+}
+
+void mouse_callback(GLFWwindow* window, double xpos, double ypos) {
+    if (firstMouse) {
+        lastX = xpos;
+        lastY = ypos;
+        firstMouse = false;
+    }
+    float xoffset = xpos - lastX;
+    float yoffset = lastY - ypos;
+    lastX = xpos;
+    lastY = ypos;
+
+    camera.ProcessMouseMovement(xoffset, yoffset);
+}
+
+void scroll_callback(GLFWwindow* window, double xoffset, double yoffset)
+{
+    camera.ProcessMouseScroll(yoffset);
+}
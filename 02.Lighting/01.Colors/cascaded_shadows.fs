@@ -0,0 +1,65 @@
+#version 430 core
+out vec4 FragColor;
+
+in vec3 FragPos;
+in vec3 Normal;
+in float ViewDepth;
+flat in vec3 Color;
+
+const int MAX_CASCADES = 4;
+
+uniform sampler2DArrayShadow shadowMap;
+uniform mat4 lightViewProjection[MAX_CASCADES];
+// 每一级的远处分界（观察空间深度）和一个纹素在世界空间的大小
+uniform float cascadeSplits[MAX_CASCADES];
+uniform float texelSize[MAX_CASCADES];
+uniform int cascadeCount;
+
+uniform vec3 lightDir;
+uniform vec3 lightColor;
+uniform vec3 viewPos;
+uniform bool shadowsEnabled;
+// 按级联着色，检查划分和级联的范围
+uniform bool showCascades;
+
+// 3x3 次硬件比较采样（每次是2x2的双线性PCF），返回照亮的比例；超出阴影距离时不在阴影中
+float ShadowFactor(vec3 normal, int cascade)
+{
+    if (cascade < 0)
+        return 1.0;
+    // 采样位置沿法线偏移1.5个纹素，避免自阴影的条纹（shadow acne）
+    vec3 position = FragPos + normal * texelSize[cascade] * 1.5;
+    vec3 coord = (lightViewProjection[cascade] * vec4(position, 1.0)).xyz * 0.5 + 0.5;
+    float texel = 1.0 / float(textureSize(shadowMap, 0).x);
+    float lit = 0.0;
+    for (int x = -1; x <= 1; x++)
+        for (int y = -1; y <= 1; y++)
+            lit += texture(shadowMap, vec4(coord.xy + vec2(x, y) * texel, float(cascade), coord.z));
+    return lit / 9.0;
+}
+
+void main()
+{
+    vec3 normal = normalize(Normal);
+    int cascade = -1;
+    for (int i = 0; i < cascadeCount; i++) {
+        if (ViewDepth < cascadeSplits[i]) {
+            cascade = i;
+            break;
+        }
+    }
+
+    vec3 toLight = -lightDir;
+    float diff = max(dot(normal, toLight), 0.0);
+    vec3 viewDir = normalize(viewPos - FragPos);
+    float spec = pow(max(dot(normal, normalize(toLight + viewDir)), 0.0), 32.0) * 0.3;
+    // 背光面本来就是暗的，不需要采样阴影
+    float lit = shadowsEnabled && diff > 0.0 ? ShadowFactor(normal, cascade) : 1.0;
+
+    vec3 color = (0.15 + lit * (diff + spec)) * lightColor * Color;
+    if (showCascades && cascade >= 0) {
+        const vec3 tints[MAX_CASCADES] = vec3[](vec3(1.0, 0.5, 0.5), vec3(0.5, 1.0, 0.5), vec3(0.5, 0.5, 1.0), vec3(1.0, 1.0, 0.5));
+        color *= tints[cascade];
+    }
+    FragColor = vec4(color, 1.0);
+}
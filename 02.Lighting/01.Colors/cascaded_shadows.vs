@@ -0,0 +1,35 @@
+#version 430 core
+layout (location = 0) in vec3 aPos;
+layout (location = 1) in vec3 aNormal;
+
+// 所有物体的模型矩阵和颜色，实例编号通过可见列表间接索引，剔除后只画可见的物体
+layout (std430, binding = 3) readonly buffer Models {
+    mat4 models[];
+};
+layout (std430, binding = 4) readonly buffer Colors {
+    vec4 colors[];
+};
+layout (std430, binding = 5) readonly buffer Visible {
+    uint visible[];
+};
+
+out vec3 FragPos;
+out vec3 Normal;
+out float ViewDepth;
+flat out vec3 Color;
+
+uniform mat4 view;
+uniform mat4 projection;
+
+void main()
+{
+    uint object = visible[gl_InstanceID];
+    mat4 model = models[object];
+    vec4 worldPos = model * vec4(aPos, 1.0);
+    vec4 viewPos = view * worldPos;
+    FragPos = worldPos.xyz;
+    Normal = mat3(transpose(inverse(model))) * aNormal;
+    ViewDepth = -viewPos.z;
+    Color = colors[object].rgb;
+    gl_Position = projection * viewPos;
+}
@@ -0,0 +1,712 @@
+// 分簇光照示例：上万个动态点光源和聚光灯，每帧在CPU上把光源分配到视锥体的簇中，着色时只计算所在簇的光源
+// 两条渲染路径可以随时切换：
+//   前向  每个物体的片段直接计算光照（clustered_lighting.vs/.fs）
+//   延迟  先把材质、法线、深度写入G-buffer（deferred_gbuffer.fs），再用一个全屏三角形逐像素计算光照（deferred_lighting.vs/.fs）
+// 需要 OpenGL 4.3（SSBO），Mesa llvmpipe 也可以运行
+//
+// 按键：= / - 光源数量加倍、减半（64 ~ 16384），R 切换前向和延迟渲染，B 切换分簇和逐像素计算所有光源，
+//       空格暂停光源运动，T 切换多线程和单线程分配，V 切换SIMD和标量测试
+// 运行参数：
+//   --validate   隐藏窗口，对比各种分配方式和参考实现的结果，输出不同光源数量下的分配耗时；
+//                对比分簇和逐像素计算所有光源、前向和延迟渲染出的图像，并输出两条路径的渲染时间，不一致时返回非0
+#include <iostream>
+#include <cstring>
+#include <vector>
+#include <random>
+#include <chrono>
+#include <memory>
+#include <algorithm>
+#include <glad/glad.h>
+#include <GLFW/glfw3.h>
+
+#include <glm/glm.hpp>
+#include <glm/gtc/matrix_transform.hpp>
+#include <glm/gtc/type_ptr.hpp>
+
+#include <learnopengl/shader.h>
+#include <learnopengl/camera.h>
+#include <learnopengl/clustered_lighting.h>
+#include <learnopengl/gbuffer.h>
+#include <learnopengl/dynamic_resolution.h>
+#include <learnopengl/image_compare.h>
+
+void framebuffer_size_callback(GLFWwindow* window, int width, int height);
+void mouse_callback(GLFWwindow* window, double xpos, double ypos);
+void scroll_callback(GLFWwindow* window, double xoffset, double yoffset);
+void key_callback(GLFWwindow* window, int key, int scancode, int action, int mods);
+void processInput(GLFWwindow *window);
+
+// 窗口大小，和 16 x 9 的格子对应
+const unsigned int SCR_WIDTH = 1280;
+const unsigned int SCR_HEIGHT = 720;
+
+// 场景：边长 FLOOR_SIZE 的地面上 GRID x GRID 个立方体，光源在地面上方绕各自的中心转动
+const int GRID = 16;
+const float SPACING = 6.0f;
+const float FLOOR_SIZE = 120.0f;
+
+const unsigned int MIN_LIGHTS = 64;
+const unsigned int MAX_LIGHTS = 16384;
+
+// camera
+Camera camera(glm::vec3(0.0f, 12.0f, 45.0f), glm::vec3(0.0f, 1.0f, 0.0f), -90.0f, -20.0f);
+
+bool firstMouse = true;
+double lastX = SCR_WIDTH / 2.0;
+double lastY = SCR_HEIGHT / 2.0;
+
+// timing
+float deltaTime = 0.0f;	// time between current frame and last frame
+float lastFrame = 0.0f;
+
+// 选项
+unsigned int lightCount = 1024;
+bool deferredShading = false;
+bool bruteForce = false;
+bool animateLights = true;
+bool multiThreaded = true;
+bool simdTests = true;
+
+int fbWidth = SCR_WIDTH, fbHeight = SCR_HEIGHT;
+
+// 光源的运动：绕 Center 在水平面上转圈
+struct LightOrbit {
+    glm::vec3 Center;
+    float Radius, Speed, Phase;
+};
+
+// 前向和延迟两条路径共用的场景、着色器和光源缓冲，持有GL对象，需要在 glfwTerminate 之前释放
+class SceneRenderer {
+public:
+    Shader Forward, Geometry, Lighting;
+    ClusteredLightBuffers Lights;
+    GBuffer GBuf;
+
+    SceneRenderer(int width, int height);
+    ~SceneRenderer();
+    SceneRenderer(const SceneRenderer &) = delete;
+    SceneRenderer &operator=(const SceneRenderer &) = delete;
+
+    // 渲染到 targetFBO（0是默认帧缓冲）；光源和分簇结果已经上传并绑定，clusterer 提供分簇参数
+    void Render(const Camera &cam, const LightClusterer &clusterer, unsigned int count, bool deferred, bool brute,
+                unsigned int targetFBO, int width, int height);
+
+private:
+    unsigned int VAO = 0, VBO = 0, emptyVAO = 0, modelBuffer = 0, materialBuffer = 0;
+    GLsizei instanceCount = 0;
+
+    void setLightingUniforms(const Shader &shader, const Camera &cam, const LightClusterer &clusterer,
+                             unsigned int count, bool brute, int width, int height) const;
+};
+
+// 随机生成光源，四分之一是朝下的聚光灯；光源越多单个越暗，画面的整体亮度差不多
+void generateLights(unsigned int count, std::vector<ClusteredLight> &lights, std::vector<LightOrbit> &orbits);
+void updateLights(float time, std::vector<ClusteredLight> &lights, const std::vector<LightOrbit> &orbits);
+int validate(SceneRenderer &renderer);
+
+int main(int argc, char *argv[])
+{
+    using std::cout;
+    using std::endl;
+
+    bool validateMode = argc > 1 && std::strcmp(argv[1], "--validate") == 0;
+
+    // glfw: 初始化设置
+    // ------------------------------
+    glfwInit();
+    glfwWindowHint(GLFW_CONTEXT_VERSION_MAJOR, 4);
+    glfwWindowHint(GLFW_CONTEXT_VERSION_MINOR, 3);
+    glfwWindowHint(GLFW_OPENGL_PROFILE, GLFW_OPENGL_CORE_PROFILE);
+    if (validateMode)
+        glfwWindowHint(GLFW_VISIBLE, GLFW_FALSE);
+
+    // glfw: 创建窗口
+    // --------------------
+    GLFWwindow* window = glfwCreateWindow(SCR_WIDTH, SCR_HEIGHT, "LearnOpenGL", nullptr, nullptr);
+    if (window == nullptr)
+    {
+        cout << "Failed to create GLFW window" << endl;
+        glfwTerminate();
+        exit(EXIT_FAILURE);
+    }
+    glfwMakeContextCurrent(window);     // 设置OpenGL上下文
+    glfwSetFramebufferSizeCallback(window, framebuffer_size_callback);
+    glfwSetCursorPosCallback(window, mouse_callback);
+    glfwSetScrollCallback(window, scroll_callback);
+    glfwSetKeyCallback(window, key_callback);
+    if (!validateMode)
+        glfwSetInputMode(window, GLFW_CURSOR, GLFW_CURSOR_DISABLED);
+
+    // glad: 加载OpenGL函数指针
+    // ---------------------------------------
+    if (!gladLoadGLLoader((GLADloadproc)glfwGetProcAddress))
+    {
+        cout << "Failed to initialize GLAD" << endl;
+        exit(EXIT_FAILURE);
+    }
+    if (!GLAD_GL_VERSION_4_3)
+    {
+        cout << "Clustered lighting requires OpenGL 4.3" << endl;
+        glfwTerminate();
+        exit(EXIT_FAILURE);
+    }
+    camera.FarPlane = 150.0f;
+    glfwGetFramebufferSize(window, &fbWidth, &fbHeight);
+
+    std::unique_ptr<SceneRenderer> rendererPtr(new SceneRenderer(fbWidth, fbHeight));
+    SceneRenderer &renderer = *rendererPtr;
+
+    if (validateMode) {
+        int failures = validate(renderer);
+        rendererPtr.reset();
+        glfwTerminate();
+        return failures == 0 ? EXIT_SUCCESS : EXIT_FAILURE;
+    }
+
+    LightClusterer clusterer;
+    std::vector<ClusteredLight> lights;
+    std::vector<LightOrbit> orbits;
+    unsigned int generatedCount = 0;
+    float lightTime = 0.0f;
+    std::unique_ptr<GpuTimer> gpuTimer(new GpuTimer());
+    double gpuMs = 0.0;
+
+    // 渲染循环
+    // -----------
+    float titleTimer = 0.0f;
+    double assignMs = 0.0;
+    while (!glfwWindowShouldClose(window))
+    {
+        float currentFrame = glfwGetTime();
+        deltaTime = currentFrame - lastFrame;
+        lastFrame = currentFrame;
+
+        processInput(window);
+
+        if (generatedCount != lightCount) {
+            generateLights(lightCount, lights, orbits);
+            generatedCount = lightCount;
+        }
+        if (animateLights)
+            lightTime += deltaTime;
+        updateLights(lightTime, lights, orbits);
+
+        // 分配光源，簇的深度范围和摄像机一致，不会有片段落在最后一层之外
+        float aspect = (float)fbWidth / (float)fbHeight;
+        auto start = std::chrono::high_resolution_clock::now();
+        clusterer.SetProjection(glm::radians(camera.Zoom), aspect, camera.NearPlane, camera.FarPlane);
+        if (!bruteForce)
+            clusterer.Assign(lights, camera.GetViewMatrix(), multiThreaded ? 0 : 1, simdTests);
+        assignMs = std::chrono::duration<double, std::milli>(std::chrono::high_resolution_clock::now() - start).count();
+
+        renderer.Lights.UploadLights(lights);
+        if (!bruteForce)
+            renderer.Lights.UploadClusters(clusterer);
+        renderer.Lights.Bind();
+
+        gpuTimer->Begin();
+        renderer.Render(camera, clusterer, (unsigned int) lights.size(), deferredShading, bruteForce, 0, fbWidth, fbHeight);
+        gpuTimer->End();
+        gpuTimer->Poll(gpuMs);
+
+        titleTimer += deltaTime;
+        if (titleTimer > 0.5f) {
+            titleTimer = 0.0f;
+            std::string title = std::string("Clustered Lighting - ") + (deferredShading ? "deferred" : "forward") +
+                                " - " + std::to_string(lights.size()) + " lights - ";
+            if (bruteForce)
+                title += "brute force";
+            else
+                title += "assign " + std::to_string(assignMs) + " ms (" + (multiThreaded ? "MT" : "1T") + ", " +
+                         (simdTests ? "SIMD" : "scalar") + "), avg " +
+                         std::to_string((double) clusterer.Indices().size() / clusterer.ClusterCount()) +
+                         " max " + std::to_string(clusterer.MaxLightsPerCluster()) + " per cluster";
+            title += " - GPU " + std::to_string(gpuMs) + " ms - " + std::to_string(deltaTime * 1000.0f) + " ms";
+            glfwSetWindowTitle(window, title.c_str());
+        }
+
+        // glfw: 交换颜色缓冲，检测事件
+        // -------------------------------------------------------------------------------
+        glfwSwapBuffers(window);
+        glfwPollEvents();
+    }
+
+    gpuTimer.reset();
+    rendererPtr.reset();
+
+    glfwTerminate();
+    return 0;
+}
+
+SceneRenderer::SceneRenderer(int width, int height)
+        : Forward("clustered_lighting.vs", "clustered_lighting.fs"),
+          Geometry("clustered_lighting.vs", "deferred_gbuffer.fs"),
+          Lighting("deferred_lighting.vs", "deferred_lighting.fs"),
+          GBuf(width, height)
+{
+    // 定义顶点数据，包含位置、法线
+    float vertices[] = {
+            -0.5f, -0.5f, -0.5f,  0.0f,  0.0f, -1.0f,
+             0.5f, -0.5f, -0.5f,  0.0f,  0.0f, -1.0f,
+             0.5f,  0.5f, -0.5f,  0.0f,  0.0f, -1.0f,
+             0.5f,  0.5f, -0.5f,  0.0f,  0.0f, -1.0f,
+            -0.5f,  0.5f, -0.5f,  0.0f,  0.0f, -1.0f,
+            -0.5f, -0.5f, -0.5f,  0.0f,  0.0f, -1.0f,
+
+            -0.5f, -0.5f,  0.5f,  0.0f,  0.0f,  1.0f,
+             0.5f, -0.5f,  0.5f,  0.0f,  0.0f,  1.0f,
+             0.5f,  0.5f,  0.5f,  0.0f,  0.0f,  1.0f,
+             0.5f,  0.5f,  0.5f,  0.0f,  0.0f,  1.0f,
+            -0.5f,  0.5f,  0.5f,  0.0f,  0.0f,  1.0f,
+            -0.5f, -0.5f,  0.5f,  0.0f,  0.0f,  1.0f,
+
+            -0.5f,  0.5f,  0.5f, -1.0f,  0.0f,  0.0f,
+            -0.5f,  0.5f, -0.5f, -1.0f,  0.0f,  0.0f,
+            -0.5f, -0.5f, -0.5f, -1.0f,  0.0f,  0.0f,
+            -0.5f, -0.5f, -0.5f, -1.0f,  0.0f,  0.0f,
+            -0.5f, -0.5f,  0.5f, -1.0f,  0.0f,  0.0f,
+            -0.5f,  0.5f,  0.5f, -1.0f,  0.0f,  0.0f,
+
+             0.5f,  0.5f,  0.5f,  1.0f,  0.0f,  0.0f,
+             0.5f,  0.5f, -0.5f,  1.0f,  0.0f,  0.0f,
+             0.5f, -0.5f, -0.5f,  1.0f,  0.0f,  0.0f,
+             0.5f, -0.5f, -0.5f,  1.0f,  0.0f,  0.0f,
+             0.5f, -0.5f,  0.5f,  1.0f,  0.0f,  0.0f,
+             0.5f,  0.5f,  0.5f,  1.0f,  0.0f,  0.0f,
+
+            -0.5f, -0.5f, -0.5f,  0.0f, -1.0f,  0.0f,
+             0.5f, -0.5f, -0.5f,  0.0f, -1.0f,  0.0f,
+             0.5f, -0.5f,  0.5f,  0.0f, -1.0f,  0.0f,
+             0.5f, -0.5f,  0.5f,  0.0f, -1.0f,  0.0f,
+            -0.5f, -0.5f,  0.5f,  0.0f, -1.0f,  0.0f,
+            -0.5f, -0.5f, -0.5f,  0.0f, -1.0f,  0.0f,
+
+            -0.5f,  0.5f, -0.5f,  0.0f,  1.0f,  0.0f,
+             0.5f,  0.5f, -0.5f,  0.0f,  1.0f,  0.0f,
+             0.5f,  0.5f,  0.5f,  0.0f,  1.0f,  0.0f,
+             0.5f,  0.5f,  0.5f,  0.0f,  1.0f,  0.0f,
+            -0.5f,  0.5f,  0.5f,  0.0f,  1.0f,  0.0f,
+            -0.5f,  0.5f, -0.5f,  0.0f,  1.0f,  0.0f
+    };
+
+    // 实例0是地面（顶面在 y = 0），其余是立方体；材质是 albedo + 粗糙度
+    std::vector<glm::mat4> models;
+    std::vector<glm::vec4> materials;
+    glm::mat4 floor = glm::translate(glm::mat4(1.0f), glm::vec3(0.0f, -0.5f, 0.0f));
+    models.push_back(glm::scale(floor, glm::vec3(FLOOR_SIZE, 1.0f, FLOOR_SIZE)));
+    materials.push_back(glm::vec4(0.8f, 0.8f, 0.8f, 0.8f));
+    for (int z = 0; z < GRID; z++) {
+        for (int x = 0; x < GRID; x++) {
+            glm::mat4 model = glm::mat4(1.0f);
+            float height = 1.0f + (float) ((x * 7 + z * 13) % 5);
+            model = glm::translate(model, glm::vec3((x - GRID / 2 + 0.5f) * SPACING, height * 0.5f, (z - GRID / 2 + 0.5f) * SPACING));
+            model = glm::rotate(model, glm::radians(15.0f * (x + z)), glm::vec3(0.0f, 1.0f, 0.0f));
+            model = glm::scale(model, glm::vec3(1.5f, height, 1.5f));
+            models.push_back(model);
+            float roughness = 0.3f + 0.15f * (float) ((x + z * 3) % 5);
+            materials.push_back(glm::vec4(0.5f + 0.1f * (x % 5), 0.5f + 0.1f * (z % 5), 0.6f, roughness));
+        }
+    }
+    instanceCount = (GLsizei) models.size();
+
+    glGenBuffers(1, &modelBuffer);
+    glBindBuffer(GL_SHADER_STORAGE_BUFFER, modelBuffer);
+    glBufferData(GL_SHADER_STORAGE_BUFFER, models.size() * sizeof(glm::mat4), models.data(), GL_STATIC_DRAW);
+    glGenBuffers(1, &materialBuffer);
+    glBindBuffer(GL_SHADER_STORAGE_BUFFER, materialBuffer);
+    glBufferData(GL_SHADER_STORAGE_BUFFER, materials.size() * sizeof(glm::vec4), materials.data(), GL_STATIC_DRAW);
+    glBindBufferBase(GL_SHADER_STORAGE_BUFFER, 3, modelBuffer);
+    glBindBufferBase(GL_SHADER_STORAGE_BUFFER, 4, materialBuffer);
+
+    // 创建顶点缓冲和顶点数组
+    glGenVertexArrays(1, &VAO);
+    glGenBuffers(1, &VBO);
+
+    glBindVertexArray(VAO);
+    glBindBuffer(GL_ARRAY_BUFFER, VBO);
+    glBufferData(GL_ARRAY_BUFFER, sizeof(vertices), vertices, GL_STATIC_DRAW);
+
+    // 顶点位置
+    glVertexAttribPointer(0, 3, GL_FLOAT, GL_FALSE, 6 * sizeof(float), (void *)nullptr);
+    glEnableVertexAttribArray(0);
+    // 法线
+    glVertexAttribPointer(1, 3, GL_FLOAT, GL_FALSE, 6 * sizeof(float), (void *)(3 * sizeof(float)));
+    glEnableVertexAttribArray(1);
+
+    // 全屏三角形没有顶点属性，但核心模式下绘制时必须绑定一个VAO
+    glGenVertexArrays(1, &emptyVAO);
+
+    Lighting.use();
+    Lighting.setInt("gAlbedoRoughness", 0);
+    Lighting.setInt("gNormal", 1);
+    Lighting.setInt("gDepth", 2);
+}
+
+SceneRenderer::~SceneRenderer()
+{
+    glDeleteVertexArrays(1, &VAO);
+    glDeleteVertexArrays(1, &emptyVAO);
+    glDeleteBuffers(1, &VBO);
+    glDeleteBuffers(1, &modelBuffer);
+    glDeleteBuffers(1, &materialBuffer);
+}
+
+void SceneRenderer::setLightingUniforms(const Shader &shader, const Camera &cam, const LightClusterer &clusterer,
+                                        unsigned int count, bool brute, int width, int height) const
+{
+    shader.setVec3("viewPos", cam.Position);
+    shader.setFloat("ambientStrength", 0.05f);
+    shader.setVec2("screenSize", glm::vec2(width, height));
+    shader.setFloat("sliceScale", clusterer.SliceScale());
+    shader.setFloat("sliceBias", clusterer.SliceBias());
+    shader.setBool("bruteForce", brute);
+    glUniform3ui(glGetUniformLocation(shader.ID, "clusterCounts"), clusterer.TilesX(), clusterer.TilesY(), clusterer.Slices());
+    glUniform1ui(glGetUniformLocation(shader.ID, "lightCount"), count);
+}
+
+void SceneRenderer::Render(const Camera &cam, const LightClusterer &clusterer, unsigned int count, bool deferred, bool brute,
+                           unsigned int targetFBO, int width, int height)
+{
+    float aspect = (float) width / (float) height;
+    const glm::mat4 &projection = cam.GetProjectionMatrix(aspect);
+    const glm::mat4 &view = cam.GetViewMatrix();
+
+    glEnable(GL_DEPTH_TEST);
+    if (!deferred) {
+        glBindFramebuffer(GL_FRAMEBUFFER, targetFBO);
+        glViewport(0, 0, width, height);
+        glClearColor(0.0f, 0.0f, 0.0f, 1.0f);
+        glClear(GL_COLOR_BUFFER_BIT | GL_DEPTH_BUFFER_BIT);
+
+        Forward.use();
+        Forward.setMat4("projection", projection);
+        Forward.setMat4("view", view);
+        setLightingUniforms(Forward, cam, clusterer, count, brute, width, height);
+        glBindVertexArray(VAO);
+        glDrawArraysInstanced(GL_TRIANGLES, 0, 36, instanceCount);
+        return;
+    }
+
+    // 几何阶段：只写材质、法线和深度
+    GBuf.Resize(width, height);
+    GBuf.BindForGeometry();
+    Geometry.use();
+    Geometry.setMat4("projection", projection);
+    Geometry.setMat4("view", view);
+    glBindVertexArray(VAO);
+    glDrawArraysInstanced(GL_TRIANGLES, 0, 36, instanceCount);
+
+    // 光照阶段：每个像素只计算一次光照，和场景的重叠程度无关
+    glBindFramebuffer(GL_FRAMEBUFFER, targetFBO);
+    glViewport(0, 0, width, height);
+    glDisable(GL_DEPTH_TEST);
+    Lighting.use();
+    Lighting.setMat4("inverseProjection", glm::inverse(projection));
+    Lighting.setMat4("inverseView", glm::inverse(view));
+    setLightingUniforms(Lighting, cam, clusterer, count, brute, width, height);
+    GBuf.BindTextures(0);
+    glBindVertexArray(emptyVAO);
+    glDrawArrays(GL_TRIANGLES, 0, 3);
+    glEnable(GL_DEPTH_TEST);
+}
+
+void generateLights(unsigned int count, std::vector<ClusteredLight> &lights, std::vector<LightOrbit> &orbits)
+{
+    std::mt19937 rng(2024);
+    std::uniform_real_distribution<float> position(-FLOOR_SIZE * 0.45f, FLOOR_SIZE * 0.45f);
+    std::uniform_real_distribution<float> height(0.5f, 6.0f);
+    std::uniform_real_distribution<float> unit(0.0f, 1.0f);
+
+    float intensity = std::min(1.0f, std::sqrt(256.0f / count)) * 4.0f;
+    lights.clear();
+    orbits.clear();
+    for (unsigned int i = 0; i < count; i++) {
+        LightOrbit orbit;
+        orbit.Center = glm::vec3(position(rng), height(rng), position(rng));
+        orbit.Radius = 1.0f + 4.0f * unit(rng);
+        orbit.Speed = (unit(rng) - 0.5f) * 2.0f;
+        orbit.Phase = unit(rng) * 6.2831853f;
+        orbits.push_back(orbit);
+
+        glm::vec3 color = glm::vec3(0.3f) + 0.7f * glm::vec3(unit(rng), unit(rng), unit(rng));
+        float radius = 3.0f + 5.0f * unit(rng);
+        if (i % 4 == 3)
+            lights.push_back(MakeSpotLight(orbit.Center, glm::vec3(0.0f, -1.0f, 0.0f), radius + 4.0f,
+                                           15.0f + 10.0f * unit(rng), 30.0f + 15.0f * unit(rng), color, intensity * 2.0f));
+        else
+            lights.push_back(MakePointLight(orbit.Center, radius, color, intensity));
+    }
+}
+
+void updateLights(float time, std::vector<ClusteredLight> &lights, const std::vector<LightOrbit> &orbits)
+{
+    for (size_t i = 0; i < lights.size(); i++) {
+        const LightOrbit &orbit = orbits[i];
+        float angle = orbit.Phase + orbit.Speed * time;
+        glm::vec3 position = orbit.Center + orbit.Radius * glm::vec3(std::cos(angle), 0.0f, std::sin(angle));
+        lights[i].PositionRadius = glm::vec4(position, lights[i].PositionRadius.w);
+    }
+}
+
+// 1. 不同光源数量、不同相机位姿下，SIMD + 多线程、标量单线程的分配结果和逐簇逐光源测试的参考实现完全一致
+// 2. 光源数量从64到16384，输出各种分配方式的耗时
+// 3. 分簇渲染和逐像素计算所有光源的图像一致：超出范围的光源贡献为0，两者只差簇边界上的浮点误差
+// 4. 八面体编码量化成16位后的角度误差，以及延迟渲染和前向渲染的图像差别（法线、albedo量化和位置重建的误差）
+// 5. 不同光源数量下前向和延迟渲染的时间，以及G-buffer每帧写入和读取的数据量
+// ---------------------------------------------------------------------------------------------------------
+int validate(SceneRenderer &renderer)
+{
+    using std::cout;
+    using std::endl;
+    using Clock = std::chrono::high_resolution_clock;
+
+    struct Pose { glm::vec3 Position; float Yaw, Pitch; };
+    const Pose poses[] = {
+            {glm::vec3(  0.0f, 12.0f,  45.0f),  -90.0f, -20.0f},
+            {glm::vec3( 30.0f,  2.0f,  10.0f), -150.0f,   0.0f},
+            {glm::vec3(  0.0f, 60.0f,   0.0f),  -90.0f, -89.0f},
+            {glm::vec3(-10.0f,  3.0f, -10.0f),   45.0f,  10.0f}
+    };
+    const int width = SCR_WIDTH, height = SCR_HEIGHT;
+    float aspect = (float) width / height;
+    auto poseCamera = [](const Pose &pose) {
+        Camera cam(pose.Position, glm::vec3(0.0f, 1.0f, 0.0f), pose.Yaw, pose.Pitch);
+        cam.FarPlane = 150.0f;
+        return cam;
+    };
+
+    int failures = 0;
+    LightClusterer clusterer, reference;
+    std::vector<ClusteredLight> lights;
+    std::vector<LightOrbit> orbits;
+
+    // 结果一致性
+    for (unsigned int count : {256u, 2048u, 10000u}) {
+        generateLights(count, lights, orbits);
+        updateLights(1.0f, lights, orbits);
+        int index = 0;
+        for (const Pose &pose : poses) {
+            Camera cam = poseCamera(pose);
+            glm::mat4 view = cam.GetViewMatrix();
+            clusterer.SetProjection(glm::radians(cam.Zoom), aspect, cam.NearPlane, cam.FarPlane);
+            reference.SetProjection(glm::radians(cam.Zoom), aspect, cam.NearPlane, cam.FarPlane);
+            reference.AssignReference(lights, view);
+
+            bool ok = true;
+            const struct { unsigned int Threads; bool Simd; } modes[] = {{1, false}, {1, true}, {4, true}, {0, true}};
+            for (const auto &mode : modes) {
+                clusterer.Assign(lights, view, mode.Threads, mode.Simd);
+                ok = ok && clusterer.Clusters() == reference.Clusters() && clusterer.Indices() == reference.Indices();
+            }
+            cout << count << " lights, pose " << index++ << ": " << reference.Indices().size() << " entries, max "
+                 << reference.MaxLightsPerCluster() << " per cluster, " << clusterer.Tests() << " / "
+                 << reference.Tests() << " tests" << (ok ? " OK" : " MISMATCH") << endl;
+            if (!ok)
+                failures++;
+        }
+    }
+
+    // 分配耗时
+    {
+        Camera cam = poseCamera(poses[0]);
+        glm::mat4 view = cam.GetViewMatrix();
+        clusterer.SetProjection(glm::radians(cam.Zoom), aspect, cam.NearPlane, cam.FarPlane);
+        cout << "lights   scalar 1T(ms)  SIMD 1T(ms)  SIMD MT(ms)" << endl;
+        for (unsigned int count = MIN_LIGHTS; count <= MAX_LIGHTS; count *= 4) {
+            generateLights(count, lights, orbits);
+            updateLights(1.0f, lights, orbits);
+            double ms[3];
+            const struct { unsigned int Threads; bool Simd; } modes[] = {{1, false}, {1, true}, {0, true}};
+            for (int m = 0; m < 3; m++) {
+                const int runs = 10;
+                auto start = Clock::now();
+                for (int r = 0; r < runs; r++)
+                    clusterer.Assign(lights, view, modes[m].Threads, modes[m].Simd);
+                ms[m] = std::chrono::duration<double, std::milli>(Clock::now() - start).count() / runs;
+            }
+            cout << count << "\t " << ms[0] << "\t\t" << ms[1] << "\t     " << ms[2] << endl;
+        }
+    }
+
+    // 八面体编码的精度：和G-buffer一样量化到16位
+    {
+        std::mt19937 rng(7);
+        std::uniform_real_distribution<float> unit(-1.0f, 1.0f);
+        double maxAngle = 0.0;
+        for (int i = 0; i < 100000; i++) {
+            glm::vec3 n(unit(rng), unit(rng), unit(rng));
+            if (glm::dot(n, n) < 1e-4f)
+                continue;
+            n = glm::normalize(n);
+            glm::vec2 e = OctEncode(n) * 0.5f + 0.5f;
+            e = glm::vec2(std::round(e.x * 65535.0f), std::round(e.y * 65535.0f)) / 65535.0f;
+            glm::vec3 d = OctDecode(e * 2.0f - 1.0f);
+            // 夹角很小时 acos 在float精度下误差很大，用双精度的叉积和点积计算
+            double cx = (double) n.y * d.z - (double) n.z * d.y, cy = (double) n.z * d.x - (double) n.x * d.z,
+                   cz = (double) n.x * d.y - (double) n.y * d.x;
+            double dot = (double) n.x * d.x + (double) n.y * d.y + (double) n.z * d.z;
+            maxAngle = std::max(maxAngle, std::atan2(std::sqrt(cx * cx + cy * cy + cz * cz), dot) * 57.29577951);
+        }
+        bool ok = maxAngle < 0.02;
+        cout << "octahedral normals (RG16): max error " << maxAngle << " degrees" << (ok ? " OK" : " FAIL") << endl;
+        if (!ok)
+            failures++;
+    }
+
+    // 渲染结果对比
+    unsigned int FBO, colorBuffer, depthBuffer;
+    glGenFramebuffers(1, &FBO);
+    glBindFramebuffer(GL_FRAMEBUFFER, FBO);
+    glGenRenderbuffers(1, &colorBuffer);
+    glBindRenderbuffer(GL_RENDERBUFFER, colorBuffer);
+    glRenderbufferStorage(GL_RENDERBUFFER, GL_RGBA8, width, height);
+    glFramebufferRenderbuffer(GL_FRAMEBUFFER, GL_COLOR_ATTACHMENT0, GL_RENDERBUFFER, colorBuffer);
+    glGenRenderbuffers(1, &depthBuffer);
+    glBindRenderbuffer(GL_RENDERBUFFER, depthBuffer);
+    glRenderbufferStorage(GL_RENDERBUFFER, GL_DEPTH_COMPONENT24, width, height);
+    glFramebufferRenderbuffer(GL_FRAMEBUFFER, GL_DEPTH_ATTACHMENT, GL_RENDERBUFFER, depthBuffer);
+
+    auto render = [&](const Camera &cam, unsigned int count, bool deferred, bool brute, std::vector<unsigned char> &pixels) {
+        renderer.Render(cam, clusterer, count, deferred, brute, FBO, width, height);
+        pixels.resize((size_t) width * height * 4);
+        glBindFramebuffer(GL_FRAMEBUFFER, FBO);
+        glReadPixels(0, 0, width, height, GL_RGBA, GL_UNSIGNED_BYTE, pixels.data());
+    };
+    auto upload = [&](const Camera &cam) {
+        clusterer.SetProjection(glm::radians(cam.Zoom), aspect, cam.NearPlane, cam.FarPlane);
+        clusterer.Assign(lights, cam.GetViewMatrix());
+        renderer.Lights.UploadLights(lights);
+        renderer.Lights.UploadClusters(clusterer);
+        renderer.Lights.Bind();
+    };
+
+    generateLights(256, lights, orbits);
+    updateLights(1.0f, lights, orbits);
+    std::vector<unsigned char> clustered, brute, deferred;
+    int index = 0;
+    for (const Pose &pose : poses) {
+        Camera cam = poseCamera(pose);
+        upload(cam);
+        render(cam, (unsigned int) lights.size(), false, false, clustered);
+        render(cam, (unsigned int) lights.size(), false, true, brute);
+        render(cam, (unsigned int) lights.size(), true, false, deferred);
+
+        ImageDifference bruteDiff = CompareImages(clustered.data(), brute.data(), width, height);
+        ImageDifference deferredDiff = CompareImages(clustered.data(), deferred.data(), width, height);
+        // 画面不能是全黑的，否则对比没有意义
+        unsigned int lit = 0;
+        for (size_t i = 0; i < brute.size(); i += 4)
+            lit += brute[i] + brute[i + 1] + brute[i + 2] > 60;
+        bool ok = bruteDiff.MaxDiff <= 1 && lit > (unsigned int) (width * height / 50);
+        bool deferredOk = deferredDiff.Ssim >= 0.99 && deferredDiff.DiffFraction < 0.001;
+        cout << "render pose " << index++ << ": brute force max diff " << bruteDiff.MaxDiff << ", lit pixels " << lit
+             << (ok ? " OK" : " FAIL") << "; deferred SSIM " << deferredDiff.Ssim << ", max diff " << deferredDiff.MaxDiff
+             << ", " << deferredDiff.DiffFraction * 100.0 << "% pixels off by more than 16" << (deferredOk ? " OK" : " FAIL") << endl;
+        if (!ok || !deferredOk)
+            failures++;
+    }
+
+    // 渲染时间：每种设置连续渲染几帧，取平均；G-buffer的数据量按写入一次、读取一次计算
+    // 用 glFinish 前后的CPU时间而不是 GL_TIME_ELAPSED 查询：llvmpipe 等到刷新时才真正光栅化，
+    // 查询只能测到提交命令的时间
+    {
+        Camera cam = poseCamera(poses[0]);
+        double gbufferMB = 2.0 * GBuffer::BytesPerPixel * width * height / (1024.0 * 1024.0);
+        cout << "G-buffer: " << GBuffer::BytesPerPixel << " bytes/pixel, " << gbufferMB << " MB/frame at "
+             << width << "x" << height << endl;
+        cout << "lights   forward(ms)  deferred(ms)" << endl;
+        for (unsigned int count : {256u, 1024u, 4096u}) {
+            generateLights(count, lights, orbits);
+            updateLights(1.0f, lights, orbits);
+            upload(cam);
+            double ms[2];
+            for (int d = 0; d < 2; d++) {
+                const int frames = 3;
+                double total = 0.0;
+                // 第一帧包含着色器的首次使用等开销，不计入
+                renderer.Render(cam, clusterer, count, d == 1, false, FBO, width, height);
+                glFinish();
+                for (int f = 0; f < frames; f++) {
+                    auto start = Clock::now();
+                    renderer.Render(cam, clusterer, count, d == 1, false, FBO, width, height);
+                    glFinish();
+                    total += std::chrono::duration<double, std::milli>(Clock::now() - start).count();
+                }
+                ms[d] = total / frames;
+            }
+            cout << count << "\t " << ms[0] << "\t      " << ms[1] << endl;
+        }
+    }
+    glBindFramebuffer(GL_FRAMEBUFFER, 0);
+    glDeleteFramebuffers(1, &FBO);
+    glDeleteRenderbuffers(1, &colorBuffer);
+    glDeleteRenderbuffers(1, &depthBuffer);
+
+    cout << (failures == 0 ? "Clustered lighting matches reference" : "Clustered lighting validation FAILED") << endl;
+    return failures;
+}
+
+// process all input: query GLFW whether relevant keys are pressed/released this frame and react accordingly
+// ---------------------------------------------------------------------------------------------------------
+void processInput(GLFWwindow *window)
+{
+    if (glfwGetKey(window, GLFW_KEY_ESCAPE) == GLFW_PRESS)
+        glfwSetWindowShouldClose(window, true);
+
+    if (glfwGetKey(window, GLFW_KEY_W) == GLFW_PRESS)
+        camera.ProcessKeyboard(FORWARD, deltaTime);
+    if (glfwGetKey(window, GLFW_KEY_S) == GLFW_PRESS)
+        camera.ProcessKeyboard(BACKWARD, deltaTime);
+    if (glfwGetKey(window, GLFW_KEY_A) == GLFW_PRESS)
+        camera.ProcessKeyboard(LEFT, deltaTime);
+    if (glfwGetKey(window, GLFW_KEY_D) == GLFW_PRESS)
+        camera.ProcessKeyboard(RIGHT, deltaTime);
+}
+
+void key_callback(GLFWwindow* window, int key, int scancode, int action, int mods)
+{
+    if (action != GLFW_PRESS)
+        return;
+    if (key == GLFW_KEY_EQUAL)
+        lightCount = std::min(lightCount * 2, MAX_LIGHTS);
+    if (key == GLFW_KEY_MINUS)
+        lightCount = std::max(lightCount / 2, MIN_LIGHTS);
+    if (key == GLFW_KEY_R)
+        deferredShading = !deferredShading;
+    if (key == GLFW_KEY_B)
+        bruteForce = !bruteForce;
+    if (key == GLFW_KEY_SPACE)
+        animateLights = !animateLights;
+    if (key == GLFW_KEY_T)
+        multiThreaded = !multiThreaded;
+    if (key == GLFW_KEY_V)
+        simdTests = !simdTests;
+}
+
+// glfw: whenever the window size changed (by OS or user resize) this callback function executes
+// ---------------------------------------------------------------------------------------------
+void framebuffer_size_callback(GLFWwindow* window, int width, int height)
+{
+    fbWidth = width;
+    fbHeight = height;
+    glViewport(0, 0, width, height);
+}
+
+void mouse_callback(GLFWwindow* window, double xpos, double ypos) {
+    if (firstMouse) {
+        lastX = xpos;
+        lastY = ypos;
+        firstMouse = false;
+    }
+    float xoffset = xpos - lastX;
+    float yoffset = lastY - ypos;
+    lastX = xpos;
+    lastY = ypos;
+
+    camera.ProcessMouseMovement(xoffset, yoffset);
+}
+
+void scroll_callback(GLFWwindow* window, double xoffset, double yoffset)
+{
+    camera.ProcessMouseScroll(yoffset);
+}
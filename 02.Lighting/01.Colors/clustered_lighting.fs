@@ -0,0 +1,87 @@
+#version 430 core
+out vec4 FragColor;
+
+in vec3 FragPos;
+in vec3 Normal;
+in float ViewDepth;
+flat in vec4 Material;
+
+// 和 includes/learnopengl/clustered_lighting.h 中的 ClusteredLight 一致
+struct Light {
+    vec4 PositionRadius;
+    vec4 ColorIntensity;
+    vec4 DirectionCosOuter;
+    vec4 CosInner;
+};
+
+layout (std430, binding = 0) readonly buffer Lights {
+    Light lights[];
+};
+// 每个簇的 (光源编号的起始位置, 数量)
+layout (std430, binding = 1) readonly buffer Clusters {
+    uvec2 clusters[];
+};
+layout (std430, binding = 2) readonly buffer LightIndices {
+    uint lightIndices[];
+};
+
+uniform vec3 viewPos;
+uniform float ambientStrength;
+
+// 分簇参数：格子数、层数，层 = floor(log(深度) * sliceScale + sliceBias)
+uniform uvec3 clusterCounts;
+uniform vec2 screenSize;
+uniform float sliceScale;
+uniform float sliceBias;
+// 不分簇，每个片段计算所有光源，用来对比结果和性能
+uniform bool bruteForce;
+uniform uint lightCount;
+
+// Blinn-Phong，距离衰减在影响半径处平滑地降到0，超出半径的光源贡献正好为0，分簇时可以放心地跳过
+// 和 deferred_lighting.fs 中的实现相同
+vec3 CalcLight(Light light, vec3 fragPos, vec3 normal, vec3 viewDir, vec3 albedo, float shininess)
+{
+    vec3 toLight = light.PositionRadius.xyz - fragPos;
+    float distance = length(toLight);
+    float radius = light.PositionRadius.w;
+    if (distance >= radius)
+        return vec3(0.0);
+    vec3 lightDir = toLight / distance;
+
+    float ratio = distance / radius;
+    float window = clamp(1.0 - ratio * ratio * ratio * ratio, 0.0, 1.0);
+    float attenuation = window * window / (distance * distance + 1.0);
+    // 点光源的外锥角余弦为-2，smoothstep恒为1
+    float theta = dot(-lightDir, light.DirectionCosOuter.xyz);
+    float spot = smoothstep(light.DirectionCosOuter.w, light.CosInner.x, theta);
+
+    float diff = max(dot(normal, lightDir), 0.0);
+    vec3 halfway = normalize(lightDir + viewDir);
+    float spec = pow(max(dot(normal, halfway), 0.0), shininess);
+    vec3 color = light.ColorIntensity.rgb * light.ColorIntensity.a;
+    return (diff * albedo + 0.5 * spec) * attenuation * spot * color;
+}
+
+void main()
+{
+    vec3 normal = normalize(Normal);
+    vec3 viewDir = normalize(viewPos - FragPos);
+    vec3 albedo = Material.rgb;
+    // 粗糙度0 ~ 1 对应高光指数 2048 ~ 2
+    float shininess = exp2(1.0 + 10.0 * (1.0 - Material.a));
+    vec3 result = vec3(0.0);
+
+    if (bruteForce) {
+        for (uint i = 0u; i < lightCount; i++)
+            result += CalcLight(lights[i], FragPos, normal, viewDir, albedo, shininess);
+    } else {
+        uvec2 tile = min(uvec2(gl_FragCoord.xy * vec2(clusterCounts.xy) / screenSize), clusterCounts.xy - 1u);
+        float slice = clamp(floor(log(ViewDepth) * sliceScale + sliceBias), 0.0, float(clusterCounts.z - 1u));
+        uint cluster = tile.x + tile.y * clusterCounts.x + uint(slice) * clusterCounts.x * clusterCounts.y;
+        uvec2 range = clusters[cluster];
+        for (uint i = 0u; i < range.y; i++)
+            result += CalcLight(lights[lightIndices[range.x + i]], FragPos, normal, viewDir, albedo, shininess);
+    }
+
+    FragColor = vec4(ambientStrength * albedo + result, 1.0);
+}
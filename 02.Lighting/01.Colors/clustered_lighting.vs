@@ -0,0 +1,33 @@
+#version 430 core
+layout (location = 0) in vec3 aPos;
+layout (location = 1) in vec3 aNormal;
+
+// 每个实例的模型矩阵，实例0是地面
+layout (std430, binding = 3) readonly buffer Models {
+    mat4 models[];
+};
+// 每个实例的材质：albedo + 粗糙度
+layout (std430, binding = 4) readonly buffer Materials {
+    vec4 materials[];
+};
+
+out vec3 FragPos;
+out vec3 Normal;
+out float ViewDepth;
+flat out vec4 Material;
+
+uniform mat4 view;
+uniform mat4 projection;
+
+void main()
+{
+    mat4 model = models[gl_InstanceID];
+    vec4 worldPos = model * vec4(aPos, 1.0);
+    vec4 viewPos = view * worldPos;
+    FragPos = worldPos.xyz;
+    Normal = mat3(transpose(inverse(model))) * aNormal;
+    // 观察空间的深度（正数），用来确定片段所在的层
+    ViewDepth = -viewPos.z;
+    Material = materials[gl_InstanceID];
+    gl_Position = projection * viewPos;
+}
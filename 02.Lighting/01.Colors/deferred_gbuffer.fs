@@ -0,0 +1,26 @@
+#version 430 core
+// 延迟渲染的几何阶段，顶点着色器和前向渲染共用 clustered_lighting.vs
+layout (location = 0) out vec4 gAlbedoRoughness;
+layout (location = 1) out vec2 gNormal;
+
+in vec3 FragPos;
+in vec3 Normal;
+in float ViewDepth;
+flat in vec4 Material;
+
+// 八面体编码，结果在 [-1, 1]^2
+vec2 OctEncode(vec3 n)
+{
+    n /= abs(n.x) + abs(n.y) + abs(n.z);
+    vec2 e = n.xy;
+    if (n.z < 0.0)
+        e = (1.0 - abs(n.yx)) * vec2(n.x >= 0.0 ? 1.0 : -1.0, n.y >= 0.0 ? 1.0 : -1.0);
+    return e;
+}
+
+void main()
+{
+    gAlbedoRoughness = Material;
+    // RG16 是无符号归一化格式
+    gNormal = OctEncode(normalize(Normal)) * 0.5 + 0.5;
+}
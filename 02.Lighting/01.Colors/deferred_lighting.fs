@@ -0,0 +1,107 @@
+#version 430 core
+// 延迟渲染的光照阶段：每个像素从G-buffer读取材质和法线，由深度重建位置，再按所在簇的光源列表计算光照
+out vec4 FragColor;
+
+// 和 includes/learnopengl/clustered_lighting.h 中的 ClusteredLight 一致
+struct Light {
+    vec4 PositionRadius;
+    vec4 ColorIntensity;
+    vec4 DirectionCosOuter;
+    vec4 CosInner;
+};
+
+layout (std430, binding = 0) readonly buffer Lights {
+    Light lights[];
+};
+layout (std430, binding = 1) readonly buffer Clusters {
+    uvec2 clusters[];
+};
+layout (std430, binding = 2) readonly buffer LightIndices {
+    uint lightIndices[];
+};
+
+uniform sampler2D gAlbedoRoughness;
+uniform sampler2D gNormal;
+uniform sampler2D gDepth;
+
+uniform mat4 inverseProjection;
+uniform mat4 inverseView;
+uniform vec3 viewPos;
+uniform float ambientStrength;
+
+uniform uvec3 clusterCounts;
+uniform vec2 screenSize;
+uniform float sliceScale;
+uniform float sliceBias;
+uniform bool bruteForce;
+uniform uint lightCount;
+
+vec3 OctDecode(vec2 e)
+{
+    vec3 n = vec3(e, 1.0 - abs(e.x) - abs(e.y));
+    float t = max(-n.z, 0.0);
+    n.xy += vec2(n.x >= 0.0 ? -t : t, n.y >= 0.0 ? -t : t);
+    return normalize(n);
+}
+
+// 和 clustered_lighting.fs 中的实现相同
+vec3 CalcLight(Light light, vec3 fragPos, vec3 normal, vec3 viewDir, vec3 albedo, float shininess)
+{
+    vec3 toLight = light.PositionRadius.xyz - fragPos;
+    float distance = length(toLight);
+    float radius = light.PositionRadius.w;
+    if (distance >= radius)
+        return vec3(0.0);
+    vec3 lightDir = toLight / distance;
+
+    float ratio = distance / radius;
+    float window = clamp(1.0 - ratio * ratio * ratio * ratio, 0.0, 1.0);
+    float attenuation = window * window / (distance * distance + 1.0);
+    float theta = dot(-lightDir, light.DirectionCosOuter.xyz);
+    float spot = smoothstep(light.DirectionCosOuter.w, light.CosInner.x, theta);
+
+    float diff = max(dot(normal, lightDir), 0.0);
+    vec3 halfway = normalize(lightDir + viewDir);
+    float spec = pow(max(dot(normal, halfway), 0.0), shininess);
+    vec3 color = light.ColorIntensity.rgb * light.ColorIntensity.a;
+    return (diff * albedo + 0.5 * spec) * attenuation * spot * color;
+}
+
+void main()
+{
+    ivec2 pixel = ivec2(gl_FragCoord.xy);
+    float depth = texelFetch(gDepth, pixel, 0).r;
+    // 没有几何体的像素保持清屏颜色
+    if (depth == 1.0) {
+        FragColor = vec4(0.0, 0.0, 0.0, 1.0);
+        return;
+    }
+
+    // 由深度重建观察空间和世界空间的位置
+    vec4 ndc = vec4(gl_FragCoord.xy / screenSize * 2.0 - 1.0, depth * 2.0 - 1.0, 1.0);
+    vec4 viewSpace = inverseProjection * ndc;
+    viewSpace /= viewSpace.w;
+    vec3 fragPos = (inverseView * viewSpace).xyz;
+    float viewDepth = -viewSpace.z;
+
+    vec4 material = texelFetch(gAlbedoRoughness, pixel, 0);
+    vec3 albedo = material.rgb;
+    float shininess = exp2(1.0 + 10.0 * (1.0 - material.a));
+    vec3 normal = OctDecode(texelFetch(gNormal, pixel, 0).rg * 2.0 - 1.0);
+    vec3 viewDir = normalize(viewPos - fragPos);
+    vec3 result = vec3(0.0);
+
+    if (bruteForce) {
+        for (uint i = 0u; i < lightCount; i++)
+            result += CalcLight(lights[i], fragPos, normal, viewDir, albedo, shininess);
+    } else {
+        uvec2 tile = min(uvec2(gl_FragCoord.xy * vec2(clusterCounts.xy) / screenSize), clusterCounts.xy - 1u);
+        float slice = clamp(floor(log(viewDepth) * sliceScale + sliceBias), 0.0, float(clusterCounts.z - 1u));
+        uint cluster = tile.x + tile.y * clusterCounts.x + uint(slice) * clusterCounts.x * clusterCounts.y;
+        uvec2 range = clusters[cluster];
+        for (uint i = 0u; i < range.y; i++)
+            result += CalcLight(lights[lightIndices[range.x + i]], fragPos, normal, viewDir, albedo, shininess);
+    }
+
+    FragColor = vec4(ambientStrength * albedo + result, 1.0);
+}
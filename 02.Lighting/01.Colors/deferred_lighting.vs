@@ -0,0 +1,7 @@
+#version 430 core
+// 全屏三角形，不需要顶点缓冲：绘制3个顶点，覆盖 [-1, 3] 的范围，屏幕外的部分被裁剪掉
+void main()
+{
+    vec2 position = vec2((gl_VertexID << 1) & 2, gl_VertexID & 2);
+    gl_Position = vec4(position * 2.0 - 1.0, 0.0, 1.0);
+}
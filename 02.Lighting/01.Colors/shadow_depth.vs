@@ -0,0 +1,16 @@
+#version 430 core
+layout (location = 0) in vec3 aPos;
+
+layout (std430, binding = 3) readonly buffer Models {
+    mat4 models[];
+};
+layout (std430, binding = 5) readonly buffer Visible {
+    uint visible[];
+};
+
+uniform mat4 lightViewProjection;
+
+void main()
+{
+    gl_Position = lightViewProjection * models[visible[gl_InstanceID]] * vec4(aPos, 1.0);
+}
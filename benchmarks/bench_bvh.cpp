@@ -0,0 +1,146 @@
+// BVH基准测试：100万个包围盒上的建树、refit和各种查询吞吐量，并和线性扫描对比结果
+// 只依赖 glm 和 includes/learnopengl，不需要OpenGL
+//
+// 编译：g++ -O2 -std=c++14 -I../includes bench_bvh.cpp -o bench_bvh
+// 运行：./bench_bvh [包围盒数量]
+#include <iostream>
+#include <iomanip>
+#include <vector>
+#include <random>
+#include <chrono>
+#include <cstdlib>
+
+#include <glm/glm.hpp>
+#include <glm/gtc/matrix_transform.hpp>
+
+#include <learnopengl/bvh.h>
+
+using Clock = std::chrono::high_resolution_clock;
+
+static double millisecondsSince(Clock::time_point start)
+{
+    return std::chrono::duration<double, std::milli>(Clock::now() - start).count();
+}
+
+int main(int argc, char *argv[])
+{
+    using std::cout;
+    using std::endl;
+
+    const unsigned int count = argc > 1 ? (unsigned int) std::atoi(argv[1]) : 1000000;
+    const float worldSize = 1000.0f;
+
+    // 随机场景，固定种子保证每次结果一致
+    std::mt19937 rng(12345);
+    std::uniform_real_distribution<float> position(-worldSize * 0.5f, worldSize * 0.5f);
+    std::uniform_real_distribution<float> size(0.25f, 2.0f);
+    std::uniform_real_distribution<float> jitter(-0.5f, 0.5f);
+    std::uniform_real_distribution<float> angle(0.0f, 360.0f);
+
+    std::vector<AABB> boxes(count);
+    for (auto &box : boxes) {
+        glm::vec3 c(position(rng), position(rng), position(rng));
+        glm::vec3 e(size(rng), size(rng), size(rng));
+        box = AABB(c - e, c + e);
+    }
+
+    cout << std::fixed << std::setprecision(2);
+    cout << "boxes: " << count << endl;
+
+    // 建树
+    BVH bvh;
+    auto start = Clock::now();
+    bvh.Build(boxes);
+    double buildMs = millisecondsSince(start);
+    cout << "build:  " << buildMs << " ms, " << bvh.Nodes().size() << " nodes ("
+         << bvh.Nodes().size() * sizeof(BVHNode) / (1024.0 * 1024.0) << " MB)" << endl;
+
+    // 动态物体：每个包围盒随机移动一点，然后refit
+    std::vector<AABB> moved = boxes;
+    for (auto &box : moved) {
+        glm::vec3 d(jitter(rng), jitter(rng), jitter(rng));
+        box = AABB(box.Min + d, box.Max + d);
+    }
+    start = Clock::now();
+    bvh.Refit(moved);
+    double refitMs = millisecondsSince(start);
+    cout << "refit:  " << refitMs << " ms (degraded: " << (bvh.RefitDegraded() ? "yes" : "no") << ")" << endl;
+    bvh.Refit(boxes);
+
+    // 视锥体查询：随机相机，和线性扫描的结果数量对比
+    const int frustumQueries = 200;
+    std::vector<Frustum> frusta;
+    for (int i = 0; i < frustumQueries; i++) {
+        glm::vec3 eye(position(rng), position(rng), position(rng));
+        float yaw = glm::radians(angle(rng)), pitch = glm::radians(angle(rng) / 4.0f - 45.0f);
+        glm::vec3 front(cos(yaw) * cos(pitch), sin(pitch), sin(yaw) * cos(pitch));
+        glm::mat4 view = glm::lookAt(eye, eye + front, glm::vec3(0.0f, 1.0f, 0.0f));
+        glm::mat4 projection = glm::perspective(glm::radians(45.0f), 16.0f / 9.0f, 0.1f, 100.0f);
+        frusta.emplace_back(projection * view);
+    }
+
+    size_t bvhVisible = 0, linearVisible = 0;
+    start = Clock::now();
+    for (const auto &frustum : frusta)
+        bvh.QueryFrustum(frustum, [&](unsigned int) { bvhVisible++; });
+    double frustumMs = millisecondsSince(start);
+
+    start = Clock::now();
+    for (const auto &frustum : frusta)
+        for (const auto &box : boxes)
+            if (frustum.IntersectsAABB(box))
+                linearVisible++;
+    double linearMs = millisecondsSince(start);
+    cout << "frustum: " << frustumQueries / (frustumMs / 1000.0) << " queries/s (linear scan "
+         << frustumQueries / (linearMs / 1000.0) << " queries/s), visible "
+         << bvhVisible << " / " << linearVisible << (bvhVisible == linearVisible ? " OK" : " MISMATCH") << endl;
+
+    // 球查询：模拟点光源影响范围
+    const int sphereQueries = 100000;
+    size_t sphereHits = 0;
+    start = Clock::now();
+    for (int i = 0; i < sphereQueries; i++) {
+        glm::vec3 c(position(rng), position(rng), position(rng));
+        bvh.QuerySphere(c, 10.0f, [&](unsigned int) { sphereHits++; });
+    }
+    double sphereMs = millisecondsSince(start);
+    cout << "sphere: " << sphereQueries / (sphereMs / 1000.0) << " queries/s, "
+         << (double) sphereHits / sphereQueries << " hits/query" << endl;
+
+    // 包围盒查询
+    const int boxQueries = 100000;
+    size_t boxHits = 0;
+    start = Clock::now();
+    for (int i = 0; i < boxQueries; i++) {
+        glm::vec3 c(position(rng), position(rng), position(rng));
+        bvh.QueryAABB(AABB(c - glm::vec3(8.0f), c + glm::vec3(8.0f)), [&](unsigned int) { boxHits++; });
+    }
+    double boxMs = millisecondsSince(start);
+    cout << "aabb:   " << boxQueries / (boxMs / 1000.0) << " queries/s, "
+         << (double) boxHits / boxQueries << " hits/query" << endl;
+
+    // 射线查询：最近命中
+    const int rayQueries = 200000;
+    int rayHits = 0;
+    start = Clock::now();
+    for (int i = 0; i < rayQueries; i++) {
+        Ray ray(glm::vec3(position(rng), position(rng), position(rng)),
+                glm::normalize(glm::vec3(jitter(rng), jitter(rng), jitter(rng))));
+        glm::vec3 invDir = 1.0f / ray.Direction;
+        float tMax = worldSize;
+        bool hit = bvh.Raycast(ray, tMax, [&](unsigned int prim, float &t) {
+            float tEnter;
+            if (IntersectRayAABB(ray.Origin, invDir, boxes[prim], t, tEnter) && tEnter < t) {
+                t = tEnter;
+                return true;
+            }
+            return false;
+        });
+        rayHits += hit;
+    }
+    double rayMs = millisecondsSince(start);
+    cout << "ray:    " << rayQueries / (rayMs / 1000.0) << " rays/s, hit rate "
+         << 100.0 * rayHits / rayQueries << "%" << endl;
+
+    return bvhVisible == linearVisible ? EXIT_SUCCESS : EXIT_FAILURE;
+}
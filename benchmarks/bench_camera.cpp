@@ -0,0 +1,137 @@
+// 摄像机基准测试：高回报率鼠标每帧几百个事件，对比逐事件更新朝向的欧拉角摄像机和延迟计算的摄像机
+// 同时检查两者在相同输入下（包括89度俯仰限制和超过90度的翻转）得到的视图矩阵一致
+//
+// 编译：g++ -O2 -std=c++14 -I../includes bench_camera.cpp ../src/camera.cpp ../src/glad.c -o bench_camera
+// （和示例一样需要 glad 和 glm 的头文件；摄像机的反转深度函数会调用GL，需要一起链接 glad.c，运行时不会调用）
+// 运行：./bench_camera
+#include <iostream>
+#include <iomanip>
+#include <vector>
+#include <random>
+#include <chrono>
+#include <cmath>
+#include <cstdlib>
+
+#include <glm/glm.hpp>
+#include <glm/gtc/matrix_transform.hpp>
+
+#include <learnopengl/camera.h>
+
+using Clock = std::chrono::high_resolution_clock;
+
+static double millisecondsSince(Clock::time_point start)
+{
+    return std::chrono::duration<double, std::milli>(Clock::now() - start).count();
+}
+
+// 原来的摄像机：每个鼠标事件都重新计算Front/Right/Up，每次取视图矩阵都调用lookAt
+struct EulerCamera {
+    glm::vec3 Position, Front, Up, Right, WorldUp;
+    float Yaw, Pitch;
+    float MouseSensitivity = SENSITIVITY;
+
+    EulerCamera(glm::vec3 position, glm::vec3 up, float yaw, float pitch)
+            : Position(position), WorldUp(up), Yaw(yaw), Pitch(pitch) { updateCameraVectors(); }
+
+    glm::mat4 GetViewMatrix() { return glm::lookAt(Position, Position + Front, Up); }
+
+    void ProcessMouseMovement(float xoffset, float yoffset, bool constrainPitch) {
+        Yaw += xoffset * MouseSensitivity;
+        Pitch += yoffset * MouseSensitivity;
+        if (constrainPitch) {
+            if (Pitch > 89.0f)
+                Pitch = 89.0f;
+            if (Pitch < -89.0f)
+                Pitch = -89.0f;
+        }
+        updateCameraVectors();
+    }
+
+    void updateCameraVectors() {
+        glm::vec3 front;
+        front.x = cos(glm::radians(Yaw)) * cos(glm::radians(Pitch));
+        front.y = sin(glm::radians(Pitch));
+        front.z = sin(glm::radians(Yaw)) * cos(glm::radians(Pitch));
+        Front = glm::normalize(front);
+        Right = glm::normalize(glm::cross(Front, WorldUp));
+        Up    = glm::normalize(glm::cross(Right, Front));
+    }
+};
+
+static float maxDifference(const glm::mat4 &a, const glm::mat4 &b)
+{
+    float d = 0.0f;
+    for (int c = 0; c < 4; c++)
+        for (int r = 0; r < 4; r++)
+            d = std::max(d, std::fabs(a[c][r] - b[c][r]));
+    return d;
+}
+
+int main()
+{
+    using std::cout;
+    using std::endl;
+
+    const int frames = 2000;
+    const int eventsPerFrame = 500;     // 8000Hz鼠标在16ms的帧里大约产生这么多事件
+    const float aspect = 16.0f / 9.0f;
+
+    // 预先生成输入，两个摄像机使用相同的事件序列；偏向上方的漂移让俯仰角反复撞到89度限制
+    std::mt19937 rng(12345);
+    std::normal_distribution<float> delta(0.0f, 2.0f);
+    std::vector<glm::vec2> events(frames * eventsPerFrame);
+    for (auto &e : events)
+        e = glm::vec2(delta(rng), delta(rng) + 0.3f);
+
+    bool ok = true;
+    for (bool constrain : { true, false }) {
+        EulerCamera euler(glm::vec3(0.0f, 0.0f, 3.0f), glm::vec3(0.0f, 1.0f, 0.0f), YAW, PITCH);
+        Camera camera(glm::vec3(0.0f, 0.0f, 3.0f));
+        // 不限制俯仰角时只测少量事件，避免Pitch正好落在90度附近导致两边都是NaN
+        int count = constrain ? frames : 20;
+
+        float maxError = 0.0f;
+        float sink = 0.0f;     // 使用结果，避免被优化掉
+        auto start = Clock::now();
+        for (int f = 0; f < count; f++) {
+            for (int e = 0; e < eventsPerFrame; e++)
+                euler.ProcessMouseMovement(events[f * eventsPerFrame + e].x, events[f * eventsPerFrame + e].y, constrain);
+            glm::mat4 projection = glm::perspective(glm::radians(ZOOM), aspect, 0.1f, 100.0f);
+            sink += (projection * euler.GetViewMatrix())[3][2];
+        }
+        double eulerMs = millisecondsSince(start);
+
+        start = Clock::now();
+        for (int f = 0; f < count; f++) {
+            for (int e = 0; e < eventsPerFrame; e++)
+                camera.ProcessMouseMovement(events[f * eventsPerFrame + e].x, events[f * eventsPerFrame + e].y, constrain);
+            sink += camera.GetViewProjectionMatrix(aspect)[3][2];
+        }
+        double lazyMs = millisecondsSince(start);
+
+        // 逐帧对比
+        EulerCamera checkEuler(glm::vec3(0.0f, 0.0f, 3.0f), glm::vec3(0.0f, 1.0f, 0.0f), YAW, PITCH);
+        Camera checkCamera(glm::vec3(0.0f, 0.0f, 3.0f));
+        for (int f = 0; f < count; f++) {
+            for (int e = 0; e < eventsPerFrame; e++) {
+                checkEuler.ProcessMouseMovement(events[f * eventsPerFrame + e].x, events[f * eventsPerFrame + e].y, constrain);
+                checkCamera.ProcessMouseMovement(events[f * eventsPerFrame + e].x, events[f * eventsPerFrame + e].y, constrain);
+            }
+            checkCamera.ProcessKeyboard(FORWARD, 0.01f);
+            checkEuler.Position += checkEuler.Front * (SPEED * 0.01f);
+            maxError = std::max(maxError, maxDifference(checkEuler.GetViewMatrix(), checkCamera.GetViewMatrix()));
+            if (checkEuler.Pitch != checkCamera.Pitch)
+                maxError = INFINITY;
+        }
+        ok = ok && maxError < 1e-4f;
+
+        cout << std::fixed << std::setprecision(3)
+             << (constrain ? "constrained pitch:   " : "unconstrained pitch: ")
+             << count << " frames x " << eventsPerFrame << " events, euler " << eulerMs / count * 1000.0
+             << " us/frame, lazy " << lazyMs / count * 1000.0 << " us/frame ("
+             << std::setprecision(1) << eulerMs / lazyMs << "x), max view error "
+             << std::scientific << maxError << std::fixed << (sink == 12345.0f ? " " : "") << endl;
+    }
+
+    return ok ? EXIT_SUCCESS : EXIT_FAILURE;
+}
@@ -0,0 +1,85 @@
+// 分簇光照的光源分配基准测试：100到16384个点光源和聚光灯，分配到 16 x 9 x 24 个簇，
+// 对比标量单线程、SIMD单线程、SIMD多线程的耗时，并和逐簇逐光源测试的参考实现对比结果
+// 只依赖 glm 和 includes/learnopengl，不需要OpenGL上下文
+//
+// 编译：g++ -O2 -std=c++14 -pthread -I../includes bench_clustered_lighting.cpp -o bench_clustered_lighting
+// 运行：./bench_clustered_lighting
+#include <iostream>
+#include <iomanip>
+#include <vector>
+#include <random>
+#include <chrono>
+#include <cmath>
+#include <cstdlib>
+
+#include <glm/glm.hpp>
+#include <glm/gtc/matrix_transform.hpp>
+
+#include <learnopengl/clustered_lighting.h>
+
+using Clock = std::chrono::high_resolution_clock;
+
+static double millisecondsSince(Clock::time_point start)
+{
+    return std::chrono::duration<double, std::milli>(Clock::now() - start).count();
+}
+
+// 光源分布在摄像机前方 200 x 200 的区域里，四分之一是聚光灯
+static std::vector<ClusteredLight> makeLights(unsigned int count, std::mt19937 &rng)
+{
+    std::uniform_real_distribution<float> position(-100.0f, 100.0f);
+    std::uniform_real_distribution<float> unit(0.0f, 1.0f);
+    std::vector<ClusteredLight> lights;
+    for (unsigned int i = 0; i < count; i++) {
+        glm::vec3 p(position(rng), 10.0f * unit(rng), position(rng) - 100.0f);
+        glm::vec3 color(unit(rng), unit(rng), unit(rng));
+        float radius = 2.0f + 6.0f * unit(rng);
+        if (i % 4 == 3) {
+            glm::vec3 direction(unit(rng) - 0.5f, -1.0f, unit(rng) - 0.5f);
+            lights.push_back(MakeSpotLight(p, direction, radius * 1.5f, 20.0f, 20.0f + 30.0f * unit(rng), color));
+        } else
+            lights.push_back(MakePointLight(p, radius, color));
+    }
+    return lights;
+}
+
+int main()
+{
+    using std::cout;
+    using std::endl;
+
+    std::mt19937 rng(12345);
+    glm::mat4 view = glm::lookAt(glm::vec3(0.0f, 15.0f, 10.0f), glm::vec3(0.0f, 0.0f, -60.0f), glm::vec3(0.0f, 1.0f, 0.0f));
+
+    LightClusterer clusterer, reference;
+    clusterer.SetProjection(glm::radians(60.0f), 16.0f / 9.0f, 0.1f, 200.0f);
+    reference.SetProjection(glm::radians(60.0f), 16.0f / 9.0f, 0.1f, 200.0f);
+
+    int failures = 0;
+    cout << std::fixed << std::setprecision(3);
+    cout << "lights  scalar 1T(ms)  simd 1T(ms)  simd MT(ms)  entries  max/cluster  speedup" << endl;
+    for (unsigned int count : {100u, 1000u, 4000u, 10000u, 16384u}) {
+        std::vector<ClusteredLight> lights = makeLights(count, rng);
+        const struct { unsigned int Threads; bool Simd; } modes[] = {{1, false}, {1, true}, {0, true}};
+        double ms[3];
+        bool ok = true;
+        reference.AssignReference(lights, view);
+        for (int m = 0; m < 3; m++) {
+            // 先运行一次，分配好内部的缓冲
+            clusterer.Assign(lights, view, modes[m].Threads, modes[m].Simd);
+            ok = ok && clusterer.Clusters() == reference.Clusters() && clusterer.Indices() == reference.Indices();
+            int runs = count <= 1000 ? 200 : 20;
+            auto start = Clock::now();
+            for (int r = 0; r < runs; r++)
+                clusterer.Assign(lights, view, modes[m].Threads, modes[m].Simd);
+            ms[m] = millisecondsSince(start) / runs;
+        }
+        cout << std::setw(6) << count << std::setw(15) << ms[0] << std::setw(13) << ms[1] << std::setw(13) << ms[2]
+             << std::setw(9) << clusterer.Indices().size() << std::setw(13) << clusterer.MaxLightsPerCluster()
+             << std::setw(8) << std::setprecision(2) << ms[0] / ms[2] << "x" << std::setprecision(3)
+             << (ok ? "   OK" : "   MISMATCH") << endl;
+        if (!ok)
+            failures++;
+    }
+    return failures == 0 ? EXIT_SUCCESS : EXIT_FAILURE;
+}
@@ -0,0 +1,192 @@
+// 预烘焙网格的基准测试：生成细分的球面OBJ（默认100万个三角形），对比每次启动都解析OBJ（MeshImporter，所有线程）和
+// 打开烘焙好的 .mesh 文件的时间；上传用复制到另一块内存代替（glBufferData 也要把数据复制到驱动的内存中）
+// 同时检查烘焙的结果：32字节的顶点格式和导入的顶点逐位相同，LOD 0 的三角形和导入的相同（顺序按小簇重排），Verify 通过
+// 文件在当前目录生成，结束后删除；测的是文件已经在页缓存中的情况（刚写完）
+//
+// 编译：和引擎库一起构建（cmake --build . --target bench_cooked_mesh）
+// 运行：./bench_cooked_mesh [三角形数，百万，默认1]
+#include <iostream>
+#include <iomanip>
+#include <vector>
+#include <array>
+#include <string>
+#include <chrono>
+#include <algorithm>
+#include <cmath>
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
+#include <cstdint>
+
+#include <glm/glm.hpp>
+
+#include <learnopengl/cooked_mesh.h>
+
+using Clock = std::chrono::high_resolution_clock;
+
+static double millisecondsSince(Clock::time_point start)
+{
+    return std::chrono::duration<double, std::milli>(Clock::now() - start).count();
+}
+
+// 经纬度细分的球面，rings x segments 个四边形；每一行的最后一列位置和第一列相同，但纹理坐标是 u = 1
+static bool writeSphereObj(const char *path, int rings, int segments)
+{
+    FILE *file = std::fopen(path, "wb");
+    if (!file)
+        return false;
+    std::vector<char> buffer(1 << 20);
+    std::setvbuf(file, buffer.data(), _IOFBF, buffer.size());
+    const double PI = 3.14159265358979323846;
+    for (int r = 0; r <= rings; r++) {
+        double theta = PI * r / rings;
+        for (int s = 0; s < segments; s++) {
+            double phi = 2.0 * PI * s / segments;
+            double x = std::sin(theta) * std::cos(phi), y = std::cos(theta), z = -std::sin(theta) * std::sin(phi);
+            std::fprintf(file, "v %.6f %.6f %.6f\nvn %.6f %.6f %.6f\n", 50.0 * x, 50.0 * y, 50.0 * z, x, y, z);
+        }
+        for (int s = 0; s <= segments; s++)
+            std::fprintf(file, "vt %.6f %.6f\n", (double) s / segments, 1.0 - (double) r / rings);
+    }
+    for (int r = 0; r < rings; r++) {
+        for (int s = 0; s < segments; s++) {
+            long long p[4] = {(long long) r * segments + s + 1, (long long) (r + 1) * segments + s + 1,
+                              (long long) (r + 1) * segments + (s + 1) % segments + 1, (long long) r * segments + (s + 1) % segments + 1};
+            long long t[4] = {(long long) r * (segments + 1) + s + 1, (long long) (r + 1) * (segments + 1) + s + 1,
+                              (long long) (r + 1) * (segments + 1) + s + 2, (long long) r * (segments + 1) + s + 2};
+            std::fprintf(file, "f %lld/%lld/%lld %lld/%lld/%lld %lld/%lld/%lld %lld/%lld/%lld\n",
+                         p[0], t[0], p[0], p[1], t[1], p[1], p[2], t[2], p[2], p[3], t[3], p[3]);
+        }
+    }
+    return std::fclose(file) == 0;
+}
+
+// 三角形列表，每个三角形旋转到最小的顶点在前（不改变绕向）后排序，用来比较顺序不同的两组三角形
+static std::vector<std::array<uint32_t, 3>> sortedTriangles(const std::vector<uint32_t> &indices)
+{
+    std::vector<std::array<uint32_t, 3>> keys;
+    keys.reserve(indices.size() / 3);
+    for (size_t i = 0; i + 2 < indices.size(); i += 3) {
+        std::array<uint32_t, 3> v = {{indices[i], indices[i + 1], indices[i + 2]}};
+        std::rotate(v.begin(), std::min_element(v.begin(), v.end()), v.end());
+        keys.push_back(v);
+    }
+    std::sort(keys.begin(), keys.end());
+    return keys;
+}
+
+static std::vector<uint32_t> readIndices(const CookedMesh &mesh, const CookedLod &lod)
+{
+    std::vector<uint32_t> indices(lod.IndexCount);
+    for (uint32_t i = 0; i < lod.IndexCount; i++) {
+        size_t at = lod.IndexOffset + i;
+        if (mesh.IndexSize() == 2) {
+            uint16_t value;
+            std::memcpy(&value, mesh.IndexData() + at * 2, 2);
+            indices[i] = value;
+        } else {
+            std::memcpy(&indices[i], mesh.IndexData() + at * 4, 4);
+        }
+    }
+    return indices;
+}
+
+int main(int argc, char *argv[])
+{
+    using std::cout;
+    using std::endl;
+
+    double millions = argc > 1 ? std::atof(argv[1]) : 1.0;
+    const char *objPath = "bench_cooked_mesh.obj";
+    const char *paths[2] = {"bench_cooked_mesh_full.mesh", "bench_cooked_mesh_compact.mesh"};
+    // rings x 2rings 个四边形，每个两个三角形
+    int rings = std::max((int) std::sqrt(millions * 1e6 / 4.0), 4);
+    int segments = rings * 2;
+    cout << std::fixed << std::setprecision(2);
+    if (!writeSphereObj(objPath, rings, segments)) {
+        cout << "cannot write " << objPath << endl;
+        return EXIT_FAILURE;
+    }
+    int failures = 0;
+    auto check = [&failures](bool ok) {
+        cout << (ok ? "OK" : "FAILED") << endl;
+        if (!ok)
+            failures++;
+    };
+
+    // 1. 每次启动都解析OBJ，取5次中最快的
+    MeshImporter importer;
+    ImportedMesh mesh;
+    double parseMs = INFINITY;
+    size_t objBytes = 0;
+    for (int run = 0; run < 5; run++) {
+        if (!importer.LoadObj(objPath, mesh)) {
+            cout << importer.Error() << endl;
+            return EXIT_FAILURE;
+        }
+        parseMs = std::min(parseMs, importer.Stats().TotalMs);
+        objBytes = importer.Stats().Bytes;
+    }
+    std::remove(objPath);
+    cout << "cooked mesh: sphere " << rings << " x " << segments << ", " << mesh.TriangleCount() << " triangles, " << mesh.Vertices.size()
+         << " vertices" << endl;
+    cout << "format                   file(MB)  load(ms)  open(ms)  copy(ms)  speedup" << endl;
+    cout << std::left << std::setw(24) << "OBJ, parsed" << std::right << std::setw(10) << objBytes / (1024.0 * 1024.0) << std::setw(10) << parseMs
+         << endl;
+
+    // 2. 烘焙两种顶点格式，打开 + 复制顶点和索引，取5次中最快的
+    for (int compact = 0; compact < 2; compact++) {
+        MeshCooker cooker;
+        cooker.CompactVertices = compact != 0;
+        auto start = Clock::now();
+        if (!cooker.Write(mesh, paths[compact])) {
+            cout << cooker.Error() << endl;
+            return EXIT_FAILURE;
+        }
+        double cookMs = millisecondsSince(start);
+
+        double openMs = INFINITY, copyMs = INFINITY, loadMs = INFINITY;
+        std::vector<unsigned char> vertexCopy, indexCopy;
+        for (int run = 0; run < 5; run++) {
+            start = Clock::now();
+            CookedMesh cooked;
+            if (!cooked.Open(paths[compact])) {
+                cout << cooked.Error() << endl;
+                return EXIT_FAILURE;
+            }
+            double open = millisecondsSince(start);
+            auto copyStart = Clock::now();
+            vertexCopy.assign(cooked.VertexData(), cooked.VertexData() + cooked.VertexBytes());
+            indexCopy.assign(cooked.IndexData(), cooked.IndexData() + cooked.IndexBytes());
+            double copy = millisecondsSince(copyStart);
+            double total = millisecondsSince(start);
+            if (total < loadMs) {
+                loadMs = total;
+                openMs = open;
+                copyMs = copy;
+            }
+        }
+        CookedMesh cooked;
+        cooked.Open(paths[compact]);
+        cout << std::left << std::setw(24) << (compact ? "cooked, 20-byte vertices" : "cooked, 32-byte vertices") << std::right
+             << std::setw(10) << cooked.Header().FileSize / (1024.0 * 1024.0) << std::setw(10) << loadMs << std::setw(10) << openMs
+             << std::setw(10) << copyMs << std::setw(8) << std::setprecision(0) << parseMs / loadMs << "x" << std::setprecision(2)
+             << "   (cooked in " << cookMs << " ms)" << endl;
+
+        // 3. 检查内容
+        const CookedMeshHeader &header = cooked.Header();
+        bool ok = cooked.Verify() && header.VertexCount == mesh.Vertices.size() && cooked.Lod(0).IndexCount == mesh.Indices.size() &&
+                  sortedTriangles(readIndices(cooked, cooked.Lod(0))) == sortedTriangles(mesh.Indices);
+        if (!compact)
+            ok = ok && std::memcmp(cooked.VertexData(), mesh.Vertices.data(), cooked.VertexBytes()) == 0;
+        if (!ok)
+            cout << cooked.Error() << endl;
+        cout << "  " << header.MeshletCount << " meshlets, LOD triangles:";
+        for (unsigned int i = 0; i < header.LodCount; i++)
+            cout << " " << cooked.Lod(i).IndexCount / 3;
+        cout << (compact ? ", Verify passed " : ", vertices identical to the import, LOD 0 has the same triangles ");
+        check(ok);
+        std::remove(paths[compact]);
+    }
+    return failures == 0 ? EXIT_SUCCESS : EXIT_FAILURE;
+}
@@ -0,0 +1,297 @@
+// 网格导入的基准测试：生成指定大小的OBJ文件（细分的球面，位置 + 纹理坐标 + 法线，四边形面，经线接缝处纹理坐标不同），
+// 对比 iostream 逐行读取 + unordered_map 去重的常见写法和 MeshImporter 单线程、多线程的加载时间，检查结果相同；
+// 再把结果写成 .glb，对比零拷贝打开和展开成 ImportedMesh 的时间；最后用随机数检查浮点数解析和 strtod 的结果相同
+// 文件在当前目录生成，结束后删除；测的是文件已经在页缓存中的情况（刚写完）
+//
+// 编译：和引擎库一起构建（cmake --build . --target bench_mesh_import）
+// 运行：./bench_mesh_import [OBJ文件的大小，MB，默认32]，例如 ./bench_mesh_import 1024 测1GB的文件
+#include <iostream>
+#include <iomanip>
+#include <fstream>
+#include <sstream>
+#include <vector>
+#include <string>
+#include <chrono>
+#include <cmath>
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
+#include <cstdint>
+#include <unordered_map>
+#include <thread>
+
+#include <glm/glm.hpp>
+
+#include <learnopengl/mesh_import.h>
+
+using Clock = std::chrono::high_resolution_clock;
+
+static double millisecondsSince(Clock::time_point start)
+{
+    return std::chrono::duration<double, std::milli>(Clock::now() - start).count();
+}
+
+// 经纬度细分的球面，rings x segments 个四边形；每一行的最后一列位置和第一列相同，但纹理坐标是 u = 1
+// 奇数行的面用负索引（相对索引），分块解析时要按块的偏移换算
+static bool writeSphereObj(const char *path, int rings, int segments)
+{
+    FILE *file = std::fopen(path, "wb");
+    if (!file)
+        return false;
+    std::vector<char> buffer(1 << 20);
+    std::setvbuf(file, buffer.data(), _IOFBF, buffer.size());
+    std::fprintf(file, "# sphere %d x %d\no sphere\n", rings, segments);
+    const double PI = 3.14159265358979323846;
+    for (int r = 0; r <= rings; r++) {
+        double theta = PI * r / rings;
+        for (int s = 0; s < segments; s++) {
+            double phi = 2.0 * PI * s / segments;
+            double x = std::sin(theta) * std::cos(phi), y = std::cos(theta), z = std::sin(theta) * std::sin(phi);
+            std::fprintf(file, "v %.6f %.6f %.6f\n", 50.0 * x, 50.0 * y, 50.0 * z);
+            std::fprintf(file, "vn %.6f %.6f %.6f\n", x, y, z);
+        }
+        for (int s = 0; s <= segments; s++)
+            std::fprintf(file, "vt %.6f %.6f\n", (double) s / segments, 1.0 - (double) r / rings);
+    }
+    for (int r = 0; r < rings; r++) {
+        for (int s = 0; s < segments; s++) {
+            // 四个角：(r, s) (r + 1, s) (r + 1, s + 1) (r, s + 1)，位置和法线在经线上回绕，纹理坐标不回绕
+            long long p[4] = {(long long) r * segments + s, (long long) (r + 1) * segments + s,
+                              (long long) (r + 1) * segments + (s + 1) % segments, (long long) r * segments + (s + 1) % segments};
+            long long t[4] = {(long long) r * (segments + 1) + s, (long long) (r + 1) * (segments + 1) + s,
+                              (long long) (r + 1) * (segments + 1) + s + 1, (long long) r * (segments + 1) + s + 1};
+            std::fputc('f', file);
+            for (int k = 0; k < 4; k++) {
+                if (r % 2)
+                    std::fprintf(file, " %lld/%lld/%lld", p[k] - (long long) (rings + 1) * segments,
+                                 t[k] - (long long) (rings + 1) * (segments + 1), p[k] - (long long) (rings + 1) * segments);
+                else
+                    std::fprintf(file, " %lld/%lld/%lld", p[k] + 1, t[k] + 1, p[k] + 1);
+            }
+            std::fputc('\n', file);
+        }
+    }
+    return std::fclose(file) == 0;
+}
+
+// 常见的写法：getline + istringstream，(位置, 纹理坐标, 法线) 用 unordered_map 去重
+static bool loadObjNaive(const char *path, ImportedMesh &mesh)
+{
+    std::ifstream in(path);
+    if (!in)
+        return false;
+    mesh.Clear();
+    std::vector<glm::vec3> positions, normals;
+    std::vector<glm::vec2> texCoords;
+    struct KeyHash {
+        size_t operator()(const std::string &key) const { return std::hash<std::string>()(key); }
+    };
+    std::unordered_map<std::string, unsigned int, KeyHash> vertices;
+    std::string line, type, corner;
+    auto resolve = [](long long index, size_t count) { return index > 0 ? index - 1 : (long long) count + index; };
+    while (std::getline(in, line)) {
+        std::istringstream stream(line);
+        if (!(stream >> type))
+            continue;
+        if (type == "v") {
+            glm::vec3 v;
+            stream >> v.x >> v.y >> v.z;
+            positions.push_back(v);
+        } else if (type == "vt") {
+            glm::vec2 v;
+            stream >> v.x >> v.y;
+            texCoords.push_back(v);
+        } else if (type == "vn") {
+            glm::vec3 v;
+            stream >> v.x >> v.y >> v.z;
+            normals.push_back(v);
+        } else if (type == "f") {
+            std::vector<unsigned int> polygon;
+            while (stream >> corner) {
+                long long p = 0, t = 0, n = 0;
+                std::sscanf(corner.c_str(), "%lld/%lld/%lld", &p, &t, &n);
+                long long key[3] = {resolve(p, positions.size()), resolve(t, texCoords.size()), resolve(n, normals.size())};
+                std::string k(reinterpret_cast<const char *>(key), sizeof(key));
+                auto found = vertices.find(k);
+                if (found == vertices.end()) {
+                    MeshVertex vertex;
+                    vertex.Position = positions[key[0]];
+                    vertex.TexCoords = texCoords[key[1]];
+                    vertex.Normal = normals[key[2]];
+                    found = vertices.emplace(k, (unsigned int) mesh.Vertices.size()).first;
+                    mesh.Vertices.push_back(vertex);
+                    mesh.Bounds.Grow(vertex.Position);
+                }
+                polygon.push_back(found->second);
+            }
+            for (size_t i = 1; i + 1 < polygon.size(); i++)
+                mesh.Indices.insert(mesh.Indices.end(), {polygon[0], polygon[i], polygon[i + 1]});
+        }
+    }
+    mesh.HasNormals = mesh.HasTexCoords = true;
+    return true;
+}
+
+// 把网格写成 .glb：一个交错的顶点缓冲视图（步长32字节）和一个索引缓冲视图，纹理坐标按glTF的习惯翻转v
+static bool writeGlb(const char *path, const ImportedMesh &mesh)
+{
+    std::vector<MeshVertex> vertices = mesh.Vertices;
+    for (MeshVertex &vertex : vertices)
+        vertex.TexCoords.y = 1.0f - vertex.TexCoords.y;
+    size_t vertexBytes = vertices.size() * sizeof(MeshVertex), indexBytes = mesh.Indices.size() * sizeof(unsigned int);
+    std::ostringstream json;
+    json << "{\"asset\":{\"version\":\"2.0\"},\"scene\":0,\"scenes\":[{\"nodes\":[0]}],\"nodes\":[{\"mesh\":0}],"
+         << "\"meshes\":[{\"primitives\":[{\"attributes\":{\"POSITION\":0,\"NORMAL\":1,\"TEXCOORD_0\":2},\"indices\":3}]}],"
+         << "\"buffers\":[{\"byteLength\":" << vertexBytes + indexBytes << "}],"
+         << "\"bufferViews\":[{\"buffer\":0,\"byteOffset\":0,\"byteLength\":" << vertexBytes << ",\"byteStride\":32},"
+         << "{\"buffer\":0,\"byteOffset\":" << vertexBytes << ",\"byteLength\":" << indexBytes << "}],"
+         << "\"accessors\":["
+         << "{\"bufferView\":0,\"byteOffset\":0,\"componentType\":5126,\"count\":" << vertices.size() << ",\"type\":\"VEC3\","
+         << "\"min\":[" << mesh.Bounds.Min.x << "," << mesh.Bounds.Min.y << "," << mesh.Bounds.Min.z << "],"
+         << "\"max\":[" << mesh.Bounds.Max.x << "," << mesh.Bounds.Max.y << "," << mesh.Bounds.Max.z << "]},"
+         << "{\"bufferView\":0,\"byteOffset\":12,\"componentType\":5126,\"count\":" << vertices.size() << ",\"type\":\"VEC3\"},"
+         << "{\"bufferView\":0,\"byteOffset\":24,\"componentType\":5126,\"count\":" << vertices.size() << ",\"type\":\"VEC2\"},"
+         << "{\"bufferView\":1,\"componentType\":5125,\"count\":" << mesh.Indices.size() << ",\"type\":\"SCALAR\"}]}";
+    std::string text = json.str();
+    text.resize((text.size() + 3) & ~(size_t) 3, ' ');
+    size_t binBytes = vertexBytes + indexBytes;
+    uint32_t header[5] = {0x46546C67, 2, (uint32_t) (12 + 8 + text.size() + 8 + binBytes), (uint32_t) text.size(), 0x4E4F534A};
+    uint32_t binHeader[2] = {(uint32_t) binBytes, 0x004E4942};
+    std::ofstream out(path, std::ios::binary);
+    out.write(reinterpret_cast<const char *>(header), sizeof(header));
+    out.write(text.data(), (std::streamsize) text.size());
+    out.write(reinterpret_cast<const char *>(binHeader), sizeof(binHeader));
+    out.write(reinterpret_cast<const char *>(vertices.data()), (std::streamsize) vertexBytes);
+    out.write(reinterpret_cast<const char *>(mesh.Indices.data()), (std::streamsize) indexBytes);
+    return (bool) out;
+}
+
+// 两个网格的顶点和索引是否相同，纹理坐标允许 texCoordTolerance 的误差（glb中翻转了两次v）
+static bool sameMesh(const ImportedMesh &a, const ImportedMesh &b, float texCoordTolerance = 0.0f)
+{
+    if (a.Vertices.size() != b.Vertices.size() || a.Indices != b.Indices)
+        return false;
+    for (size_t i = 0; i < a.Vertices.size(); i++) {
+        const MeshVertex &u = a.Vertices[i], &v = b.Vertices[i];
+        if (u.Position != v.Position || u.Normal != v.Normal ||
+            std::abs(u.TexCoords.x - v.TexCoords.x) > texCoordTolerance || std::abs(u.TexCoords.y - v.TexCoords.y) > texCoordTolerance)
+            return false;
+    }
+    return true;
+}
+
+// 可重复的伪随机数
+static uint32_t nextRandom(uint32_t &state)
+{
+    state = state * 1664525u + 1013904223u;
+    return state;
+}
+
+int main(int argc, char *argv[])
+{
+    using std::cout;
+    using std::endl;
+
+    double megabytes = argc > 1 ? std::atof(argv[1]) : 32.0;
+    const char *objPath = "bench_mesh_import.obj";
+    const char *glbPath = "bench_mesh_import.glb";
+    // 每个网格顶点在文件中大约占 190 字节（v、vn、vt 和一个四边形面）
+    int rings = std::max((int) std::sqrt(megabytes * 1024.0 * 1024.0 / 190.0 / 2.0), 4);
+    int segments = rings * 2;
+    cout << std::fixed << std::setprecision(1);
+    auto start = Clock::now();
+    if (!writeSphereObj(objPath, rings, segments)) {
+        cout << "cannot write " << objPath << endl;
+        return EXIT_FAILURE;
+    }
+    double writeMs = millisecondsSince(start);
+    MappedFile probe(objPath);
+    double fileMb = probe.Size() / (1024.0 * 1024.0);
+    probe.Close();
+    cout << "mesh import: sphere " << rings << " x " << segments << ", " << (size_t) rings * segments * 2 << " triangles, OBJ "
+         << fileMb << " MB (written in " << writeMs << " ms), " << std::thread::hardware_concurrency() << " hardware threads" << endl;
+
+    int failures = 0;
+    cout << "loader                  time(ms)   MB/s    parse  merge   vertices  triangles" << endl;
+    auto report = [&](const char *name, double ms, const MeshImportStats *stats, const ImportedMesh &mesh, bool ok) {
+        cout << std::left << std::setw(22) << name << std::right << std::setw(10) << ms << std::setw(8) << fileMb * 1000.0 / ms;
+        if (stats)
+            cout << std::setw(9) << stats->ParseMs << std::setw(7) << stats->MergeMs;
+        else
+            cout << std::setw(16) << "";
+        cout << std::setw(11) << mesh.Vertices.size() << std::setw(11) << mesh.TriangleCount() << (ok ? "   OK" : "   MISMATCH") << endl;
+        if (!ok)
+            failures++;
+    };
+
+    // 1. iostream 的写法，作为对比和参考结果；文件很大时太慢，跳过
+    ImportedMesh reference, mesh;
+    bool haveReference = megabytes <= 256.0;
+    if (haveReference) {
+        start = Clock::now();
+        loadObjNaive(objPath, reference);
+        report("iostream + hash map", millisecondsSince(start), nullptr, reference, true);
+    }
+
+    // 2. MeshImporter：单线程、所有线程、很小的块（检查负索引跨块换算）
+    MeshImporter importer;
+    const struct { const char *Name; unsigned int Threads; size_t ChunkSize; } configs[] = {
+            {"importer 1 thread", 1, 4u << 20}, {"importer all threads", 0, 4u << 20}, {"importer 64 KB chunks", 0, 64u << 10}};
+    for (const auto &config : configs) {
+        importer.Threads = config.Threads;
+        importer.ChunkSize = config.ChunkSize;
+        bool ok = importer.LoadObj(objPath, mesh);
+        if (!ok)
+            cout << importer.Error() << endl;
+        if (!haveReference) {
+            reference = mesh;
+            haveReference = true;
+        }
+        ok = ok && sameMesh(mesh, reference);
+        report(config.Name, importer.Stats().TotalMs, &importer.Stats(), mesh, ok);
+    }
+
+    // 3. glb：零拷贝打开（映射 + 解析JSON），以及展开成 ImportedMesh
+    if (!writeGlb(glbPath, reference)) {
+        cout << "cannot write " << glbPath << endl;
+        failures++;
+    } else {
+        start = Clock::now();
+        GlbFile glb;
+        bool ok = glb.Open(glbPath) && glb.Primitives().size() == 1 && glb.Primitives()[0].Positions.Count == reference.Vertices.size();
+        double openMs = millisecondsSince(start);
+        cout << "glb open (zero-copy)  " << std::setw(10) << std::setprecision(3) << openMs << std::setprecision(1)
+             << "   accessors point into the mapped file" << (ok ? "   OK" : "   FAILED") << endl;
+        if (!ok)
+            failures++;
+        importer.Threads = 0;
+        ok = importer.LoadGlb(glbPath, mesh) && sameMesh(mesh, reference, 1e-6f);
+        report("glb load + flatten", importer.Stats().TotalMs, &importer.Stats(), mesh, ok);
+    }
+    std::remove(objPath);
+    std::remove(glbPath);
+
+    // 4. 浮点数解析：各种写法的随机数，结果和 strtod 再转成float相同
+    {
+        uint32_t state = 2024u;
+        const char *formats[] = {"%.6f", "%.9g", "%.3e", "%.17g", "%.0f"};
+        size_t mismatches = 0, total = 0;
+        char text[64];
+        for (int i = 0; i < 200000; i++) {
+            double magnitude = std::pow(10.0, (int) (nextRandom(state) % 13) - 6);
+            double value = ((double) nextRandom(state) / 4294967296.0 - 0.5) * magnitude;
+            int length = std::snprintf(text, sizeof(text), formats[i % 5], value);
+            float parsed = 0.0f;
+            const char *end = ParseFloat(text, text + length, parsed);
+            float expected = (float) std::strtod(text, nullptr);
+            if (end != text + length || parsed != expected)
+                mismatches++;
+            total++;
+        }
+        cout << "float parsing: " << total << " random numbers, " << mismatches << " differ from strtod "
+             << (mismatches == 0 ? "OK" : "FAILED") << endl;
+        if (mismatches != 0)
+            failures++;
+    }
+    return failures == 0 ? EXIT_SUCCESS : EXIT_FAILURE;
+}
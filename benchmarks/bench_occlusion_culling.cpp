@@ -0,0 +1,162 @@
+// 遮挡剔除的基准测试：密集的城市场景（街区里的楼房 + 街道上的小物体，约两万个物体），
+// 摄像机在街道上，楼房作为遮挡物光栅化到低分辨率缓冲，再测试视锥体内所有物体的包围盒
+// 对比标量单线程、AVX2单线程、AVX2多线程的光栅化和测试耗时、剔除比例，并检查三者的结果相同
+// 只依赖 glm 和 includes/learnopengl，不需要OpenGL上下文
+//
+// 编译：g++ -O2 -mavx2 -std=c++14 -pthread -I../includes bench_occlusion_culling.cpp -o bench_occlusion_culling
+// 运行：./bench_occlusion_culling
+#include <iostream>
+#include <iomanip>
+#include <vector>
+#include <cmath>
+#include <cstdlib>
+#include <algorithm>
+
+#include <glm/glm.hpp>
+#include <glm/gtc/matrix_transform.hpp>
+
+#include <learnopengl/bounds.h>
+#include <learnopengl/frustum.h>
+#include <learnopengl/occlusion_culling.h>
+
+// 以原点为中心的单位立方体，12个逆时针的三角形，只有位置
+static std::vector<float> makeBox()
+{
+    std::vector<float> vertices;
+    for (int axis = 0; axis < 3; axis++) {
+        for (int side = -1; side <= 1; side += 2) {
+            // 面上的两个切向量，叉积朝外
+            glm::vec3 n(0.0f), u(0.0f), v(0.0f);
+            n[axis] = (float) side;
+            u[(axis + 1) % 3] = 1.0f;
+            v[(axis + 2) % 3] = (float) side;
+            glm::vec3 c[4] = {0.5f * (n - u - v), 0.5f * (n + u - v), 0.5f * (n + u + v), 0.5f * (n - u + v)};
+            const int order[6] = {0, 1, 2, 2, 3, 0};
+            for (int k : order)
+                vertices.insert(vertices.end(), {c[k].x, c[k].y, c[k].z});
+        }
+    }
+    return vertices;
+}
+
+// 可重复的伪随机数
+static float random01(unsigned int &state)
+{
+    state = state * 1664525u + 1013904223u;
+    return (float) (state >> 8) / 16777216.0f;
+}
+
+int main()
+{
+    using std::cout;
+    using std::endl;
+
+    // 城市：BLOCKS x BLOCKS 个街区，每个街区 4 x 4 栋楼，楼之间的街道上放小物体
+    const int BLOCKS = 16, LOTS = 4;
+    const float LOT = 10.0f, STREET = 8.0f, BLOCK = LOTS * LOT + STREET;
+    std::vector<float> box = makeBox();
+    std::vector<AABB> boxes;
+    std::vector<glm::mat4> buildings;
+    // boxes 中每个物体对应的楼房，小物体是 -1
+    std::vector<int> buildingOf;
+    unsigned int seed = 12345u;
+    for (int bz = 0; bz < BLOCKS; bz++) {
+        for (int bx = 0; bx < BLOCKS; bx++) {
+            glm::vec3 origin(bx * BLOCK - BLOCKS * BLOCK * 0.5f, 0.0f, bz * BLOCK - BLOCKS * BLOCK * 0.5f);
+            for (int lz = 0; lz < LOTS; lz++) {
+                for (int lx = 0; lx < LOTS; lx++) {
+                    float height = 8.0f + 40.0f * random01(seed) * random01(seed);
+                    glm::vec3 size(LOT - 1.0f, height, LOT - 1.0f);
+                    glm::vec3 center = origin + glm::vec3((lx + 0.5f) * LOT, height * 0.5f, (lz + 0.5f) * LOT);
+                    buildingOf.push_back((int) buildings.size());
+                    buildings.push_back(glm::scale(glm::translate(glm::mat4(1.0f), center), size));
+                    boxes.push_back(AABB(center - size * 0.5f, center + size * 0.5f));
+                }
+            }
+            // 街道上的小物体（车、路灯、长椅……），每个街区60个
+            for (int i = 0; i < 60; i++) {
+                float along = random01(seed) * BLOCK, across = LOTS * LOT + 1.0f + random01(seed) * (STREET - 2.0f);
+                glm::vec3 center = random01(seed) < 0.5f ? origin + glm::vec3(along, 0.75f, across) : origin + glm::vec3(across, 0.75f, along);
+                glm::vec3 extents(0.5f + random01(seed), 0.75f, 0.5f + random01(seed));
+                buildingOf.push_back(-1);
+                boxes.push_back(AABB(center - extents, center + extents));
+            }
+        }
+    }
+
+    int failures = 0;
+    cout << "occlusion culling: " << (MaskedOcclusionCuller::HasAvx2() ? "AVX2" : "scalar only") << ", "
+         << boxes.size() << " objects, " << buildings.size() << " buildings" << endl;
+    cout << std::fixed << std::setprecision(3);
+    cout << "view     candidates  occluders  mode       raster(ms)  test(ms)  culled" << endl;
+
+    // 摄像机沿街道、在路口和高处
+    const struct { const char *Name; glm::vec3 Eye, Target; } views[] = {
+            {"street", glm::vec3(-3.0f, 1.7f, 4.0f * BLOCK + 3.0f), glm::vec3(-3.0f, 1.7f, -200.0f)},
+            {"corner", glm::vec3(44.0f, 1.7f, 44.0f), glm::vec3(-150.0f, 10.0f, -120.0f)},
+            {"aerial", glm::vec3(0.0f, 70.0f, 250.0f), glm::vec3(0.0f, 0.0f, 0.0f)},
+    };
+    glm::mat4 projection = glm::perspective(glm::radians(60.0f), 16.0f / 9.0f, 0.1f, 1000.0f);
+    MaskedOcclusionCuller culler(320, 192);
+    // 没有编译AVX2路径时 Simd 不起作用：不输出和标量相同的单线程一行，多线程一行按实际的路径命名
+    struct Mode { const char *Name; unsigned int Threads; bool Simd; };
+    std::vector<Mode> modes = {{"scalar 1T", 1, false}};
+    if (MaskedOcclusionCuller::HasAvx2())
+        modes.push_back({"avx2 1T", 1, true});
+    modes.push_back({MaskedOcclusionCuller::HasAvx2() ? "avx2 MT" : "scalar MT", 0, true});
+    for (const auto &view : views) {
+        glm::mat4 viewProjection = projection * glm::lookAt(view.Eye, view.Target, glm::vec3(0.0f, 1.0f, 0.0f));
+        Frustum frustum(viewProjection);
+        std::vector<unsigned int> candidates;
+        for (unsigned int i = 0; i < boxes.size(); i++)
+            if (frustum.IntersectsAABB(boxes[i]))
+                candidates.push_back(i);
+        // 遮挡物是视锥体内离摄像机最近的楼房，近处的先写入
+        std::vector<unsigned int> occluderIndices;
+        for (unsigned int i : candidates)
+            if (buildingOf[i] >= 0)
+                occluderIndices.push_back(i);
+        std::sort(occluderIndices.begin(), occluderIndices.end(), [&](unsigned int a, unsigned int b) {
+            return glm::length(boxes[a].Center() - view.Eye) < glm::length(boxes[b].Center() - view.Eye);
+        });
+        if (occluderIndices.size() > 512)
+            occluderIndices.resize(512);
+        std::vector<Occluder> occluders;
+        for (unsigned int i : occluderIndices) {
+            Occluder occluder;
+            occluder.Vertices = box.data();
+            occluder.VertexCount = (unsigned int) box.size() / 3;
+            occluder.Model = buildings[buildingOf[i]];
+            occluders.push_back(occluder);
+        }
+
+        std::vector<unsigned int> reference, visible;
+        for (size_t m = 0; m < modes.size(); m++) {
+            culler.Threads = modes[m].Threads;
+            culler.Simd = modes[m].Simd;
+            const int runs = 10;
+            double rasterMs = 0.0, testMs = 0.0;
+            for (int r = 0; r <= runs; r++) {
+                culler.Clear();
+                culler.RenderOccluders(occluders, viewProjection);
+                culler.Test(boxes, candidates, visible);
+                // 第一次运行只用来预热
+                if (r > 0) {
+                    rasterMs += culler.Stats().RasterMs;
+                    testMs += culler.Stats().TestMs;
+                }
+            }
+            bool ok = m == 0 || visible == reference;
+            if (m == 0)
+                reference = visible;
+            cout << std::left << std::setw(9) << view.Name << std::right << std::setw(10) << candidates.size()
+                 << std::setw(11) << occluders.size() << "  " << std::left << std::setw(10) << modes[m].Name << std::right
+                 << std::setw(11) << rasterMs / runs << std::setw(10) << testMs / runs << std::setw(7) << std::setprecision(1)
+                 << 100.0 * culler.Stats().Culled / std::max<size_t>(candidates.size(), 1) << "%" << std::setprecision(3)
+                 << (ok ? "   OK" : "   MISMATCH") << endl;
+            if (!ok)
+                failures++;
+        }
+    }
+    return failures == 0 ? EXIT_SUCCESS : EXIT_FAILURE;
+}
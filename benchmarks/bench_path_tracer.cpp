@@ -0,0 +1,179 @@
+// 路径追踪的基准测试：地面上 8 x 8 x 3 的立方体阵列，天空光 + 太阳，最多3次弹射
+// 1. 标量单线程、AVX2单线程、AVX2多线程的每秒射线数，并检查三者的图像逐字节相同、同一个种子两次渲染相同
+// 2. 收敛：换一个种子渲染 256 个样本的参考图像，再逐步累计样本，输出每个阶段的耗时和相对参考图像的均方根误差
+// 纹理是程序生成的棋盘格，只依赖 glm 和 includes/learnopengl，不需要OpenGL上下文
+//
+// 编译：g++ -O2 -mavx2 -std=c++14 -pthread -I../includes bench_path_tracer.cpp -o bench_path_tracer
+// 运行：./bench_path_tracer
+#include <iostream>
+#include <iomanip>
+#include <vector>
+#include <chrono>
+#include <cmath>
+#include <cstdlib>
+
+#include <glm/glm.hpp>
+#include <glm/gtc/matrix_transform.hpp>
+
+#include <learnopengl/path_tracer.h>
+
+using Clock = std::chrono::high_resolution_clock;
+
+static double millisecondsSince(Clock::time_point start)
+{
+    return std::chrono::duration<double, std::milli>(Clock::now() - start).count();
+}
+
+// 和 6.1.coordinate_systems 相同的立方体：位置 + 纹理坐标
+static const float cubeVertices[] = {
+        -0.5f, -0.5f, -0.5f,  0.0f, 0.0f,   0.5f, -0.5f, -0.5f,  1.0f, 0.0f,   0.5f,  0.5f, -0.5f,  1.0f, 1.0f,
+         0.5f,  0.5f, -0.5f,  1.0f, 1.0f,  -0.5f,  0.5f, -0.5f,  0.0f, 1.0f,  -0.5f, -0.5f, -0.5f,  0.0f, 0.0f,
+        -0.5f, -0.5f,  0.5f,  0.0f, 0.0f,   0.5f, -0.5f,  0.5f,  1.0f, 0.0f,   0.5f,  0.5f,  0.5f,  1.0f, 1.0f,
+         0.5f,  0.5f,  0.5f,  1.0f, 1.0f,  -0.5f,  0.5f,  0.5f,  0.0f, 1.0f,  -0.5f, -0.5f,  0.5f,  0.0f, 0.0f,
+        -0.5f,  0.5f,  0.5f,  1.0f, 0.0f,  -0.5f,  0.5f, -0.5f,  1.0f, 1.0f,  -0.5f, -0.5f, -0.5f,  0.0f, 1.0f,
+        -0.5f, -0.5f, -0.5f,  0.0f, 1.0f,  -0.5f, -0.5f,  0.5f,  0.0f, 0.0f,  -0.5f,  0.5f,  0.5f,  1.0f, 0.0f,
+         0.5f,  0.5f,  0.5f,  1.0f, 0.0f,   0.5f,  0.5f, -0.5f,  1.0f, 1.0f,   0.5f, -0.5f, -0.5f,  0.0f, 1.0f,
+         0.5f, -0.5f, -0.5f,  0.0f, 1.0f,   0.5f, -0.5f,  0.5f,  0.0f, 0.0f,   0.5f,  0.5f,  0.5f,  1.0f, 0.0f,
+        -0.5f, -0.5f, -0.5f,  0.0f, 1.0f,   0.5f, -0.5f, -0.5f,  1.0f, 1.0f,   0.5f, -0.5f,  0.5f,  1.0f, 0.0f,
+         0.5f, -0.5f,  0.5f,  1.0f, 0.0f,  -0.5f, -0.5f,  0.5f,  0.0f, 0.0f,  -0.5f, -0.5f, -0.5f,  0.0f, 1.0f,
+        -0.5f,  0.5f, -0.5f,  0.0f, 1.0f,   0.5f,  0.5f, -0.5f,  1.0f, 1.0f,   0.5f,  0.5f,  0.5f,  1.0f, 0.0f,
+         0.5f,  0.5f,  0.5f,  1.0f, 0.0f,  -0.5f,  0.5f,  0.5f,  0.0f, 0.0f,  -0.5f,  0.5f, -0.5f,  0.0f, 1.0f
+};
+
+// size x size 的棋盘格，每格 cell 个纹素
+static SoftwareTexture makeChecker(int size, int cell, const glm::vec3 &a, const glm::vec3 &b)
+{
+    std::vector<unsigned char> data((size_t) size * size * 3);
+    for (int y = 0; y < size; y++) {
+        for (int x = 0; x < size; x++) {
+            const glm::vec3 &c = ((x / cell + y / cell) % 2) ? a : b;
+            unsigned char *p = &data[((size_t) y * size + x) * 3];
+            p[0] = (unsigned char) (c.x * 255.0f);
+            p[1] = (unsigned char) (c.y * 255.0f);
+            p[2] = (unsigned char) (c.z * 255.0f);
+        }
+    }
+    return SoftwareTexture(data.data(), size, size, 3);
+}
+
+// 两张图像线性颜色的均方根误差
+static double rmse(const PathTracer &a, const std::vector<glm::vec3> &reference)
+{
+    double sum = 0.0;
+    for (int y = 0; y < a.Height(); y++)
+        for (int x = 0; x < a.Width(); x++) {
+            glm::vec3 d = a.Pixel(x, y) - reference[(size_t) y * a.Width() + x];
+            sum += glm::dot(d, d) / 3.0;
+        }
+    return std::sqrt(sum / ((double) a.Width() * a.Height()));
+}
+
+int main()
+{
+    using std::cout;
+    using std::endl;
+
+    SoftwareTexture texture1 = makeChecker(512, 32, glm::vec3(0.8f, 0.6f, 0.4f), glm::vec3(0.5f, 0.35f, 0.2f));
+    SoftwareTexture texture2 = makeChecker(256, 8, glm::vec3(1.0f, 1.0f, 0.0f), glm::vec3(0.0f, 0.0f, 0.0f));
+    SoftwareTexture groundTexture = makeChecker(64, 8, glm::vec3(0.7f, 0.7f, 0.7f), glm::vec3(0.45f, 0.45f, 0.45f));
+    SoftwareMaterial material;
+    material.Texture1 = &texture1;
+    material.Texture2 = &texture2;
+    material.Mix = 0.2f;
+    SoftwareMaterial groundMaterial;
+    groundMaterial.Texture1 = &groundTexture;
+
+    const int WIDTH = 320, HEIGHT = 240;
+    PathTracer tracer(WIDTH, HEIGHT);
+    // 地面是压扁的大立方体
+    tracer.AddMesh(cubeVertices, 36, glm::scale(glm::translate(glm::mat4(1.0f), glm::vec3(0.0f, -0.55f, -6.0f)), glm::vec3(40.0f, 0.1f, 40.0f)), groundMaterial);
+    const int GRID = 8;
+    for (int z = 0; z < 3; z++)
+        for (int y = 0; y < GRID; y++)
+            for (int x = 0; x < GRID; x++) {
+                glm::vec3 position(x * 1.6f - GRID * 0.8f, z * 1.2f, -y * 1.6f - 1.0f);
+                glm::mat4 model = glm::translate(glm::mat4(1.0f), position);
+                model = glm::rotate(model, glm::radians(17.0f * (x + y + z)), glm::normalize(glm::vec3(1.0f, 0.3f, 0.5f)));
+                tracer.AddMesh(cubeVertices, 36, glm::scale(model, glm::vec3(0.8f)), material);
+            }
+    tracer.Build();
+    tracer.SkyColor = glm::vec3(0.5f, 0.6f, 0.7f);
+    tracer.SunColor = glm::vec3(1.0f, 0.95f, 0.85f);
+    tracer.MaxBounces = 3;
+    glm::mat4 view = glm::lookAt(glm::vec3(0.5f, 3.0f, 5.0f), glm::vec3(0.0f, 0.5f, -6.0f), glm::vec3(0.0f, 1.0f, 0.0f));
+    glm::mat4 projection = glm::perspective(glm::radians(45.0f), (float) WIDTH / HEIGHT, 0.1f, 100.0f);
+
+    int failures = 0;
+    cout << "path tracer: " << (PathTracer::HasAvx2() ? "AVX2" : "scalar only") << ", " << tracer.TriangleCount()
+         << " triangles, " << WIDTH << "x" << HEIGHT << endl;
+    cout << std::fixed << std::setprecision(3);
+
+    // 1. 吞吐量和确定性
+    cout << "mode        spp  time(ms)  Mrays/s  rays/sample" << endl;
+    // 没有编译AVX2路径时 Simd 不起作用：不输出和标量相同的单线程一行，多线程一行按实际的路径命名
+    struct Mode { const char *Name; unsigned int Threads; bool Simd; };
+    std::vector<Mode> modes = {{"scalar 1T", 1, false}};
+    if (PathTracer::HasAvx2())
+        modes.push_back({"avx2 1T", 1, true});
+    modes.push_back({PathTracer::HasAvx2() ? "avx2 MT" : "scalar MT", 0, true});
+    const unsigned int SPP = 4;
+    std::vector<unsigned char> reference, pixels;
+    for (size_t m = 0; m < modes.size(); m++) {
+        tracer.Threads = modes[m].Threads;
+        tracer.Simd = modes[m].Simd;
+        tracer.SetCamera(view, projection);
+        tracer.Render(SPP);
+        tracer.ReadPixels(m == 0 ? reference : pixels);
+        bool ok = m == 0 || pixels == reference;
+        const PathTracerStats &stats = tracer.Stats();
+        cout << std::left << std::setw(10) << modes[m].Name << std::right << std::setw(5) << SPP << std::setw(10) << stats.Ms
+             << std::setw(9) << stats.RaysPerSecond() * 1e-6 << std::setw(13) << (double) stats.Rays() / stats.Samples
+             << (ok ? "   OK" : "   MISMATCH") << endl;
+        if (!ok)
+            failures++;
+    }
+    tracer.SetCamera(view, projection);
+    tracer.Render(SPP);
+    tracer.ReadPixels(pixels);
+    bool repeatable = pixels == reference;
+    cout << "same seed rendered twice: " << (repeatable ? "identical" : "DIFFERENT") << endl;
+    if (!repeatable)
+        failures++;
+
+    // 2. 收敛：误差应该按 1/sqrt(样本数) 下降；分辨率减半，参考图像不用渲染太久
+    const int SMALL_WIDTH = WIDTH / 2, SMALL_HEIGHT = HEIGHT / 2;
+    tracer.Resize(SMALL_WIDTH, SMALL_HEIGHT);
+    tracer.Threads = 0;
+    tracer.Simd = true;
+    tracer.Seed = 1234;
+    tracer.SetCamera(view, projection);
+    auto start = Clock::now();
+    tracer.Render(256);
+    double referenceMs = millisecondsSince(start);
+    std::vector<glm::vec3> converged((size_t) SMALL_WIDTH * SMALL_HEIGHT);
+    for (int y = 0; y < SMALL_HEIGHT; y++)
+        for (int x = 0; x < SMALL_WIDTH; x++)
+            converged[(size_t) y * SMALL_WIDTH + x] = tracer.Pixel(x, y);
+    cout << "reference: " << SMALL_WIDTH << "x" << SMALL_HEIGHT << ", 256 spp in " << referenceMs << " ms" << endl;
+
+    tracer.Seed = 1;
+    tracer.SetCamera(view, projection);
+    cout << "spp   time(ms)   rmse      rmse * sqrt(spp)" << endl;
+    double elapsed = 0.0, firstError = 0.0, lastError = 0.0;
+    for (unsigned int target = 1; target <= 64; target *= 2) {
+        tracer.Render(target - tracer.SampleCount());
+        elapsed += tracer.Stats().Ms;
+        double error = rmse(tracer, converged);
+        if (target == 1)
+            firstError = error;
+        lastError = error;
+        cout << std::setw(3) << target << std::setw(11) << elapsed << std::setw(10) << std::setprecision(5) << error
+             << std::setw(12) << error * std::sqrt((double) target) << std::setprecision(3) << endl;
+    }
+    // 从1到64个样本，误差理想情况下降到 1/8，留一些余量给参考图像本身的噪声
+    bool converging = lastError < firstError * 0.2;
+    cout << "convergence: " << (converging ? "OK" : "FAILED") << endl;
+    if (!converging)
+        failures++;
+    return failures == 0 ? EXIT_SUCCESS : EXIT_FAILURE;
+}
@@ -0,0 +1,225 @@
+// 场景图基准测试：100万个节点的层级，对比全量更新和只修改一个节点时的增量更新
+// 另外用随机的创建、删除、改父节点、修改变换操作，和独立的递归参考实现对比世界矩阵，检查旧句柄失效：
+// 通过已经删除的句柄调用 Set*、SetParent、Get*，不能改动复用了槽位的节点，读到的是默认值
+// 只依赖 glm 和 includes/learnopengl，不需要OpenGL
+//
+// 编译：g++ -O2 -std=c++14 -I../includes bench_scene_graph.cpp -o bench_scene_graph
+// 运行：./bench_scene_graph
+#include <iostream>
+#include <iomanip>
+#include <vector>
+#include <map>
+#include <random>
+#include <chrono>
+#include <cmath>
+#include <cstdlib>
+
+#include <glm/glm.hpp>
+#include <glm/gtc/matrix_transform.hpp>
+#include <glm/gtc/quaternion.hpp>
+
+// 模糊测试有意使用失效的句柄，调试版本中也不要断言
+#define LEARNOPENGL_SCENE_GRAPH_ASSERT_HANDLES 0
+#include <learnopengl/scene_graph.h>
+
+using Clock = std::chrono::high_resolution_clock;
+
+static double millisecondsSince(Clock::time_point start)
+{
+    return std::chrono::duration<double, std::milli>(Clock::now() - start).count();
+}
+
+// 参考实现：每个节点单独保存父节点和局部变换，递归求世界矩阵
+struct ReferenceNode {
+    SceneHandle Parent;
+    glm::vec3 Position;
+    glm::quat Rotation;
+    glm::vec3 Scale;
+};
+
+static uint64_t key(SceneHandle h)
+{
+    return ((uint64_t) h.Generation << 32) | h.Index;
+}
+
+static glm::mat4 referenceWorld(const std::map<uint64_t, ReferenceNode> &reference, SceneHandle h)
+{
+    const ReferenceNode &node = reference.at(key(h));
+    glm::mat4 local = glm::translate(glm::mat4(1.0f), node.Position) * glm::mat4_cast(node.Rotation);
+    local = glm::scale(local, node.Scale);
+    if (node.Parent.Index == UINT32_MAX)
+        return local;
+    return referenceWorld(reference, node.Parent) * local;
+}
+
+static bool isAncestor(const std::map<uint64_t, ReferenceNode> &reference, SceneHandle ancestor, SceneHandle h)
+{
+    for (SceneHandle p = h; p.Index != UINT32_MAX; p = reference.at(key(p)).Parent)
+        if (p == ancestor)
+            return true;
+    return false;
+}
+
+// 随机操作，和参考实现对比；mirror模拟GPU上的实例缓冲，只按UpdatedRange复制
+static int fuzz()
+{
+    std::mt19937 rng(12345);
+    std::uniform_real_distribution<float> unit(-1.0f, 1.0f);
+    auto randomRotation = [&]() {
+        return glm::angleAxis(unit(rng) * 3.0f, glm::normalize(glm::vec3(unit(rng), unit(rng), unit(rng)) + glm::vec3(0.0f, 0.0f, 1e-3f)));
+    };
+
+    SceneGraph graph;
+    std::map<uint64_t, ReferenceNode> reference;
+    std::vector<SceneHandle> alive, destroyed;
+    std::vector<glm::mat4> mirror;
+    int failures = 0;
+
+    for (int step = 0; step < 3000; step++) {
+        int op = std::uniform_int_distribution<int>(0, 9)(rng);
+        auto pickAlive = [&]() { return alive[std::uniform_int_distribution<size_t>(0, alive.size() - 1)(rng)]; };
+
+        if (op < 4 || alive.size() < 4) {
+            SceneHandle parent = !alive.empty() && op != 0 ? pickAlive() : SceneHandle();
+            ReferenceNode node{parent, glm::vec3(unit(rng), unit(rng), unit(rng)) * 3.0f, randomRotation(),
+                               glm::vec3(1.0f + 0.2f * unit(rng))};
+            SceneHandle h = graph.Create(node.Position, node.Rotation, node.Scale, parent);
+            reference[key(h)] = node;
+            alive.push_back(h);
+        } else if (op < 7) {
+            SceneHandle h = pickAlive();
+            ReferenceNode &node = reference[key(h)];
+            node.Position = glm::vec3(unit(rng), unit(rng), unit(rng)) * 3.0f;
+            node.Rotation = randomRotation();
+            graph.SetPosition(h, node.Position);
+            graph.SetRotation(h, node.Rotation);
+        } else if (op < 9) {
+            SceneHandle h = pickAlive();
+            SceneHandle parent = op == 7 ? pickAlive() : SceneHandle();
+            // 一部分挂到现在的父节点或祖父节点下：新父节点的区间包含要移动的子树
+            if (op == 7 && step % 3 != 0) {
+                parent = reference[key(h)].Parent;
+                if (step % 3 == 2 && parent.Index != UINT32_MAX)
+                    parent = reference[key(parent)].Parent;
+            }
+            bool expected = parent.Index == UINT32_MAX || !isAncestor(reference, h, parent);
+            if (graph.SetParent(h, parent) != expected)
+                failures++;
+            if (expected)
+                reference[key(h)].Parent = parent;
+        } else {
+            // 删除子树：参考实现里找出所有后代一起删掉
+            SceneHandle h = pickAlive();
+            graph.Destroy(h);
+            std::vector<SceneHandle> remaining;
+            for (SceneHandle a : alive) {
+                if (isAncestor(reference, h, a))
+                    destroyed.push_back(a);
+                else
+                    remaining.push_back(a);
+            }
+            for (SceneHandle d : destroyed)
+                reference.erase(key(d));
+            alive.swap(remaining);
+        }
+
+        // 失效的句柄：槽位多半已经被新节点复用，写入不能改到新节点上（下面和参考实现比较世界矩阵时会发现），读到的是默认值
+        if (!destroyed.empty() && step % 2 == 0) {
+            SceneHandle d = destroyed[std::uniform_int_distribution<size_t>(0, destroyed.size() - 1)(rng)];
+            graph.SetPosition(d, glm::vec3(100.0f));
+            graph.SetRotation(d, randomRotation());
+            graph.SetScale(d, glm::vec3(7.0f));
+            graph.Destroy(d);
+            if (graph.SetParent(d, SceneHandle()) || (!alive.empty() && (graph.SetParent(d, pickAlive()) || graph.SetParent(pickAlive(), d))))
+                failures++;
+            if (graph.GetPosition(d) != glm::vec3(0.0f) || glm::mat4_cast(graph.GetRotation(d)) != glm::mat4(1.0f) || graph.GetScale(d) != glm::vec3(1.0f) ||
+                graph.World(d) != glm::mat4(1.0f) || graph.GetParent(d) != SceneHandle() || graph.DenseIndex(d) != UINT32_MAX)
+                failures++;
+        }
+
+        graph.Update();
+        mirror.resize(graph.Count());
+        unsigned int first, count;
+        if (graph.UpdatedRange(first, count))
+            std::copy(graph.WorldMatrices().begin() + first, graph.WorldMatrices().begin() + first + count, mirror.begin() + first);
+
+        if (step % 50 == 0 || step == 2999) {
+            for (SceneHandle h : alive) {
+                if (!graph.Alive(h)) {
+                    failures++;
+                    continue;
+                }
+                glm::mat4 expected = referenceWorld(reference, h);
+                const glm::mat4 &got = graph.World(h);
+                const glm::mat4 &uploaded = mirror[graph.DenseIndex(h)];
+                for (int c = 0; c < 4; c++)
+                    for (int r = 0; r < 4; r++)
+                        if (std::fabs(expected[c][r] - got[c][r]) > 1e-3f * (1.0f + std::fabs(expected[c][r])) ||
+                            uploaded[c][r] != got[c][r])
+                            failures++;
+                // 深度优先顺序：父节点在前面
+                SceneHandle parent = graph.GetParent(h);
+                if (parent != reference[key(h)].Parent || (graph.Alive(parent) && graph.DenseIndex(parent) >= graph.DenseIndex(h)))
+                    failures++;
+            }
+            for (SceneHandle d : destroyed)
+                if (graph.Alive(d))
+                    failures++;
+        }
+    }
+    std::cout << "fuzz: " << alive.size() << " nodes alive, " << destroyed.size() << " destroyed, "
+              << (failures ? "FAILED" : "OK") << std::endl;
+    return failures;
+}
+
+int main()
+{
+    using std::cout;
+    using std::endl;
+
+    int failures = fuzz();
+
+    // 100万个节点：1000个根节点，每个根下面10个子节点，每个子节点下面99个叶子
+    // 按深度优先顺序创建，每次都插在数组末尾，不需要移动数组
+    SceneGraph graph;
+    std::vector<SceneHandle> roots, middles, leaves;
+    auto start = Clock::now();
+    for (int r = 0; r < 1000; r++) {
+        SceneHandle root = graph.Create(glm::vec3(r * 10.0f, 0.0f, 0.0f));
+        roots.push_back(root);
+        for (int m = 0; m < 10; m++) {
+            SceneHandle middle = graph.Create(glm::vec3(0.0f, m * 2.0f, 0.0f), glm::angleAxis(0.1f * m, glm::vec3(0.0f, 1.0f, 0.0f)),
+                                              glm::vec3(1.0f), root);
+            middles.push_back(middle);
+            for (int l = 0; l < 99; l++)
+                leaves.push_back(graph.Create(glm::vec3(l * 0.1f, 0.0f, 0.0f), glm::quat(), glm::vec3(0.5f), middle));
+        }
+    }
+    double createMs = millisecondsSince(start);
+
+    cout << std::fixed << std::setprecision(3);
+    start = Clock::now();
+    unsigned int computed = graph.Update();
+    double fullMs = millisecondsSince(start);
+    cout << "nodes: " << graph.Count() << ", create " << createMs << " ms" << endl;
+    cout << "full update:       " << fullMs << " ms (" << computed << " nodes)" << endl;
+
+    const int repeats = 100;
+    std::mt19937 rng(1);
+    auto timeMoves = [&](const std::vector<SceneHandle> &handles, const char *label) {
+        unsigned int total = 0;
+        auto begin = Clock::now();
+        for (int i = 0; i < repeats; i++) {
+            SceneHandle h = handles[std::uniform_int_distribution<size_t>(0, handles.size() - 1)(rng)];
+            graph.SetPosition(h, graph.GetPosition(h) + glm::vec3(0.0f, 0.01f, 0.0f));
+            total += graph.Update();
+        }
+        double ms = millisecondsSince(begin) / repeats;
+        cout << label << ms << " ms (" << total / repeats << " nodes), " << fullMs / ms << "x faster than full" << endl;
+    };
+    timeMoves(leaves, "move one leaf:     ");
+    timeMoves(middles, "move one subtree:  ");
+    timeMoves(roots, "move one root:     ");
+
+    return failures == 0 ? EXIT_SUCCESS : EXIT_FAILURE;
+}
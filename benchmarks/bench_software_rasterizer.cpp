@@ -0,0 +1,135 @@
+// 软件光栅化的基准测试：摄像机示例的立方体摆成 N x N x 4 的网格，在几种分辨率下渲染，
+// 对比标量单线程、AVX2单线程、AVX2多线程的每帧耗时，并检查三者的结果逐字节相同
+// 纹理是程序生成的棋盘格，只依赖 glm 和 includes/learnopengl，不需要OpenGL上下文，可以在没有GPU的服务器上运行
+//
+// 编译：g++ -O2 -mavx2 -std=c++14 -pthread -I../includes bench_software_rasterizer.cpp -o bench_software_rasterizer
+// 运行：./bench_software_rasterizer
+#include <iostream>
+#include <iomanip>
+#include <vector>
+#include <chrono>
+#include <cmath>
+#include <cstdlib>
+
+#include <glm/glm.hpp>
+#include <glm/gtc/matrix_transform.hpp>
+
+#include <learnopengl/software_rasterizer.h>
+
+using Clock = std::chrono::high_resolution_clock;
+
+static double millisecondsSince(Clock::time_point start)
+{
+    return std::chrono::duration<double, std::milli>(Clock::now() - start).count();
+}
+
+// 和 6.1.coordinate_systems 相同的立方体：位置 + 纹理坐标
+static const float cubeVertices[] = {
+        -0.5f, -0.5f, -0.5f,  0.0f, 0.0f,   0.5f, -0.5f, -0.5f,  1.0f, 0.0f,   0.5f,  0.5f, -0.5f,  1.0f, 1.0f,
+         0.5f,  0.5f, -0.5f,  1.0f, 1.0f,  -0.5f,  0.5f, -0.5f,  0.0f, 1.0f,  -0.5f, -0.5f, -0.5f,  0.0f, 0.0f,
+        -0.5f, -0.5f,  0.5f,  0.0f, 0.0f,   0.5f, -0.5f,  0.5f,  1.0f, 0.0f,   0.5f,  0.5f,  0.5f,  1.0f, 1.0f,
+         0.5f,  0.5f,  0.5f,  1.0f, 1.0f,  -0.5f,  0.5f,  0.5f,  0.0f, 1.0f,  -0.5f, -0.5f,  0.5f,  0.0f, 0.0f,
+        -0.5f,  0.5f,  0.5f,  1.0f, 0.0f,  -0.5f,  0.5f, -0.5f,  1.0f, 1.0f,  -0.5f, -0.5f, -0.5f,  0.0f, 1.0f,
+        -0.5f, -0.5f, -0.5f,  0.0f, 1.0f,  -0.5f, -0.5f,  0.5f,  0.0f, 0.0f,  -0.5f,  0.5f,  0.5f,  1.0f, 0.0f,
+         0.5f,  0.5f,  0.5f,  1.0f, 0.0f,   0.5f,  0.5f, -0.5f,  1.0f, 1.0f,   0.5f, -0.5f, -0.5f,  0.0f, 1.0f,
+         0.5f, -0.5f, -0.5f,  0.0f, 1.0f,   0.5f, -0.5f,  0.5f,  0.0f, 0.0f,   0.5f,  0.5f,  0.5f,  1.0f, 0.0f,
+        -0.5f, -0.5f, -0.5f,  0.0f, 1.0f,   0.5f, -0.5f, -0.5f,  1.0f, 1.0f,   0.5f, -0.5f,  0.5f,  1.0f, 0.0f,
+         0.5f, -0.5f,  0.5f,  1.0f, 0.0f,  -0.5f, -0.5f,  0.5f,  0.0f, 0.0f,  -0.5f, -0.5f, -0.5f,  0.0f, 1.0f,
+        -0.5f,  0.5f, -0.5f,  0.0f, 1.0f,   0.5f,  0.5f, -0.5f,  1.0f, 1.0f,   0.5f,  0.5f,  0.5f,  1.0f, 0.0f,
+         0.5f,  0.5f,  0.5f,  1.0f, 0.0f,  -0.5f,  0.5f,  0.5f,  0.0f, 0.0f,  -0.5f,  0.5f, -0.5f,  0.0f, 1.0f
+};
+
+// size x size 的棋盘格，每格 cell 个纹素
+static SoftwareTexture makeChecker(int size, int cell, const glm::vec3 &a, const glm::vec3 &b)
+{
+    std::vector<unsigned char> data((size_t) size * size * 3);
+    for (int y = 0; y < size; y++) {
+        for (int x = 0; x < size; x++) {
+            const glm::vec3 &c = ((x / cell + y / cell) % 2) ? a : b;
+            unsigned char *p = &data[((size_t) y * size + x) * 3];
+            p[0] = (unsigned char) (c.x * 255.0f);
+            p[1] = (unsigned char) (c.y * 255.0f);
+            p[2] = (unsigned char) (c.z * 255.0f);
+        }
+    }
+    return SoftwareTexture(data.data(), size, size, 3);
+}
+
+int main()
+{
+    using std::cout;
+    using std::endl;
+
+    SoftwareTexture texture1 = makeChecker(512, 32, glm::vec3(0.6f, 0.4f, 0.2f), glm::vec3(0.3f, 0.2f, 0.1f));
+    SoftwareTexture texture2 = makeChecker(256, 8, glm::vec3(1.0f, 1.0f, 0.0f), glm::vec3(0.0f, 0.0f, 0.0f));
+    SoftwareMaterial material;
+    material.Texture1 = &texture1;
+    material.Texture2 = &texture2;
+    material.Mix = 0.2f;
+
+    // 立方体网格，离摄像机越远越密，近处的立方体和近平面相交
+    std::vector<glm::mat4> models;
+    const int GRID = 12;
+    for (int z = 0; z < 4; z++)
+        for (int y = 0; y < GRID; y++)
+            for (int x = 0; x < GRID; x++) {
+                glm::vec3 position(x * 1.6f - GRID * 0.8f, y * 1.6f - GRID * 0.8f, -z * 4.0f - 1.0f);
+                glm::mat4 model = glm::translate(glm::mat4(1.0f), position);
+                models.push_back(glm::rotate(model, glm::radians(17.0f * (x + y + z)), glm::normalize(glm::vec3(1.0f, 0.3f, 0.5f))));
+            }
+    glm::mat4 view = glm::lookAt(glm::vec3(0.3f, 0.2f, 1.5f), glm::vec3(0.0f, 0.0f, -8.0f), glm::vec3(0.0f, 1.0f, 0.0f));
+
+    int failures = 0;
+    cout << "software rasterizer: " << (SoftwareRasterizer::HasAvx2() ? "AVX2" : "scalar only") << ", "
+         << models.size() << " cubes, " << models.size() * 12 << " triangles" << endl;
+    cout << std::fixed << std::setprecision(3);
+    // 没有编译AVX2路径时 Simd 不起作用：不输出和标量相同的单线程一列，多线程一列按实际的路径命名
+    const bool avx2 = SoftwareRasterizer::HasAvx2();
+    cout << "resolution   scalar 1T(ms)" << (avx2 ? "  avx2 1T(ms)  avx2 MT(ms)" : "  scalar MT(ms)")
+         << "  shaded px  speedup" << endl;
+    const struct { int Width, Height; } resolutions[] = {{640, 360}, {1280, 720}, {1920, 1080}};
+    for (const auto &resolution : resolutions) {
+        SoftwareRasterizer rasterizer(resolution.Width, resolution.Height);
+        glm::mat4 projection = glm::perspective(glm::radians(60.0f), (float) resolution.Width / resolution.Height, 0.1f, 100.0f);
+        auto render = [&]() {
+            rasterizer.Clear(glm::vec4(0.2f, 0.3f, 0.3f, 1.0f));
+            rasterizer.SetMaterial(material);
+            for (const glm::mat4 &model : models)
+                rasterizer.Draw(cubeVertices, 36, model, view, projection);
+            rasterizer.Flush();
+        };
+
+        struct Mode { unsigned int Threads; bool Simd; };
+        std::vector<Mode> modes = {{1, false}};
+        if (avx2)
+            modes.push_back({1, true});
+        modes.push_back({0, true});
+        std::vector<double> ms(modes.size());
+        std::vector<unsigned char> reference, pixels;
+        bool ok = true;
+        for (size_t m = 0; m < modes.size(); m++) {
+            rasterizer.Threads = modes[m].Threads;
+            rasterizer.Simd = modes[m].Simd;
+            // 先运行一次，分配好内部的缓冲
+            render();
+            rasterizer.ReadPixels(m == 0 ? reference : pixels);
+            ok = ok && (m == 0 || pixels == reference);
+            int runs = 5;
+            auto start = Clock::now();
+            for (int r = 0; r < runs; r++)
+                render();
+            ms[m] = millisecondsSince(start) / runs;
+        }
+        cout << std::setw(5) << resolution.Width << "x" << std::setw(4) << resolution.Height << std::setw(15) << ms[0];
+        if (avx2)
+            cout << std::setw(13) << ms[1] << std::setw(13) << ms[2];
+        else
+            cout << std::setw(16) << ms[1];
+        cout << std::setw(11) << rasterizer.Stats().PixelsShaded
+             << std::setw(8) << std::setprecision(2) << ms[0] / ms.back() << "x" << std::setprecision(3)
+             << (ok ? "   OK" : "   MISMATCH") << endl;
+        if (!ok)
+            failures++;
+    }
+    return failures == 0 ? EXIT_SUCCESS : EXIT_FAILURE;
+}
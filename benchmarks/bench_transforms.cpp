@@ -0,0 +1,126 @@
+// 批量变换基准测试：1千到100万个物体，对比逐个物体 glm::translate + glm::rotate 和 TransformSystem 的SoA SIMD版本
+// 只依赖 glm 和 includes/learnopengl，不需要OpenGL；输出写到一块普通内存，模拟映射出来的实例缓冲
+//
+// 编译：g++ -O2 -mavx2 -std=c++14 -I../includes bench_transforms.cpp -o bench_transforms（不加 -mavx2 时simd一列是SSE2路径）
+// 运行：./bench_transforms
+#include <iostream>
+#include <iomanip>
+#include <vector>
+#include <random>
+#include <chrono>
+#include <cmath>
+#include <cstdlib>
+
+#include <glm/glm.hpp>
+#include <glm/gtc/matrix_transform.hpp>
+#include <glm/gtc/quaternion.hpp>
+#include <glm/gtc/type_ptr.hpp>
+
+#include <learnopengl/transforms.h>
+
+using Clock = std::chrono::high_resolution_clock;
+
+static double millisecondsSince(Clock::time_point start)
+{
+    return std::chrono::duration<double, std::milli>(Clock::now() - start).count();
+}
+
+int main()
+{
+    using std::cout;
+    using std::endl;
+
+    std::mt19937 rng(12345);
+    std::uniform_real_distribution<float> position(-100.0f, 100.0f);
+    std::uniform_real_distribution<float> angle(0.0f, 360.0f);
+    std::uniform_real_distribution<float> unit(-1.0f, 1.0f);
+
+    cout << std::fixed << std::setprecision(2);
+    // simd一列用的路径由编译选项决定，写结果时要一起记下来
+#if defined(LEARNOPENGL_TRANSFORMS_AVX)
+    cout << "simd path: AVX, 8 objects per group" << endl;
+#elif defined(LEARNOPENGL_TRANSFORMS_SSE)
+    cout << "simd path: SSE2, 4 objects per group" << endl;
+#else
+    cout << "simd path: scalar fallback" << endl;
+#endif
+    cout << "objects      glm(ns/obj)  scalar(ns/obj)  simd(ns/obj)  simd 10% dirty(ns/obj)  speedup" << endl;
+
+    bool ok = true;
+    for (unsigned int count : { 1000u, 10000u, 100000u, 1000000u }) {
+        std::vector<glm::vec3> positions(count), axes(count);
+        std::vector<float> angles(count);
+        for (unsigned int i = 0; i < count; i++) {
+            positions[i] = glm::vec3(position(rng), position(rng), position(rng));
+            axes[i] = glm::normalize(glm::vec3(unit(rng), unit(rng), unit(rng)) + glm::vec3(0.0f, 0.0f, 1e-3f));
+            angles[i] = angle(rng);
+        }
+
+        TransformSystem transforms;
+        for (unsigned int i = 0; i < count; i++)
+            transforms.Add(positions[i], glm::angleAxis(glm::radians(angles[i]), axes[i]));
+
+        // 每种方法总共处理约1000万个物体，小规模时重复多次
+        const unsigned int repeats = std::max(1u, 10000000u / count);
+        std::vector<glm::mat4> reference(count);
+        std::vector<float> scalarOut(count * 16), simdOut(count * 16);
+
+        // 示例里原来的写法：每个物体每帧 translate 然后 rotate
+        auto start = Clock::now();
+        for (unsigned int r = 0; r < repeats; r++) {
+            for (unsigned int i = 0; i < count; i++) {
+                glm::mat4 model = glm::mat4(1.0f);
+                model = glm::translate(model, positions[i]);
+                model = glm::rotate(model, glm::radians(angles[i]), axes[i]);
+                reference[i] = model;
+            }
+        }
+        double glmNs = millisecondsSince(start) * 1e6 / ((double) repeats * count);
+
+        start = Clock::now();
+        for (unsigned int r = 0; r < repeats; r++) {
+            transforms.MarkAllDirty();
+            transforms.UpdateScalar(scalarOut.data());
+        }
+        double scalarNs = millisecondsSince(start) * 1e6 / ((double) repeats * count);
+
+        start = Clock::now();
+        for (unsigned int r = 0; r < repeats; r++) {
+            transforms.MarkAllDirty();
+            transforms.Update(simdOut.data());
+        }
+        double simdNs = millisecondsSince(start) * 1e6 / ((double) repeats * count);
+
+        // 每帧只有10%的物体在动：脏标记让其余90%完全跳过
+        std::uniform_int_distribution<unsigned int> pick(0, count - 1);
+        std::vector<unsigned int> moving(count / 10);
+        for (auto &i : moving)
+            i = pick(rng);
+        start = Clock::now();
+        for (unsigned int r = 0; r < repeats; r++) {
+            for (unsigned int i : moving)
+                transforms.SetPosition(i, positions[i]);
+            unsigned int first, size;
+            if (transforms.DirtyRange(first, size))
+                transforms.Update(simdOut.data() + (size_t) first * 16, first);
+        }
+        double partialNs = millisecondsSince(start) * 1e6 / ((double) repeats * count);
+
+        // 结果和glm一致
+        float maxError = 0.0f;
+        for (unsigned int i = 0; i < count; i++) {
+            const float *expected = glm::value_ptr(reference[i]);
+            for (int k = 0; k < 16; k++) {
+                maxError = std::max(maxError, std::fabs(expected[k] - simdOut[i * 16 + k]));
+                maxError = std::max(maxError, std::fabs(expected[k] - scalarOut[i * 16 + k]));
+            }
+        }
+        ok = ok && maxError < 1e-4f;
+
+        cout << std::setw(7) << count << std::setw(15) << glmNs << std::setw(16) << scalarNs
+             << std::setw(14) << simdNs << std::setw(24) << partialNs << std::setw(9) << glmNs / simdNs << "x"
+             << "   max error " << std::scientific << std::setprecision(1) << maxError << std::fixed << std::setprecision(2) << endl;
+    }
+
+    return ok ? EXIT_SUCCESS : EXIT_FAILURE;
+}
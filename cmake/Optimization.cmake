@@ -0,0 +1,94 @@
+# 构建配置
+#   Release      CMake默认的Release选项（GCC、Clang为 -O3 -DNDEBUG），不开LTO
+#   RelWithLTO   Release + 链接时优化
+#   PgoGenerate  RelWithLTO + 插桩，运行 benchmark 目标生成剖析数据
+#   PgoUse       RelWithLTO + 使用剖析数据优化；只有 learnopengl_use_profile 标记的代码使用剖析数据，其余和RelWithLTO相同
+# 两阶段PGO在同一个构建目录中完成，剖析数据按目标文件的路径对应：
+#   cmake -B build -DCMAKE_BUILD_TYPE=PgoGenerate && cmake --build build && cmake --build build --target benchmark
+#   cmake -B build -DCMAKE_BUILD_TYPE=PgoUse && cmake --build build
+# 剖析数据保存在 LEARNOPENGL_PGO_DIR 中，重新插桩前要清空，否则新旧数据会累加
+
+include(CheckIPOSupported)
+
+set(LEARNOPENGL_BUILD_TYPES Release RelWithLTO PgoGenerate PgoUse)
+get_property(LEARNOPENGL_MULTI_CONFIG GLOBAL PROPERTY GENERATOR_IS_MULTI_CONFIG)
+if (LEARNOPENGL_MULTI_CONFIG)
+    set(CMAKE_CONFIGURATION_TYPES Debug ${LEARNOPENGL_BUILD_TYPES} CACHE STRING "" FORCE)
+else()
+    if (NOT CMAKE_BUILD_TYPE)
+        set(CMAKE_BUILD_TYPE Release CACHE STRING "" FORCE)
+    endif()
+    set_property(CACHE CMAKE_BUILD_TYPE PROPERTY STRINGS Debug ${LEARNOPENGL_BUILD_TYPES})
+endif()
+
+set(LEARNOPENGL_PGO_DIR ${CMAKE_BINARY_DIR}/pgo-profiles CACHE PATH "PGO剖析数据的目录")
+
+check_ipo_supported(RESULT LEARNOPENGL_IPO_SUPPORTED OUTPUT LEARNOPENGL_IPO_OUTPUT LANGUAGES C CXX)
+if (NOT LEARNOPENGL_IPO_SUPPORTED)
+    message(STATUS "LTO is not supported by this toolchain, RelWithLTO and PGO builds fall back to Release: ${LEARNOPENGL_IPO_OUTPUT}")
+endif()
+
+# 所有新配置都以Release的编译选项为基础
+foreach (config RELWITHLTO PGOGENERATE PGOUSE)
+    foreach (lang C CXX)
+        set(CMAKE_${lang}_FLAGS_${config} "${CMAKE_${lang}_FLAGS_RELEASE}")
+    endforeach()
+    foreach (kind EXE SHARED STATIC MODULE)
+        set(CMAKE_${kind}_LINKER_FLAGS_${config} "${CMAKE_${kind}_LINKER_FLAGS_RELEASE}")
+    endforeach()
+    set(CMAKE_INTERPROCEDURAL_OPTIMIZATION_${config} ${LEARNOPENGL_IPO_SUPPORTED})
+endforeach()
+mark_as_advanced(LEARNOPENGL_PGO_DIR)
+
+# 插桩和使用剖析数据的选项；GCC直接读取 .gcda，Clang需要先用 llvm-profdata 合并成 default.profdata
+set(LEARNOPENGL_PGO_MERGE_COMMAND "")
+set(LEARNOPENGL_PGO_USE_OPTIONS "")
+if (CMAKE_CXX_COMPILER_ID STREQUAL "GNU")
+    # 示例和基准测试里有多个线程，计数器用原子操作更新，否则剖析数据会有误差
+    set(pgoGenerate "-fprofile-generate=${LEARNOPENGL_PGO_DIR} -fprofile-update=prefer-atomic")
+    # -fprofile-correction 容忍多线程计数的不一致
+    # 基准测试里用来校验结果的线性扫描、暴力求交占了训练中绝大部分的执行次数，GCC默认只把覆盖99%执行次数的基本块当作热点，
+    # BVH的refit、视锥体查询因此被当成冷代码按大小优化，比Release慢了将近一倍；hot-bb-count-ws-permille=1000 让训练中执行过的代码都算热点
+    # -fprofile-use 会同时打开 -ftracer（尾部复制），BVH的建树和射线查询因此慢了三到四成，用 -fno-tracer 关掉
+    set(LEARNOPENGL_PGO_USE_OPTIONS -fprofile-use=${LEARNOPENGL_PGO_DIR} -fprofile-correction
+            --param=hot-bb-count-ws-permille=1000 -fno-tracer)
+elseif (CMAKE_CXX_COMPILER_ID MATCHES "Clang")
+    string(REGEX MATCH "^[0-9]+" clangMajor ${CMAKE_CXX_COMPILER_VERSION})
+    find_program(LLVM_PROFDATA NAMES llvm-profdata llvm-profdata-${clangMajor})
+    set(pgoGenerate "-fprofile-generate=${LEARNOPENGL_PGO_DIR}")
+    set(LEARNOPENGL_PGO_USE_OPTIONS -fprofile-use=${LEARNOPENGL_PGO_DIR}/default.profdata)
+    if (LLVM_PROFDATA)
+        set(LEARNOPENGL_PGO_MERGE_COMMAND ${LLVM_PROFDATA} merge -output=${LEARNOPENGL_PGO_DIR}/default.profdata ${LEARNOPENGL_PGO_DIR})
+    endif()
+else()
+    set(pgoGenerate "")
+    message(STATUS "PGO configurations are only supported with GCC and Clang, PgoGenerate and PgoUse are the same as RelWithLTO")
+endif()
+
+# 插桩整个构建，这样任何程序都可以链接插桩过的引擎库
+foreach (lang C CXX)
+    string(APPEND CMAKE_${lang}_FLAGS_PGOGENERATE " ${pgoGenerate}")
+endforeach()
+foreach (kind EXE SHARED MODULE)
+    string(APPEND CMAKE_${kind}_LINKER_FLAGS_PGOGENERATE " ${pgoGenerate}")
+endforeach()
+
+# learnopengl_use_profile(<目标> [源文件...])：PgoUse 中用剖析数据编译目标，给出源文件时只用于这些源文件
+# 只标记 benchmark 训练运行执行到的代码（基准测试和引擎库中它们调用的部分）。示例、工具和引擎库中的GL代码在训练中不会执行，
+# 用剖析数据编译只会缺少剖析数据或者被当成冷代码，所以它们在PgoUse中和RelWithLTO相同；
+# 这样 -Wmissing-profile（GCC）和 -Wprofile-instr-unprofiled（Clang）只会报告和目标文件对不上的剖析数据
+function(learnopengl_use_profile target)
+    if (NOT LEARNOPENGL_PGO_USE_OPTIONS)
+        return()
+    endif()
+    set(options "$<$<CONFIG:PgoUse>:${LEARNOPENGL_PGO_USE_OPTIONS}>")
+    if (ARGN)
+        set_property(SOURCE ${ARGN} APPEND PROPERTY COMPILE_OPTIONS "${options}")
+    else()
+        target_compile_options(${target} PRIVATE "${options}")
+    endif()
+    get_target_property(type ${target} TYPE)
+    if (NOT type STREQUAL "STATIC_LIBRARY")
+        target_link_options(${target} PRIVATE "${options}")
+    endif()
+endfunction()
@@ -0,0 +1,63 @@
+# 示例按相对路径读取着色器和图片：每个示例输出到自己的目录，构建后把源码目录里的着色器、图片和 06.Textures 中的纹理复制过去，
+# 在输出目录中运行即可
+file(GLOB LEARNOPENGL_TEXTURES CONFIGURE_DEPENDS
+        "${PROJECT_SOURCE_DIR}/01.Getting Started/06.Textures/*.jpg"
+        "${PROJECT_SOURCE_DIR}/01.Getting Started/06.Textures/*.png")
+
+# add_sample(<目标名> <源文件>)：源文件是相对当前 CMakeLists.txt 的路径
+function(add_sample name source)
+    get_filename_component(dir "${CMAKE_CURRENT_SOURCE_DIR}/${source}" DIRECTORY)
+    add_executable(${name} "${source}")
+    target_link_libraries(${name} PRIVATE learnopengl glfw)
+    set_target_properties(${name} PROPERTIES
+            RUNTIME_OUTPUT_DIRECTORY "${CMAKE_CURRENT_BINARY_DIR}/${name}"
+            VS_DEBUGGER_WORKING_DIRECTORY "${CMAKE_CURRENT_BINARY_DIR}/${name}")
+    file(GLOB resources CONFIGURE_DEPENDS
+            "${dir}/*.vs" "${dir}/*.fs" "${dir}/*.gs" "${dir}/*.comp" "${dir}/*.jpg" "${dir}/*.png")
+    add_custom_command(TARGET ${name} POST_BUILD
+            COMMAND ${CMAKE_COMMAND} -E copy_if_different ${resources} ${LEARNOPENGL_TEXTURES} $<TARGET_FILE_DIR:${name}>
+            VERBATIM)
+endfunction()
+
+# add_sample_bench(<目标名>)：bench_<目标名> 用 --validate 运行示例（隐藏窗口，输出各项检查的耗时和结果），并统计总时间
+function(add_sample_bench name)
+    add_custom_target(bench_${name}
+            COMMAND ${CMAKE_COMMAND} -E time $<TARGET_FILE:${name}> --validate
+            WORKING_DIRECTORY $<TARGET_FILE_DIR:${name}>
+            DEPENDS ${name}
+            USES_TERMINAL)
+endfunction()
+
+# 金图：各章示例用 --capture 截图（示例自己的渲染代码，时间和摄像机固定），golden_images 和提交在仓库里的参考图比较
+# add_golden_case(<用例名> <示例目标名> [示例的参数...])：参数见 includes/learnopengl/sample_capture.h
+function(add_golden_case name sample)
+    set_property(GLOBAL APPEND PROPERTY LEARNOPENGL_GOLDEN_NAMES ${name})
+    set_property(GLOBAL APPEND PROPERTY LEARNOPENGL_GOLDEN_SAMPLES ${sample})
+    set_property(GLOBAL APPEND PROPERTY LEARNOPENGL_GOLDEN_COMMANDS
+            COMMAND ${CMAKE_COMMAND} -E chdir $<TARGET_FILE_DIR:${sample}>
+            $<TARGET_FILE:${sample}> --capture "${CMAKE_BINARY_DIR}/golden_captures/${name}.png" ${ARGN})
+endfunction()
+
+# add_golden_targets(<比较程序> <参考图目录>)：在所有 add_golden_case 之后调用
+#   check_golden_images  截图并和参考图比较，不一致的用例在 golden_captures 中输出 名字.actual.png 和 名字.diff.png
+#   update_golden_images 截图并覆盖参考图，只在确认渲染的变化是预期的之后使用
+function(add_golden_targets runner golden_dir)
+    get_property(names GLOBAL PROPERTY LEARNOPENGL_GOLDEN_NAMES)
+    get_property(samples GLOBAL PROPERTY LEARNOPENGL_GOLDEN_SAMPLES)
+    get_property(commands GLOBAL PROPERTY LEARNOPENGL_GOLDEN_COMMANDS)
+    set(capture_dir "${CMAKE_BINARY_DIR}/golden_captures")
+    add_custom_target(check_golden_images
+            COMMAND ${CMAKE_COMMAND} -E make_directory "${capture_dir}"
+            ${commands}
+            COMMAND $<TARGET_FILE:${runner}> "${golden_dir}" "${capture_dir}" ${names}
+            DEPENDS ${runner} ${samples}
+            VERBATIM
+            USES_TERMINAL)
+    add_custom_target(update_golden_images
+            COMMAND ${CMAKE_COMMAND} -E make_directory "${capture_dir}"
+            ${commands}
+            COMMAND $<TARGET_FILE:${runner}> --update "${golden_dir}" "${capture_dir}" ${names}
+            DEPENDS ${runner} ${samples}
+            VERBATIM
+            USES_TERMINAL)
+endfunction()
@@ -0,0 +1,80 @@
+#ifndef LEARNOPENGL_BOUNDS_H
+#define LEARNOPENGL_BOUNDS_H
+
+#include <glm/glm.hpp>
+
+#include <cfloat>
+#include <cmath>
+#include <algorithm>
+
+// 轴对齐包围盒，默认构造为空盒（Min > Max），可以直接Grow
+struct AABB {
+    glm::vec3 Min;
+    glm::vec3 Max;
+
+    AABB() : Min(FLT_MAX), Max(-FLT_MAX) {}
+    AABB(const glm::vec3 &min, const glm::vec3 &max) : Min(min), Max(max) {}
+
+    bool Valid() const { return Min.x <= Max.x && Min.y <= Max.y && Min.z <= Max.z; }
+    glm::vec3 Center() const { return (Min + Max) * 0.5f; }
+    // 半长
+    glm::vec3 Extents() const { return (Max - Min) * 0.5f; }
+
+    void Grow(const glm::vec3 &p) { Min = glm::min(Min, p); Max = glm::max(Max, p); }
+    void Grow(const AABB &b) { Min = glm::min(Min, b.Min); Max = glm::max(Max, b.Max); }
+
+    float SurfaceArea() const;
+    // 变换后的包围盒，使用Arvo的方法，不需要变换8个角点
+    AABB Transformed(const glm::mat4 &m) const;
+};
+
+// 射线，Direction不要求归一化，求得的t以Direction的长度为单位
+struct Ray {
+    glm::vec3 Origin;
+    glm::vec3 Direction;
+
+    Ray() : Origin(0.0f), Direction(0.0f, 0.0f, -1.0f) {}
+    Ray(const glm::vec3 &origin, const glm::vec3 &direction) : Origin(origin), Direction(direction) {}
+
+    glm::vec3 At(float t) const { return Origin + Direction * t; }
+};
+
+// slab方法求射线与包围盒的相交区间，invDir为 1/Direction，命中时返回进入距离
+bool IntersectRayAABB(const glm::vec3 &origin, const glm::vec3 &invDir, const AABB &box, float tMax, float &tEnter);
+
+// 类定义
+// =================================================================================================
+
+inline float AABB::SurfaceArea() const {
+    if (!Valid())
+        return 0.0f;
+    glm::vec3 d = Max - Min;
+    return 2.0f * (d.x * d.y + d.y * d.z + d.z * d.x);
+}
+
+inline AABB AABB::Transformed(const glm::mat4 &m) const {
+    glm::vec3 min(m[3].x, m[3].y, m[3].z);
+    glm::vec3 max = min;
+    for (int c = 0; c < 3; c++) {
+        for (int r = 0; r < 3; r++) {
+            float a = m[c][r] * Min[c];
+            float b = m[c][r] * Max[c];
+            min[r] += a < b ? a : b;
+            max[r] += a < b ? b : a;
+        }
+    }
+    return AABB(min, max);
+}
+
+inline bool IntersectRayAABB(const glm::vec3 &origin, const glm::vec3 &invDir, const AABB &box, float tMax, float &tEnter) {
+    glm::vec3 t0 = (box.Min - origin) * invDir;
+    glm::vec3 t1 = (box.Max - origin) * invDir;
+    glm::vec3 tNear = glm::min(t0, t1);
+    glm::vec3 tFar = glm::max(t0, t1);
+    float enter = std::max(std::max(tNear.x, tNear.y), std::max(tNear.z, 0.0f));
+    float exit = std::min(std::min(tFar.x, tFar.y), std::min(tFar.z, tMax));
+    tEnter = enter;
+    return enter <= exit;
+}
+
+#endif // LEARNOPENGL_BOUNDS_H
@@ -0,0 +1,436 @@
+#ifndef LEARNOPENGL_BVH_H
+#define LEARNOPENGL_BVH_H
+
+#include <glm/glm.hpp>
+
+#include <vector>
+#include <cfloat>
+#include <algorithm>
+
+#include "bounds.h"
+#include "frustum.h"
+
+// 扁平化的BVH节点，32字节。
+// 内部节点：LeftFirst是左孩子下标，右孩子固定是 LeftFirst + 1，两个孩子相邻存放，访问时一起进缓存
+// 叶子节点：LeftFirst是第一个图元在索引数组中的位置，Count是图元数量（Count > 0 表示叶子）
+struct BVHNode {
+    glm::vec3 Min;
+    unsigned int LeftFirst;
+    glm::vec3 Max;
+    unsigned int Count;
+
+    bool IsLeaf() const { return Count > 0; }
+    AABB Bounds() const { return AABB(Min, Max); }
+};
+
+static_assert(sizeof(BVHNode) == 32, "BVHNode should stay 32 bytes");
+
+// 图元包围盒上的层次包围体。
+// 静态物体用 Build 建树（分桶SAH）；动态物体在包围盒变化后调用 Refit 只更新节点包围盒，
+// 质量下降太多时（RefitDegraded）再重新 Build。
+// 查询接口都以回调的方式返回图元编号（即传给 Build 的包围盒下标）。
+class BVH {
+public:
+    // 叶子最多容纳的图元数量
+    unsigned int MaxLeafSize = 4;
+    // 叶子里的图元按多少个一组做SIMD测试，SAH按组数而不是图元数计算相交代价
+    unsigned int PacketSize = 1;
+
+    void Build(const std::vector<AABB> &boxes);
+    void Refit(const std::vector<AABB> &boxes);
+    // 根节点面积相对建树时增长超过 ratio 倍，说明树已经不紧凑了
+    bool RefitDegraded(float ratio = 2.0f) const;
+
+    bool Empty() const { return nodes.empty(); }
+    const std::vector<BVHNode> &Nodes() const { return nodes; }
+    const std::vector<unsigned int> &Indices() const { return indices; }
+    AABB Bounds() const { return nodes.empty() ? AABB() : nodes[0].Bounds(); }
+
+    // visit(unsigned int primitive)
+    template <typename Visitor> void QueryFrustum(const Frustum &frustum, Visitor &&visit) const;
+    template <typename Visitor> void QuerySphere(const glm::vec3 &center, float radius, Visitor &&visit) const;
+    template <typename Visitor> void QueryAABB(const AABB &box, Visitor &&visit) const;
+    // 按由近到远的顺序遍历射线经过的叶子，hit(unsigned int primitive, float &tMax) 命中时缩短tMax并返回true。
+    // 返回是否有任何命中，tMax为最近命中距离
+    template <typename HitFunction> bool Raycast(const Ray &ray, float &tMax, HitFunction &&hit) const;
+    // 同上，但以叶子为单位回调 hitLeaf(unsigned int first, unsigned int count, float &tMax)，
+    // first/count 是叶子在 Indices() 中的范围，调用者可以按这个顺序存放图元数据做批量测试
+    template <typename LeafFunction> bool RaycastLeaves(const Ray &ray, float &tMax, LeafFunction &&hitLeaf) const;
+
+private:
+    // 建树时的图元记录，划分时直接移动记录本身，扫描都是连续访问
+    struct BuildPrimitive {
+        AABB Box;
+        glm::vec3 Centroid;
+        unsigned int Index;
+    };
+
+    std::vector<BVHNode> nodes;
+    std::vector<unsigned int> indices;
+    // 按叶子顺序存放的图元包围盒，查询时在叶子里逐个精确测试
+    std::vector<AABB> primitiveBounds;
+    float builtRootArea = 0.0f;
+
+    static const int BIN_COUNT = 16;
+    // 建树时限制深度，遍历用的定长栈就不会溢出
+    static const unsigned int MAX_DEPTH = 60;
+    static const int STACK_SIZE = 64;
+
+    static void updateBounds(BVHNode &node, const BuildPrimitive *prims);
+    bool findSplit(const BVHNode &node, const BuildPrimitive *prims, int &axis, float &position) const;
+    template <typename Visitor> void visitSubtree(unsigned int nodeIndex, Visitor &visit) const;
+
+    float packets(unsigned int count) const { return (float) ((count + PacketSize - 1) / PacketSize); }
+
+    static bool overlaps(const glm::vec3 &min, const glm::vec3 &max, const AABB &box) {
+        return min.x <= box.Max.x && max.x >= box.Min.x &&
+               min.y <= box.Max.y && max.y >= box.Min.y &&
+               min.z <= box.Max.z && max.z >= box.Min.z;
+    }
+};
+
+// 类定义
+// =================================================================================================
+
+inline void BVH::updateBounds(BVHNode &node, const BuildPrimitive *prims) {
+    AABB bounds;
+    for (unsigned int i = 0; i < node.Count; i++)
+        bounds.Grow(prims[node.LeftFirst + i].Box);
+    node.Min = bounds.Min;
+    node.Max = bounds.Max;
+}
+
+inline void BVH::Build(const std::vector<AABB> &boxes) {
+    nodes.clear();
+    indices.clear();
+    unsigned int n = (unsigned int) boxes.size();
+    if (n == 0)
+        return;
+
+    std::vector<BuildPrimitive> prims(n);
+    for (unsigned int i = 0; i < n; i++)
+        prims[i] = {boxes[i], boxes[i].Center(), i};
+    BuildPrimitive *base = prims.data();
+    // 二叉树最多 2n-1 个节点，下标1空出来，让每对兄弟节点从偶数下标开始
+    nodes.reserve(2 * n);
+    nodes.resize(2);
+    nodes[0].LeftFirst = 0;
+    nodes[0].Count = n;
+    updateBounds(nodes[0], base);
+
+    // 用显式栈代替递归，百万级图元也不会爆栈
+    struct Task { unsigned int Node; unsigned int Depth; };
+    std::vector<Task> stack;
+    stack.push_back({0, 0});
+    while (!stack.empty()) {
+        Task task = stack.back();
+        stack.pop_back();
+        unsigned int nodeIndex = task.Node;
+        BVHNode node = nodes[nodeIndex];
+
+        int axis = 0;
+        float position = 0.0f;
+        if (node.Count <= 1 || task.Depth >= MAX_DEPTH || !findSplit(node, base, axis, position))
+            continue;
+
+        // 按分割平面划分图元
+        BuildPrimitive *first = base + node.LeftFirst;
+        BuildPrimitive *last = first + node.Count;
+        BuildPrimitive *mid = std::partition(first, last, [&](const BuildPrimitive &prim) {
+            return prim.Centroid[axis] < position;
+        });
+        unsigned int leftCount = (unsigned int) (mid - first);
+        if (leftCount == 0 || leftCount == node.Count) {
+            // 质心重合无法划分，按中位数强制拆开
+            leftCount = node.Count / 2;
+            std::nth_element(first, first + leftCount, last, [&](const BuildPrimitive &a, const BuildPrimitive &b) {
+                return a.Centroid[axis] < b.Centroid[axis];
+            });
+        }
+
+        unsigned int left = (unsigned int) nodes.size();
+        nodes.resize(nodes.size() + 2);
+        nodes[left].LeftFirst = node.LeftFirst;
+        nodes[left].Count = leftCount;
+        nodes[left + 1].LeftFirst = node.LeftFirst + leftCount;
+        nodes[left + 1].Count = node.Count - leftCount;
+        updateBounds(nodes[left], base);
+        updateBounds(nodes[left + 1], base);
+
+        nodes[nodeIndex].LeftFirst = left;
+        nodes[nodeIndex].Count = 0;
+        stack.push_back({left + 1, task.Depth + 1});
+        stack.push_back({left, task.Depth + 1});
+    }
+    nodes.shrink_to_fit();
+
+    indices.resize(n);
+    primitiveBounds.resize(n);
+    for (unsigned int i = 0; i < n; i++) {
+        indices[i] = prims[i].Index;
+        primitiveBounds[i] = prims[i].Box;
+    }
+    builtRootArea = nodes[0].Bounds().SurfaceArea();
+}
+
+// 分桶SAH：每个轴把质心范围分成 BIN_COUNT 个桶，评估桶边界作为分割面的代价
+inline bool BVH::findSplit(const BVHNode &node, const BuildPrimitive *prims, int &bestAxis, float &bestPosition) const {
+    prims += node.LeftFirst;
+    AABB centroidBounds;
+    for (unsigned int i = 0; i < node.Count; i++)
+        centroidBounds.Grow(prims[i].Centroid);
+
+    // 图元很少的节点用不着那么多桶
+    int bins = (int) std::min<unsigned int>(BIN_COUNT, node.Count * 2);
+    float bestCost = FLT_MAX;
+    for (int axis = 0; axis < 3; axis++) {
+        float lo = centroidBounds.Min[axis], hi = centroidBounds.Max[axis];
+        if (hi <= lo)
+            continue;
+
+        AABB binBounds[BIN_COUNT];
+        unsigned int binCount[BIN_COUNT] = {};
+        float scale = bins / (hi - lo);
+        for (unsigned int i = 0; i < node.Count; i++) {
+            int bin = std::min(bins - 1, (int) ((prims[i].Centroid[axis] - lo) * scale));
+            binCount[bin]++;
+            binBounds[bin].Grow(prims[i].Box);
+        }
+
+        // 从左往右、从右往左各扫一遍，得到每个分割面两侧的面积和数量
+        float leftArea[BIN_COUNT - 1], rightArea[BIN_COUNT - 1];
+        unsigned int leftCount[BIN_COUNT - 1], rightCount[BIN_COUNT - 1];
+        AABB leftBox, rightBox;
+        unsigned int leftSum = 0, rightSum = 0;
+        for (int i = 0; i < bins - 1; i++) {
+            leftSum += binCount[i];
+            leftCount[i] = leftSum;
+            leftBox.Grow(binBounds[i]);
+            leftArea[i] = leftBox.SurfaceArea();
+
+            rightSum += binCount[bins - 1 - i];
+            rightCount[bins - 2 - i] = rightSum;
+            rightBox.Grow(binBounds[bins - 1 - i]);
+            rightArea[bins - 2 - i] = rightBox.SurfaceArea();
+        }
+        for (int i = 0; i < bins - 1; i++) {
+            float cost = packets(leftCount[i]) * leftArea[i] + packets(rightCount[i]) * rightArea[i];
+            if (leftCount[i] > 0 && rightCount[i] > 0 && cost < bestCost) {
+                bestCost = cost;
+                bestAxis = axis;
+                bestPosition = lo + (i + 1) / scale;
+            }
+        }
+    }
+
+    if (bestCost == FLT_MAX) {
+        // 所有质心重合，只有图元太多时才强制拆分
+        if (node.Count <= MaxLeafSize)
+            return false;
+        glm::vec3 extent = node.Max - node.Min;
+        bestAxis = extent.x > extent.y ? (extent.x > extent.z ? 0 : 2) : (extent.y > extent.z ? 1 : 2);
+        bestPosition = centroidBounds.Min[bestAxis];
+        return true;
+    }
+    // 和不拆分的代价比较：多一层节点的遍历代价记为一次图元相交
+    float leafCost = (packets(node.Count) - 1.0f) * node.Bounds().SurfaceArea();
+    return node.Count > MaxLeafSize || bestCost < leafCost;
+}
+
+inline void BVH::Refit(const std::vector<AABB> &boxes) {
+    if (nodes.empty())
+        return;
+    for (size_t i = 0; i < indices.size(); i++)
+        primitiveBounds[i] = boxes[indices[i]];
+    // 孩子总是在父节点之后分配，倒序遍历就是自底向上
+    for (int i = (int) nodes.size() - 1; i >= 0; i--) {
+        if (i == 1)
+            continue;
+        BVHNode &node = nodes[i];
+        if (node.IsLeaf()) {
+            AABB bounds;
+            for (unsigned int p = 0; p < node.Count; p++)
+                bounds.Grow(primitiveBounds[node.LeftFirst + p]);
+            node.Min = bounds.Min;
+            node.Max = bounds.Max;
+        } else {
+            const BVHNode &left = nodes[node.LeftFirst];
+            const BVHNode &right = nodes[node.LeftFirst + 1];
+            node.Min = glm::min(left.Min, right.Min);
+            node.Max = glm::max(left.Max, right.Max);
+        }
+    }
+}
+
+inline bool BVH::RefitDegraded(float ratio) const {
+    return !nodes.empty() && nodes[0].Bounds().SurfaceArea() > builtRootArea * ratio;
+}
+
+template <typename Visitor>
+void BVH::visitSubtree(unsigned int nodeIndex, Visitor &visit) const {
+    unsigned int stack[STACK_SIZE];
+    int top = 0;
+    stack[top++] = nodeIndex;
+    while (top > 0) {
+        const BVHNode &node = nodes[stack[--top]];
+        if (node.IsLeaf()) {
+            for (unsigned int i = 0; i < node.Count; i++)
+                visit(indices[node.LeftFirst + i]);
+        } else {
+            stack[top++] = node.LeftFirst + 1;
+            stack[top++] = node.LeftFirst;
+        }
+    }
+}
+
+template <typename Visitor>
+void BVH::QueryFrustum(const Frustum &frustum, Visitor &&visit) const {
+    if (nodes.empty())
+        return;
+    // 栈里同时记录还需要测试的平面，节点完全在某个平面内侧时，子树不再测这个平面
+    struct Entry { unsigned int Node; unsigned int PlaneMask; };
+    Entry stack[STACK_SIZE];
+    int top = 0;
+    stack[top++] = {0, (1u << Frustum::PLANE_COUNT) - 1};
+    while (top > 0) {
+        Entry entry = stack[--top];
+        const BVHNode &node = nodes[entry.Node];
+        glm::vec3 center = (node.Min + node.Max) * 0.5f;
+        glm::vec3 extents = (node.Max - node.Min) * 0.5f;
+
+        unsigned int mask = entry.PlaneMask;
+        bool outside = false;
+        for (int p = 0; p < Frustum::PLANE_COUNT && !outside; p++) {
+            if (!(mask & (1u << p)))
+                continue;
+            const glm::vec4 &plane = frustum.Planes[p];
+            glm::vec3 n(plane.x, plane.y, plane.z);
+            float r = glm::dot(extents, glm::abs(n));
+            float d = glm::dot(n, center) + plane.w;
+            if (d < -r)
+                outside = true;
+            else if (d >= r)
+                mask &= ~(1u << p);
+        }
+        if (outside)
+            continue;
+        if (mask == 0) {
+            // 完全在视锥体内，整棵子树都可见
+            visitSubtree(entry.Node, visit);
+            continue;
+        }
+        if (node.IsLeaf()) {
+            for (unsigned int i = 0; i < node.Count; i++)
+                if (frustum.IntersectsAABB(primitiveBounds[node.LeftFirst + i]))
+                    visit(indices[node.LeftFirst + i]);
+        } else {
+            stack[top++] = {node.LeftFirst + 1, mask};
+            stack[top++] = {node.LeftFirst, mask};
+        }
+    }
+}
+
+template <typename Visitor>
+void BVH::QuerySphere(const glm::vec3 &center, float radius, Visitor &&visit) const {
+    if (nodes.empty())
+        return;
+    float radius2 = radius * radius;
+    unsigned int stack[STACK_SIZE];
+    int top = 0;
+    stack[top++] = 0;
+    while (top > 0) {
+        const BVHNode &node = nodes[stack[--top]];
+        // 球心到包围盒最近点的距离
+        glm::vec3 d = center - glm::clamp(center, node.Min, node.Max);
+        if (glm::dot(d, d) > radius2)
+            continue;
+        if (node.IsLeaf()) {
+            for (unsigned int i = 0; i < node.Count; i++) {
+                const AABB &b = primitiveBounds[node.LeftFirst + i];
+                glm::vec3 pd = center - glm::clamp(center, b.Min, b.Max);
+                if (glm::dot(pd, pd) <= radius2)
+                    visit(indices[node.LeftFirst + i]);
+            }
+        } else {
+            stack[top++] = node.LeftFirst + 1;
+            stack[top++] = node.LeftFirst;
+        }
+    }
+}
+
+template <typename Visitor>
+void BVH::QueryAABB(const AABB &box, Visitor &&visit) const {
+    if (nodes.empty())
+        return;
+    unsigned int stack[STACK_SIZE];
+    int top = 0;
+    stack[top++] = 0;
+    while (top > 0) {
+        const BVHNode &node = nodes[stack[--top]];
+        if (!overlaps(node.Min, node.Max, box))
+            continue;
+        if (node.IsLeaf()) {
+            for (unsigned int i = 0; i < node.Count; i++) {
+                const AABB &b = primitiveBounds[node.LeftFirst + i];
+                if (overlaps(b.Min, b.Max, box))
+                    visit(indices[node.LeftFirst + i]);
+            }
+        } else {
+            stack[top++] = node.LeftFirst + 1;
+            stack[top++] = node.LeftFirst;
+        }
+    }
+}
+
+template <typename HitFunction>
+bool BVH::Raycast(const Ray &ray, float &tMax, HitFunction &&hit) const {
+    return RaycastLeaves(ray, tMax, [&](unsigned int first, unsigned int count, float &t) {
+        bool any = false;
+        for (unsigned int i = 0; i < count; i++)
+            any |= hit(indices[first + i], t);
+        return any;
+    });
+}
+
+template <typename LeafFunction>
+bool BVH::RaycastLeaves(const Ray &ray, float &tMax, LeafFunction &&hitLeaf) const {
+    if (nodes.empty())
+        return false;
+    glm::vec3 invDir = 1.0f / ray.Direction;
+    float tEnter;
+    if (!IntersectRayAABB(ray.Origin, invDir, nodes[0].Bounds(), tMax, tEnter))
+        return false;
+
+    bool any = false;
+    struct Entry { unsigned int Node; float TEnter; };
+    Entry stack[STACK_SIZE];
+    int top = 0;
+    stack[top++] = {0, tEnter};
+    while (top > 0) {
+        Entry entry = stack[--top];
+        // 入栈之后tMax可能已经被更近的命中缩短
+        if (entry.TEnter > tMax)
+            continue;
+        const BVHNode &node = nodes[entry.Node];
+        if (node.IsLeaf()) {
+            any |= hitLeaf(node.LeftFirst, node.Count, tMax);
+            continue;
+        }
+        unsigned int closer = node.LeftFirst, further = node.LeftFirst + 1;
+        float tCloser, tFurther;
+        bool hitCloser = IntersectRayAABB(ray.Origin, invDir, nodes[closer].Bounds(), tMax, tCloser);
+        bool hitFurther = IntersectRayAABB(ray.Origin, invDir, nodes[further].Bounds(), tMax, tFurther);
+        if (hitCloser && hitFurther && tFurther < tCloser) {
+            std::swap(closer, further);
+            std::swap(tCloser, tFurther);
+        }
+        // 先压远的，近的先出栈
+        if (hitFurther)
+            stack[top++] = {further, tFurther};
+        if (hitCloser)
+            stack[top++] = {closer, tCloser};
+    }
+    return any;
+}
+
+#endif // LEARNOPENGL_BVH_H
@@ -0,0 +1,106 @@
+#ifndef LEARNOPENGL_CAMERA_H
+#define LEARNOPENGL_CAMERA_H
+
+#include <glad/glad.h>
+#include <glm/glm.hpp>
+#include <glm/gtc/matrix_transform.hpp>
+#include <glm/gtc/quaternion.hpp>
+
+#include <learnopengl/bounds.h>
+
+#include <vector>
+
+enum Camera_Movement {
+    FORWARD,
+    BACKWARD,
+    LEFT,
+    RIGHT
+};
+
+// 摄像机默认值
+const float YAW         = -90.0f;
+const float PITCH       =  0.0f;
+const float SPEED       =  2.5f;
+const float SENSITIVITY =  0.1f;
+const float ZOOM        =  45.0f;
+
+// 摄像机类
+// 鼠标事件只累加欧拉角，朝向（四元数和Front/Right/Up）、视图矩阵、投影矩阵都在第一次用到时才重新计算，
+// 是否需要重新计算由缓存时的输入值判断，直接修改 Position、Yaw、Pitch、Zoom 等成员也会生效
+// 定义在 src/camera.cpp 中，随引擎库一起编译
+class Camera {
+private:
+    mutable glm::quat orientation;
+    mutable glm::vec3 front, right, up;
+    mutable glm::mat4 view, projection, viewProjection;
+    // 上次计算缓存时使用的输入
+    mutable float vectorsYaw, vectorsPitch;
+    mutable glm::vec3 vectorsWorldUp;
+    mutable glm::vec3 viewPosition;
+    mutable float projectionZoom, projectionAspect, projectionNear, projectionFar;
+    mutable bool projectionReversedZ, projectionZeroToOne;
+    mutable bool vectorsValid = false, viewValid = false, projectionValid = false, viewProjectionValid = false;
+
+    void updateCameraVectors() const;
+    void updateView() const;
+    void updateProjection(float aspectRatio) const;
+
+public:
+    glm::vec3 Position;
+    // 双精度的世界原点，摄像机的世界坐标 = WorldOrigin + Position；大场景中配合 RebaseOrigin 使用，
+    // Position 只保存相对原点的小位移，移动时不会因为float精度丢失
+    glm::dvec3 WorldOrigin = glm::dvec3(0.0);
+    glm::vec3 WorldUp;
+    // 欧拉角
+    float Yaw;
+    float Pitch;
+    // 摄像机选项
+    float MovementSpeed;
+    float MouseSensitivity;
+    float Zoom;
+    // 透视投影的近平面和远平面
+    float NearPlane = 0.1f;
+    float FarPlane = 100.0f;
+    // 反转深度 + 无穷远平面：近平面深度为1，无穷远处为0，不再使用FarPlane；
+    // 需要浮点深度缓冲、GL_GREATER 深度测试、深度清除为0，EnableReversedZ 会设置好这些GL状态
+    bool ReversedZ = false;
+    // 裁剪空间深度范围是否为 [0, 1]（glClipControl），否则按OpenGL默认的 [-1, 1] 构造投影矩阵
+    bool ClipDepthZeroToOne = false;
+
+    Camera (glm::vec3 position = glm::vec3(0.0f, 0.0f, 0.0f),
+            glm::vec3 up = glm::vec3(0.0f, 1.0f, 0.0f),
+            float yaw = YAW, float pitch = PITCH);
+
+    Camera (float posX, float posY, float posZ, float upX, float upY, float upZ, float yaw, float pitch);
+
+    glm::vec3 GetFront() const { updateCameraVectors(); return front; }
+    glm::vec3 GetRight() const { updateCameraVectors(); return right; }
+    glm::vec3 GetUp() const { updateCameraVectors(); return up; }
+    // 从摄像机空间（-Z朝前）到世界空间的旋转
+    glm::quat GetOrientation() const { updateCameraVectors(); return orientation; }
+    const glm::mat4 &GetViewMatrix() const { updateView(); return view; }
+    // 视场角取Zoom，aspectRatio或Zoom不变时返回缓存的矩阵
+    const glm::mat4 &GetProjectionMatrix(float aspectRatio) const { updateProjection(aspectRatio); return projection; }
+    const glm::mat4 &GetViewProjectionMatrix(float aspectRatio) const;
+    // 以摄像机为原点的视图矩阵，只有旋转，配合 CameraRelativeBatch 使用
+    glm::mat4 GetViewRotationMatrix() const;
+    glm::dvec3 GetWorldPosition() const { return WorldOrigin + glm::dvec3(Position); }
+    // 把Position并入WorldOrigin，Position归零；视图矩阵等缓存在下次使用时重新计算
+    void RebaseOrigin();
+
+    // 打开反转深度：有glClipControl（OpenGL 4.5 或 ARB_clip_control）时把深度范围设为[0, 1]，
+    // 深度测试改为GL_GREATER，清除值改为0；返回是否用上了glClipControl
+    // useClipControl为false时保持[-1, 1]，用来对比没有glClipControl的平台
+    bool EnableReversedZ(bool useClipControl = true);
+    // 恢复标准深度：[-1, 1]、GL_LESS、清除值为1
+    void DisableReversedZ();
+    // 屏幕坐标（左上角为原点，和GLFW光标坐标一致）转换成世界空间射线，视场角和渲染时一样取Zoom；起点是Position，相对于WorldOrigin
+    Ray ScreenPointToRay(float screenX, float screenY, float viewportWidth, float viewportHeight) const;
+
+    void ProcessKeyboard (Camera_Movement direction, float deltaTime);
+    void ProcessMouseMovement(float xoffset, float yoffset, GLboolean constrainPitch = GL_FALSE);
+    void ProcessMouseScroll(float yoffset);
+
+};
+
+#endif // LEARNOPENGL_CAMERA_H
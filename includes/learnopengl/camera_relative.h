@@ -0,0 +1,97 @@
+#ifndef LEARNOPENGL_CAMERA_RELATIVE_H
+#define LEARNOPENGL_CAMERA_RELATIVE_H
+
+#include <glm/glm.hpp>
+#include <glm/gtc/quaternion.hpp>
+
+#include <vector>
+
+// 以摄像机为原点的渲染：物体的世界坐标用双精度保存，每帧在CPU上减去摄像机的世界坐标，
+// 得到的相对位移已经很小，再转换成float构造 视图 * 模型 矩阵，GPU上不需要任何双精度运算
+// 在10^7量级的坐标上，float本身的间隔是1个单位，直接用float世界矩阵会让顶点抖动；
+// 相对位移的精度只和到摄像机的距离有关，离摄像机越近越精确
+class CameraRelativeBatch {
+public:
+    unsigned int Add(const glm::dvec3 &position, const glm::quat &rotation = glm::quat(), const glm::vec3 &scale = glm::vec3(1.0f));
+    void Clear();
+    unsigned int Count() const { return (unsigned int) objects.size(); }
+
+    void SetPosition(unsigned int i, const glm::dvec3 &position) { objects[i].Position = position; }
+    void SetRotationScale(unsigned int i, const glm::quat &rotation, const glm::vec3 &scale);
+    const glm::dvec3 &GetPosition(unsigned int i) const { return objects[i].Position; }
+
+    // eye是摄像机的世界坐标，viewRotation是去掉平移的视图矩阵（只用左上3x3）
+    // 所有物体的 视图 * 模型 矩阵写入modelView，每个16个float、列主序，通常是映射出来的实例缓冲
+    void Build(const glm::dvec3 &eye, const glm::mat4 &viewRotation, float *modelView) const;
+    // 对比用：世界矩阵和视图矩阵都用float，和直接上传float世界坐标的做法相同
+    void BuildSinglePrecision(const glm::mat4 &view, float *modelView) const;
+
+private:
+    struct Object {
+        glm::dvec3 Position;
+        glm::mat3 Basis;    // 旋转 * 缩放
+    };
+    std::vector<Object> objects;
+
+    static glm::mat3 basis(const glm::quat &rotation, const glm::vec3 &scale);
+};
+
+// 类定义
+// =================================================================================================
+
+inline unsigned int CameraRelativeBatch::Add(const glm::dvec3 &position, const glm::quat &rotation, const glm::vec3 &scale) {
+    objects.push_back({position, basis(rotation, scale)});
+    return (unsigned int) objects.size() - 1;
+}
+
+inline void CameraRelativeBatch::Clear() {
+    objects.clear();
+}
+
+inline void CameraRelativeBatch::SetRotationScale(unsigned int i, const glm::quat &rotation, const glm::vec3 &scale) {
+    objects[i].Basis = basis(rotation, scale);
+}
+
+inline void CameraRelativeBatch::Build(const glm::dvec3 &eye, const glm::mat4 &viewRotation, float *modelView) const {
+    glm::mat3 r(viewRotation);
+    for (const Object &o : objects) {
+        // 减法用双精度完成，只有结果才转换成float
+        glm::vec3 offset(o.Position - eye);
+        glm::mat3 m = r * o.Basis;
+        glm::vec3 t = r * offset;
+        float *out = modelView;
+        for (int c = 0; c < 3; c++) {
+            out[c * 4 + 0] = m[c].x;
+            out[c * 4 + 1] = m[c].y;
+            out[c * 4 + 2] = m[c].z;
+            out[c * 4 + 3] = 0.0f;
+        }
+        out[12] = t.x;
+        out[13] = t.y;
+        out[14] = t.z;
+        out[15] = 1.0f;
+        modelView += 16;
+    }
+}
+
+inline void CameraRelativeBatch::BuildSinglePrecision(const glm::mat4 &view, float *modelView) const {
+    for (const Object &o : objects) {
+        glm::mat4 model(o.Basis);
+        model[3] = glm::vec4(glm::vec3(o.Position), 1.0f);
+        glm::mat4 m = view * model;
+        for (int c = 0; c < 4; c++)
+            for (int k = 0; k < 4; k++)
+                modelView[c * 4 + k] = m[c][k];
+        modelView += 16;
+    }
+}
+
+inline glm::mat3 CameraRelativeBatch::basis(const glm::quat &rotation, const glm::vec3 &scale) {
+    glm::mat3 m = glm::mat3_cast(rotation);
+    m[0] *= scale.x;
+    m[1] *= scale.y;
+    m[2] *= scale.z;
+    return m;
+}
+
+#endif // LEARNOPENGL_CAMERA_RELATIVE_H
@@ -0,0 +1,269 @@
+#ifndef LEARNOPENGL_CASCADED_SHADOWS_H
+#define LEARNOPENGL_CASCADED_SHADOWS_H
+
+#include <glad/glad.h>
+#include <glm/glm.hpp>
+#include <glm/gtc/matrix_transform.hpp>
+
+#include <vector>
+#include <string>
+#include <cmath>
+#include <iostream>
+#include <algorithm>
+
+#include "bounds.h"
+#include "frustum.h"
+#include "camera.h"
+#include "gpu_profiler.h"
+
+// 实用划分（practical split scheme）：对数划分和均匀划分按 lambda 混合，返回 count + 1 个深度，
+// 第一个是 nearPlane，最后一个是 farPlane
+std::vector<float> PracticalSplits(float nearPlane, float farPlane, int count, float lambda);
+
+// 方向光的级联阴影贴图，所有级联放在一个深度纹理数组中
+//
+// 稳定的级联：每一级用视锥体对应片段的包围球，半径只和视场角、宽高比、划分深度有关，摄像机旋转时不变；
+// 中心在光源空间中对齐到阴影贴图的纹素，摄像机移动时阴影边缘不会闪烁
+//
+// 缓存：FirstCachedCascade 及以后的级联（远处的）范围比包围球大 CacheMargin，中心按更大的步长对齐，
+// 包围球没有超出这个范围时中心保持不动、矩阵不变，不需要重绘；以下情况才重绘：
+//   1. 矩阵变了（包围球超出了缓存的范围、改变了视场角等）
+//   2. Invalidate（静态几何体改变）或光源方向改变
+//   3. 动态投影物体的阴影可能落在这一级的范围内，或者上次绘制时是这样（旧的影子要擦掉）；
+//      物体沿光线方向扫过 DynamicShadowLength 的范围和这一级的深度区间、包围球都相交才算
+// 近处的级联每帧都重绘
+class CascadedShadowMap {
+public:
+    float Lambda = 0.75f;               // 实用划分中对数划分的比重
+    float ShadowDistance = 150.0f;      // 超过这个距离没有阴影
+    float CasterDistance = 100.0f;      // 级联范围之外、朝向光源方向还要包含多远的投影物体
+    int FirstCachedCascade = 2;
+    float CacheMargin = 0.25f;
+    float DynamicShadowLength = 30.0f;  // 动态物体的影子沿光线方向最远落到多远的接收物体上
+
+    explicit CascadedShadowMap(int resolution = 2048, int cascades = 4);
+    ~CascadedShadowMap();
+    CascadedShadowMap(const CascadedShadowMap &) = delete;
+    CascadedShadowMap &operator=(const CascadedShadowMap &) = delete;
+
+    // 方向是光线前进的方向（从光源指向场景），改变时所有级联重绘
+    void SetLightDirection(const glm::vec3 &direction);
+    const glm::vec3 &LightDirection() const { return lightDir; }
+    // 静态几何体改变后调用，所有级联重绘
+    void Invalidate();
+
+    // 每帧渲染阴影前调用：计算划分和每一级的矩阵，决定哪些级联需要重绘
+    // dynamicCasters 是这一帧会动的投影物体的世界空间包围盒
+    void Update(const Camera &camera, float aspect, const std::vector<AABB> &dynamicCasters);
+    // 重绘需要的级联：对每一级调用 draw(cascade, lightViewProjection, frustum)，只画 frustum 内的物体即可
+    // 调用前后绑定的帧缓冲、视口会被修改；profiler 不为空时每一级记为 "shadow cascade i"
+    template<typename DrawFunc>
+    int Render(DrawFunc draw, GpuProfiler *profiler = nullptr);
+
+    int Count() const { return count; }
+    int Resolution() const { return resolution; }
+    unsigned int Texture() const { return texture; }
+    // 第i级的远处分界（观察空间深度），着色器用它选择级联
+    float SplitDepth(int i) const { return splits[i + 1]; }
+    const glm::mat4 &LightViewProjection(int i) const { return cascades[i].ViewProjection; }
+    // 一个纹素在世界空间的大小，用来按法线方向偏移采样位置
+    float TexelWorldSize(int i) const { return cascades[i].TexelSize; }
+    bool NeedsRender(int i) const { return cascades[i].Dirty; }
+    // 第i级视锥体片段的包围球（世界空间，w是半径），用来校验级联范围
+    glm::vec4 SliceSphere(int i) const { return cascades[i].Sphere; }
+
+private:
+    struct Cascade {
+        glm::mat4 ViewProjection = glm::mat4(1.0f);
+        glm::mat4 Rendered = glm::mat4(0.0f);   // 上次绘制时的矩阵
+        glm::vec4 Sphere;
+        glm::vec3 Snapped;                      // 光源空间中对齐后的中心
+        float TexelSize = 0.0f;
+        bool Dirty = true;
+        bool Invalid = true;
+        bool HadDynamic = false;                // 上次绘制时是否有动态物体的阴影
+        bool HasDynamic = false;
+    };
+
+    int resolution, count;
+    unsigned int texture = 0, fbo = 0;
+    glm::vec3 lightDir = glm::vec3(0.0f, -1.0f, 0.0f);
+    glm::mat3 lightRotation = glm::mat3(1.0f);
+    std::vector<float> splits;
+    std::vector<Cascade> cascades;
+};
+
+// 类定义
+// =================================================================================================
+
+inline std::vector<float> PracticalSplits(float nearPlane, float farPlane, int count, float lambda) {
+    std::vector<float> result(count + 1);
+    for (int i = 0; i <= count; i++) {
+        float t = (float) i / count;
+        float logSplit = nearPlane * std::pow(farPlane / nearPlane, t);
+        float uniformSplit = nearPlane + (farPlane - nearPlane) * t;
+        result[i] = lambda * logSplit + (1.0f - lambda) * uniformSplit;
+    }
+    result[0] = nearPlane;
+    result[count] = farPlane;
+    return result;
+}
+
+inline CascadedShadowMap::CascadedShadowMap(int resolution, int cascades)
+        : resolution(resolution), count(cascades), cascades(cascades) {
+    glGenTextures(1, &texture);
+    glBindTexture(GL_TEXTURE_2D_ARRAY, texture);
+    glTexImage3D(GL_TEXTURE_2D_ARRAY, 0, GL_DEPTH_COMPONENT32F, resolution, resolution, cascades, 0,
+                 GL_DEPTH_COMPONENT, GL_FLOAT, nullptr);
+    // 硬件比较 + 线性过滤，一次采样得到2x2的PCF
+    glTexParameteri(GL_TEXTURE_2D_ARRAY, GL_TEXTURE_MIN_FILTER, GL_LINEAR);
+    glTexParameteri(GL_TEXTURE_2D_ARRAY, GL_TEXTURE_MAG_FILTER, GL_LINEAR);
+    glTexParameteri(GL_TEXTURE_2D_ARRAY, GL_TEXTURE_COMPARE_MODE, GL_COMPARE_REF_TO_TEXTURE);
+    glTexParameteri(GL_TEXTURE_2D_ARRAY, GL_TEXTURE_COMPARE_FUNC, GL_LEQUAL);
+    // 范围外的采样都算照亮
+    glTexParameteri(GL_TEXTURE_2D_ARRAY, GL_TEXTURE_WRAP_S, GL_CLAMP_TO_BORDER);
+    glTexParameteri(GL_TEXTURE_2D_ARRAY, GL_TEXTURE_WRAP_T, GL_CLAMP_TO_BORDER);
+    const float border[] = {1.0f, 1.0f, 1.0f, 1.0f};
+    glTexParameterfv(GL_TEXTURE_2D_ARRAY, GL_TEXTURE_BORDER_COLOR, border);
+
+    glGenFramebuffers(1, &fbo);
+    glBindFramebuffer(GL_FRAMEBUFFER, fbo);
+    glFramebufferTextureLayer(GL_FRAMEBUFFER, GL_DEPTH_ATTACHMENT, texture, 0, 0);
+    glDrawBuffer(GL_NONE);
+    glReadBuffer(GL_NONE);
+    if (glCheckFramebufferStatus(GL_FRAMEBUFFER) != GL_FRAMEBUFFER_COMPLETE)
+        std::cout << "ERROR::SHADOWMAP:: Framebuffer is not complete!" << std::endl;
+    glBindFramebuffer(GL_FRAMEBUFFER, 0);
+
+    SetLightDirection(glm::vec3(-0.4f, -1.0f, -0.3f));
+}
+
+inline CascadedShadowMap::~CascadedShadowMap() {
+    glDeleteFramebuffers(1, &fbo);
+    glDeleteTextures(1, &texture);
+}
+
+inline void CascadedShadowMap::SetLightDirection(const glm::vec3 &direction) {
+    glm::vec3 dir = glm::normalize(direction);
+    if (dir == lightDir)
+        return;
+    lightDir = dir;
+    glm::vec3 up = std::abs(dir.y) > 0.99f ? glm::vec3(0.0f, 0.0f, 1.0f) : glm::vec3(0.0f, 1.0f, 0.0f);
+    // 光源空间：-Z 是光线前进的方向，朝向光源的是 +Z
+    lightRotation = glm::mat3(glm::lookAt(glm::vec3(0.0f), dir, up));
+    Invalidate();
+}
+
+inline void CascadedShadowMap::Invalidate() {
+    for (Cascade &c : cascades)
+        c.Invalid = true;
+}
+
+inline void CascadedShadowMap::Update(const Camera &camera, float aspect, const std::vector<AABB> &dynamicCasters) {
+    splits = PracticalSplits(camera.NearPlane, std::min(ShadowDistance, camera.FarPlane), count, Lambda);
+    float tanY = std::tan(glm::radians(camera.Zoom) * 0.5f);
+    float tanX = tanY * aspect;
+    // 片段角点到视线轴的距离 / 深度
+    float diagonal = std::sqrt(tanX * tanX + tanY * tanY);
+    glm::vec3 front = camera.GetFront();
+
+    // 动态物体在光源空间的包围盒，以及沿光线扫过 DynamicShadowLength 后在观察空间的深度范围
+    std::vector<AABB> dynamicLight;
+    std::vector<glm::vec2> dynamicDepth;
+    glm::mat4 rotation4(lightRotation);
+    float sweep = glm::dot(lightDir, front) * DynamicShadowLength;
+    for (const AABB &box : dynamicCasters) {
+        dynamicLight.push_back(box.Transformed(rotation4));
+        float depth = glm::dot(box.Center() - camera.Position, front);
+        float half = glm::dot(glm::abs(front), box.Extents());
+        dynamicDepth.push_back(glm::vec2(depth - half + std::min(sweep, 0.0f), depth + half + std::max(sweep, 0.0f)));
+    }
+
+    for (int i = 0; i < count; i++) {
+        Cascade &c = cascades[i];
+        // 包围球：中心在视线轴上，到近处和远处角点的距离相等，超过远平面时取远平面的中心
+        float n = splits[i], f = splits[i + 1];
+        float an = n * diagonal, af = f * diagonal;
+        float z = std::min((f * f + af * af - n * n - an * an) / (2.0f * (f - n)), f);
+        float radius = std::sqrt((f - z) * (f - z) + af * af);
+        // 半径量化一下，浮点误差不会让它每帧都有微小的变化
+        radius = std::ceil(radius * 16.0f) / 16.0f;
+        glm::vec3 center = camera.Position + front * z;
+        c.Sphere = glm::vec4(center, radius);
+
+        // 范围比包围球大一点，中心按 step 对齐后仍然包含整个包围球；step 是纹素的整数倍，阴影边缘稳定
+        bool cached = i >= FirstCachedCascade;
+        float margin = cached ? CacheMargin : 2.0f / (resolution - 2);
+        float extent = radius * (1.0f + margin);
+        float texel = 2.0f * extent / resolution;
+        float step = std::max(std::floor(radius * margin / texel), 1.0f) * texel;
+        glm::vec3 lightCenter = lightRotation * center;
+        glm::vec3 snapped = glm::floor(lightCenter / step) * step;
+        // 缓存的级联：包围球还在上次的范围内就不移动，避免在对齐的边界附近来回重绘
+        if (cached && !c.Invalid && c.TexelSize == texel) {
+            glm::vec3 offset = glm::abs(lightCenter - c.Snapped);
+            float slack = extent - radius;
+            if (offset.x <= slack && offset.y <= slack && offset.z <= slack)
+                snapped = c.Snapped;
+        }
+        c.TexelSize = texel;
+        c.Snapped = snapped;
+
+        glm::mat4 view = glm::translate(glm::mat4(1.0f), -snapped) * rotation4;
+        glm::mat4 projection = glm::ortho(-extent, extent, -extent, extent, -(extent + CasterDistance), extent);
+        c.ViewProjection = projection * view;
+
+        // 动态物体的阴影会落在这一级的范围内：xy和包围球重叠，不完全在包围球的下游，
+        // 并且影子的深度范围和这一级的深度区间重叠（留几个纹素给过滤和法线偏移）
+        c.HasDynamic = false;
+        float pad = 4.0f * c.TexelSize;
+        for (size_t k = 0; k < dynamicLight.size(); k++) {
+            const AABB &box = dynamicLight[k];
+            if (dynamicDepth[k].y >= n - pad && dynamicDepth[k].x <= f + pad &&
+                box.Max.x >= lightCenter.x - radius && box.Min.x <= lightCenter.x + radius &&
+                box.Max.y >= lightCenter.y - radius && box.Min.y <= lightCenter.y + radius &&
+                box.Max.z >= lightCenter.z - radius) {
+                c.HasDynamic = true;
+                break;
+            }
+        }
+        c.Dirty = !cached || c.Invalid || c.ViewProjection != c.Rendered || c.HasDynamic || c.HadDynamic;
+    }
+}
+
+template<typename DrawFunc>
+int CascadedShadowMap::Render(DrawFunc draw, GpuProfiler *profiler) {
+    glBindFramebuffer(GL_FRAMEBUFFER, fbo);
+    glViewport(0, 0, resolution, resolution);
+    glEnable(GL_DEPTH_TEST);
+    // 光源方向上在近平面之前的投影物体压到深度0，不会被裁掉
+    glEnable(GL_DEPTH_CLAMP);
+    glEnable(GL_POLYGON_OFFSET_FILL);
+    glPolygonOffset(1.5f, 2.0f);
+
+    int rendered = 0;
+    for (int i = 0; i < count; i++) {
+        Cascade &c = cascades[i];
+        if (!c.Dirty)
+            continue;
+        if (profiler)
+            profiler->Begin("shadow cascade " + std::to_string(i));
+        glFramebufferTextureLayer(GL_FRAMEBUFFER, GL_DEPTH_ATTACHMENT, texture, 0, i);
+        glClear(GL_DEPTH_BUFFER_BIT);
+        draw(i, c.ViewProjection, Frustum(c.ViewProjection));
+        if (profiler)
+            profiler->End();
+        c.Rendered = c.ViewProjection;
+        c.Invalid = false;
+        c.HadDynamic = c.HasDynamic;
+        c.Dirty = false;
+        rendered++;
+    }
+
+    glDisable(GL_POLYGON_OFFSET_FILL);
+    glDisable(GL_DEPTH_CLAMP);
+    glBindFramebuffer(GL_FRAMEBUFFER, 0);
+    return rendered;
+}
+
+#endif // LEARNOPENGL_CASCADED_SHADOWS_H
@@ -0,0 +1,512 @@
+#ifndef LEARNOPENGL_CLUSTERED_LIGHTING_H
+#define LEARNOPENGL_CLUSTERED_LIGHTING_H
+
+#include <glad/glad.h>
+#include <glm/glm.hpp>
+
+#include <vector>
+#include <thread>
+#include <cmath>
+#include <algorithm>
+
+#include "bounds.h"
+
+#if defined(__SSE2__) || defined(_M_X64) || (defined(_M_IX86_FP) && _M_IX86_FP >= 2)
+#include <emmintrin.h>
+#define LEARNOPENGL_CLUSTERED_LIGHTING_SSE2 1
+#if defined(_MSC_VER)
+#include <intrin.h>
+#endif
+#endif
+
+// 光源，布局和着色器中 std430 的 Light 结构一致
+// 点光源和聚光灯共用一个结构，聚光灯的 DirectionCosOuter.w 是外锥角的余弦，点光源为 -2（任何方向都在锥内）
+struct ClusteredLight {
+    glm::vec4 PositionRadius;       // xyz: 世界空间位置，w: 影响半径，超过半径的贡献正好为0
+    glm::vec4 ColorIntensity;       // rgb: 颜色，a: 强度
+    glm::vec4 DirectionCosOuter;    // xyz: 聚光方向（归一化），w: 外锥角余弦
+    glm::vec4 CosInner;             // x: 内锥角余弦，其余未使用
+};
+
+ClusteredLight MakePointLight(const glm::vec3 &position, float radius, const glm::vec3 &color, float intensity = 1.0f);
+// innerAngle、outerAngle是半角（角度）
+ClusteredLight MakeSpotLight(const glm::vec3 &position, const glm::vec3 &direction, float radius,
+                             float innerAngle, float outerAngle, const glm::vec3 &color, float intensity = 1.0f);
+bool IsSpotLight(const ClusteredLight &light);
+// 光照范围的包围球（xyz中心，w半径）：点光源就是影响范围；聚光灯是半径内的圆锥，用圆锥的最小包围球，窄的聚光灯比点光源的球小得多
+glm::vec4 LightBoundingSphere(const ClusteredLight &light);
+
+// 分簇前向渲染的光源分配：把视锥体按屏幕划分成 TilesX x TilesY 个格子，深度方向按指数划分成 Slices 层，
+// 每个小视锥体（froxel）记录和它相交的光源列表，片段着色器只计算自己所在簇的光源
+//
+// 每帧在CPU上分配：
+//   1. 光源包围球变换到观察空间，由深度范围得到相交的层
+//   2. 每一层中簇包围盒的x、y范围随格子编号单调递增，二分查找得到x、y方向上可能相交的格子范围，
+//      只对范围内的簇做球和包围盒的精确测试，一行格子用SSE2一次测试4个
+//   3. 按层划分给多个线程（按估计的测试数量均分），每个线程先记录 (簇, 光源) 对，再按簇做计数排序
+// 每个簇内的光源按编号递增排列，结果和线程数、是否使用SIMD无关
+//
+// 结果是两个数组：Clusters 中每个簇一个 (offset, count)，Indices 是所有簇的光源编号依次排列
+// 簇的编号：x + y * TilesX + z * TilesX * TilesY
+class LightClusterer {
+public:
+    LightClusterer(unsigned int tilesX = 16, unsigned int tilesY = 9, unsigned int slices = 24);
+
+    // 投影改变时调用：fovY为弧度，far一般和摄像机的远平面相同；更远的片段算在最后一层，但far之外的光源不会被分配
+    void SetProjection(float fovY, float aspect, float nearPlane, float farPlane);
+    // threads为0时使用所有硬件线程
+    void Assign(const std::vector<ClusteredLight> &lights, const glm::mat4 &view, unsigned int threads = 0, bool simd = true);
+    // 参考实现：每个簇和每个光源都做一次精确测试，用来校验
+    void AssignReference(const std::vector<ClusteredLight> &lights, const glm::mat4 &view);
+
+    const std::vector<glm::uvec2> &Clusters() const { return clusters; }
+    const std::vector<unsigned int> &Indices() const { return indices; }
+    // 簇在观察空间的包围盒
+    AABB ClusterBounds(unsigned int x, unsigned int y, unsigned int z) const;
+
+    unsigned int TilesX() const { return tilesX; }
+    unsigned int TilesY() const { return tilesY; }
+    unsigned int Slices() const { return slices; }
+    unsigned int ClusterCount() const { return tilesX * tilesY * slices; }
+    // 着色器由观察空间深度d计算层：floor(log(d) * SliceScale + SliceBias)
+    float SliceScale() const { return sliceScale; }
+    float SliceBias() const { return sliceBias; }
+    unsigned int SliceForDepth(float depth) const;
+
+    // 上一次分配的统计
+    unsigned int MaxLightsPerCluster() const { return maxPerCluster; }
+    size_t Tests() const { return tests; }
+
+private:
+    // 一个光源在观察空间的包围球和相交的层
+    struct Candidate {
+        glm::vec4 Sphere;
+        unsigned int Light;
+        unsigned int Slice0, Slice1;    // 闭区间
+        float Tiles;                    // 每层大约覆盖的格子数，用来给线程分配工作
+    };
+    // 一个线程的输出
+    struct Worker {
+        std::vector<glm::uvec2> Pairs;  // (簇, 光源)
+        std::vector<unsigned int> Sorted;
+        std::vector<unsigned int> Counts;
+        size_t Tests = 0;
+    };
+
+    unsigned int tilesX, tilesY, slices;
+    unsigned int rowStride;             // 每行格子数对齐到4，SIMD一次读4个不会越界
+    float tanHalfX = 1.0f, tanHalfY = 1.0f, nearPlane = 0.1f, farPlane = 100.0f;
+    float sliceScale = 0.0f, sliceBias = 0.0f;
+    // 簇包围盒，按 (层, 行) 连续存放的SoA，下标 (z * tilesY + y) * rowStride + x
+    std::vector<float> minX, minY, minZ, maxX, maxY, maxZ;
+
+    std::vector<Candidate> candidates;
+    std::vector<Worker> workers;
+    std::vector<glm::uvec2> clusters;
+    std::vector<unsigned int> indices;
+    unsigned int maxPerCluster = 0;
+    size_t tests = 0;
+
+    void gatherCandidates(const std::vector<ClusteredLight> &lights, const glm::mat4 &view);
+    void assignSlices(Worker &worker, unsigned int slice0, unsigned int slice1, bool simd) const;
+    void sortWorker(Worker &worker, unsigned int slice0, unsigned int slice1) const;
+    bool sphereIntersects(size_t soa, const glm::vec4 &sphere) const;
+    // 第z层中x、y方向上可能和球相交的格子（闭区间），没有时返回false
+    bool tileRange(unsigned int z, const glm::vec4 &sphere, unsigned int &x0, unsigned int &x1, unsigned int &y0, unsigned int &y1) const;
+    // 最低的置位的编号，mask不能为0；MSVC没有 __builtin_ctz
+    static int lowestBit(unsigned int mask);
+};
+
+inline int LightClusterer::lowestBit(unsigned int mask) {
+#if defined(_MSC_VER)
+    unsigned long index;
+    _BitScanForward(&index, mask);
+    return (int) index;
+#else
+    return __builtin_ctz(mask);
+#endif
+}
+
+// 分簇结果的GPU缓冲：光源、簇、光源编号三个SSBO（需要OpenGL 4.3），容量不够时才重新分配
+class ClusteredLightBuffers {
+public:
+    ClusteredLightBuffers();
+    ~ClusteredLightBuffers();
+    ClusteredLightBuffers(const ClusteredLightBuffers &) = delete;
+    ClusteredLightBuffers &operator=(const ClusteredLightBuffers &) = delete;
+
+    void UploadLights(const std::vector<ClusteredLight> &lights);
+    void UploadClusters(const LightClusterer &clusterer);
+    // 对应着色器中的 binding
+    void Bind(unsigned int lightBinding = 0, unsigned int clusterBinding = 1, unsigned int indexBinding = 2) const;
+
+private:
+    unsigned int buffers[3] = {0, 0, 0};
+    size_t capacity[3] = {0, 0, 0};
+
+    void upload(int buffer, const void *data, size_t size);
+};
+
+// 类定义
+// =================================================================================================
+
+inline ClusteredLight MakePointLight(const glm::vec3 &position, float radius, const glm::vec3 &color, float intensity) {
+    ClusteredLight light;
+    light.PositionRadius = glm::vec4(position, radius);
+    light.ColorIntensity = glm::vec4(color, intensity);
+    light.DirectionCosOuter = glm::vec4(0.0f, -1.0f, 0.0f, -2.0f);
+    light.CosInner = glm::vec4(-1.0f, 0.0f, 0.0f, 0.0f);
+    return light;
+}
+
+inline ClusteredLight MakeSpotLight(const glm::vec3 &position, const glm::vec3 &direction, float radius,
+                                    float innerAngle, float outerAngle, const glm::vec3 &color, float intensity) {
+    ClusteredLight light;
+    light.PositionRadius = glm::vec4(position, radius);
+    light.ColorIntensity = glm::vec4(color, intensity);
+    light.DirectionCosOuter = glm::vec4(glm::normalize(direction), std::cos(glm::radians(outerAngle)));
+    light.CosInner = glm::vec4(std::cos(glm::radians(innerAngle)), 0.0f, 0.0f, 0.0f);
+    return light;
+}
+
+inline bool IsSpotLight(const ClusteredLight &light) {
+    return light.DirectionCosOuter.w > -1.0f;
+}
+
+inline glm::vec4 LightBoundingSphere(const ClusteredLight &light) {
+    glm::vec3 position(light.PositionRadius);
+    float radius = light.PositionRadius.w;
+    if (!IsSpotLight(light))
+        return light.PositionRadius;
+    glm::vec3 direction(light.DirectionCosOuter);
+    float cosAngle = light.DirectionCosOuter.w;
+    // 半径为r、半角为θ的圆锥（底面是球面）：θ > 45度时包围球以底面圆心为中心，半径为底面圆的半径；
+    // 否则顶点和底面圆都在球面上，半径为 r / (2cosθ)
+    if (cosAngle < 0.70710678f) {
+        float sinAngle = std::sqrt(std::max(1.0f - cosAngle * cosAngle, 0.0f));
+        // 超过90度时底面圆比整个球还大，直接用整个球
+        if (cosAngle <= 0.0f)
+            return light.PositionRadius;
+        return glm::vec4(position + direction * (radius * cosAngle), radius * sinAngle);
+    }
+    float r = radius / (2.0f * cosAngle);
+    return glm::vec4(position + direction * r, r);
+}
+
+inline LightClusterer::LightClusterer(unsigned int tilesX, unsigned int tilesY, unsigned int slices)
+        : tilesX(std::max(tilesX, 1u)), tilesY(std::max(tilesY, 1u)), slices(std::max(slices, 1u)) {
+    rowStride = (this->tilesX + 3) & ~3u;
+    SetProjection(glm::radians(45.0f), 16.0f / 9.0f, 0.1f, 100.0f);
+}
+
+inline void LightClusterer::SetProjection(float fovY, float aspect, float nearZ, float farZ) {
+    tanHalfY = std::tan(fovY * 0.5f);
+    tanHalfX = tanHalfY * aspect;
+    nearPlane = nearZ;
+    farPlane = std::max(farZ, nearZ * 1.001f);
+    float logRatio = std::log(farPlane / nearPlane);
+    sliceScale = slices / logRatio;
+    sliceBias = -(float) slices * std::log(nearPlane) / logRatio;
+
+    size_t size = (size_t) slices * tilesY * rowStride;
+    // 补齐的格子是空盒（Min > Max），和任何球都不相交
+    minX.assign(size, 1e30f);
+    minY.assign(size, 1e30f);
+    minZ.assign(size, 1e30f);
+    maxX.assign(size, -1e30f);
+    maxY.assign(size, -1e30f);
+    maxZ.assign(size, -1e30f);
+    for (unsigned int z = 0; z < slices; z++) {
+        // 指数划分：第k层的近处距离为 near * (far / near)^(k / slices)
+        float depth0 = nearPlane * std::pow(farPlane / nearPlane, (float) z / slices);
+        float depth1 = nearPlane * std::pow(farPlane / nearPlane, (float) (z + 1) / slices);
+        for (unsigned int y = 0; y < tilesY; y++) {
+            float ndcY0 = -1.0f + 2.0f * y / tilesY, ndcY1 = -1.0f + 2.0f * (y + 1) / tilesY;
+            for (unsigned int x = 0; x < tilesX; x++) {
+                float ndcX0 = -1.0f + 2.0f * x / tilesX, ndcX1 = -1.0f + 2.0f * (x + 1) / tilesX;
+                // 小视锥体的8个角点
+                AABB box;
+                for (float depth : {depth0, depth1})
+                    for (float ndcX : {ndcX0, ndcX1})
+                        for (float ndcY : {ndcY0, ndcY1})
+                            box.Grow(glm::vec3(ndcX * tanHalfX * depth, ndcY * tanHalfY * depth, -depth));
+                size_t i = ((size_t) z * tilesY + y) * rowStride + x;
+                minX[i] = box.Min.x;
+                minY[i] = box.Min.y;
+                minZ[i] = box.Min.z;
+                maxX[i] = box.Max.x;
+                maxY[i] = box.Max.y;
+                maxZ[i] = box.Max.z;
+            }
+        }
+    }
+}
+
+inline unsigned int LightClusterer::SliceForDepth(float depth) const {
+    float slice = std::floor(std::log(std::max(depth, nearPlane)) * sliceScale + sliceBias);
+    return (unsigned int) std::min(std::max(slice, 0.0f), (float) (slices - 1));
+}
+
+inline AABB LightClusterer::ClusterBounds(unsigned int x, unsigned int y, unsigned int z) const {
+    size_t i = ((size_t) z * tilesY + y) * rowStride + x;
+    return AABB(glm::vec3(minX[i], minY[i], minZ[i]), glm::vec3(maxX[i], maxY[i], maxZ[i]));
+}
+
+inline bool LightClusterer::sphereIntersects(size_t i, const glm::vec4 &sphere) const {
+    // 球心到包围盒的最近距离，运算顺序和SIMD版本相同，两者结果完全一致
+    float dx = std::max(std::max(minX[i] - sphere.x, 0.0f), sphere.x - maxX[i]);
+    float dy = std::max(std::max(minY[i] - sphere.y, 0.0f), sphere.y - maxY[i]);
+    float dz = std::max(std::max(minZ[i] - sphere.z, 0.0f), sphere.z - maxZ[i]);
+    return dx * dx + dy * dy + dz * dz <= sphere.w * sphere.w;
+}
+
+inline bool LightClusterer::tileRange(unsigned int z, const glm::vec4 &sphere,
+                                      unsigned int &x0, unsigned int &x1, unsigned int &y0, unsigned int &y1) const {
+    // 簇包围盒的x范围只和x有关、y范围只和y有关，并且随格子编号递增；单轴距离的平方已经超过半径平方的格子，
+    // 在 sphereIntersects 中三轴的和只会更大，一定通不过精确测试
+    float r2 = sphere.w * sphere.w;
+    auto outside = [r2](float d) { return d > 0.0f && d * d > r2; };
+    size_t layer = (size_t) z * tilesY * rowStride;
+    unsigned int lo = 0, hi = tilesX;
+    while (lo < hi) {
+        unsigned int mid = (lo + hi) / 2;
+        if (outside(sphere.x - maxX[layer + mid])) lo = mid + 1; else hi = mid;
+    }
+    x0 = lo;
+    hi = tilesX;
+    while (lo < hi) {
+        unsigned int mid = (lo + hi) / 2;
+        if (!outside(minX[layer + mid] - sphere.x)) lo = mid + 1; else hi = mid;
+    }
+    if (lo == x0)
+        return false;
+    x1 = lo - 1;
+
+    lo = 0;
+    hi = tilesY;
+    while (lo < hi) {
+        unsigned int mid = (lo + hi) / 2;
+        if (outside(sphere.y - maxY[layer + (size_t) mid * rowStride])) lo = mid + 1; else hi = mid;
+    }
+    y0 = lo;
+    hi = tilesY;
+    while (lo < hi) {
+        unsigned int mid = (lo + hi) / 2;
+        if (!outside(minY[layer + (size_t) mid * rowStride] - sphere.y)) lo = mid + 1; else hi = mid;
+    }
+    if (lo == y0)
+        return false;
+    y1 = lo - 1;
+    return true;
+}
+
+inline void LightClusterer::gatherCandidates(const std::vector<ClusteredLight> &lights, const glm::mat4 &view) {
+    candidates.clear();
+    for (unsigned int i = 0; i < (unsigned int) lights.size(); i++) {
+        glm::vec4 world = LightBoundingSphere(lights[i]);
+        glm::vec3 center = glm::vec3(view * glm::vec4(glm::vec3(world), 1.0f));
+        float radius = world.w;
+        float depth0 = -center.z - radius, depth1 = -center.z + radius;
+        if (depth1 < nearPlane || depth0 > farPlane)
+            continue;
+
+        Candidate c;
+        c.Sphere = glm::vec4(center, radius);
+        c.Light = i;
+        // 对数的舍入误差可能让层差一，各向外多取一层，是否相交由精确测试决定
+        c.Slice0 = SliceForDepth(depth0);
+        c.Slice1 = SliceForDepth(depth1);
+        c.Slice0 = c.Slice0 > 0 ? c.Slice0 - 1 : 0;
+        c.Slice1 = std::min(c.Slice1 + 1, slices - 1);
+        float depth = std::max(-center.z, nearPlane);
+        float w = std::min(radius / (depth * tanHalfX) * tilesX + 1.0f, (float) tilesX);
+        float h = std::min(radius / (depth * tanHalfY) * tilesY + 1.0f, (float) tilesY);
+        c.Tiles = w * h;
+        candidates.push_back(c);
+    }
+}
+
+inline void LightClusterer::assignSlices(Worker &worker, unsigned int slice0, unsigned int slice1, bool simd) const {
+    worker.Pairs.clear();
+    worker.Tests = 0;
+    for (const Candidate &c : candidates) {
+        unsigned int z0 = std::max(c.Slice0, slice0), z1 = std::min(c.Slice1 + 1, slice1);
+        for (unsigned int z = z0; z < z1; z++) {
+            unsigned int x0, x1, y0, y1;
+            if (!tileRange(z, c.Sphere, x0, x1, y0, y1))
+                continue;
+            worker.Tests += (size_t) (x1 - x0 + 1) * (y1 - y0 + 1);
+            for (unsigned int y = y0; y <= y1; y++) {
+                size_t row = ((size_t) z * tilesY + y) * rowStride;
+                unsigned int clusterRow = (z * tilesY + y) * tilesX;
+#ifdef LEARNOPENGL_CLUSTERED_LIGHTING_SSE2
+                if (simd) {
+                    __m128 cx = _mm_set1_ps(c.Sphere.x), cy = _mm_set1_ps(c.Sphere.y), cz = _mm_set1_ps(c.Sphere.z);
+                    __m128 r2 = _mm_set1_ps(c.Sphere.w * c.Sphere.w);
+                    __m128 zero = _mm_setzero_ps();
+                    // 从对齐到4的位置开始，每次4个格子；范围外的格子用掩码去掉
+                    for (unsigned int x = x0 & ~3u; x <= x1; x += 4) {
+                        size_t i = row + x;
+                        __m128 dx = _mm_max_ps(_mm_max_ps(_mm_sub_ps(_mm_loadu_ps(&minX[i]), cx), zero), _mm_sub_ps(cx, _mm_loadu_ps(&maxX[i])));
+                        __m128 dy = _mm_max_ps(_mm_max_ps(_mm_sub_ps(_mm_loadu_ps(&minY[i]), cy), zero), _mm_sub_ps(cy, _mm_loadu_ps(&maxY[i])));
+                        __m128 dz = _mm_max_ps(_mm_max_ps(_mm_sub_ps(_mm_loadu_ps(&minZ[i]), cz), zero), _mm_sub_ps(cz, _mm_loadu_ps(&maxZ[i])));
+                        __m128 d2 = _mm_add_ps(_mm_add_ps(_mm_mul_ps(dx, dx), _mm_mul_ps(dy, dy)), _mm_mul_ps(dz, dz));
+                        int mask = _mm_movemask_ps(_mm_cmple_ps(d2, r2));
+                        while (mask) {
+                            int lane = lowestBit((unsigned int) mask);
+                            mask &= mask - 1;
+                            unsigned int tx = x + lane;
+                            if (tx >= x0 && tx <= x1)
+                                worker.Pairs.push_back(glm::uvec2(clusterRow + tx, c.Light));
+                        }
+                    }
+                    continue;
+                }
+#endif
+                for (unsigned int x = x0; x <= x1; x++)
+                    if (sphereIntersects(row + x, c.Sphere))
+                        worker.Pairs.push_back(glm::uvec2(clusterRow + x, c.Light));
+            }
+        }
+    }
+}
+
+inline void LightClusterer::sortWorker(Worker &worker, unsigned int slice0, unsigned int slice1) const {
+    // 按簇计数排序，同一个簇内保持光源编号的顺序（候选本来就是按编号排列的）
+    unsigned int first = slice0 * tilesX * tilesY, count = (slice1 - slice0) * tilesX * tilesY;
+    worker.Counts.assign(count + 1, 0);
+    for (const glm::uvec2 &pair : worker.Pairs)
+        worker.Counts[pair.x - first + 1]++;
+    for (unsigned int i = 1; i <= count; i++)
+        worker.Counts[i] += worker.Counts[i - 1];
+    worker.Sorted.resize(worker.Pairs.size());
+    std::vector<unsigned int> cursor(worker.Counts.begin(), worker.Counts.end() - 1);
+    for (const glm::uvec2 &pair : worker.Pairs)
+        worker.Sorted[cursor[pair.x - first]++] = pair.y;
+}
+
+inline void LightClusterer::Assign(const std::vector<ClusteredLight> &lights, const glm::mat4 &view, unsigned int threads, bool simd) {
+    gatherCandidates(lights, view);
+    if (threads == 0)
+        threads = std::max(std::thread::hardware_concurrency(), 1u);
+    threads = std::min(threads, slices);
+
+    // 按每层估计的测试数量把层分给线程，光源在深度方向上分布不均匀时各线程的工作量也差不多
+    std::vector<double> work(slices + 1, 0.0);
+    for (const Candidate &c : candidates)
+        for (unsigned int z = c.Slice0; z <= c.Slice1; z++)
+            work[z + 1] += c.Tiles;
+    for (unsigned int z = 1; z <= slices; z++)
+        work[z] += work[z - 1];
+    std::vector<unsigned int> bounds(threads + 1, slices);
+    bounds[0] = 0;
+    for (unsigned int t = 1; t < threads; t++) {
+        double target = work[slices] * t / threads;
+        unsigned int z = bounds[t - 1];
+        while (z < slices && work[z + 1] <= target)
+            z++;
+        bounds[t] = z;
+    }
+
+    if (workers.size() < threads)
+        workers.resize(threads);
+    std::vector<std::thread> pool;
+    for (unsigned int t = 1; t < threads; t++)
+        pool.emplace_back([this, t, &bounds, simd]() {
+            assignSlices(workers[t], bounds[t], bounds[t + 1], simd);
+            sortWorker(workers[t], bounds[t], bounds[t + 1]);
+        });
+    assignSlices(workers[0], bounds[0], bounds[1], simd);
+    sortWorker(workers[0], bounds[0], bounds[1]);
+    for (std::thread &thread : pool)
+        thread.join();
+
+    // 各线程负责的簇是连续的，按顺序拼起来
+    clusters.resize(ClusterCount());
+    indices.clear();
+    maxPerCluster = 0;
+    tests = 0;
+    for (unsigned int t = 0; t < threads; t++) {
+        const Worker &worker = workers[t];
+        unsigned int first = bounds[t] * tilesX * tilesY, count = (bounds[t + 1] - bounds[t]) * tilesX * tilesY;
+        unsigned int base = (unsigned int) indices.size();
+        for (unsigned int i = 0; i < count; i++) {
+            unsigned int n = worker.Counts[i + 1] - worker.Counts[i];
+            clusters[first + i] = glm::uvec2(base + worker.Counts[i], n);
+            maxPerCluster = std::max(maxPerCluster, n);
+        }
+        indices.insert(indices.end(), worker.Sorted.begin(), worker.Sorted.end());
+        tests += worker.Tests;
+    }
+}
+
+inline void LightClusterer::AssignReference(const std::vector<ClusteredLight> &lights, const glm::mat4 &view) {
+    std::vector<glm::vec4> spheres;
+    for (const ClusteredLight &light : lights) {
+        glm::vec4 world = LightBoundingSphere(light);
+        spheres.push_back(glm::vec4(glm::vec3(view * glm::vec4(glm::vec3(world), 1.0f)), world.w));
+    }
+    clusters.resize(ClusterCount());
+    indices.clear();
+    maxPerCluster = 0;
+    tests = 0;
+    for (unsigned int z = 0; z < slices; z++) {
+        for (unsigned int y = 0; y < tilesY; y++) {
+            for (unsigned int x = 0; x < tilesX; x++) {
+                size_t i = ((size_t) z * tilesY + y) * rowStride + x;
+                unsigned int offset = (unsigned int) indices.size();
+                for (unsigned int l = 0; l < (unsigned int) spheres.size(); l++) {
+                    // 深度范围之外的光源不分配，和快速路径一致
+                    float depth = -spheres[l].z;
+                    if (depth + spheres[l].w < nearPlane || depth - spheres[l].w > farPlane)
+                        continue;
+                    if (sphereIntersects(i, spheres[l]))
+                        indices.push_back(l);
+                }
+                unsigned int n = (unsigned int) indices.size() - offset;
+                clusters[(z * tilesY + y) * tilesX + x] = glm::uvec2(offset, n);
+                maxPerCluster = std::max(maxPerCluster, n);
+                tests += spheres.size();
+            }
+        }
+    }
+}
+
+inline ClusteredLightBuffers::ClusteredLightBuffers() {
+    glGenBuffers(3, buffers);
+}
+
+inline ClusteredLightBuffers::~ClusteredLightBuffers() {
+    glDeleteBuffers(3, buffers);
+}
+
+inline void ClusteredLightBuffers::UploadLights(const std::vector<ClusteredLight> &lights) {
+    upload(0, lights.data(), lights.size() * sizeof(ClusteredLight));
+}
+
+inline void ClusteredLightBuffers::UploadClusters(const LightClusterer &clusterer) {
+    upload(1, clusterer.Clusters().data(), clusterer.Clusters().size() * sizeof(glm::uvec2));
+    upload(2, clusterer.Indices().data(), clusterer.Indices().size() * sizeof(unsigned int));
+}
+
+inline void ClusteredLightBuffers::Bind(unsigned int lightBinding, unsigned int clusterBinding, unsigned int indexBinding) const {
+    glBindBufferBase(GL_SHADER_STORAGE_BUFFER, lightBinding, buffers[0]);
+    glBindBufferBase(GL_SHADER_STORAGE_BUFFER, clusterBinding, buffers[1]);
+    glBindBufferBase(GL_SHADER_STORAGE_BUFFER, indexBinding, buffers[2]);
+}
+
+inline void ClusteredLightBuffers::upload(int buffer, const void *data, size_t size) {
+    glBindBuffer(GL_SHADER_STORAGE_BUFFER, buffers[buffer]);
+    // 空的SSBO不能绑定，至少分配一个元素；容量按1.5倍增长，光源数量变化时不用每帧重新分配
+    if (size > capacity[buffer] || capacity[buffer] == 0) {
+        capacity[buffer] = std::max(size + size / 2, (size_t) 64);
+        glBufferData(GL_SHADER_STORAGE_BUFFER, capacity[buffer], nullptr, GL_STREAM_DRAW);
+    } else {
+        // 丢弃旧内容，驱动可以换一块新的存储，不用等上一帧的绘制读完
+        glInvalidateBufferData(buffers[buffer]);
+    }
+    if (size > 0)
+        glBufferSubData(GL_SHADER_STORAGE_BUFFER, 0, size, data);
+}
+
+#endif // LEARNOPENGL_CLUSTERED_LIGHTING_H
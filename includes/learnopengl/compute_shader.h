@@ -0,0 +1,149 @@
+#ifndef LEARNOPENGL_COMPUTE_SHADER_H
+#define LEARNOPENGL_COMPUTE_SHADER_H
+
+#include <glad/glad.h>
+#include <glm/glm.hpp>
+
+#include <string>
+#include <fstream>
+#include <sstream>
+#include <iostream>
+
+// 计算着色器程序（需要OpenGL 4.3），接口和Shader类保持一致
+class ComputeShader {
+public:
+    unsigned int ID;
+    // 参数是计算着色器源码路径
+    explicit ComputeShader(const char *computePath);
+    // 激活着色器程序
+    void use() const { glUseProgram(ID); }
+    // 按工作组数量分发，x/y/z 是需要覆盖的线程总数，内部按 local size 向上取整
+    void dispatch(unsigned int x, unsigned int y = 1, unsigned int z = 1) const;
+    // uniform工具函数
+    void setBool(const std::string &name, bool value) const;
+    void setInt(const std::string &name, int value) const;
+    void setUInt(const std::string &name, unsigned int value) const;
+    void setFloat(const std::string &name, float value) const;
+    void setVec2(const std::string &name, const glm::vec2 &value) const;
+    void setIVec2(const std::string &name, int x, int y) const;
+    void setVec3(const std::string &name, const glm::vec3 &value) const;
+    void setVec4(const std::string &name, const glm::vec4 &value) const;
+    void setVec4Array(const std::string &name, const glm::vec4 *values, int count) const;
+    void setMat4(const std::string &name, const glm::mat4 &mat) const;
+
+private:
+    int localSize[3];
+
+    void checkCompileErrors(unsigned int shader, std::string type);
+};
+
+// 类定义
+// =================================================================================================
+
+inline ComputeShader::ComputeShader(const char *computePath) : ID(0), localSize{1, 1, 1} {
+    using namespace std;
+
+    string computeCode;
+    ifstream cShaderFile;
+    cShaderFile.exceptions(ifstream::failbit | ifstream::badbit);
+    try {
+        cShaderFile.open(computePath);
+        stringstream cShaderStream;
+        cShaderStream << cShaderFile.rdbuf();
+        cShaderFile.close();
+        computeCode = cShaderStream.str();
+    }
+    catch (ifstream::failure &e) {
+        cout << "ERROR::SHADER::FILE_NOT_SUCCESSFULLY_READ: " << computePath << endl;
+    }
+    const char *cShaderCode = computeCode.c_str();
+
+    unsigned int compute = glCreateShader(GL_COMPUTE_SHADER);
+    glShaderSource(compute, 1, &cShaderCode, nullptr);
+    glCompileShader(compute);
+    checkCompileErrors(compute, "COMPUTE");
+
+    ID = glCreateProgram();
+    glAttachShader(ID, compute);
+    glLinkProgram(ID);
+    checkCompileErrors(ID, "PROGRAM");
+    glDeleteShader(compute);
+
+    // 记下 local_size，dispatch 的时候不需要调用者再算一遍
+    glGetProgramiv(ID, GL_COMPUTE_WORK_GROUP_SIZE, localSize);
+}
+
+inline void ComputeShader::dispatch(unsigned int x, unsigned int y, unsigned int z) const {
+    glDispatchCompute((x + localSize[0] - 1) / localSize[0],
+                      (y + localSize[1] - 1) / localSize[1],
+                      (z + localSize[2] - 1) / localSize[2]);
+}
+
+inline void ComputeShader::checkCompileErrors(unsigned int shader, std::string type) {
+    using std::cout;
+    using std::endl;
+
+    int success;
+    char infoLog[1024];
+    if (type != "PROGRAM") {
+        glGetShaderiv(shader, GL_COMPILE_STATUS, &success);
+        if (!success) {
+            glGetShaderInfoLog(shader, 1024, nullptr, infoLog);
+            cout << "ERROR::SHADER_COMPILATION_ERROR of type: " << type << "\n" << infoLog
+                 << "\n -- --------------------------------------------------- -- " << endl;
+        }
+    } else {
+        glGetProgramiv(shader, GL_LINK_STATUS, &success);
+        if (!success) {
+            glGetProgramInfoLog(shader, 1024, nullptr, infoLog);
+            cout << "ERROR::PROGRAM_LINKING_ERROR of type: " << type << "\n" << infoLog
+                 << "\n -- --------------------------------------------------- -- " << endl;
+        }
+    }
+}
+
+inline void ComputeShader::setBool(const std::string &name, bool value) const {
+    glUniform1i(glGetUniformLocation(ID, name.c_str()), (int) value);
+}
+
+inline void ComputeShader::setInt(const std::string &name, int value) const {
+    glUniform1i(glGetUniformLocation(ID, name.c_str()), value);
+}
+
+inline void ComputeShader::setUInt(const std::string &name, unsigned int value) const {
+    glUniform1ui(glGetUniformLocation(ID, name.c_str()), value);
+}
+
+inline void ComputeShader::setFloat(const std::string &name, float value) const {
+    glUniform1f(glGetUniformLocation(ID, name.c_str()), value);
+}
+
+// -------------------------------------------------------------------------------
+inline void ComputeShader::setVec2(const std::string &name, const glm::vec2 &value) const {
+    glUniform2fv(glGetUniformLocation(ID, name.c_str()), 1, &value[0]);
+}
+
+inline void ComputeShader::setIVec2(const std::string &name, int x, int y) const {
+    glUniform2i(glGetUniformLocation(ID, name.c_str()), x, y);
+}
+
+// -------------------------------------------------------------------------------
+inline void ComputeShader::setVec3(const std::string &name, const glm::vec3 &value) const {
+    glUniform3fv(glGetUniformLocation(ID, name.c_str()), 1, &value[0]);
+}
+
+// -------------------------------------------------------------------------------
+inline void ComputeShader::setVec4(const std::string &name, const glm::vec4 &value) const {
+    glUniform4fv(glGetUniformLocation(ID, name.c_str()), 1, &value[0]);
+}
+
+inline void ComputeShader::setVec4Array(const std::string &name, const glm::vec4 *values, int count) const {
+    glUniform4fv(glGetUniformLocation(ID, name.c_str()), count, &values[0][0]);
+}
+
+// -------------------------------------------------------------------------------
+inline void ComputeShader::setMat4(const std::string &name, const glm::mat4 &mat) const {
+    glUniformMatrix4fv(glGetUniformLocation(ID, name.c_str()), 1, GL_FALSE, &mat[0][0]);
+}
+
+#endif // LEARNOPENGL_COMPUTE_SHADER_H
@@ -0,0 +1,192 @@
+#ifndef LEARNOPENGL_COOKED_MESH_H
+#define LEARNOPENGL_COOKED_MESH_H
+
+#include <glad/glad.h>
+#include <glm/glm.hpp>
+
+#include <learnopengl/bounds.h>
+#include <learnopengl/mesh_import.h>
+
+#include <cstdint>
+#include <vector>
+#include <string>
+
+// 预烘焙的二进制网格（.mesh）：离线把 ImportedMesh 转换成GPU直接可用的格式，运行时映射文件后
+// 顶点和索引整块交给 glBufferData，不再逐顶点处理
+//
+// 文件布局（小端），每一段的起点都16字节对齐：
+//   CookedMeshHeader
+//   CookedAttribute[AttributeCount]     顶点格式
+//   CookedLod[LodCount]                 LOD表，LOD 0 是原始网格
+//   CookedMeshlet[MeshletCount]         所有LOD的小簇，按LOD排列
+//   顶点数据    VertexCount * VertexStride 字节，交错排列
+//   索引数据    IndexCount 个 IndexType（16位或32位），所有LOD依次排列，每个LOD内按小簇的顺序
+//   小簇的顶点  MeshletVertexCount 个uint32，每个小簇用到的顶点编号
+//   小簇的三角形 MeshletTriangleCount * 3 个uint8，小簇内的局部索引
+// 最后两段是给网格着色器用的格式；OpenGL 3.3 用索引数据中对应的范围绘制小簇（见 CookedMeshlet::IndexOffset）
+const uint32_t COOKED_MESH_MAGIC = 0x48534D43;     // "CMSH"
+const uint32_t COOKED_MESH_VERSION = 1;
+const unsigned int COOKED_MESH_ALIGNMENT = 16;
+const unsigned int COOKED_MESH_MAX_ATTRIBUTES = 4;
+const unsigned int MESHLET_MAX_VERTICES = 64;
+const unsigned int MESHLET_MAX_TRIANGLES = 124;
+
+// 顶点属性的位置，和着色器中的 layout (location = ...) 对应
+enum CookedAttributeLocation { COOKED_POSITION = 0, COOKED_NORMAL = 1, COOKED_TEXCOORD = 2 };
+
+const uint32_t COOKED_HAS_NORMALS = 1;
+const uint32_t COOKED_HAS_TEXCOORDS = 2;
+
+struct CookedMeshHeader {
+    uint32_t Magic;
+    uint32_t Version;
+    uint64_t FileSize;
+    uint32_t Flags;                 // COOKED_HAS_NORMALS | COOKED_HAS_TEXCOORDS
+    uint32_t VertexCount;
+    uint32_t VertexStride;
+    uint32_t AttributeCount;
+    uint32_t IndexCount;            // 所有LOD的索引总数
+    uint32_t IndexType;             // GL_UNSIGNED_SHORT 或 GL_UNSIGNED_INT
+    uint32_t LodCount;
+    uint32_t MeshletCount;
+    uint32_t MeshletVertexCount;
+    uint32_t MeshletTriangleCount;
+    float BoundsMin[3];
+    float BoundsMax[3];
+    uint64_t AttributeOffset;       // 各段在文件中的字节偏移
+    uint64_t LodOffset;
+    uint64_t MeshletOffset;
+    uint64_t VertexOffset;
+    uint64_t IndexOffset;
+    uint64_t MeshletVertexOffset;
+    uint64_t MeshletTriangleOffset;
+};
+
+// 一个顶点属性，参数和 glVertexAttribPointer 相同，ComponentType 是GL的枚举值
+struct CookedAttribute {
+    uint32_t Location;
+    uint32_t Components;
+    uint32_t ComponentType;
+    uint32_t Normalized;
+    uint32_t Offset;                // 在顶点中的字节偏移
+};
+
+// 一级LOD：索引数据中的范围和它的小簇
+struct CookedLod {
+    uint32_t IndexOffset;           // 第一个索引的编号（不是字节）
+    uint32_t IndexCount;
+    uint32_t MeshletOffset;
+    uint32_t MeshletCount;
+    float Error;                    // 简化的误差（模型空间的长度），LOD 0 为0
+};
+
+// 小簇：最多 MESHLET_MAX_VERTICES 个顶点、MESHLET_MAX_TRIANGLES 个三角形，带包围盒和法线锥
+// 法线锥用于背面剔除：从 Eye 看过去 dot(Center - Eye, ConeAxis) >= ConeCutoff * |Center - Eye| + Radius 时，
+// 小簇的所有三角形都是背面；ConeCutoff 为1时不能剔除
+struct CookedMeshlet {
+    uint32_t VertexOffset;          // 在小簇顶点中的起点
+    uint32_t VertexCount;
+    uint32_t TriangleOffset;        // 在小簇三角形中的起点（三角形编号）
+    uint32_t TriangleCount;
+    uint32_t IndexOffset;           // 在索引数据中的起点，共 TriangleCount * 3 个索引
+    float BoundsMin[3];
+    float BoundsMax[3];
+    float ConeAxis[3];
+    float ConeCutoff;
+
+    AABB Bounds() const { return AABB(glm::vec3(BoundsMin[0], BoundsMin[1], BoundsMin[2]), glm::vec3(BoundsMax[0], BoundsMax[1], BoundsMax[2])); }
+    // 从 eye（模型空间）看过去小簇的所有三角形都是背面
+    bool BackFacing(const glm::vec3 &eye) const;
+};
+
+// 离线烘焙：顶点格式、LOD、小簇，输出 .mesh 文件的内容
+// LOD用顶点聚类生成：按网格单元合并顶点，每个单元取最接近单元内平均位置的原始顶点，所有LOD共用一份顶点数据；
+// 网格单元的大小自动调整到三角形数大约是上一级的 LodRatio 倍，三角形太少时提前结束
+// 每个LOD的三角形按重心的Morton码排序后贪心地切成小簇，空间上相邻的三角形在同一个小簇中，剔除更有效
+// 定义在 src/cooked_mesh.cpp 中，随引擎库一起编译
+class MeshCooker {
+public:
+    // 紧凑的顶点格式：位置3个float，法线 GL_INT_2_10_10_10_REV，纹理坐标 GL_HALF_FLOAT，20字节；
+    // false时保持 MeshVertex 的32字节格式，和导入的结果逐位相同
+    bool CompactVertices = true;
+    // LOD的级数（包括原始网格）和相邻两级的三角形数之比
+    unsigned int LodCount = 4;
+    float LodRatio = 0.25f;
+
+    bool Cook(const ImportedMesh &mesh, std::vector<unsigned char> &data);
+    bool Write(const ImportedMesh &mesh, const char *path);
+    const std::string &Error() const { return error; }
+
+private:
+    std::string error;
+};
+
+// 映射的 .mesh 文件。Open 只检查文件头和各个表（LOD、小簇）是否在范围内，不读取顶点和索引，
+// 所以打开的时间和网格大小无关；来源不可信的文件先用 Verify 检查所有索引
+// 定义在 src/cooked_mesh.cpp 中，随引擎库一起编译
+class CookedMesh {
+public:
+    bool Open(const char *path);
+    // 从内存中解析，data 要一直有效并且4字节对齐
+    bool Parse(const unsigned char *data, size_t size);
+    // 逐项检查：索引和小簇的顶点都小于 VertexCount，小簇的三角形和索引数据中对应的范围相同
+    bool Verify();
+
+    bool IsOpen() const { return header != nullptr; }
+    const CookedMeshHeader &Header() const { return *header; }
+    AABB Bounds() const;
+    bool HasNormals() const { return (header->Flags & COOKED_HAS_NORMALS) != 0; }
+    bool HasTexCoords() const { return (header->Flags & COOKED_HAS_TEXCOORDS) != 0; }
+    unsigned int IndexSize() const { return header->IndexType == GL_UNSIGNED_SHORT ? 2 : 4; }
+
+    const CookedAttribute *Attributes() const { return reinterpret_cast<const CookedAttribute *>(data + header->AttributeOffset); }
+    const CookedLod &Lod(unsigned int i) const { return reinterpret_cast<const CookedLod *>(data + header->LodOffset)[i]; }
+    const CookedMeshlet *Meshlets() const { return reinterpret_cast<const CookedMeshlet *>(data + header->MeshletOffset); }
+    const unsigned char *VertexData() const { return data + header->VertexOffset; }
+    size_t VertexBytes() const { return (size_t) header->VertexCount * header->VertexStride; }
+    const unsigned char *IndexData() const { return data + header->IndexOffset; }
+    size_t IndexBytes() const { return (size_t) header->IndexCount * IndexSize(); }
+    const uint32_t *MeshletVertices() const { return reinterpret_cast<const uint32_t *>(data + header->MeshletVertexOffset); }
+    const uint8_t *MeshletTriangles() const { return data + header->MeshletTriangleOffset; }
+
+    const MappedFile &File() const { return file; }
+    const std::string &Error() const { return error; }
+
+private:
+    MappedFile file;
+    const unsigned char *data = nullptr;
+    const CookedMeshHeader *header = nullptr;
+    std::string error;
+};
+
+// .mesh 在GPU上的缓冲：映射的顶点和索引数据各用一次 glBufferData 上传，顶点属性按文件中的顶点格式设置
+// 定义在 src/cooked_mesh.cpp 中，随引擎库一起编译
+class CookedMeshBuffers {
+public:
+    CookedMeshBuffers() = default;
+    ~CookedMeshBuffers() { Release(); }
+    CookedMeshBuffers(const CookedMeshBuffers &) = delete;
+    CookedMeshBuffers &operator=(const CookedMeshBuffers &) = delete;
+
+    void Upload(const CookedMesh &mesh);
+    void Release();
+
+    // 画一整级LOD
+    void DrawLod(unsigned int lod) const;
+    // 画一组小簇（CookedMesh::Meshlets() 中的编号），一次 glMultiDrawElements
+    void DrawMeshlets(const std::vector<unsigned int> &meshlets) const;
+
+    unsigned int VAO() const { return vao; }
+
+private:
+    unsigned int vao = 0, vbo = 0, ebo = 0;
+    GLenum indexType = GL_UNSIGNED_INT;
+    unsigned int indexSize = 4;
+    std::vector<CookedLod> lods;
+    std::vector<CookedMeshlet> meshlets;
+    // DrawMeshlets 的参数，避免每帧分配
+    mutable std::vector<GLsizei> counts;
+    mutable std::vector<const void *> offsets;
+};
+
+#endif // LEARNOPENGL_COOKED_MESH_H
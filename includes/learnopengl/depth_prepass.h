@@ -0,0 +1,206 @@
+#ifndef LEARNOPENGL_DEPTH_PREPASS_H
+#define LEARNOPENGL_DEPTH_PREPASS_H
+
+#include <glad/glad.h>
+
+#include <vector>
+#include <iostream>
+#include <algorithm>
+
+// 深度预渲染（depth pre-pass）：先只写深度画一遍场景，再用 GL_EQUAL 深度测试、不写深度画一遍着色，
+// 每个像素只有最终可见的片段会执行着色器（依赖早期深度测试，片段着色器不能写 gl_FragDepth、不能 discard）
+// 预渲染用只有位置的顶点流和空的片段着色器，两遍的顶点着色器都要声明 invariant gl_Position，
+// 否则不同的程序算出的深度可能差一点，GL_EQUAL 会漏掉像素
+// 两个表面的深度量化后恰好相等时两个片段都会通过，留下的是后画的（不用预渲染时是先画的），只影响极少数像素
+//
+// PREPASS_AUTO：根据 OverdrawMeter 测得的过度绘制决定是否启用，带迟滞：
+// 有覆盖的像素平均片段数超过 EnableOverdraw 才启用，低于 DisableOverdraw 才关闭
+enum DepthPrepassMode { PREPASS_OFF = 0, PREPASS_ON, PREPASS_AUTO };
+
+class DepthPrepass {
+public:
+    DepthPrepassMode Mode = PREPASS_AUTO;
+    float EnableOverdraw = 3.0f;        // 预渲染要多画一遍几何体，过度绘制不够多时不划算
+    float DisableOverdraw = 2.0f;
+    unsigned int MeasureInterval = 120; // PREPASS_AUTO 下每隔多少帧测一次过度绘制
+
+    // 这一帧是否使用预渲染
+    bool Enabled() const { return Mode == PREPASS_ON || (Mode == PREPASS_AUTO && autoEnabled); }
+    // 每帧调用一次，PREPASS_AUTO 下到了该测量过度绘制的帧（包括第一帧）返回true
+    bool NeedsMeasurement();
+    // 传入不用预渲染时测得的有覆盖像素的平均片段数，更新自动模式的状态
+    void ReportOverdraw(float fragmentsPerCoveredPixel);
+
+    // 调用前清空深度；drawDepth 用只有位置的程序画不透明物体，drawColor 画着色的一遍
+    // 结束后恢复 GL_LESS、深度写入和颜色写入
+    template<typename DepthFunc, typename ColorFunc>
+    void Render(DepthFunc drawDepth, ColorFunc drawColor) const;
+
+    float LastOverdraw() const { return lastOverdraw; }
+    unsigned int Switches() const { return switches; }
+
+private:
+    bool autoEnabled = false;
+    unsigned int framesUntilMeasure = 0;
+    float lastOverdraw = 0.0f;
+    unsigned int switches = 0;
+};
+
+// 过度绘制的统计：每个像素通过深度测试、被着色的片段数
+struct OverdrawStats {
+    double FragmentsPerPixel = 0.0;         // 所有像素的平均
+    double FragmentsPerCoveredPixel = 0.0;  // 至少有一个片段的像素的平均
+    double Coverage = 0.0;                  // 有片段的像素比例
+    unsigned int MaxFragments = 0;
+    double TotalFragments = 0.0;
+};
+
+// 过度绘制的测量：场景画到自己的 R32F 颜色缓冲和深度缓冲上，片段着色器输出1，加法混合累加出每个像素的片段数，
+// 读回CPU求平均；Texture() 可以直接用来显示热度图
+// 混合在深度测试之后，统计的是通过深度测试的片段；有早期深度测试时就是实际执行着色器的片段数，
+// 没有时被挡住的片段也会着色，实际开销更大
+// 读回会让CPU等GPU，只适合隔一段时间测一次
+class OverdrawMeter {
+public:
+    OverdrawMeter(int width, int height);
+    ~OverdrawMeter();
+    OverdrawMeter(const OverdrawMeter &) = delete;
+    OverdrawMeter &operator=(const OverdrawMeter &) = delete;
+
+    void Resize(int width, int height);
+    // 绑定自己的帧缓冲、清空、打开加法混合后调用 draw()，draw 中的颜色输出要换成输出1的片段着色器
+    // 结束后恢复默认帧缓冲，视口需要调用者重新设置
+    template<typename DrawFunc>
+    OverdrawStats Measure(DrawFunc draw);
+
+    unsigned int Texture() const { return color; }
+    int Width() const { return width; }
+    int Height() const { return height; }
+
+private:
+    unsigned int fbo = 0, color = 0, depth = 0;
+    int width, height;
+    std::vector<float> counts;
+
+    void create();
+    void destroy();
+};
+
+// 类定义
+// =================================================================================================
+
+inline bool DepthPrepass::NeedsMeasurement() {
+    if (Mode != PREPASS_AUTO)
+        return false;
+    if (framesUntilMeasure > 0) {
+        framesUntilMeasure--;
+        return false;
+    }
+    framesUntilMeasure = MeasureInterval;
+    return true;
+}
+
+inline void DepthPrepass::ReportOverdraw(float fragmentsPerCoveredPixel) {
+    lastOverdraw = fragmentsPerCoveredPixel;
+    bool enable = autoEnabled ? fragmentsPerCoveredPixel >= DisableOverdraw : fragmentsPerCoveredPixel > EnableOverdraw;
+    if (enable != autoEnabled)
+        switches++;
+    autoEnabled = enable;
+}
+
+template<typename DepthFunc, typename ColorFunc>
+void DepthPrepass::Render(DepthFunc drawDepth, ColorFunc drawColor) const {
+    glEnable(GL_DEPTH_TEST);
+    glDepthFunc(GL_LESS);
+    glDepthMask(GL_TRUE);
+    if (!Enabled()) {
+        drawColor();
+        return;
+    }
+    glColorMask(GL_FALSE, GL_FALSE, GL_FALSE, GL_FALSE);
+    drawDepth();
+    glColorMask(GL_TRUE, GL_TRUE, GL_TRUE, GL_TRUE);
+    // 深度已经是最终结果，着色的一遍只让深度相等的片段通过
+    glDepthFunc(GL_EQUAL);
+    glDepthMask(GL_FALSE);
+    drawColor();
+    glDepthFunc(GL_LESS);
+    glDepthMask(GL_TRUE);
+}
+
+inline OverdrawMeter::OverdrawMeter(int width, int height) : width(width), height(height) {
+    create();
+}
+
+inline OverdrawMeter::~OverdrawMeter() {
+    destroy();
+}
+
+inline void OverdrawMeter::Resize(int newWidth, int newHeight) {
+    if (newWidth == width && newHeight == height)
+        return;
+    destroy();
+    width = newWidth;
+    height = newHeight;
+    create();
+}
+
+template<typename DrawFunc>
+OverdrawStats OverdrawMeter::Measure(DrawFunc draw) {
+    glBindFramebuffer(GL_FRAMEBUFFER, fbo);
+    glViewport(0, 0, width, height);
+    glClearColor(0.0f, 0.0f, 0.0f, 0.0f);
+    glClear(GL_COLOR_BUFFER_BIT | GL_DEPTH_BUFFER_BIT);
+    glEnable(GL_BLEND);
+    glBlendFunc(GL_ONE, GL_ONE);
+    draw();
+    glDisable(GL_BLEND);
+
+    counts.resize((size_t) width * height);
+    glReadPixels(0, 0, width, height, GL_RED, GL_FLOAT, counts.data());
+    glBindFramebuffer(GL_FRAMEBUFFER, 0);
+
+    OverdrawStats stats;
+    size_t covered = 0;
+    for (float c : counts) {
+        stats.TotalFragments += c;
+        if (c > 0.0f)
+            covered++;
+        stats.MaxFragments = std::max(stats.MaxFragments, (unsigned int) c);
+    }
+    stats.FragmentsPerPixel = stats.TotalFragments / counts.size();
+    stats.FragmentsPerCoveredPixel = covered ? stats.TotalFragments / covered : 0.0;
+    stats.Coverage = (double) covered / counts.size();
+    return stats;
+}
+
+inline void OverdrawMeter::create() {
+    glGenFramebuffers(1, &fbo);
+    glBindFramebuffer(GL_FRAMEBUFFER, fbo);
+
+    // 32位浮点累加，2^24 以内的整数是精确的
+    glGenTextures(1, &color);
+    glBindTexture(GL_TEXTURE_2D, color);
+    glTexImage2D(GL_TEXTURE_2D, 0, GL_R32F, width, height, 0, GL_RED, GL_FLOAT, nullptr);
+    glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_MIN_FILTER, GL_NEAREST);
+    glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_MAG_FILTER, GL_NEAREST);
+    glFramebufferTexture2D(GL_FRAMEBUFFER, GL_COLOR_ATTACHMENT0, GL_TEXTURE_2D, color, 0);
+
+    glGenRenderbuffers(1, &depth);
+    glBindRenderbuffer(GL_RENDERBUFFER, depth);
+    glRenderbufferStorage(GL_RENDERBUFFER, GL_DEPTH_COMPONENT24, width, height);
+    glFramebufferRenderbuffer(GL_FRAMEBUFFER, GL_DEPTH_ATTACHMENT, GL_RENDERBUFFER, depth);
+
+    if (glCheckFramebufferStatus(GL_FRAMEBUFFER) != GL_FRAMEBUFFER_COMPLETE)
+        std::cout << "ERROR::OVERDRAW:: Framebuffer is not complete!" << std::endl;
+    glBindFramebuffer(GL_FRAMEBUFFER, 0);
+}
+
+inline void OverdrawMeter::destroy() {
+    glDeleteFramebuffers(1, &fbo);
+    glDeleteTextures(1, &color);
+    glDeleteRenderbuffers(1, &depth);
+    fbo = color = depth = 0;
+}
+
+#endif // LEARNOPENGL_DEPTH_PREPASS_H
@@ -0,0 +1,271 @@
+#ifndef LEARNOPENGL_DYNAMIC_RESOLUTION_H
+#define LEARNOPENGL_DYNAMIC_RESOLUTION_H
+
+#include <glad/glad.h>
+
+#include <vector>
+#include <cmath>
+#include <iostream>
+#include <algorithm>
+
+// GPU计时：GL_TIME_ELAPSED 查询组成的环，结果要等GPU执行完才有，所以总是读几帧以前的结果
+// Poll不会等待GPU；只有环满了、最老的查询还没完成时，Begin才会等它
+class GpuTimer {
+public:
+    explicit GpuTimer(unsigned int latency = 4);
+    ~GpuTimer();
+    GpuTimer(const GpuTimer &) = delete;
+    GpuTimer &operator=(const GpuTimer &) = delete;
+
+    void Begin();
+    void End();
+    // 取出所有已经完成的查询，ms是其中最新的一个（毫秒）；没有新结果时返回false
+    bool Poll(double &ms);
+
+private:
+    std::vector<unsigned int> queries;
+    unsigned int next = 0;      // 下一个要发出的查询
+    unsigned int pending = 0;   // 已发出、还没读取的查询数量
+    bool hasResult = false;
+    double lastMs = 0.0;
+
+    void readOldest();
+};
+
+// 动态分辨率控制器：每帧传入测得的GPU时间，调整内部渲染分辨率的缩放（每个轴），让GPU时间保持在目标以内
+// 假设GPU时间大致和像素数量成正比，即和 Scale^2 成正比，一次就调到预测的目标位置，而不是一小步一小步地试
+// 迟滞：超过 目标 * UpperBound 连续 DecreaseFrames 帧才降低分辨率，低于 目标 * LowerBound 连续 IncreaseFrames 帧才提高，
+// 两者之间不调整；每次调整后等待 Cooldown 帧，计时结果有几帧延迟，不等的话会根据旧分辨率的时间再调一次
+class ResolutionController {
+public:
+    explicit ResolutionController(double targetMs = 1000.0 / 60.0, float minScale = 0.5f, float maxScale = 1.0f)
+            : TargetMs(targetMs), MinScale(minScale), MaxScale(maxScale), scale(maxScale) {}
+
+    double TargetMs;
+    float MinScale;
+    float MaxScale;
+    float ScaleStep = 0.05f;            // 缩放按这个粒度取整，避免每次只差一两个像素的调整
+    double UpperBound = 1.0;
+    double LowerBound = 0.8;
+    unsigned int DecreaseFrames = 2;    // 降分辨率要快，掉帧比画面模糊更明显
+    unsigned int IncreaseFrames = 30;   // 升分辨率要慢，避免负载刚下去又上来时来回切换
+    unsigned int Cooldown = 8;
+    double Smoothing = 0.25;            // GPU时间的指数平均系数
+
+    // 返回这一帧应该使用的缩放
+    float Update(double gpuMs);
+    void Reset(float initialScale);
+
+    float Scale() const { return scale; }
+    double SmoothedMs() const { return smoothedMs; }
+    unsigned int Changes() const { return changes; }
+
+private:
+    float scale;
+    double smoothedMs = -1.0;
+    unsigned int overFrames = 0;
+    unsigned int underFrames = 0;
+    unsigned int cooldownFrames = 0;
+    unsigned int changes = 0;
+
+    void apply(float newScale);
+};
+
+// 按窗口大小分配的离屏渲染目标，只使用左下角 Scale 比例的区域，改变缩放不需要重新分配
+// Upscale用线性过滤把这块区域放大复制到整个窗口
+class ScaledRenderTarget {
+public:
+    ScaledRenderTarget(int width, int height);
+    ~ScaledRenderTarget();
+    ScaledRenderTarget(const ScaledRenderTarget &) = delete;
+    ScaledRenderTarget &operator=(const ScaledRenderTarget &) = delete;
+
+    // 窗口大小改变时调用
+    void Resize(int width, int height);
+    void SetScale(float scale);
+
+    // 绑定离屏缓冲，视口设置为内部渲染分辨率
+    void Bind() const;
+    // 放大到drawFramebuffer（默认是窗口）的整个区域
+    void Upscale(unsigned int drawFramebuffer = 0) const;
+
+    int Width() const { return width; }
+    int Height() const { return height; }
+    int RenderWidth() const { return renderWidth; }
+    int RenderHeight() const { return renderHeight; }
+    float Scale() const { return scale; }
+    unsigned int Framebuffer() const { return fbo; }
+
+private:
+    int width = 0, height = 0;
+    int renderWidth = 0, renderHeight = 0;
+    float scale = 1.0f;
+    unsigned int fbo = 0, colorBuffer = 0, depthBuffer = 0;
+
+    void allocate();
+    void release();
+};
+
+// 类定义
+// =================================================================================================
+
+inline GpuTimer::GpuTimer(unsigned int latency) : queries(std::max(latency, 1u)) {
+    glGenQueries((GLsizei) queries.size(), queries.data());
+}
+
+inline GpuTimer::~GpuTimer() {
+    glDeleteQueries((GLsizei) queries.size(), queries.data());
+}
+
+inline void GpuTimer::Begin() {
+    // 环满了，最老的查询所在的位置要被重用，只能等它的结果
+    if (pending == queries.size())
+        readOldest();
+    glBeginQuery(GL_TIME_ELAPSED, queries[next]);
+}
+
+inline void GpuTimer::End() {
+    glEndQuery(GL_TIME_ELAPSED);
+    next = (next + 1) % (unsigned int) queries.size();
+    pending++;
+}
+
+inline bool GpuTimer::Poll(double &ms) {
+    while (pending > 0) {
+        unsigned int oldest = (next + (unsigned int) queries.size() - pending) % (unsigned int) queries.size();
+        GLint available = 0;
+        glGetQueryObjectiv(queries[oldest], GL_QUERY_RESULT_AVAILABLE, &available);
+        if (!available)
+            break;
+        readOldest();
+    }
+    if (!hasResult)
+        return false;
+    ms = lastMs;
+    hasResult = false;
+    return true;
+}
+
+inline void GpuTimer::readOldest() {
+    unsigned int oldest = (next + (unsigned int) queries.size() - pending) % (unsigned int) queries.size();
+    GLuint64 ns = 0;
+    // 结果还没有时 GL_QUERY_RESULT 会阻塞到GPU执行完这个查询
+    glGetQueryObjectui64v(queries[oldest], GL_QUERY_RESULT, &ns);
+    lastMs = ns * 1e-6;
+    hasResult = true;
+    pending--;
+}
+
+inline float ResolutionController::Update(double gpuMs) {
+    smoothedMs = smoothedMs < 0.0 ? gpuMs : smoothedMs + (gpuMs - smoothedMs) * Smoothing;
+    if (cooldownFrames > 0) {
+        cooldownFrames--;
+        return scale;
+    }
+
+    // 调整的目标放在迟滞区间的中间
+    double desiredMs = TargetMs * (UpperBound + LowerBound) * 0.5;
+    float predicted = scale * (float) std::sqrt(desiredMs / std::max(smoothedMs, 1e-3));
+    if (smoothedMs > TargetMs * UpperBound) {
+        underFrames = 0;
+        if (++overFrames >= DecreaseFrames && scale > MinScale)
+            // 向下取整，至少降一档
+            apply(std::min(std::floor(predicted / ScaleStep) * ScaleStep, scale - ScaleStep));
+    } else if (smoothedMs < TargetMs * LowerBound) {
+        overFrames = 0;
+        // 每次最多升两档，预测不准时也不会一下子升过头
+        if (++underFrames >= IncreaseFrames && scale < MaxScale)
+            apply(std::min(std::max(std::floor(predicted / ScaleStep) * ScaleStep, scale + ScaleStep), scale + 2.0f * ScaleStep));
+    } else {
+        overFrames = 0;
+        underFrames = 0;
+    }
+    return scale;
+}
+
+inline void ResolutionController::Reset(float initialScale) {
+    scale = std::min(std::max(initialScale, MinScale), MaxScale);
+    smoothedMs = -1.0;
+    overFrames = underFrames = cooldownFrames = changes = 0;
+}
+
+inline void ResolutionController::apply(float newScale) {
+    newScale = std::min(std::max(newScale, MinScale), MaxScale);
+    overFrames = 0;
+    underFrames = 0;
+    if (newScale == scale)
+        return;
+    // 平均值按新分辨率的像素数换算，否则冷却结束后还会参考旧分辨率的时间
+    smoothedMs *= (newScale * newScale) / (scale * scale);
+    scale = newScale;
+    cooldownFrames = Cooldown;
+    changes++;
+}
+
+inline ScaledRenderTarget::ScaledRenderTarget(int width, int height) {
+    Resize(width, height);
+}
+
+inline ScaledRenderTarget::~ScaledRenderTarget() {
+    release();
+}
+
+inline void ScaledRenderTarget::Resize(int w, int h) {
+    if (w == width && h == height && fbo != 0)
+        return;
+    width = std::max(w, 1);
+    height = std::max(h, 1);
+    release();
+    allocate();
+    SetScale(scale);
+}
+
+inline void ScaledRenderTarget::SetScale(float s) {
+    scale = std::min(std::max(s, 0.0f), 1.0f);
+    renderWidth = std::max((int) std::lround(width * scale), 1);
+    renderHeight = std::max((int) std::lround(height * scale), 1);
+}
+
+inline void ScaledRenderTarget::Bind() const {
+    glBindFramebuffer(GL_FRAMEBUFFER, fbo);
+    glViewport(0, 0, renderWidth, renderHeight);
+}
+
+inline void ScaledRenderTarget::Upscale(unsigned int drawFramebuffer) const {
+    glBindFramebuffer(GL_READ_FRAMEBUFFER, fbo);
+    glBindFramebuffer(GL_DRAW_FRAMEBUFFER, drawFramebuffer);
+    glBlitFramebuffer(0, 0, renderWidth, renderHeight, 0, 0, width, height, GL_COLOR_BUFFER_BIT,
+                      renderWidth == width && renderHeight == height ? GL_NEAREST : GL_LINEAR);
+    glBindFramebuffer(GL_FRAMEBUFFER, drawFramebuffer);
+    glViewport(0, 0, width, height);
+}
+
+inline void ScaledRenderTarget::allocate() {
+    glGenFramebuffers(1, &fbo);
+    glBindFramebuffer(GL_FRAMEBUFFER, fbo);
+
+    glGenRenderbuffers(1, &colorBuffer);
+    glBindRenderbuffer(GL_RENDERBUFFER, colorBuffer);
+    glRenderbufferStorage(GL_RENDERBUFFER, GL_RGBA8, width, height);
+    glFramebufferRenderbuffer(GL_FRAMEBUFFER, GL_COLOR_ATTACHMENT0, GL_RENDERBUFFER, colorBuffer);
+
+    glGenRenderbuffers(1, &depthBuffer);
+    glBindRenderbuffer(GL_RENDERBUFFER, depthBuffer);
+    glRenderbufferStorage(GL_RENDERBUFFER, GL_DEPTH24_STENCIL8, width, height);
+    glFramebufferRenderbuffer(GL_FRAMEBUFFER, GL_DEPTH_STENCIL_ATTACHMENT, GL_RENDERBUFFER, depthBuffer);
+
+    if (glCheckFramebufferStatus(GL_FRAMEBUFFER) != GL_FRAMEBUFFER_COMPLETE)
+        std::cout << "Framebuffer is not complete" << std::endl;
+    glBindFramebuffer(GL_FRAMEBUFFER, 0);
+}
+
+inline void ScaledRenderTarget::release() {
+    if (fbo == 0)
+        return;
+    glDeleteFramebuffers(1, &fbo);
+    glDeleteRenderbuffers(1, &colorBuffer);
+    glDeleteRenderbuffers(1, &depthBuffer);
+    fbo = colorBuffer = depthBuffer = 0;
+}
+
+#endif // LEARNOPENGL_DYNAMIC_RESOLUTION_H
@@ -0,0 +1,627 @@
+#ifndef LEARNOPENGL_FRAME_CAPTURE_H
+#define LEARNOPENGL_FRAME_CAPTURE_H
+
+#include <glad/glad.h>
+
+#include <algorithm>
+#include <atomic>
+#include <condition_variable>
+#include <cstdint>
+#include <cstdio>
+#include <cstring>
+#include <deque>
+#include <functional>
+#include <map>
+#include <mutex>
+#include <string>
+#include <thread>
+#include <vector>
+
+// 读回的一帧，RGBA8，行从下往上（和glReadPixels相同）
+struct CapturedFrame {
+    uint64_t Index;
+    int Width, Height;
+    const unsigned char *Pixels;
+};
+
+// 把RGBA8图像写成PNG，flipRows为true时把从下往上的行翻转过来
+// 默认用不压缩的deflate块保存：文件比压缩的PNG大，但编码只是顺序复制，不需要额外的依赖
+// compress为true时每行先做Sub过滤，再用LZ77加固定Huffman编码压缩，慢得多，用于要提交到仓库里的图片（金图）
+bool WritePngRgba(const char *path, int width, int height, const unsigned char *rgba, bool flipRows,
+                  bool compress = false);
+// RGBA8转成 YUV 4:2:0（I420，BT.601有限范围），输出的行从上往下
+void RgbaToI420(int width, int height, const unsigned char *rgba, std::vector<unsigned char> &yuv);
+
+// 异步帧捕获：glReadPixels写进像素打包缓冲（PBO）组成的环，立即返回，用栅栏（fence）查询GPU是否完成
+// 完成的帧交给工作线程编码（PNG序列、Y4M视频流或者回调），渲染线程只负责发起读取和检查栅栏
+//
+// 每个槽位的状态：空闲 -> 等待GPU -> 编码中 -> 空闲
+// 支持 ARB_buffer_storage 时PBO持久映射，工作线程直接读映射的内存，渲染线程不需要复制；
+// 否则渲染线程映射后复制到槽位的内存里再交给工作线程
+// 环里没有空闲槽位时：BlockWhenBusy为true就等待最老的槽位（计入Stalls），否则丢弃这一帧（计入Dropped）
+class FrameCapture {
+public:
+    typedef std::function<void(const CapturedFrame &frame)> FrameCallback;
+
+    FrameCapture(int width, int height, unsigned int ringSize = 4, unsigned int workerCount = 2);
+    ~FrameCapture();
+    FrameCapture(const FrameCapture &) = delete;
+    FrameCapture &operator=(const FrameCapture &) = delete;
+
+    bool BlockWhenBusy = true;
+
+    // 每一帧都写成PNG，pattern是printf格式，参数是帧编号，例如 "capture_%05llu.png"；空字符串关闭
+    void SetPngOutput(const std::string &pattern);
+    // 所有帧写进一个Y4M文件（YUV 4:2:0），可以直接交给 ffmpeg -i 编码；空字符串关闭，关闭前会等待已捕获的帧写完
+    bool SetY4mOutput(const std::string &path, int fps = 60);
+    // 在工作线程中调用，frame.Pixels只在回调期间有效
+    void SetCallback(FrameCallback callback);
+
+    // 窗口大小改变时调用，会先等待所有捕获完成
+    void Resize(int width, int height);
+    // 从framebuffer（默认是窗口）读取左下角 Width x Height 的区域，不等待GPU
+    bool Capture(unsigned int framebuffer = 0);
+    // 检查GPU已经完成的读取并交给工作线程，每帧调用一次
+    void Poll();
+    // 等待所有读取和编码完成
+    void Flush();
+
+    int Width() const { return width; }
+    int Height() const { return height; }
+    bool PersistentMapping() const { return persistent; }
+    uint64_t Captured() const { return nextIndex; }
+    uint64_t Encoded() const { return encoded; }
+    uint64_t Dropped() const { return dropped; }
+    uint64_t Stalls() const { return stalls; }
+
+private:
+    enum SlotState {
+        SLOT_FREE,
+        SLOT_READBACK,
+        SLOT_ENCODING
+    };
+    struct Slot {
+        unsigned int Buffer = 0;
+        GLsync Fence = nullptr;
+        unsigned char *Mapped = nullptr;    // 持久映射的地址
+        std::vector<unsigned char> Copy;    // 没有持久映射时复制到这里
+        uint64_t Index = 0;
+        std::atomic<int> State{SLOT_FREE};
+    };
+
+    int width, height;
+    bool persistent;
+    std::vector<Slot> slots;
+    unsigned int nextSlot = 0;
+    uint64_t nextIndex = 0;
+    uint64_t dropped = 0;
+    uint64_t stalls = 0;
+    std::atomic<uint64_t> encoded{0};
+
+    // 工作线程
+    std::vector<std::thread> workers;
+    std::mutex jobMutex;
+    std::condition_variable jobReady;
+    std::condition_variable slotFreed;
+    std::deque<Slot *> jobs;
+    bool quit = false;
+
+    // 输出设置，由 jobMutex 保护
+    std::string pngPattern;
+    FrameCallback callback;
+
+    // Y4M按帧编号顺序写入，工作线程先转换颜色，再排队写入
+    std::mutex y4mMutex;
+    FILE *y4mFile = nullptr;
+    uint64_t y4mNext = 0;
+    std::map<uint64_t, std::vector<unsigned char>> y4mPending;
+
+    void allocate();
+    void release();
+    // 等待slot的GPU读取完成并交给工作线程
+    void submit(Slot &slot, bool wait);
+    void waitForSlot(Slot &slot);
+    void workerLoop();
+    void encode(Slot &slot);
+};
+
+// 类定义
+// =================================================================================================
+
+namespace frame_capture_detail {
+    // deflate的比特流从每个字节的低位开始写；Huffman码要从高位开始写，所以先反转
+    struct BitWriter {
+        std::vector<unsigned char> &Out;
+        uint32_t Buffer = 0;
+        int Count = 0;
+
+        explicit BitWriter(std::vector<unsigned char> &out) : Out(out) {}
+        void Put(uint32_t bits, int n) {
+            Buffer |= bits << Count;
+            Count += n;
+            while (Count >= 8) {
+                Out.push_back((unsigned char) Buffer);
+                Buffer >>= 8;
+                Count -= 8;
+            }
+        }
+        void PutCode(uint32_t code, int n) {
+            uint32_t reversed = 0;
+            for (int i = 0; i < n; i++)
+                reversed |= ((code >> i) & 1u) << (n - 1 - i);
+            Put(reversed, n);
+        }
+        void Flush() {
+            if (Count > 0)
+                Out.push_back((unsigned char) Buffer);
+            Buffer = 0;
+            Count = 0;
+        }
+    };
+
+    // 固定Huffman表中字面量/长度符号的编码（RFC 1951 3.2.6）
+    inline void putSymbol(BitWriter &w, int symbol) {
+        if (symbol < 144)
+            w.PutCode(0x30 + symbol, 8);
+        else if (symbol < 256)
+            w.PutCode(0x190 + symbol - 144, 9);
+        else if (symbol < 280)
+            w.PutCode(symbol - 256, 7);
+        else
+            w.PutCode(0xC0 + symbol - 280, 8);
+    }
+
+    // 一个固定Huffman块：哈希链找32KB窗口内最长的匹配，每个位置最多比较 MAX_CHAIN 个候选
+    inline void deflateFixed(const std::vector<unsigned char> &in, std::vector<unsigned char> &out) {
+        static const int lengthBase[29] = {3, 4, 5, 6, 7, 8, 9, 10, 11, 13, 15, 17, 19, 23, 27, 31, 35, 43, 51, 59,
+                                           67, 83, 99, 115, 131, 163, 195, 227, 258};
+        static const int lengthExtra[29] = {0, 0, 0, 0, 0, 0, 0, 0, 1, 1, 1, 1, 2, 2, 2, 2, 3, 3, 3, 3,
+                                            4, 4, 4, 4, 5, 5, 5, 5, 0};
+        static const int distanceBase[30] = {1, 2, 3, 4, 5, 7, 9, 13, 17, 25, 33, 49, 65, 97, 129, 193, 257, 385,
+                                             513, 769, 1025, 1537, 2049, 3073, 4097, 6145, 8193, 12289, 16385, 24577};
+        static const int distanceExtra[30] = {0, 0, 0, 0, 1, 1, 2, 2, 3, 3, 4, 4, 5, 5, 6, 6, 7, 7, 8, 8,
+                                              9, 9, 10, 10, 11, 11, 12, 12, 13, 13};
+        const size_t WINDOW = 32768;
+        const int HASH_BITS = 15, MAX_CHAIN = 16, MAX_MATCH = 258;
+
+        const size_t n = in.size();
+        std::vector<int64_t> head((size_t) 1 << HASH_BITS, -1), prev(WINDOW, -1);
+        auto hash = [&](size_t p) {
+            return ((in[p] << 10) ^ (in[p + 1] << 5) ^ in[p + 2]) & ((1 << HASH_BITS) - 1);
+        };
+        auto insert = [&](size_t p) {
+            if (p + 2 >= n)
+                return;
+            int h = hash(p);
+            prev[p & (WINDOW - 1)] = head[h];
+            head[h] = (int64_t) p;
+        };
+
+        BitWriter w(out);
+        w.Put(1, 1);    // 最后一个块
+        w.Put(1, 2);    // 固定Huffman
+        size_t i = 0;
+        while (i < n) {
+            int bestLength = 0;
+            size_t bestDistance = 0;
+            if (i + 2 < n) {
+                int maxLength = (int) std::min(n - i, (size_t) MAX_MATCH);
+                int64_t candidate = head[hash(i)];
+                // 只看窗口内的候选：更早的位置在prev环里的槽位可能已经被新的位置覆盖
+                for (int chain = 0; candidate >= 0 && i - (size_t) candidate <= WINDOW && chain < MAX_CHAIN; chain++) {
+                    const unsigned char *a = &in[(size_t) candidate], *b = &in[i];
+                    int length = 0;
+                    while (length < maxLength && a[length] == b[length])
+                        length++;
+                    if (length > bestLength) {
+                        bestLength = length;
+                        bestDistance = i - (size_t) candidate;
+                        if (length == maxLength)
+                            break;
+                    }
+                    candidate = prev[(size_t) candidate & (WINDOW - 1)];
+                }
+            }
+            if (bestLength >= 3) {
+                int l = 28;
+                while (lengthBase[l] > bestLength)
+                    l--;
+                putSymbol(w, 257 + l);
+                w.Put((uint32_t) (bestLength - lengthBase[l]), lengthExtra[l]);
+                int d = 29;
+                while ((size_t) distanceBase[d] > bestDistance)
+                    d--;
+                w.PutCode((uint32_t) d, 5);
+                w.Put((uint32_t) (bestDistance - distanceBase[d]), distanceExtra[d]);
+                for (int k = 0; k < bestLength; k++)
+                    insert(i + k);
+                i += bestLength;
+            } else {
+                putSymbol(w, in[i]);
+                insert(i);
+                i++;
+            }
+        }
+        putSymbol(w, 256);  // 块结束
+        w.Flush();
+    }
+}
+
+inline bool WritePngRgba(const char *path, int width, int height, const unsigned char *rgba, bool flipRows,
+                         bool compress) {
+    // 局部静态变量的初始化是线程安全的，多个工作线程可以同时写PNG
+    static const std::vector<uint32_t> crcTable = [] {
+        std::vector<uint32_t> table(256);
+        for (uint32_t n = 0; n < 256; n++) {
+            uint32_t c = n;
+            for (int k = 0; k < 8; k++)
+                c = c & 1 ? 0xEDB88320u ^ (c >> 1) : c >> 1;
+            table[n] = c;
+        }
+        return table;
+    }();
+
+    FILE *file = std::fopen(path, "wb");
+    if (!file)
+        return false;
+
+    auto put32 = [](std::vector<unsigned char> &out, uint32_t v) {
+        out.push_back((unsigned char) (v >> 24));
+        out.push_back((unsigned char) (v >> 16));
+        out.push_back((unsigned char) (v >> 8));
+        out.push_back((unsigned char) v);
+    };
+    auto writeChunk = [&](const char *type, const std::vector<unsigned char> &data) {
+        std::vector<unsigned char> chunk;
+        put32(chunk, (uint32_t) data.size());
+        chunk.insert(chunk.end(), type, type + 4);
+        chunk.insert(chunk.end(), data.begin(), data.end());
+        uint32_t crc = 0xFFFFFFFFu;
+        for (size_t i = 4; i < chunk.size(); i++)
+            crc = crcTable[(crc ^ chunk[i]) & 0xFF] ^ (crc >> 8);
+        put32(chunk, crc ^ 0xFFFFFFFFu);
+        std::fwrite(chunk.data(), 1, chunk.size(), file);
+    };
+
+    static const unsigned char signature[8] = {0x89, 'P', 'N', 'G', '\r', '\n', 0x1A, '\n'};
+    std::fwrite(signature, 1, 8, file);
+
+    std::vector<unsigned char> header;
+    put32(header, (uint32_t) width);
+    put32(header, (uint32_t) height);
+    header.push_back(8);    // 每个通道8位
+    header.push_back(6);    // RGBA
+    header.push_back(0);
+    header.push_back(0);
+    header.push_back(0);
+    writeChunk("IHDR", header);
+
+    // 每行前面加一个过滤类型字节：不压缩时为0（不过滤），压缩时为1（Sub，存和左边像素的差）
+    size_t rowBytes = (size_t) width * 4;
+    std::vector<unsigned char> raw;
+    raw.reserve((rowBytes + 1) * height);
+    for (int y = 0; y < height; y++) {
+        const unsigned char *row = rgba + (flipRows ? (size_t) (height - 1 - y) : (size_t) y) * rowBytes;
+        if (!compress) {
+            raw.push_back(0);
+            raw.insert(raw.end(), row, row + rowBytes);
+            continue;
+        }
+        raw.push_back(1);
+        for (size_t x = 0; x < rowBytes; x++)
+            raw.push_back((unsigned char) (row[x] - (x >= 4 ? row[x - 4] : 0)));
+    }
+
+    // zlib：2字节头，deflate数据，最后是Adler-32校验
+    // 不压缩时数据是若干个不压缩的deflate块（每块最多65535字节）
+    std::vector<unsigned char> zlib;
+    zlib.reserve(raw.size() + raw.size() / 65535 * 5 + 16);
+    zlib.push_back(0x78);
+    zlib.push_back(0x01);
+    if (compress) {
+        frame_capture_detail::deflateFixed(raw, zlib);
+    } else {
+        size_t offset = 0;
+        do {
+            size_t length = std::min(raw.size() - offset, (size_t) 65535);
+            bool last = offset + length == raw.size();
+            zlib.push_back(last ? 1 : 0);
+            zlib.push_back((unsigned char) length);
+            zlib.push_back((unsigned char) (length >> 8));
+            zlib.push_back((unsigned char) ~length);
+            zlib.push_back((unsigned char) (~length >> 8));
+            zlib.insert(zlib.end(), raw.begin() + offset, raw.begin() + offset + length);
+            offset += length;
+        } while (offset < raw.size());
+    }
+    uint32_t a = 1, b = 0;
+    for (size_t i = 0; i < raw.size(); i++) {
+        a = (a + raw[i]) % 65521;
+        b = (b + a) % 65521;
+    }
+    put32(zlib, (b << 16) | a);
+    writeChunk("IDAT", zlib);
+    writeChunk("IEND", std::vector<unsigned char>());
+
+    bool ok = std::ferror(file) == 0;
+    std::fclose(file);
+    return ok;
+}
+
+inline void RgbaToI420(int width, int height, const unsigned char *rgba, std::vector<unsigned char> &yuv) {
+    int chromaWidth = (width + 1) / 2, chromaHeight = (height + 1) / 2;
+    yuv.resize((size_t) width * height + 2 * (size_t) chromaWidth * chromaHeight);
+    unsigned char *yPlane = yuv.data();
+    unsigned char *uPlane = yPlane + (size_t) width * height;
+    unsigned char *vPlane = uPlane + (size_t) chromaWidth * chromaHeight;
+
+    // 输入的行从下往上，输出翻转成从上往下
+    auto pixel = [&](int x, int y) { return rgba + ((size_t) (height - 1 - y) * width + x) * 4; };
+    for (int y = 0; y < height; y++) {
+        for (int x = 0; x < width; x++) {
+            const unsigned char *p = pixel(x, y);
+            yPlane[(size_t) y * width + x] = (unsigned char) (((66 * p[0] + 129 * p[1] + 25 * p[2] + 128) >> 8) + 16);
+        }
+    }
+    // 色度取2x2像素的平均值
+    for (int cy = 0; cy < chromaHeight; cy++) {
+        for (int cx = 0; cx < chromaWidth; cx++) {
+            int r = 0, g = 0, b = 0, n = 0;
+            for (int dy = 0; dy < 2; dy++) {
+                for (int dx = 0; dx < 2; dx++) {
+                    int x = cx * 2 + dx, y = cy * 2 + dy;
+                    if (x >= width || y >= height)
+                        continue;
+                    const unsigned char *p = pixel(x, y);
+                    r += p[0];
+                    g += p[1];
+                    b += p[2];
+                    n++;
+                }
+            }
+            r /= n;
+            g /= n;
+            b /= n;
+            uPlane[(size_t) cy * chromaWidth + cx] = (unsigned char) (((-38 * r - 74 * g + 112 * b + 128) >> 8) + 128);
+            vPlane[(size_t) cy * chromaWidth + cx] = (unsigned char) (((112 * r - 94 * g - 18 * b + 128) >> 8) + 128);
+        }
+    }
+}
+
+inline FrameCapture::FrameCapture(int width, int height, unsigned int ringSize, unsigned int workerCount)
+        : width(width), height(height), persistent(GLAD_GL_VERSION_4_4 || GLAD_GL_ARB_buffer_storage),
+          slots(std::max(ringSize, 2u)) {
+    allocate();
+    for (unsigned int i = 0; i < std::max(workerCount, 1u); i++)
+        workers.emplace_back(&FrameCapture::workerLoop, this);
+}
+
+inline FrameCapture::~FrameCapture() {
+    Flush();
+    {
+        std::lock_guard<std::mutex> lock(jobMutex);
+        quit = true;
+    }
+    jobReady.notify_all();
+    for (std::thread &worker : workers)
+        worker.join();
+    SetY4mOutput("");
+    release();
+}
+
+inline void FrameCapture::SetPngOutput(const std::string &pattern) {
+    std::lock_guard<std::mutex> lock(jobMutex);
+    pngPattern = pattern;
+}
+
+inline bool FrameCapture::SetY4mOutput(const std::string &path, int fps) {
+    Flush();
+    std::lock_guard<std::mutex> lock(y4mMutex);
+    if (y4mFile) {
+        std::fclose(y4mFile);
+        y4mFile = nullptr;
+    }
+    y4mPending.clear();
+    if (path.empty())
+        return true;
+    y4mFile = std::fopen(path.c_str(), "wb");
+    if (!y4mFile)
+        return false;
+    std::fprintf(y4mFile, "YUV4MPEG2 W%d H%d F%d:1 Ip A1:1 C420jpeg\n", width, height, fps);
+    // 从下一个捕获的帧开始写
+    y4mNext = nextIndex;
+    return true;
+}
+
+inline void FrameCapture::SetCallback(FrameCallback frameCallback) {
+    std::lock_guard<std::mutex> lock(jobMutex);
+    callback = frameCallback;
+}
+
+inline void FrameCapture::Resize(int w, int h) {
+    if (w == width && h == height)
+        return;
+    Flush();
+    release();
+    width = w;
+    height = h;
+    allocate();
+}
+
+inline bool FrameCapture::Capture(unsigned int framebuffer) {
+    Slot &slot = slots[nextSlot];
+    if (slot.State != SLOT_FREE) {
+        if (!BlockWhenBusy) {
+            dropped++;
+            return false;
+        }
+        stalls++;
+        waitForSlot(slot);
+    }
+
+    slot.Index = nextIndex++;
+    glBindFramebuffer(GL_READ_FRAMEBUFFER, framebuffer);
+    glBindBuffer(GL_PIXEL_PACK_BUFFER, slot.Buffer);
+    glPixelStorei(GL_PACK_ALIGNMENT, 1);
+    glReadPixels(0, 0, width, height, GL_RGBA, GL_UNSIGNED_BYTE, nullptr);
+    glBindBuffer(GL_PIXEL_PACK_BUFFER, 0);
+    slot.Fence = glFenceSync(GL_SYNC_GPU_COMMANDS_COMPLETE, 0);
+    // 确保栅栏被提交，否则Poll里不带等待的查询可能永远得不到结果
+    glFlush();
+    slot.State = SLOT_READBACK;
+    nextSlot = (nextSlot + 1) % (unsigned int) slots.size();
+    return true;
+}
+
+inline void FrameCapture::Poll() {
+    // 按捕获的顺序检查，前面的没完成时后面的通常也没完成
+    for (unsigned int i = 0; i < slots.size(); i++) {
+        Slot &slot = slots[(nextSlot + i) % slots.size()];
+        if (slot.State == SLOT_READBACK)
+            submit(slot, false);
+    }
+}
+
+inline void FrameCapture::Flush() {
+    for (Slot &slot : slots)
+        if (slot.State == SLOT_READBACK)
+            submit(slot, true);
+    std::unique_lock<std::mutex> lock(jobMutex);
+    slotFreed.wait(lock, [this] {
+        for (const Slot &slot : slots)
+            if (slot.State != SLOT_FREE)
+                return false;
+        return true;
+    });
+}
+
+inline void FrameCapture::allocate() {
+    size_t size = (size_t) width * height * 4;
+    for (Slot &slot : slots) {
+        glGenBuffers(1, &slot.Buffer);
+        glBindBuffer(GL_PIXEL_PACK_BUFFER, slot.Buffer);
+        if (persistent) {
+            // 持久映射 + 一致性：工作线程读映射的内存时不需要渲染线程做任何GL调用，栅栏完成后数据就是可见的
+            GLbitfield flags = GL_MAP_READ_BIT | GL_MAP_PERSISTENT_BIT | GL_MAP_COHERENT_BIT;
+            glBufferStorage(GL_PIXEL_PACK_BUFFER, size, nullptr, flags);
+            slot.Mapped = (unsigned char *) glMapBufferRange(GL_PIXEL_PACK_BUFFER, 0, size, flags);
+        } else {
+            glBufferData(GL_PIXEL_PACK_BUFFER, size, nullptr, GL_STREAM_READ);
+            slot.Copy.resize(size);
+        }
+        slot.State = SLOT_FREE;
+    }
+    glBindBuffer(GL_PIXEL_PACK_BUFFER, 0);
+}
+
+inline void FrameCapture::release() {
+    for (Slot &slot : slots) {
+        if (slot.Fence) {
+            glDeleteSync(slot.Fence);
+            slot.Fence = nullptr;
+        }
+        if (slot.Mapped) {
+            glBindBuffer(GL_PIXEL_PACK_BUFFER, slot.Buffer);
+            glUnmapBuffer(GL_PIXEL_PACK_BUFFER);
+            slot.Mapped = nullptr;
+        }
+        glDeleteBuffers(1, &slot.Buffer);
+        slot.Buffer = 0;
+        std::vector<unsigned char>().swap(slot.Copy);
+    }
+    glBindBuffer(GL_PIXEL_PACK_BUFFER, 0);
+}
+
+inline void FrameCapture::submit(Slot &slot, bool wait) {
+    GLenum result = glClientWaitSync(slot.Fence, wait ? GL_SYNC_FLUSH_COMMANDS_BIT : 0, wait ? GL_TIMEOUT_IGNORED : 0);
+    if (result != GL_ALREADY_SIGNALED && result != GL_CONDITION_SATISFIED)
+        return;
+    glDeleteSync(slot.Fence);
+    slot.Fence = nullptr;
+
+    if (!persistent) {
+        glBindBuffer(GL_PIXEL_PACK_BUFFER, slot.Buffer);
+        void *data = glMapBufferRange(GL_PIXEL_PACK_BUFFER, 0, slot.Copy.size(), GL_MAP_READ_BIT);
+        if (data) {
+            std::memcpy(slot.Copy.data(), data, slot.Copy.size());
+            glUnmapBuffer(GL_PIXEL_PACK_BUFFER);
+        }
+        glBindBuffer(GL_PIXEL_PACK_BUFFER, 0);
+    }
+
+    {
+        std::lock_guard<std::mutex> lock(jobMutex);
+        slot.State = SLOT_ENCODING;
+        jobs.push_back(&slot);
+    }
+    jobReady.notify_one();
+}
+
+inline void FrameCapture::waitForSlot(Slot &slot) {
+    if (slot.State == SLOT_READBACK)
+        submit(slot, true);
+    std::unique_lock<std::mutex> lock(jobMutex);
+    slotFreed.wait(lock, [&slot] { return slot.State == SLOT_FREE; });
+}
+
+inline void FrameCapture::workerLoop() {
+    while (true) {
+        Slot *slot;
+        {
+            std::unique_lock<std::mutex> lock(jobMutex);
+            jobReady.wait(lock, [this] { return quit || !jobs.empty(); });
+            if (jobs.empty())
+                return;
+            slot = jobs.front();
+            jobs.pop_front();
+        }
+        encode(*slot);
+        {
+            std::lock_guard<std::mutex> lock(jobMutex);
+            slot->State = SLOT_FREE;
+        }
+        encoded++;
+        slotFreed.notify_all();
+    }
+}
+
+inline void FrameCapture::encode(Slot &slot) {
+    CapturedFrame frame = {slot.Index, width, height, persistent ? slot.Mapped : slot.Copy.data()};
+    std::string pattern;
+    FrameCallback frameCallback;
+    {
+        std::lock_guard<std::mutex> lock(jobMutex);
+        pattern = pngPattern;
+        frameCallback = callback;
+    }
+
+    if (!pattern.empty()) {
+        char path[512];
+        std::snprintf(path, sizeof(path), pattern.c_str(), (unsigned long long) frame.Index);
+        WritePngRgba(path, frame.Width, frame.Height, frame.Pixels, true);
+    }
+    if (frameCallback)
+        frameCallback(frame);
+
+    bool y4m;
+    {
+        std::lock_guard<std::mutex> lock(y4mMutex);
+        y4m = y4mFile != nullptr && frame.Index >= y4mNext;
+    }
+    if (y4m) {
+        // 颜色转换在各个工作线程里并行做，写文件时按帧编号排队
+        std::vector<unsigned char> yuv;
+        RgbaToI420(frame.Width, frame.Height, frame.Pixels, yuv);
+        std::lock_guard<std::mutex> lock(y4mMutex);
+        if (y4mFile) {
+            y4mPending[frame.Index].swap(yuv);
+            for (auto it = y4mPending.begin(); it != y4mPending.end() && it->first == y4mNext; it = y4mPending.erase(it)) {
+                std::fputs("FRAME\n", y4mFile);
+                std::fwrite(it->second.data(), 1, it->second.size(), y4mFile);
+                y4mNext++;
+            }
+        }
+    }
+}
+
+#endif // LEARNOPENGL_FRAME_CAPTURE_H
@@ -0,0 +1,169 @@
+#ifndef LEARNOPENGL_FRAME_LOOP_H
+#define LEARNOPENGL_FRAME_LOOP_H
+
+#include <atomic>
+#include <chrono>
+#include <cstdint>
+#include <cmath>
+#include <functional>
+#include <mutex>
+#include <thread>
+#include <algorithm>
+
+// 固定步长的模拟：每帧把真实经过的时间加进累加器，按固定的Step取出整数个模拟步，
+// 剩下不足一步的时间用Alpha表示，渲染时在上一步和这一步的状态之间插值
+// 模拟结果只取决于步数和每一步的输入，和帧率、帧时间的抖动无关
+// 一帧最多执行MaxSteps步，卡顿时多出来的时间直接丢弃，模拟的开销有上限，不会越卡越慢
+class FixedTimestep {
+public:
+    explicit FixedTimestep(double step = 1.0 / 60.0, unsigned int maxSteps = 8) : step(step), maxSteps(maxSteps) {}
+
+    // 传入这一帧真实经过的时间（秒），返回这一帧要执行的模拟步数
+    unsigned int Advance(double frameTime);
+    void Reset();
+
+    double Step() const { return step; }
+    unsigned int MaxSteps() const { return maxSteps; }
+    // 累加器中剩余的时间占一步的比例，[0, 1)
+    float Alpha() const { return (float) (accumulator / step); }
+    double Accumulator() const { return accumulator; }
+    uint64_t Ticks() const { return ticks; }
+    // 因为超过MaxSteps而丢弃的时间（秒）
+    double DroppedTime() const { return dropped; }
+
+private:
+    double step;
+    unsigned int maxSteps;
+    double accumulator = 0.0;
+    double dropped = 0.0;
+    uint64_t ticks = 0;
+};
+
+// 在单独的线程中按固定步长运行模拟，渲染线程随时可以取最近两步的状态和插值系数
+// 状态双缓冲：模拟线程只修改自己的工作副本，每一步结束后在锁内复制到发布的 上一步/这一步，
+// 渲染线程在锁内复制出来，锁只覆盖两次复制，不会等待模拟
+template<typename State>
+class SimulationThread {
+public:
+    // simulate(state, tick, step)：把state从第tick步推进到第tick + 1步
+    typedef std::function<void(State &state, uint64_t tick, double step)> SimulateFunction;
+
+    explicit SimulationThread(double step = 1.0 / 60.0, unsigned int maxSteps = 8) : timestep(step, maxSteps) {}
+    ~SimulationThread() { Stop(); }
+    SimulationThread(const SimulationThread &) = delete;
+    SimulationThread &operator=(const SimulationThread &) = delete;
+
+    void Start(const State &initial, SimulateFunction simulate);
+    void Stop();
+    bool Running() const { return running; }
+
+    // previous、current是最近两步的状态，alpha是按当前时间在两者之间插值的系数，返回current对应的步数
+    // 渲染的画面比模拟晚一步，换来的是插值只用已经算好的状态
+    uint64_t Latest(State &previous, State &current, float &alpha) const;
+    uint64_t Ticks() const { return publishedTick; }
+    double DroppedTime() const;
+
+private:
+    typedef std::chrono::steady_clock Clock;
+
+    FixedTimestep timestep;
+    SimulateFunction simulateFunction;
+    std::thread thread;
+    std::atomic<bool> running{false};
+
+    mutable std::mutex mutex;
+    State published[2];
+    Clock::time_point publishedTime;    // current对应的时刻
+    std::atomic<uint64_t> publishedTick{0};
+    double droppedTime = 0.0;
+
+    void run(State state);
+};
+
+// 类定义
+// =================================================================================================
+
+inline unsigned int FixedTimestep::Advance(double frameTime) {
+    accumulator += std::max(frameTime, 0.0);
+    unsigned int steps = (unsigned int) std::min(accumulator / step, (double) maxSteps);
+    accumulator -= steps * step;
+    // 还剩一步以上说明到了上限，多出来的时间丢掉，只保留不足一步的部分
+    if (accumulator >= step) {
+        double keep = accumulator - std::floor(accumulator / step) * step;
+        dropped += accumulator - keep;
+        accumulator = keep;
+    }
+    ticks += steps;
+    return steps;
+}
+
+inline void FixedTimestep::Reset() {
+    accumulator = 0.0;
+    dropped = 0.0;
+    ticks = 0;
+}
+
+template<typename State>
+void SimulationThread<State>::Start(const State &initial, SimulateFunction simulate) {
+    Stop();
+    simulateFunction = simulate;
+    timestep.Reset();
+    published[0] = initial;
+    published[1] = initial;
+    publishedTime = Clock::now();
+    publishedTick = 0;
+    droppedTime = 0.0;
+    running = true;
+    thread = std::thread(&SimulationThread::run, this, initial);
+}
+
+template<typename State>
+void SimulationThread<State>::Stop() {
+    running = false;
+    if (thread.joinable())
+        thread.join();
+}
+
+template<typename State>
+uint64_t SimulationThread<State>::Latest(State &previous, State &current, float &alpha) const {
+    std::lock_guard<std::mutex> lock(mutex);
+    previous = published[0];
+    current = published[1];
+    double elapsed = std::chrono::duration<double>(Clock::now() - publishedTime).count();
+    alpha = (float) std::min(std::max(elapsed / timestep.Step(), 0.0), 1.0);
+    return publishedTick;
+}
+
+template<typename State>
+double SimulationThread<State>::DroppedTime() const {
+    std::lock_guard<std::mutex> lock(mutex);
+    return droppedTime;
+}
+
+template<typename State>
+void SimulationThread<State>::run(State state) {
+    State previous = state;
+    Clock::time_point last = Clock::now();
+    while (running) {
+        Clock::time_point now = Clock::now();
+        unsigned int steps = timestep.Advance(std::chrono::duration<double>(now - last).count());
+        last = now;
+        for (unsigned int i = 0; i < steps; i++) {
+            previous = state;
+            simulateFunction(state, timestep.Ticks() - steps + i, timestep.Step());
+        }
+        if (steps > 0) {
+            std::lock_guard<std::mutex> lock(mutex);
+            published[0] = previous;
+            published[1] = state;
+            // 累加器里剩下的时间已经过去了，current对应的时刻要往前推
+            publishedTime = now - std::chrono::duration_cast<Clock::duration>(std::chrono::duration<double>(timestep.Accumulator()));
+            publishedTick = timestep.Ticks();
+            droppedTime = timestep.DroppedTime();
+        }
+        // 睡到下一步的时间
+        std::this_thread::sleep_for(std::chrono::duration<double>(timestep.Step() - timestep.Accumulator()));
+    }
+}
+
+#endif // LEARNOPENGL_FRAME_LOOP_H
@@ -0,0 +1,508 @@
+#ifndef LEARNOPENGL_FRAME_STATS_H
+#define LEARNOPENGL_FRAME_STATS_H
+
+#include <glad/glad.h>
+
+#include <glm/glm.hpp>
+
+#include <cstddef>
+#include <string>
+#include <vector>
+#include <deque>
+#include <chrono>
+#include <fstream>
+#include <sstream>
+#include <iomanip>
+#include <algorithm>
+
+#include "shader.h"
+
+// 一个 pass 的统计：CPU端记录的调用次数，GPU端的计时和管线统计
+struct PassStats {
+    std::string Name;
+    double GpuMs = 0.0;
+    unsigned int Draws = 0;                 // CountDraw 记录的绘制调用
+    unsigned int Calls = 0;                 // CountCalls 记录的其他GL调用（绑定、上传uniform等）
+    // GL_ARB_pipeline_statistics_query（GL 4.6 核心），不支持时都是0
+    GLuint64 Vertices = 0;                  // 提交的顶点
+    GLuint64 Primitives = 0;                // 提交的图元
+    GLuint64 VertexInvocations = 0;         // 顶点着色器的执行次数（有顶点缓存时比提交的顶点少）
+    GLuint64 ClippedPrimitives = 0;         // 裁剪后剩下的图元
+    GLuint64 FragmentInvocations = 0;       // 片段着色器的执行次数（是否包含被早期深度测试剔除的片段由实现决定）
+};
+
+struct FrameStatsResult {
+    unsigned long long Frame = 0;           // 帧号，从1开始
+    double CpuMs = 0.0;                     // BeginFrame 到 EndFrame 的CPU时间
+    std::vector<PassStats> Passes;
+
+    double GpuMs() const;
+};
+
+// 按 pass 收集每帧的统计，不会让CPU等GPU：
+// 每帧的查询放在 Latency + 1 个槽中轮流使用，第N帧开始时读取第 N - Latency 帧的结果，
+// 那时还没有完成的就丢掉（Dropped() 加一），不会用 GL_QUERY_RESULT 等待
+// 同一种查询不能嵌套，pass 只能依次 BeginPass / EndPass
+// 可以把每一帧的结果按CSV格式写到文件中
+class FrameStats {
+public:
+    static const unsigned int Latency = 2;
+
+    FrameStats();
+    ~FrameStats();
+    FrameStats(const FrameStats &) = delete;
+    FrameStats &operator=(const FrameStats &) = delete;
+
+    bool PipelineStatistics() const { return pipelineStatistics; }
+
+    void BeginFrame();
+    void EndFrame();
+    void BeginPass(const std::string &name);
+    void EndPass();
+    // 记在当前 pass 上，pass 之外的调用不记录
+    void CountDraw(unsigned int count = 1);
+    void CountCalls(unsigned int count = 1);
+
+    // 最近读到的一帧（第 N - Latency 帧），HasResult() 为false时是空的
+    bool HasResult() const { return latest.Frame != 0; }
+    const FrameStatsResult &Latest() const { return latest; }
+    unsigned long long Frame() const { return frame; }
+    unsigned int Dropped() const { return dropped; }
+
+    // 之后读到的每一帧都追加到文件中，每个 pass 一行
+    bool OpenLog(const std::string &path);
+    void CloseLog();
+
+private:
+    static const int QUERY_COUNT = 6;       // 计时 + 5种管线统计
+
+    struct PassQueries {
+        std::string Name;
+        unsigned int Queries[QUERY_COUNT] = {};
+        unsigned int Draws = 0, Calls = 0;
+    };
+    struct Slot {
+        unsigned long long Frame = 0;
+        double CpuMs = 0.0;
+        std::vector<PassQueries> Passes;
+        size_t UsedPasses = 0;
+        bool Pending = false;
+    };
+
+    bool pipelineStatistics;
+    int queryCount;
+    Slot slots[Latency + 1];
+    unsigned long long frame = 0;
+    int currentPass = -1;
+    unsigned int dropped = 0;
+    std::chrono::high_resolution_clock::time_point frameStart;
+    FrameStatsResult latest;
+    std::ofstream log;
+
+    Slot &slotFor(unsigned long long n) { return slots[n % (Latency + 1)]; }
+    bool resolve(Slot &slot);
+    static GLenum target(int query);
+};
+
+// 统计信息的叠加显示：文字和图表都是带纹理的矩形，攒在一个顶点缓冲里，Draw 时一次绘制
+// 字体是内置的 3x5 点阵（数字、大写字母和常用符号，小写字母按大写显示），放大 Scale 倍
+// 坐标以像素为单位，原点在左上角
+class StatsOverlay {
+public:
+    int Scale = 2;
+
+    StatsOverlay(const char *vertexPath, const char *fragmentPath);
+    ~StatsOverlay();
+    StatsOverlay(const StatsOverlay &) = delete;
+    StatsOverlay &operator=(const StatsOverlay &) = delete;
+
+    // 返回下一个字符的x坐标
+    float Text(float x, float y, const std::string &text, const glm::vec4 &color = glm::vec4(1.0f));
+    void Rect(float x, float y, float width, float height, const glm::vec4 &color);
+    // 柱状图，values 从左到右，maxValue 对应 height
+    void Graph(float x, float y, float width, float height, const std::deque<float> &values, float maxValue, const glm::vec4 &color);
+    float LineHeight() const { return 7.0f * Scale; }
+
+    // 常用的布局：每个 pass 一行（GPU时间、绘制调用、其他GL调用、顶点、图元、片段、每像素片段数），下面是GPU时间的历史
+    void AddFrameStats(const FrameStatsResult &result, int screenWidth, int screenHeight, float x = 8.0f, float y = 8.0f);
+
+    // 一次绘制画出所有攒下的矩形并清空，返回顶点数；stats 不为空时记一次绘制调用
+    // 会关闭深度测试、打开 alpha 混合，结束后恢复深度测试
+    size_t Draw(int screenWidth, int screenHeight, FrameStats *stats = nullptr);
+
+private:
+    struct Vertex {
+        float X, Y, U, V;
+        unsigned char Color[4];
+    };
+    static const int CELL_WIDTH = 4, CELL_HEIGHT = 6;   // 纹理中每个字符占的格子（3x5 加1像素的间隔）
+    static const int FIRST_CHAR = 32, CHAR_COUNT = 96;  // 最后一个格子（127）是实心的，用来画矩形
+
+    Shader shader;
+    unsigned int VAO = 0, VBO = 0, font = 0;
+    size_t capacity = 0;
+    std::vector<Vertex> vertices;
+    std::deque<float> history;
+
+    void quad(float x, float y, float width, float height, int cell, const glm::vec4 &color);
+    static const char *glyph(char c);
+};
+
+// 类定义
+// =================================================================================================
+
+inline double FrameStatsResult::GpuMs() const {
+    double ms = 0.0;
+    for (const PassStats &pass : Passes)
+        ms += pass.GpuMs;
+    return ms;
+}
+
+inline FrameStats::FrameStats() {
+    pipelineStatistics = GLAD_GL_VERSION_4_6 || GLAD_GL_ARB_pipeline_statistics_query;
+    queryCount = pipelineStatistics ? QUERY_COUNT : 1;
+}
+
+inline FrameStats::~FrameStats() {
+    for (Slot &slot : slots)
+        for (PassQueries &pass : slot.Passes)
+            glDeleteQueries(QUERY_COUNT, pass.Queries);
+}
+
+inline GLenum FrameStats::target(int query) {
+    const GLenum targets[QUERY_COUNT] = {GL_TIME_ELAPSED, GL_VERTICES_SUBMITTED, GL_PRIMITIVES_SUBMITTED,
+                                         GL_VERTEX_SHADER_INVOCATIONS, GL_CLIPPING_OUTPUT_PRIMITIVES, GL_FRAGMENT_SHADER_INVOCATIONS};
+    return targets[query];
+}
+
+inline void FrameStats::BeginFrame() {
+    frame++;
+    // 第 N - Latency 帧：这时还没完成就丢掉，不等待
+    if (frame > Latency) {
+        Slot &old = slotFor(frame - Latency);
+        if (old.Pending && !resolve(old))
+            dropped++;
+        old.Pending = false;
+    }
+    Slot &slot = slotFor(frame);
+    slot.Frame = frame;
+    slot.UsedPasses = 0;
+    slot.Pending = false;
+    frameStart = std::chrono::high_resolution_clock::now();
+}
+
+inline void FrameStats::EndFrame() {
+    if (currentPass >= 0)
+        EndPass();
+    Slot &slot = slotFor(frame);
+    slot.CpuMs = std::chrono::duration<double, std::milli>(std::chrono::high_resolution_clock::now() - frameStart).count();
+    slot.Pending = slot.UsedPasses > 0;
+}
+
+inline void FrameStats::BeginPass(const std::string &name) {
+    if (currentPass >= 0)
+        EndPass();
+    Slot &slot = slotFor(frame);
+    if (slot.UsedPasses == slot.Passes.size()) {
+        slot.Passes.emplace_back();
+        glGenQueries(QUERY_COUNT, slot.Passes.back().Queries);
+    }
+    currentPass = (int) slot.UsedPasses++;
+    PassQueries &pass = slot.Passes[currentPass];
+    pass.Name = name;
+    pass.Draws = pass.Calls = 0;
+    for (int i = 0; i < queryCount; i++)
+        glBeginQuery(target(i), pass.Queries[i]);
+}
+
+inline void FrameStats::EndPass() {
+    if (currentPass < 0)
+        return;
+    for (int i = 0; i < queryCount; i++)
+        glEndQuery(target(i));
+    currentPass = -1;
+}
+
+inline void FrameStats::CountDraw(unsigned int count) {
+    if (currentPass >= 0)
+        slotFor(frame).Passes[currentPass].Draws += count;
+}
+
+inline void FrameStats::CountCalls(unsigned int count) {
+    if (currentPass >= 0)
+        slotFor(frame).Passes[currentPass].Calls += count;
+}
+
+inline bool FrameStats::resolve(Slot &slot) {
+    for (size_t p = 0; p < slot.UsedPasses; p++)
+        for (int i = 0; i < queryCount; i++) {
+            GLint available = 0;
+            glGetQueryObjectiv(slot.Passes[p].Queries[i], GL_QUERY_RESULT_AVAILABLE, &available);
+            if (!available)
+                return false;
+        }
+
+    latest.Frame = slot.Frame;
+    latest.CpuMs = slot.CpuMs;
+    latest.Passes.resize(slot.UsedPasses);
+    for (size_t p = 0; p < slot.UsedPasses; p++) {
+        const PassQueries &queries = slot.Passes[p];
+        GLuint64 values[QUERY_COUNT] = {};
+        for (int i = 0; i < queryCount; i++)
+            glGetQueryObjectui64v(queries.Queries[i], GL_QUERY_RESULT, &values[i]);
+        PassStats &pass = latest.Passes[p];
+        pass.Name = queries.Name;
+        pass.Draws = queries.Draws;
+        pass.Calls = queries.Calls;
+        pass.GpuMs = values[0] / 1000000.0;
+        pass.Vertices = values[1];
+        pass.Primitives = values[2];
+        pass.VertexInvocations = values[3];
+        pass.ClippedPrimitives = values[4];
+        pass.FragmentInvocations = values[5];
+    }
+
+    if (log.is_open()) {
+        for (const PassStats &pass : latest.Passes)
+            log << latest.Frame << "," << pass.Name << "," << latest.CpuMs << "," << pass.GpuMs << "," << pass.Draws << ","
+                << pass.Calls << "," << pass.Vertices << "," << pass.Primitives << "," << pass.VertexInvocations << ","
+                << pass.ClippedPrimitives << "," << pass.FragmentInvocations << "\n";
+    }
+    return true;
+}
+
+inline bool FrameStats::OpenLog(const std::string &path) {
+    CloseLog();
+    log.open(path);
+    if (!log)
+        return false;
+    log << "frame,pass,cpu_ms,gpu_ms,draws,calls,vertices,primitives,vs_invocations,clipped_primitives,fs_invocations\n";
+    return true;
+}
+
+inline void FrameStats::CloseLog() {
+    if (log.is_open())
+        log.close();
+}
+
+inline StatsOverlay::StatsOverlay(const char *vertexPath, const char *fragmentPath) : shader(vertexPath, fragmentPath) {
+    // 字体纹理：每个字符一个 4x6 的格子，R8，1表示点亮
+    const int width = CELL_WIDTH * CHAR_COUNT, height = CELL_HEIGHT;
+    std::vector<unsigned char> pixels((size_t) width * height, 0);
+    for (int c = 0; c < CHAR_COUNT; c++) {
+        const char *bits = glyph((char) (FIRST_CHAR + c));
+        for (int row = 0; row < 5; row++)
+            for (int column = 0; column < 3; column++)
+                if (c == CHAR_COUNT - 1 || (bits && bits[row * 3 + column] == '1'))
+                    pixels[(size_t) row * width + c * CELL_WIDTH + column] = 255;
+    }
+    glGenTextures(1, &font);
+    glBindTexture(GL_TEXTURE_2D, font);
+    glPixelStorei(GL_UNPACK_ALIGNMENT, 1);
+    glTexImage2D(GL_TEXTURE_2D, 0, GL_R8, width, height, 0, GL_RED, GL_UNSIGNED_BYTE, pixels.data());
+    glPixelStorei(GL_UNPACK_ALIGNMENT, 4);
+    glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_MIN_FILTER, GL_NEAREST);
+    glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_MAG_FILTER, GL_NEAREST);
+    glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_WRAP_S, GL_CLAMP_TO_EDGE);
+    glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_WRAP_T, GL_CLAMP_TO_EDGE);
+
+    glGenVertexArrays(1, &VAO);
+    glGenBuffers(1, &VBO);
+    glBindVertexArray(VAO);
+    glBindBuffer(GL_ARRAY_BUFFER, VBO);
+    glVertexAttribPointer(0, 2, GL_FLOAT, GL_FALSE, sizeof(Vertex), (void *) offsetof(Vertex, X));
+    glEnableVertexAttribArray(0);
+    glVertexAttribPointer(1, 2, GL_FLOAT, GL_FALSE, sizeof(Vertex), (void *) offsetof(Vertex, U));
+    glEnableVertexAttribArray(1);
+    glVertexAttribPointer(2, 4, GL_UNSIGNED_BYTE, GL_TRUE, sizeof(Vertex), (void *) offsetof(Vertex, Color));
+    glEnableVertexAttribArray(2);
+    glBindVertexArray(0);
+
+    shader.use();
+    shader.setInt("font", 0);
+}
+
+inline StatsOverlay::~StatsOverlay() {
+    glDeleteVertexArrays(1, &VAO);
+    glDeleteBuffers(1, &VBO);
+    glDeleteTextures(1, &font);
+}
+
+inline void StatsOverlay::quad(float x, float y, float width, float height, int cell, const glm::vec4 &color) {
+    const float texWidth = (float) (CELL_WIDTH * CHAR_COUNT);
+    float u0 = cell * CELL_WIDTH / texWidth, u1 = (cell * CELL_WIDTH + 3) / texWidth;
+    float v0 = 0.0f, v1 = 5.0f / CELL_HEIGHT;
+    Vertex v[4];
+    const float corners[4][4] = {{x, y, u0, v0}, {x + width, y, u1, v0}, {x + width, y + height, u1, v1}, {x, y + height, u0, v1}};
+    for (int i = 0; i < 4; i++) {
+        v[i].X = corners[i][0];
+        v[i].Y = corners[i][1];
+        v[i].U = corners[i][2];
+        v[i].V = corners[i][3];
+        for (int c = 0; c < 4; c++)
+            v[i].Color[c] = (unsigned char) (glm::clamp(color[c], 0.0f, 1.0f) * 255.0f + 0.5f);
+    }
+    const int order[6] = {0, 1, 2, 0, 2, 3};
+    for (int i : order)
+        vertices.push_back(v[i]);
+}
+
+inline float StatsOverlay::Text(float x, float y, const std::string &text, const glm::vec4 &color) {
+    for (char c : text) {
+        if (c >= 'a' && c <= 'z')
+            c = (char) (c - 'a' + 'A');
+        if (c != ' ' && glyph(c))
+            quad(x, y, 3.0f * Scale, 5.0f * Scale, c - FIRST_CHAR, color);
+        x += 4.0f * Scale;
+    }
+    return x;
+}
+
+inline void StatsOverlay::Rect(float x, float y, float width, float height, const glm::vec4 &color) {
+    quad(x, y, width, height, CHAR_COUNT - 1, color);
+}
+
+inline void StatsOverlay::Graph(float x, float y, float width, float height, const std::deque<float> &values, float maxValue,
+                                const glm::vec4 &color) {
+    if (values.empty() || maxValue <= 0.0f)
+        return;
+    float barWidth = width / values.size();
+    for (size_t i = 0; i < values.size(); i++) {
+        float h = std::min(values[i] / maxValue, 1.0f) * height;
+        Rect(x + i * barWidth, y + height - h, std::max(barWidth - 1.0f, 1.0f), h, color);
+    }
+}
+
+inline void StatsOverlay::AddFrameStats(const FrameStatsResult &result, int screenWidth, int screenHeight, float x, float y) {
+    auto compact = [](double value) {
+        std::ostringstream out;
+        out << std::fixed << std::setprecision(1);
+        if (value >= 1e6)
+            out << value / 1e6 << "M";
+        else if (value >= 1e3)
+            out << value / 1e3 << "K";
+        else
+            out << std::setprecision(0) << value;
+        return out.str();
+    };
+    auto column = [](std::string text, size_t width) {
+        text.resize(std::max(text.size(), width), ' ');
+        return text;
+    };
+    double pixels = (double) screenWidth * screenHeight;
+    float line = LineHeight();
+    float width = 4.0f * Scale * 70, graphHeight = 24.0f * Scale;
+    float rows = (float) result.Passes.size() + 2.0f;
+    Rect(x - 4.0f, y - 4.0f, width + 8.0f, line * rows + 4.0f + graphHeight + 8.0f, glm::vec4(0.0f, 0.0f, 0.0f, 0.6f));
+
+    std::ostringstream title;
+    title << std::fixed << std::setprecision(2) << "FRAME " << result.Frame << "  CPU " << result.CpuMs << " MS  GPU "
+          << result.GpuMs() << " MS";
+    Text(x, y, title.str(), glm::vec4(1.0f, 1.0f, 0.6f, 1.0f));
+    y += line;
+    Text(x, y, column("PASS", 14) + column("MS", 7) + column("DRAWS", 7) + column("CALLS", 7) + column("VERTS", 8) + column("PRIMS", 8) +
+               column("FRAGS", 8) + "FRAG/PX", glm::vec4(0.7f, 0.7f, 0.7f, 1.0f));
+    for (const PassStats &pass : result.Passes) {
+        y += line;
+        std::ostringstream ms, fill;
+        ms << std::fixed << std::setprecision(2) << pass.GpuMs;
+        fill << std::fixed << std::setprecision(2) << pass.FragmentInvocations / pixels;
+        Text(x, y, column(pass.Name.substr(0, 13), 14) + column(ms.str(), 7) + column(std::to_string(pass.Draws), 7) +
+                   column(std::to_string(pass.Calls), 7) + column(compact((double) pass.Vertices), 8) + column(compact((double) pass.Primitives), 8) +
+                   column(compact((double) pass.FragmentInvocations), 8) + fill.str());
+    }
+
+    // GPU时间的历史，满格是历史中的最大值
+    history.push_back((float) result.GpuMs());
+    while (history.size() > 120)
+        history.pop_front();
+    float maxMs = *std::max_element(history.begin(), history.end());
+    y += line + 4.0f;
+    Graph(x, y, width, graphHeight, history, maxMs, glm::vec4(0.3f, 0.9f, 0.4f, 0.9f));
+}
+
+inline size_t StatsOverlay::Draw(int screenWidth, int screenHeight, FrameStats *stats) {
+    size_t count = vertices.size();
+    if (count == 0)
+        return 0;
+    if (count > capacity)
+        capacity = count + count / 2;
+    // 每次都重新分配，驱动可以丢掉旧的内容，不用等上一帧的绘制读完
+    glBindBuffer(GL_ARRAY_BUFFER, VBO);
+    glBufferData(GL_ARRAY_BUFFER, capacity * sizeof(Vertex), nullptr, GL_STREAM_DRAW);
+    glBufferSubData(GL_ARRAY_BUFFER, 0, count * sizeof(Vertex), vertices.data());
+
+    glDisable(GL_DEPTH_TEST);
+    glEnable(GL_BLEND);
+    glBlendFunc(GL_SRC_ALPHA, GL_ONE_MINUS_SRC_ALPHA);
+    shader.use();
+    shader.setVec2("screenSize", glm::vec2((float) screenWidth, (float) screenHeight));
+    glActiveTexture(GL_TEXTURE0);
+    glBindTexture(GL_TEXTURE_2D, font);
+    glBindVertexArray(VAO);
+    glDrawArrays(GL_TRIANGLES, 0, (GLsizei) count);
+    if (stats)
+        stats->CountDraw();
+    glDisable(GL_BLEND);
+    glEnable(GL_DEPTH_TEST);
+
+    vertices.clear();
+    return count;
+}
+
+// 3x5 点阵，每行3个字符，从上到下5行
+inline const char *StatsOverlay::glyph(char c) {
+    switch (c) {
+        case ' ': return "000000000000000";
+        case '0': return "111101101101111";
+        case '1': return "010110010010111";
+        case '2': return "111001111100111";
+        case '3': return "111001111001111";
+        case '4': return "101101111001001";
+        case '5': return "111100111001111";
+        case '6': return "111100111101111";
+        case '7': return "111001001001001";
+        case '8': return "111101111101111";
+        case '9': return "111101111001111";
+        case 'A': return "010101111101101";
+        case 'B': return "110101110101110";
+        case 'C': return "011100100100011";
+        case 'D': return "110101101101110";
+        case 'E': return "111100110100111";
+        case 'F': return "111100110100100";
+        case 'G': return "011100101101011";
+        case 'H': return "101101111101101";
+        case 'I': return "111010010010111";
+        case 'J': return "001001001101010";
+        case 'K': return "101101110101101";
+        case 'L': return "100100100100111";
+        case 'M': return "101111111101101";
+        case 'N': return "110101101101101";
+        case 'O': return "010101101101010";
+        case 'P': return "110101110100100";
+        case 'Q': return "010101101110011";
+        case 'R': return "110101110101101";
+        case 'S': return "011100010001110";
+        case 'T': return "111010010010010";
+        case 'U': return "101101101101111";
+        case 'V': return "101101101101010";
+        case 'W': return "101101111111101";
+        case 'X': return "101101010101101";
+        case 'Y': return "101101010010010";
+        case 'Z': return "111001010100111";
+        case '.': return "000000000000010";
+        case ',': return "000000000010100";
+        case ':': return "000010000010000";
+        case '/': return "001001010100100";
+        case '%': return "101001010100101";
+        case '-': return "000000111000000";
+        case '+': return "000010111010000";
+        case '=': return "000111000111000";
+        case '_': return "000000000000111";
+        case '(': return "001010010010001";
+        case ')': return "100010010010100";
+        default: return nullptr;
+    }
+}
+
+#endif // LEARNOPENGL_FRAME_STATS_H
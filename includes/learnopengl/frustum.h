@@ -0,0 +1,72 @@
+#ifndef LEARNOPENGL_FRUSTUM_H
+#define LEARNOPENGL_FRUSTUM_H
+
+#include <glm/glm.hpp>
+
+#include "bounds.h"
+
+// 视锥体，从 projection * view 矩阵中提取六个平面（Gribb-Hartmann方法）
+// 平面法线指向视锥体内部，并且已经归一化，所以 dot(n, p) + d 就是到平面的有符号距离
+// 反转深度的无穷远投影也适用，但平面的含义变了：PLANE_FAR 是真正的近平面 z_view <= -near（不能省掉）；
+// PLANE_NEAR 在 [-1, 1] 深度范围下退化为恒成立，在 [0, 1]（glClipControl）下是 z_view <= near，比近平面宽松；没有远平面
+class Frustum {
+public:
+    enum Plane { PLANE_LEFT = 0, PLANE_RIGHT, PLANE_BOTTOM, PLANE_TOP, PLANE_NEAR, PLANE_FAR, PLANE_COUNT };
+
+    glm::vec4 Planes[PLANE_COUNT];
+
+    Frustum() = default;
+    explicit Frustum(const glm::mat4 &viewProjection);
+
+    bool IntersectsAABB(const glm::vec3 &center, const glm::vec3 &extents) const;
+    bool IntersectsAABB(const AABB &box) const { return IntersectsAABB(box.Center(), box.Extents()); }
+    bool IntersectsSphere(const glm::vec3 &center, float radius) const;
+};
+
+// 类定义
+// =================================================================================================
+
+inline Frustum::Frustum(const glm::mat4 &m) {
+    // glm是列主序，m[c][r]，这里取出矩阵的四行
+    glm::vec4 row0(m[0][0], m[1][0], m[2][0], m[3][0]);
+    glm::vec4 row1(m[0][1], m[1][1], m[2][1], m[3][1]);
+    glm::vec4 row2(m[0][2], m[1][2], m[2][2], m[3][2]);
+    glm::vec4 row3(m[0][3], m[1][3], m[2][3], m[3][3]);
+
+    Planes[PLANE_LEFT] = row3 + row0;
+    Planes[PLANE_RIGHT] = row3 - row0;
+    Planes[PLANE_BOTTOM] = row3 + row1;
+    Planes[PLANE_TOP] = row3 - row1;
+    Planes[PLANE_NEAR] = row3 + row2;
+    Planes[PLANE_FAR] = row3 - row2;
+
+    for (auto &plane : Planes) {
+        float len = glm::length(glm::vec3(plane.x, plane.y, plane.z));
+        // 无限远投影的远平面法线长度为0，让它对所有点都返回正距离
+        if (len > 0.0f)
+            plane /= len;
+        else
+            plane = glm::vec4(0.0f, 0.0f, 0.0f, 1.0f);
+    }
+}
+
+inline bool Frustum::IntersectsAABB(const glm::vec3 &center, const glm::vec3 &extents) const {
+    for (const auto &plane : Planes) {
+        glm::vec3 n(plane.x, plane.y, plane.z);
+        // 包围盒在平面法线方向上的投影半径
+        float r = glm::dot(extents, glm::abs(n));
+        if (glm::dot(n, center) + plane.w < -r)
+            return false;
+    }
+    return true;
+}
+
+inline bool Frustum::IntersectsSphere(const glm::vec3 &center, float radius) const {
+    for (const auto &plane : Planes) {
+        if (glm::dot(glm::vec3(plane.x, plane.y, plane.z), center) + plane.w < -radius)
+            return false;
+    }
+    return true;
+}
+
+#endif // LEARNOPENGL_FRUSTUM_H
@@ -0,0 +1,140 @@
+#ifndef LEARNOPENGL_GBUFFER_H
+#define LEARNOPENGL_GBUFFER_H
+
+#include <glad/glad.h>
+#include <glm/glm.hpp>
+
+#include <cmath>
+#include <iostream>
+#include <algorithm>
+
+// 延迟渲染的G-buffer，每像素12字节：
+//   附件0  RGBA8    albedo.rgb + 粗糙度
+//   附件1  RG16     八面体编码的世界空间法线（[-1, 1] 映射到 [0, 1]）
+//   深度   DEPTH32F 光照阶段由深度和逆投影矩阵重建位置，不单独保存位置
+// 几何阶段绑定 FBO 后用 MRT 一次写入两个颜色附件；光照阶段用 texelFetch 读取，不需要过滤
+class GBuffer {
+public:
+    static const int BytesPerPixel = 12;
+
+    GBuffer(int width, int height);
+    ~GBuffer();
+    GBuffer(const GBuffer &) = delete;
+    GBuffer &operator=(const GBuffer &) = delete;
+
+    // 大小不变时什么都不做
+    void Resize(int width, int height);
+    // 绑定帧缓冲、设置视口并清空，之后绘制几何阶段
+    void BindForGeometry() const;
+    // 把三个纹理依次绑定到 firstUnit、firstUnit + 1、firstUnit + 2
+    void BindTextures(unsigned int firstUnit = 0) const;
+
+    unsigned int FBO() const { return fbo; }
+    unsigned int DepthTexture() const { return depth; }
+    int Width() const { return width; }
+    int Height() const { return height; }
+
+private:
+    unsigned int fbo = 0, albedo = 0, normal = 0, depth = 0;
+    int width = 0, height = 0;
+
+    void create();
+    void destroy();
+};
+
+// 八面体编码：单位向量投影到 |x|+|y|+|z|=1 的八面体上，下半部分翻折到上半部分的外侧，得到 [-1, 1]^2 中的两个分量
+// 和 deferred_gbuffer.fs、deferred_lighting.fs 中的实现一致，用来在CPU上检查量化后的精度
+glm::vec2 OctEncode(const glm::vec3 &n);
+glm::vec3 OctDecode(const glm::vec2 &e);
+
+// 类定义
+// =================================================================================================
+
+inline GBuffer::GBuffer(int width, int height) : width(width), height(height) {
+    create();
+}
+
+inline GBuffer::~GBuffer() {
+    destroy();
+}
+
+inline void GBuffer::Resize(int newWidth, int newHeight) {
+    if (newWidth == width && newHeight == height)
+        return;
+    destroy();
+    width = newWidth;
+    height = newHeight;
+    create();
+}
+
+inline void GBuffer::BindForGeometry() const {
+    glBindFramebuffer(GL_FRAMEBUFFER, fbo);
+    glViewport(0, 0, width, height);
+    glClearColor(0.0f, 0.0f, 0.0f, 0.0f);
+    glClear(GL_COLOR_BUFFER_BIT | GL_DEPTH_BUFFER_BIT);
+}
+
+inline void GBuffer::BindTextures(unsigned int firstUnit) const {
+    glActiveTexture(GL_TEXTURE0 + firstUnit);
+    glBindTexture(GL_TEXTURE_2D, albedo);
+    glActiveTexture(GL_TEXTURE0 + firstUnit + 1);
+    glBindTexture(GL_TEXTURE_2D, normal);
+    glActiveTexture(GL_TEXTURE0 + firstUnit + 2);
+    glBindTexture(GL_TEXTURE_2D, depth);
+    glActiveTexture(GL_TEXTURE0);
+}
+
+inline void GBuffer::create() {
+    glGenFramebuffers(1, &fbo);
+    glBindFramebuffer(GL_FRAMEBUFFER, fbo);
+
+    struct Attachment { unsigned int *Texture; GLenum InternalFormat, Format, Type, Point; };
+    const Attachment attachments[] = {
+            {&albedo, GL_RGBA8, GL_RGBA, GL_UNSIGNED_BYTE, GL_COLOR_ATTACHMENT0},
+            {&normal, GL_RG16, GL_RG, GL_UNSIGNED_SHORT, GL_COLOR_ATTACHMENT1},
+            {&depth, GL_DEPTH_COMPONENT32F, GL_DEPTH_COMPONENT, GL_FLOAT, GL_DEPTH_ATTACHMENT}
+    };
+    for (const Attachment &a : attachments) {
+        glGenTextures(1, a.Texture);
+        glBindTexture(GL_TEXTURE_2D, *a.Texture);
+        glTexImage2D(GL_TEXTURE_2D, 0, a.InternalFormat, width, height, 0, a.Format, a.Type, nullptr);
+        glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_MIN_FILTER, GL_NEAREST);
+        glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_MAG_FILTER, GL_NEAREST);
+        glFramebufferTexture2D(GL_FRAMEBUFFER, a.Point, GL_TEXTURE_2D, *a.Texture, 0);
+    }
+    const GLenum drawBuffers[] = {GL_COLOR_ATTACHMENT0, GL_COLOR_ATTACHMENT1};
+    glDrawBuffers(2, drawBuffers);
+
+    if (glCheckFramebufferStatus(GL_FRAMEBUFFER) != GL_FRAMEBUFFER_COMPLETE)
+        std::cout << "ERROR::GBUFFER:: Framebuffer is not complete!" << std::endl;
+    glBindFramebuffer(GL_FRAMEBUFFER, 0);
+}
+
+inline void GBuffer::destroy() {
+    glDeleteFramebuffers(1, &fbo);
+    glDeleteTextures(1, &albedo);
+    glDeleteTextures(1, &normal);
+    glDeleteTextures(1, &depth);
+    fbo = albedo = normal = depth = 0;
+}
+
+inline glm::vec2 OctEncode(const glm::vec3 &n) {
+    glm::vec3 v = n / (std::abs(n.x) + std::abs(n.y) + std::abs(n.z));
+    glm::vec2 e(v.x, v.y);
+    if (v.z < 0.0f) {
+        e.x = (1.0f - std::abs(v.y)) * (v.x >= 0.0f ? 1.0f : -1.0f);
+        e.y = (1.0f - std::abs(v.x)) * (v.y >= 0.0f ? 1.0f : -1.0f);
+    }
+    return e;
+}
+
+inline glm::vec3 OctDecode(const glm::vec2 &e) {
+    glm::vec3 v(e.x, e.y, 1.0f - std::abs(e.x) - std::abs(e.y));
+    // 下半部分：翻折回来
+    float t = std::max(-v.z, 0.0f);
+    v.x += v.x >= 0.0f ? -t : t;
+    v.y += v.y >= 0.0f ? -t : t;
+    return glm::normalize(v);
+}
+
+#endif // LEARNOPENGL_GBUFFER_H
@@ -0,0 +1,300 @@
+#ifndef LEARNOPENGL_GPU_CULLING_H
+#define LEARNOPENGL_GPU_CULLING_H
+
+#include <glad/glad.h>
+#include <glm/glm.hpp>
+
+#include <vector>
+#include <algorithm>
+
+#include "compute_shader.h"
+#include "frustum.h"
+
+// 每个物体的剔除输入，布局和 gpu_cull.comp 中 std430 的 Object 结构一致
+struct GpuCullObject {
+    glm::vec4 Center;           // xyz: 世界空间包围盒中心
+    glm::vec4 Extents;          // xyz: 包围盒半长
+    unsigned int VertexCount;   // 对应 glDrawArrays 的 count
+    unsigned int FirstVertex;   // 对应 glDrawArrays 的 first
+    unsigned int Padding[2];
+};
+
+// glMultiDrawArraysIndirect 规定的命令格式
+struct DrawArraysIndirectCommand {
+    unsigned int Count;
+    unsigned int InstanceCount;
+    unsigned int First;
+    unsigned int BaseInstance;
+};
+
+// GPU剔除：计算着色器对每个物体做视锥体剔除和Hi-Z遮挡剔除，
+// 可见物体被压缩写入间接绘制命令缓冲，数量写入参数缓冲，CPU不回读可见性。
+//
+// 每帧的顺序：
+//   Cull(当前帧VP) -> Draw() -> 渲染剩余内容 -> BuildHiZ(当前帧深度, 当前帧VP)
+// 遮挡测试使用的是上一帧的深度金字塔和上一帧的VP矩阵。
+class GpuCuller {
+public:
+    GpuCuller(const char *hizBuildPath, const char *cullPath);
+    ~GpuCuller();
+    GpuCuller(const GpuCuller &) = delete;
+    GpuCuller &operator=(const GpuCuller &) = delete;
+
+    void SetObjects(const std::vector<GpuCullObject> &objects);
+    unsigned int ObjectCount() const { return objectCount; }
+
+    // 给VAO添加一个逐实例的物体编号属性（uint）。每条命令的 baseInstance 就是物体编号，
+    // 所以顶点着色器可以用这个属性去索引物体的模型矩阵等数据
+    void BindObjectIdAttribute(unsigned int vao, unsigned int location) const;
+
+    // GPU剔除，occlusion为false时只做视锥体剔除
+    void Cull(const glm::mat4 &viewProjection, bool occlusion = true);
+    // CPU视锥体剔除，作为参考实现，结果写入同一个命令缓冲
+    std::vector<unsigned int> CullCpu(const glm::mat4 &viewProjection);
+    // 直接指定要绘制的物体列表
+    void SetDrawList(const std::vector<unsigned int> &ids);
+    // 绘制命令缓冲中的可见物体
+    void Draw(GLenum mode = GL_TRIANGLES) const;
+
+    // 用当前帧的深度纹理生成Hi-Z金字塔，供下一帧遮挡剔除使用
+    void BuildHiZ(unsigned int depthTexture, int width, int height, const glm::mat4 &viewProjection);
+    void InvalidateHiZ() { hizValid = false; }
+
+    // 回读可见物体编号，会等待GPU完成，只用于验证
+    std::vector<unsigned int> ReadbackVisible() const;
+
+private:
+    ComputeShader hizBuild;
+    ComputeShader cull;
+
+    unsigned int objectBuffer;
+    unsigned int commandBuffer;
+    unsigned int countBuffer;
+    unsigned int objectIdBuffer;
+    unsigned int objectCount;
+    std::vector<GpuCullObject> cpuObjects;
+
+    unsigned int hizTexture;
+    int hizWidth;
+    int hizHeight;
+    int hizLevels;
+    bool hizValid;
+    glm::mat4 hizViewProjection;
+
+    void resetCommands() const;
+    void allocateHiZ(int width, int height);
+};
+
+// 类定义
+// =================================================================================================
+
+inline GpuCuller::GpuCuller(const char *hizBuildPath, const char *cullPath)
+        : hizBuild(hizBuildPath), cull(cullPath), objectCount(0),
+          hizTexture(0), hizWidth(0), hizHeight(0), hizLevels(0), hizValid(false), hizViewProjection(1.0f) {
+    glGenBuffers(1, &objectBuffer);
+    glGenBuffers(1, &commandBuffer);
+    glGenBuffers(1, &countBuffer);
+    glGenBuffers(1, &objectIdBuffer);
+
+    unsigned int zero = 0;
+    glBindBuffer(GL_SHADER_STORAGE_BUFFER, countBuffer);
+    glBufferData(GL_SHADER_STORAGE_BUFFER, sizeof(unsigned int), &zero, GL_DYNAMIC_DRAW);
+}
+
+inline GpuCuller::~GpuCuller() {
+    glDeleteBuffers(1, &objectBuffer);
+    glDeleteBuffers(1, &commandBuffer);
+    glDeleteBuffers(1, &countBuffer);
+    glDeleteBuffers(1, &objectIdBuffer);
+    if (hizTexture)
+        glDeleteTextures(1, &hizTexture);
+}
+
+inline void GpuCuller::SetObjects(const std::vector<GpuCullObject> &objects) {
+    cpuObjects = objects;
+    objectCount = (unsigned int) objects.size();
+
+    glBindBuffer(GL_SHADER_STORAGE_BUFFER, objectBuffer);
+    glBufferData(GL_SHADER_STORAGE_BUFFER, objects.size() * sizeof(GpuCullObject), objects.data(), GL_STATIC_DRAW);
+
+    glBindBuffer(GL_SHADER_STORAGE_BUFFER, commandBuffer);
+    glBufferData(GL_SHADER_STORAGE_BUFFER, objects.size() * sizeof(DrawArraysIndirectCommand), nullptr, GL_DYNAMIC_DRAW);
+
+    std::vector<unsigned int> ids(objectCount);
+    for (unsigned int i = 0; i < objectCount; i++)
+        ids[i] = i;
+    glBindBuffer(GL_ARRAY_BUFFER, objectIdBuffer);
+    glBufferData(GL_ARRAY_BUFFER, ids.size() * sizeof(unsigned int), ids.data(), GL_STATIC_DRAW);
+
+    resetCommands();
+}
+
+inline void GpuCuller::BindObjectIdAttribute(unsigned int vao, unsigned int location) const {
+    glBindVertexArray(vao);
+    glBindBuffer(GL_ARRAY_BUFFER, objectIdBuffer);
+    glVertexAttribIPointer(location, 1, GL_UNSIGNED_INT, sizeof(unsigned int), (void *) nullptr);
+    glEnableVertexAttribArray(location);
+    // 每个实例前进一次，起点由命令的 baseInstance 决定
+    glVertexAttribDivisor(location, 1);
+}
+
+inline void GpuCuller::resetCommands() const {
+    // 清零整个命令缓冲：不支持 indirect count 时会绘制 objectCount 条命令，尾部 instanceCount 为0的命令不产生绘制
+    glBindBuffer(GL_SHADER_STORAGE_BUFFER, commandBuffer);
+    glClearBufferData(GL_SHADER_STORAGE_BUFFER, GL_R32UI, GL_RED_INTEGER, GL_UNSIGNED_INT, nullptr);
+    glBindBuffer(GL_SHADER_STORAGE_BUFFER, countBuffer);
+    glClearBufferData(GL_SHADER_STORAGE_BUFFER, GL_R32UI, GL_RED_INTEGER, GL_UNSIGNED_INT, nullptr);
+}
+
+inline void GpuCuller::Cull(const glm::mat4 &viewProjection, bool occlusion) {
+    if (objectCount == 0)
+        return;
+    resetCommands();
+
+    Frustum frustum(viewProjection);
+    cull.use();
+    cull.setUInt("objectCount", objectCount);
+    cull.setVec4Array("frustumPlanes", frustum.Planes, Frustum::PLANE_COUNT);
+    cull.setBool("occlusionEnabled", occlusion && hizValid);
+    cull.setMat4("hizViewProjection", hizViewProjection);
+    cull.setVec2("hizSize", glm::vec2((float) hizWidth, (float) hizHeight));
+    cull.setInt("hizLevels", hizLevels);
+    cull.setInt("hiz", 0);
+
+    glActiveTexture(GL_TEXTURE0);
+    glBindTexture(GL_TEXTURE_2D, hizTexture);
+    glBindBufferBase(GL_SHADER_STORAGE_BUFFER, 0, objectBuffer);
+    glBindBufferBase(GL_SHADER_STORAGE_BUFFER, 1, commandBuffer);
+    glBindBufferBase(GL_SHADER_STORAGE_BUFFER, 2, countBuffer);
+
+    cull.dispatch(objectCount);
+    // 命令缓冲和参数缓冲接下来会被间接绘制读取
+    glMemoryBarrier(GL_COMMAND_BARRIER_BIT | GL_SHADER_STORAGE_BARRIER_BIT);
+}
+
+inline std::vector<unsigned int> GpuCuller::CullCpu(const glm::mat4 &viewProjection) {
+    Frustum frustum(viewProjection);
+    std::vector<unsigned int> visible;
+    for (unsigned int i = 0; i < objectCount; i++) {
+        const GpuCullObject &o = cpuObjects[i];
+        if (frustum.IntersectsAABB(glm::vec3(o.Center), glm::vec3(o.Extents)))
+            visible.push_back(i);
+    }
+    SetDrawList(visible);
+    return visible;
+}
+
+inline void GpuCuller::SetDrawList(const std::vector<unsigned int> &ids) {
+    resetCommands();
+    if (ids.empty())
+        return;
+
+    std::vector<DrawArraysIndirectCommand> commands;
+    commands.reserve(ids.size());
+    for (unsigned int id : ids) {
+        const GpuCullObject &o = cpuObjects[id];
+        commands.push_back({o.VertexCount, 1, o.FirstVertex, id});
+    }
+    unsigned int count = (unsigned int) commands.size();
+    glBindBuffer(GL_SHADER_STORAGE_BUFFER, commandBuffer);
+    glBufferSubData(GL_SHADER_STORAGE_BUFFER, 0, commands.size() * sizeof(DrawArraysIndirectCommand), commands.data());
+    glBindBuffer(GL_SHADER_STORAGE_BUFFER, countBuffer);
+    glBufferSubData(GL_SHADER_STORAGE_BUFFER, 0, sizeof(unsigned int), &count);
+}
+
+inline void GpuCuller::Draw(GLenum mode) const {
+    if (objectCount == 0)
+        return;
+    glBindBuffer(GL_DRAW_INDIRECT_BUFFER, commandBuffer);
+    if (GLAD_GL_VERSION_4_6) {
+        glBindBuffer(GL_PARAMETER_BUFFER, countBuffer);
+        glMultiDrawArraysIndirectCount(mode, nullptr, 0, (GLsizei) objectCount, 0);
+    } else if (GLAD_GL_ARB_indirect_parameters) {
+        glBindBuffer(GL_PARAMETER_BUFFER_ARB, countBuffer);
+        glMultiDrawArraysIndirectCountARB(mode, nullptr, 0, (GLsizei) objectCount, 0);
+    } else {
+        // 没有 indirect count 时提交全部命令，被剔除的命令 instanceCount 为0
+        glMultiDrawArraysIndirect(mode, nullptr, (GLsizei) objectCount, 0);
+    }
+    glBindBuffer(GL_DRAW_INDIRECT_BUFFER, 0);
+}
+
+inline void GpuCuller::allocateHiZ(int width, int height) {
+    // Hi-Z 第0层取不小于深度缓冲的2的幂，这样每一层严格减半，屏幕坐标到每一层纹素的映射是精确的
+    int w = 1, h = 1;
+    while (w < width) w <<= 1;
+    while (h < height) h <<= 1;
+    if (hizTexture && w == hizWidth && h == hizHeight)
+        return;
+
+    if (hizTexture)
+        glDeleteTextures(1, &hizTexture);
+    hizWidth = w;
+    hizHeight = h;
+    hizLevels = 1;
+    while ((w | h) >> hizLevels)
+        hizLevels++;
+
+    glGenTextures(1, &hizTexture);
+    glBindTexture(GL_TEXTURE_2D, hizTexture);
+    glTexStorage2D(GL_TEXTURE_2D, hizLevels, GL_R32F, hizWidth, hizHeight);
+    glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_MIN_FILTER, GL_NEAREST_MIPMAP_NEAREST);
+    glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_MAG_FILTER, GL_NEAREST);
+    glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_WRAP_S, GL_CLAMP_TO_EDGE);
+    glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_WRAP_T, GL_CLAMP_TO_EDGE);
+}
+
+inline void GpuCuller::BuildHiZ(unsigned int depthTexture, int width, int height, const glm::mat4 &viewProjection) {
+    allocateHiZ(width, height);
+
+    hizBuild.use();
+    hizBuild.setInt("depthTex", 0);
+    hizBuild.setIVec2("depthSize", width, height);
+
+    // 第0层：从深度纹理取最大值（最远的深度）
+    glActiveTexture(GL_TEXTURE0);
+    glBindTexture(GL_TEXTURE_2D, depthTexture);
+    hizBuild.setInt("srcLevel", -1);
+    hizBuild.setIVec2("dstSize", hizWidth, hizHeight);
+    glBindImageTexture(0, hizTexture, 0, GL_FALSE, 0, GL_WRITE_ONLY, GL_R32F);
+    hizBuild.dispatch(hizWidth, hizHeight);
+
+    // 之后每一层取上一层2x2的最大值
+    for (int level = 1; level < hizLevels; level++) {
+        int srcW = std::max(1, hizWidth >> (level - 1)), srcH = std::max(1, hizHeight >> (level - 1));
+        int dstW = std::max(1, hizWidth >> level), dstH = std::max(1, hizHeight >> level);
+        glMemoryBarrier(GL_SHADER_IMAGE_ACCESS_BARRIER_BIT);
+        hizBuild.setInt("srcLevel", level - 1);
+        hizBuild.setIVec2("srcSize", srcW, srcH);
+        hizBuild.setIVec2("dstSize", dstW, dstH);
+        glBindImageTexture(1, hizTexture, level - 1, GL_FALSE, 0, GL_READ_ONLY, GL_R32F);
+        glBindImageTexture(0, hizTexture, level, GL_FALSE, 0, GL_WRITE_ONLY, GL_R32F);
+        hizBuild.dispatch(dstW, dstH);
+    }
+    glMemoryBarrier(GL_TEXTURE_FETCH_BARRIER_BIT);
+
+    hizViewProjection = viewProjection;
+    hizValid = true;
+}
+
+inline std::vector<unsigned int> GpuCuller::ReadbackVisible() const {
+    glMemoryBarrier(GL_BUFFER_UPDATE_BARRIER_BIT);
+    unsigned int count = 0;
+    glBindBuffer(GL_SHADER_STORAGE_BUFFER, countBuffer);
+    glGetBufferSubData(GL_SHADER_STORAGE_BUFFER, 0, sizeof(unsigned int), &count);
+
+    std::vector<DrawArraysIndirectCommand> commands(count);
+    if (count > 0) {
+        glBindBuffer(GL_SHADER_STORAGE_BUFFER, commandBuffer);
+        glGetBufferSubData(GL_SHADER_STORAGE_BUFFER, 0, count * sizeof(DrawArraysIndirectCommand), commands.data());
+    }
+    std::vector<unsigned int> ids;
+    ids.reserve(count);
+    for (const auto &c : commands)
+        ids.push_back(c.BaseInstance);
+    // 计算着色器用原子操作分配槽位，顺序不确定
+    std::sort(ids.begin(), ids.end());
+    return ids;
+}
+
+#endif // LEARNOPENGL_GPU_CULLING_H
@@ -0,0 +1,108 @@
+#ifndef LEARNOPENGL_GPU_PROFILER_H
+#define LEARNOPENGL_GPU_PROFILER_H
+
+#include <glad/glad.h>
+
+#include <string>
+#include <vector>
+#include <memory>
+#include <chrono>
+#include <sstream>
+#include <iomanip>
+
+#include "dynamic_resolution.h"
+
+// 按名字分段的渲染计时，每段一个 GpuTimer，结果有几帧的延迟
+// GL_TIME_ELAPSED 查询不能嵌套，分段只能依次 Begin / End
+// Synchronous 为true时改为在段的前后 glFinish，测CPU时间：会让CPU等GPU，只用于离线测量，
+// 但在 llvmpipe 这类等到刷新才光栅化的驱动上只有这样才能测到真正的渲染时间
+class GpuProfiler {
+public:
+    bool Synchronous;
+
+    explicit GpuProfiler(bool synchronous = false) : Synchronous(synchronous) {}
+    GpuProfiler(const GpuProfiler &) = delete;
+    GpuProfiler &operator=(const GpuProfiler &) = delete;
+
+    void Begin(const std::string &name);
+    void End();
+    // 读取已经完成的查询，不会等待GPU；同步模式下什么都不做
+    void Poll();
+
+    // 段最近一次的时间（毫秒），没有结果时为0
+    double Milliseconds(const std::string &name) const;
+    // 所有段的最近一次时间，"名字 x.xx ms" 用逗号连接
+    std::string Report() const;
+
+private:
+    struct Section {
+        std::string Name;
+        std::unique_ptr<GpuTimer> Timer;
+        double Ms = 0.0;
+    };
+    std::vector<Section> sections;
+    int current = -1;
+    std::chrono::high_resolution_clock::time_point start;
+
+    int find(const std::string &name) const;
+};
+
+// 类定义
+// =================================================================================================
+
+inline int GpuProfiler::find(const std::string &name) const {
+    for (size_t i = 0; i < sections.size(); i++)
+        if (sections[i].Name == name)
+            return (int) i;
+    return -1;
+}
+
+inline void GpuProfiler::Begin(const std::string &name) {
+    current = find(name);
+    if (current < 0) {
+        Section section;
+        section.Name = name;
+        sections.push_back(std::move(section));
+        current = (int) sections.size() - 1;
+    }
+    if (Synchronous) {
+        glFinish();
+        start = std::chrono::high_resolution_clock::now();
+        return;
+    }
+    if (!sections[current].Timer)
+        sections[current].Timer.reset(new GpuTimer());
+    sections[current].Timer->Begin();
+}
+
+inline void GpuProfiler::End() {
+    if (current < 0)
+        return;
+    if (Synchronous) {
+        glFinish();
+        sections[current].Ms = std::chrono::duration<double, std::milli>(std::chrono::high_resolution_clock::now() - start).count();
+    } else
+        sections[current].Timer->End();
+    current = -1;
+}
+
+inline void GpuProfiler::Poll() {
+    for (Section &section : sections)
+        if (section.Timer)
+            section.Timer->Poll(section.Ms);
+}
+
+inline double GpuProfiler::Milliseconds(const std::string &name) const {
+    int i = find(name);
+    return i < 0 ? 0.0 : sections[i].Ms;
+}
+
+inline std::string GpuProfiler::Report() const {
+    std::ostringstream out;
+    out << std::fixed << std::setprecision(2);
+    for (size_t i = 0; i < sections.size(); i++)
+        out << (i ? ", " : "") << sections[i].Name << " " << sections[i].Ms << " ms";
+    return out.str();
+}
+
+#endif // LEARNOPENGL_GPU_PROFILER_H
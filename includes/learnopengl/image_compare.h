@@ -0,0 +1,171 @@
+#ifndef LEARNOPENGL_IMAGE_COMPARE_H
+#define LEARNOPENGL_IMAGE_COMPARE_H
+
+#include <vector>
+#include <cmath>
+#include <cstdlib>
+#include <algorithm>
+
+#if defined(__SSE2__) || defined(_M_X64) || (defined(_M_IX86_FP) && _M_IX86_FP >= 2)
+#include <emmintrin.h>
+#define LEARNOPENGL_IMAGE_COMPARE_SSE2 1
+#endif
+
+// 两张图像的差别
+struct ImageDifference {
+    double Ssim = 1.0;          // 所有窗口SSIM的平均值，1表示完全相同
+    double MinSsim = 1.0;       // 最差的窗口，局部的错误（缺了一个物体）在平均值里很容易被淹没
+    int MaxDiff = 0;            // RGB通道的最大差值
+    double DiffFraction = 0.0;  // 通道差值超过阈值的像素比例
+};
+
+// 结构相似度（SSIM）：在亮度图上用 SSIM_WINDOW x SSIM_WINDOW 的窗口、SSIM_STRIDE 的步长计算，
+// 比逐像素的差值更接近人眼的感受：整体亮度的轻微偏移、抗锯齿边缘上的一两个像素差别影响很小，结构上的变化影响很大
+const int SSIM_WINDOW = 8;
+const int SSIM_STRIDE = 4;
+
+// RGBA8图像（a、b大小相同）转成亮度后计算SSIM，同时统计逐像素的差值
+ImageDifference CompareImages(const unsigned char *a, const unsigned char *b, int width, int height, int diffThreshold = 16);
+// RGBA8转成 [0, 1] 的亮度
+void RgbaToLuma(const unsigned char *rgba, int width, int height, std::vector<float> &luma);
+// 亮度图的SSIM，窗口的行用SSE2一次处理4个像素；minSsim可以为nullptr
+double SsimLuma(const float *x, const float *y, int width, int height, double *minSsim);
+// 标量版本，结果和SIMD版本只差浮点求和顺序带来的误差，用来校验
+double SsimLumaScalar(const float *x, const float *y, int width, int height, double *minSsim);
+// 差异图：相同的像素显示为暗的灰度，差值越大越红
+void MakeDiffImage(const unsigned char *a, const unsigned char *b, int width, int height, std::vector<unsigned char> &diff);
+
+// 类定义
+// =================================================================================================
+
+inline void RgbaToLuma(const unsigned char *rgba, int width, int height, std::vector<float> &luma) {
+    luma.resize((size_t) width * height);
+    for (size_t i = 0; i < luma.size(); i++) {
+        const unsigned char *p = rgba + i * 4;
+        luma[i] = (0.299f * p[0] + 0.587f * p[1] + 0.114f * p[2]) * (1.0f / 255.0f);
+    }
+}
+
+namespace image_compare_detail {
+    // 由窗口内的 Σx、Σy、Σx²、Σy²、Σxy 计算SSIM
+    inline double ssimFromSums(double sx, double sy, double sxx, double syy, double sxy) {
+        const double n = SSIM_WINDOW * SSIM_WINDOW;
+        const double c1 = 0.01 * 0.01, c2 = 0.03 * 0.03;
+        double mx = sx / n, my = sy / n;
+        // 方差不截断到0：舍入误差可能让它略小于0，但要和协方差保持一致，两张相同的图像才能得到正好为1的结果
+        double vx = sxx / n - mx * mx;
+        double vy = syy / n - my * my;
+        double cxy = sxy / n - mx * my;
+        return ((2.0 * mx * my + c1) * (2.0 * cxy + c2)) / ((mx * mx + my * my + c1) * (vx + vy + c2));
+    }
+
+    template<typename WindowSums>
+    double ssimWindows(int width, int height, double *minSsim, WindowSums sums) {
+        double total = 0.0, worst = 1.0;
+        int count = 0;
+        for (int y = 0; y + SSIM_WINDOW <= height; y += SSIM_STRIDE) {
+            for (int x = 0; x + SSIM_WINDOW <= width; x += SSIM_STRIDE) {
+                double s[5];
+                sums(x, y, s);
+                double ssim = ssimFromSums(s[0], s[1], s[2], s[3], s[4]);
+                total += ssim;
+                worst = std::min(worst, ssim);
+                count++;
+            }
+        }
+        if (minSsim)
+            *minSsim = count ? worst : 1.0;
+        return count ? total / count : 1.0;
+    }
+}
+
+inline double SsimLumaScalar(const float *x, const float *y, int width, int height, double *minSsim) {
+    return image_compare_detail::ssimWindows(width, height, minSsim, [&](int wx, int wy, double *s) {
+        float sx = 0.0f, sy = 0.0f, sxx = 0.0f, syy = 0.0f, sxy = 0.0f;
+        for (int row = 0; row < SSIM_WINDOW; row++) {
+            const float *px = x + (size_t) (wy + row) * width + wx;
+            const float *py = y + (size_t) (wy + row) * width + wx;
+            for (int i = 0; i < SSIM_WINDOW; i++) {
+                sx += px[i];
+                sy += py[i];
+                sxx += px[i] * px[i];
+                syy += py[i] * py[i];
+                sxy += px[i] * py[i];
+            }
+        }
+        s[0] = sx;
+        s[1] = sy;
+        s[2] = sxx;
+        s[3] = syy;
+        s[4] = sxy;
+    });
+}
+
+inline double SsimLuma(const float *x, const float *y, int width, int height, double *minSsim) {
+#ifdef LEARNOPENGL_IMAGE_COMPARE_SSE2
+    static_assert(SSIM_WINDOW % 4 == 0, "SSIM window must be a multiple of the SIMD width");
+    return image_compare_detail::ssimWindows(width, height, minSsim, [&](int wx, int wy, double *s) {
+        __m128 sx = _mm_setzero_ps(), sy = _mm_setzero_ps();
+        __m128 sxx = _mm_setzero_ps(), syy = _mm_setzero_ps(), sxy = _mm_setzero_ps();
+        for (int row = 0; row < SSIM_WINDOW; row++) {
+            const float *px = x + (size_t) (wy + row) * width + wx;
+            const float *py = y + (size_t) (wy + row) * width + wx;
+            for (int i = 0; i < SSIM_WINDOW; i += 4) {
+                __m128 vx = _mm_loadu_ps(px + i);
+                __m128 vy = _mm_loadu_ps(py + i);
+                sx = _mm_add_ps(sx, vx);
+                sy = _mm_add_ps(sy, vy);
+                sxx = _mm_add_ps(sxx, _mm_mul_ps(vx, vx));
+                syy = _mm_add_ps(syy, _mm_mul_ps(vy, vy));
+                sxy = _mm_add_ps(sxy, _mm_mul_ps(vx, vy));
+            }
+        }
+        // 水平求和
+        __m128 lanes[5] = {sx, sy, sxx, syy, sxy};
+        for (int k = 0; k < 5; k++) {
+            alignas(16) float v[4];
+            _mm_store_ps(v, lanes[k]);
+            s[k] = (double) v[0] + v[1] + v[2] + v[3];
+        }
+    });
+#else
+    return SsimLumaScalar(x, y, width, height, minSsim);
+#endif
+}
+
+inline ImageDifference CompareImages(const unsigned char *a, const unsigned char *b, int width, int height, int diffThreshold) {
+    ImageDifference result;
+    size_t pixels = (size_t) width * height, different = 0;
+    for (size_t i = 0; i < pixels; i++) {
+        int diff = 0;
+        for (int c = 0; c < 3; c++)
+            diff = std::max(diff, std::abs(a[i * 4 + c] - b[i * 4 + c]));
+        result.MaxDiff = std::max(result.MaxDiff, diff);
+        if (diff > diffThreshold)
+            different++;
+    }
+    result.DiffFraction = pixels ? (double) different / pixels : 0.0;
+
+    std::vector<float> lumaA, lumaB;
+    RgbaToLuma(a, width, height, lumaA);
+    RgbaToLuma(b, width, height, lumaB);
+    result.Ssim = SsimLuma(lumaA.data(), lumaB.data(), width, height, &result.MinSsim);
+    return result;
+}
+
+inline void MakeDiffImage(const unsigned char *a, const unsigned char *b, int width, int height, std::vector<unsigned char> &diff) {
+    diff.resize((size_t) width * height * 4);
+    for (size_t i = 0; i < (size_t) width * height; i++) {
+        int d = 0;
+        for (int c = 0; c < 3; c++)
+            d = std::max(d, std::abs(a[i * 4 + c] - b[i * 4 + c]));
+        unsigned char gray = (unsigned char) ((a[i * 4] + a[i * 4 + 1] + a[i * 4 + 2]) / 12);
+        unsigned char heat = (unsigned char) std::min(d * 4, 255);
+        diff[i * 4 + 0] = std::max(gray, heat);
+        diff[i * 4 + 1] = d > 0 ? (unsigned char) 0 : gray;
+        diff[i * 4 + 2] = d > 0 ? (unsigned char) 0 : gray;
+        diff[i * 4 + 3] = 255;
+    }
+}
+
+#endif // LEARNOPENGL_IMAGE_COMPARE_H
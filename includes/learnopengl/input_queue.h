@@ -0,0 +1,71 @@
+#ifndef LEARNOPENGL_INPUT_QUEUE_H
+#define LEARNOPENGL_INPUT_QUEUE_H
+
+#include <atomic>
+#include <chrono>
+
+// 单生产者单消费者的无锁环形队列：一个线程只调用Push，另一个线程只调用Pop
+// head只由消费者写，tail只由生产者写，分开放在不同的缓存行里，避免两个线程互相让对方的缓存行失效
+template<typename T, unsigned int Capacity>
+class SpscQueue {
+    static_assert((Capacity & (Capacity - 1)) == 0, "Capacity must be a power of two");
+
+public:
+    // 队列满时返回false，元素被丢弃
+    bool Push(const T &item);
+    bool Pop(T &item);
+    // 只是一个近似值，另一个线程可能同时在读写
+    unsigned int Size() const { return tail.load(std::memory_order_acquire) - head.load(std::memory_order_acquire); }
+
+private:
+    alignas(64) std::atomic<unsigned int> head{0};
+    alignas(64) std::atomic<unsigned int> tail{0};
+    alignas(64) T items[Capacity];
+};
+
+// 输入事件，Time是事件进入队列时的时间戳（秒），用来统计从输入到画面的延迟
+struct InputEvent {
+    enum Type {
+        CURSOR_POS,
+        SCROLL,
+        KEY
+    };
+    Type Kind;
+    double Time;
+    double X, Y;        // CURSOR_POS：光标位置；SCROLL：滚动量
+    int Key, Action;    // KEY
+};
+
+typedef SpscQueue<InputEvent, 4096> InputQueue;
+
+// 所有线程共用的单调时钟，单位为秒
+inline double InputTimestamp() {
+    return std::chrono::duration<double>(std::chrono::steady_clock::now().time_since_epoch()).count();
+}
+
+// 类定义
+// =================================================================================================
+
+template<typename T, unsigned int Capacity>
+bool SpscQueue<T, Capacity>::Push(const T &item) {
+    unsigned int t = tail.load(std::memory_order_relaxed);
+    if (t - head.load(std::memory_order_acquire) == Capacity)
+        return false;
+    items[t & (Capacity - 1)] = item;
+    // release：消费者看到新的tail时，元素一定已经写好
+    tail.store(t + 1, std::memory_order_release);
+    return true;
+}
+
+template<typename T, unsigned int Capacity>
+bool SpscQueue<T, Capacity>::Pop(T &item) {
+    unsigned int h = head.load(std::memory_order_relaxed);
+    if (h == tail.load(std::memory_order_acquire))
+        return false;
+    item = items[h & (Capacity - 1)];
+    // release：生产者看到新的head时，这个位置已经读完，可以覆盖
+    head.store(h + 1, std::memory_order_release);
+    return true;
+}
+
+#endif // LEARNOPENGL_INPUT_QUEUE_H
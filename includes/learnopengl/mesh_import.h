@@ -0,0 +1,163 @@
+#ifndef LEARNOPENGL_MESH_IMPORT_H
+#define LEARNOPENGL_MESH_IMPORT_H
+
+#include <glm/glm.hpp>
+
+#include <learnopengl/bounds.h>
+
+#include <vector>
+#include <string>
+#include <cstddef>
+
+// 只读映射整个文件（POSIX上是mmap，Windows上是MapViewOfFile），析构时解除映射，可以移动不能复制
+// 空文件也能打开，Data() 为 nullptr、Size() 为0
+class MappedFile {
+public:
+    MappedFile() = default;
+    explicit MappedFile(const char *path) { Open(path); }
+    ~MappedFile() { Close(); }
+    MappedFile(MappedFile &&other) noexcept;
+    MappedFile &operator=(MappedFile &&other) noexcept;
+    MappedFile(const MappedFile &) = delete;
+    MappedFile &operator=(const MappedFile &) = delete;
+
+    bool Open(const char *path);
+    void Close();
+    bool IsOpen() const { return open; }
+    const unsigned char *Data() const { return data; }
+    size_t Size() const { return size; }
+
+private:
+    const unsigned char *data = nullptr;
+    size_t size = 0;
+    bool open = false;
+#ifdef _WIN32
+    void *file = nullptr, *mapping = nullptr;
+#endif
+};
+
+// 导入后的顶点，和教程中 Model 类的顶点布局相同：位置、法线、纹理坐标，紧密排列
+struct MeshVertex {
+    glm::vec3 Position;
+    glm::vec3 Normal;
+    glm::vec2 TexCoords;
+};
+
+// 索引化的三角形网格，Vertices 和 Indices 可以直接交给 glBufferData（GL_TRIANGLES，GL_UNSIGNED_INT）
+// 文件中没有法线或纹理坐标时对应的分量为0
+struct ImportedMesh {
+    std::vector<MeshVertex> Vertices;
+    std::vector<unsigned int> Indices;
+    bool HasNormals = false;
+    bool HasTexCoords = false;
+    AABB Bounds;
+
+    size_t TriangleCount() const { return Indices.size() / 3; }
+    void Clear();
+};
+
+// 上一次导入的统计，各阶段的耗时（毫秒）
+struct MeshImportStats {
+    size_t Bytes = 0;
+    unsigned int Threads = 0;
+    unsigned int Chunks = 0;        // OBJ分成的块数
+    size_t Positions = 0;           // 文件中的位置数
+    size_t Corners = 0;             // 三角化后三角形的角数，去重前的顶点数
+    double MapMs = 0.0;             // 打开并映射文件
+    double ParseMs = 0.0;           // 并行解析各块（glb：解析JSON、定位访问器）
+    double MergeMs = 0.0;           // 合并各块的属性，(位置, 纹理坐标, 法线) 去重生成索引（glb：展开成 ImportedMesh）
+    double TotalMs = 0.0;
+
+    double MegabytesPerSecond() const { return TotalMs > 0.0 ? Bytes / (TotalMs * 1000.0) : 0.0; }
+};
+
+// glTF访问器指向的数据，Data 直接指向映射的文件内容，不复制
+// ComponentType 是glTF（也就是GL）的枚举值：GL_FLOAT、GL_UNSIGNED_INT、GL_UNSIGNED_SHORT、GL_UNSIGNED_BYTE……
+struct GlbAccessor {
+    const unsigned char *Data = nullptr;
+    size_t Count = 0;
+    unsigned int Stride = 0;            // 相邻元素的字节距离
+    unsigned int ComponentType = 0;
+    unsigned int Components = 0;        // SCALAR 1，VEC2 2，VEC3 3，VEC4 4
+    bool Normalized = false;
+
+    bool Valid() const { return Data != nullptr; }
+    unsigned int ElementSize() const;
+    // 元素之间没有间隔时，[Data, Data + Count * ElementSize()) 可以整块交给 glBufferData
+    bool Packed() const { return Stride == ElementSize(); }
+    // 第 i 个元素的第 c 个分量，整数按 Normalized 归一化或者直接转换
+    float Float(size_t i, unsigned int c) const;
+    // 索引访问器的第 i 个索引
+    unsigned int Index(size_t i) const;
+};
+
+// 场景中的一个图元（只支持三角形），Model 是节点层级累计的变换
+struct GlbPrimitive {
+    GlbAccessor Positions;
+    GlbAccessor Normals;
+    GlbAccessor TexCoords;      // TEXCOORD_0
+    GlbAccessor Indices;        // 没有索引时无效，按顺序每3个顶点一个三角形
+    glm::mat4 Model = glm::mat4(1.0f);
+    unsigned int Mesh = 0;
+};
+
+// glTF 2.0 二进制文件（.glb）：映射文件，解析JSON块，按默认场景的节点层级列出所有三角形图元
+// 访问器直接指向文件中的BIN块，文件一直映射到 GlbFile 析构，不支持外部缓冲和稀疏访问器
+class GlbFile {
+public:
+    bool Open(const char *path);
+    // 从内存中解析，data 要一直有效
+    bool Parse(const unsigned char *data, size_t size);
+    const std::vector<GlbPrimitive> &Primitives() const { return primitives; }
+    const std::string &Error() const { return error; }
+    const MappedFile &File() const { return file; }
+
+private:
+    MappedFile file;
+    std::vector<GlbPrimitive> primitives;
+    std::string error;
+};
+
+// 网格导入：OBJ和glTF 2.0二进制（.glb），输出索引化、去重后的 ImportedMesh
+//
+// OBJ：映射文件后按 ChunkSize 分块，块的边界移到下一个换行之后，所有线程动态领取块并行解析（v、vt、vn、f，其他行忽略），
+// 数字用自己的解析器（见 ParseFloat），不经过 iostream 和 strtod 的开销，结果和 strtod 再转成float相同；
+// 负索引（相对索引）在合并时按块的偏移换算；多边形按扇形三角化
+// 合并时 (位置, 纹理坐标, 法线) 相同的角共用一个顶点，顶点按第一次出现的顺序排列，结果和线程数、分块无关
+//
+// glb：访问器零拷贝地指向映射的文件（见 GlbFile），Load 把所有图元变换到世界空间后拼成一个 ImportedMesh
+//
+// 出错时返回false，Error() 是错误信息（OBJ包括出错的行号）
+// 定义在 src/mesh_import.cpp 中，随引擎库一起编译
+class MeshImporter {
+public:
+    // 使用的线程数，0表示所有硬件线程
+    unsigned int Threads = 0;
+    // OBJ的块大小（字节），块太小时合并的开销变大，太大时线程之间的负载不均
+    size_t ChunkSize = 4u << 20;
+
+    // 按扩展名选择格式（.obj / .glb，不区分大小写）
+    bool Load(const char *path, ImportedMesh &mesh);
+    bool LoadObj(const char *path, ImportedMesh &mesh);
+    bool LoadGlb(const char *path, ImportedMesh &mesh);
+    // 从内存中的OBJ文本解析
+    bool ParseObj(const char *text, size_t size, ImportedMesh &mesh);
+    // 把 GlbFile 的所有图元展开到 mesh
+    bool Flatten(const GlbFile &glb, ImportedMesh &mesh);
+
+    const MeshImportStats &Stats() const { return stats; }
+    const std::string &Error() const { return error; }
+
+private:
+    MeshImportStats stats;
+    std::string error;
+
+    unsigned int threadCount() const;
+};
+
+// 快速的十进制浮点数解析，p 指向数字的开头（可以有符号），成功时返回数字之后的位置，失败时返回 nullptr
+// 支持 "1", "-1.5", ".5", "1e-3", "1.E+2"；不支持 inf、nan、十六进制
+// 有效数字不超过15位、十进制指数不大时（OBJ中的数字几乎都是这样）一次乘除得到结果，其他情况交给 strtod
+const char *ParseFloat(const char *p, const char *end, float &value);
+
+#endif // LEARNOPENGL_MESH_IMPORT_H
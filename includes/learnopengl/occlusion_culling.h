@@ -0,0 +1,579 @@
+#ifndef LEARNOPENGL_OCCLUSION_CULLING_H
+#define LEARNOPENGL_OCCLUSION_CULLING_H
+
+#include <glm/glm.hpp>
+
+#include <vector>
+#include <thread>
+#include <mutex>
+#include <condition_variable>
+#include <functional>
+#include <chrono>
+#include <cmath>
+#include <cstdint>
+#include <cfloat>
+#include <algorithm>
+
+#include "bounds.h"
+#include "worker_pool.h"
+
+#if defined(__AVX2__)
+#include <immintrin.h>
+#define LEARNOPENGL_OCCLUSION_CULLING_AVX2 1
+#endif
+
+// 遮挡物：非索引的三角形列表（GL_TRIANGLES），每个顶点 Stride 个float，前3个是物体空间的位置
+// 遮挡物应该是封闭的、不透明的大物体（建筑、地形、墙），顶点可以比渲染用的网格少得多
+struct Occluder {
+    const float *Vertices = nullptr;
+    unsigned int VertexCount = 0;
+    unsigned int Stride = 3;
+    glm::mat4 Model = glm::mat4(1.0f);
+};
+
+// 上一次 RenderOccluders、Test 的统计
+struct OcclusionCullingStats {
+    size_t OccluderTriangles = 0;   // 提交的遮挡物三角形
+    size_t RasterizedTriangles = 0; // 背面剔除、裁剪之后实际光栅化的三角形
+    size_t TileUpdates = 0;         // 三角形写入格子的次数
+    size_t Tested = 0;              // 测试的物体
+    size_t Culled = 0;              // 被遮挡的物体
+    double RasterMs = 0.0;
+    double TestMs = 0.0;
+};
+
+// CPU遮挡剔除，参考 masked software occlusion culling（Andersson 等，2015）：
+// 遮挡物光栅化到低分辨率的缓冲中，缓冲按 32 x 8 像素分成格子，每个格子只存 256 位的覆盖掩码和两个深度：
+//   ZMax0   参考层，格子内所有像素的深度上限
+//   ZMax1   工作层，掩码中的像素已经被深度不超过 ZMax1 的遮挡物覆盖
+// 三角形写入格子时把自己的覆盖掩码合并到工作层，工作层覆盖了整个格子就变成新的参考层；
+// 新的三角形比工作层近得多（差值超过工作层和参考层的差值）时先丢掉工作层，免得近处的遮挡物被远处的拖累
+// 每个像素的深度上限是：在掩码中取 min(ZMax0, ZMax1)，否则取 ZMax0，物体比它近的像素都可能可见
+//
+// 保守性：遮挡物只写入被三角形完整覆盖的像素（边函数减去半个像素的 |A| + |B|），深度取三角形在格子内的最大值；
+// 物体用包围盒在屏幕上覆盖的所有像素、8个角点中最近的深度测试，被剔除的物体在全分辨率下也一定被挡住
+// 包围盒和近平面相交的物体总是可见
+//
+// 深度是OpenGL默认的 [-1, 1] 映射到 [0, 1] 的窗口深度，越大越远
+// 有AVX2时每个格子的8行同时计算：每条边求出8行与边的交点，用可变移位生成每行32个像素的覆盖位，测试时用 testc 比较掩码；
+// 标量路径的运算和AVX2路径相同，结果逐位一致
+//
+// 多线程：遮挡物按数量分给各个线程做变换、裁剪和三角形设置，再按格子行分给各个线程光栅化（每个线程按同样的顺序处理所有三角形），
+// 物体测试按数量平分，结果和线程数无关；工作线程由 WorkerPool 常驻，每帧不再创建、销毁线程
+// CullAsync 在常驻的后台线程上完成整个剔除，主线程同时可以交换缓冲、等待上一帧的GPU工作
+class MaskedOcclusionCuller {
+public:
+    static const int TILE_WIDTH = 32;
+    static const int TILE_HEIGHT = 8;
+
+    // 大小向上取整到格子的整数倍
+    MaskedOcclusionCuller(int width = 320, int height = 192);
+    ~MaskedOcclusionCuller();
+    MaskedOcclusionCuller(const MaskedOcclusionCuller &) = delete;
+    MaskedOcclusionCuller &operator=(const MaskedOcclusionCuller &) = delete;
+
+    // 使用的线程数，0表示所有硬件线程
+    unsigned int Threads = 0;
+    // 没有编译AVX2时总是用标量路径
+    bool Simd = true;
+    // 遮挡物是封闭网格时剔除背面（逆时针为正面），可以少光栅化一半的三角形
+    bool BackfaceCulling = true;
+    static bool HasAvx2();
+
+    void Clear();
+    // 把遮挡物光栅化到缓冲中，viewProjection 同时用于之后的测试
+    void RenderOccluders(const std::vector<Occluder> &occluders, const glm::mat4 &viewProjection);
+    // 世界空间的包围盒是否可能可见
+    bool TestAABB(const AABB &box) const;
+    // 测试 candidates 中的物体（boxes 的下标，一般是视锥体剔除的结果），可能可见的按原来的顺序写入 visible
+    void Test(const std::vector<AABB> &boxes, const std::vector<unsigned int> &candidates, std::vector<unsigned int> &visible);
+
+    // 在后台线程上依次完成 Clear、RenderOccluders、Test，参数引用的内容在 Wait 返回之前不能修改
+    void CullAsync(const std::vector<Occluder> &occluders, const std::vector<AABB> &boxes,
+                   const std::vector<unsigned int> &candidates, const glm::mat4 &viewProjection);
+    // 等待 CullAsync 完成，返回可能可见的物体
+    const std::vector<unsigned int> &Wait();
+    bool Pending() const;
+
+    const OcclusionCullingStats &Stats() const { return stats; }
+    int Width() const { return width; }
+    int Height() const { return height; }
+    int TilesX() const { return tilesX; }
+    int TilesY() const { return tilesY; }
+    // 像素的深度上限，用来显示缓冲和校验
+    float PixelDepth(int x, int y) const;
+
+private:
+    // 每行像素一个 uint32_t，第 j 位是第 j 列；C++14 的 std::vector 不保证32字节对齐，AVX2路径用非对齐的读写
+    struct Tile {
+        uint32_t Mask[TILE_HEIGHT];
+        float ZMax0, ZMax1;
+    };
+    // 低分辨率屏幕上的三角形，已经是逆时针（边函数在内部为正）
+    struct ScreenTriangle {
+        float X[3], Y[3], Z[3];
+    };
+
+    int width, height;
+    int tilesX, tilesY;
+    std::vector<Tile> tiles;
+    glm::mat4 viewProjection = glm::mat4(1.0f);
+    std::vector<std::vector<ScreenTriangle>> triangleLists;
+    OcclusionCullingStats stats;
+
+    WorkerPool pool;
+    // CullAsync 的后台线程，第一次调用时创建
+    std::thread asyncThread;
+    mutable std::mutex asyncMutex;
+    std::condition_variable asyncCondition;
+    std::function<void()> asyncJob;
+    bool asyncPending = false, asyncQuit = false;
+    std::vector<unsigned int> asyncVisible;
+
+    void asyncLoop();
+
+    unsigned int threadCount(size_t work) const;
+    void setupOccluders(const std::vector<Occluder> &occluders, size_t first, size_t last, std::vector<ScreenTriangle> &out) const;
+    void addTriangle(const glm::vec4 &c0, const glm::vec4 &c1, const glm::vec4 &c2, std::vector<ScreenTriangle> &out) const;
+    size_t rasterizeRows(int tileRow0, int tileRow1);
+    void updateTile(Tile &tile, const uint32_t coverage[TILE_HEIGHT], float zTriangle) const;
+    void triangleCoverage(const float edgeA[3], const float edgeB[3], const float edgeC[3], int tileX, int tileY,
+                          uint32_t coverage[TILE_HEIGHT]) const;
+    bool testRect(int x0, int y0, int x1, int y1, float zMin) const;
+};
+
+// 类定义
+// =================================================================================================
+
+inline MaskedOcclusionCuller::MaskedOcclusionCuller(int w, int h) {
+    tilesX = (w + TILE_WIDTH - 1) / TILE_WIDTH;
+    tilesY = (h + TILE_HEIGHT - 1) / TILE_HEIGHT;
+    width = tilesX * TILE_WIDTH;
+    height = tilesY * TILE_HEIGHT;
+    tiles.resize((size_t) tilesX * tilesY);
+    Clear();
+}
+
+inline MaskedOcclusionCuller::~MaskedOcclusionCuller() {
+    {
+        std::lock_guard<std::mutex> lock(asyncMutex);
+        asyncQuit = true;
+    }
+    asyncCondition.notify_all();
+    // 后台线程先做完已经提交的剔除再退出
+    if (asyncThread.joinable())
+        asyncThread.join();
+}
+
+inline bool MaskedOcclusionCuller::HasAvx2() {
+#if defined(LEARNOPENGL_OCCLUSION_CULLING_AVX2)
+    return true;
+#else
+    return false;
+#endif
+}
+
+inline void MaskedOcclusionCuller::Clear() {
+    for (Tile &tile : tiles) {
+        std::fill(tile.Mask, tile.Mask + TILE_HEIGHT, 0u);
+        tile.ZMax0 = 1.0f;
+        tile.ZMax1 = 0.0f;
+    }
+}
+
+inline unsigned int MaskedOcclusionCuller::threadCount(size_t work) const {
+    unsigned int threads = Threads;
+    if (threads == 0)
+        threads = std::max(std::thread::hardware_concurrency(), 1u);
+    return (unsigned int) std::max<size_t>(std::min<size_t>(threads, work), 1);
+}
+
+inline float MaskedOcclusionCuller::PixelDepth(int x, int y) const {
+    const Tile &tile = tiles[(y / TILE_HEIGHT) * tilesX + x / TILE_WIDTH];
+    bool covered = (tile.Mask[y % TILE_HEIGHT] >> (x % TILE_WIDTH)) & 1u;
+    return covered ? std::min(tile.ZMax0, tile.ZMax1) : tile.ZMax0;
+}
+
+inline void MaskedOcclusionCuller::addTriangle(const glm::vec4 &c0, const glm::vec4 &c1, const glm::vec4 &c2, std::vector<ScreenTriangle> &out) const {
+    const glm::vec4 *c[3] = {&c0, &c1, &c2};
+    ScreenTriangle tri;
+    for (int k = 0; k < 3; k++) {
+        float invW = 1.0f / c[k]->w;
+        tri.X[k] = (c[k]->x * invW * 0.5f + 0.5f) * width;
+        tri.Y[k] = (c[k]->y * invW * 0.5f + 0.5f) * height;
+        tri.Z[k] = c[k]->z * invW * 0.5f + 0.5f;
+    }
+    float area = (tri.X[1] - tri.X[0]) * (tri.Y[2] - tri.Y[0]) - (tri.X[2] - tri.X[0]) * (tri.Y[1] - tri.Y[0]);
+    if (area == 0.0f || (BackfaceCulling && area < 0.0f))
+        return;
+    if (area < 0.0f) {
+        std::swap(tri.X[1], tri.X[2]);
+        std::swap(tri.Y[1], tri.Y[2]);
+        std::swap(tri.Z[1], tri.Z[2]);
+    }
+    // 完全在屏幕外
+    float minX = std::min(tri.X[0], std::min(tri.X[1], tri.X[2])), maxX = std::max(tri.X[0], std::max(tri.X[1], tri.X[2]));
+    float minY = std::min(tri.Y[0], std::min(tri.Y[1], tri.Y[2])), maxY = std::max(tri.Y[0], std::max(tri.Y[1], tri.Y[2]));
+    if (maxX <= 0.0f || maxY <= 0.0f || minX >= width || minY >= height)
+        return;
+    out.push_back(tri);
+}
+
+inline void MaskedOcclusionCuller::setupOccluders(const std::vector<Occluder> &occluders, size_t first, size_t last,
+                                                  std::vector<ScreenTriangle> &out) const {
+    out.clear();
+    std::vector<glm::vec4> polygon, clipped;
+    for (size_t o = first; o < last; o++) {
+        const Occluder &occluder = occluders[o];
+        glm::mat4 mvp = viewProjection * occluder.Model;
+        for (unsigned int i = 0; i + 2 < occluder.VertexCount; i += 3) {
+            glm::vec4 v[3];
+            for (int k = 0; k < 3; k++) {
+                const float *p = occluder.Vertices + (size_t) (i + k) * occluder.Stride;
+                v[k] = mvp * glm::vec4(p[0], p[1], p[2], 1.0f);
+            }
+            if (v[0].z >= -v[0].w && v[1].z >= -v[1].w && v[2].z >= -v[2].w) {
+                addTriangle(v[0], v[1], v[2], out);
+                continue;
+            }
+            // 和近平面相交，裁剪后按扇形重新组成三角形
+            polygon.assign(v, v + 3);
+            clipped.clear();
+            for (size_t k = 0; k < polygon.size(); k++) {
+                const glm::vec4 &a = polygon[k], &b = polygon[(k + 1) % polygon.size()];
+                float da = a.z + a.w, db = b.z + b.w;
+                if (da >= 0.0f)
+                    clipped.push_back(a);
+                if ((da >= 0.0f) != (db >= 0.0f))
+                    clipped.push_back(a + (b - a) * (da / (da - db)));
+            }
+            for (size_t k = 2; k < clipped.size(); k++)
+                addTriangle(clipped[0], clipped[k - 1], clipped[k], out);
+        }
+    }
+}
+
+inline void MaskedOcclusionCuller::RenderOccluders(const std::vector<Occluder> &occluders, const glm::mat4 &vp) {
+    auto start = std::chrono::high_resolution_clock::now();
+    viewProjection = vp;
+    stats = OcclusionCullingStats();
+    for (const Occluder &occluder : occluders)
+        stats.OccluderTriangles += occluder.VertexCount / 3;
+
+    // 1. 遮挡物按数量连续地分给各个线程，按线程的顺序连接起来就是提交的顺序
+    unsigned int threads = threadCount(occluders.size());
+    triangleLists.resize(threads);
+    pool.Run(threads, [this, &occluders, threads](unsigned int t) {
+        setupOccluders(occluders, occluders.size() * t / threads, occluders.size() * (t + 1) / threads, triangleLists[t]);
+    });
+    for (unsigned int t = 0; t < threads; t++)
+        stats.RasterizedTriangles += triangleLists[t].size();
+
+    // 2. 按格子行分给各个线程
+    threads = threadCount((size_t) tilesY);
+    std::vector<size_t> updates(threads, 0);
+    pool.Run(threads, [this, &updates, threads](unsigned int t) {
+        updates[t] = rasterizeRows(tilesY * t / threads, tilesY * (t + 1) / threads);
+    });
+    for (size_t u : updates)
+        stats.TileUpdates += u;
+    stats.RasterMs = std::chrono::duration<double, std::milli>(std::chrono::high_resolution_clock::now() - start).count();
+}
+
+// 光栅化所有三角形在格子行 [tileRow0, tileRow1) 中的部分，返回写入格子的次数
+inline size_t MaskedOcclusionCuller::rasterizeRows(int tileRow0, int tileRow1) {
+    size_t updates = 0;
+    int rowY0 = tileRow0 * TILE_HEIGHT, rowY1 = tileRow1 * TILE_HEIGHT;
+    for (const std::vector<ScreenTriangle> &list : triangleLists) {
+        for (const ScreenTriangle &tri : list) {
+            float minX = std::min(tri.X[0], std::min(tri.X[1], tri.X[2])), maxX = std::max(tri.X[0], std::max(tri.X[1], tri.X[2]));
+            float minY = std::min(tri.Y[0], std::min(tri.Y[1], tri.Y[2])), maxY = std::max(tri.Y[0], std::max(tri.Y[1], tri.Y[2]));
+            if (maxY <= (float) rowY0 || minY >= (float) rowY1)
+                continue;
+            int tx0 = std::max((int) std::floor(minX) / TILE_WIDTH, 0), tx1 = std::min((int) std::floor(maxX) / TILE_WIDTH, tilesX - 1);
+            int ty0 = std::max((int) std::floor(minY) / TILE_HEIGHT, tileRow0), ty1 = std::min((int) std::floor(maxY) / TILE_HEIGHT, tileRow1 - 1);
+            minX = std::max(minX, 0.0f);
+            minY = std::max(minY, 0.0f);
+
+            // 边函数 E = A * x + B * y + C 在内部为正，C 减去半个像素的 |A| + |B|，只有整个像素都在内部时才为正
+            float edgeA[3], edgeB[3], edgeC[3];
+            for (int e = 0; e < 3; e++) {
+                int i = e, j = (e + 1) % 3;
+                edgeA[e] = tri.Y[i] - tri.Y[j];
+                edgeB[e] = tri.X[j] - tri.X[i];
+                edgeC[e] = tri.X[i] * tri.Y[j] - tri.X[j] * tri.Y[i] - 0.5f * (std::abs(edgeA[e]) + std::abs(edgeB[e]));
+            }
+            // 深度平面，格子内三角形的最大深度在包围盒和格子交集的某个角上
+            float area = (tri.X[1] - tri.X[0]) * (tri.Y[2] - tri.Y[0]) - (tri.X[2] - tri.X[0]) * (tri.Y[1] - tri.Y[0]);
+            float dz1 = tri.Z[1] - tri.Z[0], dz2 = tri.Z[2] - tri.Z[0];
+            float zx = (dz1 * (tri.Y[2] - tri.Y[0]) - dz2 * (tri.Y[1] - tri.Y[0])) / area;
+            float zy = (dz2 * (tri.X[1] - tri.X[0]) - dz1 * (tri.X[2] - tri.X[0])) / area;
+            float zTriangleMax = std::max(tri.Z[0], std::max(tri.Z[1], tri.Z[2]));
+
+            for (int ty = ty0; ty <= ty1; ty++) {
+                for (int tx = tx0; tx <= tx1; tx++) {
+                    Tile &tile = tiles[ty * tilesX + tx];
+                    float cx0 = std::max((float) (tx * TILE_WIDTH), minX), cx1 = std::min((float) ((tx + 1) * TILE_WIDTH), maxX);
+                    float cy0 = std::max((float) (ty * TILE_HEIGHT), minY), cy1 = std::min((float) ((ty + 1) * TILE_HEIGHT), maxY);
+                    float z = tri.Z[0] + std::max(zx * (cx0 - tri.X[0]), zx * (cx1 - tri.X[0])) +
+                              std::max(zy * (cy0 - tri.Y[0]), zy * (cy1 - tri.Y[0]));
+                    z = std::min(z, zTriangleMax);
+                    if (z >= tile.ZMax0)
+                        continue;
+                    uint32_t coverage[TILE_HEIGHT];
+                    triangleCoverage(edgeA, edgeB, edgeC, tx * TILE_WIDTH, ty * TILE_HEIGHT, coverage);
+                    updateTile(tile, coverage, z);
+                    updates++;
+                }
+            }
+        }
+    }
+    return updates;
+}
+
+// 三角形在一个格子内完整覆盖的像素：每行求出和每条边的交点，A > 0 的边覆盖交点右边，A < 0 的边覆盖左边
+inline void MaskedOcclusionCuller::triangleCoverage(const float edgeA[3], const float edgeB[3], const float edgeC[3],
+                                                    int tileX, int tileY, uint32_t coverage[TILE_HEIGHT]) const {
+#if defined(LEARNOPENGL_OCCLUSION_CULLING_AVX2)
+    if (Simd) {
+        const __m256 rowCenter = _mm256_setr_ps(0.5f, 1.5f, 2.5f, 3.5f, 4.5f, 5.5f, 6.5f, 7.5f);
+        const __m256i full = _mm256_set1_epi32(-1), zeroi = _mm256_setzero_si256(), width32 = _mm256_set1_epi32(TILE_WIDTH);
+        __m256i mask = full;
+        for (int e = 0; e < 3; e++) {
+            float a = edgeA[e], b = edgeB[e];
+            // 格子原点为坐标原点时的常数项
+            float c = a * (float) tileX + b * (float) tileY + edgeC[e];
+            __m256 rowValue = _mm256_add_ps(_mm256_mul_ps(_mm256_set1_ps(b), rowCenter), _mm256_set1_ps(c));
+            __m256i bits;
+            if (a == 0.0f) {
+                bits = _mm256_castps_si256(_mm256_cmp_ps(rowValue, _mm256_setzero_ps(), _CMP_GT_OQ));
+            } else {
+                // 交点的列坐标（像素中心为整数），截断到 [-1, 33] 再转整数
+                __m256 xs = _mm256_sub_ps(_mm256_div_ps(_mm256_sub_ps(_mm256_setzero_ps(), rowValue), _mm256_set1_ps(a)), _mm256_set1_ps(0.5f));
+                xs = _mm256_min_ps(_mm256_max_ps(xs, _mm256_set1_ps(-1.0f)), _mm256_set1_ps(33.0f));
+                if (a > 0.0f) {
+                    __m256i first = _mm256_add_epi32(_mm256_cvttps_epi32(_mm256_floor_ps(xs)), _mm256_set1_epi32(1));
+                    first = _mm256_min_epi32(_mm256_max_epi32(first, zeroi), width32);
+                    bits = _mm256_sllv_epi32(full, first);
+                } else {
+                    __m256i count = _mm256_cvttps_epi32(_mm256_ceil_ps(xs));
+                    count = _mm256_min_epi32(_mm256_max_epi32(count, zeroi), width32);
+                    bits = _mm256_srlv_epi32(full, _mm256_sub_epi32(width32, count));
+                }
+            }
+            mask = _mm256_and_si256(mask, bits);
+        }
+        _mm256_storeu_si256((__m256i *) coverage, mask);
+        return;
+    }
+#endif
+    for (int r = 0; r < TILE_HEIGHT; r++)
+        coverage[r] = 0xFFFFFFFFu;
+    for (int e = 0; e < 3; e++) {
+        float a = edgeA[e], b = edgeB[e];
+        float c = a * (float) tileX + b * (float) tileY + edgeC[e];
+        for (int r = 0; r < TILE_HEIGHT; r++) {
+            float rowValue = b * ((float) r + 0.5f) + c;
+            uint32_t bits;
+            if (a == 0.0f) {
+                bits = rowValue > 0.0f ? 0xFFFFFFFFu : 0u;
+            } else {
+                float xs = (0.0f - rowValue) / a - 0.5f;
+                xs = std::min(std::max(xs, -1.0f), 33.0f);
+                if (a > 0.0f) {
+                    int first = std::min(std::max((int) std::floor(xs) + 1, 0), 32);
+                    bits = first >= 32 ? 0u : 0xFFFFFFFFu << first;
+                } else {
+                    int count = std::min(std::max((int) std::ceil(xs), 0), 32);
+                    bits = count == 0 ? 0u : 0xFFFFFFFFu >> (32 - count);
+                }
+            }
+            coverage[r] &= bits;
+        }
+    }
+}
+
+inline void MaskedOcclusionCuller::updateTile(Tile &tile, const uint32_t coverage[TILE_HEIGHT], float zTriangle) const {
+    // 没有覆盖新的像素、又不比工作层近的三角形只会把工作层推远，跳过
+    bool empty = true, nothingNew = true, full = true;
+    for (int r = 0; r < TILE_HEIGHT; r++) {
+        empty = empty && coverage[r] == 0;
+        nothingNew = nothingNew && (coverage[r] & ~tile.Mask[r]) == 0;
+    }
+    if (empty || (nothingNew && zTriangle >= tile.ZMax1))
+        return;
+    // 三角形比工作层近得多时丢掉工作层，让这个三角形开始新的工作层
+    if (tile.ZMax1 - zTriangle > tile.ZMax0 - tile.ZMax1) {
+        std::fill(tile.Mask, tile.Mask + TILE_HEIGHT, 0u);
+        tile.ZMax1 = 0.0f;
+    }
+    tile.ZMax1 = std::max(tile.ZMax1, zTriangle);
+    for (int r = 0; r < TILE_HEIGHT; r++) {
+        tile.Mask[r] |= coverage[r];
+        full = full && tile.Mask[r] == 0xFFFFFFFFu;
+    }
+    // 工作层覆盖了整个格子，合并成新的参考层
+    if (full) {
+        tile.ZMax0 = std::min(tile.ZMax0, tile.ZMax1);
+        tile.ZMax1 = 0.0f;
+        std::fill(tile.Mask, tile.Mask + TILE_HEIGHT, 0u);
+    }
+}
+
+inline bool MaskedOcclusionCuller::TestAABB(const AABB &box) const {
+    // 8个角点投影到低分辨率屏幕，取屏幕矩形和最近的深度；矩阵乘法按列展开，两条路径的运算顺序相同
+    const glm::mat4 &m = viewProjection;
+    float minX, minY, maxX, maxY, zMin;
+#if defined(LEARNOPENGL_OCCLUSION_CULLING_AVX2)
+    if (Simd) {
+        // 8个角点正好是8个通道
+        __m256 cx = _mm256_setr_ps(box.Min.x, box.Max.x, box.Min.x, box.Max.x, box.Min.x, box.Max.x, box.Min.x, box.Max.x);
+        __m256 cy = _mm256_setr_ps(box.Min.y, box.Min.y, box.Max.y, box.Max.y, box.Min.y, box.Min.y, box.Max.y, box.Max.y);
+        __m256 cz = _mm256_setr_ps(box.Min.z, box.Min.z, box.Min.z, box.Min.z, box.Max.z, box.Max.z, box.Max.z, box.Max.z);
+        __m256 clip[4];
+        for (int r = 0; r < 4; r++) {
+            __m256 v = _mm256_add_ps(_mm256_mul_ps(_mm256_set1_ps(m[0][r]), cx), _mm256_mul_ps(_mm256_set1_ps(m[1][r]), cy));
+            v = _mm256_add_ps(v, _mm256_mul_ps(_mm256_set1_ps(m[2][r]), cz));
+            clip[r] = _mm256_add_ps(v, _mm256_set1_ps(m[3][r]));
+        }
+        __m256 zero = _mm256_setzero_ps(), half = _mm256_set1_ps(0.5f);
+        __m256 behind = _mm256_or_ps(_mm256_cmp_ps(clip[2], _mm256_sub_ps(zero, clip[3]), _CMP_LT_OQ),
+                                     _mm256_cmp_ps(clip[3], zero, _CMP_LE_OQ));
+        if (_mm256_movemask_ps(behind))
+            return true;
+        __m256 invW = _mm256_div_ps(_mm256_set1_ps(1.0f), clip[3]);
+        __m256 x = _mm256_mul_ps(_mm256_add_ps(_mm256_mul_ps(_mm256_mul_ps(clip[0], invW), half), half), _mm256_set1_ps((float) width));
+        __m256 y = _mm256_mul_ps(_mm256_add_ps(_mm256_mul_ps(_mm256_mul_ps(clip[1], invW), half), half), _mm256_set1_ps((float) height));
+        __m256 z = _mm256_add_ps(_mm256_mul_ps(_mm256_mul_ps(clip[2], invW), half), half);
+        alignas(32) float lanes[3][8];
+        _mm256_store_ps(lanes[0], x);
+        _mm256_store_ps(lanes[1], y);
+        _mm256_store_ps(lanes[2], z);
+        minX = *std::min_element(lanes[0], lanes[0] + 8);
+        maxX = *std::max_element(lanes[0], lanes[0] + 8);
+        minY = *std::min_element(lanes[1], lanes[1] + 8);
+        maxY = *std::max_element(lanes[1], lanes[1] + 8);
+        zMin = *std::min_element(lanes[2], lanes[2] + 8);
+    } else
+#endif
+    {
+        minX = FLT_MAX, minY = FLT_MAX, maxX = -FLT_MAX, maxY = -FLT_MAX, zMin = FLT_MAX;
+        for (int i = 0; i < 8; i++) {
+            float cx = (i & 1) ? box.Max.x : box.Min.x, cy = (i & 2) ? box.Max.y : box.Min.y, cz = (i & 4) ? box.Max.z : box.Min.z;
+            float clip[4];
+            for (int r = 0; r < 4; r++)
+                clip[r] = ((m[0][r] * cx + m[1][r] * cy) + m[2][r] * cz) + m[3][r];
+            if (clip[2] < 0.0f - clip[3] || clip[3] <= 0.0f)
+                return true;
+            float invW = 1.0f / clip[3];
+            float x = (clip[0] * invW * 0.5f + 0.5f) * (float) width, y = (clip[1] * invW * 0.5f + 0.5f) * (float) height;
+            minX = std::min(minX, x);
+            maxX = std::max(maxX, x);
+            minY = std::min(minY, y);
+            maxY = std::max(maxY, y);
+            zMin = std::min(zMin, clip[2] * invW * 0.5f + 0.5f);
+        }
+    }
+    if (maxX <= 0.0f || maxY <= 0.0f || minX >= width || minY >= height)
+        return false;
+    // 矩形碰到的所有像素
+    int x0 = std::max((int) std::floor(minX), 0), x1 = std::min((int) std::ceil(maxX) - 1, width - 1);
+    int y0 = std::max((int) std::floor(minY), 0), y1 = std::min((int) std::ceil(maxY) - 1, height - 1);
+    return testRect(x0, y0, std::max(x0, x1), std::max(y0, y1), zMin);
+}
+
+// 像素矩形 [x0, x1] x [y0, y1] 中是否有深度上限大于 zMin 的像素
+inline bool MaskedOcclusionCuller::testRect(int x0, int y0, int x1, int y1, float zMin) const {
+    for (int ty = y0 / TILE_HEIGHT; ty <= y1 / TILE_HEIGHT; ty++) {
+        int r0 = std::max(y0 - ty * TILE_HEIGHT, 0), r1 = std::min(y1 - ty * TILE_HEIGHT, TILE_HEIGHT - 1);
+        for (int tx = x0 / TILE_WIDTH; tx <= x1 / TILE_WIDTH; tx++) {
+            const Tile &tile = tiles[ty * tilesX + tx];
+            if (zMin >= tile.ZMax0)
+                continue;
+            if (zMin < tile.ZMax1)
+                return true;
+            // 比参考层近、但不比工作层近：矩形内有不在工作层掩码中的像素就可能可见
+            int c0 = std::max(x0 - tx * TILE_WIDTH, 0), c1 = std::min(x1 - tx * TILE_WIDTH, TILE_WIDTH - 1);
+            uint32_t columns = (c1 - c0 + 1 >= 32 ? 0xFFFFFFFFu : ((1u << (c1 - c0 + 1)) - 1u)) << c0;
+#if defined(LEARNOPENGL_OCCLUSION_CULLING_AVX2)
+            if (Simd) {
+                const __m256i rowIndex = _mm256_setr_epi32(0, 1, 2, 3, 4, 5, 6, 7);
+                __m256i inRows = _mm256_and_si256(_mm256_cmpgt_epi32(rowIndex, _mm256_set1_epi32(r0 - 1)),
+                                                  _mm256_cmpgt_epi32(_mm256_set1_epi32(r1 + 1), rowIndex));
+                __m256i rect = _mm256_and_si256(inRows, _mm256_set1_epi32((int) columns));
+                __m256i mask = _mm256_loadu_si256((const __m256i *) tile.Mask);
+                if (!_mm256_testc_si256(mask, rect))
+                    return true;
+                continue;
+            }
+#endif
+            for (int r = r0; r <= r1; r++)
+                if (columns & ~tile.Mask[r])
+                    return true;
+        }
+    }
+    return false;
+}
+
+inline void MaskedOcclusionCuller::Test(const std::vector<AABB> &boxes, const std::vector<unsigned int> &candidates,
+                                        std::vector<unsigned int> &visible) {
+    auto start = std::chrono::high_resolution_clock::now();
+    std::vector<uint8_t> result(candidates.size());
+    unsigned int threads = threadCount(candidates.size() / 64 + 1);
+    pool.Run(threads, [&](unsigned int t) {
+        for (size_t i = candidates.size() * t / threads; i < candidates.size() * (t + 1) / threads; i++)
+            result[i] = TestAABB(boxes[candidates[i]]) ? 1 : 0;
+    });
+
+    visible.clear();
+    for (size_t i = 0; i < candidates.size(); i++)
+        if (result[i])
+            visible.push_back(candidates[i]);
+    stats.Tested = candidates.size();
+    stats.Culled = candidates.size() - visible.size();
+    stats.TestMs = std::chrono::duration<double, std::milli>(std::chrono::high_resolution_clock::now() - start).count();
+}
+
+inline void MaskedOcclusionCuller::CullAsync(const std::vector<Occluder> &occluders, const std::vector<AABB> &boxes,
+                                             const std::vector<unsigned int> &candidates, const glm::mat4 &vp) {
+    Wait();
+    {
+        std::lock_guard<std::mutex> lock(asyncMutex);
+        asyncJob = [this, &occluders, &boxes, &candidates, vp]() {
+            Clear();
+            RenderOccluders(occluders, vp);
+            Test(boxes, candidates, asyncVisible);
+        };
+        asyncPending = true;
+        if (!asyncThread.joinable())
+            asyncThread = std::thread(&MaskedOcclusionCuller::asyncLoop, this);
+    }
+    asyncCondition.notify_all();
+}
+
+inline const std::vector<unsigned int> &MaskedOcclusionCuller::Wait() {
+    std::unique_lock<std::mutex> lock(asyncMutex);
+    asyncCondition.wait(lock, [this]() { return !asyncPending; });
+    return asyncVisible;
+}
+
+inline bool MaskedOcclusionCuller::Pending() const {
+    std::lock_guard<std::mutex> lock(asyncMutex);
+    return asyncPending;
+}
+
+inline void MaskedOcclusionCuller::asyncLoop() {
+    std::unique_lock<std::mutex> lock(asyncMutex);
+    for (;;) {
+        asyncCondition.wait(lock, [this]() { return asyncPending || asyncQuit; });
+        if (!asyncPending)
+            return;
+        lock.unlock();
+        asyncJob();
+        lock.lock();
+        asyncPending = false;
+        asyncCondition.notify_all();
+    }
+}
+
+#endif // LEARNOPENGL_OCCLUSION_CULLING_H
@@ -0,0 +1,715 @@
+#ifndef LEARNOPENGL_PATH_TRACER_H
+#define LEARNOPENGL_PATH_TRACER_H
+
+#include <glm/glm.hpp>
+
+#include <vector>
+#include <thread>
+#include <atomic>
+#include <chrono>
+#include <cmath>
+#include <cfloat>
+#include <cstdint>
+#include <algorithm>
+#include <bitset>
+
+#include "bounds.h"
+#include "bvh.h"
+#include "software_rasterizer.h"
+
+#if defined(__AVX2__)
+#include <immintrin.h>
+#define LEARNOPENGL_PATH_TRACER_AVX2 1
+#endif
+
+// 上一次 Render 的统计
+struct PathTracerStats {
+    size_t Samples = 0;         // 这次增加的样本数（像素数 x 每像素样本数）
+    size_t PrimaryRays = 0;
+    size_t BounceRays = 0;      // 漫反射弹射的射线
+    size_t ShadowRays = 0;      // 朝太阳的可见性射线
+    double Ms = 0.0;
+
+    size_t Rays() const { return PrimaryRays + BounceRays + ShadowRays; }
+    double RaysPerSecond() const { return Ms > 0.0 ? Rays() / (Ms * 0.001) : 0.0; }
+};
+
+// CPU路径追踪器，用来在没有GPU的机器上生成示例场景的参考图像
+// 场景描述和 SoftwareRasterizer 相同：顶点是 位置xyz + 纹理坐标uv，模型矩阵 + SoftwareMaterial（两张纹理按 Mix 混合），
+// 摄像机就是示例里的 view、projection 矩阵，主射线从近平面出发，和OpenGL看到的范围一致；结果不做伽马校正，和示例的输出一致
+//
+// 表面是双面的朗伯体，反照率是材质的颜色；光照来自均匀的天空（SkyColor）和方向光（SunColor，用阴影射线直接采样），
+// 弹射方向按余弦分布采样，最多 MaxBounces 次；MaxBounces 为0时直接输出反照率，就是 6.1.coordinate_systems.fs 的结果
+//
+// 三角形上建分桶SAH的BVH，叶子里的三角形按SoA存放；有AVX2时：
+//   主射线按一行中连续的8个像素组成射线包，一起遍历BVH（8路的包围盒测试，每个通道一个活动掩码），叶子里每个三角形同时测试8条射线
+//   弹射和阴影射线是不相干的，单独遍历，叶子里一次测试8个三角形
+// 最近交点按 (t, 三角形编号) 比较，和遍历顺序无关，标量路径的每一步运算和AVX2路径相同，图像逐字节一致
+//
+// 渲染按 TILE_SIZE x TILE_SIZE 的格子分给所有线程，格子按编号动态领取；每个样本的随机数只由 Seed、像素和样本编号决定，
+// 结果和线程数、格子的领取顺序无关。Render 每次给所有像素增加样本，累计的结果可以随时读取（渐进式渲染）
+class PathTracer {
+public:
+    static const int TILE_SIZE = 16;
+
+    PathTracer(int width, int height);
+
+    void Resize(int width, int height);
+    // 使用的线程数，0表示所有硬件线程
+    unsigned int Threads = 0;
+    // 没有编译AVX2时总是用标量路径
+    bool Simd = true;
+    static bool HasAvx2();
+
+    // 场景，AddMesh 之后调用 Build 建BVH；纹理要一直有效
+    void ClearScene();
+    // vertices 每3个顶点组成一个三角形（GL_TRIANGLES），每个顶点5个float
+    void AddMesh(const float *vertices, unsigned int vertexCount, const glm::mat4 &model, const SoftwareMaterial &material);
+    void Build();
+    size_t TriangleCount() const { return triangleIds.size(); }
+
+    // 光照，修改后要调用 Reset
+    glm::vec3 SkyColor = glm::vec3(0.2f, 0.3f, 0.3f);
+    // 指向太阳的方向（世界空间），SunColor 为0时没有太阳
+    glm::vec3 SunDirection = glm::normalize(glm::vec3(0.4f, 1.0f, 0.3f));
+    glm::vec3 SunColor = glm::vec3(0.0f);
+    unsigned int MaxBounces = 3;
+    uint32_t Seed = 1;
+
+    // 设置摄像机并清空累计的样本
+    void SetCamera(const glm::mat4 &view, const glm::mat4 &projection);
+    void Reset();
+    // 给每个像素增加 samplesPerPixel 个样本
+    void Render(unsigned int samplesPerPixel = 1);
+    unsigned int SampleCount() const { return sampleCount; }
+
+    // 累计结果的平均值转成RGBA8，行从下往上，和 glReadPixels 的结果布局相同
+    void ReadPixels(std::vector<unsigned char> &rgba) const;
+    // 线性颜色，用来计算收敛误差
+    glm::vec3 Pixel(int x, int y) const;
+    const PathTracerStats &Stats() const { return stats; }
+
+    int Width() const { return width; }
+    int Height() const { return height; }
+
+private:
+    // SoA的9个分量：v0，边e1 = v1 - v0，边e2 = v2 - v0，和 MeshPicker 相同
+    enum Component { V0X, V0Y, V0Z, E1X, E1Y, E1Z, E2X, E2Y, E2Z, COMPONENT_COUNT };
+    static const unsigned int LANES = 8;
+    static const int STACK_SIZE = 64;
+
+    // 场景中的三角形（世界空间），Build 时按BVH叶子的顺序重新排列
+    struct SourceTriangle {
+        glm::vec3 P[3];
+        glm::vec2 UV[3];
+        unsigned int Material;
+    };
+    struct ShadingTriangle {
+        glm::vec3 Normal;
+        glm::vec2 UV0, UV1, UV2;
+        unsigned int Material;
+    };
+    struct Hit {
+        float T = FLT_MAX;
+        unsigned int Triangle = ~0u;
+        float U = 0.0f, V = 0.0f;
+    };
+    struct Rng {
+        uint32_t State;
+        float Next();
+    };
+    struct WorkerStats {
+        size_t Primary = 0, Bounce = 0, Shadow = 0;
+    };
+
+    int width, height;
+    int tilesX = 0, tilesY = 0;
+    std::vector<float> accumulation;    // 每个像素RGB三个float
+    unsigned int sampleCount = 0;
+    glm::mat4 inverseViewProjection = glm::mat4(1.0f);
+    PathTracerStats stats;
+
+    std::vector<SoftwareMaterial> materials;
+    std::vector<SourceTriangle> source;
+    BVH bvh;
+    std::vector<float> triangles[COMPONENT_COUNT];
+    std::vector<ShadingTriangle> shading;
+    std::vector<unsigned int> triangleIds;
+
+    void renderTile(int tile, unsigned int samplesPerPixel, WorkerStats &worker);
+    Ray primaryRay(int x, int y, Rng &rng) const;
+    glm::vec3 shade(const Ray &primary, const Hit &primaryHit, Rng &rng, WorkerStats &worker) const;
+    glm::vec3 albedo(const Hit &hit) const;
+
+    // 单条射线：最近交点，anyHit 为 true 时找到任何交点就返回
+    bool trace(const Ray &ray, Hit &hit, bool anyHit) const;
+    void intersectLeafScalar(const Ray &ray, unsigned int first, unsigned int count, Hit &hit) const;
+#if defined(LEARNOPENGL_PATH_TRACER_AVX2)
+    void intersectLeafAvx2(const Ray &ray, unsigned int first, unsigned int count, Hit &hit) const;
+    // 8条射线的射线包，mask 之外的通道不测试，结果写入 hits
+    void tracePacket(const Ray rays[LANES], unsigned int mask, Hit hits[LANES]) const;
+#endif
+};
+
+// 类定义
+// =================================================================================================
+
+namespace path_tracer_detail {
+    // 和 _mm256_min_ps、_mm256_max_ps 对NaN的处理相同：比较不成立时返回第二个参数
+    inline float minf(float a, float b) { return a < b ? a : b; }
+    inline float maxf(float a, float b) { return a > b ? a : b; }
+
+    // 射线和包围盒的slab测试，运算顺序和AVX2路径相同
+    inline bool slab(const glm::vec3 &origin, const glm::vec3 &invDir, const glm::vec3 &min, const glm::vec3 &max,
+                     float tMax, float &tEnter) {
+        float tNear[3], tFar[3];
+        for (int a = 0; a < 3; a++) {
+            float t0 = (min[a] - origin[a]) * invDir[a], t1 = (max[a] - origin[a]) * invDir[a];
+            tNear[a] = minf(t0, t1);
+            tFar[a] = maxf(t0, t1);
+        }
+        float enter = maxf(maxf(tNear[0], tNear[1]), maxf(tNear[2], 0.0f));
+        float exit = minf(minf(tFar[0], tFar[1]), minf(tFar[2], tMax));
+        tEnter = enter;
+        return enter <= exit;
+    }
+
+    // 按 (t, 三角形编号) 比较，和测试的顺序无关
+    inline bool closer(float t, unsigned int id, float tBest, unsigned int idBest) {
+        return t < tBest || (t == tBest && id < idBest);
+    }
+
+    // PCG 哈希，用来从种子、像素和样本编号得到每个样本独立的随机数序列
+    inline uint32_t hash(uint32_t v) {
+        uint32_t state = v * 747796405u + 2891336453u;
+        uint32_t word = ((state >> ((state >> 28u) + 4u)) ^ state) * 277803737u;
+        return (word >> 22u) ^ word;
+    }
+}
+
+inline float PathTracer::Rng::Next() {
+    State = path_tracer_detail::hash(State);
+    return (float) (State >> 8) * (1.0f / 16777216.0f);
+}
+
+inline PathTracer::PathTracer(int width, int height) : width(0), height(0) {
+    Resize(width, height);
+}
+
+inline void PathTracer::Resize(int w, int h) {
+    width = w;
+    height = h;
+    tilesX = (w + TILE_SIZE - 1) / TILE_SIZE;
+    tilesY = (h + TILE_SIZE - 1) / TILE_SIZE;
+    accumulation.assign((size_t) w * h * 3, 0.0f);
+    sampleCount = 0;
+}
+
+inline bool PathTracer::HasAvx2() {
+#if defined(LEARNOPENGL_PATH_TRACER_AVX2)
+    return true;
+#else
+    return false;
+#endif
+}
+
+inline void PathTracer::ClearScene() {
+    materials.clear();
+    source.clear();
+    shading.clear();
+    triangleIds.clear();
+    for (auto &component : triangles)
+        component.clear();
+    bvh = BVH();
+    Reset();
+}
+
+inline void PathTracer::AddMesh(const float *vertices, unsigned int vertexCount, const glm::mat4 &model, const SoftwareMaterial &material) {
+    unsigned int materialIndex = (unsigned int) materials.size();
+    materials.push_back(material);
+    for (unsigned int i = 0; i + 2 < vertexCount; i += 3) {
+        SourceTriangle tri;
+        for (int k = 0; k < 3; k++) {
+            const float *v = vertices + (size_t) (i + k) * 5;
+            tri.P[k] = glm::vec3(model * glm::vec4(v[0], v[1], v[2], 1.0f));
+            tri.UV[k] = glm::vec2(v[3], v[4]);
+        }
+        tri.Material = materialIndex;
+        source.push_back(tri);
+    }
+}
+
+inline void PathTracer::Build() {
+    std::vector<AABB> boxes(source.size());
+    for (size_t i = 0; i < source.size(); i++)
+        for (int k = 0; k < 3; k++)
+            boxes[i].Grow(source[i].P[k]);
+    // 叶子按8个一组测试，两条路径用同一棵树
+    bvh.PacketSize = LANES;
+    bvh.MaxLeafSize = LANES;
+    bvh.Build(boxes);
+
+    // 按BVH叶子的顺序存放三角形，末尾多留 LANES - 1 个空位，最后一个叶子整组读取时不会越界
+    triangleIds = bvh.Indices();
+    size_t n = triangleIds.size();
+    for (auto &component : triangles)
+        component.assign(n + LANES - 1, 0.0f);
+    shading.resize(n);
+    for (size_t i = 0; i < n; i++) {
+        const SourceTriangle &tri = source[triangleIds[i]];
+        glm::vec3 e1 = tri.P[1] - tri.P[0], e2 = tri.P[2] - tri.P[0];
+        triangles[V0X][i] = tri.P[0].x; triangles[V0Y][i] = tri.P[0].y; triangles[V0Z][i] = tri.P[0].z;
+        triangles[E1X][i] = e1.x; triangles[E1Y][i] = e1.y; triangles[E1Z][i] = e1.z;
+        triangles[E2X][i] = e2.x; triangles[E2Y][i] = e2.y; triangles[E2Z][i] = e2.z;
+        glm::vec3 normal = glm::cross(e1, e2);
+        float length = glm::length(normal);
+        shading[i].Normal = length > 0.0f ? normal / length : glm::vec3(0.0f, 1.0f, 0.0f);
+        shading[i].UV0 = tri.UV[0];
+        shading[i].UV1 = tri.UV[1];
+        shading[i].UV2 = tri.UV[2];
+        shading[i].Material = tri.Material;
+    }
+    Reset();
+}
+
+inline void PathTracer::SetCamera(const glm::mat4 &view, const glm::mat4 &projection) {
+    inverseViewProjection = glm::inverse(projection * view);
+    Reset();
+}
+
+inline void PathTracer::Reset() {
+    std::fill(accumulation.begin(), accumulation.end(), 0.0f);
+    sampleCount = 0;
+}
+
+inline void PathTracer::Render(unsigned int samplesPerPixel) {
+    auto start = std::chrono::high_resolution_clock::now();
+    unsigned int threads = Threads;
+    if (threads == 0)
+        threads = std::max(std::thread::hardware_concurrency(), 1u);
+    int tileCount = tilesX * tilesY;
+    threads = std::max(std::min(threads, (unsigned int) tileCount), 1u);
+
+    // 格子按编号动态领取，每个线程的统计最后求和
+    std::atomic<int> next(0);
+    std::vector<WorkerStats> workers(threads);
+    auto work = [this, &next, tileCount, samplesPerPixel](WorkerStats &worker) {
+        for (int tile = next++; tile < tileCount; tile = next++)
+            renderTile(tile, samplesPerPixel, worker);
+    };
+    std::vector<std::thread> pool;
+    for (unsigned int t = 1; t < threads; t++)
+        pool.emplace_back(work, std::ref(workers[t]));
+    work(workers[0]);
+    for (std::thread &thread : pool)
+        thread.join();
+    sampleCount += samplesPerPixel;
+
+    stats = PathTracerStats();
+    stats.Samples = (size_t) width * height * samplesPerPixel;
+    for (const WorkerStats &worker : workers) {
+        stats.PrimaryRays += worker.Primary;
+        stats.BounceRays += worker.Bounce;
+        stats.ShadowRays += worker.Shadow;
+    }
+    stats.Ms = std::chrono::duration<double, std::milli>(std::chrono::high_resolution_clock::now() - start).count();
+}
+
+inline Ray PathTracer::primaryRay(int x, int y, Rng &rng) const {
+    // 像素内随机抖动，多个样本平均后就是抗锯齿
+    float jx = rng.Next(), jy = rng.Next();
+    float nx = ((float) x + jx) / (float) width * 2.0f - 1.0f;
+    float ny = ((float) y + jy) / (float) height * 2.0f - 1.0f;
+    glm::vec4 nearPoint = inverseViewProjection * glm::vec4(nx, ny, -1.0f, 1.0f);
+    glm::vec4 farPoint = inverseViewProjection * glm::vec4(nx, ny, 1.0f, 1.0f);
+    glm::vec3 origin = glm::vec3(nearPoint) / nearPoint.w;
+    glm::vec3 target = glm::vec3(farPoint) / farPoint.w;
+    return Ray(origin, glm::normalize(target - origin));
+}
+
+inline void PathTracer::renderTile(int tile, unsigned int samplesPerPixel, WorkerStats &worker) {
+    int x0 = (tile % tilesX) * TILE_SIZE, y0 = (tile / tilesX) * TILE_SIZE;
+    int x1 = std::min(x0 + TILE_SIZE, width), y1 = std::min(y0 + TILE_SIZE, height);
+    for (unsigned int s = 0; s < samplesPerPixel; s++) {
+        uint32_t sample = sampleCount + s;
+        for (int y = y0; y < y1; y++) {
+            for (int x = x0; x < x1; x += LANES) {
+                int lanes = std::min((int) LANES, x1 - x);
+                Rng rng[LANES];
+                Ray rays[LANES];
+                Hit hits[LANES];
+                for (int l = 0; l < lanes; l++) {
+                    uint32_t pixel = (uint32_t) (y * width + x + l);
+                    rng[l].State = path_tracer_detail::hash(Seed ^ path_tracer_detail::hash(pixel ^ path_tracer_detail::hash(sample)));
+                    rays[l] = primaryRay(x + l, y, rng[l]);
+                }
+#if defined(LEARNOPENGL_PATH_TRACER_AVX2)
+                if (Simd)
+                    tracePacket(rays, (1u << lanes) - 1u, hits);
+                else
+#endif
+                {
+                    for (int l = 0; l < lanes; l++)
+                        trace(rays[l], hits[l], false);
+                }
+                worker.Primary += lanes;
+                for (int l = 0; l < lanes; l++) {
+                    glm::vec3 color = shade(rays[l], hits[l], rng[l], worker);
+                    float *sum = &accumulation[((size_t) y * width + x + l) * 3];
+                    sum[0] += color.x;
+                    sum[1] += color.y;
+                    sum[2] += color.z;
+                }
+            }
+        }
+    }
+}
+
+inline glm::vec3 PathTracer::albedo(const Hit &hit) const {
+    const ShadingTriangle &tri = shading[hit.Triangle];
+    glm::vec2 uv = tri.UV0 + (tri.UV1 - tri.UV0) * hit.U + (tri.UV2 - tri.UV0) * hit.V;
+    const SoftwareMaterial &material = materials[tri.Material];
+    float a[3], b[3];
+    software_rasterizer_detail::bilinear(*material.Texture1, uv.x, uv.y, a);
+    if (material.Texture2) {
+        software_rasterizer_detail::bilinear(*material.Texture2, uv.x, uv.y, b);
+        for (int c = 0; c < 3; c++)
+            a[c] = a[c] + (b[c] - a[c]) * material.Mix;
+    }
+    return glm::vec3(a[0], a[1], a[2]) * (1.0f / 255.0f);
+}
+
+inline glm::vec3 PathTracer::shade(const Ray &primary, const Hit &primaryHit, Rng &rng, WorkerStats &worker) const {
+    if (primaryHit.Triangle == ~0u)
+        return SkyColor;
+    if (MaxBounces == 0)
+        return albedo(primaryHit);
+
+    glm::vec3 radiance(0.0f), throughput(1.0f);
+    Ray ray = primary;
+    Hit hit = primaryHit;
+    bool hasSun = SunColor.x > 0.0f || SunColor.y > 0.0f || SunColor.z > 0.0f;
+    for (unsigned int bounce = 0;; bounce++) {
+        if (hit.Triangle == ~0u) {
+            radiance += throughput * SkyColor;
+            break;
+        }
+        glm::vec3 color = albedo(hit);
+        // 双面：法线翻到射线来的一侧
+        glm::vec3 normal = shading[hit.Triangle].Normal;
+        if (glm::dot(normal, ray.Direction) > 0.0f)
+            normal = -normal;
+        glm::vec3 point = ray.At(hit.T);
+        // 沿法线偏移一点，避免和自己相交
+        float scale = std::max(std::max(std::abs(point.x), std::abs(point.y)), std::max(std::abs(point.z), 1.0f));
+        point += normal * (1e-4f * scale);
+
+        if (hasSun) {
+            float nDotL = glm::dot(normal, SunDirection);
+            if (nDotL > 0.0f) {
+                Hit shadow;
+                worker.Shadow++;
+                if (!trace(Ray(point, SunDirection), shadow, true))
+                    radiance += throughput * color * SunColor * nDotL;
+            }
+        }
+        if (bounce >= MaxBounces)
+            break;
+
+        // 余弦分布采样，朗伯体的 BRDF * cos / pdf 正好是反照率
+        throughput *= color;
+        float r1 = rng.Next(), r2 = rng.Next();
+        float phi = 6.28318531f * r1, radius = std::sqrt(r2);
+        glm::vec3 helper = std::abs(normal.x) > 0.5f ? glm::vec3(0.0f, 1.0f, 0.0f) : glm::vec3(1.0f, 0.0f, 0.0f);
+        glm::vec3 tangent = glm::normalize(glm::cross(helper, normal));
+        glm::vec3 bitangent = glm::cross(normal, tangent);
+        glm::vec3 direction = tangent * (radius * std::cos(phi)) + bitangent * (radius * std::sin(phi)) +
+                              normal * std::sqrt(std::max(0.0f, 1.0f - r2));
+        ray = Ray(point, direction);
+        hit = Hit();
+        worker.Bounce++;
+        trace(ray, hit, false);
+    }
+    return radiance;
+}
+
+inline bool PathTracer::trace(const Ray &ray, Hit &hit, bool anyHit) const {
+    const std::vector<BVHNode> &nodes = bvh.Nodes();
+    if (nodes.empty())
+        return false;
+    glm::vec3 invDir = 1.0f / ray.Direction;
+    float tEnter;
+    if (!path_tracer_detail::slab(ray.Origin, invDir, nodes[0].Min, nodes[0].Max, hit.T, tEnter))
+        return false;
+
+    struct Entry { unsigned int Node; float TEnter; };
+    Entry stack[STACK_SIZE];
+    int top = 0;
+    stack[top++] = {0, tEnter};
+    while (top > 0) {
+        Entry entry = stack[--top];
+        // 入栈之后 T 可能已经被更近的交点缩短
+        if (entry.TEnter > hit.T)
+            continue;
+        const BVHNode &node = nodes[entry.Node];
+        if (node.IsLeaf()) {
+#if defined(LEARNOPENGL_PATH_TRACER_AVX2)
+            if (Simd)
+                intersectLeafAvx2(ray, node.LeftFirst, node.Count, hit);
+            else
+#endif
+                intersectLeafScalar(ray, node.LeftFirst, node.Count, hit);
+            if (anyHit && hit.Triangle != ~0u)
+                return true;
+            continue;
+        }
+        unsigned int closer = node.LeftFirst, further = node.LeftFirst + 1;
+        float tCloser, tFurther;
+        bool hitCloser = path_tracer_detail::slab(ray.Origin, invDir, nodes[closer].Min, nodes[closer].Max, hit.T, tCloser);
+        bool hitFurther = path_tracer_detail::slab(ray.Origin, invDir, nodes[further].Min, nodes[further].Max, hit.T, tFurther);
+        if (hitCloser && hitFurther && tFurther < tCloser) {
+            std::swap(closer, further);
+            std::swap(tCloser, tFurther);
+        }
+        // 先压远的，近的先出栈
+        if (hitFurther)
+            stack[top++] = {further, tFurther};
+        if (hitCloser)
+            stack[top++] = {closer, tCloser};
+    }
+    return hit.Triangle != ~0u;
+}
+
+// Möller-Trumbore，每一步和AVX2路径的运算顺序相同
+inline void PathTracer::intersectLeafScalar(const Ray &ray, unsigned int first, unsigned int count, Hit &hit) const {
+    const float dx = ray.Direction.x, dy = ray.Direction.y, dz = ray.Direction.z;
+    const float ox = ray.Origin.x, oy = ray.Origin.y, oz = ray.Origin.z;
+    for (unsigned int i = first; i < first + count; i++) {
+        float e1x = triangles[E1X][i], e1y = triangles[E1Y][i], e1z = triangles[E1Z][i];
+        float e2x = triangles[E2X][i], e2y = triangles[E2Y][i], e2z = triangles[E2Z][i];
+        float px = dy * e2z - dz * e2y, py = dz * e2x - dx * e2z, pz = dx * e2y - dy * e2x;
+        float det = (e1x * px + e1y * py) + e1z * pz;
+        float invDet = 1.0f / det;
+        float sx = ox - triangles[V0X][i], sy = oy - triangles[V0Y][i], sz = oz - triangles[V0Z][i];
+        float u = ((sx * px + sy * py) + sz * pz) * invDet;
+        float qx = sy * e1z - sz * e1y, qy = sz * e1x - sx * e1z, qz = sx * e1y - sy * e1x;
+        float v = ((dx * qx + dy * qy) + dz * qz) * invDet;
+        float t = ((e2x * qx + e2y * qy) + e2z * qz) * invDet;
+        if (det != 0.0f && u >= 0.0f && v >= 0.0f && u + v <= 1.0f && t > 0.0f &&
+            path_tracer_detail::closer(t, i, hit.T, hit.Triangle)) {
+            hit.T = t;
+            hit.Triangle = i;
+            hit.U = u;
+            hit.V = v;
+        }
+    }
+}
+
+#if defined(LEARNOPENGL_PATH_TRACER_AVX2)
+// 一条射线同时测试8个三角形，超出叶子范围的通道属于下一个叶子或末尾的空位，要屏蔽掉
+inline void PathTracer::intersectLeafAvx2(const Ray &ray, unsigned int first, unsigned int count, Hit &hit) const {
+    const __m256 zero = _mm256_setzero_ps(), one = _mm256_set1_ps(1.0f);
+    const __m256 dx = _mm256_set1_ps(ray.Direction.x), dy = _mm256_set1_ps(ray.Direction.y), dz = _mm256_set1_ps(ray.Direction.z);
+    const __m256 ox = _mm256_set1_ps(ray.Origin.x), oy = _mm256_set1_ps(ray.Origin.y), oz = _mm256_set1_ps(ray.Origin.z);
+    const __m256i laneIndex = _mm256_setr_epi32(0, 1, 2, 3, 4, 5, 6, 7);
+    for (unsigned int base = first; base < first + count; base += LANES) {
+        __m256 e1x = _mm256_loadu_ps(&triangles[E1X][base]), e1y = _mm256_loadu_ps(&triangles[E1Y][base]), e1z = _mm256_loadu_ps(&triangles[E1Z][base]);
+        __m256 e2x = _mm256_loadu_ps(&triangles[E2X][base]), e2y = _mm256_loadu_ps(&triangles[E2Y][base]), e2z = _mm256_loadu_ps(&triangles[E2Z][base]);
+        __m256 px = _mm256_sub_ps(_mm256_mul_ps(dy, e2z), _mm256_mul_ps(dz, e2y));
+        __m256 py = _mm256_sub_ps(_mm256_mul_ps(dz, e2x), _mm256_mul_ps(dx, e2z));
+        __m256 pz = _mm256_sub_ps(_mm256_mul_ps(dx, e2y), _mm256_mul_ps(dy, e2x));
+        __m256 det = _mm256_add_ps(_mm256_add_ps(_mm256_mul_ps(e1x, px), _mm256_mul_ps(e1y, py)), _mm256_mul_ps(e1z, pz));
+        __m256 invDet = _mm256_div_ps(one, det);
+        __m256 sx = _mm256_sub_ps(ox, _mm256_loadu_ps(&triangles[V0X][base]));
+        __m256 sy = _mm256_sub_ps(oy, _mm256_loadu_ps(&triangles[V0Y][base]));
+        __m256 sz = _mm256_sub_ps(oz, _mm256_loadu_ps(&triangles[V0Z][base]));
+        __m256 u = _mm256_mul_ps(_mm256_add_ps(_mm256_add_ps(_mm256_mul_ps(sx, px), _mm256_mul_ps(sy, py)), _mm256_mul_ps(sz, pz)), invDet);
+        __m256 qx = _mm256_sub_ps(_mm256_mul_ps(sy, e1z), _mm256_mul_ps(sz, e1y));
+        __m256 qy = _mm256_sub_ps(_mm256_mul_ps(sz, e1x), _mm256_mul_ps(sx, e1z));
+        __m256 qz = _mm256_sub_ps(_mm256_mul_ps(sx, e1y), _mm256_mul_ps(sy, e1x));
+        __m256 v = _mm256_mul_ps(_mm256_add_ps(_mm256_add_ps(_mm256_mul_ps(dx, qx), _mm256_mul_ps(dy, qy)), _mm256_mul_ps(dz, qz)), invDet);
+        __m256 t = _mm256_mul_ps(_mm256_add_ps(_mm256_add_ps(_mm256_mul_ps(e2x, qx), _mm256_mul_ps(e2y, qy)), _mm256_mul_ps(e2z, qz)), invDet);
+
+        __m256 valid = _mm256_castsi256_ps(_mm256_cmpgt_epi32(_mm256_set1_epi32((int) (first + count - base)), laneIndex));
+        valid = _mm256_and_ps(valid, _mm256_cmp_ps(det, zero, _CMP_NEQ_OQ));
+        valid = _mm256_and_ps(valid, _mm256_cmp_ps(u, zero, _CMP_GE_OQ));
+        valid = _mm256_and_ps(valid, _mm256_cmp_ps(v, zero, _CMP_GE_OQ));
+        valid = _mm256_and_ps(valid, _mm256_cmp_ps(_mm256_add_ps(u, v), one, _CMP_LE_OQ));
+        valid = _mm256_and_ps(valid, _mm256_cmp_ps(t, zero, _CMP_GT_OQ));
+        valid = _mm256_and_ps(valid, _mm256_cmp_ps(t, _mm256_set1_ps(hit.T), _CMP_LE_OQ));
+        int mask = _mm256_movemask_ps(valid);
+        if (!mask)
+            continue;
+        alignas(32) float ts[LANES], us[LANES], vs[LANES];
+        _mm256_store_ps(ts, t);
+        _mm256_store_ps(us, u);
+        _mm256_store_ps(vs, v);
+        for (unsigned int lane = 0; lane < LANES; lane++) {
+            if ((mask & (1 << lane)) && path_tracer_detail::closer(ts[lane], base + lane, hit.T, hit.Triangle)) {
+                hit.T = ts[lane];
+                hit.Triangle = base + lane;
+                hit.U = us[lane];
+                hit.V = vs[lane];
+            }
+        }
+    }
+}
+
+// 射线包遍历：每个通道的入栈、出栈判断和 trace 相同，只是8条射线共用一个栈；
+// 节点的远近按更多通道的判断排序，只影响访问顺序，不影响结果
+inline void PathTracer::tracePacket(const Ray rays[LANES], unsigned int mask, Hit hits[LANES]) const {
+    for (unsigned int l = 0; l < LANES; l++)
+        hits[l] = Hit();
+    const std::vector<BVHNode> &nodes = bvh.Nodes();
+    if (nodes.empty())
+        return;
+
+    alignas(32) float o[3][LANES], d[3][LANES], inv[3][LANES];
+    for (unsigned int l = 0; l < LANES; l++) {
+        // 不用的通道复制第一条射线，结果不写回
+        const Ray &ray = (mask & (1u << l)) ? rays[l] : rays[0];
+        glm::vec3 invDir = 1.0f / ray.Direction;
+        for (int a = 0; a < 3; a++) {
+            o[a][l] = ray.Origin[a];
+            d[a][l] = ray.Direction[a];
+            inv[a][l] = invDir[a];
+        }
+    }
+    const __m256 ox = _mm256_load_ps(o[0]), oy = _mm256_load_ps(o[1]), oz = _mm256_load_ps(o[2]);
+    const __m256 dx = _mm256_load_ps(d[0]), dy = _mm256_load_ps(d[1]), dz = _mm256_load_ps(d[2]);
+    const __m256 ix = _mm256_load_ps(inv[0]), iy = _mm256_load_ps(inv[1]), iz = _mm256_load_ps(inv[2]);
+    const __m256 zero = _mm256_setzero_ps(), one = _mm256_set1_ps(1.0f), infinity = _mm256_set1_ps(FLT_MAX);
+    const __m256i laneBits = _mm256_setr_epi32(1, 2, 4, 8, 16, 32, 64, 128);
+    __m256 active = _mm256_castsi256_ps(_mm256_cmpeq_epi32(_mm256_and_si256(_mm256_set1_epi32((int) mask), laneBits), laneBits));
+
+    __m256 tBest = infinity, uBest = zero, vBest = zero;
+    __m256i idBest = _mm256_set1_epi32(-1);
+
+    // 8条射线和一个节点的slab测试，返回命中的通道，enter 是进入距离
+    auto slab = [&](const BVHNode &node, __m256 lanes, __m256 &enter) {
+        __m256 t0x = _mm256_mul_ps(_mm256_sub_ps(_mm256_set1_ps(node.Min.x), ox), ix);
+        __m256 t1x = _mm256_mul_ps(_mm256_sub_ps(_mm256_set1_ps(node.Max.x), ox), ix);
+        __m256 t0y = _mm256_mul_ps(_mm256_sub_ps(_mm256_set1_ps(node.Min.y), oy), iy);
+        __m256 t1y = _mm256_mul_ps(_mm256_sub_ps(_mm256_set1_ps(node.Max.y), oy), iy);
+        __m256 t0z = _mm256_mul_ps(_mm256_sub_ps(_mm256_set1_ps(node.Min.z), oz), iz);
+        __m256 t1z = _mm256_mul_ps(_mm256_sub_ps(_mm256_set1_ps(node.Max.z), oz), iz);
+        __m256 nearX = _mm256_min_ps(t0x, t1x), farX = _mm256_max_ps(t0x, t1x);
+        __m256 nearY = _mm256_min_ps(t0y, t1y), farY = _mm256_max_ps(t0y, t1y);
+        __m256 nearZ = _mm256_min_ps(t0z, t1z), farZ = _mm256_max_ps(t0z, t1z);
+        enter = _mm256_max_ps(_mm256_max_ps(nearX, nearY), _mm256_max_ps(nearZ, zero));
+        __m256 exit = _mm256_min_ps(_mm256_min_ps(farX, farY), _mm256_min_ps(farZ, tBest));
+        return _mm256_and_ps(lanes, _mm256_cmp_ps(enter, exit, _CMP_LE_OQ));
+    };
+
+    // 栈里记录每个通道的进入距离，不活动的通道是 +inf（比任何 tBest 都大）
+    struct Entry { unsigned int Node; __m256 Enter; };
+    Entry stack[STACK_SIZE];
+    int top = 0;
+    const __m256 inactive = _mm256_set1_ps(INFINITY);
+    __m256 enter;
+    __m256 rootHit = slab(nodes[0], active, enter);
+    if (!_mm256_movemask_ps(rootHit))
+        return;
+    stack[top++] = {0, _mm256_blendv_ps(inactive, enter, rootHit)};
+    while (top > 0) {
+        Entry entry = stack[--top];
+        __m256 lanes = _mm256_cmp_ps(entry.Enter, tBest, _CMP_LE_OQ);
+        if (!_mm256_movemask_ps(lanes))
+            continue;
+        const BVHNode &node = nodes[entry.Node];
+        if (node.IsLeaf()) {
+            for (unsigned int i = node.LeftFirst; i < node.LeftFirst + node.Count; i++) {
+                __m256 e1x = _mm256_set1_ps(triangles[E1X][i]), e1y = _mm256_set1_ps(triangles[E1Y][i]), e1z = _mm256_set1_ps(triangles[E1Z][i]);
+                __m256 e2x = _mm256_set1_ps(triangles[E2X][i]), e2y = _mm256_set1_ps(triangles[E2Y][i]), e2z = _mm256_set1_ps(triangles[E2Z][i]);
+                __m256 px = _mm256_sub_ps(_mm256_mul_ps(dy, e2z), _mm256_mul_ps(dz, e2y));
+                __m256 py = _mm256_sub_ps(_mm256_mul_ps(dz, e2x), _mm256_mul_ps(dx, e2z));
+                __m256 pz = _mm256_sub_ps(_mm256_mul_ps(dx, e2y), _mm256_mul_ps(dy, e2x));
+                __m256 det = _mm256_add_ps(_mm256_add_ps(_mm256_mul_ps(e1x, px), _mm256_mul_ps(e1y, py)), _mm256_mul_ps(e1z, pz));
+                __m256 invDet = _mm256_div_ps(one, det);
+                __m256 sx = _mm256_sub_ps(ox, _mm256_set1_ps(triangles[V0X][i]));
+                __m256 sy = _mm256_sub_ps(oy, _mm256_set1_ps(triangles[V0Y][i]));
+                __m256 sz = _mm256_sub_ps(oz, _mm256_set1_ps(triangles[V0Z][i]));
+                __m256 u = _mm256_mul_ps(_mm256_add_ps(_mm256_add_ps(_mm256_mul_ps(sx, px), _mm256_mul_ps(sy, py)), _mm256_mul_ps(sz, pz)), invDet);
+                __m256 qx = _mm256_sub_ps(_mm256_mul_ps(sy, e1z), _mm256_mul_ps(sz, e1y));
+                __m256 qy = _mm256_sub_ps(_mm256_mul_ps(sz, e1x), _mm256_mul_ps(sx, e1z));
+                __m256 qz = _mm256_sub_ps(_mm256_mul_ps(sx, e1y), _mm256_mul_ps(sy, e1x));
+                __m256 v = _mm256_mul_ps(_mm256_add_ps(_mm256_add_ps(_mm256_mul_ps(dx, qx), _mm256_mul_ps(dy, qy)), _mm256_mul_ps(dz, qz)), invDet);
+                __m256 t = _mm256_mul_ps(_mm256_add_ps(_mm256_add_ps(_mm256_mul_ps(e2x, qx), _mm256_mul_ps(e2y, qy)), _mm256_mul_ps(e2z, qz)), invDet);
+
+                // 同一个三角形不会被一条射线测试两次，t 相等时编号更小才算更近
+                __m256i id = _mm256_set1_epi32((int) i);
+                __m256 closerId = _mm256_castsi256_ps(_mm256_cmpgt_epi32(_mm256_xor_si256(idBest, _mm256_set1_epi32(INT32_MIN)),
+                                                                         _mm256_xor_si256(id, _mm256_set1_epi32(INT32_MIN))));
+                __m256 closer = _mm256_or_ps(_mm256_cmp_ps(t, tBest, _CMP_LT_OQ),
+                                             _mm256_and_ps(_mm256_cmp_ps(t, tBest, _CMP_EQ_OQ), closerId));
+                __m256 valid = _mm256_and_ps(lanes, _mm256_cmp_ps(det, zero, _CMP_NEQ_OQ));
+                valid = _mm256_and_ps(valid, _mm256_cmp_ps(u, zero, _CMP_GE_OQ));
+                valid = _mm256_and_ps(valid, _mm256_cmp_ps(v, zero, _CMP_GE_OQ));
+                valid = _mm256_and_ps(valid, _mm256_cmp_ps(_mm256_add_ps(u, v), one, _CMP_LE_OQ));
+                valid = _mm256_and_ps(valid, _mm256_cmp_ps(t, zero, _CMP_GT_OQ));
+                valid = _mm256_and_ps(valid, closer);
+                tBest = _mm256_blendv_ps(tBest, t, valid);
+                uBest = _mm256_blendv_ps(uBest, u, valid);
+                vBest = _mm256_blendv_ps(vBest, v, valid);
+                idBest = _mm256_castps_si256(_mm256_blendv_ps(_mm256_castsi256_ps(idBest), _mm256_castsi256_ps(id), valid));
+            }
+            continue;
+        }
+        __m256 enterNear, enterFar;
+        unsigned int nearChild = node.LeftFirst, farChild = node.LeftFirst + 1;
+        __m256 hitNear = slab(nodes[nearChild], lanes, enterNear);
+        __m256 hitFar = slab(nodes[farChild], lanes, enterFar);
+        int maskNear = _mm256_movemask_ps(hitNear), maskFar = _mm256_movemask_ps(hitFar);
+        // 两个都命中的通道里，多数认为第二个孩子更近时交换
+        int swapVotes = _mm256_movemask_ps(_mm256_and_ps(_mm256_and_ps(hitNear, hitFar), _mm256_cmp_ps(enterFar, enterNear, _CMP_LT_OQ)));
+        int bothVotes = _mm256_movemask_ps(_mm256_and_ps(hitNear, hitFar));
+        if (2 * std::bitset<LANES>((unsigned int) swapVotes).count() > std::bitset<LANES>((unsigned int) bothVotes).count()) {
+            std::swap(nearChild, farChild);
+            std::swap(enterNear, enterFar);
+            std::swap(hitNear, hitFar);
+            std::swap(maskNear, maskFar);
+        }
+        if (maskFar)
+            stack[top++] = {farChild, _mm256_blendv_ps(inactive, enterFar, hitFar)};
+        if (maskNear)
+            stack[top++] = {nearChild, _mm256_blendv_ps(inactive, enterNear, hitNear)};
+    }
+
+    alignas(32) float ts[LANES], us[LANES], vs[LANES];
+    alignas(32) uint32_t ids[LANES];
+    _mm256_store_ps(ts, tBest);
+    _mm256_store_ps(us, uBest);
+    _mm256_store_ps(vs, vBest);
+    _mm256_store_si256((__m256i *) ids, idBest);
+    for (unsigned int l = 0; l < LANES; l++) {
+        if (!(mask & (1u << l)) || ids[l] == ~0u)
+            continue;
+        hits[l].T = ts[l];
+        hits[l].Triangle = ids[l];
+        hits[l].U = us[l];
+        hits[l].V = vs[l];
+    }
+}
+#endif
+
+inline glm::vec3 PathTracer::Pixel(int x, int y) const {
+    const float *sum = &accumulation[((size_t) y * width + x) * 3];
+    float scale = sampleCount > 0 ? 1.0f / (float) sampleCount : 0.0f;
+    return glm::vec3(sum[0], sum[1], sum[2]) * scale;
+}
+
+inline void PathTracer::ReadPixels(std::vector<unsigned char> &rgba) const {
+    rgba.resize((size_t) width * height * 4);
+    for (int y = 0; y < height; y++) {
+        for (int x = 0; x < width; x++) {
+            glm::vec3 c = glm::clamp(Pixel(x, y), glm::vec3(0.0f), glm::vec3(1.0f));
+            unsigned char *p = &rgba[((size_t) y * width + x) * 4];
+            p[0] = (unsigned char) (int) (c.x * 255.0f + 0.5f);
+            p[1] = (unsigned char) (int) (c.y * 255.0f + 0.5f);
+            p[2] = (unsigned char) (int) (c.z * 255.0f + 0.5f);
+            p[3] = 255;
+        }
+    }
+}
+
+#endif // LEARNOPENGL_PATH_TRACER_H
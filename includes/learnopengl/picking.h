@@ -0,0 +1,184 @@
+#ifndef LEARNOPENGL_PICKING_H
+#define LEARNOPENGL_PICKING_H
+
+#include <glm/glm.hpp>
+
+#include <learnopengl/bounds.h>
+#include <learnopengl/bvh.h>
+
+#include <vector>
+#include <atomic>
+#include <future>
+#include <cfloat>
+#include <cstddef>
+
+// 拾取结果，Distance以射线Direction的长度为单位
+struct PickHit {
+    bool Hit = false;
+    float Distance = FLT_MAX;
+    // 原始三角形编号（索引数组中的第几个三角形）
+    unsigned int Triangle = 0;
+    // 重心坐标，交点 = (1 - U - V) * v0 + U * v1 + V * v2
+    float U = 0.0f;
+    float V = 0.0f;
+    glm::vec3 Point = glm::vec3(0.0f);
+};
+
+// 三角形网格拾取：三角形包围盒建BVH，叶子里的三角形按SoA存放，逐个做Möller-Trumbore求交
+// 叶子只有几个三角形，时间主要花在遍历BVH上，一次测试4个三角形的SSE版本在 bench_picking 中测不出收益，所以只保留标量版本
+// 百万级三角形的模型可以用BuildAsync在后台线程建树，建完之前Pick直接返回未命中，不会卡住渲染循环
+class MeshPicker {
+public:
+    MeshPicker() = default;
+    MeshPicker(const MeshPicker &) = delete;
+    MeshPicker &operator=(const MeshPicker &) = delete;
+    ~MeshPicker();
+
+    // vertices是交错顶点数组，每个顶点stride个float，前3个float是位置；indices为空时每3个顶点组成一个三角形
+    void Build(const float *vertices, size_t vertexCount, size_t stride,
+               const unsigned int *indices = nullptr, size_t indexCount = 0);
+    void BuildAsync(std::vector<float> vertices, size_t stride, std::vector<unsigned int> indices = {});
+
+    bool Ready() const { return ready.load(std::memory_order_acquire); }
+    size_t TriangleCount() const { return Ready() ? triangleIds.size() : 0; }
+    AABB Bounds() const { return Ready() ? bvh.Bounds() : AABB(); }
+
+    // 物体空间射线的最近交点，maxDistance之外的交点忽略
+    PickHit Pick(const Ray &ray, float maxDistance = FLT_MAX) const;
+    // 世界空间射线，model为模型矩阵，返回的距离和交点都在世界空间
+    PickHit Pick(const Ray &worldRay, const glm::mat4 &model, float maxDistance = FLT_MAX) const;
+
+private:
+    // SoA的9个分量：v0，边e1 = v1 - v0，边e2 = v2 - v0
+    enum Component { V0X, V0Y, V0Z, E1X, E1Y, E1Z, E2X, E2Y, E2Z, COMPONENT_COUNT };
+
+    BVH bvh;
+    std::vector<float> triangles[COMPONENT_COUNT];
+    std::vector<unsigned int> triangleIds;
+    std::atomic<bool> ready{false};
+    std::future<void> pending;
+
+    void build(const float *vertices, size_t vertexCount, size_t stride,
+               const unsigned int *indices, size_t indexCount);
+    bool intersect(const Ray &ray, unsigned int first, unsigned int count, float &tMax, PickHit &hit) const;
+};
+
+// 类定义
+// =================================================================================================
+
+inline MeshPicker::~MeshPicker() {
+    if (pending.valid())
+        pending.wait();
+}
+
+inline void MeshPicker::Build(const float *vertices, size_t vertexCount, size_t stride,
+                              const unsigned int *indices, size_t indexCount) {
+    if (pending.valid())
+        pending.wait();
+    ready.store(false, std::memory_order_release);
+    build(vertices, vertexCount, stride, indices, indexCount);
+    ready.store(true, std::memory_order_release);
+}
+
+inline void MeshPicker::BuildAsync(std::vector<float> vertices, size_t stride, std::vector<unsigned int> indices) {
+    if (pending.valid())
+        pending.wait();
+    ready.store(false, std::memory_order_release);
+    // 数据移动到任务里，调用者的数组可以立即释放
+    pending = std::async(std::launch::async, [this, stride](std::vector<float> v, std::vector<unsigned int> i) {
+        build(v.data(), v.size() / stride, stride, i.empty() ? nullptr : i.data(), i.size());
+        ready.store(true, std::memory_order_release);
+    }, std::move(vertices), std::move(indices));
+}
+
+inline void MeshPicker::build(const float *vertices, size_t vertexCount, size_t stride,
+                              const unsigned int *indices, size_t indexCount) {
+    size_t triangleCount = indices ? indexCount / 3 : vertexCount / 3;
+    auto position = [&](size_t triangle, int corner) {
+        size_t vertex = indices ? indices[triangle * 3 + corner] : triangle * 3 + corner;
+        const float *p = vertices + vertex * stride;
+        return glm::vec3(p[0], p[1], p[2]);
+    };
+
+    std::vector<AABB> boxes(triangleCount);
+    for (size_t i = 0; i < triangleCount; i++) {
+        boxes[i].Grow(position(i, 0));
+        boxes[i].Grow(position(i, 1));
+        boxes[i].Grow(position(i, 2));
+    }
+    // SAH按4个三角形一组计算代价，叶子大一些、树浅一些，在 bench_picking 上比默认的叶子大小略快
+    bvh.PacketSize = 4;
+    bvh.MaxLeafSize = 8;
+    bvh.Build(boxes);
+
+    // 按BVH叶子的顺序存放三角形，每个叶子是SoA数组里的一段连续区间
+    const auto &order = bvh.Indices();
+    triangleIds = order;
+    for (auto &component : triangles)
+        component.assign(order.size(), 0.0f);
+    for (size_t i = 0; i < order.size(); i++) {
+        glm::vec3 v0 = position(order[i], 0);
+        glm::vec3 e1 = position(order[i], 1) - v0;
+        glm::vec3 e2 = position(order[i], 2) - v0;
+        triangles[V0X][i] = v0.x; triangles[V0Y][i] = v0.y; triangles[V0Z][i] = v0.z;
+        triangles[E1X][i] = e1.x; triangles[E1Y][i] = e1.y; triangles[E1Z][i] = e1.z;
+        triangles[E2X][i] = e2.x; triangles[E2Y][i] = e2.y; triangles[E2Z][i] = e2.z;
+    }
+}
+
+inline PickHit MeshPicker::Pick(const Ray &ray, float maxDistance) const {
+    PickHit hit;
+    if (!Ready())
+        return hit;
+    float tMax = maxDistance;
+    bvh.RaycastLeaves(ray, tMax, [&](unsigned int first, unsigned int count, float &t) {
+        return intersect(ray, first, count, t, hit);
+    });
+    if (hit.Hit)
+        hit.Point = ray.At(hit.Distance);
+    return hit;
+}
+
+inline PickHit MeshPicker::Pick(const Ray &worldRay, const glm::mat4 &model, float maxDistance) const {
+    // 方向不归一化，物体空间里的t和世界空间相同，有缩放的模型也不用换算距离
+    glm::mat4 invModel = glm::inverse(model);
+    Ray local(glm::vec3(invModel * glm::vec4(worldRay.Origin, 1.0f)),
+              glm::vec3(invModel * glm::vec4(worldRay.Direction, 0.0f)));
+    PickHit hit = Pick(local, maxDistance);
+    if (hit.Hit)
+        hit.Point = worldRay.At(hit.Distance);
+    return hit;
+}
+
+inline bool MeshPicker::intersect(const Ray &ray, unsigned int first, unsigned int count,
+                                  float &tMax, PickHit &hit) const {
+    bool any = false;
+    for (unsigned int i = first; i < first + count; i++) {
+        glm::vec3 v0(triangles[V0X][i], triangles[V0Y][i], triangles[V0Z][i]);
+        glm::vec3 e1(triangles[E1X][i], triangles[E1Y][i], triangles[E1Z][i]);
+        glm::vec3 e2(triangles[E2X][i], triangles[E2Y][i], triangles[E2Z][i]);
+
+        glm::vec3 p = glm::cross(ray.Direction, e2);
+        float det = glm::dot(e1, p);
+        if (det == 0.0f)
+            continue;
+        float invDet = 1.0f / det;
+        glm::vec3 s = ray.Origin - v0;
+        float u = glm::dot(s, p) * invDet;
+        glm::vec3 q = glm::cross(s, e1);
+        float v = glm::dot(ray.Direction, q) * invDet;
+        float t = glm::dot(e2, q) * invDet;
+        if (u >= 0.0f && v >= 0.0f && u + v <= 1.0f && t > 0.0f && t < tMax) {
+            tMax = t;
+            hit.Hit = true;
+            hit.Distance = t;
+            hit.Triangle = triangleIds[i];
+            hit.U = u;
+            hit.V = v;
+            any = true;
+        }
+    }
+    return any;
+}
+
+#endif // LEARNOPENGL_PICKING_H
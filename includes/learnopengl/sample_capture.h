@@ -0,0 +1,93 @@
+#ifndef LEARNOPENGL_SAMPLE_CAPTURE_H
+#define LEARNOPENGL_SAMPLE_CAPTURE_H
+
+#include <glad/glad.h>
+#include <GLFW/glfw3.h>
+
+#include <glm/glm.hpp>
+
+#include <cstdlib>
+#include <cstring>
+#include <iostream>
+#include <vector>
+
+#include <learnopengl/frame_capture.h>
+
+// 示例的截图模式：golden_images 用它驱动各章示例自己的渲染代码，而不是另写一份场景
+// 命令行：<示例> --capture <输出.png> [--time 秒] [--camera x y z yaw pitch zoom]
+//   窗口隐藏，动画时间固定为 --time，渲染循环只跑一帧：交换缓冲之前读回后缓冲写成PNG，然后关闭窗口
+//   --camera 给使用 Camera 类的示例设置摄像机，其他示例忽略
+// 没有 --capture 时示例的行为不变，Time() 就是 glfwGetTime()
+class SampleCapture {
+public:
+    const char *Path = nullptr;     // 为nullptr时不截图
+    float FixedTime = 0.0f;
+    bool HasCamera = false;
+    glm::vec3 CameraPosition = glm::vec3(0.0f);
+    float CameraYaw = 0.0f, CameraPitch = 0.0f, CameraZoom = 45.0f;
+
+    // 解析命令行，参数不完整或不认识时输出用法并返回false
+    bool Parse(int argc, char *argv[]);
+    bool Active() const { return Path != nullptr; }
+    // glfwCreateWindow 之前调用，截图模式下隐藏窗口
+    void WindowHints() const;
+    // 动画使用的时间，代替 glfwGetTime()
+    float Time() const { return Active() ? FixedTime : (float) glfwGetTime(); }
+    // 一帧渲染完成、glfwSwapBuffers 之前调用：截图模式下读回并写PNG，然后让渲染循环退出
+    void EndFrame(GLFWwindow *window);
+    // main 的返回值：写PNG失败时为 EXIT_FAILURE
+    int ExitCode() const { return failed ? EXIT_FAILURE : EXIT_SUCCESS; }
+
+private:
+    bool failed = false;
+};
+
+// 类定义
+// =================================================================================================
+
+inline bool SampleCapture::Parse(int argc, char *argv[]) {
+    for (int i = 1; i < argc; i++) {
+        if (std::strcmp(argv[i], "--capture") == 0 && i + 1 < argc) {
+            Path = argv[++i];
+        } else if (std::strcmp(argv[i], "--time") == 0 && i + 1 < argc) {
+            FixedTime = (float) std::atof(argv[++i]);
+        } else if (std::strcmp(argv[i], "--camera") == 0 && i + 6 < argc) {
+            HasCamera = true;
+            CameraPosition = glm::vec3((float) std::atof(argv[i + 1]), (float) std::atof(argv[i + 2]),
+                                       (float) std::atof(argv[i + 3]));
+            CameraYaw = (float) std::atof(argv[i + 4]);
+            CameraPitch = (float) std::atof(argv[i + 5]);
+            CameraZoom = (float) std::atof(argv[i + 6]);
+            i += 6;
+        } else {
+            std::cout << "usage: " << argv[0] << " [--capture <file.png> [--time <seconds>] "
+                      << "[--camera <x> <y> <z> <yaw> <pitch> <zoom>]]" << std::endl;
+            return false;
+        }
+    }
+    return true;
+}
+
+inline void SampleCapture::WindowHints() const {
+    if (Active())
+        glfwWindowHint(GLFW_VISIBLE, GLFW_FALSE);
+}
+
+inline void SampleCapture::EndFrame(GLFWwindow *window) {
+    if (!Active())
+        return;
+    int width, height;
+    glfwGetFramebufferSize(window, &width, &height);
+    std::vector<unsigned char> pixels((size_t) width * height * 4);
+    glBindFramebuffer(GL_READ_FRAMEBUFFER, 0);
+    glReadBuffer(GL_BACK);
+    glPixelStorei(GL_PACK_ALIGNMENT, 1);
+    glReadPixels(0, 0, width, height, GL_RGBA, GL_UNSIGNED_BYTE, pixels.data());
+    if (!WritePngRgba(Path, width, height, pixels.data(), true)) {
+        std::cout << "Failed to write " << Path << std::endl;
+        failed = true;
+    }
+    glfwSetWindowShouldClose(window, true);
+}
+
+#endif // LEARNOPENGL_SAMPLE_CAPTURE_H
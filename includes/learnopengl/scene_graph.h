@@ -0,0 +1,337 @@
+#ifndef LEARNOPENGL_SCENE_GRAPH_H
+#define LEARNOPENGL_SCENE_GRAPH_H
+
+#include <glm/glm.hpp>
+#include <glm/gtc/matrix_transform.hpp>
+#include <glm/gtc/quaternion.hpp>
+
+#include <vector>
+#include <algorithm>
+#include <cassert>
+#include <cstdint>
+
+// 调试版本中用失效的句柄（节点已经删除）读写节点时断言；有意测试失效句柄的程序可以在包含之前定义为0
+#ifndef LEARNOPENGL_SCENE_GRAPH_ASSERT_HANDLES
+#ifdef NDEBUG
+#define LEARNOPENGL_SCENE_GRAPH_ASSERT_HANDLES 0
+#else
+#define LEARNOPENGL_SCENE_GRAPH_ASSERT_HANDLES 1
+#endif
+#endif
+
+// 节点句柄：槽位编号 + 代数，节点删除后槽位的代数加一，旧句柄自动失效，不会指到复用槽位的新节点
+struct SceneHandle {
+    uint32_t Index = UINT32_MAX;
+    uint32_t Generation = 0;
+
+    bool operator==(const SceneHandle &other) const { return Index == other.Index && Generation == other.Generation; }
+    bool operator!=(const SceneHandle &other) const { return !(*this == other); }
+};
+
+// 层级场景图：节点按深度优先顺序存放在连续数组里，父节点总在子节点前面，每个节点的子树是一段连续区间
+// 世界矩阵在一次线性遍历中算完；修改一个节点只会重新计算它的子树
+// 删除、改父节点需要移动数组，是O(n)的；按深度优先顺序创建节点时总是追加在末尾，不需要移动
+// 所有接受句柄的函数都检查代数：失效的句柄不会读写复用了槽位的节点，Set* 什么都不做，
+// Get* 返回默认的变换（位置0、单位旋转、缩放1），World 返回单位矩阵，GetParent 返回空句柄
+class SceneGraph {
+public:
+    // parent是已经删除的节点时作为根节点创建
+    SceneHandle Create(const glm::vec3 &position = glm::vec3(0.0f), const glm::quat &rotation = glm::quat(),
+                       const glm::vec3 &scale = glm::vec3(1.0f), SceneHandle parent = SceneHandle());
+    // 删除节点和它的整棵子树；节点已经删除时什么都不做
+    void Destroy(SceneHandle node);
+    // 把节点连同子树挂到新的父节点下，parent为空句柄时变成根节点；不能挂到自己的子树里，也不能挂到已经删除的节点下
+    bool SetParent(SceneHandle node, SceneHandle parent);
+    bool Alive(SceneHandle node) const;
+
+    void SetPosition(SceneHandle node, const glm::vec3 &position);
+    void SetRotation(SceneHandle node, const glm::quat &rotation);
+    void SetScale(SceneHandle node, const glm::vec3 &scale);
+    glm::vec3 GetPosition(SceneHandle node) const;
+    glm::quat GetRotation(SceneHandle node) const;
+    glm::vec3 GetScale(SceneHandle node) const;
+    SceneHandle GetParent(SceneHandle node) const;
+
+    // 重新计算脏节点的子树，返回计算的节点数量
+    unsigned int Update();
+    const glm::mat4 &World(SceneHandle node) const;
+
+    // 深度优先顺序的世界矩阵，可以直接上传到实例缓冲；Update之后 [first, first + count) 以外的矩阵没有变化
+    const std::vector<glm::mat4> &WorldMatrices() const { return world; }
+    bool UpdatedRange(unsigned int &first, unsigned int &count) const;
+    unsigned int Count() const { return (unsigned int) nodes.size(); }
+    // 节点在 WorldMatrices() 中的下标，失效的句柄返回 UINT32_MAX
+    unsigned int DenseIndex(SceneHandle node) const { return dense(node); }
+    SceneHandle HandleAt(unsigned int denseIndex) const;
+
+private:
+    static const uint32_t INVALID = UINT32_MAX;
+
+    struct Node {
+        uint32_t Parent;        // 父节点在数组中的下标
+        uint32_t ParentSlot;    // 父节点的槽位，移动节点后用它恢复Parent
+        uint32_t SubtreeSize;   // 包括自己
+        uint32_t Slot;
+        bool Dirty;
+        glm::vec3 Position;
+        glm::quat Rotation;
+        glm::vec3 Scale;
+    };
+    struct Slot {
+        uint32_t Dense;
+        uint32_t Generation;
+    };
+
+    std::vector<Node> nodes;
+    std::vector<glm::mat4> world;
+    std::vector<Slot> slots;
+    std::vector<uint32_t> freeSlots;
+    // 被修改过的节点槽位，Update只处理这些节点的子树，不需要扫描整个数组
+    std::vector<uint32_t> dirtySlots;
+    std::vector<uint32_t> dirtyScratch;
+    unsigned int updatedFirst = 0;
+    unsigned int updatedLast = 0;
+    bool anyUpdated = false;
+    // 创建、删除、移动节点后，从这个下标开始的矩阵在数组里换了位置，下次Update要一起报告
+    uint32_t movedFirst = INVALID;
+
+    // 句柄对应的数组下标，失效的句柄返回INVALID
+    uint32_t dense(SceneHandle node) const;
+    void markDirty(uint32_t i);
+    void moveSubtree(uint32_t i, uint32_t parent);
+    void reindex(uint32_t begin);
+};
+
+// 类定义
+// =================================================================================================
+
+inline SceneHandle SceneGraph::Create(const glm::vec3 &position, const glm::quat &rotation,
+                                      const glm::vec3 &scale, SceneHandle parent) {
+    uint32_t slot;
+    if (!freeSlots.empty()) {
+        slot = freeSlots.back();
+        freeSlots.pop_back();
+    } else {
+        slot = (uint32_t) slots.size();
+        slots.push_back({INVALID, 0});
+    }
+    // 先作为根节点放到末尾，有父节点时再移动到父节点子树的末尾
+    uint32_t i = (uint32_t) nodes.size();
+    nodes.push_back({INVALID, INVALID, 1, slot, false, position, rotation, scale});
+    world.push_back(glm::mat4(1.0f));
+    slots[slot].Dense = i;
+    markDirty(i);
+
+    SceneHandle handle;
+    handle.Index = slot;
+    handle.Generation = slots[slot].Generation;
+    if (parent.Index != INVALID) {
+        uint32_t p = dense(parent);
+        if (p != INVALID)
+            moveSubtree(i, p);
+    }
+    return handle;
+}
+
+inline void SceneGraph::Destroy(SceneHandle node) {
+    if (!Alive(node))
+        return;
+    uint32_t i = dense(node);
+    uint32_t size = nodes[i].SubtreeSize;
+    for (uint32_t a = nodes[i].Parent; a != INVALID; a = nodes[a].Parent)
+        nodes[a].SubtreeSize -= size;
+    for (uint32_t k = i; k < i + size; k++) {
+        Slot &slot = slots[nodes[k].Slot];
+        slot.Dense = INVALID;
+        slot.Generation++;
+        freeSlots.push_back(nodes[k].Slot);
+    }
+    nodes.erase(nodes.begin() + i, nodes.begin() + i + size);
+    world.erase(world.begin() + i, world.begin() + i + size);
+    reindex(i);
+}
+
+inline bool SceneGraph::SetParent(SceneHandle node, SceneHandle parent) {
+    uint32_t i = dense(node);
+    if (i == INVALID)
+        return false;
+    if (parent.Index != INVALID) {
+        uint32_t p = dense(parent);
+        if (p == INVALID || (p >= i && p < i + nodes[i].SubtreeSize))
+            return false;
+        moveSubtree(i, p);
+    } else {
+        moveSubtree(i, INVALID);
+    }
+    return true;
+}
+
+inline bool SceneGraph::Alive(SceneHandle node) const {
+    return node.Index < slots.size() && slots[node.Index].Generation == node.Generation &&
+           slots[node.Index].Dense != INVALID;
+}
+
+inline uint32_t SceneGraph::dense(SceneHandle node) const {
+    bool alive = Alive(node);
+#if LEARNOPENGL_SCENE_GRAPH_ASSERT_HANDLES
+    assert(alive && "SceneHandle refers to a destroyed node");
+#endif
+    return alive ? slots[node.Index].Dense : INVALID;
+}
+
+inline glm::vec3 SceneGraph::GetPosition(SceneHandle node) const {
+    uint32_t i = dense(node);
+    return i == INVALID ? glm::vec3(0.0f) : nodes[i].Position;
+}
+
+inline glm::quat SceneGraph::GetRotation(SceneHandle node) const {
+    uint32_t i = dense(node);
+    return i == INVALID ? glm::quat() : nodes[i].Rotation;
+}
+
+inline glm::vec3 SceneGraph::GetScale(SceneHandle node) const {
+    uint32_t i = dense(node);
+    return i == INVALID ? glm::vec3(1.0f) : nodes[i].Scale;
+}
+
+inline const glm::mat4 &SceneGraph::World(SceneHandle node) const {
+    static const glm::mat4 identity(1.0f);
+    uint32_t i = dense(node);
+    return i == INVALID ? identity : world[i];
+}
+
+inline SceneHandle SceneGraph::GetParent(SceneHandle node) const {
+    uint32_t i = dense(node);
+    if (i == INVALID || nodes[i].Parent == INVALID)
+        return SceneHandle();
+    return HandleAt(nodes[i].Parent);
+}
+
+inline SceneHandle SceneGraph::HandleAt(unsigned int denseIndex) const {
+    SceneHandle handle;
+    if (denseIndex >= nodes.size())
+        return handle;
+    handle.Index = nodes[denseIndex].Slot;
+    handle.Generation = slots[handle.Index].Generation;
+    return handle;
+}
+
+inline void SceneGraph::SetPosition(SceneHandle node, const glm::vec3 &position) {
+    uint32_t i = dense(node);
+    if (i == INVALID)
+        return;
+    nodes[i].Position = position;
+    markDirty(i);
+}
+
+inline void SceneGraph::SetRotation(SceneHandle node, const glm::quat &rotation) {
+    uint32_t i = dense(node);
+    if (i == INVALID)
+        return;
+    nodes[i].Rotation = rotation;
+    markDirty(i);
+}
+
+inline void SceneGraph::SetScale(SceneHandle node, const glm::vec3 &scale) {
+    uint32_t i = dense(node);
+    if (i == INVALID)
+        return;
+    nodes[i].Scale = scale;
+    markDirty(i);
+}
+
+inline void SceneGraph::markDirty(uint32_t i) {
+    if (!nodes[i].Dirty) {
+        nodes[i].Dirty = true;
+        dirtySlots.push_back(nodes[i].Slot);
+    }
+}
+
+inline unsigned int SceneGraph::Update() {
+    anyUpdated = false;
+    if (movedFirst != INVALID && movedFirst < nodes.size()) {
+        updatedFirst = movedFirst;
+        updatedLast = (unsigned int) nodes.size() - 1;
+        anyUpdated = true;
+    }
+    movedFirst = INVALID;
+    if (dirtySlots.empty())
+        return 0;
+
+    // 槽位换成当前下标再排序，已删除的节点跳过；父节点在前，处理完一棵子树后，落在子树里的脏节点也跳过
+    dirtyScratch.clear();
+    for (uint32_t slot : dirtySlots)
+        if (slots[slot].Dense != INVALID)
+            dirtyScratch.push_back(slots[slot].Dense);
+    dirtySlots.clear();
+    std::sort(dirtyScratch.begin(), dirtyScratch.end());
+
+    unsigned int computed = 0;
+    uint32_t processedEnd = 0;
+    for (uint32_t i : dirtyScratch) {
+        if (i < processedEnd || !nodes[i].Dirty)
+            continue;
+        uint32_t end = i + nodes[i].SubtreeSize;
+        for (uint32_t k = i; k < end; k++) {
+            Node &node = nodes[k];
+            glm::mat4 local = glm::translate(glm::mat4(1.0f), node.Position) * glm::mat4_cast(node.Rotation);
+            local = glm::scale(local, node.Scale);
+            world[k] = node.Parent == INVALID ? local : world[node.Parent] * local;
+            node.Dirty = false;
+        }
+        updatedFirst = anyUpdated ? std::min(updatedFirst, i) : i;
+        updatedLast = anyUpdated ? std::max(updatedLast, end - 1) : end - 1;
+        anyUpdated = true;
+        computed += end - i;
+        processedEnd = end;
+    }
+    return computed;
+}
+
+inline bool SceneGraph::UpdatedRange(unsigned int &first, unsigned int &count) const {
+    if (!anyUpdated)
+        return false;
+    first = updatedFirst;
+    count = updatedLast - updatedFirst + 1;
+    return true;
+}
+
+// 把下标i开始的子树移动到parent子树的末尾（parent为INVALID时移动到数组末尾），用std::rotate整段搬移
+inline void SceneGraph::moveSubtree(uint32_t i, uint32_t parent) {
+    uint32_t size = nodes[i].SubtreeSize;
+    uint32_t slot = nodes[i].Slot;
+    uint32_t parentSlot = parent == INVALID ? INVALID : nodes[parent].Slot;
+    // 插入位置按移动前的子树大小计算：parent是i的祖先时，它的范围包括i的子树，rotate之后末尾正好是i的子树
+    uint32_t target = parent == INVALID ? (uint32_t) nodes.size() : parent + nodes[parent].SubtreeSize;
+    for (uint32_t a = nodes[i].Parent; a != INVALID; a = nodes[a].Parent)
+        nodes[a].SubtreeSize -= size;
+
+    uint32_t begin;
+    if (target > i) {
+        std::rotate(nodes.begin() + i, nodes.begin() + i + size, nodes.begin() + target);
+        std::rotate(world.begin() + i, world.begin() + i + size, world.begin() + target);
+        begin = i;
+    } else {
+        std::rotate(nodes.begin() + target, nodes.begin() + i, nodes.begin() + i + size);
+        std::rotate(world.begin() + target, world.begin() + i, world.begin() + i + size);
+        begin = target;
+    }
+    nodes[target <= i ? target : target - size].ParentSlot = parentSlot;
+    reindex(begin);
+
+    uint32_t moved = slots[slot].Dense;
+    for (uint32_t a = nodes[moved].Parent; a != INVALID; a = nodes[a].Parent)
+        nodes[a].SubtreeSize += size;
+    markDirty(moved);
+}
+
+// 从begin开始的节点下标变了，更新槽位表，再用父节点槽位恢复父节点下标
+inline void SceneGraph::reindex(uint32_t begin) {
+    movedFirst = std::min(movedFirst, begin);
+    for (uint32_t k = begin; k < nodes.size(); k++)
+        slots[nodes[k].Slot].Dense = k;
+    for (uint32_t k = begin; k < nodes.size(); k++)
+        nodes[k].Parent = nodes[k].ParentSlot == INVALID ? INVALID : slots[nodes[k].ParentSlot].Dense;
+}
+
+#endif // LEARNOPENGL_SCENE_GRAPH_H
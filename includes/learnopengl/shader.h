@@ -0,0 +1,40 @@
+#ifndef LEARNOPENGL_SHADER_H
+#define LEARNOPENGL_SHADER_H
+
+#include <glad/glad.h>  // 包含glad来获取所有的必须OpenGL头文件
+#include <glm/glm.hpp>
+
+#include <string>
+
+// 着色器程序：从文件读取顶点、片段（可选几何）着色器源码，编译并链接
+// 定义在 src/shader.cpp 中，随引擎库（liblearnopengl）一起编译，可以被任意多个翻译单元包含
+class Shader {
+public:
+    unsigned int ID;
+    // 参数分别是顶点着色器、片段着色器和几何着色器的源码路径，没有几何着色器时为nullptr
+    Shader(const char *vertexPath, const char *fragmentPath, const char *geometryPath = nullptr);
+    // 激活着色器程序
+    void use() const { glUseProgram(ID); }
+    // uniform工具函数
+    void setBool(const std::string &name, bool value) const;
+    void setInt(const std::string &name, int value) const;
+    void setFloat(const std::string &name, float value) const;
+
+    void setVec2(const std::string &name, const glm::vec2 &value) const;
+    void setVec2(const std::string &name, float x, float y) const;
+
+    void setVec3(const std::string &name, const glm::vec3 &value) const;
+    void setVec3(const std::string &name, float x, float y, float z) const;
+
+    void setVec4(const std::string &name, const glm::vec4 &value) const;
+    void setVec4(const std::string &name, float x, float y, float z, float w) const;
+
+    void setMat2(const std::string &name, const glm::mat2 &mat) const;
+    void setMat3(const std::string &name, const glm::mat3 &mat) const;
+    void setMat4(const std::string &name, const glm::mat4 &mat) const;
+
+private:
+    static void checkCompileErrors(unsigned int shader, const std::string &type);
+};
+
+#endif // LEARNOPENGL_SHADER_H
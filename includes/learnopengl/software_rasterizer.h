@@ -0,0 +1,621 @@
+#ifndef LEARNOPENGL_SOFTWARE_RASTERIZER_H
+#define LEARNOPENGL_SOFTWARE_RASTERIZER_H
+
+#include <glm/glm.hpp>
+
+#include <vector>
+#include <thread>
+#include <atomic>
+#include <cmath>
+#include <cstdint>
+#include <cstring>
+#include <algorithm>
+#include <bitset>
+
+#if defined(__AVX2__)
+#include <immintrin.h>
+#define LEARNOPENGL_SOFTWARE_RASTERIZER_AVX2 1
+#endif
+
+// 软件光栅化器用的纹理：RGBA8，行从下往上（和 stbi_set_flip_vertically_on_load(true) 加载的图片、OpenGL的纹理坐标一致）
+// 和示例中的纹理设置相同：GL_REPEAT 环绕、GL_LINEAR 过滤（只用第0层，示例里的 glGenerateMipmap 对 GL_LINEAR 没有作用）
+// 内部格式和示例一样是 GL_RGB：单通道图片只有红色，alpha 被丢掉
+class SoftwareTexture {
+public:
+    SoftwareTexture() = default;
+    // channels 是 stb_image 返回的通道数（1、3、4）
+    SoftwareTexture(const unsigned char *data, int width, int height, int channels);
+
+    int Width() const { return width; }
+    int Height() const { return height; }
+    // 每个纹素一个 uint32_t，字节顺序是 R、G、B、A
+    const uint32_t *Texels() const { return texels.data(); }
+
+private:
+    int width = 0, height = 0;
+    std::vector<uint32_t> texels;
+};
+
+// 片段着色，对应 6.1.coordinate_systems.fs：mix(texture(texture1, uv), texture(texture2, uv), Mix)
+// Texture2 为空时只采样 Texture1
+struct SoftwareMaterial {
+    const SoftwareTexture *Texture1 = nullptr;
+    const SoftwareTexture *Texture2 = nullptr;
+    float Mix = 0.2f;
+};
+
+// 上一次 Flush 的统计，包括它之前提交的 Draw
+struct SoftwareRasterizerStats {
+    size_t Triangles = 0;       // 提交的三角形
+    size_t Clipped = 0;         // 和近、远平面相交、被裁剪的三角形
+    size_t Culled = 0;          // 完全在视锥体外、退化或者不覆盖任何像素中心的三角形
+    size_t BinEntries = 0;      // 三角形和格子的配对数
+    size_t PixelsCovered = 0;   // 在三角形内的像素（深度测试之前）
+    size_t PixelsShaded = 0;    // 通过深度测试、写入颜色的像素
+};
+
+// CPU上的光栅化器，用来在没有GPU的机器上跑场景逻辑的基准测试和校验，也可以用来做遮挡剔除
+// 顶点格式和 6.1.coordinate_systems.vs 相同（位置xyz + 纹理坐标uv，每个顶点5个float），变换是 projection * view * model，
+// 深度范围是OpenGL默认的 [-1, 1] 映射到 [0, 1]，GL_LESS 深度测试，不剔除背面（和示例一致）
+//
+// Draw 在调用线程上完成顶点变换、近远平面裁剪和三角形设置，把三角形按包围盒分到 TILE_SIZE x TILE_SIZE 的格子里
+// （格子角上的边函数都为负的三角形不会分进去）；Flush 用多个线程按格子光栅化，每个格子由一个线程按提交顺序处理，
+// 结果和线程数无关，也和GL一样满足绘制顺序
+//
+// 光栅化用半平面边函数：顶点坐标先对齐到 1/256 像素，边函数的常数项用double在格子原点计算，格子内用float递增
+// 共享一条边的两个三角形算出的边函数正好互为相反数，再用左上规则决定边上的像素属于哪一个，不会有裂缝，也不会画两次
+// 有AVX2时一次处理一行中的8个像素：边函数、深度测试、透视校正插值、双线性采样（gather）、颜色和深度的写入都是8路的；
+// 标量路径的每一步运算和AVX2路径相同，两者的结果逐字节一致
+class SoftwareRasterizer {
+public:
+    static const int TILE_SIZE = 64;
+
+    SoftwareRasterizer(int width, int height);
+
+    void Resize(int width, int height);
+    // Flush 使用的线程数，0表示所有硬件线程
+    unsigned int Threads = 0;
+    // 没有编译AVX2时总是用标量路径
+    bool Simd = true;
+    static bool HasAvx2();
+
+    // 清空颜色和深度，实际的清空在 Flush 中由各个格子的线程完成
+    void Clear(const glm::vec4 &color, float depth = 1.0f);
+    // 之后的 Draw 使用的材质，纹理要在 Flush 之前一直有效
+    void SetMaterial(const SoftwareMaterial &material);
+    // vertices 每3个顶点组成一个三角形（GL_TRIANGLES）
+    void Draw(const float *vertices, unsigned int vertexCount, const glm::mat4 &model, const glm::mat4 &view, const glm::mat4 &projection);
+    // 光栅化所有提交的三角形，返回后可以读取结果
+    void Flush();
+
+    // RGBA8，行从下往上，和 glReadPixels 的结果布局相同
+    void ReadPixels(std::vector<unsigned char> &rgba) const;
+    float Depth(int x, int y) const { return depth[(size_t) y * stride + x]; }
+    const SoftwareRasterizerStats &Stats() const { return stats; }
+
+    int Width() const { return width; }
+    int Height() const { return height; }
+    int TilesX() const { return tilesX; }
+    int TilesY() const { return tilesY; }
+
+private:
+    // 裁剪空间的顶点
+    struct ClipVertex {
+        glm::vec4 Position;
+        glm::vec2 TexCoord;
+    };
+    // 设置好的三角形：三条边函数 E = A * x + B * y + C（在三角形内为正），
+    // 以及相对第一个顶点的属性平面 P = P0 + Px * (x - X0) + Py * (y - Y0)
+    struct Triangle {
+        float A[3], B[3];
+        double C[3];
+        bool Inclusive[3];          // 左上规则：E == 0 的像素是否属于这个三角形
+        int MinX, MinY, MaxX, MaxY; // 覆盖的像素范围（闭区间）
+        float X0, Y0;
+        float Z[3], Q[3], UQ[3], VQ[3]; // 深度、1/w、u/w、v/w 的平面：P0、Px、Py
+        unsigned int Material;
+    };
+    // 每个线程一份的统计
+    struct WorkerStats {
+        size_t Covered = 0, Shaded = 0;
+    };
+
+    int width, height;
+    int tilesX = 0, tilesY = 0;
+    int stride = 0;                 // 颜色和深度缓冲的行宽，补齐到格子的整数倍
+    std::vector<uint32_t> color;
+    std::vector<float> depth;
+
+    bool clearPending = false;
+    uint32_t clearColor = 0;
+    float clearDepth = 1.0f;
+
+    std::vector<SoftwareMaterial> materials;
+    std::vector<Triangle> triangles;
+    std::vector<std::vector<unsigned int>> bins;
+    SoftwareRasterizerStats pending;  // Draw 中累计，Flush 时和光栅化的统计一起变成 stats
+    SoftwareRasterizerStats stats;
+
+    void setupTriangle(const ClipVertex &v0, const ClipVertex &v1, const ClipVertex &v2);
+    void binTriangle(unsigned int index);
+    void rasterizeTile(int tile, WorkerStats &worker);
+    void rasterizeTriangleScalar(const Triangle &tri, int tileX, int tileY, WorkerStats &worker);
+#if defined(LEARNOPENGL_SOFTWARE_RASTERIZER_AVX2)
+    void rasterizeTriangleAvx2(const Triangle &tri, int tileX, int tileY, WorkerStats &worker);
+#endif
+};
+
+// 类定义
+// =================================================================================================
+
+inline SoftwareTexture::SoftwareTexture(const unsigned char *data, int width, int height, int channels)
+        : width(width), height(height), texels((size_t) width * height) {
+    for (size_t i = 0; i < texels.size(); i++) {
+        const unsigned char *p = data + i * channels;
+        uint32_t r = p[0];
+        uint32_t g = channels >= 3 ? p[1] : 0;
+        uint32_t b = channels >= 3 ? p[2] : 0;
+        texels[i] = r | (g << 8) | (b << 16) | 0xFF000000u;
+    }
+}
+
+namespace software_rasterizer_detail {
+    // GL_REPEAT：把整数纹素坐标（用float表示）折回 [0, size)，先按 1/size 取整，舍入误差导致的越界再修正一次
+    inline float wrap(float coord, float size, float invSize) {
+        float r = coord - std::floor(coord * invSize) * size;
+        r = r >= size ? r - size : r;
+        return r < 0.0f ? r + size : r;
+    }
+
+    // 双线性采样，结果是 [0, 255] 的RGB；每一步和 bilinearAvx2 相同
+    inline void bilinear(const SoftwareTexture &texture, float u, float v, float rgb[3]) {
+        float w = (float) texture.Width(), h = (float) texture.Height();
+        float x = u * w - 0.5f, y = v * h - 0.5f;
+        float x0 = std::floor(x), y0 = std::floor(y);
+        float fx = x - x0, fy = y - y0;
+        int ix0 = (int) wrap(x0, w, 1.0f / w), ix1 = (int) wrap(x0 + 1.0f, w, 1.0f / w);
+        int iy0 = (int) wrap(y0, h, 1.0f / h), iy1 = (int) wrap(y0 + 1.0f, h, 1.0f / h);
+        const uint32_t *texels = texture.Texels();
+        int row0 = iy0 * texture.Width(), row1 = iy1 * texture.Width();
+        uint32_t t00 = texels[row0 + ix0], t10 = texels[row0 + ix1], t01 = texels[row1 + ix0], t11 = texels[row1 + ix1];
+        for (int c = 0; c < 3; c++) {
+            int shift = c * 8;
+            float c00 = (float) ((t00 >> shift) & 0xFF), c10 = (float) ((t10 >> shift) & 0xFF);
+            float c01 = (float) ((t01 >> shift) & 0xFF), c11 = (float) ((t11 >> shift) & 0xFF);
+            float bottom = c00 + (c10 - c00) * fx;
+            float top = c01 + (c11 - c01) * fx;
+            rgb[c] = bottom + (top - bottom) * fy;
+        }
+    }
+
+    // 片段着色，返回打包好的RGBA8
+    inline uint32_t shade(const SoftwareMaterial &material, float u, float v) {
+        float a[3], b[3];
+        bilinear(*material.Texture1, u, v, a);
+        if (material.Texture2) {
+            bilinear(*material.Texture2, u, v, b);
+            for (int c = 0; c < 3; c++)
+                a[c] = a[c] + (b[c] - a[c]) * material.Mix;
+        }
+        uint32_t r = (uint32_t) (int) (a[0] + 0.5f), g = (uint32_t) (int) (a[1] + 0.5f), bl = (uint32_t) (int) (a[2] + 0.5f);
+        return r | (g << 8) | (bl << 16) | 0xFF000000u;
+    }
+
+    // 对一个裁剪平面做 Sutherland-Hodgman 裁剪，dist 在保留的一侧为正
+    template<typename Vertex, typename DistanceFunc>
+    void clipPolygon(const std::vector<Vertex> &in, std::vector<Vertex> &out, DistanceFunc dist) {
+        out.clear();
+        for (size_t i = 0; i < in.size(); i++) {
+            const Vertex &a = in[i], &b = in[(i + 1) % in.size()];
+            float da = dist(a), db = dist(b);
+            if (da >= 0.0f)
+                out.push_back(a);
+            if ((da >= 0.0f) != (db >= 0.0f)) {
+                float t = da / (da - db);
+                Vertex v;
+                v.Position = a.Position + (b.Position - a.Position) * t;
+                v.TexCoord = a.TexCoord + (b.TexCoord - a.TexCoord) * t;
+                out.push_back(v);
+            }
+        }
+    }
+
+#if defined(LEARNOPENGL_SOFTWARE_RASTERIZER_AVX2)
+    inline __m256 wrapAvx2(__m256 coord, __m256 size, __m256 invSize) {
+        __m256 r = _mm256_sub_ps(coord, _mm256_mul_ps(_mm256_floor_ps(_mm256_mul_ps(coord, invSize)), size));
+        r = _mm256_blendv_ps(r, _mm256_sub_ps(r, size), _mm256_cmp_ps(r, size, _CMP_GE_OQ));
+        return _mm256_blendv_ps(r, _mm256_add_ps(r, size), _mm256_cmp_ps(r, _mm256_setzero_ps(), _CMP_LT_OQ));
+    }
+
+    inline __m256 channelAvx2(__m256i texels, int shift) {
+        return _mm256_cvtepi32_ps(_mm256_and_si256(_mm256_srli_epi32(texels, shift), _mm256_set1_epi32(0xFF)));
+    }
+
+    // 8个像素的双线性采样，mask 之外的像素不读取纹理
+    inline void bilinearAvx2(const SoftwareTexture &texture, __m256 u, __m256 v, __m256i mask, __m256 rgb[3]) {
+        float wf = (float) texture.Width(), hf = (float) texture.Height();
+        __m256 w = _mm256_set1_ps(wf), h = _mm256_set1_ps(hf);
+        __m256 invW = _mm256_set1_ps(1.0f / wf), invH = _mm256_set1_ps(1.0f / hf);
+        __m256 half = _mm256_set1_ps(0.5f), one = _mm256_set1_ps(1.0f);
+        __m256 x = _mm256_sub_ps(_mm256_mul_ps(u, w), half), y = _mm256_sub_ps(_mm256_mul_ps(v, h), half);
+        __m256 x0 = _mm256_floor_ps(x), y0 = _mm256_floor_ps(y);
+        __m256 fx = _mm256_sub_ps(x, x0), fy = _mm256_sub_ps(y, y0);
+        __m256i ix0 = _mm256_cvttps_epi32(wrapAvx2(x0, w, invW)), ix1 = _mm256_cvttps_epi32(wrapAvx2(_mm256_add_ps(x0, one), w, invW));
+        __m256i iy0 = _mm256_cvttps_epi32(wrapAvx2(y0, h, invH)), iy1 = _mm256_cvttps_epi32(wrapAvx2(_mm256_add_ps(y0, one), h, invH));
+        __m256i width = _mm256_set1_epi32(texture.Width());
+        __m256i row0 = _mm256_mullo_epi32(iy0, width), row1 = _mm256_mullo_epi32(iy1, width);
+        const int *texels = (const int *) texture.Texels();
+        __m256i zero = _mm256_setzero_si256();
+        __m256i t00 = _mm256_mask_i32gather_epi32(zero, texels, _mm256_add_epi32(row0, ix0), mask, 4);
+        __m256i t10 = _mm256_mask_i32gather_epi32(zero, texels, _mm256_add_epi32(row0, ix1), mask, 4);
+        __m256i t01 = _mm256_mask_i32gather_epi32(zero, texels, _mm256_add_epi32(row1, ix0), mask, 4);
+        __m256i t11 = _mm256_mask_i32gather_epi32(zero, texels, _mm256_add_epi32(row1, ix1), mask, 4);
+        for (int c = 0; c < 3; c++) {
+            int shift = c * 8;
+            __m256 c00 = channelAvx2(t00, shift), c10 = channelAvx2(t10, shift);
+            __m256 c01 = channelAvx2(t01, shift), c11 = channelAvx2(t11, shift);
+            __m256 bottom = _mm256_add_ps(c00, _mm256_mul_ps(_mm256_sub_ps(c10, c00), fx));
+            __m256 top = _mm256_add_ps(c01, _mm256_mul_ps(_mm256_sub_ps(c11, c01), fx));
+            rgb[c] = _mm256_add_ps(bottom, _mm256_mul_ps(_mm256_sub_ps(top, bottom), fy));
+        }
+    }
+
+    inline __m256i shadeAvx2(const SoftwareMaterial &material, __m256 u, __m256 v, __m256i mask) {
+        __m256 a[3], b[3];
+        bilinearAvx2(*material.Texture1, u, v, mask, a);
+        if (material.Texture2) {
+            bilinearAvx2(*material.Texture2, u, v, mask, b);
+            __m256 t = _mm256_set1_ps(material.Mix);
+            for (int c = 0; c < 3; c++)
+                a[c] = _mm256_add_ps(a[c], _mm256_mul_ps(_mm256_sub_ps(b[c], a[c]), t));
+        }
+        __m256 half = _mm256_set1_ps(0.5f);
+        __m256i r = _mm256_cvttps_epi32(_mm256_add_ps(a[0], half));
+        __m256i g = _mm256_cvttps_epi32(_mm256_add_ps(a[1], half));
+        __m256i bl = _mm256_cvttps_epi32(_mm256_add_ps(a[2], half));
+        __m256i rgba = _mm256_or_si256(r, _mm256_or_si256(_mm256_slli_epi32(g, 8), _mm256_slli_epi32(bl, 16)));
+        return _mm256_or_si256(rgba, _mm256_set1_epi32((int) 0xFF000000u));
+    }
+#endif
+}
+
+inline SoftwareRasterizer::SoftwareRasterizer(int width, int height) : width(0), height(0) {
+    Resize(width, height);
+}
+
+inline bool SoftwareRasterizer::HasAvx2() {
+#if defined(LEARNOPENGL_SOFTWARE_RASTERIZER_AVX2)
+    return true;
+#else
+    return false;
+#endif
+}
+
+inline void SoftwareRasterizer::Resize(int newWidth, int newHeight) {
+    if (newWidth == width && newHeight == height)
+        return;
+    width = newWidth;
+    height = newHeight;
+    tilesX = (width + TILE_SIZE - 1) / TILE_SIZE;
+    tilesY = (height + TILE_SIZE - 1) / TILE_SIZE;
+    stride = tilesX * TILE_SIZE;
+    color.assign((size_t) stride * tilesY * TILE_SIZE, 0);
+    depth.assign((size_t) stride * tilesY * TILE_SIZE, 1.0f);
+    bins.assign((size_t) tilesX * tilesY, std::vector<unsigned int>());
+    triangles.clear();
+    materials.clear();
+}
+
+inline void SoftwareRasterizer::Clear(const glm::vec4 &c, float d) {
+    // 用double换算，0.3f * 255 这样正好在一半附近的值和GL的舍入一致
+    clearColor = 0;
+    for (int i = 0; i < 4; i++)
+        clearColor |= (uint32_t) (std::min(std::max((double) c[i], 0.0), 1.0) * 255.0 + 0.5) << (i * 8);
+    clearDepth = d;
+    clearPending = true;
+    // 清空之前提交的三角形都不会再显示
+    triangles.clear();
+    for (auto &bin : bins)
+        bin.clear();
+}
+
+inline void SoftwareRasterizer::SetMaterial(const SoftwareMaterial &material) {
+    materials.push_back(material);
+}
+
+inline void SoftwareRasterizer::Draw(const float *vertices, unsigned int vertexCount, const glm::mat4 &model,
+                                     const glm::mat4 &view, const glm::mat4 &projection) {
+    using namespace software_rasterizer_detail;
+    if (materials.empty() || !materials.back().Texture1)
+        return;
+    glm::mat4 mvp = projection * view * model;
+    std::vector<ClipVertex> polygon, temp;
+    for (unsigned int i = 0; i + 2 < vertexCount; i += 3) {
+        pending.Triangles++;
+        ClipVertex v[3];
+        for (int k = 0; k < 3; k++) {
+            const float *p = vertices + (i + k) * 5;
+            v[k].Position = mvp * glm::vec4(p[0], p[1], p[2], 1.0f);
+            v[k].TexCoord = glm::vec2(p[3], p[4]);
+        }
+        // 三个顶点都在同一个裁剪平面外
+        bool outside = false;
+        for (int axis = 0; axis < 3 && !outside; axis++) {
+            outside = (v[0].Position[axis] > v[0].Position.w && v[1].Position[axis] > v[1].Position.w && v[2].Position[axis] > v[2].Position.w) ||
+                      (v[0].Position[axis] < -v[0].Position.w && v[1].Position[axis] < -v[1].Position.w && v[2].Position[axis] < -v[2].Position.w);
+        }
+        if (outside) {
+            pending.Culled++;
+            continue;
+        }
+        // 只裁剪近、远平面，保证 w > 0；x、y 超出屏幕的部分由包围盒截掉
+        bool needsClip = false;
+        for (int k = 0; k < 3; k++)
+            needsClip = needsClip || v[k].Position.z < -v[k].Position.w || v[k].Position.z > v[k].Position.w;
+        if (!needsClip) {
+            setupTriangle(v[0], v[1], v[2]);
+            continue;
+        }
+        pending.Clipped++;
+        polygon.assign(v, v + 3);
+        clipPolygon(polygon, temp, [](const ClipVertex &c) { return c.Position.z + c.Position.w; });
+        clipPolygon(temp, polygon, [](const ClipVertex &c) { return c.Position.w - c.Position.z; });
+        for (size_t k = 2; k < polygon.size(); k++)
+            setupTriangle(polygon[0], polygon[k - 1], polygon[k]);
+    }
+}
+
+inline void SoftwareRasterizer::setupTriangle(const ClipVertex &c0, const ClipVertex &c1, const ClipVertex &c2) {
+    const ClipVertex *c[3] = {&c0, &c1, &c2};
+    float x[3], y[3], z[3], q[3], uq[3], vq[3];
+    for (int k = 0; k < 3; k++) {
+        const glm::vec4 &p = c[k]->Position;
+        q[k] = 1.0f / p.w;
+        // 视口变换，对齐到 1/256 像素
+        x[k] = std::round((p.x * q[k] * 0.5f + 0.5f) * width * 256.0f) * (1.0f / 256.0f);
+        y[k] = std::round((p.y * q[k] * 0.5f + 0.5f) * height * 256.0f) * (1.0f / 256.0f);
+        z[k] = p.z * q[k] * 0.5f + 0.5f;
+        uq[k] = c[k]->TexCoord.x * q[k];
+        vq[k] = c[k]->TexCoord.y * q[k];
+    }
+
+    double area = ((double) x[1] - x[0]) * ((double) y[2] - y[0]) - ((double) x[2] - x[0]) * ((double) y[1] - y[0]);
+    if (area == 0.0) {
+        pending.Culled++;
+        return;
+    }
+    // 顺时针的三角形交换两个顶点，边函数统一在内部为正
+    if (area < 0.0) {
+        std::swap(x[1], x[2]);
+        std::swap(y[1], y[2]);
+        std::swap(z[1], z[2]);
+        std::swap(q[1], q[2]);
+        std::swap(uq[1], uq[2]);
+        std::swap(vq[1], vq[2]);
+        area = -area;
+    }
+
+    Triangle tri;
+    // 像素中心在 (i + 0.5, j + 0.5)
+    float minX = std::min(x[0], std::min(x[1], x[2])), maxX = std::max(x[0], std::max(x[1], x[2]));
+    float minY = std::min(y[0], std::min(y[1], y[2])), maxY = std::max(y[0], std::max(y[1], y[2]));
+    tri.MinX = (int) std::max(std::ceil(minX - 0.5f), 0.0f);
+    tri.MinY = (int) std::max(std::ceil(minY - 0.5f), 0.0f);
+    tri.MaxX = (int) std::min(std::floor(maxX - 0.5f), (float) width - 1.0f);
+    tri.MaxY = (int) std::min(std::floor(maxY - 0.5f), (float) height - 1.0f);
+    if (tri.MinX > tri.MaxX || tri.MinY > tri.MaxY) {
+        pending.Culled++;
+        return;
+    }
+
+    for (int e = 0; e < 3; e++) {
+        int i = e, j = (e + 1) % 3;
+        tri.A[e] = y[i] - y[j];
+        tri.B[e] = x[j] - x[i];
+        tri.C[e] = (double) x[i] * y[j] - (double) x[j] * y[i];
+        tri.Inclusive[e] = tri.A[e] > 0.0f || (tri.A[e] == 0.0f && tri.B[e] < 0.0f);
+    }
+
+    tri.X0 = x[0];
+    tri.Y0 = y[0];
+    double dx1 = (double) x[1] - x[0], dy1 = (double) y[1] - y[0], dx2 = (double) x[2] - x[0], dy2 = (double) y[2] - y[0];
+    auto plane = [&](const float *a, float *p) {
+        double da1 = (double) a[1] - a[0], da2 = (double) a[2] - a[0];
+        p[0] = a[0];
+        p[1] = (float) ((da1 * dy2 - da2 * dy1) / area);
+        p[2] = (float) ((da2 * dx1 - da1 * dx2) / area);
+    };
+    plane(z, tri.Z);
+    plane(q, tri.Q);
+    plane(uq, tri.UQ);
+    plane(vq, tri.VQ);
+    tri.Material = (unsigned int) materials.size() - 1;
+
+    triangles.push_back(tri);
+    binTriangle((unsigned int) triangles.size() - 1);
+}
+
+inline void SoftwareRasterizer::binTriangle(unsigned int index) {
+    const Triangle &tri = triangles[index];
+    for (int ty = tri.MinY / TILE_SIZE; ty <= tri.MaxY / TILE_SIZE; ty++) {
+        for (int tx = tri.MinX / TILE_SIZE; tx <= tri.MaxX / TILE_SIZE; tx++) {
+            // 格子内像素中心的范围，每条边取边函数最大的角，为负说明整个格子都在这条边外
+            double x0 = tx * TILE_SIZE + 0.5, x1 = std::min((tx + 1) * TILE_SIZE, width) - 0.5;
+            double y0 = ty * TILE_SIZE + 0.5, y1 = std::min((ty + 1) * TILE_SIZE, height) - 0.5;
+            bool outside = false;
+            for (int e = 0; e < 3 && !outside; e++)
+                outside = tri.A[e] * (tri.A[e] > 0.0f ? x1 : x0) + tri.B[e] * (tri.B[e] > 0.0f ? y1 : y0) + tri.C[e] < 0.0;
+            if (outside)
+                continue;
+            bins[ty * tilesX + tx].push_back(index);
+            pending.BinEntries++;
+        }
+    }
+}
+
+inline void SoftwareRasterizer::Flush() {
+    unsigned int threads = Threads;
+    if (threads == 0)
+        threads = std::max(std::thread::hardware_concurrency(), 1u);
+    int tileCount = tilesX * tilesY;
+    threads = std::min(threads, (unsigned int) tileCount);
+
+    // 格子按编号动态领取，每个线程的统计最后求和
+    std::atomic<int> next(0);
+    std::vector<WorkerStats> workers(threads);
+    auto work = [this, &next, tileCount](WorkerStats &worker) {
+        for (int tile = next++; tile < tileCount; tile = next++)
+            rasterizeTile(tile, worker);
+    };
+    std::vector<std::thread> pool;
+    for (unsigned int t = 1; t < threads; t++)
+        pool.emplace_back(work, std::ref(workers[t]));
+    work(workers[0]);
+    for (std::thread &thread : pool)
+        thread.join();
+
+    stats = pending;
+    pending = SoftwareRasterizerStats();
+    for (const WorkerStats &worker : workers) {
+        stats.PixelsCovered += worker.Covered;
+        stats.PixelsShaded += worker.Shaded;
+    }
+    clearPending = false;
+    triangles.clear();
+    materials.erase(materials.begin(), materials.end() - std::min<size_t>(materials.size(), 1));
+    for (auto &bin : bins)
+        bin.clear();
+}
+
+inline void SoftwareRasterizer::rasterizeTile(int tile, WorkerStats &worker) {
+    int tileX = (tile % tilesX) * TILE_SIZE, tileY = (tile / tilesX) * TILE_SIZE;
+    if (clearPending) {
+        for (int y = 0; y < TILE_SIZE; y++) {
+            size_t row = (size_t) (tileY + y) * stride + tileX;
+            std::fill(color.begin() + row, color.begin() + row + TILE_SIZE, clearColor);
+            std::fill(depth.begin() + row, depth.begin() + row + TILE_SIZE, clearDepth);
+        }
+    }
+    for (unsigned int index : bins[tile]) {
+#if defined(LEARNOPENGL_SOFTWARE_RASTERIZER_AVX2)
+        if (Simd) {
+            rasterizeTriangleAvx2(triangles[index], tileX, tileY, worker);
+            continue;
+        }
+#endif
+        rasterizeTriangleScalar(triangles[index], tileX, tileY, worker);
+    }
+}
+
+// 一个三角形在一个格子内的部分，按行、每8个像素一组，和AVX2路径逐步对应
+inline void SoftwareRasterizer::rasterizeTriangleScalar(const Triangle &tri, int tileX, int tileY, WorkerStats &worker) {
+    using namespace software_rasterizer_detail;
+    const SoftwareMaterial &material = materials[tri.Material];
+    int x0 = std::max(tri.MinX, tileX) - tileX, x1 = std::min(tri.MaxX, tileX + TILE_SIZE - 1) - tileX;
+    int y0 = std::max(tri.MinY, tileY) - tileY, y1 = std::min(tri.MaxY, tileY + TILE_SIZE - 1) - tileY;
+    float edgeTile[3];
+    for (int e = 0; e < 3; e++)
+        edgeTile[e] = (float) (tri.A[e] * (tileX + 0.5) + tri.B[e] * (tileY + 0.5) + tri.C[e]);
+
+    for (int y = y0; y <= y1; y++) {
+        float edgeRow[3];
+        for (int e = 0; e < 3; e++)
+            edgeRow[e] = edgeTile[e] + tri.B[e] * (float) y;
+        float dy = (float) (tileY + y) + 0.5f - tri.Y0;
+        float zRow = tri.Z[0] + tri.Z[2] * dy, qRow = tri.Q[0] + tri.Q[2] * dy;
+        float uqRow = tri.UQ[0] + tri.UQ[2] * dy, vqRow = tri.VQ[0] + tri.VQ[2] * dy;
+        size_t row = (size_t) (tileY + y) * stride + tileX;
+        for (int x = x0 & ~7; x <= x1; x += 8) {
+            float dxBase = (float) (tileX + x) + 0.5f - tri.X0;
+            for (int k = 0; k < 8; k++) {
+                float fx = (float) (x + k);
+                bool inside = x + k <= x1;
+                for (int e = 0; e < 3 && inside; e++) {
+                    float edge = edgeRow[e] + tri.A[e] * fx;
+                    inside = tri.Inclusive[e] ? edge >= 0.0f : edge > 0.0f;
+                }
+                if (!inside)
+                    continue;
+                worker.Covered++;
+                float dx = dxBase + (float) k;
+                float z = zRow + tri.Z[1] * dx;
+                float &stored = depth[row + x + k];
+                if (!(z < stored))
+                    continue;
+                stored = z;
+                float w = 1.0f / (qRow + tri.Q[1] * dx);
+                float u = (uqRow + tri.UQ[1] * dx) * w, v = (vqRow + tri.VQ[1] * dx) * w;
+                color[row + x + k] = shade(material, u, v);
+                worker.Shaded++;
+            }
+        }
+    }
+}
+
+#if defined(LEARNOPENGL_SOFTWARE_RASTERIZER_AVX2)
+inline void SoftwareRasterizer::rasterizeTriangleAvx2(const Triangle &tri, int tileX, int tileY, WorkerStats &worker) {
+    using namespace software_rasterizer_detail;
+    const SoftwareMaterial &material = materials[tri.Material];
+    int x0 = std::max(tri.MinX, tileX) - tileX, x1 = std::min(tri.MaxX, tileX + TILE_SIZE - 1) - tileX;
+    int y0 = std::max(tri.MinY, tileY) - tileY, y1 = std::min(tri.MaxY, tileY + TILE_SIZE - 1) - tileY;
+    float edgeTile[3];
+    for (int e = 0; e < 3; e++)
+        edgeTile[e] = (float) (tri.A[e] * (tileX + 0.5) + tri.B[e] * (tileY + 0.5) + tri.C[e]);
+
+    const __m256 lanes = _mm256_setr_ps(0.0f, 1.0f, 2.0f, 3.0f, 4.0f, 5.0f, 6.0f, 7.0f);
+    const __m256 zero = _mm256_setzero_ps();
+    __m256 edgeA[3];
+    for (int e = 0; e < 3; e++)
+        edgeA[e] = _mm256_set1_ps(tri.A[e]);
+    __m256 zx = _mm256_set1_ps(tri.Z[1]), qx = _mm256_set1_ps(tri.Q[1]);
+    __m256 uqx = _mm256_set1_ps(tri.UQ[1]), vqx = _mm256_set1_ps(tri.VQ[1]);
+    __m256 lastX = _mm256_set1_ps((float) x1);
+
+    for (int y = y0; y <= y1; y++) {
+        __m256 edgeRow[3];
+        for (int e = 0; e < 3; e++)
+            edgeRow[e] = _mm256_set1_ps(edgeTile[e] + tri.B[e] * (float) y);
+        float dy = (float) (tileY + y) + 0.5f - tri.Y0;
+        __m256 zRow = _mm256_set1_ps(tri.Z[0] + tri.Z[2] * dy), qRow = _mm256_set1_ps(tri.Q[0] + tri.Q[2] * dy);
+        __m256 uqRow = _mm256_set1_ps(tri.UQ[0] + tri.UQ[2] * dy), vqRow = _mm256_set1_ps(tri.VQ[0] + tri.VQ[2] * dy);
+        size_t row = (size_t) (tileY + y) * stride + tileX;
+        for (int x = x0 & ~7; x <= x1; x += 8) {
+            __m256 fx = _mm256_add_ps(_mm256_set1_ps((float) x), lanes);
+            __m256 inside = _mm256_cmp_ps(fx, lastX, _CMP_LE_OQ);
+            for (int e = 0; e < 3; e++) {
+                __m256 edge = _mm256_add_ps(edgeRow[e], _mm256_mul_ps(edgeA[e], fx));
+                inside = _mm256_and_ps(inside, tri.Inclusive[e] ? _mm256_cmp_ps(edge, zero, _CMP_GE_OQ) : _mm256_cmp_ps(edge, zero, _CMP_GT_OQ));
+            }
+            int covered = _mm256_movemask_ps(inside);
+            if (!covered)
+                continue;
+            worker.Covered += (size_t) std::bitset<8>((unsigned int) covered).count();
+
+            __m256 dx = _mm256_add_ps(_mm256_set1_ps((float) (tileX + x) + 0.5f - tri.X0), lanes);
+            __m256 z = _mm256_add_ps(zRow, _mm256_mul_ps(zx, dx));
+            float *depthPtr = &depth[row + x];
+            __m256 pass = _mm256_and_ps(inside, _mm256_cmp_ps(z, _mm256_loadu_ps(depthPtr), _CMP_LT_OQ));
+            int shaded = _mm256_movemask_ps(pass);
+            if (!shaded)
+                continue;
+            worker.Shaded += (size_t) std::bitset<8>((unsigned int) shaded).count();
+            __m256i passMask = _mm256_castps_si256(pass);
+            _mm256_maskstore_ps(depthPtr, passMask, z);
+
+            __m256 w = _mm256_div_ps(_mm256_set1_ps(1.0f), _mm256_add_ps(qRow, _mm256_mul_ps(qx, dx)));
+            __m256 u = _mm256_mul_ps(_mm256_add_ps(uqRow, _mm256_mul_ps(uqx, dx)), w);
+            __m256 v = _mm256_mul_ps(_mm256_add_ps(vqRow, _mm256_mul_ps(vqx, dx)), w);
+            __m256i rgba = shadeAvx2(material, u, v, passMask);
+            _mm256_maskstore_epi32((int *) &color[row + x], passMask, rgba);
+        }
+    }
+}
+#endif
+
+inline void SoftwareRasterizer::ReadPixels(std::vector<unsigned char> &rgba) const {
+    rgba.resize((size_t) width * height * 4);
+    for (int y = 0; y < height; y++)
+        std::memcpy(&rgba[(size_t) y * width * 4], &color[(size_t) y * stride], (size_t) width * 4);
+}
+
+#endif // LEARNOPENGL_SOFTWARE_RASTERIZER_H
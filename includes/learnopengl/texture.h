@@ -0,0 +1,12 @@
+#ifndef LEARNOPENGL_TEXTURE_H
+#define LEARNOPENGL_TEXTURE_H
+
+#include <glad/glad.h>
+
+// 用stb_image加载图片，创建带mipmap的2D纹理，返回纹理ID；加载失败时输出错误并返回0
+// 格式按通道数选择（1：GL_RED，3：GL_RGB，4：GL_RGBA），缩小时用三线性过滤（GL_LINEAR_MIPMAP_LINEAR），放大时用线性过滤
+// flipVertically：图片的第一行是顶部，OpenGL纹理坐标的原点在底部，一般需要翻转
+// 定义在 src/texture.cpp 中，stb_image 的实现也只在引擎库中编译一次（src/stb_image.cpp）
+unsigned int LoadTexture(const char *path, bool flipVertically = true, GLint wrap = GL_REPEAT);
+
+#endif // LEARNOPENGL_TEXTURE_H
@@ -0,0 +1,298 @@
+#ifndef LEARNOPENGL_TRANSFORMS_H
+#define LEARNOPENGL_TRANSFORMS_H
+
+#include <glm/glm.hpp>
+#include <glm/gtc/quaternion.hpp>
+
+#include <vector>
+#include <algorithm>
+#include <cstdint>
+#include <cstring>
+#include <cstddef>
+
+#if defined(__AVX__)
+#include <immintrin.h>
+#define LEARNOPENGL_TRANSFORMS_AVX 1
+#endif
+#if defined(__SSE2__) || defined(_M_X64) || (defined(_M_IX86_FP) && _M_IX86_FP >= 2)
+#include <emmintrin.h>
+#define LEARNOPENGL_TRANSFORMS_SSE 1
+#endif
+
+// 批量变换：位置、旋转（四元数）、缩放按SoA存放，模型矩阵 = T * R * S
+// Update只重新计算标记为脏的物体，8个（AVX）或4个（SSE）一组计算，结果直接写到调用者给的内存，
+// 通常是映射出来的实例缓冲，每个矩阵16个float、列主序，和glm::mat4的内存布局相同
+class TransformSystem {
+public:
+    unsigned int Add(const glm::vec3 &position, const glm::quat &rotation = glm::quat(), const glm::vec3 &scale = glm::vec3(1.0f));
+    void Clear();
+    unsigned int Count() const { return count; }
+
+    void SetPosition(unsigned int i, const glm::vec3 &position);
+    void SetRotation(unsigned int i, const glm::quat &rotation);
+    void SetScale(unsigned int i, const glm::vec3 &scale);
+    glm::vec3 GetPosition(unsigned int i) const { return glm::vec3(px[i], py[i], pz[i]); }
+    glm::quat GetRotation(unsigned int i) const { return glm::quat(rw[i], rx[i], ry[i], rz[i]); }
+    glm::vec3 GetScale(unsigned int i) const { return glm::vec3(sx[i], sy[i], sz[i]); }
+    void MarkAllDirty();
+
+    unsigned int DirtyCount() const { return dirtyCount; }
+    // 脏物体的下标范围 [first, first + size)，没有脏物体时返回false；
+    // 调用者可以只映射这一段缓冲，然后把映射指针和first一起传给Update
+    bool DirtyRange(unsigned int &first, unsigned int &size) const;
+    // matrices指向第base个物体的矩阵，base不能大于DirtyRange返回的first，只写入脏物体，返回更新的矩阵数量
+    unsigned int Update(float *matrices, unsigned int base = 0);
+    // 不使用SIMD的版本，用于对比和校验
+    unsigned int UpdateScalar(float *matrices, unsigned int base = 0);
+
+private:
+    // SoA数组按LANES对齐补齐，补齐的部分是单位变换，整组读取不会越界
+    static const unsigned int LANES = 8;
+
+    unsigned int count = 0;
+    unsigned int dirtyCount = 0;
+    unsigned int dirtyFirst = 0;
+    unsigned int dirtyLast = 0;
+    std::vector<float> px, py, pz;
+    std::vector<float> rx, ry, rz, rw;
+    std::vector<float> sx, sy, sz;
+    std::vector<uint8_t> dirty;
+
+    void markDirty(unsigned int i);
+    void clearDirty();
+    static void compose(const float *p[3], const float *r[4], const float *s[3], unsigned int i, float *m);
+};
+
+// 类定义
+// =================================================================================================
+
+inline unsigned int TransformSystem::Add(const glm::vec3 &position, const glm::quat &rotation, const glm::vec3 &scale) {
+    unsigned int i = count++;
+    if (px.size() < count) {
+        size_t padded = (count + LANES - 1) / LANES * LANES;
+        for (auto *v : { &px, &py, &pz, &rx, &ry, &rz })
+            v->resize(padded, 0.0f);
+        for (auto *v : { &rw, &sx, &sy, &sz })
+            v->resize(padded, 1.0f);
+        dirty.resize(padded, 0);
+    }
+    px[i] = position.x; py[i] = position.y; pz[i] = position.z;
+    rx[i] = rotation.x; ry[i] = rotation.y; rz[i] = rotation.z; rw[i] = rotation.w;
+    sx[i] = scale.x; sy[i] = scale.y; sz[i] = scale.z;
+    markDirty(i);
+    return i;
+}
+
+inline void TransformSystem::Clear() {
+    count = 0;
+    for (auto *v : { &px, &py, &pz, &rx, &ry, &rz, &rw, &sx, &sy, &sz })
+        v->clear();
+    dirty.clear();
+    dirtyCount = 0;
+}
+
+inline void TransformSystem::SetPosition(unsigned int i, const glm::vec3 &position) {
+    px[i] = position.x; py[i] = position.y; pz[i] = position.z;
+    markDirty(i);
+}
+
+inline void TransformSystem::SetRotation(unsigned int i, const glm::quat &rotation) {
+    rx[i] = rotation.x; ry[i] = rotation.y; rz[i] = rotation.z; rw[i] = rotation.w;
+    markDirty(i);
+}
+
+inline void TransformSystem::SetScale(unsigned int i, const glm::vec3 &scale) {
+    sx[i] = scale.x; sy[i] = scale.y; sz[i] = scale.z;
+    markDirty(i);
+}
+
+inline void TransformSystem::MarkAllDirty() {
+    for (unsigned int i = 0; i < count; i++)
+        markDirty(i);
+}
+
+inline void TransformSystem::markDirty(unsigned int i) {
+    if (dirty[i])
+        return;
+    dirty[i] = 1;
+    if (dirtyCount == 0 || i < dirtyFirst)
+        dirtyFirst = i;
+    if (dirtyCount == 0 || i > dirtyLast)
+        dirtyLast = i;
+    dirtyCount++;
+}
+
+inline void TransformSystem::clearDirty() {
+    if (dirtyCount)
+        std::memset(&dirty[dirtyFirst], 0, dirtyLast - dirtyFirst + 1);
+    dirtyCount = 0;
+}
+
+inline bool TransformSystem::DirtyRange(unsigned int &first, unsigned int &size) const {
+    if (dirtyCount == 0)
+        return false;
+    first = dirtyFirst;
+    size = dirtyLast - dirtyFirst + 1;
+    return true;
+}
+
+inline void TransformSystem::compose(const float *p[3], const float *r[4], const float *s[3], unsigned int i, float *m) {
+    float x = r[0][i], y = r[1][i], z = r[2][i], w = r[3][i];
+    float xx = x * x, yy = y * y, zz = z * z;
+    float xy = x * y, xz = x * z, yz = y * z;
+    float wx = w * x, wy = w * y, wz = w * z;
+    m[0]  = (1.0f - 2.0f * (yy + zz)) * s[0][i];
+    m[1]  = 2.0f * (xy + wz) * s[0][i];
+    m[2]  = 2.0f * (xz - wy) * s[0][i];
+    m[3]  = 0.0f;
+    m[4]  = 2.0f * (xy - wz) * s[1][i];
+    m[5]  = (1.0f - 2.0f * (xx + zz)) * s[1][i];
+    m[6]  = 2.0f * (yz + wx) * s[1][i];
+    m[7]  = 0.0f;
+    m[8]  = 2.0f * (xz + wy) * s[2][i];
+    m[9]  = 2.0f * (yz - wx) * s[2][i];
+    m[10] = (1.0f - 2.0f * (xx + yy)) * s[2][i];
+    m[11] = 0.0f;
+    m[12] = p[0][i];
+    m[13] = p[1][i];
+    m[14] = p[2][i];
+    m[15] = 1.0f;
+}
+
+inline unsigned int TransformSystem::UpdateScalar(float *matrices, unsigned int base) {
+    if (dirtyCount == 0)
+        return 0;
+    const float *p[3] = { px.data(), py.data(), pz.data() };
+    const float *r[4] = { rx.data(), ry.data(), rz.data(), rw.data() };
+    const float *s[3] = { sx.data(), sy.data(), sz.data() };
+    unsigned int updated = 0;
+    for (unsigned int i = std::max(dirtyFirst, base); i <= dirtyLast; i++) {
+        if (!dirty[i])
+            continue;
+        compose(p, r, s, i, matrices + (size_t) (i - base) * 16);
+        updated++;
+    }
+    clearDirty();
+    return updated;
+}
+
+#if defined(LEARNOPENGL_TRANSFORMS_SSE)
+// 4个物体的矩阵元素（每个寄存器是同一个元素）转置成每个物体一列，只写脏的物体
+namespace transforms_detail {
+inline void storeColumns(__m128 c0, __m128 c1, __m128 c2, __m128 c3, const uint8_t *dirty, float *m, int column) {
+    _MM_TRANSPOSE4_PS(c0, c1, c2, c3);
+    if (dirty[0]) _mm_storeu_ps(m + column * 4, c0);
+    if (dirty[1]) _mm_storeu_ps(m + 16 + column * 4, c1);
+    if (dirty[2]) _mm_storeu_ps(m + 32 + column * 4, c2);
+    if (dirty[3]) _mm_storeu_ps(m + 48 + column * 4, c3);
+}
+
+inline void storeMatrices(const __m128 e[16], const uint8_t *dirty, float *m) {
+    for (int column = 0; column < 4; column++)
+        storeColumns(e[column * 4], e[column * 4 + 1], e[column * 4 + 2], e[column * 4 + 3], dirty, m, column);
+}
+}
+#endif
+
+inline unsigned int TransformSystem::Update(float *matrices, unsigned int base) {
+#if !defined(LEARNOPENGL_TRANSFORMS_SSE)
+    return UpdateScalar(matrices, base);
+#else
+    if (dirtyCount == 0)
+        return 0;
+    unsigned int updated = 0;
+    unsigned int first = std::max(dirtyFirst, base);
+    unsigned int start = first / LANES * LANES;
+    for (unsigned int g = start; g <= dirtyLast; g += LANES) {
+        uint64_t flags;
+        std::memcpy(&flags, &dirty[g], sizeof(flags));
+        if (!flags)
+            continue;
+        // base没有按组对齐时第一组的开头在matrices之前，这一组用标量算，保证不会写到matrices之前
+        if (g < base) {
+            const float *p[3] = { px.data(), py.data(), pz.data() };
+            const float *r[4] = { rx.data(), ry.data(), rz.data(), rw.data() };
+            const float *s[3] = { sx.data(), sy.data(), sz.data() };
+            for (unsigned int i = base; i < g + LANES && i <= dirtyLast; i++) {
+                if (dirty[i]) {
+                    compose(p, r, s, i, matrices + (size_t) (i - base) * 16);
+                    updated++;
+                }
+            }
+            continue;
+        }
+
+#if defined(LEARNOPENGL_TRANSFORMS_AVX)
+        const __m256 one = _mm256_set1_ps(1.0f);
+        const __m256 two = _mm256_set1_ps(2.0f);
+        __m256 x = _mm256_loadu_ps(&rx[g]), y = _mm256_loadu_ps(&ry[g]);
+        __m256 z = _mm256_loadu_ps(&rz[g]), w = _mm256_loadu_ps(&rw[g]);
+        __m256 scaleX = _mm256_loadu_ps(&sx[g]), scaleY = _mm256_loadu_ps(&sy[g]), scaleZ = _mm256_loadu_ps(&sz[g]);
+        __m256 xx = _mm256_mul_ps(x, x), yy = _mm256_mul_ps(y, y), zz = _mm256_mul_ps(z, z);
+        __m256 xy = _mm256_mul_ps(x, y), xz = _mm256_mul_ps(x, z), yz = _mm256_mul_ps(y, z);
+        __m256 wx = _mm256_mul_ps(w, x), wy = _mm256_mul_ps(w, y), wz = _mm256_mul_ps(w, z);
+        __m256 e[16];
+        e[0]  = _mm256_mul_ps(_mm256_sub_ps(one, _mm256_mul_ps(two, _mm256_add_ps(yy, zz))), scaleX);
+        e[1]  = _mm256_mul_ps(_mm256_mul_ps(two, _mm256_add_ps(xy, wz)), scaleX);
+        e[2]  = _mm256_mul_ps(_mm256_mul_ps(two, _mm256_sub_ps(xz, wy)), scaleX);
+        e[3]  = _mm256_setzero_ps();
+        e[4]  = _mm256_mul_ps(_mm256_mul_ps(two, _mm256_sub_ps(xy, wz)), scaleY);
+        e[5]  = _mm256_mul_ps(_mm256_sub_ps(one, _mm256_mul_ps(two, _mm256_add_ps(xx, zz))), scaleY);
+        e[6]  = _mm256_mul_ps(_mm256_mul_ps(two, _mm256_add_ps(yz, wx)), scaleY);
+        e[7]  = _mm256_setzero_ps();
+        e[8]  = _mm256_mul_ps(_mm256_mul_ps(two, _mm256_add_ps(xz, wy)), scaleZ);
+        e[9]  = _mm256_mul_ps(_mm256_mul_ps(two, _mm256_sub_ps(yz, wx)), scaleZ);
+        e[10] = _mm256_mul_ps(_mm256_sub_ps(one, _mm256_mul_ps(two, _mm256_add_ps(xx, yy))), scaleZ);
+        e[11] = _mm256_setzero_ps();
+        e[12] = _mm256_loadu_ps(&px[g]);
+        e[13] = _mm256_loadu_ps(&py[g]);
+        e[14] = _mm256_loadu_ps(&pz[g]);
+        e[15] = one;
+        // 高低两半各4个物体，分别转置写出
+        __m128 low[16], high[16];
+        for (int k = 0; k < 16; k++) {
+            low[k] = _mm256_castps256_ps128(e[k]);
+            high[k] = _mm256_extractf128_ps(e[k], 1);
+        }
+        float *m = matrices + (size_t) (g - base) * 16;
+        transforms_detail::storeMatrices(low, &dirty[g], m);
+        transforms_detail::storeMatrices(high, &dirty[g + 4], m + 64);
+#else
+        const __m128 one = _mm_set1_ps(1.0f);
+        const __m128 two = _mm_set1_ps(2.0f);
+        for (unsigned int h = g; h < g + LANES; h += 4) {
+            __m128 x = _mm_loadu_ps(&rx[h]), y = _mm_loadu_ps(&ry[h]);
+            __m128 z = _mm_loadu_ps(&rz[h]), w = _mm_loadu_ps(&rw[h]);
+            __m128 scaleX = _mm_loadu_ps(&sx[h]), scaleY = _mm_loadu_ps(&sy[h]), scaleZ = _mm_loadu_ps(&sz[h]);
+            __m128 xx = _mm_mul_ps(x, x), yy = _mm_mul_ps(y, y), zz = _mm_mul_ps(z, z);
+            __m128 xy = _mm_mul_ps(x, y), xz = _mm_mul_ps(x, z), yz = _mm_mul_ps(y, z);
+            __m128 wx = _mm_mul_ps(w, x), wy = _mm_mul_ps(w, y), wz = _mm_mul_ps(w, z);
+            __m128 e[16];
+            e[0]  = _mm_mul_ps(_mm_sub_ps(one, _mm_mul_ps(two, _mm_add_ps(yy, zz))), scaleX);
+            e[1]  = _mm_mul_ps(_mm_mul_ps(two, _mm_add_ps(xy, wz)), scaleX);
+            e[2]  = _mm_mul_ps(_mm_mul_ps(two, _mm_sub_ps(xz, wy)), scaleX);
+            e[3]  = _mm_setzero_ps();
+            e[4]  = _mm_mul_ps(_mm_mul_ps(two, _mm_sub_ps(xy, wz)), scaleY);
+            e[5]  = _mm_mul_ps(_mm_sub_ps(one, _mm_mul_ps(two, _mm_add_ps(xx, zz))), scaleY);
+            e[6]  = _mm_mul_ps(_mm_mul_ps(two, _mm_add_ps(yz, wx)), scaleY);
+            e[7]  = _mm_setzero_ps();
+            e[8]  = _mm_mul_ps(_mm_mul_ps(two, _mm_add_ps(xz, wy)), scaleZ);
+            e[9]  = _mm_mul_ps(_mm_mul_ps(two, _mm_sub_ps(yz, wx)), scaleZ);
+            e[10] = _mm_mul_ps(_mm_sub_ps(one, _mm_mul_ps(two, _mm_add_ps(xx, yy))), scaleZ);
+            e[11] = _mm_setzero_ps();
+            e[12] = _mm_loadu_ps(&px[h]);
+            e[13] = _mm_loadu_ps(&py[h]);
+            e[14] = _mm_loadu_ps(&pz[h]);
+            e[15] = one;
+            transforms_detail::storeMatrices(e, &dirty[h], matrices + (size_t) (h - base) * 16);
+        }
+#endif
+        for (unsigned int i = g; i < g + LANES; i++)
+            updated += dirty[i];
+    }
+    clearDirty();
+    return updated;
+#endif
+}
+
+#endif // LEARNOPENGL_TRANSFORMS_H
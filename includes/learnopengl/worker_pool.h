@@ -0,0 +1,91 @@
+#ifndef LEARNOPENGL_WORKER_POOL_H
+#define LEARNOPENGL_WORKER_POOL_H
+
+#include <condition_variable>
+#include <cstdint>
+#include <functional>
+#include <mutex>
+#include <thread>
+#include <vector>
+
+// 常驻的工作线程：每帧都要分几份并行执行的工作（遮挡剔除的光栅化和测试）不必每次调用都创建、销毁线程
+// Run(count, job) 在调用线程上执行 job(0)，job(1) ... job(count - 1) 交给工作线程，全部完成后返回
+// 工作线程在第一次需要时创建，之后一直等待下一次 Run；同一时间只能有一个线程调用 Run
+class WorkerPool {
+public:
+    WorkerPool() = default;
+    ~WorkerPool();
+    WorkerPool(const WorkerPool &) = delete;
+    WorkerPool &operator=(const WorkerPool &) = delete;
+
+    void Run(unsigned int count, const std::function<void(unsigned int)> &job);
+    // 已经创建的工作线程数，不包括调用线程
+    unsigned int Size() const { return (unsigned int) threads.size(); }
+
+private:
+    std::vector<std::thread> threads;
+    std::mutex mutex;
+    std::condition_variable started, finished;
+    const std::function<void(unsigned int)> *job = nullptr;
+    unsigned int jobCount = 0;
+    unsigned int remaining = 0;
+    uint64_t generation = 0;    // 每次 Run 加1，工作线程据此判断有没有新的工作
+    bool quit = false;
+
+    void loop(unsigned int worker, uint64_t seen);
+};
+
+// 类定义
+// =================================================================================================
+
+inline WorkerPool::~WorkerPool() {
+    {
+        std::lock_guard<std::mutex> lock(mutex);
+        quit = true;
+    }
+    started.notify_all();
+    for (std::thread &thread : threads)
+        thread.join();
+}
+
+inline void WorkerPool::Run(unsigned int count, const std::function<void(unsigned int)> &work) {
+    if (count == 0)
+        return;
+    {
+        std::lock_guard<std::mutex> lock(mutex);
+        // 新线程从当前的 generation 开始等待，不会把上一次 Run 当成新的工作
+        while (threads.size() + 1 < count)
+            threads.emplace_back(&WorkerPool::loop, this, (unsigned int) threads.size(), generation);
+        job = &work;
+        jobCount = count;
+        remaining = count - 1;
+        generation++;
+    }
+    started.notify_all();
+    work(0);
+    std::unique_lock<std::mutex> lock(mutex);
+    finished.wait(lock, [this]() { return remaining == 0; });
+    job = nullptr;
+}
+
+// 第 worker 个工作线程执行 job(worker + 1)，这次用不到它时继续等待
+inline void WorkerPool::loop(unsigned int worker, uint64_t seen) {
+    std::unique_lock<std::mutex> lock(mutex);
+    for (;;) {
+        started.wait(lock, [&]() { return quit || generation != seen; });
+        if (quit)
+            return;
+        seen = generation;
+        unsigned int index = worker + 1;
+        if (index >= jobCount)
+            continue;
+        const std::function<void(unsigned int)> *work = job;
+        lock.unlock();
+        (*work)(index);
+        lock.lock();
+        if (--remaining == 0)
+            finished.notify_one();
+    }
+}
+
+#endif // LEARNOPENGL_WORKER_POOL_H
@@ -0,0 +1,186 @@
+#include <learnopengl/camera.h>
+
+#include <cmath>
+
+Camera::Camera(glm::vec3 position, glm::vec3 up, float yaw, float pitch)
+        : front(glm::vec3(0.0f, 0.0f, -1.0f)), MovementSpeed(SPEED), MouseSensitivity(SENSITIVITY), Zoom(ZOOM) {
+    Position = position;
+    WorldUp = up;
+    Yaw = yaw;
+    Pitch = pitch;
+}
+
+Camera::Camera (float posX, float posY, float posZ, float upX, float upY, float upZ, float yaw, float pitch)
+        : front(glm::vec3(0.0f, 0.0f, -1.0f)), MovementSpeed(SPEED), MouseSensitivity(SENSITIVITY), Zoom(ZOOM) {
+    Position = glm::vec3(posX, posY, posZ);
+    WorldUp = glm::vec3(upX, upY, upZ);
+    Yaw = yaw;
+    Pitch = pitch;
+}
+
+const glm::mat4 &Camera::GetViewProjectionMatrix(float aspectRatio) const {
+    updateView();
+    updateProjection(aspectRatio);
+    if (!viewProjectionValid) {
+        viewProjection = projection * view;
+        viewProjectionValid = true;
+    }
+    return viewProjection;
+}
+
+glm::mat4 Camera::GetViewRotationMatrix() const {
+    glm::mat4 rotation = GetViewMatrix();
+    rotation[3] = glm::vec4(0.0f, 0.0f, 0.0f, 1.0f);
+    return rotation;
+}
+
+void Camera::RebaseOrigin() {
+    WorldOrigin += glm::dvec3(Position);
+    Position = glm::vec3(0.0f);
+}
+
+bool Camera::EnableReversedZ(bool useClipControl) {
+    // 深度范围是全局的GL状态，只要有glClipControl就显式设置，不依赖之前由哪个摄像机设置过
+    bool clipControl = GLAD_GL_VERSION_4_5 || GLAD_GL_ARB_clip_control;
+    ClipDepthZeroToOne = useClipControl && clipControl;
+    if (clipControl)
+        glClipControl(GL_LOWER_LEFT, ClipDepthZeroToOne ? GL_ZERO_TO_ONE : GL_NEGATIVE_ONE_TO_ONE);
+    glDepthFunc(GL_GREATER);
+    glClearDepth(0.0);
+    ReversedZ = true;
+    return ClipDepthZeroToOne;
+}
+
+void Camera::DisableReversedZ() {
+    if (GLAD_GL_VERSION_4_5 || GLAD_GL_ARB_clip_control)
+        glClipControl(GL_LOWER_LEFT, GL_NEGATIVE_ONE_TO_ONE);
+    glDepthFunc(GL_LESS);
+    glClearDepth(1.0);
+    ReversedZ = false;
+    ClipDepthZeroToOne = false;
+}
+
+void Camera::ProcessKeyboard(Camera_Movement direction, float deltaTime) {
+    updateCameraVectors();
+    float velocity = MovementSpeed * deltaTime;
+    if (direction == FORWARD)
+        Position += front * velocity;
+    if (direction == BACKWARD)
+        Position -= front * velocity;
+    if (direction == LEFT)
+        Position -= right * velocity;
+    if (direction == RIGHT)
+        Position += right * velocity;
+}
+
+void Camera::ProcessMouseMovement(float xoffset, float yoffset, GLboolean constrainPitch) {
+    xoffset *= MouseSensitivity;
+    yoffset *= MouseSensitivity;
+
+    Yaw   += xoffset;
+    Pitch += yoffset;
+
+    // Make sure that when pitch is out of bounds, screen doesn't get flipped
+    // 每个事件都要限制一次，和逐事件更新朝向时的结果一致
+    if (constrainPitch)
+    {
+        if (Pitch > 89.0f)
+            Pitch = 89.0f;
+        if (Pitch < -89.0f)
+            Pitch = -89.0f;
+    }
+    // 朝向在下次用到时才重新计算
+}
+
+void Camera::ProcessMouseScroll(float yoffset) {
+    if (Zoom >= 1.0f && Zoom <= 45.0f)
+        Zoom -= yoffset;
+    if (Zoom <= 1.0f)
+        Zoom = 1.0f;
+    if (Zoom >= 45.0f)
+        Zoom = 45.0f;
+}
+
+Ray Camera::ScreenPointToRay(float screenX, float screenY, float viewportWidth, float viewportHeight) const {
+    updateCameraVectors();
+    // 先转换到NDC，y轴向上
+    float ndcX = 2.0f * screenX / viewportWidth - 1.0f;
+    float ndcY = 1.0f - 2.0f * screenY / viewportHeight;
+    // 近平面上的点按透视投影的视场角和宽高比展开，不需要对投影矩阵求逆
+    float tanHalfFov = tan(glm::radians(Zoom) * 0.5f);
+    float aspect = viewportWidth / viewportHeight;
+    glm::vec3 direction = front + right * (ndcX * tanHalfFov * aspect) + up * (ndcY * tanHalfFov);
+    return Ray(Position, glm::normalize(direction));
+}
+
+void Camera::updateCameraVectors() const {
+    if (vectorsValid && vectorsYaw == Yaw && vectorsPitch == Pitch && vectorsWorldUp == WorldUp)
+        return;
+    // 先绕Z轴转Pitch，再绕Y轴转-Yaw，作用在+X上得到和欧拉角公式相同的Front：
+    // (cos(Yaw) * cos(Pitch), sin(Pitch), sin(Yaw) * cos(Pitch))
+    glm::quat q = glm::angleAxis(glm::radians(-Yaw), glm::vec3(0.0f, 1.0f, 0.0f)) *
+                  glm::angleAxis(glm::radians(Pitch), glm::vec3(0.0f, 0.0f, 1.0f));
+    front = glm::normalize(q * glm::vec3(1.0f, 0.0f, 0.0f));
+    // Also re-calculate the Right and Up vector
+    // 和原来一样由WorldUp叉乘得到，Pitch超过90度时的翻转行为也保持一致
+    right = glm::normalize(glm::cross(front, WorldUp));
+    up    = glm::normalize(glm::cross(right, front));
+    // 摄像机空间的 X、Y、-Z 分别对应 Right、Up、Front
+    orientation = glm::quat_cast(glm::mat3(right, up, -front));
+
+    vectorsYaw = Yaw;
+    vectorsPitch = Pitch;
+    vectorsWorldUp = WorldUp;
+    vectorsValid = true;
+    viewValid = false;
+}
+
+void Camera::updateView() const {
+    updateCameraVectors();
+    if (viewValid && viewPosition == Position)
+        return;
+    // 等价于 glm::lookAt(Position, Position + Front, Up)，基向量已经是正交归一的，不用再叉乘和归一化
+    view = glm::mat4(1.0f);
+    view[0][0] = right.x;  view[1][0] = right.y;  view[2][0] = right.z;
+    view[0][1] = up.x;     view[1][1] = up.y;     view[2][1] = up.z;
+    view[0][2] = -front.x; view[1][2] = -front.y; view[2][2] = -front.z;
+    view[3][0] = -glm::dot(right, Position);
+    view[3][1] = -glm::dot(up, Position);
+    view[3][2] = glm::dot(front, Position);
+    viewPosition = Position;
+    viewValid = true;
+    viewProjectionValid = false;
+}
+
+void Camera::updateProjection(float aspectRatio) const {
+    if (projectionValid && projectionZoom == Zoom && projectionAspect == aspectRatio &&
+        projectionNear == NearPlane && projectionFar == FarPlane &&
+        projectionReversedZ == ReversedZ && projectionZeroToOne == ClipDepthZeroToOne)
+        return;
+    if (ReversedZ) {
+        // 无穷远平面的反转深度投影，w = -z
+        // [0, 1]：z = near，深度 = near / -z，浮点深度缓冲的精度随距离按比例分布
+        // [-1, 1]：z = 2 * near + z_view，NDC深度 = 2 * near / -z - 1，窗口深度相同，但映射时会损失一部分精度
+        float f = 1.0f / tan(glm::radians(Zoom) * 0.5f);
+        projection = glm::mat4(0.0f);
+        projection[0][0] = f / aspectRatio;
+        projection[1][1] = f;
+        projection[2][3] = -1.0f;
+        if (ClipDepthZeroToOne) {
+            projection[3][2] = NearPlane;
+        } else {
+            projection[2][2] = 1.0f;
+            projection[3][2] = 2.0f * NearPlane;
+        }
+    } else {
+        projection = glm::perspective(glm::radians(Zoom), aspectRatio, NearPlane, FarPlane);
+    }
+    projectionZoom = Zoom;
+    projectionAspect = aspectRatio;
+    projectionNear = NearPlane;
+    projectionFar = FarPlane;
+    projectionReversedZ = ReversedZ;
+    projectionZeroToOne = ClipDepthZeroToOne;
+    projectionValid = true;
+    viewProjectionValid = false;
+}
@@ -0,0 +1,593 @@
+#include <learnopengl/cooked_mesh.h>
+
+#include <algorithm>
+#include <cmath>
+#include <cstring>
+#include <fstream>
+#include <unordered_map>
+
+static_assert(sizeof(CookedMeshHeader) == 136, "CookedMeshHeader must have no padding");
+static_assert(sizeof(CookedAttribute) == 5 * sizeof(uint32_t), "CookedAttribute must have no padding");
+static_assert(sizeof(CookedLod) == 5 * sizeof(uint32_t), "CookedLod must have no padding");
+static_assert(sizeof(CookedMeshlet) == 15 * sizeof(uint32_t), "CookedMeshlet must have no padding");
+
+namespace {
+
+const unsigned int COMPACT_STRIDE = 20;
+
+uint64_t alignUp(uint64_t offset) {
+    return (offset + COOKED_MESH_ALIGNMENT - 1) & ~(uint64_t) (COOKED_MESH_ALIGNMENT - 1);
+}
+
+// float转半精度，就近舍入到偶数，超出范围的变成无穷大
+uint16_t floatToHalf(float value) {
+    uint32_t x;
+    std::memcpy(&x, &value, sizeof(x));
+    uint32_t sign = (x >> 16) & 0x8000;
+    uint32_t mantissa = x & 0x7FFFFF;
+    int exponent = (int) ((x >> 23) & 0xFF) - 127 + 15;
+    if ((x & 0x7FFFFFFF) > 0x7F800000)
+        return (uint16_t) (sign | 0x7E00);
+    if (exponent >= 31)
+        return (uint16_t) (sign | 0x7C00);
+    if (exponent <= 0) {
+        // 非规格化数
+        if (exponent < -10)
+            return (uint16_t) sign;
+        mantissa |= 0x800000;
+        int shift = 14 - exponent;
+        uint32_t half = mantissa >> shift;
+        uint32_t rest = mantissa & ((1u << shift) - 1), halfway = 1u << (shift - 1);
+        if (rest > halfway || (rest == halfway && (half & 1)))
+            half++;
+        return (uint16_t) (sign | half);
+    }
+    uint32_t half = sign | ((uint32_t) exponent << 10) | (mantissa >> 13);
+    uint32_t rest = mantissa & 0x1FFF;
+    // 进位可能进到指数，结果仍然正确（最大的有限值进位后是无穷大）
+    if (rest > 0x1000 || (rest == 0x1000 && (half & 1)))
+        half++;
+    return (uint16_t) half;
+}
+
+// 单位向量打包成 GL_INT_2_10_10_10_REV：x在低10位，w为0
+uint32_t packNormal(const glm::vec3 &n) {
+    auto component = [](float v) {
+        return (uint32_t) ((int) std::lround(std::max(-1.0f, std::min(1.0f, v)) * 511.0f) & 0x3FF);
+    };
+    return component(n.x) | (component(n.y) << 10) | (component(n.z) << 20);
+}
+
+// 10位的三个分量交错成30位的Morton码
+uint32_t expandBits(uint32_t v) {
+    v = (v * 0x00010001u) & 0xFF0000FFu;
+    v = (v * 0x00000101u) & 0x0F00F00Fu;
+    v = (v * 0x00000011u) & 0xC30C30C3u;
+    v = (v * 0x00000005u) & 0x49249249u;
+    return v;
+}
+
+// 按网格单元聚类后的三角形：单元沿包围盒最长轴有 resolution 个，每个单元的顶点合并到最接近单元平均位置的原始顶点，
+// 丢掉退化的和重复的三角形
+std::vector<uint32_t> clusterTriangles(const ImportedMesh &mesh, float resolution, float &cellSize) {
+    glm::vec3 size = mesh.Bounds.Max - mesh.Bounds.Min;
+    cellSize = std::max(std::max(size.x, size.y), std::max(size.z, 1e-20f)) / resolution;
+    size_t vertexCount = mesh.Vertices.size();
+    std::vector<uint32_t> cellOf(vertexCount);
+    std::unordered_map<uint64_t, uint32_t> cells;
+    cells.reserve(vertexCount / 2);
+    std::vector<glm::vec3> sums;
+    std::vector<uint32_t> counts;
+    for (size_t i = 0; i < vertexCount; i++) {
+        glm::vec3 cell = (mesh.Vertices[i].Position - mesh.Bounds.Min) / cellSize;
+        uint64_t key = (uint64_t) std::min(cell.x, 2097151.0f) | (uint64_t) std::min(cell.y, 2097151.0f) << 21 |
+                       (uint64_t) std::min(cell.z, 2097151.0f) << 42;
+        auto inserted = cells.emplace(key, (uint32_t) sums.size());
+        if (inserted.second) {
+            sums.push_back(glm::vec3(0.0f));
+            counts.push_back(0);
+        }
+        uint32_t id = inserted.first->second;
+        cellOf[i] = id;
+        sums[id] += mesh.Vertices[i].Position;
+        counts[id]++;
+    }
+    std::vector<uint32_t> representative(sums.size(), 0);
+    std::vector<float> best(sums.size(), INFINITY);
+    for (size_t i = 0; i < vertexCount; i++) {
+        uint32_t id = cellOf[i];
+        glm::vec3 d = mesh.Vertices[i].Position - sums[id] / (float) counts[id];
+        float distance = glm::dot(d, d);
+        if (distance < best[id]) {
+            best[id] = distance;
+            representative[id] = (uint32_t) i;
+        }
+    }
+
+    // 三角形旋转到最小的顶点在前（不改变绕向），排序后去重
+    struct Triangle {
+        uint32_t v[3];
+        bool operator<(const Triangle &o) const { return std::lexicographical_compare(v, v + 3, o.v, o.v + 3); }
+        bool operator==(const Triangle &o) const { return v[0] == o.v[0] && v[1] == o.v[1] && v[2] == o.v[2]; }
+    };
+    std::vector<Triangle> triangles;
+    for (size_t i = 0; i + 2 < mesh.Indices.size(); i += 3) {
+        uint32_t a = representative[cellOf[mesh.Indices[i]]], b = representative[cellOf[mesh.Indices[i + 1]]],
+                c = representative[cellOf[mesh.Indices[i + 2]]];
+        if (a == b || b == c || a == c)
+            continue;
+        if (b < a && b < c)
+            triangles.push_back({{b, c, a}});
+        else if (c < a && c < b)
+            triangles.push_back({{c, a, b}});
+        else
+            triangles.push_back({{a, b, c}});
+    }
+    std::sort(triangles.begin(), triangles.end());
+    triangles.erase(std::unique(triangles.begin(), triangles.end()), triangles.end());
+    std::vector<uint32_t> indices;
+    indices.reserve(triangles.size() * 3);
+    for (const Triangle &triangle : triangles)
+        indices.insert(indices.end(), triangle.v, triangle.v + 3);
+    return indices;
+}
+
+// 一级LOD切成小簇的结果
+struct MeshletBuild {
+    std::vector<CookedMeshlet> Meshlets;
+    std::vector<uint32_t> Indices;          // 按小簇的顺序
+    std::vector<uint32_t> Vertices;
+    std::vector<uint8_t> Triangles;
+};
+
+// 三角形按重心的Morton码排序，然后按顺序贪心地装进小簇，顶点或三角形装满时开始下一个
+// local 是每个顶点在当前小簇中的局部索引，调用之间都是-1
+void buildMeshlets(const ImportedMesh &mesh, const std::vector<uint32_t> &indices, std::vector<int> &local, MeshletBuild &out) {
+    const AABB &bounds = mesh.Bounds;
+    glm::vec3 scale = 1023.0f / glm::max(bounds.Max - bounds.Min, glm::vec3(1e-20f));
+    size_t triangleCount = indices.size() / 3;
+    std::vector<std::pair<uint32_t, uint32_t>> order(triangleCount);
+    for (size_t t = 0; t < triangleCount; t++) {
+        glm::vec3 centroid = (mesh.Vertices[indices[t * 3]].Position + mesh.Vertices[indices[t * 3 + 1]].Position +
+                              mesh.Vertices[indices[t * 3 + 2]].Position) / 3.0f;
+        glm::vec3 q = glm::clamp((centroid - bounds.Min) * scale, glm::vec3(0.0f), glm::vec3(1023.0f));
+        order[t] = {expandBits((uint32_t) q.x) | expandBits((uint32_t) q.y) << 1 | expandBits((uint32_t) q.z) << 2, (uint32_t) t};
+    }
+    std::sort(order.begin(), order.end());
+
+    CookedMeshlet meshlet = {};
+    auto flush = [&]() {
+        if (meshlet.TriangleCount == 0)
+            return;
+        AABB box;
+        glm::vec3 axis(0.0f);
+        std::vector<glm::vec3> normals;
+        for (uint32_t t = 0; t < meshlet.TriangleCount; t++) {
+            const uint32_t *triangle = &out.Indices[meshlet.IndexOffset + t * 3];
+            glm::vec3 a = mesh.Vertices[triangle[0]].Position, b = mesh.Vertices[triangle[1]].Position, c = mesh.Vertices[triangle[2]].Position;
+            box.Grow(a);
+            box.Grow(b);
+            box.Grow(c);
+            glm::vec3 n = glm::cross(b - a, c - a);
+            float length = glm::length(n);
+            if (length > 0.0f) {
+                normals.push_back(n / length);
+                axis += normals.back();
+            }
+        }
+        std::memcpy(meshlet.BoundsMin, &box.Min.x, sizeof(meshlet.BoundsMin));
+        std::memcpy(meshlet.BoundsMax, &box.Max.x, sizeof(meshlet.BoundsMax));
+        // 法线锥：轴是法线的平均方向，张角由偏离最大的法线决定；张角接近90度时剔除不了，直接关掉
+        meshlet.ConeCutoff = 1.0f;
+        float axisLength = glm::length(axis);
+        if (axisLength > 0.0f) {
+            axis /= axisLength;
+            float minDot = 1.0f;
+            for (const glm::vec3 &n : normals)
+                minDot = std::min(minDot, glm::dot(n, axis));
+            if (minDot > 0.1f)
+                meshlet.ConeCutoff = std::sqrt(1.0f - minDot * minDot);
+        }
+        std::memcpy(meshlet.ConeAxis, &axis.x, sizeof(meshlet.ConeAxis));
+        for (uint32_t v = 0; v < meshlet.VertexCount; v++)
+            local[out.Vertices[meshlet.VertexOffset + v]] = -1;
+        out.Meshlets.push_back(meshlet);
+        meshlet = CookedMeshlet();
+        meshlet.VertexOffset = (uint32_t) out.Vertices.size();
+        meshlet.TriangleOffset = (uint32_t) (out.Triangles.size() / 3);
+        meshlet.IndexOffset = (uint32_t) out.Indices.size();
+    };
+    meshlet.VertexOffset = (uint32_t) out.Vertices.size();
+    meshlet.TriangleOffset = (uint32_t) (out.Triangles.size() / 3);
+    meshlet.IndexOffset = (uint32_t) out.Indices.size();
+    for (const auto &entry : order) {
+        const uint32_t *triangle = &indices[entry.second * 3];
+        unsigned int added = 0;
+        for (int k = 0; k < 3; k++)
+            added += local[triangle[k]] < 0 && (k == 0 || triangle[k] != triangle[0]) && (k < 2 || triangle[2] != triangle[1]);
+        if (meshlet.VertexCount + added > MESHLET_MAX_VERTICES || meshlet.TriangleCount == MESHLET_MAX_TRIANGLES)
+            flush();
+        for (int k = 0; k < 3; k++) {
+            uint32_t vertex = triangle[k];
+            if (local[vertex] < 0) {
+                local[vertex] = (int) meshlet.VertexCount++;
+                out.Vertices.push_back(vertex);
+            }
+            out.Triangles.push_back((uint8_t) local[vertex]);
+            out.Indices.push_back(vertex);
+        }
+        meshlet.TriangleCount++;
+    }
+    flush();
+}
+
+} // namespace
+
+// MeshCooker
+// ---------------------------------------------------------------------------------------------------------
+
+bool MeshCooker::Cook(const ImportedMesh &mesh, std::vector<unsigned char> &data) {
+    error.clear();
+    data.clear();
+    size_t vertexCount = mesh.Vertices.size();
+    if (vertexCount == 0 || mesh.Indices.empty() || mesh.Indices.size() % 3 != 0) {
+        error = "mesh has no triangles";
+        return false;
+    }
+    if (vertexCount > UINT32_MAX || mesh.Indices.size() > UINT32_MAX / 2) {
+        error = "mesh is too large";
+        return false;
+    }
+    for (unsigned int index : mesh.Indices) {
+        if (index >= vertexCount) {
+            error = "index out of range";
+            return false;
+        }
+    }
+
+    // 顶点格式
+    std::vector<CookedAttribute> attributes;
+    unsigned int stride;
+    if (CompactVertices) {
+        stride = COMPACT_STRIDE;
+        attributes.push_back({COOKED_POSITION, 3, GL_FLOAT, 0, 0});
+        if (mesh.HasNormals)
+            attributes.push_back({COOKED_NORMAL, 4, GL_INT_2_10_10_10_REV, 1, 12});
+        if (mesh.HasTexCoords)
+            attributes.push_back({COOKED_TEXCOORD, 2, GL_HALF_FLOAT, 0, 16});
+    } else {
+        stride = sizeof(MeshVertex);
+        attributes.push_back({COOKED_POSITION, 3, GL_FLOAT, 0, (uint32_t) offsetof(MeshVertex, Position)});
+        if (mesh.HasNormals)
+            attributes.push_back({COOKED_NORMAL, 3, GL_FLOAT, 0, (uint32_t) offsetof(MeshVertex, Normal)});
+        if (mesh.HasTexCoords)
+            attributes.push_back({COOKED_TEXCOORD, 2, GL_FLOAT, 0, (uint32_t) offsetof(MeshVertex, TexCoords)});
+    }
+
+    // LOD：每一级都从原始网格聚类，网格单元的数量按三角形数和单元数的平方成正比来修正，最多试6次
+    std::vector<std::vector<uint32_t>> lodIndices(1, mesh.Indices);
+    std::vector<float> lodErrors(1, 0.0f);
+    float resolution = 0.0f;
+    for (unsigned int lod = 1; lod < LodCount; lod++) {
+        float target = lodIndices.back().size() / 3 * LodRatio;
+        if (target < MESHLET_MAX_TRIANGLES)
+            break;
+        resolution = resolution > 0.0f ? resolution * std::sqrt(LodRatio) : std::sqrt(target / 6.0f);
+        std::vector<uint32_t> best;
+        float bestCell = 0.0f, bestScore = INFINITY;
+        for (int attempt = 0; attempt < 6; attempt++) {
+            float cellSize;
+            std::vector<uint32_t> indices = clusterTriangles(mesh, resolution, cellSize);
+            float triangles = (float) std::max<size_t>(indices.size() / 3, 1);
+            float score = std::fabs(std::log(triangles / target));
+            if (score < bestScore) {
+                bestScore = score;
+                bestCell = cellSize;
+                best.swap(indices);
+            }
+            if (score < std::log(1.2f))
+                break;
+            resolution = std::max(1.0f, resolution * std::sqrt(target / triangles));
+        }
+        // 简化不下去了（比如三角形本来就很大），后面的LOD没有意义
+        if (best.empty() || best.size() > lodIndices.back().size() * 0.9f)
+            break;
+        lodIndices.push_back(std::move(best));
+        lodErrors.push_back(bestCell);
+    }
+
+    // 小簇
+    std::vector<CookedLod> lods;
+    MeshletBuild meshlets;
+    std::vector<int> local(vertexCount, -1);
+    for (size_t lod = 0; lod < lodIndices.size(); lod++) {
+        CookedLod entry;
+        entry.IndexOffset = (uint32_t) meshlets.Indices.size();
+        entry.MeshletOffset = (uint32_t) meshlets.Meshlets.size();
+        buildMeshlets(mesh, lodIndices[lod], local, meshlets);
+        entry.IndexCount = (uint32_t) meshlets.Indices.size() - entry.IndexOffset;
+        entry.MeshletCount = (uint32_t) meshlets.Meshlets.size() - entry.MeshletOffset;
+        entry.Error = lodErrors[lod];
+        lods.push_back(entry);
+    }
+
+    // 文件布局
+    CookedMeshHeader header = {};
+    header.Magic = COOKED_MESH_MAGIC;
+    header.Version = COOKED_MESH_VERSION;
+    header.Flags = (mesh.HasNormals ? COOKED_HAS_NORMALS : 0) | (mesh.HasTexCoords ? COOKED_HAS_TEXCOORDS : 0);
+    header.VertexCount = (uint32_t) vertexCount;
+    header.VertexStride = stride;
+    header.AttributeCount = (uint32_t) attributes.size();
+    header.IndexCount = (uint32_t) meshlets.Indices.size();
+    header.IndexType = vertexCount <= 65536 ? GL_UNSIGNED_SHORT : GL_UNSIGNED_INT;
+    header.LodCount = (uint32_t) lods.size();
+    header.MeshletCount = (uint32_t) meshlets.Meshlets.size();
+    header.MeshletVertexCount = (uint32_t) meshlets.Vertices.size();
+    header.MeshletTriangleCount = (uint32_t) (meshlets.Triangles.size() / 3);
+    std::memcpy(header.BoundsMin, &mesh.Bounds.Min.x, sizeof(header.BoundsMin));
+    std::memcpy(header.BoundsMax, &mesh.Bounds.Max.x, sizeof(header.BoundsMax));
+    unsigned int indexSize = header.IndexType == GL_UNSIGNED_SHORT ? 2 : 4;
+    header.AttributeOffset = alignUp(sizeof(CookedMeshHeader));
+    header.LodOffset = alignUp(header.AttributeOffset + attributes.size() * sizeof(CookedAttribute));
+    header.MeshletOffset = alignUp(header.LodOffset + lods.size() * sizeof(CookedLod));
+    header.VertexOffset = alignUp(header.MeshletOffset + meshlets.Meshlets.size() * sizeof(CookedMeshlet));
+    header.IndexOffset = alignUp(header.VertexOffset + (uint64_t) vertexCount * stride);
+    header.MeshletVertexOffset = alignUp(header.IndexOffset + (uint64_t) header.IndexCount * indexSize);
+    header.MeshletTriangleOffset = alignUp(header.MeshletVertexOffset + meshlets.Vertices.size() * sizeof(uint32_t));
+    header.FileSize = alignUp(header.MeshletTriangleOffset + meshlets.Triangles.size());
+
+    data.assign(header.FileSize, 0);
+    unsigned char *out = data.data();
+    std::memcpy(out, &header, sizeof(header));
+    std::memcpy(out + header.AttributeOffset, attributes.data(), attributes.size() * sizeof(CookedAttribute));
+    std::memcpy(out + header.LodOffset, lods.data(), lods.size() * sizeof(CookedLod));
+    std::memcpy(out + header.MeshletOffset, meshlets.Meshlets.data(), meshlets.Meshlets.size() * sizeof(CookedMeshlet));
+    unsigned char *vertices = out + header.VertexOffset;
+    if (CompactVertices) {
+        for (size_t i = 0; i < vertexCount; i++) {
+            const MeshVertex &vertex = mesh.Vertices[i];
+            unsigned char *p = vertices + i * COMPACT_STRIDE;
+            uint32_t normal = packNormal(vertex.Normal);
+            uint16_t uv[2] = {floatToHalf(vertex.TexCoords.x), floatToHalf(vertex.TexCoords.y)};
+            std::memcpy(p, &vertex.Position.x, 12);
+            std::memcpy(p + 12, &normal, 4);
+            std::memcpy(p + 16, uv, 4);
+        }
+    } else {
+        std::memcpy(vertices, mesh.Vertices.data(), vertexCount * sizeof(MeshVertex));
+    }
+    unsigned char *indices = out + header.IndexOffset;
+    if (indexSize == 2) {
+        for (size_t i = 0; i < meshlets.Indices.size(); i++) {
+            uint16_t index = (uint16_t) meshlets.Indices[i];
+            std::memcpy(indices + i * 2, &index, 2);
+        }
+    } else {
+        std::memcpy(indices, meshlets.Indices.data(), meshlets.Indices.size() * sizeof(uint32_t));
+    }
+    std::memcpy(out + header.MeshletVertexOffset, meshlets.Vertices.data(), meshlets.Vertices.size() * sizeof(uint32_t));
+    std::memcpy(out + header.MeshletTriangleOffset, meshlets.Triangles.data(), meshlets.Triangles.size());
+    return true;
+}
+
+bool MeshCooker::Write(const ImportedMesh &mesh, const char *path) {
+    std::vector<unsigned char> data;
+    if (!Cook(mesh, data))
+        return false;
+    std::ofstream file(path, std::ios::binary);
+    file.write(reinterpret_cast<const char *>(data.data()), (std::streamsize) data.size());
+    if (!file) {
+        error = std::string("cannot write ") + path;
+        return false;
+    }
+    return true;
+}
+
+// CookedMesh
+// ---------------------------------------------------------------------------------------------------------
+
+bool CookedMeshlet::BackFacing(const glm::vec3 &eye) const {
+    AABB box = Bounds();
+    glm::vec3 center = box.Center(), toCenter = center - eye;
+    glm::vec3 axis(ConeAxis[0], ConeAxis[1], ConeAxis[2]);
+    return glm::dot(toCenter, axis) >= ConeCutoff * glm::length(toCenter) + glm::length(box.Extents());
+}
+
+bool CookedMesh::Open(const char *path) {
+    header = nullptr;
+    data = nullptr;
+    if (!file.Open(path)) {
+        error = std::string("cannot open ") + path;
+        return false;
+    }
+    return Parse(file.Data(), file.Size());
+}
+
+bool CookedMesh::Parse(const unsigned char *bytes, size_t size) {
+    header = nullptr;
+    data = nullptr;
+    error.clear();
+    auto fail = [this](const char *message) {
+        error = message;
+        return false;
+    };
+    if (size < sizeof(CookedMeshHeader) || ((uintptr_t) bytes & 3) != 0)
+        return fail("file too small or misaligned");
+    const CookedMeshHeader *h = reinterpret_cast<const CookedMeshHeader *>(bytes);
+    if (h->Magic != COOKED_MESH_MAGIC)
+        return fail("not a cooked mesh");
+    if (h->Version != COOKED_MESH_VERSION)
+        return fail("unsupported version");
+    if (h->FileSize != size)
+        return fail("file size does not match the header (truncated?)");
+    if (h->IndexType != GL_UNSIGNED_SHORT && h->IndexType != GL_UNSIGNED_INT)
+        return fail("invalid index type");
+    if (h->AttributeCount == 0 || h->AttributeCount > COOKED_MESH_MAX_ATTRIBUTES || h->LodCount == 0 || h->IndexCount % 3 != 0)
+        return fail("invalid header");
+    // 每一段都要对齐并且在文件之内（数量都是32位，乘积不会溢出64位）
+    uint64_t indexSize = h->IndexType == GL_UNSIGNED_SHORT ? 2 : 4;
+    struct Section { uint64_t Offset, Bytes; };
+    const Section sections[] = {
+            {h->AttributeOffset, (uint64_t) h->AttributeCount * sizeof(CookedAttribute)},
+            {h->LodOffset, (uint64_t) h->LodCount * sizeof(CookedLod)},
+            {h->MeshletOffset, (uint64_t) h->MeshletCount * sizeof(CookedMeshlet)},
+            {h->VertexOffset, (uint64_t) h->VertexCount * h->VertexStride},
+            {h->IndexOffset, (uint64_t) h->IndexCount * indexSize},
+            {h->MeshletVertexOffset, (uint64_t) h->MeshletVertexCount * sizeof(uint32_t)},
+            {h->MeshletTriangleOffset, (uint64_t) h->MeshletTriangleCount * 3}};
+    for (const Section &section : sections) {
+        if (section.Offset % COOKED_MESH_ALIGNMENT != 0 || section.Offset < sizeof(CookedMeshHeader) || section.Offset > size ||
+            section.Bytes > size - section.Offset)
+            return fail("section out of range");
+    }
+    const CookedAttribute *attributes = reinterpret_cast<const CookedAttribute *>(bytes + h->AttributeOffset);
+    for (uint32_t i = 0; i < h->AttributeCount; i++) {
+        const CookedAttribute &attribute = attributes[i];
+        uint32_t componentSize = attribute.ComponentType == GL_FLOAT || attribute.ComponentType == GL_INT_2_10_10_10_REV ? 4
+                                 : attribute.ComponentType == GL_HALF_FLOAT ? 2 : 0;
+        uint32_t bytesUsed = attribute.ComponentType == GL_INT_2_10_10_10_REV ? 4 : componentSize * attribute.Components;
+        if (componentSize == 0 || attribute.Components == 0 || attribute.Components > 4 || attribute.Location >= 16 ||
+            (attribute.ComponentType == GL_INT_2_10_10_10_REV && attribute.Components != 4) ||
+            attribute.Offset > h->VertexStride || bytesUsed > h->VertexStride - attribute.Offset)
+            return fail("invalid vertex attribute");
+    }
+    const CookedLod *lods = reinterpret_cast<const CookedLod *>(bytes + h->LodOffset);
+    for (uint32_t i = 0; i < h->LodCount; i++) {
+        const CookedLod &lod = lods[i];
+        if (lod.IndexOffset > h->IndexCount || lod.IndexCount > h->IndexCount - lod.IndexOffset || lod.IndexCount % 3 != 0 ||
+            lod.MeshletOffset > h->MeshletCount || lod.MeshletCount > h->MeshletCount - lod.MeshletOffset)
+            return fail("invalid LOD");
+    }
+    const CookedMeshlet *meshlets = reinterpret_cast<const CookedMeshlet *>(bytes + h->MeshletOffset);
+    for (uint32_t i = 0; i < h->MeshletCount; i++) {
+        const CookedMeshlet &meshlet = meshlets[i];
+        if (meshlet.VertexCount > MESHLET_MAX_VERTICES || meshlet.TriangleCount > MESHLET_MAX_TRIANGLES ||
+            meshlet.VertexOffset > h->MeshletVertexCount || meshlet.VertexCount > h->MeshletVertexCount - meshlet.VertexOffset ||
+            meshlet.TriangleOffset > h->MeshletTriangleCount || meshlet.TriangleCount > h->MeshletTriangleCount - meshlet.TriangleOffset ||
+            meshlet.IndexOffset > h->IndexCount || meshlet.TriangleCount * 3 > h->IndexCount - meshlet.IndexOffset)
+            return fail("invalid meshlet");
+    }
+    data = bytes;
+    header = h;
+    return true;
+}
+
+bool CookedMesh::Verify() {
+    if (!header) {
+        error = "no mesh";
+        return false;
+    }
+    auto index = [this](size_t i) -> uint32_t {
+        if (header->IndexType == GL_UNSIGNED_SHORT) {
+            uint16_t value;
+            std::memcpy(&value, IndexData() + i * 2, 2);
+            return value;
+        }
+        uint32_t value;
+        std::memcpy(&value, IndexData() + i * 4, 4);
+        return value;
+    };
+    for (size_t i = 0; i < header->IndexCount; i++) {
+        if (index(i) >= header->VertexCount) {
+            error = "index out of range";
+            return false;
+        }
+    }
+    const uint32_t *meshletVertices = MeshletVertices();
+    for (uint32_t i = 0; i < header->MeshletVertexCount; i++) {
+        if (meshletVertices[i] >= header->VertexCount) {
+            error = "meshlet vertex out of range";
+            return false;
+        }
+    }
+    // 每级LOD的小簇依次覆盖它的索引范围，小簇的局部三角形和索引数据相同
+    for (uint32_t l = 0; l < header->LodCount; l++) {
+        const CookedLod &lod = Lod(l);
+        uint32_t next = lod.IndexOffset;
+        for (uint32_t m = lod.MeshletOffset; m < lod.MeshletOffset + lod.MeshletCount; m++) {
+            const CookedMeshlet &meshlet = Meshlets()[m];
+            if (meshlet.IndexOffset != next) {
+                error = "meshlets do not cover their LOD";
+                return false;
+            }
+            const uint8_t *triangles = MeshletTriangles() + (size_t) meshlet.TriangleOffset * 3;
+            for (uint32_t k = 0; k < meshlet.TriangleCount * 3; k++) {
+                if (triangles[k] >= meshlet.VertexCount || meshletVertices[meshlet.VertexOffset + triangles[k]] != index(meshlet.IndexOffset + k)) {
+                    error = "meshlet triangles do not match the index data";
+                    return false;
+                }
+            }
+            next += meshlet.TriangleCount * 3;
+        }
+        if (next != lod.IndexOffset + lod.IndexCount) {
+            error = "meshlets do not cover their LOD";
+            return false;
+        }
+    }
+    return true;
+}
+
+AABB CookedMesh::Bounds() const {
+    return AABB(glm::vec3(header->BoundsMin[0], header->BoundsMin[1], header->BoundsMin[2]),
+                glm::vec3(header->BoundsMax[0], header->BoundsMax[1], header->BoundsMax[2]));
+}
+
+// CookedMeshBuffers
+// ---------------------------------------------------------------------------------------------------------
+
+void CookedMeshBuffers::Upload(const CookedMesh &mesh) {
+    Release();
+    const CookedMeshHeader &header = mesh.Header();
+    glGenVertexArrays(1, &vao);
+    glGenBuffers(1, &vbo);
+    glGenBuffers(1, &ebo);
+    glBindVertexArray(vao);
+    glBindBuffer(GL_ARRAY_BUFFER, vbo);
+    glBufferData(GL_ARRAY_BUFFER, (GLsizeiptr) mesh.VertexBytes(), mesh.VertexData(), GL_STATIC_DRAW);
+    glBindBuffer(GL_ELEMENT_ARRAY_BUFFER, ebo);
+    glBufferData(GL_ELEMENT_ARRAY_BUFFER, (GLsizeiptr) mesh.IndexBytes(), mesh.IndexData(), GL_STATIC_DRAW);
+    for (uint32_t i = 0; i < header.AttributeCount; i++) {
+        const CookedAttribute &attribute = mesh.Attributes()[i];
+        glVertexAttribPointer(attribute.Location, (GLint) attribute.Components, attribute.ComponentType, attribute.Normalized ? GL_TRUE : GL_FALSE,
+                              (GLsizei) header.VertexStride, (void *) (uintptr_t) attribute.Offset);
+        glEnableVertexAttribArray(attribute.Location);
+    }
+    glBindVertexArray(0);
+    indexType = header.IndexType;
+    indexSize = mesh.IndexSize();
+    lods.assign(&mesh.Lod(0), &mesh.Lod(0) + header.LodCount);
+    meshlets.assign(mesh.Meshlets(), mesh.Meshlets() + header.MeshletCount);
+}
+
+void CookedMeshBuffers::Release() {
+    if (vao) {
+        glDeleteVertexArrays(1, &vao);
+        glDeleteBuffers(1, &vbo);
+        glDeleteBuffers(1, &ebo);
+    }
+    vao = vbo = ebo = 0;
+    lods.clear();
+    meshlets.clear();
+}
+
+void CookedMeshBuffers::DrawLod(unsigned int lod) const {
+    const CookedLod &entry = lods[std::min<size_t>(lod, lods.size() - 1)];
+    glBindVertexArray(vao);
+    glDrawElements(GL_TRIANGLES, (GLsizei) entry.IndexCount, indexType, (void *) ((uintptr_t) entry.IndexOffset * indexSize));
+    glBindVertexArray(0);
+}
+
+void CookedMeshBuffers::DrawMeshlets(const std::vector<unsigned int> &ids) const {
+    if (ids.empty())
+        return;
+    counts.clear();
+    offsets.clear();
+    for (unsigned int id : ids) {
+        counts.push_back((GLsizei) meshlets[id].TriangleCount * 3);
+        offsets.push_back((const void *) ((uintptr_t) meshlets[id].IndexOffset * indexSize));
+    }
+    glBindVertexArray(vao);
+    glMultiDrawElements(GL_TRIANGLES, counts.data(), indexType, offsets.data(), (GLsizei) ids.size());
+    glBindVertexArray(0);
+}
@@ -0,0 +1,1063 @@
+#include <learnopengl/mesh_import.h>
+
+#include <glm/gtc/quaternion.hpp>
+
+#include <algorithm>
+#include <atomic>
+#include <cctype>
+#include <chrono>
+#include <climits>
+#include <cmath>
+#include <cstdint>
+#include <cstdlib>
+#include <cstring>
+#include <thread>
+
+#ifdef _WIN32
+#define WIN32_LEAN_AND_MEAN
+#define NOMINMAX
+#include <windows.h>
+#else
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+#endif
+
+static_assert(sizeof(MeshVertex) == 8 * sizeof(float), "MeshVertex must be tightly packed for glBufferData");
+
+namespace {
+
+typedef std::chrono::high_resolution_clock Clock;
+
+double millisecondsSince(Clock::time_point start) {
+    return std::chrono::duration<double, std::milli>(Clock::now() - start).count();
+}
+
+// 用 threads 个线程（包括调用线程）处理 [0, count) 的每一项，项按编号动态领取
+template<typename Function>
+void parallelFor(size_t count, unsigned int threads, const Function &function) {
+    threads = (unsigned int) std::max<size_t>(std::min<size_t>(threads, count), 1);
+    std::atomic<size_t> next(0);
+    auto work = [&]() {
+        for (size_t i = next++; i < count; i = next++)
+            function(i);
+    };
+    std::vector<std::thread> pool;
+    for (unsigned int t = 1; t < threads; t++)
+        pool.emplace_back(work);
+    work();
+    for (std::thread &thread : pool)
+        thread.join();
+}
+
+// 10的0到22次方都能用double精确表示
+const double POW10[] = {1e0, 1e1, 1e2, 1e3, 1e4, 1e5, 1e6, 1e7, 1e8, 1e9, 1e10, 1e11,
+                        1e12, 1e13, 1e14, 1e15, 1e16, 1e17, 1e18, 1e19, 1e20, 1e21, 1e22};
+
+inline bool isDigit(char c) { return (unsigned char) (c - '0') < 10; }
+inline bool isBlank(char c) { return c == ' ' || c == '\t'; }
+
+// 十进制数转成double：尾数不超过 2^53、十进制指数在 [-22, 22] 内时，一次乘除得到正确舍入的结果（Clinger的快速路径），
+// 其他情况（超过15位的有效数字、很大的指数）很少见，复制出来交给 strtod；示例都不修改locale，小数点总是 '.'
+const char *parseDouble(const char *p, const char *end, double &value) {
+    const char *start = p;
+    bool negative = false;
+    if (p < end && (*p == '-' || *p == '+')) {
+        negative = *p == '-';
+        p++;
+    }
+    uint64_t mantissa = 0;
+    int digits = 0, exponent = 0;
+    bool any = false;
+    for (; p < end && isDigit(*p); p++) {
+        any = true;
+        if (digits < 19) {
+            mantissa = mantissa * 10 + (uint64_t) (*p - '0');
+            digits += mantissa != 0;
+        } else
+            exponent++;
+    }
+    if (p < end && *p == '.') {
+        for (p++; p < end && isDigit(*p); p++) {
+            any = true;
+            if (digits < 19) {
+                mantissa = mantissa * 10 + (uint64_t) (*p - '0');
+                digits += mantissa != 0;
+                exponent--;
+            }
+        }
+    }
+    if (!any)
+        return nullptr;
+    // 'e' 后面没有数字时不算指数，数字在 'e' 之前结束
+    if (p < end && (*p == 'e' || *p == 'E')) {
+        const char *q = p + 1;
+        bool negativeExponent = false;
+        if (q < end && (*q == '-' || *q == '+')) {
+            negativeExponent = *q == '-';
+            q++;
+        }
+        if (q < end && isDigit(*q)) {
+            int e = 0;
+            for (; q < end && isDigit(*q); q++)
+                e = std::min(e * 10 + (*q - '0'), 100000);
+            exponent += negativeExponent ? -e : e;
+            p = q;
+        }
+    }
+
+    double result;
+    if (mantissa == 0)
+        result = 0.0;
+    else if (mantissa <= (uint64_t(1) << 53) && exponent >= -22 && exponent <= 22)
+        result = exponent < 0 ? (double) mantissa / POW10[-exponent] : (double) mantissa * POW10[exponent];
+    else {
+        std::string text(start, p);
+        value = std::strtod(text.c_str(), nullptr);
+        return p;
+    }
+    value = negative ? -result : result;
+    return p;
+}
+
+const char *parseInt(const char *p, const char *end, long long &value) {
+    bool negative = false;
+    if (p < end && (*p == '-' || *p == '+')) {
+        negative = *p == '-';
+        p++;
+    }
+    if (p >= end || !isDigit(*p))
+        return nullptr;
+    long long v = 0;
+    for (; p < end && isDigit(*p); p++)
+        v = std::min(v * 10 + (*p - '0'), (long long) INT32_MAX);
+    value = negative ? -v : v;
+    return p;
+}
+
+// OBJ
+// ---------------------------------------------------------------------------------------------------------
+
+// 没有纹理坐标或法线；换算后的索引至少是 -INT32_MAX（parseInt 的范围），不会等于它，
+// 指到第一个元素之前的相对索引是负数，和“没有”区分开，合并时报错
+const int MISSING = INT_MIN;
+
+// 一个块的解析结果，索引从0开始；负索引先换算成相对块开头的编号（可能小于0，指向之前的块），在 Relative 中记下位置，
+// 合并时加上之前的块中对应属性的数量
+struct ObjChunk {
+    const char *Begin = nullptr, *End = nullptr;
+    std::vector<float> Positions, TexCoords, Normals;
+    std::vector<int> Corners;           // 每个角3个索引：位置、纹理坐标、法线
+    std::vector<size_t> Relative;
+    const char *ErrorAt = nullptr;
+    const char *ErrorMessage = nullptr;
+    // 合并时发现索引越界后重新解析这个块：解析到包含第 FindCorner 个索引的面时停下，ErrorAt 指向那一行
+    size_t FindCorner = SIZE_MAX;
+};
+
+// 多边形的一个角，Relative 的3位表示3个索引是不是负索引
+struct ObjCorner {
+    int Index[3];
+    unsigned int Relative;
+};
+
+// 解析一行中的 count 个数字
+bool parseFloats(const char *&p, const char *end, float *values, int count) {
+    for (int i = 0; i < count; i++) {
+        while (p < end && isBlank(*p))
+            p++;
+        double value;
+        const char *next = parseDouble(p, end, value);
+        if (!next)
+            return false;
+        values[i] = (float) value;
+        p = next;
+    }
+    return true;
+}
+
+void parseObjChunk(ObjChunk &chunk) {
+    const char *p = chunk.Begin, *end = chunk.End;
+    std::vector<ObjCorner> polygon;
+    auto fail = [&chunk](const char *at, const char *message) {
+        chunk.ErrorAt = at;
+        chunk.ErrorMessage = message;
+    };
+
+    while (p < end) {
+        while (p < end && isBlank(*p))
+            p++;
+        const char *line = p;
+        char next = p + 1 < end ? p[1] : '\n';
+        if (p < end && *p == 'v') {
+            float values[3];
+            if (isBlank(next)) {
+                p++;
+                if (!parseFloats(p, end, values, 3))
+                    return fail(line, "expected 3 numbers after 'v'");
+                chunk.Positions.insert(chunk.Positions.end(), values, values + 3);
+            } else if ((next == 't' || next == 'n') && p + 2 < end && isBlank(p[2])) {
+                p += 2;
+                if (next == 'n') {
+                    if (!parseFloats(p, end, values, 3))
+                        return fail(line, "expected 3 numbers after 'vn'");
+                    chunk.Normals.insert(chunk.Normals.end(), values, values + 3);
+                } else {
+                    // vt u [v [w]]
+                    if (!parseFloats(p, end, values, 1))
+                        return fail(line, "expected a number after 'vt'");
+                    while (p < end && isBlank(*p))
+                        p++;
+                    values[1] = 0.0f;
+                    if (p < end && (isDigit(*p) || *p == '-' || *p == '+' || *p == '.') && !parseFloats(p, end, values + 1, 1))
+                        return fail(line, "invalid number after 'vt'");
+                    chunk.TexCoords.insert(chunk.TexCoords.end(), values, values + 2);
+                }
+            }
+        } else if (p < end && *p == 'f' && isBlank(next)) {
+            p++;
+            polygon.clear();
+            const int counts[3] = {(int) (chunk.Positions.size() / 3), (int) (chunk.TexCoords.size() / 2),
+                                   (int) (chunk.Normals.size() / 3)};
+            for (;;) {
+                while (p < end && isBlank(*p))
+                    p++;
+                if (p >= end || *p == '\n' || *p == '\r' || *p == '#')
+                    break;
+                // v、v/vt、v//vn、v/vt/vn
+                ObjCorner corner = {{MISSING, MISSING, MISSING}, 0};
+                for (int k = 0; k < 3; k++) {
+                    if (k > 0) {
+                        if (p >= end || *p != '/')
+                            break;
+                        p++;
+                        if (k == 1 && p < end && *p == '/')
+                            continue;
+                    }
+                    long long value;
+                    const char *q = parseInt(p, end, value);
+                    if (!q)
+                        return fail(line, "invalid index in 'f'");
+                    p = q;
+                    if (value == 0)
+                        return fail(line, "index 0 in 'f'");
+                    if (value > 0)
+                        corner.Index[k] = (int) (value - 1);
+                    else {
+                        corner.Index[k] = (int) (counts[k] + value);
+                        corner.Relative |= 1u << k;
+                    }
+                }
+                polygon.push_back(corner);
+            }
+            if (polygon.size() < 3)
+                return fail(line, "face with fewer than 3 vertices");
+            // 扇形三角化
+            for (size_t i = 1; i + 1 < polygon.size(); i++) {
+                const ObjCorner *triangle[3] = {&polygon[0], &polygon[i], &polygon[i + 1]};
+                for (const ObjCorner *corner : triangle) {
+                    for (int k = 0; k < 3; k++) {
+                        if (corner->Relative & (1u << k))
+                            chunk.Relative.push_back(chunk.Corners.size());
+                        chunk.Corners.push_back(corner->Index[k]);
+                    }
+                }
+            }
+            if (chunk.Corners.size() > chunk.FindCorner) {
+                chunk.ErrorAt = line;
+                return;
+            }
+        }
+        // 其他行（注释、o、g、s、usemtl、mtllib……）和数字之后剩下的内容都跳过
+        const void *newline = p < end ? std::memchr(p, '\n', (size_t) (end - p)) : nullptr;
+        p = newline ? (const char *) newline + 1 : end;
+    }
+}
+
+// glb 和 JSON
+// ---------------------------------------------------------------------------------------------------------
+
+// JSON节点放在一个数组中，子节点用 FirstChild / NextSibling 连接
+// 字符串不处理转义，Text 指向引号内的原始内容；glTF中用到的键和枚举字符串都不含转义
+struct JsonNode {
+    enum Kind { NUL, BOOLEAN, NUMBER, STRING, ARRAY, OBJECT };
+    Kind Type = NUL;
+    double Number = 0.0;
+    const char *Text = nullptr;
+    size_t Length = 0;
+    const char *Key = nullptr;
+    size_t KeyLength = 0;
+    int FirstChild = -1, NextSibling = -1;
+};
+
+class Json {
+public:
+    bool Parse(const char *text, size_t size) {
+        p = text;
+        end = text + size;
+        nodes.clear();
+        nodes.reserve(size / 8);
+        if (parseValue(0) < 0)
+            return false;
+        skipSpace();
+        return p == end;
+    }
+    const JsonNode *Root() const { return nodes.empty() ? nullptr : &nodes[0]; }
+
+    const JsonNode *Member(const JsonNode *object, const char *key) const {
+        if (!object || object->Type != JsonNode::OBJECT)
+            return nullptr;
+        size_t length = std::strlen(key);
+        for (int c = object->FirstChild; c >= 0; c = nodes[c].NextSibling)
+            if (nodes[c].KeyLength == length && std::memcmp(nodes[c].Key, key, length) == 0)
+                return &nodes[c];
+        return nullptr;
+    }
+    std::vector<const JsonNode *> Items(const JsonNode *array) const {
+        std::vector<const JsonNode *> items;
+        if (array && array->Type == JsonNode::ARRAY)
+            for (int c = array->FirstChild; c >= 0; c = nodes[c].NextSibling)
+                items.push_back(&nodes[c]);
+        return items;
+    }
+    // 数字成员，不存在或者类型不对时返回 fallback
+    double Number(const JsonNode *object, const char *key, double fallback) const {
+        const JsonNode *member = Member(object, key);
+        return member && member->Type == JsonNode::NUMBER ? member->Number : fallback;
+    }
+    static bool Equals(const JsonNode *node, const char *text) {
+        return node && node->Type == JsonNode::STRING && node->Length == std::strlen(text) &&
+               std::memcmp(node->Text, text, node->Length) == 0;
+    }
+
+private:
+    static const int MAX_DEPTH = 256;
+    const char *p = nullptr, *end = nullptr;
+    std::vector<JsonNode> nodes;
+
+    void skipSpace() {
+        while (p < end && (*p == ' ' || *p == '\t' || *p == '\n' || *p == '\r'))
+            p++;
+    }
+    bool parseString(const char *&text, size_t &length) {
+        if (p >= end || *p != '"')
+            return false;
+        text = ++p;
+        while (p < end && *p != '"')
+            p += *p == '\\' ? 2 : 1;
+        if (p >= end)
+            return false;
+        length = (size_t) (p - text);
+        p++;
+        return true;
+    }
+    bool literal(const char *word) {
+        size_t length = std::strlen(word);
+        if ((size_t) (end - p) < length || std::memcmp(p, word, length) != 0)
+            return false;
+        p += length;
+        return true;
+    }
+    // 返回节点编号，失败时返回-1
+    int parseValue(int depth) {
+        skipSpace();
+        if (p >= end || depth > MAX_DEPTH)
+            return -1;
+        int index = (int) nodes.size();
+        nodes.emplace_back();
+        char c = *p;
+        if (c == '{' || c == '[') {
+            bool object = c == '{';
+            nodes[index].Type = object ? JsonNode::OBJECT : JsonNode::ARRAY;
+            p++;
+            skipSpace();
+            int last = -1;
+            if (p < end && *p == (object ? '}' : ']')) {
+                p++;
+                return index;
+            }
+            for (;;) {
+                const char *key = nullptr;
+                size_t keyLength = 0;
+                if (object) {
+                    skipSpace();
+                    if (!parseString(key, keyLength))
+                        return -1;
+                    skipSpace();
+                    if (p >= end || *p++ != ':')
+                        return -1;
+                }
+                int child = parseValue(depth + 1);
+                if (child < 0)
+                    return -1;
+                nodes[child].Key = key;
+                nodes[child].KeyLength = keyLength;
+                if (last < 0)
+                    nodes[index].FirstChild = child;
+                else
+                    nodes[last].NextSibling = child;
+                last = child;
+                skipSpace();
+                if (p < end && *p == ',') {
+                    p++;
+                    continue;
+                }
+                if (p < end && *p == (object ? '}' : ']')) {
+                    p++;
+                    return index;
+                }
+                return -1;
+            }
+        }
+        if (c == '"') {
+            nodes[index].Type = JsonNode::STRING;
+            return parseString(nodes[index].Text, nodes[index].Length) ? index : -1;
+        }
+        if (literal("true") || literal("false")) {
+            nodes[index].Type = JsonNode::BOOLEAN;
+            nodes[index].Number = p[-1] == 'e' && p[-2] == 'u' ? 1.0 : 0.0;
+            return index;
+        }
+        if (literal("null"))
+            return index;
+        const char *next = parseDouble(p, end, nodes[index].Number);
+        if (!next)
+            return -1;
+        nodes[index].Type = JsonNode::NUMBER;
+        p = next;
+        return index;
+    }
+};
+
+const uint32_t GLB_MAGIC = 0x46546C67;          // "glTF"
+const uint32_t GLB_CHUNK_JSON = 0x4E4F534A;     // "JSON"
+const uint32_t GLB_CHUNK_BIN = 0x004E4942;      // "BIN\0"
+const unsigned int GLTF_TRIANGLES = 4;
+// glTF规定 bufferView.byteStride 不超过252；glb的长度是32位的，数量和字节偏移都不会超过 GLB_MAX_BYTES
+const unsigned int GLTF_MAX_BYTE_STRIDE = 252;
+const double GLB_MAX_BYTES = 4294967295.0;
+
+uint32_t readU32(const unsigned char *p) {
+    return (uint32_t) p[0] | ((uint32_t) p[1] << 8) | ((uint32_t) p[2] << 16) | ((uint32_t) p[3] << 24);
+}
+
+// JSON中的数量、字节偏移和下标：[0, limit] 中的整数；负数、小数、NaN和过大的值直接转换成 size_t 是未定义行为
+bool jsonInteger(double value, double limit, size_t &result) {
+    if (!(value >= 0.0 && value <= limit) || value != std::floor(value))
+        return false;
+    result = (size_t) value;
+    return true;
+}
+
+// 数组下标：[0, count) 中的整数
+bool jsonIndex(double value, size_t count, size_t &index) {
+    return jsonInteger(value, (double) count - 1.0, index);
+}
+
+// 节点的局部变换：matrix，或者 translation * rotation * scale
+glm::mat4 nodeTransform(const Json &json, const JsonNode *node) {
+    glm::mat4 transform(1.0f);
+    std::vector<const JsonNode *> matrix = json.Items(json.Member(node, "matrix"));
+    if (matrix.size() == 16) {
+        for (int i = 0; i < 16; i++)
+            transform[i / 4][i % 4] = (float) matrix[i]->Number;
+        return transform;
+    }
+    std::vector<const JsonNode *> t = json.Items(json.Member(node, "translation"));
+    std::vector<const JsonNode *> r = json.Items(json.Member(node, "rotation"));
+    std::vector<const JsonNode *> s = json.Items(json.Member(node, "scale"));
+    if (t.size() == 3)
+        transform[3] = glm::vec4((float) t[0]->Number, (float) t[1]->Number, (float) t[2]->Number, 1.0f);
+    if (r.size() == 4)
+        transform = transform * glm::mat4_cast(glm::quat((float) r[3]->Number, (float) r[0]->Number, (float) r[1]->Number, (float) r[2]->Number));
+    if (s.size() == 3) {
+        glm::vec3 scale((float) s[0]->Number, (float) s[1]->Number, (float) s[2]->Number);
+        for (int i = 0; i < 3; i++)
+            transform[i] = transform[i] * scale[i];
+    }
+    return transform;
+}
+
+} // namespace
+
+// 类定义
+// =================================================================================================
+
+MappedFile::MappedFile(MappedFile &&other) noexcept {
+    *this = std::move(other);
+}
+
+MappedFile &MappedFile::operator=(MappedFile &&other) noexcept {
+    if (this != &other) {
+        Close();
+        std::swap(data, other.data);
+        std::swap(size, other.size);
+        std::swap(open, other.open);
+#ifdef _WIN32
+        std::swap(file, other.file);
+        std::swap(mapping, other.mapping);
+#endif
+    }
+    return *this;
+}
+
+bool MappedFile::Open(const char *path) {
+    Close();
+#ifdef _WIN32
+    HANDLE handle = CreateFileA(path, GENERIC_READ, FILE_SHARE_READ, nullptr, OPEN_EXISTING, FILE_FLAG_SEQUENTIAL_SCAN, nullptr);
+    if (handle == INVALID_HANDLE_VALUE)
+        return false;
+    LARGE_INTEGER fileSize;
+    if (!GetFileSizeEx(handle, &fileSize)) {
+        CloseHandle(handle);
+        return false;
+    }
+    file = handle;
+    size = (size_t) fileSize.QuadPart;
+    if (size > 0) {
+        mapping = CreateFileMappingA(handle, nullptr, PAGE_READONLY, 0, 0, nullptr);
+        void *view = mapping ? MapViewOfFile((HANDLE) mapping, FILE_MAP_READ, 0, 0, 0) : nullptr;
+        if (!view) {
+            open = true;
+            Close();
+            return false;
+        }
+        data = (const unsigned char *) view;
+    }
+#else
+    int fd = ::open(path, O_RDONLY);
+    if (fd < 0)
+        return false;
+    struct stat info;
+    if (fstat(fd, &info) != 0) {
+        ::close(fd);
+        return false;
+    }
+    size = (size_t) info.st_size;
+    if (size > 0) {
+        void *view = mmap(nullptr, size, PROT_READ, MAP_PRIVATE, fd, 0);
+        if (view == MAP_FAILED) {
+            ::close(fd);
+            size = 0;
+            return false;
+        }
+#ifdef MADV_WILLNEED
+        // 文件会被整个读一遍，让内核提前读入
+        madvise(view, size, MADV_WILLNEED);
+#endif
+        data = (const unsigned char *) view;
+    }
+    // 映射不依赖文件描述符
+    ::close(fd);
+#endif
+    open = true;
+    return true;
+}
+
+void MappedFile::Close() {
+    if (!open)
+        return;
+#ifdef _WIN32
+    if (data)
+        UnmapViewOfFile(data);
+    if (mapping)
+        CloseHandle((HANDLE) mapping);
+    if (file)
+        CloseHandle((HANDLE) file);
+    file = mapping = nullptr;
+#else
+    if (data)
+        munmap((void *) data, size);
+#endif
+    data = nullptr;
+    size = 0;
+    open = false;
+}
+
+void ImportedMesh::Clear() {
+    Vertices.clear();
+    Indices.clear();
+    HasNormals = HasTexCoords = false;
+    Bounds = AABB();
+}
+
+unsigned int GlbAccessor::ElementSize() const {
+    unsigned int componentSize = ComponentType == 5126 || ComponentType == 5125 ? 4 : ComponentType == 5122 || ComponentType == 5123 ? 2 : 1;
+    return componentSize * Components;
+}
+
+float GlbAccessor::Float(size_t i, unsigned int c) const {
+    const unsigned char *p = Data + i * Stride;
+    switch (ComponentType) {
+        case 5126: { float v; std::memcpy(&v, p + c * 4, 4); return v; }
+        case 5125: { uint32_t v; std::memcpy(&v, p + c * 4, 4); return (float) v; }
+        case 5123: { uint16_t v; std::memcpy(&v, p + c * 2, 2); return Normalized ? v / 65535.0f : (float) v; }
+        case 5122: { int16_t v; std::memcpy(&v, p + c * 2, 2); return Normalized ? std::max(v / 32767.0f, -1.0f) : (float) v; }
+        case 5121: return Normalized ? p[c] / 255.0f : (float) p[c];
+        case 5120: { int8_t v = (int8_t) p[c]; return Normalized ? std::max(v / 127.0f, -1.0f) : (float) v; }
+        default: return 0.0f;
+    }
+}
+
+unsigned int GlbAccessor::Index(size_t i) const {
+    const unsigned char *p = Data + i * Stride;
+    switch (ComponentType) {
+        case 5125: { uint32_t v; std::memcpy(&v, p, 4); return v; }
+        case 5123: { uint16_t v; std::memcpy(&v, p, 2); return v; }
+        default: return p[0];
+    }
+}
+
+bool GlbFile::Open(const char *path) {
+    primitives.clear();
+    if (!file.Open(path)) {
+        error = std::string("cannot open ") + path;
+        return false;
+    }
+    return Parse(file.Data(), file.Size());
+}
+
+bool GlbFile::Parse(const unsigned char *data, size_t size) {
+    primitives.clear();
+    error.clear();
+    auto fail = [this](const std::string &message) {
+        error = message;
+        primitives.clear();
+        return false;
+    };
+
+    // 12字节的文件头，然后是JSON块和可选的BIN块，每个块前面是长度和类型
+    if (size < 20 || readU32(data) != GLB_MAGIC)
+        return fail("not a glb file");
+    if (readU32(data + 4) != 2)
+        return fail("unsupported glTF version");
+    size_t length = std::min<size_t>(readU32(data + 8), size);
+    size_t jsonLength = readU32(data + 12);
+    if (readU32(data + 16) != GLB_CHUNK_JSON || 20 + jsonLength > length)
+        return fail("missing JSON chunk");
+    const char *jsonText = (const char *) data + 20;
+    const unsigned char *bin = nullptr;
+    size_t binLength = 0;
+    size_t offset = (20 + jsonLength + 3) & ~(size_t) 3;
+    if (offset + 8 <= length && readU32(data + offset + 4) == GLB_CHUNK_BIN) {
+        binLength = std::min<size_t>(readU32(data + offset), length - offset - 8);
+        bin = data + offset + 8;
+    }
+
+    Json json;
+    if (!json.Parse(jsonText, jsonLength))
+        return fail("invalid JSON chunk");
+    const JsonNode *root = json.Root();
+    // 只支持内嵌在BIN块中的缓冲（buffer 0，没有uri）
+    std::vector<const JsonNode *> buffers = json.Items(json.Member(root, "buffers"));
+    for (const JsonNode *buffer : buffers)
+        if (json.Member(buffer, "uri"))
+            return fail("external buffers are not supported");
+    std::vector<const JsonNode *> views = json.Items(json.Member(root, "bufferViews"));
+    std::vector<const JsonNode *> accessors = json.Items(json.Member(root, "accessors"));
+    std::vector<const JsonNode *> meshes = json.Items(json.Member(root, "meshes"));
+    std::vector<const JsonNode *> nodes = json.Items(json.Member(root, "nodes"));
+
+    // index 是图元中访问器的编号，没有这个成员时返回true，result保持无效
+    auto accessor = [&](const JsonNode *index, GlbAccessor &result) {
+        if (!index)
+            return true;
+        size_t accessorIndex, viewIndex;
+        if (index->Type != JsonNode::NUMBER || !jsonIndex(index->Number, accessors.size(), accessorIndex))
+            return false;
+        const JsonNode *a = accessors[accessorIndex];
+        if (json.Member(a, "sparse") || !bin || !jsonIndex(json.Number(a, "bufferView", -1.0), views.size(), viewIndex))
+            return false;
+        const JsonNode *v = views[viewIndex];
+        if (json.Number(v, "buffer", 0.0) != 0.0)
+            return false;
+        const JsonNode *type = json.Member(a, "type");
+        result.Components = Json::Equals(type, "SCALAR") ? 1 : Json::Equals(type, "VEC2") ? 2 : Json::Equals(type, "VEC3") ? 3 :
+                            Json::Equals(type, "VEC4") ? 4 : 0;
+        result.ComponentType = (unsigned int) json.Number(a, "componentType", 0.0);
+        result.Normalized = json.Member(a, "normalized") && json.Member(a, "normalized")->Number != 0.0;
+        unsigned int elementSize = result.ElementSize();
+        size_t stride, viewOffset, viewLength, accessorOffset;
+        if (result.Components == 0 || !jsonInteger(json.Number(a, "count", -1.0), GLB_MAX_BYTES, result.Count) ||
+            !jsonInteger(json.Number(v, "byteStride", elementSize), GLTF_MAX_BYTE_STRIDE, stride) || stride < elementSize ||
+            !jsonInteger(json.Number(v, "byteOffset", 0.0), GLB_MAX_BYTES, viewOffset) ||
+            !jsonInteger(json.Number(v, "byteLength", -1.0), GLB_MAX_BYTES, viewLength) ||
+            !jsonInteger(json.Number(a, "byteOffset", 0.0), GLB_MAX_BYTES, accessorOffset))
+            return false;
+        // 视图要在BIN块里，访问器的最后一个元素要在视图里；都用减法比较，不会溢出
+        if (viewOffset > binLength || viewLength > binLength - viewOffset || accessorOffset > viewLength)
+            return false;
+        if (result.Count > 0 && (elementSize > viewLength - accessorOffset ||
+                                 result.Count - 1 > (viewLength - accessorOffset - elementSize) / stride))
+            return false;
+        result.Stride = (unsigned int) stride;
+        result.Data = bin + viewOffset + accessorOffset;
+        return true;
+    };
+
+    // 网格的每个三角形图元，加上累计的变换
+    auto addMesh = [&](size_t meshIndex, const glm::mat4 &model) {
+        if (meshIndex >= meshes.size())
+            return false;
+        for (const JsonNode *p : json.Items(json.Member(meshes[meshIndex], "primitives"))) {
+            if (json.Number(p, "mode", GLTF_TRIANGLES) != GLTF_TRIANGLES)
+                continue;
+            const JsonNode *attributes = json.Member(p, "attributes");
+            GlbPrimitive primitive;
+            primitive.Model = model;
+            primitive.Mesh = (unsigned int) meshIndex;
+            if (!accessor(json.Member(attributes, "POSITION"), primitive.Positions) ||
+                !accessor(json.Member(attributes, "NORMAL"), primitive.Normals) ||
+                !accessor(json.Member(attributes, "TEXCOORD_0"), primitive.TexCoords) ||
+                !accessor(json.Member(p, "indices"), primitive.Indices))
+                return false;
+            if (!primitive.Positions.Valid() || primitive.Positions.Components != 3 ||
+                (primitive.Normals.Valid() && (primitive.Normals.Components != 3 || primitive.Normals.Count != primitive.Positions.Count)) ||
+                (primitive.TexCoords.Valid() && (primitive.TexCoords.Components != 2 || primitive.TexCoords.Count != primitive.Positions.Count)) ||
+                (primitive.Indices.Valid() && primitive.Indices.Components != 1))
+                return false;
+            primitives.push_back(primitive);
+        }
+        return true;
+    };
+
+    if (nodes.empty()) {
+        // 没有节点时每个网格放在原点
+        for (size_t m = 0; m < meshes.size(); m++)
+            if (!addMesh(m, glm::mat4(1.0f)))
+                return fail("invalid mesh or accessor");
+        return true;
+    }
+
+    // 根节点：默认场景的节点；没有场景时是所有不是别人子节点的节点
+    std::vector<size_t> roots;
+    std::vector<const JsonNode *> scenes = json.Items(json.Member(root, "scenes"));
+    size_t sceneIndex, nodeIndex;
+    if (jsonIndex(json.Number(root, "scene", 0.0), scenes.size(), sceneIndex)) {
+        for (const JsonNode *n : json.Items(json.Member(scenes[sceneIndex], "nodes"))) {
+            if (n->Type != JsonNode::NUMBER || !jsonIndex(n->Number, nodes.size(), nodeIndex))
+                return fail("invalid node hierarchy");
+            roots.push_back(nodeIndex);
+        }
+    } else {
+        std::vector<bool> isChild(nodes.size(), false);
+        for (const JsonNode *node : nodes)
+            for (const JsonNode *c : json.Items(json.Member(node, "children")))
+                if (c->Type == JsonNode::NUMBER && jsonIndex(c->Number, nodes.size(), nodeIndex))
+                    isChild[nodeIndex] = true;
+        for (size_t n = 0; n < nodes.size(); n++)
+            if (!isChild[n])
+                roots.push_back(n);
+    }
+    // 深度优先，层数超过节点数说明有环
+    struct Pending { size_t Node; glm::mat4 Parent; size_t Depth; };
+    std::vector<Pending> stack;
+    for (auto it = roots.rbegin(); it != roots.rend(); ++it)
+        stack.push_back({*it, glm::mat4(1.0f), 0});
+    while (!stack.empty()) {
+        Pending pending = stack.back();
+        stack.pop_back();
+        if (pending.Node >= nodes.size() || pending.Depth > nodes.size())
+            return fail("invalid node hierarchy");
+        const JsonNode *node = nodes[pending.Node];
+        glm::mat4 model = pending.Parent * nodeTransform(json, node);
+        const JsonNode *mesh = json.Member(node, "mesh");
+        size_t meshIndex;
+        if (mesh && (mesh->Type != JsonNode::NUMBER || !jsonIndex(mesh->Number, meshes.size(), meshIndex) || !addMesh(meshIndex, model)))
+            return fail("invalid mesh or accessor");
+        std::vector<const JsonNode *> children = json.Items(json.Member(node, "children"));
+        for (auto it = children.rbegin(); it != children.rend(); ++it) {
+            if ((*it)->Type != JsonNode::NUMBER || !jsonIndex((*it)->Number, nodes.size(), nodeIndex))
+                return fail("invalid node hierarchy");
+            stack.push_back({nodeIndex, model, pending.Depth + 1});
+        }
+    }
+    return true;
+}
+
+bool MeshImporter::Load(const char *path, ImportedMesh &mesh) {
+    std::string name(path);
+    std::string extension = name.substr(std::min(name.find_last_of('.'), name.size()));
+    std::transform(extension.begin(), extension.end(), extension.begin(), [](char c) { return (char) std::tolower((unsigned char) c); });
+    if (extension == ".obj")
+        return LoadObj(path, mesh);
+    if (extension == ".glb")
+        return LoadGlb(path, mesh);
+    error = "unsupported file type: " + name;
+    return false;
+}
+
+bool MeshImporter::LoadObj(const char *path, ImportedMesh &mesh) {
+    auto start = Clock::now();
+    MappedFile file;
+    if (!file.Open(path)) {
+        error = std::string("cannot open ") + path;
+        return false;
+    }
+    double mapMs = millisecondsSince(start);
+    bool ok = ParseObj((const char *) file.Data(), file.Size(), mesh);
+    stats.MapMs = mapMs;
+    stats.TotalMs = millisecondsSince(start);
+    return ok;
+}
+
+bool MeshImporter::LoadGlb(const char *path, ImportedMesh &mesh) {
+    auto start = Clock::now();
+    mesh.Clear();
+    stats = MeshImportStats();
+    stats.Threads = threadCount();
+    MappedFile file;
+    if (!file.Open(path)) {
+        error = std::string("cannot open ") + path;
+        return false;
+    }
+    stats.Bytes = file.Size();
+    stats.MapMs = millisecondsSince(start);
+
+    auto parseStart = Clock::now();
+    GlbFile glb;
+    if (!glb.Parse(file.Data(), file.Size())) {
+        error = std::string(path) + ": " + glb.Error();
+        return false;
+    }
+    stats.ParseMs = millisecondsSince(parseStart);
+    bool ok = Flatten(glb, mesh);
+    stats.TotalMs = millisecondsSince(start);
+    return ok;
+}
+
+bool MeshImporter::Flatten(const GlbFile &glb, ImportedMesh &mesh) {
+    auto start = Clock::now();
+    mesh.Clear();
+    error.clear();
+    const std::vector<GlbPrimitive> &primitives = glb.Primitives();
+    // 每个图元在输出中的起点
+    std::vector<size_t> vertexBase(primitives.size() + 1, 0), indexBase(primitives.size() + 1, 0);
+    for (size_t i = 0; i < primitives.size(); i++) {
+        const GlbPrimitive &primitive = primitives[i];
+        vertexBase[i + 1] = vertexBase[i] + primitive.Positions.Count;
+        indexBase[i + 1] = indexBase[i] + (primitive.Indices.Valid() ? primitive.Indices.Count : primitive.Positions.Count);
+        mesh.HasNormals = mesh.HasNormals || primitive.Normals.Valid();
+        mesh.HasTexCoords = mesh.HasTexCoords || primitive.TexCoords.Valid();
+    }
+    mesh.Vertices.resize(vertexBase.back());
+    mesh.Indices.resize(indexBase.back());
+
+    // 按 BLOCK 个顶点分块并行展开
+    const size_t BLOCK = 65536;
+    struct Task { size_t Primitive, Begin, End; };
+    std::vector<Task> tasks;
+    for (size_t i = 0; i < primitives.size(); i++) {
+        size_t count = std::max(primitives[i].Positions.Count, indexBase[i + 1] - indexBase[i]);
+        for (size_t begin = 0; begin < count; begin += BLOCK)
+            tasks.push_back({i, begin, std::min(begin + BLOCK, count)});
+    }
+    std::vector<AABB> bounds(tasks.size());
+    std::vector<char> badIndex(tasks.size(), 0);
+    parallelFor(tasks.size(), threadCount(), [&](size_t t) {
+        const Task &task = tasks[t];
+        const GlbPrimitive &primitive = primitives[task.Primitive];
+        // 单位变换时法线原样复制，和文件中的数据逐位相同
+        bool identity = primitive.Model == glm::mat4(1.0f);
+        glm::mat3 normalMatrix = glm::transpose(glm::inverse(glm::mat3(primitive.Model)));
+        size_t vertexCount = primitive.Positions.Count;
+        for (size_t i = task.Begin; i < std::min(task.End, vertexCount); i++) {
+            MeshVertex &vertex = mesh.Vertices[vertexBase[task.Primitive] + i];
+            const GlbAccessor &positions = primitive.Positions;
+            glm::vec4 position = primitive.Model * glm::vec4(positions.Float(i, 0), positions.Float(i, 1), positions.Float(i, 2), 1.0f);
+            vertex.Position = glm::vec3(position);
+            bounds[t].Grow(vertex.Position);
+            vertex.Normal = glm::vec3(0.0f);
+            if (primitive.Normals.Valid()) {
+                glm::vec3 normal(primitive.Normals.Float(i, 0), primitive.Normals.Float(i, 1), primitive.Normals.Float(i, 2));
+                if (!identity) {
+                    normal = normalMatrix * normal;
+                    float length = glm::length(normal);
+                    normal = length > 0.0f ? normal / length : normal;
+                }
+                vertex.Normal = normal;
+            }
+            // glTF的纹理坐标原点在图片左上角，示例加载图片时上下翻转，v也要翻转
+            vertex.TexCoords = primitive.TexCoords.Valid() ? glm::vec2(primitive.TexCoords.Float(i, 0), 1.0f - primitive.TexCoords.Float(i, 1)) : glm::vec2(0.0f);
+        }
+        size_t indexCount = indexBase[task.Primitive + 1] - indexBase[task.Primitive];
+        unsigned int base = (unsigned int) vertexBase[task.Primitive];
+        for (size_t i = task.Begin; i < std::min(task.End, indexCount); i++) {
+            unsigned int index = primitive.Indices.Valid() ? primitive.Indices.Index(i) : (unsigned int) i;
+            if (index >= vertexCount)
+                badIndex[t] = 1;
+            mesh.Indices[indexBase[task.Primitive] + i] = base + index;
+        }
+    });
+    for (size_t t = 0; t < tasks.size(); t++) {
+        if (badIndex[t]) {
+            error = "index out of range";
+            mesh.Clear();
+            return false;
+        }
+        mesh.Bounds.Grow(bounds[t]);
+    }
+    stats.Positions = mesh.Vertices.size();
+    stats.Corners = mesh.Indices.size();
+    stats.MergeMs = millisecondsSince(start);
+    return true;
+}
+
+unsigned int MeshImporter::threadCount() const {
+    return Threads != 0 ? Threads : std::max(std::thread::hardware_concurrency(), 1u);
+}
+
+bool MeshImporter::ParseObj(const char *text, size_t size, ImportedMesh &mesh) {
+    auto start = Clock::now();
+    mesh.Clear();
+    error.clear();
+    stats = MeshImportStats();
+    stats.Bytes = size;
+    stats.Threads = threadCount();
+
+    // 1. 分块，边界移到下一个换行之后，并行解析
+    const char *end = text + size;
+    size_t chunkSize = std::max<size_t>(ChunkSize, 1);
+    size_t chunkCount = std::max<size_t>((size + chunkSize - 1) / chunkSize, 1);
+    std::vector<ObjChunk> chunks(chunkCount);
+    const char *begin = text;
+    for (size_t i = 0; i < chunkCount; i++) {
+        const char *target = i + 1 == chunkCount ? end : text + (i + 1) * chunkSize;
+        const void *newline = target < end ? std::memchr(target, '\n', (size_t) (end - target)) : nullptr;
+        const char *chunkEnd = i + 1 == chunkCount ? end : newline ? (const char *) newline + 1 : end;
+        chunks[i].Begin = begin;
+        chunks[i].End = std::max(chunkEnd, begin);
+        begin = chunks[i].End;
+    }
+    stats.Chunks = (unsigned int) chunkCount;
+    parallelFor(chunkCount, stats.Threads, [&](size_t i) { parseObjChunk(chunks[i]); });
+    stats.ParseMs = millisecondsSince(start);
+
+    auto merge = Clock::now();
+    auto failAt = [&](const char *at, const char *message) {
+        size_t line = 1 + (size_t) std::count(text, at, '\n');
+        error = "line " + std::to_string(line) + ": " + message;
+        mesh.Clear();
+        return false;
+    };
+    for (const ObjChunk &chunk : chunks)
+        if (chunk.ErrorMessage)
+            return failAt(chunk.ErrorAt, chunk.ErrorMessage);
+
+    // 2. 各块属性和角的起点，把属性拷贝到一起，负索引加上块的起点，检查索引范围
+    std::vector<size_t> base[4];
+    for (std::vector<size_t> &b : base)
+        b.assign(chunkCount + 1, 0);
+    for (size_t i = 0; i < chunkCount; i++) {
+        base[0][i + 1] = base[0][i] + chunks[i].Positions.size() / 3;
+        base[1][i + 1] = base[1][i] + chunks[i].TexCoords.size() / 2;
+        base[2][i + 1] = base[2][i] + chunks[i].Normals.size() / 3;
+        base[3][i + 1] = base[3][i] + chunks[i].Corners.size() / 3;
+    }
+    const size_t counts[3] = {base[0][chunkCount], base[1][chunkCount], base[2][chunkCount]};
+    if (counts[0] > (size_t) INT32_MAX || counts[1] > (size_t) INT32_MAX || counts[2] > (size_t) INT32_MAX ||
+        base[3][chunkCount] > (size_t) UINT32_MAX) {
+        error = "mesh too large for 32-bit indices";
+        return false;
+    }
+    stats.Positions = counts[0];
+    stats.Corners = base[3][chunkCount];
+    std::vector<float> positions(counts[0] * 3), texCoords(counts[1] * 2), normals(counts[2] * 3);
+    // 每个块第一个越界的索引在 Corners 中的位置
+    std::vector<size_t> badCorner(chunkCount, SIZE_MAX);
+    std::vector<char> usesTexCoords(chunkCount, 0), usesNormals(chunkCount, 0);
+    parallelFor(chunkCount, stats.Threads, [&](size_t i) {
+        ObjChunk &chunk = chunks[i];
+        std::copy(chunk.Positions.begin(), chunk.Positions.end(), positions.begin() + base[0][i] * 3);
+        std::copy(chunk.TexCoords.begin(), chunk.TexCoords.end(), texCoords.begin() + base[1][i] * 2);
+        std::copy(chunk.Normals.begin(), chunk.Normals.end(), normals.begin() + base[2][i] * 3);
+        std::vector<float>().swap(chunk.Positions);
+        std::vector<float>().swap(chunk.TexCoords);
+        std::vector<float>().swap(chunk.Normals);
+        for (size_t slot : chunk.Relative)
+            chunk.Corners[slot] += (int) base[slot % 3][i];
+        for (size_t c = 0; c < chunk.Corners.size(); c += 3) {
+            int p = chunk.Corners[c], t = chunk.Corners[c + 1], n = chunk.Corners[c + 2];
+            usesTexCoords[i] |= t != MISSING;
+            usesNormals[i] |= n != MISSING;
+            if (p < 0 || (size_t) p >= counts[0] || (t != MISSING && (t < 0 || (size_t) t >= counts[1])) ||
+                (n != MISSING && (n < 0 || (size_t) n >= counts[2]))) {
+                badCorner[i] = c;
+                break;
+            }
+        }
+    });
+    for (size_t i = 0; i < chunkCount; i++) {
+        // 角没有记下所在的行，出错时重新解析这个块找到那一行，正常的文件不需要额外的内存
+        if (badCorner[i] != SIZE_MAX) {
+            ObjChunk again;
+            again.Begin = chunks[i].Begin;
+            again.End = chunks[i].End;
+            again.FindCorner = badCorner[i];
+            parseObjChunk(again);
+            return failAt(again.ErrorAt ? again.ErrorAt : again.Begin, "face index out of range");
+        }
+        mesh.HasTexCoords = mesh.HasTexCoords || usesTexCoords[i];
+        mesh.HasNormals = mesh.HasNormals || usesNormals[i];
+    }
+
+    // 3. 去重：每个位置一条链表，连着用到这个位置的所有顶点，顶点按第一次出现的顺序编号
+    //    同一个位置的不同 (纹理坐标, 法线) 组合通常只有几个，链表很短
+    const unsigned int NONE = ~0u;
+    std::vector<unsigned int> head(counts[0], NONE), next;
+    std::vector<int> keys;
+    next.reserve(counts[0]);
+    keys.reserve(counts[0] * 3);
+    mesh.Indices.resize(stats.Corners);
+    unsigned int *index = mesh.Indices.data();
+    for (ObjChunk &chunk : chunks) {
+        const int *corner = chunk.Corners.data(), *cornerEnd = corner + chunk.Corners.size();
+        for (; corner < cornerEnd; corner += 3) {
+            int p = corner[0], t = corner[1], n = corner[2];
+            unsigned int v = head[p];
+            while (v != NONE && (keys[(size_t) v * 3 + 1] != t || keys[(size_t) v * 3 + 2] != n))
+                v = next[v];
+            if (v == NONE) {
+                v = (unsigned int) next.size();
+                next.push_back(head[p]);
+                head[p] = v;
+                keys.insert(keys.end(), {p, t, n});
+            }
+            *index++ = v;
+        }
+        std::vector<int>().swap(chunk.Corners);
+    }
+
+    // 4. 并行组装交错的顶点，同时计算包围盒
+    size_t vertexCount = next.size();
+    mesh.Vertices.resize(vertexCount);
+    const size_t BLOCK = 65536;
+    size_t blockCount = (vertexCount + BLOCK - 1) / BLOCK;
+    std::vector<AABB> bounds(blockCount);
+    parallelFor(blockCount, stats.Threads, [&](size_t b) {
+        for (size_t v = b * BLOCK; v < std::min(vertexCount, (b + 1) * BLOCK); v++) {
+            const int *key = &keys[v * 3];
+            MeshVertex &vertex = mesh.Vertices[v];
+            const float *p = &positions[(size_t) key[0] * 3];
+            vertex.Position = glm::vec3(p[0], p[1], p[2]);
+            bounds[b].Grow(vertex.Position);
+            vertex.TexCoords = key[1] != MISSING ? glm::vec2(texCoords[(size_t) key[1] * 2], texCoords[(size_t) key[1] * 2 + 1]) : glm::vec2(0.0f);
+            const float *n = key[2] != MISSING ? &normals[(size_t) key[2] * 3] : nullptr;
+            vertex.Normal = n ? glm::vec3(n[0], n[1], n[2]) : glm::vec3(0.0f);
+        }
+    });
+    for (const AABB &b : bounds)
+        mesh.Bounds.Grow(b);
+    stats.MergeMs = millisecondsSince(merge);
+    stats.TotalMs = millisecondsSince(start);
+    return true;
+}
+
+const char *ParseFloat(const char *p, const char *end, float &value) {
+    double result;
+    const char *next = parseDouble(p, end, result);
+    if (next)
+        value = (float) result;
+    return next;
+}
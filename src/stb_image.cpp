@@ -0,0 +1,3 @@
+// stb_image 的实现只在引擎库中编译一次，示例直接包含 <stb_image.h>，不再定义 STB_IMAGE_IMPLEMENTATION
+#define STB_IMAGE_IMPLEMENTATION
+#include <stb_image.h>
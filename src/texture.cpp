@@ -0,0 +1,33 @@
+#include <learnopengl/texture.h>
+
+#include <stb_image.h>
+
+#include <iostream>
+
+unsigned int LoadTexture(const char *path, bool flipVertically, GLint wrap) {
+    int width, height, nrChannels;
+    stbi_set_flip_vertically_on_load(flipVertically);
+    unsigned char *data = stbi_load(path, &width, &height, &nrChannels, 0);
+    if (!data) {
+        std::cout << "Failed to load texture: " << path << std::endl;
+        return 0;
+    }
+    GLenum format = nrChannels == 1 ? GL_RED : nrChannels == 4 ? GL_RGBA : GL_RGB;
+
+    unsigned int texture;
+    glGenTextures(1, &texture);
+    glBindTexture(GL_TEXTURE_2D, texture);
+    // 设置纹理环绕选项
+    glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_WRAP_S, wrap);
+    glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_WRAP_T, wrap);
+    // 纹理过滤选项
+    glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_MIN_FILTER, GL_LINEAR_MIPMAP_LINEAR);
+    glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_MAG_FILTER, GL_LINEAR);
+    // 行宽不是4的倍数（比如单通道或者宽度为奇数的RGB图片）时按1字节对齐读取
+    glPixelStorei(GL_UNPACK_ALIGNMENT, 1);
+    glTexImage2D(GL_TEXTURE_2D, 0, (GLint) format, width, height, 0, format, GL_UNSIGNED_BYTE, data);
+    glPixelStorei(GL_UNPACK_ALIGNMENT, 4);
+    glGenerateMipmap(GL_TEXTURE_2D);
+    stbi_image_free(data);
+    return texture;
+}
@@ -0,0 +1,72 @@
+// 网格烘焙：把OBJ或glb转换成预烘焙的 .mesh 文件（格式见 cooked_mesh.h），运行时映射后直接上传，不再解析
+//
+// 用法：mesh_cooker <输入.obj|.glb> <输出.mesh> [--full] [--lods N] [--ratio R]
+//   --full      保持32字节的顶点格式（默认是20字节的紧凑格式）
+//   --lods N    LOD的级数，包括原始网格，默认4
+//   --ratio R   相邻两级的三角形数之比，默认0.25
+#include <learnopengl/cooked_mesh.h>
+
+#include <algorithm>
+#include <chrono>
+#include <cstdlib>
+#include <cstring>
+#include <iostream>
+
+int main(int argc, char *argv[]) {
+    using std::cout;
+    using std::endl;
+    typedef std::chrono::high_resolution_clock Clock;
+
+    if (argc < 3) {
+        cout << "usage: mesh_cooker <input.obj|input.glb> <output.mesh> [--full] [--lods N] [--ratio R]" << endl;
+        return EXIT_FAILURE;
+    }
+    MeshCooker cooker;
+    for (int i = 3; i < argc; i++) {
+        if (std::strcmp(argv[i], "--full") == 0)
+            cooker.CompactVertices = false;
+        else if (std::strcmp(argv[i], "--lods") == 0 && i + 1 < argc)
+            cooker.LodCount = (unsigned int) std::max(1, std::atoi(argv[++i]));
+        else if (std::strcmp(argv[i], "--ratio") == 0 && i + 1 < argc)
+            cooker.LodRatio = (float) std::atof(argv[++i]);
+        else {
+            cout << "unknown option " << argv[i] << endl;
+            return EXIT_FAILURE;
+        }
+    }
+    if (!(cooker.LodRatio > 0.0f && cooker.LodRatio < 1.0f)) {
+        cout << "--ratio must be between 0 and 1" << endl;
+        return EXIT_FAILURE;
+    }
+
+    MeshImporter importer;
+    ImportedMesh mesh;
+    if (!importer.Load(argv[1], mesh)) {
+        cout << importer.Error() << endl;
+        return EXIT_FAILURE;
+    }
+    cout << argv[1] << ": " << mesh.Vertices.size() << " vertices, " << mesh.TriangleCount() << " triangles, imported in "
+         << importer.Stats().TotalMs << " ms" << endl;
+
+    auto start = Clock::now();
+    if (!cooker.Write(mesh, argv[2])) {
+        cout << cooker.Error() << endl;
+        return EXIT_FAILURE;
+    }
+    double cookMs = std::chrono::duration<double, std::milli>(Clock::now() - start).count();
+
+    // 读回来检查一遍，输出各级LOD
+    CookedMesh cooked;
+    if (!cooked.Open(argv[2]) || !cooked.Verify()) {
+        cout << argv[2] << ": " << cooked.Error() << endl;
+        return EXIT_FAILURE;
+    }
+    const CookedMeshHeader &header = cooked.Header();
+    cout << argv[2] << ": " << header.FileSize / 1024 << " KB, cooked in " << cookMs << " ms, " << header.VertexStride << "-byte vertices, "
+         << (header.IndexType == GL_UNSIGNED_SHORT ? 16 : 32) << "-bit indices, " << header.MeshletCount << " meshlets" << endl;
+    for (unsigned int i = 0; i < header.LodCount; i++) {
+        const CookedLod &lod = cooked.Lod(i);
+        cout << "  LOD " << i << ": " << lod.IndexCount / 3 << " triangles, " << lod.MeshletCount << " meshlets, error " << lod.Error << endl;
+    }
+    return EXIT_SUCCESS;
+}